@@ -347,6 +347,7 @@ LteEnbMac::GetTypeId (void)
 
 
 LteEnbMac::LteEnbMac ()
+  : m_niMaxUesPerTti (0)
 {
   NS_LOG_FUNCTION (this);
   m_macSapProvider = new EnbMacMemberLteMacSapProvider<LteEnbMac> (this);
@@ -454,6 +455,12 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
   m_frameNo = frameNo;
   m_subframeNo = subframeNo;
 
+  // NI API CHANGE - the NI PHY may limit the UEs served per TTI while its real-time loop is
+  // degraded, the cap is applied here before any RLC PDU is dequeued or DCI is sent
+  m_niMaxUesPerTti = m_enbPhySapProvider->GetNiApiEnable () ? m_enbPhySapProvider->GetNiMaxUesPerTti () : 0;
+  m_niServedRntis.clear ();
+  m_niSkippedRntis.clear ();
+
 
   // --- DOWNLINK ---
   // Send Dl-CQI info to the scheduler
@@ -596,6 +603,26 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
 
   m_schedSapProvider->SchedUlTriggerReq (ulparams);
 
+  if (!m_niSkippedRntis.empty ())
+    {
+      m_enbPhySapProvider->NotifyNiSkippedUes (m_niSkippedRntis.size ());
+    }
+}
+
+bool
+LteEnbMac::NiServeRnti (uint16_t rnti)
+{
+  if ((m_niMaxUesPerTti == 0) || (m_niServedRntis.count (rnti) > 0))
+    {
+      return true;
+    }
+  if (m_niServedRntis.size () < m_niMaxUesPerTti)
+    {
+      m_niServedRntis.insert (rnti);
+      return true;
+    }
+  m_niSkippedRntis.insert (rnti);
+  return false;
 }
 
 
@@ -974,6 +1001,21 @@ LteEnbMac::DoSchedDlConfigInd (FfMacSchedSapUser::SchedDlConfigIndParameters ind
   Ptr<PacketBurst> pb = CreateObject<PacketBurst> ();
   std::map <LteFlowId_t, LteMacSapUser* >::iterator it;
 
+  // NI API CHANGE - UEs above the NI PHY cap keep their RLC data for a later TTI
+  std::vector<BuildDataListElement_s>::iterator itData = ind.m_buildDataList.begin ();
+  while (itData != ind.m_buildDataList.end ())
+    {
+      if (NiServeRnti (itData->m_rnti))
+        {
+          ++itData;
+        }
+      else
+        {
+          NI_LOG_DEBUG ("eNB MAC DL - NI PHY UE cap reached, rnti= " << itData->m_rnti << " not served in this TTI");
+          itData = ind.m_buildDataList.erase (itData);
+        }
+    }
+
   for (unsigned int i = 0; i < ind.m_buildDataList.size (); i++)
     {
       for (uint16_t layer = 0; layer < ind.m_buildDataList.at (i).m_dci.m_ndi.size (); layer++)
@@ -1124,6 +1166,21 @@ LteEnbMac::DoSchedUlConfigInd (FfMacSchedSapUser::SchedUlConfigIndParameters ind
 {
   NS_LOG_FUNCTION (this);
 
+  // NI API CHANGE - UEs above the NI PHY cap get no UL grant in this TTI
+  std::vector<UlDciListElement_s>::iterator itDci = ind.m_dciList.begin ();
+  while (itDci != ind.m_dciList.end ())
+    {
+      if (NiServeRnti (itDci->m_rnti))
+        {
+          ++itDci;
+        }
+      else
+        {
+          NI_LOG_DEBUG ("eNB MAC UL - NI PHY UE cap reached, rnti= " << itDci->m_rnti << " not served in this TTI");
+          itDci = ind.m_dciList.erase (itDci);
+        }
+    }
+
   for (unsigned int i = 0; i < ind.m_dciList.size (); i++)
     {
       // send the correspondent ul dci
@@ -24,6 +24,7 @@
 
 
 #include <map>
+#include <set>
 #include <vector>
 #include <ns3/lte-common.h>
 #include <ns3/lte-mac-sap.h>
@@ -211,6 +212,9 @@ private:
   void DoUlInfoListElementHarqFeeback (UlInfoListElement_s params);
   void DoDlInfoListElementHarqFeeback (DlInfoListElement_s params);
 
+  // NI API CHANGE - false if the UE exceeds the number of UEs the NI PHY serves in this TTI
+  bool NiServeRnti (uint16_t rnti);
+
   //            rnti,             lcid, SAP of the RLC instance
   std::map <uint16_t, std::map<uint8_t, LteMacSapUser*> > m_rlcAttached;
 
@@ -263,6 +267,11 @@ private:
   
   uint8_t m_macChTtiDelay; // delay of MAC, PHY and channel in terms of TTIs
 
+  // NI API CHANGE - UEs served and skipped in the current TTI while the NI PHY caps them
+  uint32_t m_niMaxUesPerTti;
+  std::set<uint16_t> m_niServedRntis;
+  std::set<uint16_t> m_niSkippedRntis;
+
 
   std::map <uint16_t, DlHarqProcessesBuffer_t> m_miDlHarqProcessesPackets; // Packet under trasmission of the DL HARQ process
   
@@ -64,6 +64,9 @@ public:
   // NI API CHANGE
   virtual bool GetNiApiEnable () = 0;
   virtual bool GetNiApiLoopbackEnable () = 0;
+  // maximum number of UEs the MAC schedules per TTI, 0 if not limited
+  virtual uint32_t GetNiMaxUesPerTti () = 0;
+  virtual void NotifyNiSkippedUes (uint32_t numUes) = 0;
 
 };
 
@@ -87,6 +87,8 @@ public:
   // NI API CHANGE
   virtual bool GetNiApiEnable ();
   virtual bool GetNiApiLoopbackEnable ();
+  virtual uint32_t GetNiMaxUesPerTti ();
+  virtual void NotifyNiSkippedUes (uint32_t numUes);
 
 
 private:
@@ -141,6 +143,18 @@ EnbMemberLteEnbPhySapProvider::GetNiApiLoopbackEnable ()
   return (m_phy->DoGetNiApiLoopbackEnable());
 }
 
+uint32_t
+EnbMemberLteEnbPhySapProvider::GetNiMaxUesPerTti ()
+{
+  return (m_phy->DoGetNiMaxUesPerTti ());
+}
+
+void
+EnbMemberLteEnbPhySapProvider::NotifyNiSkippedUes (uint32_t numUes)
+{
+  m_phy->DoNotifyNiSkippedUes (numUes);
+}
+
 
 ////////////////////////////////////////
 // generic LteEnbPhy methods
@@ -460,6 +474,16 @@ LteEnbPhy::DoGetNiApiLoopbackEnable ()
 {
   return (m_niLtePhyModule->GetNiApiLoopbackEnable ());
 }
+uint32_t
+LteEnbPhy::DoGetNiMaxUesPerTti ()
+{
+  return (m_niLtePhyModule->GetNiMaxUesPerTti ());
+}
+void
+LteEnbPhy::DoNotifyNiSkippedUes (uint32_t numUes)
+{
+  m_niLtePhyModule->NiNotifySkippedUes (numUes);
+}
 
 void
 LteEnbPhy::PhyPduReceived (Ptr<Packet> p)
@@ -829,7 +853,7 @@ LteEnbPhy::StartSubFrame (void)
                        this);
 
   // NI API CHANGE: temporary change for timing measurements
-  NI_LOG_TRACE("[Trace#10],StartSubFrameEnd," << ( NiUtils::GetSysTime()-g_logTraceStartSubframeTime));
+  NI_TRACE(NI_TRACE_START_SUBFRAME_END, m_nrFrames, m_nrSubFrames, NiUtils::GetSysTime()-g_logTraceStartSubframeTime);
 }
 
 void
@@ -852,7 +876,7 @@ LteEnbPhy::SendControlChannels (std::list<Ptr<LteControlMessage> > ctrlMsgList)
   m_downlinkSpectrumPhy->StartTxDlCtrlFrame (ctrlMsgList, pss);
 
   // NI API CHANGE: temporary used for timing measurements
-  NI_LOG_TRACE("[Trace#11],SendControlChannels," << ( NiUtils::GetSysTime()-g_logTraceStartSubframeTime));
+  NI_TRACE(NI_TRACE_SEND_CONTROL_CHANNELS, m_nrFrames, m_nrSubFrames, NiUtils::GetSysTime()-g_logTraceStartSubframeTime);
 }
 
 void
@@ -867,7 +891,7 @@ LteEnbPhy::SendDataChannels (Ptr<PacketBurst> pb)
   m_downlinkSpectrumPhy->StartTxDataFrame (pb, ctrlMsgList, DL_DATA_DURATION);
 
   // NI API CHANGE: temporary used for timing measurements
-  NI_LOG_TRACE("[Trace#12],SendDataChannels," << ( NiUtils::GetSysTime()-g_logTraceStartSubframeTime));
+  NI_TRACE(NI_TRACE_SEND_DATA_CHANNELS, m_nrFrames, m_nrSubFrames, NiUtils::GetSysTime()-g_logTraceStartSubframeTime);
 }
 
 
@@ -326,6 +326,8 @@ private:
   // NI API CHANGE
   bool DoGetNiApiEnable ();
   bool DoGetNiApiLoopbackEnable ();
+  uint32_t DoGetNiMaxUesPerTti ();
+  void DoNotifyNiSkippedUes (uint32_t numUes);
 
   /**
    * Add the given RNTI to the list of attached UE #m_ueAttached.
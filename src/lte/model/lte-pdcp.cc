@@ -215,6 +215,8 @@ LtePdcp::DoTransmitPdcpSdu (Ptr<Packet> p)
   PdcpTag pdcpTag (Simulator::Now ());
   p->AddPacketTag (pdcpTag);
   m_txPdu (m_rnti, m_lcid, p->GetSize ());
+  // PDCP throughput of this node for remote control telemetry
+  g_RemoteControlEngine.GetPdb()->numPdcpTxBytes.Increment(p->GetSize ());
 
   LteRlcSapProvider::TransmitPdcpPduParameters params;
   params.rnti = m_rnti;
@@ -226,15 +228,22 @@ LtePdcp::DoTransmitPdcpSdu (Ptr<Packet> p)
   PdcpLcid lcidtag;
 
   //NI API CHANGE: read out values from remote control database and overwrite local decision variables
-  if (pdcp_decisionlwa != g_RemoteControlEngine.GetPdb()->getParameterLwaDecVariable())
+  //                only after they have been written, the version check is a single atomic load per SDU
+  ParameterDataBase* pdb = g_RemoteControlEngine.GetPdb();
+  const uint64_t rcParameterVersion = pdb->GetVersion();
+  if (m_rcParameterVersion != rcParameterVersion)
     {
-	  pdcp_decisionlwa = g_RemoteControlEngine.GetPdb()->getParameterLwaDecVariable();
-	  NI_LOG_CONSOLE_DEBUG("NI.RC:LWA value changed! LWA value is : " << pdcp_decisionlwa);
-    }
-  if (pdcp_decisionlwip != g_RemoteControlEngine.GetPdb()->getParameterLwipDecVariable())
-    {
-	  pdcp_decisionlwip = g_RemoteControlEngine.GetPdb()->getParameterLwipDecVariable();
-	  NI_LOG_CONSOLE_DEBUG("NI.RC:LWIP value changed! LWIP value is : " << pdcp_decisionlwip);
+      m_rcParameterVersion = rcParameterVersion;
+      if (pdcp_decisionlwa != pdb->getParameterLwaDecVariable())
+        {
+          pdcp_decisionlwa = pdb->getParameterLwaDecVariable();
+          NI_LOG_CONSOLE_DEBUG("NI.RC:LWA value changed! LWA value is : " << pdcp_decisionlwa);
+        }
+      if (pdcp_decisionlwip != pdb->getParameterLwipDecVariable())
+        {
+          pdcp_decisionlwip = pdb->getParameterLwipDecVariable();
+          NI_LOG_CONSOLE_DEBUG("NI.RC:LWIP value changed! LWIP value is : " << pdcp_decisionlwip);
+        }
     }
 
   // switch between the lwa/lwip modes
@@ -166,6 +166,8 @@ protected:
 
   uint32_t pdcp_decisionlwa;
   uint32_t pdcp_decisionlwip;
+  // remote control data base version of the last read of the decision variables
+  uint64_t m_rcParameterVersion=UINT64_MAX;
   uint32_t m_packetCounter=0;
 
 private:
@@ -0,0 +1,606 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#ifndef NI_LTE_CTRL_MSG_CODEC_H_
+#define NI_LTE_CTRL_MSG_CODEC_H_
+
+#include <cstdint>
+
+#include <ns3/lte-control-messages.h>
+#include <ns3/lte-rrc-sap.h>
+#include <ns3/ff-mac-common.h>
+
+namespace ns3
+{
+
+  //======================================================================================
+  // Packed wire format of the MAC PDUs exchanged by NiLtePhyInterface
+  //
+  // A MAC PDU starts with the packet header, followed by numCtrlMsg control messages
+  // and the payload packets. Each control message starts with its message type and is
+  // bit-packed MSB first into the field widths given below, then padded to the next
+  // byte. The widths cover the value ranges of 36.212 / 36.331, wider values are
+  // masked. The size of each message is a compile time constant (or a linear
+  // function of its list lengths), independent of the compiler ABI.
+  // The version in the packet header has to be incremented on each format change.
+  //======================================================================================
+
+#define NI_LTE_CTRL_MSG__VERSION 2
+#define NI_LTE_CTRL_MSG__TYPE_BITS 4
+
+  // packet identifier
+  typedef enum {
+    NIAPI_DL_PACKET  = 0,
+    NIAPI_UL_PACKET  = 1,
+    NIAPI_UNDEF_PACKET = 2, //undefined packet type
+  } NiApiPacketType_t ;
+
+  struct NiApiPacketHeader {
+    uint8_t  version;
+    uint8_t  niApiPacketType;
+    uint32_t nrFrames;
+    uint8_t  nrSubFrames;
+    uint32_t cellId;
+    uint16_t rnti;
+    uint8_t  numCtrlMsg;
+    uint8_t  numPaylMsg;
+  };
+
+  // writes fields MSB first into a byte buffer, single pass without bounds checks,
+  // the caller provides a buffer of the precomputed message size
+  class NiLteBitWriter
+  {
+  public:
+    explicit NiLteBitWriter (uint8_t* p_buffer)
+    : m_buffer (p_buffer), m_pos (0), m_acc (0), m_numBits (0)
+    {
+    }
+
+    inline void Put (uint32_t value, uint32_t numBits)
+    {
+      m_acc = (m_acc << numBits) | (value & Mask (numBits));
+      m_numBits += numBits;
+      while (m_numBits >= 8)
+        {
+          m_numBits -= 8;
+          m_buffer[m_pos++] = (uint8_t) (m_acc >> m_numBits);
+        }
+    }
+    // two's complement in numBits
+    inline void PutSigned (int32_t value, uint32_t numBits)
+    {
+      Put ((uint32_t) value, numBits);
+    }
+    // pads the last byte with zeros, returns the number of bytes written
+    inline uint32_t Finish (void)
+    {
+      if (m_numBits > 0)
+        {
+          m_buffer[m_pos++] = (uint8_t) (m_acc << (8 - m_numBits));
+          m_numBits = 0;
+        }
+      return m_pos;
+    }
+
+    static inline uint32_t Mask (uint32_t numBits)
+    {
+      return (uint32_t) ((1ULL << numBits) - 1);
+    }
+
+  private:
+    uint8_t* m_buffer;
+    uint32_t m_pos;
+    uint64_t m_acc;
+    uint32_t m_numBits;
+  };
+
+  // reads fields written by NiLteBitWriter, reading beyond numBytes returns zeros
+  // and marks the reader as overrun
+  class NiLteBitReader
+  {
+  public:
+    NiLteBitReader (const uint8_t* p_buffer, uint32_t numBytes)
+    : m_buffer (p_buffer), m_size (numBytes), m_pos (0), m_acc (0), m_numBits (0), m_overrun (false)
+    {
+    }
+
+    inline uint32_t Get (uint32_t numBits)
+    {
+      while (m_numBits < numBits)
+        {
+          if (m_pos == m_size)
+            {
+              m_overrun = true;
+              return 0;
+            }
+          m_acc = (m_acc << 8) | m_buffer[m_pos++];
+          m_numBits += 8;
+        }
+      m_numBits -= numBits;
+      return (uint32_t) (m_acc >> m_numBits) & NiLteBitWriter::Mask (numBits);
+    }
+    inline int32_t GetSigned (uint32_t numBits)
+    {
+      const uint32_t value = Get (numBits);
+      const uint32_t signBit = 1U << (numBits - 1);
+      return (int32_t) (value ^ signBit) - (int32_t) signBit;
+    }
+    // skips the padding of the current byte, returns the number of bytes read
+    inline uint32_t Finish (void)
+    {
+      m_numBits = 0;
+      return m_pos;
+    }
+    inline bool IsOverrun (void) const
+    {
+      return m_overrun;
+    }
+    // true if numBytes further bytes are available
+    inline bool HasBytes (uint32_t numBytes) const
+    {
+      return m_size - m_pos >= numBytes;
+    }
+
+  private:
+    const uint8_t* m_buffer;
+    uint32_t m_size;
+    uint32_t m_pos;
+    uint64_t m_acc;
+    uint32_t m_numBits;
+    bool m_overrun;
+  };
+
+  inline uint32_t
+  NiLteCtrlMsgBytes (uint32_t numBits)
+  {
+    return (numBits + 7) / 8;
+  }
+
+  //--------------------------------------------------------------------------------------
+  // packet header: version 4, packet type 2, control messages 8, payload messages 2,
+  // SFN 10 (modulo 1024), subframe 4, cell id 16, RNTI 16
+  //--------------------------------------------------------------------------------------
+
+  struct NiLtePacketHeaderCodec
+  {
+    static const uint32_t bits = 4 + 2 + 8 + 2 + 10 + 4 + 16 + 16;
+    static const uint32_t size = (bits + 7) / 8;
+
+    static inline void Encode (NiLteBitWriter& w, const NiApiPacketHeader& hdr)
+    {
+      w.Put (NI_LTE_CTRL_MSG__VERSION, 4);
+      w.Put (hdr.niApiPacketType, 2);
+      w.Put (hdr.numCtrlMsg, 8);
+      w.Put (hdr.numPaylMsg, 2);
+      w.Put (hdr.nrFrames, 10);
+      w.Put (hdr.nrSubFrames, 4);
+      w.Put (hdr.cellId, 16);
+      w.Put (hdr.rnti, 16);
+    }
+    static inline uint32_t Write (uint8_t* p_buffer, const NiApiPacketHeader& hdr)
+    {
+      NiLteBitWriter w (p_buffer);
+      Encode (w, hdr);
+      return w.Finish ();
+    }
+    static inline void Decode (NiLteBitReader& r, NiApiPacketHeader* hdr)
+    {
+      hdr->version         = r.Get (4);
+      hdr->niApiPacketType = r.Get (2);
+      hdr->numCtrlMsg      = r.Get (8);
+      hdr->numPaylMsg      = r.Get (2);
+      hdr->nrFrames        = r.Get (10);
+      hdr->nrSubFrames     = r.Get (4);
+      hdr->cellId          = r.Get (16);
+      hdr->rnti            = r.Get (16);
+    }
+  };
+
+  //--------------------------------------------------------------------------------------
+  // control messages, the bits include the message type
+  //--------------------------------------------------------------------------------------
+
+  // MIB: DL bandwidth 8, SFN 32 (the ns-3 frame counter does not wrap)
+  struct NiLteMibCodec
+  {
+    static const uint32_t bits = NI_LTE_CTRL_MSG__TYPE_BITS + 8 + 32;
+    static const uint32_t size = (bits + 7) / 8;
+
+    static inline void Encode (NiLteBitWriter& w, const LteRrcSap::MasterInformationBlock& mib)
+    {
+      w.Put (mib.dlBandwidth, 8);
+      w.Put (mib.systemFrameNumber, 32);
+    }
+    static inline void Decode (NiLteBitReader& r, LteRrcSap::MasterInformationBlock* mib)
+    {
+      mib->dlBandwidth       = r.Get (8);
+      mib->systemFrameNumber = r.Get (32);
+    }
+  };
+
+  // SIB1: PLMN identity 24, cell identity 28, CSG indication 1, CSG identity 27,
+  // q-RxLevMin 8 (signed), q-QualMin 8 (signed)
+  struct NiLteSib1Codec
+  {
+    static const uint32_t bits = NI_LTE_CTRL_MSG__TYPE_BITS + 24 + 28 + 1 + 27 + 8 + 8;
+    static const uint32_t size = (bits + 7) / 8;
+
+    static inline void Encode (NiLteBitWriter& w, const LteRrcSap::SystemInformationBlockType1& sib1)
+    {
+      w.Put (sib1.cellAccessRelatedInfo.plmnIdentityInfo.plmnIdentity, 24);
+      w.Put (sib1.cellAccessRelatedInfo.cellIdentity, 28);
+      w.Put (sib1.cellAccessRelatedInfo.csgIndication, 1);
+      w.Put (sib1.cellAccessRelatedInfo.csgIdentity, 27);
+      w.PutSigned (sib1.cellSelectionInfo.qRxLevMin, 8);
+      w.PutSigned (sib1.cellSelectionInfo.qQualMin, 8);
+    }
+    static inline void Decode (NiLteBitReader& r, LteRrcSap::SystemInformationBlockType1* sib1)
+    {
+      sib1->cellAccessRelatedInfo.plmnIdentityInfo.plmnIdentity = r.Get (24);
+      sib1->cellAccessRelatedInfo.cellIdentity  = r.Get (28);
+      sib1->cellAccessRelatedInfo.csgIndication = r.Get (1);
+      sib1->cellAccessRelatedInfo.csgIdentity   = r.Get (27);
+      sib1->cellSelectionInfo.qRxLevMin = r.GetSigned (8);
+      sib1->cellSelectionInfo.qQualMin  = r.GetSigned (8);
+    }
+  };
+
+  // RAR: RA-RNTI 16, number of responses 8, per response: RAPID 6, RNTI 16 and the
+  // UL grant with RNTI 16, RB start 7, RB length 7, TB size 16, MCS 5, hopping 1,
+  // TPC 4 (signed), CQI request 1, UL delay 1 (the DL DCI of the response is not sent)
+  struct NiLteRarCodec
+  {
+    static const uint32_t bits = NI_LTE_CTRL_MSG__TYPE_BITS + 16 + 8;
+    static const uint32_t bitsPerRar = 6 + 16 + 16 + 7 + 7 + 16 + 5 + 1 + 4 + 1 + 1;
+    static inline uint32_t Size (uint32_t numRar)
+    {
+      return NiLteCtrlMsgBytes (bits + numRar * bitsPerRar);
+    }
+
+    static inline void Encode (NiLteBitWriter& w, uint16_t raRnti, uint32_t numRar)
+    {
+      w.Put (raRnti, 16);
+      w.Put (numRar, 8);
+    }
+    static inline void Decode (NiLteBitReader& r, uint16_t* raRnti, uint32_t* numRar)
+    {
+      *raRnti = r.Get (16);
+      *numRar = r.Get (8);
+    }
+    static inline void EncodeRar (NiLteBitWriter& w, const RarLteControlMessage::Rar& rar)
+    {
+      const UlGrant_s& grant = rar.rarPayload.m_grant;
+      w.Put (rar.rapId, 6);
+      w.Put (rar.rarPayload.m_rnti, 16);
+      w.Put (grant.m_rnti, 16);
+      w.Put (grant.m_rbStart, 7);
+      w.Put (grant.m_rbLen, 7);
+      w.Put (grant.m_tbSize, 16);
+      w.Put (grant.m_mcs, 5);
+      w.Put (grant.m_hopping, 1);
+      w.PutSigned (grant.m_tpc, 4);
+      w.Put (grant.m_cqiRequest, 1);
+      w.Put (grant.m_ulDelay, 1);
+    }
+    static inline void DecodeRar (NiLteBitReader& r, RarLteControlMessage::Rar* rar)
+    {
+      UlGrant_s& grant = rar->rarPayload.m_grant;
+      rar->rapId              = r.Get (6);
+      rar->rarPayload.m_rnti  = r.Get (16);
+      grant.m_rnti       = r.Get (16);
+      grant.m_rbStart    = r.Get (7);
+      grant.m_rbLen      = r.Get (7);
+      grant.m_tbSize     = r.Get (16);
+      grant.m_mcs        = r.Get (5);
+      grant.m_hopping    = r.Get (1);
+      grant.m_tpc        = r.GetSigned (4);
+      grant.m_cqiRequest = r.Get (1);
+      grant.m_ulDelay    = r.Get (1);
+    }
+  };
+
+  // DL DCI, one transport block: RNTI 16, RBG bitmap 25, RB shift 1, resource allocation
+  // type 2, TB size 16, MCS 5, NDI 1, RV 2, CCE index 7, aggregation level 4, precoding
+  // info 6, format 3, TPC 2, HARQ process 4, DAI 2, VRB format 1, TB swap 1, SPS release 1,
+  // PDCCH order 1, preamble index 6, PRACH mask index 4, Ngap 1, TBS index 5,
+  // DL power offset 1, PDCCH power offset 4
+  struct NiLteDlDciCodec
+  {
+    static const uint32_t bits = NI_LTE_CTRL_MSG__TYPE_BITS + 16 + 25 + 1 + 2 + 16 + 5 + 1 + 2 + 7 + 4 + 6 + 3 + 2 + 4 + 2 +
+                                 1 + 1 + 1 + 1 + 6 + 4 + 1 + 5 + 1 + 4;
+    static const uint32_t size = (bits + 7) / 8;
+
+    static inline void Encode (NiLteBitWriter& w, const DlDciListElement_s& dci)
+    {
+      w.Put (dci.m_rnti, 16);
+      w.Put (dci.m_rbBitmap, 25);
+      w.Put (dci.m_rbShift, 1);
+      w.Put (dci.m_resAlloc, 2);
+      w.Put (dci.m_tbsSize.at (0), 16);
+      w.Put (dci.m_mcs.at (0), 5);
+      w.Put (dci.m_ndi.at (0), 1);
+      w.Put (dci.m_rv.at (0), 2);
+      w.Put (dci.m_cceIndex, 7);
+      w.Put (dci.m_aggrLevel, 4);
+      w.Put (dci.m_precodingInfo, 6);
+      w.Put (dci.m_format, 3);
+      w.Put (dci.m_tpc, 2);
+      w.Put (dci.m_harqProcess, 4);
+      w.Put (dci.m_dai, 2);
+      w.Put (dci.m_vrbFormat, 1);
+      w.Put (dci.m_tbSwap, 1);
+      w.Put (dci.m_spsRelease, 1);
+      w.Put (dci.m_pdcchOrder, 1);
+      w.Put (dci.m_preambleIndex, 6);
+      w.Put (dci.m_prachMaskIndex, 4);
+      w.Put (dci.m_nGap, 1);
+      w.Put (dci.m_tbsIdx, 5);
+      w.Put (dci.m_dlPowerOffset, 1);
+      w.Put (dci.m_pdcchPowerOffset, 4);
+    }
+    // appends the transport block to the vectors of dci
+    static inline void Decode (NiLteBitReader& r, DlDciListElement_s* dci)
+    {
+      dci->m_rnti             = r.Get (16);
+      dci->m_rbBitmap         = r.Get (25);
+      dci->m_rbShift          = r.Get (1);
+      dci->m_resAlloc         = r.Get (2);
+      dci->m_tbsSize.push_back (r.Get (16));
+      dci->m_mcs.push_back (r.Get (5));
+      dci->m_ndi.push_back (r.Get (1));
+      dci->m_rv.push_back (r.Get (2));
+      dci->m_cceIndex         = r.Get (7);
+      dci->m_aggrLevel        = r.Get (4);
+      dci->m_precodingInfo    = r.Get (6);
+      dci->m_format           = (DlDciListElement_s::Format_e) r.Get (3);
+      dci->m_tpc              = r.Get (2);
+      dci->m_harqProcess      = r.Get (4);
+      dci->m_dai              = r.Get (2);
+      dci->m_vrbFormat        = (DlDciListElement_s::VrbFormat_e) r.Get (1);
+      dci->m_tbSwap           = r.Get (1);
+      dci->m_spsRelease       = r.Get (1);
+      dci->m_pdcchOrder       = r.Get (1);
+      dci->m_preambleIndex    = r.Get (6);
+      dci->m_prachMaskIndex   = r.Get (4);
+      dci->m_nGap             = (DlDciListElement_s::Ngap_e) r.Get (1);
+      dci->m_tbsIdx           = r.Get (5);
+      dci->m_dlPowerOffset    = r.Get (1);
+      dci->m_pdcchPowerOffset = r.Get (4);
+    }
+  };
+
+  // UL DCI: RNTI 16, RB start 7, RB length 7, TB size 16, MCS 5, NDI 1, CCE index 7,
+  // aggregation level 4, antenna selection 2, hopping 1, n2DMRS 3, TPC 4 (signed),
+  // CQI request 1, UL index 2, DAI 3, frequency hopping 2, PDCCH power offset 4 (signed)
+  struct NiLteUlDciCodec
+  {
+    static const uint32_t bits = NI_LTE_CTRL_MSG__TYPE_BITS + 16 + 7 + 7 + 16 + 5 + 1 + 7 + 4 + 2 + 1 + 3 + 4 + 1 + 2 + 3 + 2 + 4;
+    static const uint32_t size = (bits + 7) / 8;
+
+    static inline void Encode (NiLteBitWriter& w, const UlDciListElement_s& dci)
+    {
+      w.Put (dci.m_rnti, 16);
+      w.Put (dci.m_rbStart, 7);
+      w.Put (dci.m_rbLen, 7);
+      w.Put (dci.m_tbSize, 16);
+      w.Put (dci.m_mcs, 5);
+      w.Put (dci.m_ndi, 1);
+      w.Put (dci.m_cceIndex, 7);
+      w.Put (dci.m_aggrLevel, 4);
+      w.Put (dci.m_ueTxAntennaSelection, 2);
+      w.Put (dci.m_hopping, 1);
+      w.Put (dci.m_n2Dmrs, 3);
+      w.PutSigned (dci.m_tpc, 4);
+      w.Put (dci.m_cqiRequest, 1);
+      w.Put (dci.m_ulIndex, 2);
+      w.Put (dci.m_dai, 3);
+      w.Put (dci.m_freqHopping, 2);
+      w.PutSigned (dci.m_pdcchPowerOffset, 4);
+    }
+    static inline void Decode (NiLteBitReader& r, UlDciListElement_s* dci)
+    {
+      dci->m_rnti                 = r.Get (16);
+      dci->m_rbStart              = r.Get (7);
+      dci->m_rbLen                = r.Get (7);
+      dci->m_tbSize               = r.Get (16);
+      dci->m_mcs                  = r.Get (5);
+      dci->m_ndi                  = r.Get (1);
+      dci->m_cceIndex             = r.Get (7);
+      dci->m_aggrLevel            = r.Get (4);
+      dci->m_ueTxAntennaSelection = r.Get (2);
+      dci->m_hopping              = r.Get (1);
+      dci->m_n2Dmrs               = r.Get (3);
+      dci->m_tpc                  = r.GetSigned (4);
+      dci->m_cqiRequest           = r.Get (1);
+      dci->m_ulIndex              = r.Get (2);
+      dci->m_dai                  = r.Get (3);
+      dci->m_freqHopping          = r.Get (2);
+      dci->m_pdcchPowerOffset     = r.GetSigned (4);
+    }
+  };
+
+  // DL CQI: RNTI 16, RI 3, CQI type 4, number of wideband CQIs 1, number of subband
+  // CQIs 5, followed by the wideband and subband CQIs of the first layer with 4 each
+  // (wbPmi, ueSelected, bwPart, sbList and sbPmi are not sent)
+  struct NiLteDlCqiCodec
+  {
+    static const uint32_t bits = NI_LTE_CTRL_MSG__TYPE_BITS + 16 + 3 + 4 + 1 + 5;
+    static const uint32_t maxNumSbCqi = 31;
+    static inline uint32_t Size (uint32_t numWbCqi, uint32_t numSbCqi)
+    {
+      return NiLteCtrlMsgBytes (bits + (numWbCqi + numSbCqi) * 4);
+    }
+
+    static inline void Encode (NiLteBitWriter& w, const CqiListElement_s& cqi)
+    {
+      const uint32_t numWbCqi = cqi.m_wbCqi.empty () ? 0 : 1;
+      uint32_t numSbCqi = cqi.m_sbMeasResult.m_higherLayerSelected.size ();
+      if (numSbCqi > maxNumSbCqi)
+        {
+          numSbCqi = maxNumSbCqi;
+        }
+      w.Put (cqi.m_rnti, 16);
+      w.Put (cqi.m_ri, 3);
+      w.Put (cqi.m_cqiType, 4);
+      w.Put (numWbCqi, 1);
+      w.Put (numSbCqi, 5);
+      if (numWbCqi > 0)
+        {
+          w.Put (cqi.m_wbCqi[0], 4);
+        }
+      for (uint32_t i = 0; i < numSbCqi; i++)
+        {
+          w.Put (cqi.m_sbMeasResult.m_higherLayerSelected[i].m_sbCqi.at (0), 4);
+        }
+    }
+    static inline void Decode (NiLteBitReader& r, CqiListElement_s* cqi)
+    {
+      cqi->m_rnti    = r.Get (16);
+      cqi->m_ri      = r.Get (3);
+      cqi->m_cqiType = (CqiListElement_s::CqiType_e) r.Get (4);
+      const uint32_t numWbCqi = r.Get (1);
+      const uint32_t numSbCqi = r.Get (5);
+      if (numWbCqi > 0)
+        {
+          cqi->m_wbCqi.push_back (r.Get (4));
+        }
+      cqi->m_sbMeasResult.m_higherLayerSelected.resize (numSbCqi);
+      for (uint32_t i = 0; i < numSbCqi; i++)
+        {
+          cqi->m_sbMeasResult.m_higherLayerSelected[i].m_sbCqi.push_back (r.Get (4));
+        }
+    }
+  };
+
+  // BSR: RNTI 16, MAC CE type 2, PHR 6, C-RNTI 8 (as in MacCeValue_u), buffer status of the four LCGs 6 each
+  struct NiLteBsrCodec
+  {
+    static const uint32_t bits = NI_LTE_CTRL_MSG__TYPE_BITS + 16 + 2 + 6 + 8 + 4 * 6;
+    static const uint32_t size = (bits + 7) / 8;
+
+    static inline void Encode (NiLteBitWriter& w, const MacCeListElement_s& bsr)
+    {
+      w.Put (bsr.m_rnti, 16);
+      w.Put (bsr.m_macCeType, 2);
+      w.Put (bsr.m_macCeValue.m_phr, 6);
+      w.Put (bsr.m_macCeValue.m_crnti, 8);
+      // always four, see LteUeMac::SendReportBufferStatus
+      for (uint32_t i = 0; i < 4; i++)
+        {
+          w.Put (bsr.m_macCeValue.m_bufferStatus.at (i), 6);
+        }
+    }
+    static inline void Decode (NiLteBitReader& r, MacCeListElement_s* bsr)
+    {
+      bsr->m_rnti                 = r.Get (16);
+      bsr->m_macCeType            = (MacCeListElement_s::MacCeType_e) r.Get (2);
+      bsr->m_macCeValue.m_phr     = r.Get (6);
+      bsr->m_macCeValue.m_crnti   = r.Get (8);
+      for (uint32_t i = 0; i < 4; i++)
+        {
+          bsr->m_macCeValue.m_bufferStatus.push_back (r.Get (6));
+        }
+    }
+  };
+
+  // RACH preamble: RAPID 6
+  struct NiLteRachPreambleCodec
+  {
+    static const uint32_t bits = NI_LTE_CTRL_MSG__TYPE_BITS + 6;
+    static const uint32_t size = (bits + 7) / 8;
+
+    static inline void Encode (NiLteBitWriter& w, uint32_t rapId)
+    {
+      w.Put (rapId, 6);
+    }
+    static inline uint32_t Decode (NiLteBitReader& r)
+    {
+      return r.Get (6);
+    }
+  };
+
+  //--------------------------------------------------------------------------------------
+  // payload packets: number of packets 16, per packet its size 16, the tag sidecar and
+  // the serialized packet
+  //
+  // The tag sidecar carries the packet tags which are not serialized with the packet:
+  // RNTI 16, LCID 5, layer 1, RLC tag present 1, PDCP tag present 1, followed by the
+  // RLC and PDCP sender timestamps in ns with 64 each (zero if the tag is not present)
+  //--------------------------------------------------------------------------------------
+
+  struct NiLtePacketTags {
+    uint16_t rnti;
+    uint8_t  lcid;
+    uint8_t  layer;
+    bool     hasRlcTag;
+    bool     hasPdcpTag;
+    int64_t  rlcTimestamp;
+    int64_t  pdcpTimestamp;
+  };
+
+  struct NiLteDataFrameCodec
+  {
+    static const uint32_t bits = 16;
+    static const uint32_t size = (bits + 7) / 8;
+    static const uint32_t bitsPerPacket = 16 + 16 + 5 + 1 + 1 + 1 + 64 + 64;
+    static const uint32_t sizePerPacket = (bitsPerPacket + 7) / 8;
+
+    // packet size and tag sidecar in one pass
+    static inline void EncodePacket (NiLteBitWriter& w, uint32_t packetSize, const NiLtePacketTags& tags)
+    {
+      w.Put (packetSize, 16);
+      w.Put (tags.rnti, 16);
+      w.Put (tags.lcid, 5);
+      w.Put (tags.layer, 1);
+      w.Put (tags.hasRlcTag, 1);
+      w.Put (tags.hasPdcpTag, 1);
+      PutTimestamp (w, tags.rlcTimestamp);
+      PutTimestamp (w, tags.pdcpTimestamp);
+    }
+    static inline uint32_t DecodePacket (NiLteBitReader& r, NiLtePacketTags* tags)
+    {
+      const uint32_t packetSize = r.Get (16);
+      tags->rnti          = r.Get (16);
+      tags->lcid          = r.Get (5);
+      tags->layer         = r.Get (1);
+      tags->hasRlcTag     = r.Get (1);
+      tags->hasPdcpTag    = r.Get (1);
+      tags->rlcTimestamp  = GetTimestamp (r);
+      tags->pdcpTimestamp = GetTimestamp (r);
+      return packetSize;
+    }
+
+  private:
+    static inline void PutTimestamp (NiLteBitWriter& w, int64_t timestamp)
+    {
+      w.Put ((uint32_t) ((uint64_t) timestamp >> 32), 32);
+      w.Put ((uint32_t) timestamp, 32);
+    }
+    static inline int64_t GetTimestamp (NiLteBitReader& r)
+    {
+      const uint64_t hi = r.Get (32);
+      return (int64_t) ((hi << 32) | r.Get (32));
+    }
+  };
+
+} // namespace ns3
+
+#endif /* NI_LTE_CTRL_MSG_CODEC_H_ */
@@ -37,11 +37,6 @@
 
 #include "ni-lte-phy-interface.h"
 
-#include "ns3/ni-api-rlc-tag-header.h"
-#include "ns3/ni-api-pdcp-tag-header.h"
-#include "ns3/ni-api-radio-bearer-header.h"
-#include "ns3/ni-api-packet-tag-info-header.h"
-
 #include "ns3/ni.h"
 #include "ns3/ni-l1-l2-api-lte-tables.h"
 
@@ -51,6 +46,19 @@ namespace ns3
 
   NS_OBJECT_ENSURE_REGISTERED (NiLtePhyInterface);
 
+  // definitions of the message sizes of ni-lte-ctrl-msg-codec.h, they are passed by reference
+  const uint32_t NiLtePacketHeaderCodec::size;
+  const uint32_t NiLteMibCodec::size;
+  const uint32_t NiLteSib1Codec::size;
+  const uint32_t NiLteDlDciCodec::size;
+  const uint32_t NiLteUlDciCodec::size;
+  const uint32_t NiLteBsrCodec::size;
+  const uint32_t NiLteRachPreambleCodec::size;
+
+  // AFW instances used by the pipe transports of the PHYs of this process, e.g. one
+  // per eNB of a multi-cell scenario, released again when the transport is closed
+  static std::bitset<NI_PIPE_MAX_INSTANCES> g_niApiUsedInstances;
+
   TypeId
   NiLtePhyInterface::GetTypeId (void)
   {
@@ -78,6 +86,81 @@ namespace ns3
                      UintegerValue (100),
                      MakeUintegerAccessor (&NiLtePhyInterface::m_niCqiReportPeriodMs),
                      MakeUintegerChecker<uint8_t> ())
+      .AddAttribute ("niApiPipeRxMode",
+                     "Receive mode of the NI API pipe transport (NIAPI_PIPE_RX_POLLING or NIAPI_PIPE_RX_EPOLL)",
+                     StringValue ("NIAPI_PIPE_RX_POLLING"),
+                     MakeStringAccessor (&NiLtePhyInterface::SetNiApiPipeRxMode),
+                     MakeStringChecker ())
+      .AddAttribute ("niApiTransportType",
+                     "Transport used for the NI API (NIAPI_TRANSPORT_PIPE or NIAPI_TRANSPORT_SHM)",
+                     StringValue ("NIAPI_TRANSPORT_PIPE"),
+                     MakeStringAccessor (&NiLtePhyInterface::SetNiApiTransportType),
+                     MakeStringChecker ())
+      .AddAttribute ("niApiInstanceId",
+                     "AFW instance (api_transport_<instance>-*) of the first PHY using the NI API, further PHYs of the process use the next free instances",
+                     UintegerValue (0),
+                     MakeUintegerAccessor (&NiLtePhyInterface::m_niApiInstanceId),
+                     MakeUintegerChecker<uint32_t> (0, NI_PIPE_MAX_INSTANCES - 1))
+      .AddAttribute ("niRxPduQueueSize",
+                     "Number of MAC PDUs that can be queued between the NI API pipe rx thread and the simulator thread",
+                     UintegerValue (64),
+                     MakeUintegerAccessor (&NiLtePhyInterface::m_niRxPduQueueSize),
+                     MakeUintegerChecker<uint32_t> (1, 4096))
+      .AddAttribute ("niTimingIndSpinUs",
+                     "Time in microseconds the simulator thread spins for the next PHY timing indication before blocking",
+                     UintegerValue (50),
+                     MakeUintegerAccessor (&NiLtePhyInterface::m_niTimingIndSpinUs),
+                     MakeUintegerChecker<uint32_t> ())
+      .AddAttribute ("niDeadlineBudgetUs",
+                     "Time in microseconds from the PHY timing indication until the tx requests of the subframe have to be sent",
+                     UintegerValue (1000),
+                     MakeUintegerAccessor (&NiLtePhyInterface::m_niDeadlineBudgetUs),
+                     MakeUintegerChecker<uint32_t> ())
+      .AddAttribute ("niDeadlineMarginUs",
+                     "Subframes with less slack in microseconds to the deadline budget count as tight",
+                     UintegerValue (200),
+                     MakeUintegerAccessor (&NiLtePhyInterface::m_niDeadlineMarginUs),
+                     MakeUintegerChecker<uint32_t> ())
+      .AddAttribute ("niDeadlineMaxLevel",
+                     "Highest degradation level when falling behind (0 normal, 1 no debug log, 2 no CQI, 3 defer remote control, 4 cap PDUs)",
+                     UintegerValue (NI_DEADLINE_LEVEL_CAP_PDUS),
+                     MakeUintegerAccessor (&NiLtePhyInterface::m_niDeadlineMaxLevel),
+                     MakeUintegerChecker<uint32_t> (NI_DEADLINE_LEVEL_NORMAL, NI_DEADLINE_NUM_LEVELS - 1))
+      .AddAttribute ("niDeadlineDegradeRate",
+                     "Running rate of tight subframes stepping one degradation level down",
+                     DoubleValue (0.1),
+                     MakeDoubleAccessor (&NiLtePhyInterface::m_niDeadlineDegradeRate),
+                     MakeDoubleChecker<double> (0.0, 1.0))
+      .AddAttribute ("niDeadlineRecoverRate",
+                     "Running rate of tight subframes restoring one degradation level",
+                     DoubleValue (0.02),
+                     MakeDoubleAccessor (&NiLtePhyInterface::m_niDeadlineRecoverRate),
+                     MakeDoubleChecker<double> (0.0, 1.0))
+      .AddAttribute ("niDeadlinePduCap",
+                     "Maximum number of UEs the eNB MAC schedules per TTI, one MAC PDU each, at the highest degradation level",
+                     UintegerValue (1),
+                     MakeUintegerAccessor (&NiLtePhyInterface::m_niDeadlinePduCap),
+                     MakeUintegerChecker<uint32_t> (1, 0xFFFF))
+      .AddAttribute ("niLinkAdaptationEnable",
+                     "Derive the CQI reports from the PHY subband SINR corrected by an outer loop on the CRC results",
+                     BooleanValue (false),
+                     MakeBooleanAccessor (&NiLtePhyInterface::m_niLinkAdaptationEnable),
+                     MakeBooleanChecker ())
+      .AddAttribute ("niLinkAdaptationBlerTarget",
+                     "Block error rate the outer loop link adaptation converges to",
+                     DoubleValue (0.1),
+                     MakeDoubleAccessor (&NiLtePhyInterface::m_niLinkAdaptationBlerTarget),
+                     MakeDoubleChecker<double> (0.01, 0.5))
+      .AddAttribute ("niLinkAdaptationStepDb",
+                     "SINR offset decrease in dB on each CRC error of the outer loop link adaptation",
+                     DoubleValue (0.5),
+                     MakeDoubleAccessor (&NiLtePhyInterface::m_niLinkAdaptationStepDb),
+                     MakeDoubleChecker<double> (0.0, 10.0))
+      .AddAttribute ("niApiDlMultiPdu",
+                     "Send the downlink MAC PDUs of all UEs of a TTI with one config / payload request pair",
+                     BooleanValue (false),
+                     MakeBooleanAccessor (&NiLtePhyInterface::m_niApiDlMultiPdu),
+                     MakeBooleanChecker ())
       .AddAttribute ("enableNiApi",
                      "Enable NI API",
                      BooleanValue (false),
@@ -111,11 +194,27 @@ namespace ns3
     m_rnti(0),
     m_mcs(0),
     m_tbsSize(0),
+    m_niLteSdrTimingSync(CreateObject <NiLteSdrTimingSync> ()),
     m_sfnSfOffset(0),
     m_lastTimingIndTimeUs(0),
-    m_niLteSdrTimingSync(CreateObject <NiLteSdrTimingSync> ())
+    m_lastTimingIndSeqNum(0),
+    m_niTimingIndSpinUs(50),
+    m_numTimingDiffWarning(0),
+    m_numTimingDiffError(0),
+    m_numTimingDiffFatal(0),
+    m_niApiPipeRxMode(NI_PIPE_RX_MODE_POLLING),
+    m_niApiShmTransport(false),
+    m_niRxPduQueue(NULL),
+    m_niRxPduQueueSize(64),
+    m_niRxPduQueueNumBatches(0),
+    m_niRxNumDecodeErrors(0),
+    m_rcParameterVersion(UINT64_MAX)
   {
-
+    m_rxPackets.reserve (NI_LTE_PHY_POOL_SIZE);
+    m_txPackets.reserve (NI_LTE_PHY_POOL_SIZE);
+    m_rxCtrlMsgListPool.resize (NI_LTE_PHY_POOL_SIZE);
+    // room for a complete multi PDU payload plus one PDU under construction
+    m_dlTxPduBuffer.resize (2 * NI_COMMON_CONST_MAX_PAYLOAD_SIZE);
   }
 
   NiLtePhyInterface::~NiLtePhyInterface ()
@@ -152,6 +251,19 @@ namespace ns3
   {
     if (m_enableNiApi && !m_initializationDone)
       {
+        NiDeadlineMonitorConfig deadlineConfig;
+        deadlineConfig.budgetUs = m_niDeadlineBudgetUs;
+        deadlineConfig.marginUs = m_niDeadlineMarginUs;
+        deadlineConfig.maxLevel = m_niDeadlineMaxLevel;
+        deadlineConfig.degradeRate = m_niDeadlineDegradeRate;
+        deadlineConfig.recoverRate = m_niDeadlineRecoverRate;
+        m_deadlineMonitor.Configure (deadlineConfig);
+
+        NiLinkAdaptationConfig linkAdaptationConfig;
+        linkAdaptationConfig.blerTarget = m_niLinkAdaptationBlerTarget;
+        linkAdaptationConfig.stepDownDb = m_niLinkAdaptationStepDb;
+        m_linkAdaptation.Configure (linkAdaptationConfig);
+
         if (m_enableNiApiLoopback)
           {
             // initialize ni udp transport layer - used here only for debug purpose
@@ -213,14 +325,14 @@ namespace ns3
         // create udp tx/rx sockets for enb config
         if (((m_niApiDevType==NIAPI_ENB)||(m_niApiDevType==NIAPI_ALL))&&(m_ns3DevType==NS3_ENB)){
             // set callback function for rx packets
-            m_niUdpTransport->SetNiApiDataEndOkCallback (MakeCallback (&NiLtePhyInterface::NiStartRxCtrlDataFrame, this));
+            m_niUdpTransport->SetNiApiDataEndOkCallback (MakeCallback (&NiLtePhyInterface::NiStartRxUdpCtrlDataFrame, this));
             m_niUdpTransport->OpenUdpSocketTx(m_niUdpSta1RemoteIpAddrTx, m_niUdpSta1RemotePortTx);
             m_niUdpTransport->OpenUdpSocketRx(m_niUdpSta1LocalPortRx, rxThreadPriority);
         }
         // create udp tx/rx sockets for ue config
         else if (((m_niApiDevType==NIAPI_UE)||(m_niApiDevType==NIAPI_ALL))&&(m_ns3DevType==NS3_UE)) {
             // set callback function for rx packets
-            m_niUdpTransport->SetNiApiDataEndOkCallback (MakeCallback (&NiLtePhyInterface::NiStartRxCtrlDataFrame, this));
+            m_niUdpTransport->SetNiApiDataEndOkCallback (MakeCallback (&NiLtePhyInterface::NiStartRxUdpCtrlDataFrame, this));
             m_niUdpTransport->OpenUdpSocketTx(m_niUdpSta2RemoteIpAddrTx, m_niUdpSta2RemotePortTx);
             m_niUdpTransport->OpenUdpSocketRx(m_niUdpSta2LocalPortRx, rxThreadPriority);
         }
@@ -275,14 +387,45 @@ namespace ns3
             int ns3Priority = NiUtils::GetThreadPrioriy();
             const int niTransportPhyTimingIndPrio = ns3Priority;
             const int niTransportPhyRxPrio = ns3Priority - 5;
-            // create udp transport object
-            m_niPipeTransport = CreateObject <NiPipeTransport> ("LTE");
+            // create named pipe or shared memory transport object
+            if (m_niApiShmTransport)
+              {
+                m_niPipeTransport = CreateObject <NiShmTransport> ("LTE");
+              }
+            else
+              {
+                m_niPipeTransport = CreateObject <NiPipeTransport> ("LTE");
+              }
+            // select polling or event driven reception
+            m_niPipeTransport->SetRxMode(m_niApiPipeRxMode);
+            // each PHY of the process drives its own AFW instance, callbacks below are bound to this PHY
+            uint32_t instanceId = m_niApiInstanceId;
+            while ((instanceId < NI_PIPE_MAX_INSTANCES) && g_niApiUsedInstances.test (instanceId))
+              {
+                instanceId++;
+              }
+            if (instanceId == NI_PIPE_MAX_INSTANCES)
+              {
+                NI_LOG_FATAL("No free AFW instance from " << m_niApiInstanceId << " on, all " << NI_PIPE_MAX_INSTANCES << " are in use");
+              }
+            g_niApiUsedInstances.set (instanceId);
+            m_niPipeTransport->SetInstanceId(instanceId);
+            // queue for received MAC PDUs, drained by the simulator thread in NiStartSubframe
+            m_niRxPduQueue = new NiSpscRing<NiRxPduQueueEntry> (m_niRxPduQueueSize);
+            m_niRxPduQueueNumBatches = 0;
+            // queue for the SINR reports and CRC results of the link adaptation, drained together with the rx queue
+            m_niLinkAdaptationQueue = new NiSpscRing<NiLinkAdaptationQueueEntry> (m_niRxPduQueueSize);
+            // set call back for Rx Control and Data Frames
+            m_niPipeTransport->SetNiApiDataEndOkCallback (MakeCallback (&NiLtePhyInterface::NiEnqueueRxCtrlDataFrame, this));
             // init transport layer for LTE
             m_niPipeTransport->Init(niTransportPhyTimingIndPrio, niTransportPhyRxPrio);
-            // set call back for Rx Control and Data Frames
-            m_niPipeTransport->SetNiApiDataEndOkCallback (MakeCallback (&NiLtePhyInterface::NiStartRxCtrlDataFrame, this));
             // set call back for Rx Cell Measurement Report
             m_niPipeTransport->SetNiApiCellMeasurementEndOkCallback (MakeCallback (&NiLtePhyInterface::NiStartRxCellMeasurementIndHandler, this));
+            // set call back for the CRC results of received transport blocks
+            if (m_niLinkAdaptationEnable)
+              {
+                m_niPipeTransport->SetNiApiCrcResultCallback (MakeCallback (&NiLtePhyInterface::NiStartRxCrcResultHandler, this));
+              }
             // set device type
             m_niPipeTransport->SetNiApiDevType(m_niApiDevType);
           }
@@ -303,9 +446,48 @@ namespace ns3
           {
             // de-init transport layer for LTE
             m_niPipeTransport->DeInit();
+            g_niApiUsedInstances.reset (m_niPipeTransport->GetInstanceId());
             // remove call backs
-            m_niPipeTransport->SetNiApiDataEndOkCallback (MakeNullCallback< bool, uint8_t* >());
+            m_niPipeTransport->SetNiApiDataEndOkCallback (MakeNullCallback< bool, uint8_t*, uint32_t >());
             m_niPipeTransport->SetNiApiCellMeasurementEndOkCallback (MakeNullCallback< bool, PhyCellMeasInd >());
+            m_niPipeTransport->SetNiApiCrcResultCallback (MakeNullCallback< bool, uint16_t, bool >());
+            // rx thread is stopped now, print and release rx queue
+            NI_LOG_CONSOLE_INFO("\n-------- NI LTE PHY Rx PDU Queue --------");
+            NI_LOG_CONSOLE_INFO("Capacity           = " << m_niRxPduQueue->GetCapacity());
+            NI_LOG_CONSOLE_INFO("Enqueued           = " << m_niRxPduQueue->GetNumPushed());
+            NI_LOG_CONSOLE_INFO("Dequeued           = " << m_niRxPduQueue->GetNumPopped());
+            NI_LOG_CONSOLE_INFO("Dropped            = " << m_niRxPduQueue->GetNumDropped());
+            NI_LOG_CONSOLE_INFO("Max depth          = " << m_niRxPduQueue->GetMaxDepth());
+            NI_LOG_CONSOLE_INFO("Drained batches    = " << m_niRxPduQueueNumBatches);
+            NI_LOG_CONSOLE_INFO("Decode errors      = " << m_niRxNumDecodeErrors);
+            NI_LOG_CONSOLE_INFO("-----------------------------------------\n");
+            NI_LOG_CONSOLE_INFO("-------- NI LTE PHY Timing --------------");
+            NI_LOG_CONSOLE_INFO("Subframes > 333 us = " << m_numTimingDiffWarning);
+            NI_LOG_CONSOLE_INFO("Subframes > 666 us = " << m_numTimingDiffError);
+            NI_LOG_CONSOLE_INFO("Subframes > 1 TTI  = " << m_numTimingDiffFatal);
+            m_deadlineMonitor.Print();
+            if (m_numDeadlineSkippedUes > 0)
+              {
+                NI_LOG_CONSOLE_INFO("Skipped UEs        = " << m_numDeadlineSkippedUes << " (cap " << m_niDeadlinePduCap << " per TTI)");
+              }
+            const NiTimingIndWaitStats& waitStats = m_niPipeTransport->GetTimingIndWaitStats();
+            if (waitStats.numWakeLatency > 0)
+              {
+                NI_LOG_CONSOLE_INFO("Wake latency       = avg " << (waitStats.sumWakeLatencyNs / waitStats.numWakeLatency) / 1000.0 <<
+                                    " us, max " << waitStats.maxWakeLatencyNs / 1000.0 << " us (spin " << m_niTimingIndSpinUs << " us)");
+              }
+            NI_LOG_CONSOLE_INFO("-----------------------------------------\n");
+            if (m_niLinkAdaptationEnable)
+              {
+                NI_LOG_CONSOLE_INFO("-------- NI LTE Link Adaptation ---------");
+                m_linkAdaptation.Print();
+                NI_LOG_CONSOLE_INFO("Reports dropped    = " << m_niLinkAdaptationQueue->GetNumDropped());
+                NI_LOG_CONSOLE_INFO("-----------------------------------------\n");
+              }
+            delete m_niRxPduQueue;
+            m_niRxPduQueue = NULL;
+            delete m_niLinkAdaptationQueue;
+            m_niLinkAdaptationQueue = NULL;
           }
     }
     else {
@@ -370,6 +552,36 @@ namespace ns3
     return;
   }
 
+  void
+  NiLtePhyInterface::SetNiApiPipeRxMode (std::string mode)
+  {
+    NI_LOG_DEBUG(this << " - Set NI LTE API Pipe Rx Mode to " << mode);
+
+    if (mode == "NIAPI_PIPE_RX_POLLING")
+      m_niApiPipeRxMode = NI_PIPE_RX_MODE_POLLING;
+    else if (mode == "NIAPI_PIPE_RX_EPOLL")
+      m_niApiPipeRxMode = NI_PIPE_RX_MODE_EPOLL;
+    else
+      NI_LOG_FATAL("\nNiLtePhyInterface::m_niApiPipeRxMode: Unrecognizable option for NI API pipe rx mode");
+
+    return;
+  }
+
+  void
+  NiLtePhyInterface::SetNiApiTransportType (std::string type)
+  {
+    NI_LOG_DEBUG(this << " - Set NI LTE API Transport Type to " << type);
+
+    if (type == "NIAPI_TRANSPORT_PIPE")
+      m_niApiShmTransport = false;
+    else if (type == "NIAPI_TRANSPORT_SHM")
+      m_niApiShmTransport = true;
+    else
+      NI_LOG_FATAL("\nNiLtePhyInterface::m_niApiShmTransport: Unrecognizable option for NI API transport type");
+
+    return;
+  }
+
   NiApiDevType_t
   NiLtePhyInterface::GetNiApiDevType () const
   {
@@ -420,6 +632,8 @@ namespace ns3
     m_chSinrDb  = chSinrDb;
 
     m_chSinrLin = pow(10, m_chSinrDb/10);
+
+    g_RemoteControlEngine.GetPdb()->lteChannelSinrStat.Set(chSinrDb);
   }
 
   double
@@ -428,6 +642,23 @@ namespace ns3
     return m_chSinrDb;
   }
 
+  uint32_t
+  NiLtePhyInterface::GetNiMaxUesPerTti () const
+  {
+    // one mac pdu is serialized per ue, the mac applies the cap before the rlc pdus are dequeued
+    if (m_enableNiApi && m_deadlineMonitor.IsActive (NI_DEADLINE_LEVEL_CAP_PDUS))
+      {
+        return m_niDeadlinePduCap;
+      }
+    return 0;
+  }
+
+  void
+  NiLtePhyInterface::NiNotifySkippedUes (uint32_t numUes)
+  {
+    m_numDeadlineSkippedUes += numUes;
+  }
+
   uint64_t
   NiLtePhyInterface::NiSfnTtiCounterSync (uint32_t* m_nrFrames, uint32_t* m_nrSubFrames)
   {
@@ -468,22 +699,37 @@ namespace ns3
   void
   NiLtePhyInterface::NiGenerateCqiReport ()
   {
+    // the last report stays valid at the eNB while the real-time loop is degraded
+    if (!m_deadlineMonitor.IsActive (NI_DEADLINE_LEVEL_NO_CQI))
+      {
+        // convert sinr value ns-3 SpectrumValue format
+        Ptr<LteSpectrumPhy>      spectrumPhy   = m_niPhySpectrumModelCallback();
+        Ptr<const SpectrumModel> spectrumModel = spectrumPhy->GetRxSpectrumModel();
+        Ptr<SpectrumValue>       spectrumSinr  = Create<SpectrumValue>(spectrumModel);
+
+        // the subband SINR of the PHY corrected by the outer loop, unless the SINR is set manually via remote control
+        std::vector<double> sinrPerRbDb;
+        if (m_niLinkAdaptationEnable &&
+            (g_RemoteControlEngine.GetPdb()->getParameterManualLteUeChannelSinrEnable() == false) &&
+            m_linkAdaptation.GetSinrPerRb (NI_LINK_ADAPTATION__OWN_LINK, spectrumSinr->GetSpectrumModel ()->GetNumBands (), &sinrPerRbDb))
+          {
+            NI_LOG_DEBUG(this << " - NI CQI Report generated with subband SINR, outer loop offset " <<
+                         m_linkAdaptation.GetOffsetDb (NI_LINK_ADAPTATION__OWN_LINK) << " dB");
+            for (uint32_t rb = 0; rb < sinrPerRbDb.size (); rb++)
+              {
+                (*spectrumSinr)[rb] = pow (10, sinrPerRbDb[rb] / 10);
+              }
+          }
+        else
+          {
+            NI_LOG_DEBUG(this << " - NI CQI Report generated with SINR " << m_chSinrDb << " dB");
+            // add wideband sinr value to SpectrumValue vector
+            (*spectrumSinr) += m_chSinrLin;
+          }
 
-    // here only wideband SINR/CQI is used
-    // TODO-NI: add subband SINR/CQI if needed
-
-    NI_LOG_DEBUG(this << " - NI CQI Report generated with SINR " << m_chSinrDb << " dB");
-
-    // convert sinr value ns-3 SpectrumValue format
-    Ptr<LteSpectrumPhy>      spectrumPhy   = m_niPhySpectrumModelCallback();
-    Ptr<const SpectrumModel> spectrumModel = spectrumPhy->GetRxSpectrumModel();
-    Ptr<SpectrumValue>       spectrumSinr  = Create<SpectrumValue>(spectrumModel);
-
-    // add sinr value to SpectrumValue vector
-    (*spectrumSinr) += m_chSinrLin;
-
-    // call function to create cqi report
-    m_niPhyRxCqiReportCallback(*spectrumSinr);
+        // call function to create cqi report
+        m_niPhyRxCqiReportCallback(*spectrumSinr);
+      }
 
     // schedule next function call
     Simulator::Schedule(MilliSeconds(m_niCqiReportPeriodMs), &NiLtePhyInterface::NiGenerateCqiReport, this);
@@ -497,6 +743,23 @@ namespace ns3
         NI_LOG_FATAL (this << " - DL: payloadDataBufOffset > m_tbsSize");
     }
 
+    if (m_niApiDlMultiPdu){
+        // queue the mac pdu, the caller buffer has to stay valid until NiFlushTxApiPdus
+        const uint32_t pduBytes = PHY_TX_PAYLOAD_PAR_SET_HDR_SIZE + m_tbsSize;
+        if ((m_numDlTxPdus == MAX_NUM_DLSCH_PDUS) ||
+            (16 + m_dlTxPduBytes + pduBytes > NI_COMMON_CONST_MAX_PAYLOAD_SIZE)){
+            NiFlushTxApiPdus ();
+        }
+        NiDlschTxPdu* pPdu = &m_dlTxPdus[m_numDlTxPdus++];
+        pPdu->prbAlloc = m_rbBitmap;
+        pPdu->rnti     = m_rnti;
+        pPdu->mcs      = m_mcs;
+        pPdu->macPdu   = payloadDataBuffer;
+        pPdu->tbsSize  = m_tbsSize;
+        m_dlTxPduBytes += pduBytes;
+        return true;
+    }
+
     // chose api transport layer
     if (m_enableNiApiLoopback){ // send message over udp loopback channel to rx station
         m_niUdpTransport->SendToUdpSocketTx(payloadDataBuffer, m_tbsSize);
@@ -513,12 +776,38 @@ namespace ns3
     // call rx function directly - useful for debugging
     //NiStartRxCtrlDataFrame((uint8_t*)&payloadDataBuffer);
 
+    return true;
+  }
+
+  // sends the queued downlink mac pdus with one write
+  void
+  NiLtePhyInterface::NiFlushTxApiPdus (void)
+  {
+    if (m_numDlTxPdus == 0){
+        return;
+    }
+
+    if (m_enableNiApiLoopback){ // one datagram per mac pdu, all sent with one sendmmsg
+        uint8_t* txBuffers[MAX_NUM_DLSCH_PDUS];
+        uint32_t txBufferSizes[MAX_NUM_DLSCH_PDUS];
+        for (uint32_t i = 0; i < m_numDlTxPdus; i++){
+            txBuffers[i]     = m_dlTxPdus[i].macPdu;
+            txBufferSizes[i] = m_dlTxPdus[i].tbsSize;
+        }
+        m_niUdpTransport->SendToUdpSocketTxMsgs(0, txBuffers, txBufferSizes, m_numDlTxPdus);
+    } else if (m_niPipeTransport->CreateAndSendDlTxReqMsgs(m_sfn, m_tti, m_dlTxPdus, m_numDlTxPdus) < 0){
+        NI_LOG_FATAL (this << " - DL: Could not send DL Config / Payload Request Messages");
+    }
+
+    m_numDlTxPdus  = 0;
+    m_dlTxPduBytes = 0;
   }
 
   bool
-  NiLtePhyInterface::NiStartTxCtrlDataFrame (Ptr<PacketBurst> packetBurst, std::list<Ptr<LteControlMessage> > ctrlMsgList, uint32_t m_nrFrames, uint32_t m_nrSubFrames)
+  NiLtePhyInterface::NiStartTxCtrlDataFrame (Ptr<PacketBurst> packetBurst, const std::list<Ptr<LteControlMessage> > &ctrlMsgList, uint32_t m_nrFrames, uint32_t m_nrSubFrames)
   {
-    NI_LOG_TRACE("[Trace#20],NiStartTxCtrlDataFrameStart," << ( NiUtils::GetSysTime()-g_logTraceStartSubframeTime));
+    const uint64_t startTimeNs = NiUtils::GetSysTimeNs();
+    NI_TRACE(NI_TRACE_TX_CTRL_DATA_FRAME_START, m_nrFrames, m_nrSubFrames, NiUtils::GetSysTime()-g_logTraceStartSubframeTime);
 
     if ((m_nrFrames!=m_sfn)||(m_nrSubFrames!=m_tti)){
         NI_LOG_DEBUG (this << " - SFN/TTI Counters out of sync");
@@ -543,9 +832,8 @@ namespace ns3
         struct NiApiPacketHeader niApiPacketHeader;
         niApiPacketHeader.niApiPacketType = NIAPI_DL_PACKET;
 
-        // include this as first element in pdu message
-        std::memcpy(payloadDataBuffer, (uint8_t*)&niApiPacketHeader, sizeof(niApiPacketHeader));
-        payloadDataBufOffset += sizeof(niApiPacketHeader);
+        // reserve the first element in pdu message, the header is written when the pdu is complete
+        payloadDataBufOffset += NiLtePacketHeaderCodec::size;
 
         // check if control messages available
         if (ctrlMsgList.size () > 0){
@@ -585,7 +873,7 @@ namespace ns3
                 niApiPacketHeader.numCtrlMsg      = controlMessageCnt;
                 niApiPacketHeader.numPaylMsg      = 0;
                 // include packet header as first element in payload buffer
-                std::memcpy(payloadDataBuffer, (uint8_t*)&niApiPacketHeader, sizeof(niApiPacketHeader));
+                NiLtePacketHeaderCodec::Write (payloadDataBuffer, niApiPacketHeader);
 
                 // send mac pdu with broadcast information to all ue's
                 NiStartTxApiSend ((uint8_t*)&payloadDataBuffer, (uint32_t*)&payloadDataBufOffset);
@@ -602,6 +890,18 @@ namespace ns3
                                   << " control messages available for rnti #" << curRnti
                                   << " / buffer offset=" << payloadDataBufOffsetTmp);
 
+                    // the mac pdu of each ue is built at its own place in the pdu buffer if all pdus
+                    // of the tti are sent together, starting with the common broadcast part
+                    uint8_t* pduBuffer = (uint8_t*)&payloadDataBuffer;
+                    if (m_niApiDlMultiPdu){
+                        if (m_dlTxPduBufferOffset > NI_COMMON_CONST_MAX_PAYLOAD_SIZE){
+                            NiFlushTxApiPdus ();
+                            m_dlTxPduBufferOffset = 0;
+                        }
+                        pduBuffer = m_dlTxPduBuffer.data () + m_dlTxPduBufferOffset;
+                        std::memcpy(pduBuffer, payloadDataBuffer, payloadDataBufOffsetTmp);
+                    }
+
                     // reset payload buffer offset
                     payloadDataBufOffset  = payloadDataBufOffsetTmp;
                     // reset control message cnt
@@ -609,7 +909,7 @@ namespace ns3
 
                     // downlink rnti specific control message processing (DL DCI, UL DCI)
                     // note: in the dl the payload data packet processing is done when receiving a dl dci message
-                    NiStartTxDlCtrlFrameUc (packetBurst, ctrlMsgList, (uint8_t*)&payloadDataBuffer, (uint32_t*)&payloadDataBufOffset, controlMessageCnt, curRnti);
+                    NiStartTxDlCtrlFrameUc (packetBurst, ctrlMsgList, pduBuffer, (uint32_t*)&payloadDataBufOffset, controlMessageCnt, curRnti);
 
                     // update api packet header infos
                     niApiPacketHeader.nrFrames        = m_sfn;
@@ -619,10 +919,13 @@ namespace ns3
                     niApiPacketHeader.numCtrlMsg      = controlMessageCnt;
                     niApiPacketHeader.numPaylMsg      = paylMessageCnt;
                     // include packet header as first element in payload buffer
-                    std::memcpy(payloadDataBuffer, (uint8_t*)&niApiPacketHeader, sizeof(niApiPacketHeader));
+                    NiLtePacketHeaderCodec::Write (pduBuffer, niApiPacketHeader);
 
                     // send mac pdu via ni api to specific ue
-                    NiStartTxApiSend ((uint8_t*)&payloadDataBuffer, (uint32_t*)&payloadDataBufOffset);
+                    NiStartTxApiSend (pduBuffer, (uint32_t*)&payloadDataBufOffset);
+                    if (m_niApiDlMultiPdu){
+                        m_dlTxPduBufferOffset += m_tbsSize;
+                    }
 
                   } // end rnti/ue loop
             }
@@ -633,6 +936,10 @@ namespace ns3
             //}
         } // end if ctrl msg list
 
+        // send the mac pdus of all ues of this tti
+        NiFlushTxApiPdus ();
+        m_dlTxPduBufferOffset = 0;
+
     } else if (((m_niApiDevType==NIAPI_UE)||(m_niApiDevType==NIAPI_ALL))&&(m_ns3DevType==NS3_UE)){
         // uplink transmitter
 
@@ -640,9 +947,8 @@ namespace ns3
         struct NiApiPacketHeader niApiPacketHeader;
         niApiPacketHeader.niApiPacketType = NIAPI_UL_PACKET;
 
-        // include this as first element in pdu message
-        std::memcpy(payloadDataBuffer, (uint8_t*)&niApiPacketHeader, sizeof(niApiPacketHeader));
-        payloadDataBufOffset += sizeof(niApiPacketHeader);
+        // reserve the first element in pdu message, the header is written when the pdu is complete
+        payloadDataBufOffset += NiLtePacketHeaderCodec::size;
 
         // check if control messages available
         if (ctrlMsgList.size () > 0){
@@ -674,7 +980,7 @@ namespace ns3
             niApiPacketHeader.cellId      = m_cellId;
             niApiPacketHeader.rnti        = m_rnti;
             // include packet header this as first element in payload buffer
-            std::memcpy(payloadDataBuffer, (uint8_t*)&niApiPacketHeader, sizeof(niApiPacketHeader));
+            NiLtePacketHeaderCodec::Write (payloadDataBuffer, niApiPacketHeader);
 
             // chose api transport layer
             if (m_enableNiApiLoopback){ // send message over udp loopback channel to rx station
@@ -694,33 +1000,45 @@ namespace ns3
         // do nothing
     }
 
-    NI_LOG_TRACE(" [Trace#21],NiStartTxCtrlDataFrameEnd," << ( NiUtils::GetSysTime()-g_logTraceStartSubframeTime));
+    g_NiLatency.Record(NI_LATENCY_TX_CTRL_DATA_FRAME, NiUtils::GetSysTimeNs() - startTimeNs);
+    NiUpdateDeadlineMonitor();
+    NI_TRACE(NI_TRACE_TX_CTRL_DATA_FRAME_END, m_nrFrames, m_nrSubFrames, NiUtils::GetSysTime()-g_logTraceStartSubframeTime);
 
   } // end NiStartTxCtrlDataFrame function
 
+  // the udp transport does not report the datagram size, its rx slots hold at least a MAC PDU
   bool
-  NiLtePhyInterface::NiStartRxCtrlDataFrame (uint8_t* payloadDataBuffer)
+  NiLtePhyInterface::NiStartRxUdpCtrlDataFrame (uint8_t* payloadDataBuffer)
   {
+    return NiStartRxCtrlDataFrame (payloadDataBuffer, MAX_MAC_PDU_SIZE);
+  }
+
+  bool
+  NiLtePhyInterface::NiStartRxCtrlDataFrame (uint8_t* payloadDataBuffer, uint32_t payloadDataBufSize)
+  {
+    NiAllocScope allocScope (NI_ALLOC_SCOPE_PHY_RX);
 
     // pointer to current payload buffer offset
     uint32_t payloadDataBufOffset = 0;
 
-    // create control message list and clear queue
-    std::list<Ptr<LteControlMessage> > ctrlMsgList;
-    ctrlMsgList.clear();
-    // create payload packet burst
-    Ptr<PacketBurst> packetBurst = Create <PacketBurst> ();
+    // control message list and payload packets are reused and empty at this point
+    std::list<Ptr<LteControlMessage> > &ctrlMsgList = m_rxCtrlMsgList;
+    std::vector<Ptr<Packet> > &rxPackets = m_rxPackets;
 
+    // extract packet header
+    struct NiApiPacketHeader niApiPacketHeader;
+    NiLteBitReader headerReader (payloadDataBuffer, payloadDataBufSize);
+    NiLtePacketHeaderCodec::Decode (headerReader, &niApiPacketHeader);
+    payloadDataBufOffset += headerReader.Finish ();
+
+    bool pduOk = !headerReader.IsOverrun () && (niApiPacketHeader.version == NI_LTE_CTRL_MSG__VERSION);
+    if (!pduOk){
+        // truncated header or different wire format version, nothing is decoded
+    }
     // switch between enb and ue
-    if (((m_niApiDevType==NIAPI_UE)||(m_niApiDevType==NIAPI_ALL))&&(m_ns3DevType==NS3_UE)){
+    else if (((m_niApiDevType==NIAPI_UE)||(m_niApiDevType==NIAPI_ALL))&&(m_ns3DevType==NS3_UE)){
         // downlink receiver
 
-        // create empty dl packet header
-        struct NiApiPacketHeader niApiPacketHeader;
-        // extract dl packet header
-        std::memcpy((uint8_t*)&niApiPacketHeader, payloadDataBuffer, sizeof(niApiPacketHeader));
-        payloadDataBufOffset += sizeof(niApiPacketHeader);
-
         NI_LOG_DEBUG (this << " - DL: Received MAC PDU with /"
                       << " control=" << (uint16_t) niApiPacketHeader.numCtrlMsg
                       << " payload=" << (uint16_t) niApiPacketHeader.numPaylMsg
@@ -729,21 +1047,15 @@ namespace ns3
                       << " cellId=" << niApiPacketHeader.cellId
                       << " RNTI=" << niApiPacketHeader.rnti);
 
-        for (uint32_t rxCtrlPacketCnt = 0; rxCtrlPacketCnt < niApiPacketHeader.numCtrlMsg ; rxCtrlPacketCnt  ++){
+        for (uint32_t rxCtrlPacketCnt = 0; (rxCtrlPacketCnt < niApiPacketHeader.numCtrlMsg) && pduOk; rxCtrlPacketCnt  ++){
             // process all received downlink control messages
             // note: when receiving a dl dci message the payload is processed directly afterwards
-            NiStartRxDlCtrlFrame (packetBurst, ctrlMsgList, payloadDataBuffer, (uint32_t*)&payloadDataBufOffset);
+            pduOk = NiStartRxDlCtrlFrame (rxPackets, ctrlMsgList, payloadDataBuffer, (uint32_t*)&payloadDataBufOffset, payloadDataBufSize);
         }
 
     } else if (((m_niApiDevType==NIAPI_ENB)||(m_niApiDevType==NIAPI_ALL))&&(m_ns3DevType==NS3_ENB)){
         // uplink receiver
 
-        // create empty dl packet header
-        struct NiApiPacketHeader niApiPacketHeader;
-        // extract dl packet header
-        std::memcpy((uint8_t*)&niApiPacketHeader, payloadDataBuffer, sizeof(niApiPacketHeader));
-        payloadDataBufOffset += sizeof(niApiPacketHeader);
-
         NI_LOG_DEBUG (this << " - UL: Received MAC PDU with /"
                       << " control=" << (uint16_t) niApiPacketHeader.numCtrlMsg
                       << " payload=" << (uint16_t) niApiPacketHeader.numPaylMsg
@@ -753,14 +1065,14 @@ namespace ns3
                       << " RNTI=" << niApiPacketHeader.rnti);
 
         // process all received control messages
-        for (uint32_t rxCtrlPacketCnt = 0; rxCtrlPacketCnt < niApiPacketHeader.numCtrlMsg ; rxCtrlPacketCnt  ++){
+        for (uint32_t rxCtrlPacketCnt = 0; (rxCtrlPacketCnt < niApiPacketHeader.numCtrlMsg) && pduOk; rxCtrlPacketCnt  ++){
             // process all received uplink control messages
-            NiStartRxUlCtrlFrame (packetBurst, ctrlMsgList, payloadDataBuffer, (uint32_t*)&payloadDataBufOffset);
+            pduOk = NiStartRxUlCtrlFrame (rxPackets, ctrlMsgList, payloadDataBuffer, (uint32_t*)&payloadDataBufOffset, payloadDataBufSize);
         }
 
-        if (niApiPacketHeader.numPaylMsg > 0 ) {
+        if (pduOk && (niApiPacketHeader.numPaylMsg > 0)) {
             // extract uplink payload data packets from MAC PDU and store in a packet burst
-            NiStartRxDataFrame (packetBurst, payloadDataBuffer, (uint32_t*)&payloadDataBufOffset);
+            pduOk = NiStartRxDataFrame (rxPackets, payloadDataBuffer, (uint32_t*)&payloadDataBufOffset, payloadDataBufSize);
         }
 
     } else {
@@ -768,22 +1080,118 @@ namespace ns3
         // do nothing
     }
 
-    // check if packets available
-    if (packetBurst) {
-        for (std::list<Ptr<Packet> >::const_iterator itPacketBurst = packetBurst->Begin (); itPacketBurst != packetBurst->End (); ++itPacketBurst)
-          {
-            // call ns-3 PhyPduReceived function in lte end/ue phy for further payload packet processing
-            m_niPhyRxDataEndOkCallback (*itPacketBurst);
-          }
+    if (!pduOk){
+        // a truncated or malformed MAC PDU is dropped as a whole
+        m_niRxNumDecodeErrors++;
+        NI_LOG_ERROR ("NiLtePhyInterface::NiStartRxCtrlDataFrame: MAC PDU of " << payloadDataBufSize << " bytes with wire format version "
+                      << (uint16_t) niApiPacketHeader.version << " could not be decoded at offset " << payloadDataBufOffset);
+        rxPackets.clear ();
     }
-    // check if control messages available
-    if (ctrlMsgList.size () > 0){
-        // call ns-3 ReceiveLteControlMessageList function in lte end/ue phy for further control message processing
-        m_niPhyRxCtrlEndOkCallback (ctrlMsgList);
+    else
+    {
+      // allocations of the ns-3 lte phy are not accounted to the NI rx path
+      NiAllocScope upcallScope (NI_ALLOC_SCOPE_PAUSE);
+
+      for (std::vector<Ptr<Packet> >::const_iterator itPacket = rxPackets.begin (); itPacket != rxPackets.end (); ++itPacket)
+        {
+          // call ns-3 PhyPduReceived function in lte end/ue phy for further payload packet processing
+          m_niPhyRxDataEndOkCallback (*itPacket);
+        }
+      // check if control messages available
+      if (!ctrlMsgList.empty ()){
+          // call ns-3 ReceiveLteControlMessageList function in lte end/ue phy for further control message processing
+          m_niPhyRxCtrlEndOkCallback (ctrlMsgList);
+      }
     }
 
+    // release the packets and messages, keep the storage for the next MAC PDU
+    rxPackets.clear ();
+    for (std::list<Ptr<LteControlMessage> >::iterator itCtrlMsg = ctrlMsgList.begin (); itCtrlMsg != ctrlMsgList.end (); ++itCtrlMsg)
+      {
+        *itCtrlMsg = 0;
+      }
+    m_rxCtrlMsgListPool.splice (m_rxCtrlMsgListPool.end (), ctrlMsgList);
+
+    return pduOk;
   } // end NiStartRxCtrlDataFrame function
 
+  // appends msg with a list node from the pool, a new node is only allocated if the pool is empty
+  void
+  NiLtePhyInterface::NiRxCtrlMsgListAppend (std::list<Ptr<LteControlMessage> > &ctrlMsgList, Ptr<LteControlMessage> msg)
+  {
+    if (m_rxCtrlMsgListPool.empty ())
+      {
+        ctrlMsgList.push_back (msg);
+        return;
+      }
+    ctrlMsgList.splice (ctrlMsgList.end (), m_rxCtrlMsgListPool, m_rxCtrlMsgListPool.begin ());
+    ctrlMsgList.back () = msg;
+  }
+
+  // called from the pipe transport rx thread - only copy the PDU into the rx queue,
+  // processing is done in the simulator thread by NiProcessRxPduQueue
+  bool
+  NiLtePhyInterface::NiEnqueueRxCtrlDataFrame (uint8_t* payloadDataBuffer, uint32_t payloadSize)
+  {
+    NiRxPduQueueEntry* entry = m_niRxPduQueue->GetWriteSlot ();
+    if (entry == NULL)
+      {
+        NI_LOG_WARN ("NiLtePhyInterface::NiEnqueueRxCtrlDataFrame: rx queue full, MAC PDU dropped");
+        return false;
+      }
+    if (payloadSize > MAX_MAC_PDU_SIZE)
+      {
+        NI_LOG_ERROR ("NiLtePhyInterface::NiEnqueueRxCtrlDataFrame: MAC PDU size " << payloadSize << " exceeds maximum");
+        payloadSize = MAX_MAC_PDU_SIZE;
+      }
+    entry->size = payloadSize;
+    std::memcpy (entry->data, payloadDataBuffer, payloadSize);
+    m_niRxPduQueue->CommitWrite ();
+    return true;
+  }
+
+  // called from the simulator thread - process all MAC PDUs queued so far as one batch
+  void
+  NiLtePhyInterface::NiProcessRxPduQueue (void)
+  {
+    if (m_niRxPduQueue == NULL) return;
+
+    // apply the SINR reports and CRC results received so far to the link adaptation
+    const uint32_t numReports = m_niLinkAdaptationQueue->GetDepth ();
+    for (uint32_t i = 0; i < numReports; i++)
+      {
+        NiLinkAdaptationQueueEntry* entry = m_niLinkAdaptationQueue->GetReadSlot ();
+        if (entry == NULL) break;
+        if (entry->isCrc)
+          {
+            m_linkAdaptation.ReportCrc (entry->rnti, entry->crcOk);
+          }
+        else
+          {
+            SetNiChannelSinrValue (entry->widebandSinrDb);
+            if (m_niLinkAdaptationEnable)
+              {
+                m_linkAdaptation.ReportSinr (entry->rnti, entry->widebandSinrDb, entry->subbandSinrDb, entry->numSubbands);
+              }
+          }
+        m_niLinkAdaptationQueue->CommitRead ();
+      }
+
+    // limit batch to the entries available at entry to not starve the subframe
+    const uint32_t batchSize = m_niRxPduQueue->GetDepth ();
+    if (batchSize == 0) return;
+
+    NI_LOG_DEBUG ("Process " << batchSize << " queued MAC PDUs");
+    for (uint32_t i = 0; i < batchSize; i++)
+      {
+        NiRxPduQueueEntry* entry = m_niRxPduQueue->GetReadSlot ();
+        if (entry == NULL) break;
+        NiStartRxCtrlDataFrame (entry->data, entry->size);
+        m_niRxPduQueue->CommitRead ();
+      }
+    m_niRxPduQueueNumBatches++;
+  }
+
   bool
   NiLtePhyInterface::NiStartRxCellMeasurementIndHandler (PhyCellMeasInd phyCellMeasInd)
   {
@@ -792,17 +1200,49 @@ namespace ns3
       {
         // convert fixed point to double
         double widebandSinr = NiUtils::ConvertFxpI8_6_2ToDouble(phyCellMeasInd.cellMeasReportBody.widebandSinr);
-        // update channel SINR value
-        SetNiChannelSinrValue(widebandSinr);
+        // the channel SINR value and the subband SINR for the CQI reports are applied in the
+        // simulator thread by NiProcessRxPduQueue, NiGenerateCqiReport reads them there
+        NiLinkAdaptationQueueEntry* entry = m_niLinkAdaptationQueue->GetWriteSlot ();
+        if (entry == NULL)
+          {
+            return false;
+          }
+        entry->isCrc = false;
+        entry->rnti = NI_LINK_ADAPTATION__OWN_LINK;
+        entry->widebandSinrDb = widebandSinr;
+        entry->numSubbands = std::min<uint32_t> (phyCellMeasInd.cellMeasReportBody.numSubbandSinr, NI_LINK_ADAPTATION__MAX_SUBBANDS);
+        for (uint32_t i = 0; i < entry->numSubbands; i++)
+          {
+            entry->subbandSinrDb[i] = NiUtils::ConvertFxpI8_6_2ToDouble(phyCellMeasInd.cellMeasReportBody.subbandSinr[i]);
+          }
+        m_niLinkAdaptationQueue->CommitWrite ();
       }
     return true;
   }
 
+  // called from the pipe transport rx thread - only queue the CRC result,
+  // the link adaptation is updated in the simulator thread by NiProcessRxPduQueue
   bool
-  NiLtePhyInterface::NiStartTxDlCtrlFrameBc (Ptr<PacketBurst> packetBurst, std::list<Ptr<LteControlMessage> > ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t &controlMessageCnt, std::map <uint16_t, uint16_t> &rntiMap)
+  NiLtePhyInterface::NiStartRxCrcResultHandler (uint16_t rnti, bool crcOk)
+  {
+    NiLinkAdaptationQueueEntry* entry = m_niLinkAdaptationQueue->GetWriteSlot ();
+    if (entry == NULL)
+      {
+        return false;
+      }
+    entry->isCrc = true;
+    // the UE adapts its own downlink, the eNB keeps the uplink BLER per UE
+    entry->rnti = (m_niApiDevType == NIAPI_UE) ? NI_LINK_ADAPTATION__OWN_LINK : rnti;
+    entry->crcOk = crcOk;
+    m_niLinkAdaptationQueue->CommitWrite ();
+    return true;
+  }
+
+  bool
+  NiLtePhyInterface::NiStartTxDlCtrlFrameBc (Ptr<PacketBurst> packetBurst, const std::list<Ptr<LteControlMessage> > &ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t &controlMessageCnt, std::map <uint16_t, uint16_t> &rntiMap)
   {
     // parse the control messages
-    std::list<Ptr<LteControlMessage> >::iterator itCtrlMsg;
+    std::list<Ptr<LteControlMessage> >::const_iterator itCtrlMsg;
 
     // first collect all broadcast messages which are not rnti specific - these will be sent to all ue's
     itCtrlMsg = ctrlMsgList.begin ();
@@ -814,57 +1254,50 @@ namespace ns3
         switch (m_messageType) {
           case LteControlMessage::MIB:
             {
-              // store message type in pdu
-              std::memcpy(payloadDataBuffer+*payloadDataBufOffset, (uint8_t*)&m_messageType, sizeof(m_messageType));
-              *payloadDataBufOffset += sizeof(m_messageType);
-              controlMessageCnt++;
-
               // extract mib control message
               Ptr<MibLteControlMessage> mib = DynamicCast<MibLteControlMessage> (msg);
               LteRrcSap::MasterInformationBlock mibElem = mib->GetMib();
-              // store mivb in pdu
-              std::memcpy(payloadDataBuffer+*payloadDataBufOffset, (uint8_t*)&mibElem, sizeof(mibElem));
-              *payloadDataBufOffset += sizeof(mibElem);
+              // store message type and mib in pdu
+              NiLteBitWriter writer (payloadDataBuffer+*payloadDataBufOffset);
+              writer.Put (m_messageType, NI_LTE_CTRL_MSG__TYPE_BITS);
+              NiLteMibCodec::Encode (writer, mibElem);
+              *payloadDataBufOffset += writer.Finish ();
+              controlMessageCnt++;
 
-              NI_LOG_DEBUG (this << " - DL: MIB Message sent (Size=" << sizeof(mibElem) << " bytes) /"
+              NI_LOG_DEBUG (this << " - DL: MIB Message sent (Size=" << NiLteMibCodec::size << " bytes) /"
                             " SFN=" << (uint16_t) mibElem.systemFrameNumber <<
                             " DL-BW=" << (uint16_t) mibElem.dlBandwidth);
               break;
             }
           case LteControlMessage::SIB1:
             {
-              // store message type in pdu
-              std::memcpy(payloadDataBuffer+*payloadDataBufOffset, (uint8_t*)&m_messageType, sizeof(m_messageType));
-              *payloadDataBufOffset += sizeof(m_messageType);
-              controlMessageCnt++;
-
               // extract sib1 control message
               Ptr<Sib1LteControlMessage> sib1 = DynamicCast<Sib1LteControlMessage> (msg);
               LteRrcSap::SystemInformationBlockType1 sib1Elem = sib1->GetSib1();
               // extract cell id
               m_cellId = sib1Elem.cellAccessRelatedInfo.cellIdentity;
-              // store sib1 in pdu
-              std::memcpy(payloadDataBuffer+*payloadDataBufOffset, (uint8_t*)&sib1Elem, sizeof(sib1Elem));
-              *payloadDataBufOffset += sizeof(sib1Elem);
+              // store message type and sib1 in pdu
+              NiLteBitWriter writer (payloadDataBuffer+*payloadDataBufOffset);
+              writer.Put (m_messageType, NI_LTE_CTRL_MSG__TYPE_BITS);
+              NiLteSib1Codec::Encode (writer, sib1Elem);
+              *payloadDataBufOffset += writer.Finish ();
+              controlMessageCnt++;
 
-              NI_LOG_DEBUG (this << " - DL: SIB1 Message sent (Size=" << sizeof(sib1Elem) << " bytes) /"
+              NI_LOG_DEBUG (this << " - DL: SIB1 Message sent (Size=" << NiLteSib1Codec::size << " bytes) /"
                             " Cell ID=" << (uint16_t) sib1Elem.cellAccessRelatedInfo.cellIdentity);
               break;
             }
           case LteControlMessage::RAR:
             {
-              // store message type in pdu
-              std::memcpy(payloadDataBuffer+*payloadDataBufOffset, (uint8_t*)&m_messageType, sizeof(m_messageType));
-              *payloadDataBufOffset += sizeof(m_messageType);
               controlMessageCnt++;
 
               // Elements defined in BuildRarListElement_s in ff-mac-common.h
               Ptr<RarLteControlMessage> rar = DynamicCast<RarLteControlMessage> (msg);
 
-              // serialize rar message
-              SerializeRarMessage (rar, payloadDataBuffer, payloadDataBufOffset);
+              // serialize message type and rar message
+              const uint32_t rarMsgSize = SerializeRarMessage (rar, payloadDataBuffer, payloadDataBufOffset);
 
-              NI_LOG_DEBUG (this << " - DL: RAR Message sent (Size=" << sizeof(rar) << " bytes) /"
+              NI_LOG_DEBUG (this << " - DL: RAR Message sent (Size=" << rarMsgSize << " bytes) /"
                             " raRNTI=" << (uint16_t) rar->GetRaRnti ());
 
               break;
@@ -908,10 +1341,10 @@ namespace ns3
   }
 
   bool
-  NiLtePhyInterface::NiStartTxDlCtrlFrameUc (Ptr<PacketBurst> packetBurst, std::list<Ptr<LteControlMessage> > ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t &controlMessageCnt, uint16_t curRnti)
+  NiLtePhyInterface::NiStartTxDlCtrlFrameUc (Ptr<PacketBurst> packetBurst, const std::list<Ptr<LteControlMessage> > &ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t &controlMessageCnt, uint16_t curRnti)
   {
     // parse the control messages
-    std::list<Ptr<LteControlMessage> >::iterator itCtrlMsg;
+    std::list<Ptr<LteControlMessage> >::const_iterator itCtrlMsg;
 
     // collect all messages which are rnti specific - these will be sent only to specific ue
     itCtrlMsg = ctrlMsgList.begin ();
@@ -939,18 +1372,16 @@ namespace ns3
               Ptr<UlDciLteControlMessage> uldci = DynamicCast<UlDciLteControlMessage> (msg);
 
               if (uldci->GetDci().m_rnti == curRnti){
-                  // store message type in pdu
-                  std::memcpy(payloadDataBuffer+*payloadDataBufOffset, (uint8_t*)&m_messageType, sizeof(m_messageType));
-                  *payloadDataBufOffset += sizeof(m_messageType);
-                  controlMessageCnt++;
-
                   // get ul dci element
-                  UlDciListElement_s ulDciElem = uldci->GetDci ();
-                  // store ul dci element in pdu
-                  std::memcpy(payloadDataBuffer+*payloadDataBufOffset, (uint8_t*)&ulDciElem, sizeof(ulDciElem));
-                  *payloadDataBufOffset += sizeof(ulDciElem);
+                  const UlDciListElement_s& ulDciElem = uldci->GetDci ();
+                  // store message type and ul dci element in pdu
+                  NiLteBitWriter writer (payloadDataBuffer+*payloadDataBufOffset);
+                  writer.Put (m_messageType, NI_LTE_CTRL_MSG__TYPE_BITS);
+                  NiLteUlDciCodec::Encode (writer, ulDciElem);
+                  *payloadDataBufOffset += writer.Finish ();
+                  controlMessageCnt++;
 
-                  NI_LOG_DEBUG (this << " - DL: UL DCI Message sent (Size=" << sizeof(ulDciElem) << " bytes) /"
+                  NI_LOG_DEBUG (this << " - DL: UL DCI Message sent (Size=" << NiLteUlDciCodec::size << " bytes) /"
                                 << " rnti=" << ulDciElem.m_rnti);
               }
 
@@ -962,27 +1393,23 @@ namespace ns3
               Ptr<DlDciLteControlMessage> dldci = DynamicCast<DlDciLteControlMessage> (msg);
 
               if (dldci->GetDci().m_rnti == curRnti){
-                  // store message type in pdu
-                  std::memcpy(payloadDataBuffer+*payloadDataBufOffset, (uint8_t*)&m_messageType, sizeof(m_messageType));
-                  *payloadDataBufOffset += sizeof(m_messageType);
-                  controlMessageCnt++;
-
                   // get dl dci element
-                  DlDciListElement_s dlDciElem = dldci->GetDci ();
+                  const DlDciListElement_s& dlDciElem = dldci->GetDci ();
                   // extract required parameters for ni api tx config req message
                   m_rbBitmap = dlDciElem.m_rbBitmap;
                   m_rnti     = dlDciElem.m_rnti;
                   m_mcs      = dlDciElem.m_mcs.at (0);
                   m_tbsSize  = dlDciElem.m_tbsSize.at (0);
-                  // convert ns-3 dl dci struct into ni dl dci struct due to use of std::vector
-                  NiDlDciListElement_s dlDciElemNi;
-                  ConvertToNiDlDciListElement(dlDciElem, &dlDciElemNi);
-                  // store dl dci element in pdu
-                  std::memcpy(payloadDataBuffer+*payloadDataBufOffset, (uint8_t*)&dlDciElemNi, sizeof(dlDciElemNi));
-                  *payloadDataBufOffset += sizeof(dlDciElemNi);
+                  // store message type and dl dci element in pdu
+                  // NOTE: restriction to one transport block
+                  NiLteBitWriter writer (payloadDataBuffer+*payloadDataBufOffset);
+                  writer.Put (m_messageType, NI_LTE_CTRL_MSG__TYPE_BITS);
+                  NiLteDlDciCodec::Encode (writer, dlDciElem);
+                  *payloadDataBufOffset += writer.Finish ();
+                  controlMessageCnt++;
 
                   NI_LOG_DEBUG (this << " - DL:"
-                                << " Create DL DCI data (" << sizeof(dlDciElemNi) << " bytes) /"
+                                << " Create DL DCI data (" << NiLteDlDciCodec::size << " bytes) /"
                                 << " rbBitmap=" << (std::bitset<32>) m_rbBitmap
                                 << " rnti=" << m_rnti
                                 << " mcs=" << (uint16_t) m_mcs
@@ -1007,13 +1434,12 @@ namespace ns3
   }
 
   bool
-  NiLtePhyInterface::NiStartRxDlCtrlFrame (Ptr<PacketBurst> packetBurst, std::list<Ptr<LteControlMessage> > &ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset)
+  NiLtePhyInterface::NiStartRxDlCtrlFrame (std::vector<Ptr<Packet> > &rxPackets, std::list<Ptr<LteControlMessage> > &ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t payloadDataBufSize)
   {
-
-    LteControlMessage::MessageType m_messageType;
+    // reads the message bounded by the received MAC PDU size
+    NiLteBitReader reader (payloadDataBuffer+*payloadDataBufOffset, payloadDataBufSize-*payloadDataBufOffset);
     // extract message type
-    std::memcpy((uint8_t*)&m_messageType, payloadDataBuffer+*payloadDataBufOffset, sizeof(m_messageType));
-    *payloadDataBufOffset += sizeof(m_messageType);
+    LteControlMessage::MessageType m_messageType = (LteControlMessage::MessageType) reader.Get (NI_LTE_CTRL_MSG__TYPE_BITS);
 
     switch (m_messageType){
       case LteControlMessage::MIB:
@@ -1021,14 +1447,15 @@ namespace ns3
           // extract mib control element
           LteRrcSap::MasterInformationBlock mibElem;
 
-          std::memcpy(&mibElem, payloadDataBuffer+*payloadDataBufOffset, sizeof(mibElem));
-          *payloadDataBufOffset += sizeof(mibElem);
+          NiLteMibCodec::Decode (reader, &mibElem);
+          *payloadDataBufOffset += reader.Finish ();
+          if (reader.IsOverrun ()) return false;
 
           // recreate the mib control message
           Ptr<MibLteControlMessage> mib = Create<MibLteControlMessage> ();
           mib->SetMib(mibElem);
           Ptr<LteControlMessage> msg = mib;
-          ctrlMsgList.push_back( msg );
+          NiRxCtrlMsgListAppend (ctrlMsgList, msg);
 
           // update sfn and tti counters
           if (!m_mibReceived){
@@ -1037,7 +1464,7 @@ namespace ns3
               m_mibReceived = true;
           }
 
-          NI_LOG_DEBUG (this << " - DL: MIB Message received (Size=" << sizeof(mibElem) << " bytes) /"
+          NI_LOG_DEBUG (this << " - DL: MIB Message received (Size=" << NiLteMibCodec::size << " bytes) /"
                         " SFN=" << (uint16_t) mibElem.systemFrameNumber <<
                         " DL-BW=" << (uint16_t) mibElem.dlBandwidth <<
                         " SFN updated=" << m_mibReceived);
@@ -1049,16 +1476,17 @@ namespace ns3
           // extract sib1 control element
           LteRrcSap::SystemInformationBlockType1 sib1Elem;
 
-          std::memcpy(&sib1Elem, payloadDataBuffer+*payloadDataBufOffset, sizeof(sib1Elem));
-          *payloadDataBufOffset += sizeof(sib1Elem);
+          NiLteSib1Codec::Decode (reader, &sib1Elem);
+          *payloadDataBufOffset += reader.Finish ();
+          if (reader.IsOverrun ()) return false;
 
           // recreate the sib1 control message
           Ptr<Sib1LteControlMessage> sib1 = Create<Sib1LteControlMessage> ();
           sib1->SetSib1(sib1Elem);
           Ptr<LteControlMessage> msg = sib1;
-          ctrlMsgList.push_back( msg );
+          NiRxCtrlMsgListAppend (ctrlMsgList, msg);
 
-          NI_LOG_DEBUG (this << " - DL: SIB1 Message received (Size=" << sizeof(sib1Elem) << " bytes) /"
+          NI_LOG_DEBUG (this << " - DL: SIB1 Message received (Size=" << NiLteSib1Codec::size << " bytes) /"
                         " Cell ID=" << (uint16_t) sib1Elem.cellAccessRelatedInfo.cellIdentity);
 
           break;
@@ -1068,12 +1496,16 @@ namespace ns3
           // recreate the rar control message
           Ptr<RarLteControlMessage> rar = Create<RarLteControlMessage> ();
           // deserialize rar message and set temporarily the m_rnti - needed for ul packets
-          m_rnti = DeserializeRarMessage (rar, payloadDataBuffer, payloadDataBufOffset);
+          const uint16_t rarRnti = DeserializeRarMessage (rar, reader);
+          const uint32_t rarMsgSize = reader.Finish ();
+          *payloadDataBufOffset += rarMsgSize;
+          if (reader.IsOverrun ()) return false;
+          m_rnti = rarRnti;
           // put rar message into queue
           Ptr<LteControlMessage> msg = rar;
-          ctrlMsgList.push_back( msg );
+          NiRxCtrlMsgListAppend (ctrlMsgList, msg);
 
-          NI_LOG_DEBUG (this << " - DL: RAR Message received (Size=" << sizeof(rar) << " bytes) /"
+          NI_LOG_DEBUG (this << " - DL: RAR Message received (Size=" << rarMsgSize << " bytes) /"
                         " raRNTI=" << (uint16_t) rar->GetRaRnti ());
 
           break;
@@ -1083,16 +1515,17 @@ namespace ns3
           // extract ul dci element
           UlDciListElement_s   ulDciElem;
 
-          std::memcpy(&ulDciElem, payloadDataBuffer+*payloadDataBufOffset, sizeof(ulDciElem));
-          *payloadDataBufOffset += sizeof(ulDciElem);
+          NiLteUlDciCodec::Decode (reader, &ulDciElem);
+          *payloadDataBufOffset += reader.Finish ();
+          if (reader.IsOverrun ()) return false;
 
           // recreate the ul dci control message
           Ptr<UlDciLteControlMessage> uldci = Create<UlDciLteControlMessage> ();
           uldci->SetDci(ulDciElem);
           Ptr<LteControlMessage> msg = uldci;
-          ctrlMsgList.push_back( msg );
+          NiRxCtrlMsgListAppend (ctrlMsgList, msg);
 
-          NI_LOG_DEBUG (this << " - DL: UL DCI data received (" << sizeof(ulDciElem) << " bytes)");
+          NI_LOG_DEBUG (this << " - DL: UL DCI data received (" << NiLteUlDciCodec::size << " bytes)");
 
           break;
         }
@@ -1100,49 +1533,41 @@ namespace ns3
         {
           // extract dl dci element
           DlDciListElement_s   dlDciElem;
-          NiDlDciListElement_s dlDciElemNi;
 
-          std::memcpy(&dlDciElemNi, payloadDataBuffer+*payloadDataBufOffset, sizeof(dlDciElemNi));
-          *payloadDataBufOffset += sizeof(dlDciElemNi);
-
-          // convert ni dl dci structure to ns-3 dl dci structure due to use of std::vector
-          ConvertFromNiDlDciListElement(dlDciElemNi, &dlDciElem);
+          NiLteDlDciCodec::Decode (reader, &dlDciElem);
+          *payloadDataBufOffset += reader.Finish ();
+          if (reader.IsOverrun ()) return false;
 
           // recreate the dl dci control message
           Ptr<DlDciLteControlMessage> dldci = Create<DlDciLteControlMessage> ();
           dldci->SetDci(dlDciElem);
           Ptr<LteControlMessage> msg = dldci;
-          ctrlMsgList.push_back( msg );
-
-          uint32_t m_numPackets;
-          std::memcpy(&m_numPackets, payloadDataBuffer+*payloadDataBufOffset, sizeof(m_numPackets));
+          NiRxCtrlMsgListAppend (ctrlMsgList, msg);
 
           NI_LOG_DEBUG (this << " - DL:"
-                        << " DL DCI data received (" << sizeof(dlDciElemNi) << " bytes)"
+                        << " DL DCI data received (" << NiLteDlDciCodec::size << " bytes)"
                         << " rbBitmap=" << (std::bitset<32>) dldci->GetDci ().m_rbBitmap
                         << " rnti=" << dldci->GetDci ().m_rnti
                         << " mcs=" << (uint16_t) dldci->GetDci ().m_mcs.at (0)
                         << " tbsSize=" << (uint16_t) dldci->GetDci ().m_tbsSize.at (0) << " bytes"
-                        << " buffer offset=" << *payloadDataBufOffset
-                        << " packetNum=" << m_numPackets);
-
+                        << " buffer offset=" << *payloadDataBufOffset);
 
           // extract payload data packets from MAC PDU and store in a burst
-          NiStartRxDataFrame (packetBurst, payloadDataBuffer, payloadDataBufOffset);
-
-          break;
+          return NiStartRxDataFrame (rxPackets, payloadDataBuffer, payloadDataBufOffset, payloadDataBufSize);
         }
       default:
-        NI_LOG_FATAL (this << " - DL: Message type " << m_messageType << " not recognized");
+        NI_LOG_ERROR (this << " - DL: Message type " << m_messageType << " not recognized");
+        return false;
     } // end switch
 
+    return true;
   }
 
   bool
-  NiLtePhyInterface::NiStartTxUlCtrlFrame (Ptr<PacketBurst> packetBurst, std::list<Ptr<LteControlMessage> > ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t &controlMessageCnt)
+  NiLtePhyInterface::NiStartTxUlCtrlFrame (Ptr<PacketBurst> packetBurst, const std::list<Ptr<LteControlMessage> > &ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t &controlMessageCnt)
   {
     // parse the control messages
-    std::list<Ptr<LteControlMessage> >::iterator itCtrlMsg;
+    std::list<Ptr<LteControlMessage> >::const_iterator itCtrlMsg;
 
     // first collect all broadcast messages which are not rnti specific - these will be sent to all ue's
     itCtrlMsg = ctrlMsgList.begin ();
@@ -1154,52 +1579,39 @@ namespace ns3
         switch (m_messageType) {
           case LteControlMessage::DL_CQI:
             {
-              // store message type in pdu
-              std::memcpy(payloadDataBuffer+*payloadDataBufOffset, (uint8_t*)&m_messageType, sizeof(m_messageType));
-              *payloadDataBufOffset += sizeof(m_messageType);
               controlMessageCnt++;
 
               Ptr<DlCqiLteControlMessage> dlcqi = DynamicCast<DlCqiLteControlMessage> (msg);
 
-              // serialize dl cqi message
-              SerializeDlCqiMessage (dlcqi, payloadDataBuffer, payloadDataBufOffset);
+              // serialize message type and dl cqi message
+              const uint32_t dlCqiMsgSize = SerializeDlCqiMessage (dlcqi, payloadDataBuffer, payloadDataBufOffset);
 
-              NI_LOG_DEBUG (this << " - UL: DL_CQI Message sent (Size=" << sizeof(dlcqi) << " bytes)");
+              NI_LOG_DEBUG (this << " - UL: DL_CQI Message sent (Size=" << dlCqiMsgSize << " bytes)");
               break;
             }
           case LteControlMessage::BSR:
             {
-              // store message type in pdu
-              std::memcpy(payloadDataBuffer+*payloadDataBufOffset, (uint8_t*)&m_messageType, sizeof(m_messageType));
-              *payloadDataBufOffset += sizeof(m_messageType);
-              controlMessageCnt++;
-
               Ptr<BsrLteControlMessage> bsr = DynamicCast<BsrLteControlMessage> (msg);
               // get bsr element
               MacCeListElement_s bsrElem = bsr->GetBsr ();
 
-              // convert ns-3 dl dci struct into ni dl dci struct due to use of std::vector
-              NiMacCeListElement_s bsrElemNi;
-              ConvertToNiMacCeListElement(bsrElem, &bsrElemNi);
-              // store dl dci element in pdu
-              std::memcpy(payloadDataBuffer+*payloadDataBufOffset, (uint8_t*)&bsrElemNi, sizeof(bsrElemNi));
-              *payloadDataBufOffset += sizeof(bsrElemNi);
-
-              NI_LOG_DEBUG (this << " - UL: BSR Message sent (Size=" << sizeof(bsrElemNi) << " bytes) /"
-                            " m_rnti=" << (uint16_t)bsrElemNi.m_rnti  <<
-                            " m_phr=" << (uint16_t)bsrElemNi.m_phr <<
-                            " m_macCeType=" << (uint16_t)bsrElemNi.m_macCeType <<
-                            " m_crnti=" << (uint16_t)bsrElemNi.m_crnti <<
-                            " m_bufferStatus_0=" << (uint16_t)bsrElemNi.m_bufferStatus_0);
+              // store message type and bsr element in pdu
+              NiLteBitWriter writer (payloadDataBuffer+*payloadDataBufOffset);
+              writer.Put (m_messageType, NI_LTE_CTRL_MSG__TYPE_BITS);
+              NiLteBsrCodec::Encode (writer, bsrElem);
+              *payloadDataBufOffset += writer.Finish ();
+              controlMessageCnt++;
+
+              NI_LOG_DEBUG (this << " - UL: BSR Message sent (Size=" << NiLteBsrCodec::size << " bytes) /"
+                            " m_rnti=" << (uint16_t)bsrElem.m_rnti  <<
+                            " m_phr=" << (uint16_t)bsrElem.m_macCeValue.m_phr <<
+                            " m_macCeType=" << (uint16_t)bsrElem.m_macCeType <<
+                            " m_crnti=" << (uint16_t)bsrElem.m_macCeValue.m_crnti <<
+                            " m_bufferStatus_0=" << (uint16_t)bsrElem.m_macCeValue.m_bufferStatus.at (0));
               break;
             }
           case LteControlMessage::DL_HARQ:
             {
-              // store message type in pdu
-              std::memcpy(payloadDataBuffer+*payloadDataBufOffset, (uint8_t*)&m_messageType, sizeof(m_messageType));
-              *payloadDataBufOffset += sizeof(m_messageType);
-              controlMessageCnt++;
-
               Ptr<DlHarqFeedbackLteControlMessage> dlharq = DynamicCast<DlHarqFeedbackLteControlMessage> (msg);
 
               // NOTE: currently no DL HARQ messages are supported in NI API as disabled in main file
@@ -1212,20 +1624,18 @@ namespace ns3
             }
           case LteControlMessage::RACH_PREAMBLE:
             {
-              // store message type in pdu
-              std::memcpy(payloadDataBuffer+*payloadDataBufOffset, (uint8_t*)&m_messageType, sizeof(m_messageType));
-              *payloadDataBufOffset += sizeof(m_messageType);
-              controlMessageCnt++;
-
               Ptr<RachPreambleLteControlMessage> rach = DynamicCast<RachPreambleLteControlMessage> (msg);
 
               uint32_t m_rapId = rach->GetRapId ();
 
-              // store RACH rapID in pdu
-              std::memcpy(payloadDataBuffer+*payloadDataBufOffset, (uint8_t*)&m_rapId, sizeof(m_rapId));
-              *payloadDataBufOffset += sizeof(m_rapId);
+              // store message type and RACH rapID in pdu
+              NiLteBitWriter writer (payloadDataBuffer+*payloadDataBufOffset);
+              writer.Put (m_messageType, NI_LTE_CTRL_MSG__TYPE_BITS);
+              NiLteRachPreambleCodec::Encode (writer, m_rapId);
+              *payloadDataBufOffset += writer.Finish ();
+              controlMessageCnt++;
 
-              NI_LOG_DEBUG (this << " - UL: RACH_PREAMBLE Message sent (Size=" << sizeof(rach) << " bytes) /"
+              NI_LOG_DEBUG (this << " - UL: RACH_PREAMBLE Message sent (Size=" << NiLteRachPreambleCodec::size << " bytes) /"
                             " m_rapId=" << m_rapId);
 
               break;
@@ -1239,12 +1649,12 @@ namespace ns3
   }
 
   bool
-  NiLtePhyInterface::NiStartRxUlCtrlFrame (Ptr<PacketBurst> packetBurst, std::list<Ptr<LteControlMessage> > &ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset)
+  NiLtePhyInterface::NiStartRxUlCtrlFrame (std::vector<Ptr<Packet> > &rxPackets, std::list<Ptr<LteControlMessage> > &ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t payloadDataBufSize)
   {
-    LteControlMessage::MessageType m_messageType;
+    // reads the message bounded by the received MAC PDU size
+    NiLteBitReader reader (payloadDataBuffer+*payloadDataBufOffset, payloadDataBufSize-*payloadDataBufOffset);
     // extract message type
-    std::memcpy((uint8_t*)&m_messageType, payloadDataBuffer+*payloadDataBufOffset, sizeof(m_messageType));
-    *payloadDataBufOffset += sizeof(m_messageType);
+    LteControlMessage::MessageType m_messageType = (LteControlMessage::MessageType) reader.Get (NI_LTE_CTRL_MSG__TYPE_BITS);
 
     switch (m_messageType){
       case LteControlMessage::DL_CQI:
@@ -1252,37 +1662,37 @@ namespace ns3
           Ptr<DlCqiLteControlMessage> dlcqi = Create<DlCqiLteControlMessage> ();
 
           // deserialize dl cqi message
-          DeserializeDlCqiMessage (dlcqi, payloadDataBuffer, payloadDataBufOffset);
+          DeserializeDlCqiMessage (dlcqi, reader);
+          const uint32_t dlCqiMsgSize = reader.Finish ();
+          *payloadDataBufOffset += dlCqiMsgSize;
+          if (reader.IsOverrun ()) return false;
 
           Ptr<LteControlMessage> msg = dlcqi;
-          ctrlMsgList.push_back( msg );
+          NiRxCtrlMsgListAppend (ctrlMsgList, msg);
 
-          NI_LOG_DEBUG (this << " - UL: DL_CQI Message received (Size=" << sizeof(dlcqi) << " bytes)");
+          NI_LOG_DEBUG (this << " - UL: DL_CQI Message received (Size=" << dlCqiMsgSize << " bytes)");
           break;
         }
       case LteControlMessage::BSR:
         {
           // extract bsr element
           MacCeListElement_s bsrElem;
-          NiMacCeListElement_s bsrElemNi;
 
-          std::memcpy(&bsrElemNi, payloadDataBuffer+*payloadDataBufOffset, sizeof(bsrElemNi));
-          *payloadDataBufOffset += sizeof(bsrElemNi);
-
-          // convert ni dl dci structure to ns-3 dl dci structure due to use of std::vector
-          ConvertFromNiMacCeListElement(bsrElemNi, &bsrElem);
+          NiLteBsrCodec::Decode (reader, &bsrElem);
+          *payloadDataBufOffset += reader.Finish ();
+          if (reader.IsOverrun ()) return false;
 
           Ptr<BsrLteControlMessage> bsr = Create<BsrLteControlMessage> ();
           bsr->SetBsr(bsrElem);
           Ptr<LteControlMessage> msg = bsr;
-          ctrlMsgList.push_back( msg );
+          NiRxCtrlMsgListAppend (ctrlMsgList, msg);
 
-          NI_LOG_DEBUG (this << " - UL: BSR Message received (Size=" << sizeof(bsrElemNi) << " bytes)"
-                        " m_rnti=" << (uint16_t)bsrElemNi.m_rnti  <<
-                        " m_phr=" << (uint16_t)bsrElemNi.m_phr <<
-                        " m_macCeType=" << (uint16_t)bsrElemNi.m_macCeType <<
-                        " m_crnti=" << (uint16_t)bsrElemNi.m_crnti <<
-                        " m_bufferStatus_0=" << (uint16_t)bsrElemNi.m_bufferStatus_0);
+          NI_LOG_DEBUG (this << " - UL: BSR Message received (Size=" << NiLteBsrCodec::size << " bytes)"
+                        " m_rnti=" << (uint16_t)bsrElem.m_rnti  <<
+                        " m_phr=" << (uint16_t)bsrElem.m_macCeValue.m_phr <<
+                        " m_macCeType=" << (uint16_t)bsrElem.m_macCeType <<
+                        " m_crnti=" << (uint16_t)bsrElem.m_macCeValue.m_crnti <<
+                        " m_bufferStatus_0=" << (uint16_t)bsrElem.m_macCeValue.m_bufferStatus.at (0));
 
           break;
         }
@@ -1301,26 +1711,27 @@ namespace ns3
         }
       case LteControlMessage::RACH_PREAMBLE:
         {
-          uint32_t m_rapId;
-
-          std::memcpy(&m_rapId, payloadDataBuffer+*payloadDataBufOffset, sizeof(m_rapId));
-          *payloadDataBufOffset += sizeof(m_rapId);
+          uint32_t m_rapId = NiLteRachPreambleCodec::Decode (reader);
+          *payloadDataBufOffset += reader.Finish ();
+          if (reader.IsOverrun ()) return false;
 
           Ptr<RachPreambleLteControlMessage> rach = Create<RachPreambleLteControlMessage> ();
           rach->SetRapId (m_rapId);
 
           Ptr<LteControlMessage> msg = rach;
-          ctrlMsgList.push_back( rach );
+          NiRxCtrlMsgListAppend (ctrlMsgList, rach);
 
-          NI_LOG_DEBUG (this << " - UL: RACH_PREAMBLE Message received (Size=" << sizeof(rach) << " bytes) /"
+          NI_LOG_DEBUG (this << " - UL: RACH_PREAMBLE Message received (Size=" << NiLteRachPreambleCodec::size << " bytes) /"
                         " m_rapId=" << m_rapId);
 
           break;
         }
       default:
         NI_LOG_ERROR (this << " - UL: Message type " << m_messageType << " not recognized");
+        return false;
     } // end switch
 
+    return true;
   }
 
   bool
@@ -1330,24 +1741,20 @@ namespace ns3
     if (packetBurst) {
 
         LteRadioBearerTag mLteBearerTag;
-        Ptr<Packet> packetTmp;
-
-        // create auxiliary rnti specific packet burst
-        Ptr<PacketBurst> packetBurstTmp = Create<PacketBurst> ();
 
-        // collect all packets which belong to one rnti
+        // collect all packets which belong to one rnti in the reused tx packet vector,
+        // the packets are not modified since the tags are sent in a sidecar
+        std::vector<Ptr<Packet> > &txPackets = m_txPackets;
         std::list<Ptr<Packet> >::const_iterator itPacketBurst = packetBurst->Begin ();
         while (itPacketBurst != packetBurst->End ())
           {
-            // get next packet from burst
-            packetTmp = (*itPacketBurst)->Copy();
             // get rnti from bearer tag
-            packetTmp->RemovePacketTag (mLteBearerTag);
+            (*itPacketBurst)->PeekPacketTag (mLteBearerTag);
             // check if packet belong to requested rnti - if requested rnti is zero transmit all (used for uplink)
             if ((curRnti == mLteBearerTag.GetRnti ())||(curRnti == 0))
               {
                 // add packets to rnti specific packet burst
-                packetBurstTmp->AddPacket ((*itPacketBurst)->Copy());
+                txPackets.push_back (*itPacketBurst);
               }
             itPacketBurst++;
 
@@ -1355,75 +1762,47 @@ namespace ns3
           }
 
         // include number of packets in pdu for restoring at the receiver
-        uint32_t m_numPackets = packetBurstTmp->GetNPackets();
+        uint32_t m_numPackets = txPackets.size();
 
-        std::memcpy(payloadDataBuffer+*payloadDataBufOffset, (uint8_t*)&m_numPackets, sizeof(m_numPackets));
-        *payloadDataBufOffset += sizeof(m_numPackets);
+        NiLteBitWriter writer (payloadDataBuffer+*payloadDataBufOffset);
+        writer.Put (m_numPackets, NiLteDataFrameCodec::bits);
+        *payloadDataBufOffset += writer.Finish ();
 
         // serialize the packet burst of the current rnti
-        for (std::list<Ptr<Packet> >::const_iterator itPacketBurstTmp = packetBurstTmp->Begin (); itPacketBurstTmp != packetBurstTmp->End (); ++itPacketBurstTmp)
+        for (std::vector<Ptr<Packet> >::const_iterator itPacketTmp = txPackets.begin (); itPacketTmp != txPackets.end (); ++itPacketTmp)
           {
             // get next packet
-            Ptr<Packet> m_currentPacket = (*itPacketBurstTmp);
+            Ptr<Packet> m_currentPacket = (*itPacketTmp);
 
             NI_LOG_DEBUG(this << " - Serialize packet of size " << m_currentPacket->GetSerializedSize () << " bytes - Payload buffer cnt: " << *payloadDataBufOffset);
 
-            // Append all packet and byte tags as header objects to the packet,
-            // because these are NOT serialized
-            // keep track of the tag types and the order with a list
-            // LteRadioBearerTag == 1, RlcTag == 2, PDCP Tag == 3
-            std::vector<uint8_t> tagTypeList;
-
-            // Add the LteRadioBearerTag to the packet
+            // packet tags are NOT serialized, the radio bearer, RLC and PDCP tags
+            // are sent in the tag sidecar in front of the packet
+            NiLtePacketTags tags;
             LteRadioBearerTag radioBearTag;
-            m_currentPacket->RemovePacketTag (radioBearTag);
-            LteRadioBearerHeader radioBearerHead (radioBearTag.GetRnti (),\
-                                                  radioBearTag.GetLcid (),\
-                                                  radioBearTag.GetLayer ());
-            m_currentPacket->AddHeader (radioBearerHead);
-            tagTypeList.push_back (1);
-            uint16_t nTags = 1;
-
-            // Add RlcTag, PdcpTag to the packet
+            m_currentPacket->PeekPacketTag (radioBearTag);
+            tags.rnti  = radioBearTag.GetRnti ();
+            tags.lcid  = radioBearTag.GetLcid ();
+            tags.layer = radioBearTag.GetLayer ();
             RlcTag rlcTag;
-            TypeId rlcTid = rlcTag.GetInstanceTypeId ();
+            tags.hasRlcTag    = m_currentPacket->PeekPacketTag (rlcTag);
+            tags.rlcTimestamp = tags.hasRlcTag ? rlcTag.GetSenderTimestamp ().GetNanoSeconds () : 0;
             PdcpTag pdcpTag;
-            TypeId pdcpTid = pdcpTag.GetInstanceTypeId ();
-            ByteTagIterator itByteTag = m_currentPacket->GetByteTagIterator ();
-            while (itByteTag.HasNext ())
-              {
-                ByteTagIterator::Item item = itByteTag.Next ();
-                if (rlcTid == item.GetTypeId ())
-                  {
-                    item.GetTag (rlcTag);
-                    RlcTagHeader rlcTagHead (rlcTag.GetSenderTimestamp ());
-                    m_currentPacket->AddHeader (rlcTagHead);
-                    nTags++;
-                    tagTypeList.push_back (2);
-                  }
-                if (pdcpTid == item.GetTypeId ())
-                  {
-                    item.GetTag (pdcpTag);
-                    PdcpTagHeader pdcpTagHead (pdcpTag.GetSenderTimestamp ());
-                    m_currentPacket->AddHeader (pdcpTagHead);
-                    nTags++;
-                    tagTypeList.push_back (3);
-                  }
-              }
-            //Add the tag info to the packet
-            LtePacketTagInfoHeader numTags (nTags, tagTypeList);
-            m_currentPacket->AddHeader (numTags);
+            tags.hasPdcpTag    = m_currentPacket->PeekPacketTag (pdcpTag);
+            tags.pdcpTimestamp = tags.hasPdcpTag ? pdcpTag.GetSenderTimestamp ().GetNanoSeconds () : 0;
 
-            // include packet size for restoring at the receiver
+            // include packet size for restoring at the receiver and the tag sidecar
             uint32_t m_PacketSize = m_currentPacket->GetSerializedSize();
 
-            std::memcpy(payloadDataBuffer+*payloadDataBufOffset, (uint8_t*)&m_PacketSize, sizeof(m_PacketSize));
-            *payloadDataBufOffset += sizeof(m_PacketSize);
+            NiLteBitWriter sizeWriter (payloadDataBuffer+*payloadDataBufOffset);
+            NiLteDataFrameCodec::EncodePacket (sizeWriter, m_PacketSize, tags);
+            *payloadDataBufOffset += sizeWriter.Finish ();
 
             // include payload packet in pdu
             m_currentPacket->Serialize (payloadDataBuffer+*payloadDataBufOffset, m_PacketSize);
             *payloadDataBufOffset += m_PacketSize;
           }
+        txPackets.clear ();
 
         m_niApiCountTxPayloadDataPackets++;
 
@@ -1440,360 +1819,117 @@ namespace ns3
   }
 
   bool
-  NiLtePhyInterface::NiStartRxDataFrame (Ptr<PacketBurst> packetBurst, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset)
+  NiLtePhyInterface::NiStartRxDataFrame (std::vector<Ptr<Packet> > &rxPackets, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t payloadDataBufSize)
   {
-    //
-    LtePacketTagInfoHeader tagTypeListRx;
-    std::list<RlcTag> rlcTagList;
-    std::list<PdcpTag> pdcpTagList;
-    LteRadioBearerHeader radioBearerHeadRx;
-    RlcTagHeader rlcTagHeadRx;
-    PdcpTagHeader pdcpTagHeadRx;
-
     // extract number of packets
-    uint32_t m_numPackets;
-    std::memcpy((uint8_t*)&m_numPackets, payloadDataBuffer+*payloadDataBufOffset, sizeof(m_numPackets));
-    *payloadDataBufOffset += sizeof(m_numPackets);
+    NiLteBitReader reader (payloadDataBuffer+*payloadDataBufOffset, payloadDataBufSize-*payloadDataBufOffset);
+    uint32_t m_numPackets = reader.Get (NiLteDataFrameCodec::bits);
+    *payloadDataBufOffset += reader.Finish ();
+    if (reader.IsOverrun ()) return false;
 
     NI_LOG_DEBUG (this << " - Received MAC PDU including " << m_numPackets << " packets - buffer offset=" << *payloadDataBufOffset);
 
     for (uint32_t idxPacket = 0; idxPacket < m_numPackets; idxPacket++)
       {
-        rlcTagList.clear ();
-        pdcpTagList.clear ();
-
-        // extract packet size
-        uint32_t m_PacketSize;
-        std::memcpy((uint8_t*)&m_PacketSize, payloadDataBuffer+*payloadDataBufOffset, sizeof(m_PacketSize));
-        *payloadDataBufOffset += sizeof(m_PacketSize);
+        // extract packet size and tag sidecar
+        NiLtePacketTags tags;
+        NiLteBitReader sizeReader (payloadDataBuffer+*payloadDataBufOffset, payloadDataBufSize-*payloadDataBufOffset);
+        uint32_t m_PacketSize = NiLteDataFrameCodec::DecodePacket (sizeReader, &tags);
+        *payloadDataBufOffset += sizeReader.Finish ();
+        if (sizeReader.IsOverrun () || (m_PacketSize > payloadDataBufSize-*payloadDataBufOffset))
+          {
+            NI_LOG_ERROR (this << " - Packet #" << idxPacket << " of size " << m_PacketSize << " bytes exceeds the received MAC PDU");
+            return false;
+          }
 
         // extract payload packet
         Ptr<Packet> packet = Create<Packet> ((uint8_t const*)(payloadDataBuffer+*payloadDataBufOffset), m_PacketSize, true);
         *payloadDataBufOffset += m_PacketSize;
 
-        packet->RemoveHeader (tagTypeListRx);
-
-        // extract header object containing original packet and byte tags in
-        // the opposite order
-        for (int16_t i=tagTypeListRx.GetNumOfTagHeaders()-1; i>=0; i--)
+        // restore the original packet tags
+        packet->AddPacketTag (LteRadioBearerTag (tags.rnti, tags.lcid, tags.layer));
+        if (tags.hasRlcTag)
           {
-            switch (tagTypeListRx.GetHeaderTypeList ()[i]) {
-              case 1: //Packet Tag
-                {
-                  packet->RemoveHeader (radioBearerHeadRx);
-                  LteRadioBearerTag tagRx (radioBearerHeadRx.GetRnti (), radioBearerHeadRx.GetLcid (), radioBearerHeadRx.GetLayer ());
-                  packet->AddPacketTag (tagRx);
-                  break;
-                }
-              case 2: //RLC Tag
-                {
-                  packet->RemoveHeader (rlcTagHeadRx);
-                  RlcTag rlcTag (rlcTagHeadRx.GetSenderTimestamp ());
-                  rlcTagList.push_front (rlcTag);
-                  break;
-                }
-              case 3: //PDCP Tag
-                {
-                  packet->RemoveHeader (pdcpTagHeadRx);
-                  PdcpTag pdcpTag (pdcpTagHeadRx.GetSenderTimestamp ());
-                  pdcpTagList.push_front (pdcpTag);
-                  break;
-                }
-            }
+            packet->AddPacketTag (RlcTag (NanoSeconds (tags.rlcTimestamp)));
           }
-
-        // Add the original Bytes Tags back to the packet
-        for (uint16_t i = 0; i<tagTypeListRx.GetNumOfTagHeaders(); i++)
+        if (tags.hasPdcpTag)
           {
-            switch (tagTypeListRx.GetHeaderTypeList ()[i]) {
-              case 2: //RLC Tag
-                {
-                  packet->AddByteTag (rlcTagList.front ());
-                  rlcTagList.pop_front ();
-                  break;
-                }
-              case 3: //PDCP Tag
-                {
-                  packet->AddByteTag (pdcpTagList.front ());
-                  pdcpTagList.pop_front ();
-                  break;
-                }
-            }
+            packet->AddPacketTag (PdcpTag (NanoSeconds (tags.pdcpTimestamp)));
           }
 
         NI_LOG_DEBUG(this << " - Add packet #" << idxPacket << " of size " << packet->GetSerializedSize () << " bytes to packet burst - buffer offset=" << *payloadDataBufOffset);
 
         // add packet to temp burst
-        packetBurst->AddPacket(packet);
+        rxPackets.push_back(packet);
       }
+    return true;
   }
 
-  void
-  NiLtePhyInterface::ConvertToNiDlDciListElement (DlDciListElement_s dlDciElem, NiDlDciListElement_s* dlDciElemNi)
-  {
-    dlDciElemNi->m_rnti             = dlDciElem.m_rnti;
-    dlDciElemNi->m_rbBitmap         = dlDciElem.m_rbBitmap;
-    dlDciElemNi->m_rbShift          = dlDciElem.m_rbShift;
-    dlDciElemNi->m_resAlloc         = dlDciElem.m_resAlloc;
-    // NOTE: restriction to one transport block
-    dlDciElemNi->m_tbsSize          = dlDciElem.m_tbsSize.at(0);
-    dlDciElemNi->m_mcs              = dlDciElem.m_mcs.at(0);
-    dlDciElemNi->m_ndi              = dlDciElem.m_ndi.at(0);
-    dlDciElemNi->m_rv               = dlDciElem.m_rv.at(0);
-    dlDciElemNi->m_cceIndex         = dlDciElem.m_cceIndex;
-    dlDciElemNi->m_aggrLevel        = dlDciElem.m_aggrLevel;
-    dlDciElemNi->m_precodingInfo    = dlDciElem.m_precodingInfo;
-    dlDciElemNi->m_format           = (NiDlDciListElement_s::Format_e) dlDciElem.m_format;
-    dlDciElemNi->m_tpc              = dlDciElem.m_tpc;
-    dlDciElemNi->m_harqProcess      = dlDciElem.m_harqProcess;
-    dlDciElemNi->m_dai              = dlDciElem.m_dai;
-    dlDciElemNi->m_vrbFormat        = (NiDlDciListElement_s::VrbFormat_e) dlDciElem.m_vrbFormat;
-    dlDciElemNi->m_tbSwap           = dlDciElem.m_tbSwap;
-    dlDciElemNi->m_spsRelease       = dlDciElem.m_spsRelease;
-    dlDciElemNi->m_pdcchOrder       = dlDciElem.m_pdcchOrder;
-    dlDciElemNi->m_preambleIndex    = dlDciElem.m_preambleIndex;
-    dlDciElemNi->m_prachMaskIndex   = dlDciElem.m_prachMaskIndex;
-    dlDciElemNi->m_nGap             = (NiDlDciListElement_s::Ngap_e) dlDciElem.m_nGap;
-    dlDciElemNi->m_tbsIdx           = dlDciElem.m_tbsIdx;
-    dlDciElemNi->m_dlPowerOffset    = dlDciElem.m_dlPowerOffset;
-    dlDciElemNi->m_pdcchPowerOffset = dlDciElem.m_pdcchPowerOffset;
-  }
-
-  void
-  NiLtePhyInterface::ConvertFromNiDlDciListElement (NiDlDciListElement_s dlDciElemNi, DlDciListElement_s* dlDciElem)
-  {
-    dlDciElem->m_rnti             = dlDciElemNi.m_rnti;
-    dlDciElem->m_rbBitmap         = dlDciElemNi.m_rbBitmap;
-    dlDciElem->m_rbShift          = dlDciElemNi.m_rbShift;
-    dlDciElem->m_resAlloc         = dlDciElemNi.m_resAlloc;
-    dlDciElem->m_tbsSize.push_back(dlDciElemNi.m_tbsSize);
-    dlDciElem->m_mcs.push_back(dlDciElemNi.m_mcs);
-    dlDciElem->m_ndi.push_back(dlDciElemNi.m_ndi);
-    dlDciElem->m_rv.push_back(dlDciElemNi.m_rv);
-    dlDciElem->m_cceIndex         = dlDciElemNi.m_cceIndex;
-    dlDciElem->m_aggrLevel        = dlDciElemNi.m_aggrLevel;
-    dlDciElem->m_precodingInfo    = dlDciElemNi.m_precodingInfo;
-    dlDciElem->m_format           = (DlDciListElement_s::Format_e) dlDciElemNi.m_format;
-    dlDciElem->m_tpc              = dlDciElemNi.m_tpc;
-    dlDciElem->m_harqProcess      = dlDciElemNi.m_harqProcess;
-    dlDciElem->m_dai              = dlDciElemNi.m_dai;
-    dlDciElem->m_vrbFormat        = (DlDciListElement_s::VrbFormat_e) dlDciElemNi.m_vrbFormat;
-    dlDciElem->m_tbSwap           = dlDciElemNi.m_tbSwap;
-    dlDciElem->m_spsRelease       = dlDciElemNi.m_spsRelease;
-    dlDciElem->m_pdcchOrder       = dlDciElemNi.m_pdcchOrder;
-    dlDciElem->m_preambleIndex    = dlDciElemNi.m_preambleIndex;
-    dlDciElem->m_prachMaskIndex   = dlDciElemNi.m_prachMaskIndex;
-    dlDciElem->m_nGap             = (DlDciListElement_s::Ngap_e) dlDciElemNi.m_nGap;
-    dlDciElem->m_tbsIdx           = dlDciElemNi.m_tbsIdx;
-    dlDciElem->m_dlPowerOffset    = dlDciElemNi.m_dlPowerOffset;
-    dlDciElem->m_pdcchPowerOffset = dlDciElemNi.m_pdcchPowerOffset;
-  }
-
-  void
-  NiLtePhyInterface::ConvertToNiMacCeListElement (MacCeListElement_s BsrElem, NiMacCeListElement_s* BsrElemNi)
-  {
-    BsrElemNi->m_rnti            = BsrElem.m_rnti;
-    BsrElemNi->m_macCeType       = (NiMacCeListElement_s::MacCeType_e) BsrElem.m_macCeType;
-    BsrElemNi->m_phr             = BsrElem.m_macCeValue.m_phr;
-    BsrElemNi->m_crnti           = BsrElem.m_macCeValue.m_crnti;
-    BsrElemNi->m_bufferStatus_0  = BsrElem.m_macCeValue.m_bufferStatus.at(0);
-    BsrElemNi->m_bufferStatus_1  = BsrElem.m_macCeValue.m_bufferStatus.at(1);
-    BsrElemNi->m_bufferStatus_2  = BsrElem.m_macCeValue.m_bufferStatus.at(2);
-    BsrElemNi->m_bufferStatus_3  = BsrElem.m_macCeValue.m_bufferStatus.at(3);
-  }
-
-  void
-  NiLtePhyInterface::ConvertFromNiMacCeListElement (NiMacCeListElement_s BsrElemNi, MacCeListElement_s* BsrElem)
-  {
-    BsrElem->m_rnti               = BsrElemNi.m_rnti;
-    BsrElem->m_macCeType          = (MacCeListElement_s::MacCeType_e) BsrElemNi.m_macCeType;
-    BsrElem->m_macCeValue.m_phr   = BsrElemNi.m_phr;
-    BsrElem->m_macCeValue.m_crnti = BsrElemNi.m_crnti;
-    BsrElem->m_macCeValue.m_bufferStatus.push_back(BsrElemNi.m_bufferStatus_0);
-    BsrElem->m_macCeValue.m_bufferStatus.push_back(BsrElemNi.m_bufferStatus_1);
-    BsrElem->m_macCeValue.m_bufferStatus.push_back(BsrElemNi.m_bufferStatus_2);
-    BsrElem->m_macCeValue.m_bufferStatus.push_back(BsrElemNi.m_bufferStatus_3);
-  }
-
-  void
+  uint32_t
   NiLtePhyInterface::SerializeRarMessage (Ptr<RarLteControlMessage> rar , uint8_t* buffer, uint32_t* bufferOffset)
   {
     // serialize rar message
-    uint8_t rarMsgCnt=0;
+    uint32_t rarMsgCnt=0;
     for (std::list<RarLteControlMessage::Rar>::const_iterator it = rar->RarListBegin (); it != rar->RarListEnd ();++it){
         rarMsgCnt++;
     }
-    // store rar rnti in pdu
-    uint16_t raRnti = rar->GetRaRnti ();
-    std::memcpy(buffer+*bufferOffset, (uint8_t*)&raRnti, sizeof(raRnti));
-    *bufferOffset += sizeof(raRnti);
-    // store number of messages in pdu
-    std::memcpy(buffer+*bufferOffset, (uint8_t*)&rarMsgCnt, sizeof(rarMsgCnt));
-    *bufferOffset += sizeof(rarMsgCnt);
+    NiLteBitWriter writer (buffer+*bufferOffset);
+    writer.Put (LteControlMessage::RAR, NI_LTE_CTRL_MSG__TYPE_BITS);
+    // store rar rnti and number of messages in pdu
+    NiLteRarCodec::Encode (writer, rar->GetRaRnti (), rarMsgCnt);
     for (std::list<RarLteControlMessage::Rar>::const_iterator it = rar->RarListBegin (); it != rar->RarListEnd ();++it){
-        uint8_t rapId                    = it->rapId;
-        BuildRarListElement_s rarPayload = it->rarPayload;
-        uint16_t m_rnti                  = rarPayload.m_rnti;
-        UlGrant_s m_grant                = rarPayload.m_grant;
-        // store rapId in pdu
-        std::memcpy(buffer+*bufferOffset, (uint8_t*)&rapId, sizeof(rapId));
-        *bufferOffset += sizeof(rapId);
-        // store m_rnti in pdu
-        std::memcpy(buffer+*bufferOffset, (uint8_t*)&m_rnti, sizeof(m_rnti));
-        *bufferOffset += sizeof(m_rnti);
-        // store m_rnti in pdu
-        std::memcpy(buffer+*bufferOffset, (uint8_t*)&m_grant, sizeof(m_grant));
-        *bufferOffset += sizeof(m_grant);
+        // store rapId, m_rnti and m_grant in pdu
         // note that the dl dci element that is part of the rar is not used and transferred here
-
-        /*NI_LOG_DEBUG("Serialize RAR Message: "
-            << " raRnti=" << (uint16_t)raRnti
-            << " rarMsgCnt=" << (uint16_t)rarMsgCnt
-            << " rapId=" << (uint16_t)rapId
-            << " m_rnti=" << (uint16_t)m_rnti);*/
+        NiLteRarCodec::EncodeRar (writer, *it);
     }
+    const uint32_t rarMsgSize = writer.Finish ();
+    *bufferOffset += rarMsgSize;
+    return rarMsgSize;
   }
 
   uint16_t
-  NiLtePhyInterface::DeserializeRarMessage (Ptr<RarLteControlMessage> rarMsg , uint8_t* buffer, uint32_t* bufferOffset)
+  NiLtePhyInterface::DeserializeRarMessage (Ptr<RarLteControlMessage> rarMsg , NiLteBitReader& reader)
   {
     // extract and set rar control element
     uint16_t raRnti;
-    std::memcpy(&raRnti, buffer+*bufferOffset, sizeof(raRnti));
-    *bufferOffset += sizeof(raRnti);
+    uint32_t rarMsgCnt;
+    // extract rar rnti and number of messages
+    NiLteRarCodec::Decode (reader, &raRnti, &rarMsgCnt);
     rarMsg->SetRaRnti (raRnti);
-    // extract number of messages
-    uint8_t rarMsgCnt=0;
-    std::memcpy(&rarMsgCnt, buffer+*bufferOffset, sizeof(rarMsgCnt));
-    *bufferOffset += sizeof(rarMsgCnt);
 
     // extract rar messages
-    uint8_t   rapId;
-    uint16_t  m_rnti;
-    UlGrant_s m_grant;
-    for (uint32_t cntMessage = 0; cntMessage < rarMsgCnt ; cntMessage  ++){
-
-        std::memcpy(&rapId, buffer+*bufferOffset, sizeof(rapId));
-        *bufferOffset += sizeof(rapId);
-
-        std::memcpy(&m_rnti, buffer+*bufferOffset, sizeof(m_rnti));
-        *bufferOffset += sizeof(m_rnti);
-
-        std::memcpy(&m_grant, buffer+*bufferOffset, sizeof(m_grant));
-        *bufferOffset += sizeof(m_grant);
-
+    uint16_t  m_rnti = 0;
+    for (uint32_t cntMessage = 0; (cntMessage < rarMsgCnt) && !reader.IsOverrun (); cntMessage  ++){
         // create new rar list element
-        BuildRarListElement_s rarListElem;
-        rarListElem.m_rnti  = m_rnti;
-        rarListElem.m_grant = m_grant;
         RarLteControlMessage::Rar rar;
-        rar.rapId      = rapId;
-        rar.rarPayload = rarListElem;
+        NiLteRarCodec::DecodeRar (reader, &rar);
+        m_rnti = rar.rarPayload.m_rnti;
         rarMsg->AddRar (rar);
-
-        /*NI_LOG_DEBUG("Deserialized RAR Message: "
-            << "raRnti=" << (uint16_t)raRnti
-            << " / rarMsgCnt=" << (uint16_t)rarMsgCnt
-            << " / rapId=" << (uint16_t)rapId << " / m_rnti="
-            << (uint16_t)m_rnti);*/
     }
 
     return m_rnti;
   }
 
-  void
+  uint32_t
   NiLtePhyInterface::SerializeDlCqiMessage (Ptr<DlCqiLteControlMessage> dlCqiMsg , uint8_t* buffer, uint32_t* bufferOffset)
   {
-    CqiListElement_s dlCqiElem = dlCqiMsg->GetDlCqi ();
-
-    // serialize m_rnti
-    std::memcpy(buffer+*bufferOffset, (uint16_t*)&dlCqiElem.m_rnti, sizeof(dlCqiElem.m_rnti));
-    *bufferOffset += sizeof(dlCqiElem.m_rnti);
-    // serialize m_ri
-    std::memcpy(buffer+*bufferOffset, (uint8_t*)&dlCqiElem.m_ri, sizeof(dlCqiElem.m_ri));
-    *bufferOffset += sizeof(dlCqiElem.m_ri);
-    // serialize m_cqiType
-    std::memcpy(buffer+*bufferOffset, &dlCqiElem.m_cqiType, sizeof(dlCqiElem.m_cqiType));
-    *bufferOffset += sizeof(dlCqiElem.m_cqiType);
-    // serialize number of wbCqi elements
-    uint8_t wbCqiNum = dlCqiElem.m_wbCqi.size();
-    std::memcpy(buffer+*bufferOffset, (uint8_t*)&wbCqiNum, sizeof(wbCqiNum));
-    *bufferOffset += sizeof(wbCqiNum);
-    if (wbCqiNum>0){
-        // serialize m_wbCqi -> simplification: only one layer supported
-        std::memcpy(buffer+*bufferOffset, (uint8_t*)&dlCqiElem.m_wbCqi.at(0), sizeof(dlCqiElem.m_wbCqi.at(0)));
-        *bufferOffset += sizeof(dlCqiElem.m_wbCqi.at(0));
-    }
-    // serialize number of sbCqi elements
     // NOTE: the following elements are not transmitted as there are not used:
     // m_wbPmi, m_ueSelected, m_bwPart, m_sbList, m_sbPmi
-    uint8_t sbCqiNum = dlCqiElem.m_sbMeasResult.m_higherLayerSelected.size();
-    std::memcpy(buffer+*bufferOffset, (uint8_t*)&sbCqiNum, sizeof(sbCqiNum));
-    *bufferOffset += sizeof(sbCqiNum);
-    if (sbCqiNum>0){
-        // serialize m_higherLayerSelected vector
-        for (uint32_t cntCqi = 0; cntCqi < sbCqiNum ; cntCqi  ++){
-            // serialize m_sbCqi -> simplification: only one layer supported
-            uint8_t sbCqi = dlCqiElem.m_sbMeasResult.m_higherLayerSelected.at(cntCqi).m_sbCqi.at(0);
-            std::memcpy(buffer+*bufferOffset, (uint8_t*)&sbCqi, sizeof(sbCqi));
-            *bufferOffset += sizeof(sbCqi);
-        }
-    }
-
-    /*NI_LOG_DEBUG("Serialize Dl CQI Message: "
-        << " m_rnti=" << (uint16_t)dlCqiElem.m_rnti
-        << " sbCqiNum=" << (uint16_t)sbCqiNum
-        << " wbCqiNum=" << (uint16_t)wbCqiNum);*/
+    // simplification: only one layer supported
+    NiLteBitWriter writer (buffer+*bufferOffset);
+    writer.Put (LteControlMessage::DL_CQI, NI_LTE_CTRL_MSG__TYPE_BITS);
+    NiLteDlCqiCodec::Encode (writer, dlCqiMsg->GetDlCqi ());
+    const uint32_t dlCqiMsgSize = writer.Finish ();
+    *bufferOffset += dlCqiMsgSize;
+    return dlCqiMsgSize;
   }
 
   void
-  NiLtePhyInterface::DeserializeDlCqiMessage (Ptr<DlCqiLteControlMessage> dlCqiMsg , uint8_t* buffer, uint32_t* bufferOffset)
+  NiLtePhyInterface::DeserializeDlCqiMessage (Ptr<DlCqiLteControlMessage> dlCqiMsg , NiLteBitReader& reader)
   {
     CqiListElement_s dlCqiElem;
-
-    // deserialize m_rnti
-    std::memcpy(&dlCqiElem.m_rnti, buffer+*bufferOffset, sizeof(dlCqiElem.m_rnti));
-    *bufferOffset += sizeof(dlCqiElem.m_rnti);
-    // serialize m_ri
-    std::memcpy(&dlCqiElem.m_ri, buffer+*bufferOffset, sizeof(dlCqiElem.m_ri));
-    *bufferOffset += sizeof(dlCqiElem.m_ri);
-    // serialize m_cqiType
-    std::memcpy(&dlCqiElem.m_cqiType, buffer+*bufferOffset, sizeof(dlCqiElem.m_cqiType));
-    *bufferOffset += sizeof(dlCqiElem.m_cqiType);
-    // deserialize number of wbCqi elements
-    uint8_t wbCqiNum;
-    std::memcpy((uint8_t*)&wbCqiNum, buffer+*bufferOffset, sizeof(wbCqiNum));
-    *bufferOffset += sizeof(wbCqiNum);
-    if (wbCqiNum>0){
-        // serialize m_wbCqi -> simplification: only one layer supported
-        uint8_t wbCqi;
-        std::memcpy(&wbCqi,buffer+*bufferOffset, sizeof(wbCqi));
-        *bufferOffset += sizeof(wbCqi);
-        dlCqiElem.m_wbCqi.push_back(wbCqi);
-    }
-    // serialize number of cqi elements
-    uint8_t sbCqiNum;
-    std::memcpy((uint8_t*)&sbCqiNum, buffer+*bufferOffset, sizeof(sbCqiNum));
-    *bufferOffset += sizeof(sbCqiNum);
-    if (sbCqiNum>0){
-        // deserialize m_higherLayerSelected vector
-        for (uint32_t cntCqi = 0; cntCqi < sbCqiNum ; cntCqi  ++){
-            HigherLayerSelected_s hlCqi;
-            // deserialize m_sbCqi -> simplification: only one layer supported
-            uint8_t sbCqi;
-            std::memcpy(buffer+*bufferOffset, (uint8_t*)&sbCqi, sizeof(sbCqi));
-            *bufferOffset += sizeof(sbCqi);
-            hlCqi.m_sbCqi.push_back(sbCqi);
-            dlCqiElem.m_sbMeasResult.m_higherLayerSelected.push_back(hlCqi);
-        }
-    }
-
+    NiLteDlCqiCodec::Decode (reader, &dlCqiElem);
     dlCqiMsg->SetDlCqi (dlCqiElem);
-
-    /*NI_LOG_DEBUG("Deserialize Dl CQI Message: "
-            << " m_rnti=" << (uint16_t)dlCqiElem.m_rnti
-            << " sbCqiNum=" << (uint16_t)sbCqiNum
-            << " wbCqiNum=" << (uint16_t)wbCqiNum);*/
   }
 
   void
@@ -1804,6 +1940,9 @@ namespace ns3
                                       uint64_t ueToEnbSfoffset // inital subframe offset between UE and eNB determined by MIB reception, for eNB this value is always 0
                                      )
   {
+    // received MAC PDUs are accounted to the nested NI_ALLOC_SCOPE_PHY_RX scopes
+    NiAllocScope allocScope (NI_ALLOC_SCOPE_SUBFRAME);
+
     const int defaultTtiDuration = NI_LTE_CONST_TTI_DURATION_US;
     const int errorTtiDuration   = 666; // defaultTtiTiming*2/3
     const int warningTtiDuration = 333; // defaultTtiTiming*1/3
@@ -1813,21 +1952,26 @@ namespace ns3
         NI_LOG_FATAL("NS3 TTI duration (" << ns3TtiTimingUs <<") not equal to: " << defaultTtiDuration << "(us)");
       }
 
+    const uint64_t startTimeNs = NiUtils::GetSysTimeNs();
+
     // tracing used for performance measurements
     g_logTraceStartSubframeTime = NiUtils::GetSysTime();
-    NI_LOG_TRACE("[Trace#0],StartSubFrameStart," << (NiUtils::GetSysTime()-g_logTraceStartSubframeTime));
+    NI_TRACE(NI_TRACE_START_SUBFRAME_START, nrFrames, nrSubFrames, NiUtils::GetSysTime()-g_logTraceStartSubframeTime);
 
     // check for first subframe / iteration
     const bool firstRun = (Simulator::Now().GetMicroSeconds() == 0) ? true : false;
 
     // wait for the first timing indication
-    if (firstRun) WaitForPhyTimingInd();
+    NiPhyTimingSnapshot timingSnapshot;
+    if (firstRun) WaitForPhyTimingInd(&timingSnapshot);
 
     // get actual system time
     const uint64_t systemTimeUs = NiUtils::GetSysTime();
 
     // wait for PhyTimingInd to ensure PHY is sync with simulator
-    const uint64_t timingIndTimeUs = WaitForPhyTimingInd();
+    const uint64_t timingIndTimeUs = WaitForPhyTimingInd(&timingSnapshot);
+    // the first iteration waits for the PHY to start
+    if (!firstRun) g_NiLatency.Record(NI_LATENCY_SUBFRAME_TIMING_WAIT, NiUtils::GetSysTimeNs() - startTimeNs);
 
     // calculate difference to PHY timing indication
     //  diff positive -> PHY timing before NS3 Simulator
@@ -1843,54 +1987,88 @@ namespace ns3
       }
     else
       {
-        if (absDiffUs > warningTtiDuration)
+        // check the largest limit first, otherwise only the warning would ever be reported
+        if (absDiffUs > defaultTtiDuration) // FATAL ERROR if above 1ms
           {
-            NI_LOG_WARN("PHY timing extended TTI*1/3 limit with " + std::to_string(diffUs) + "us");
+            m_numTimingDiffFatal++;
+            NI_LOG_FATAL("PHY timing extended TTI limit with " + std::to_string(diffUs) + "us");
+            diffUs %= defaultTtiDuration;
           }
         else if (absDiffUs > errorTtiDuration)
           {
+            m_numTimingDiffError++;
             NI_LOG_ERROR("PHY timing extended TTI*2/3 limit with " + std::to_string(diffUs) + "us");
           }
-        else if (absDiffUs > defaultTtiDuration) // FATAL ERROR if above 1ms
+        else if (absDiffUs > warningTtiDuration)
           {
-            NI_LOG_FATAL("PHY timing extended TTI limit with " + std::to_string(diffUs) + "us");
-            diffUs %= defaultTtiDuration;
+            m_numTimingDiffWarning++;
+            NI_LOG_WARN("PHY timing extended TTI*1/3 limit with " + std::to_string(diffUs) + "us");
           }
       }
 
     // calculate timing difference between simulator start subframe and PHY timing indication
     m_niLteSdrTimingSync->CalcPhyTimeDiff(diffUs);
 
-    // get NI FPGA PHY timing based on PHY timing indication
-    const uint16_t timingIndSfn = m_niPipeTransport->GetTimingIndSfn();
-    const uint8_t timingIndTti = m_niPipeTransport->GetTimingIndTti();
+    // get NI FPGA PHY timing based on PHY timing indication - from the same snapshot as its time
+    const uint16_t timingIndSfn = (uint16_t) timingSnapshot.sfn;
+    const uint8_t timingIndTti = (uint8_t) timingSnapshot.tti;
 
     // calc and track the TTI/SFN offset (m_sfnSfOffset) between PHY and Simulator timing
     m_niLteSdrTimingSync->ReCalcSfnSfOffset(firstRun, nrFrames, nrSubFrames,
                                             timingIndSfn, timingIndTti,
                                             ueToEnbSfoffset, m_sfnSfOffset);
 
-    NI_LOG_TRACE("[Trace#1],SFN,TTI,diffNs3ToPhyTimingInd,timingIndTimeUs," <<
-                 "systemTimeUs,simTimeUs,g_alignmentOffset,g_globalTimingdiffNano," <<
-                 timingIndSfn << "," << std::to_string(timingIndTti) << "," << diffUs << "," << timingIndTimeUs << "," <<
-                 systemTimeUs << "," << Simulator::Now().GetMicroSeconds() << "," << m_niLteSdrTimingSync->GetAlignmentOffset() << "," << m_niLteSdrTimingSync->GetGlobalTimingdiffNano());
+    // system time of the subframe start is timingIndTimeUs + diffNs3ToPhyTimingInd
+    NI_TRACE(NI_TRACE_PHY_TIMING_IND, timingIndSfn, timingIndTti, diffUs, timingIndTimeUs,
+             m_niLteSdrTimingSync->GetAlignmentOffset(), m_niLteSdrTimingSync->GetGlobalTimingdiffNano(),
+             m_niPipeTransport->GetTimingIndWaitStats().lastWakeLatencyNs);
 
     // store value for evaluation in next iteration
     m_lastTimingIndTimeUs = timingIndTimeUs;
+    m_lastTimingIndSeqNum = timingSnapshot.seqNum;
 
-    UpdateNiChannelSinrValueFromRemoteControl();
+    // hand over MAC PDUs received by the pipe transport since the last subframe
+    NiProcessRxPduQueue();
+
+    // remote control updates are applied at a lower rate while the real-time loop is degraded
+    if (!m_deadlineMonitor.IsActive (NI_DEADLINE_LEVEL_DEFER_RC) ||
+        (m_deadlineMonitor.GetNumSubframes () % NI_DEADLINE__RC_DEFER_PERIOD == 0))
+      {
+        UpdateNiChannelSinrValueFromRemoteControl();
+      }
+  }
+
+  // called once per subframe after the tx requests were sent
+  void
+  NiLtePhyInterface::NiUpdateDeadlineMonitor (void)
+  {
+    // the budget starts with the PHY timing indication the subframe was aligned to
+    if (m_lastTimingIndTimeUs == 0) return;
+
+    const uint64_t usedUs = NiUtils::GetSysTime() - m_lastTimingIndTimeUs;
+    const bool levelChanged = m_deadlineMonitor.RecordSubframe (usedUs);
+    ParameterDataBase* pdb = g_RemoteControlEngine.GetPdb();
+    if (m_deadlineMonitor.GetLastSlackUs () < 0)
+      {
+        pdb->numLteDeadlineMiss.Increment(1);
+      }
+    if (levelChanged)
+      {
+        const enum NiDeadlineLevel level = m_deadlineMonitor.GetLevel ();
+        NI_LOG_WARN ("Deadline level changed to " << NiLteDeadlineMonitor::GetLevelName (level) <<
+                     " - tight subframe rate " << m_deadlineMonitor.GetTightRate () <<
+                     ", miss rate " << m_deadlineMonitor.GetMissRate ());
+        g_NiLogging.SetSuppressedLevels (m_deadlineMonitor.IsActive (NI_DEADLINE_LEVEL_NO_DEBUG_LOG) ?
+                                         (LOG__DEBUG | LOG__TRACE | LOG__CONSOLE_DEBUG) : LOG__NONE);
+        pdb->lteDeadlineLevel.Set(level);
+      }
   }
 
   uint64_t
-  NiLtePhyInterface::WaitForPhyTimingInd()
+  NiLtePhyInterface::WaitForPhyTimingInd(NiPhyTimingSnapshot* pSnapshot)
   {
-    uint64_t timingIndTimeUs = 0;
-    const struct timespec ts = {0, 1000L}; // 1us
-    uint32_t numWaitIterations = 0;
-    uint64_t systemTimeUs,waitTimeUs;
     bool firstTimingInd = false;
 
-
     if (m_niPipeTransport->GetTimingIndReceived() == false)
       {
         NI_LOG_CONSOLE_INFO ("    Waiting for first LTE PHY timing indication...");
@@ -1898,39 +2076,42 @@ namespace ns3
         firstTimingInd = true;
       }
 
-    systemTimeUs = NiUtils::GetSysTime();
+    const uint64_t systemTimeUs = NiUtils::GetSysTime();
 
-    // in case timing indication was not received, wait until reception
-    while ((m_niPipeTransport->GetTimingIndReceived() == false) ||
-           (m_niPipeTransport->GetTimingIndTime() == m_lastTimingIndTimeUs))
+    // wait for a timing indication newer than the one of the last subframe,
+    // spin shortly and block on the futex of the published timing snapshot afterwards
+    while (!m_niPipeTransport->WaitForTimingInd(m_lastTimingIndSeqNum, pSnapshot, m_niTimingIndSpinUs * 1000ULL, 0))
       {
-        nanosleep( &ts, NULL );
-        numWaitIterations++;
-      }
-    timingIndTimeUs = m_niPipeTransport->GetTimingIndTime();
-    waitTimeUs = NiUtils::GetSysTime() - systemTimeUs;
-    if (numWaitIterations > 0)
-      {
-        NI_LOG_DEBUG ("Waited " + std::to_string(numWaitIterations) + " iterations for timing indication, waitTimeUs: " + std::to_string(waitTimeUs));
       }
+    const uint64_t waitTimeUs = NiUtils::GetSysTime() - systemTimeUs;
+    NI_LOG_DEBUG ("Waited " + std::to_string(waitTimeUs) + "us for timing indication, wake latency: " +
+                  std::to_string(m_niPipeTransport->GetTimingIndWaitStats().lastWakeLatencyNs) + "ns");
     if (firstTimingInd)
       {
         NI_LOG_CONSOLE_INFO ("    ...done!" << std::endl << "[~] NS-3 Simulator executing...");
       }
-    return timingIndTimeUs;
+    return pSnapshot->sysTimeUs;
   }
 
   void
   NiLtePhyInterface::UpdateNiChannelSinrValueFromRemoteControl(void)
   {
+    // parameters are only re-read after the remote control wrote any of them
+    ParameterDataBase* pdb = g_RemoteControlEngine.GetPdb();
+    const uint64_t rcParameterVersion = pdb->GetVersion();
+    if (m_rcParameterVersion == rcParameterVersion)
+      {
+        return;
+      }
+    m_rcParameterVersion = rcParameterVersion;
     // update channel SINR value only in case manual channel SINR setting via remote control engine is enabled
     // in oder to not interfer with PHY_CELL_MEASUREMENT_IND
-    if (g_RemoteControlEngine.GetPdb()->getParameterManualLteUeChannelSinrEnable() == true)
+    if (pdb->getParameterManualLteUeChannelSinrEnable() == true)
       {
         //read out values from remote control database and overwrite local sinr value
-        if (GetNiChannelSinrValue() != g_RemoteControlEngine.GetPdb()->getParameterLteUeChannelSinr())
+        const double sinr = pdb->getParameterLteUeChannelSinr();
+        if (GetNiChannelSinrValue() != sinr)
           {
-            double sinr = g_RemoteControlEngine.GetPdb()->getParameterLteUeChannelSinr();
             SetNiChannelSinrValue(sinr);
             NI_LOG_CONSOLE_DEBUG("NI.RC:LteUeChannelSinr value changed! SINR value is : " << sinr);
           }
@@ -33,6 +33,8 @@
 #include <ns3/spectrum-value.h>
 #include <ns3/lte-spectrum-phy.h>
 
+#include <ns3/ni-lte-ctrl-msg-codec.h>
+
 #include "ns3/ni.h"
 
 namespace ns3
@@ -52,86 +54,36 @@ namespace ns3
     NIAPI_NONE = 3,
   } NiApiDevType_t;
 
-  // packet identifier
-  typedef enum {
-    NIAPI_DL_PACKET  = 0,
-    NIAPI_UL_PACKET  = 1,
-    NIAPI_UNDEF_PACKET = 2, //undefined packet type
-  } NiApiPacketType_t ;
-
-  typedef Callback< void, Ptr<Packet> > NiPhyRxDataEndOkCallback;
-  typedef Callback< void, std::list<Ptr<LteControlMessage> > > NiPhyRxCtrlEndOkCallback;
-  typedef Callback< void, const SpectrumValue& > NiPhyRxCqiReportCallback;
-  typedef Callback< Ptr<LteSpectrumPhy> > NiPhySpectrumModelCallback;
+  // MAC PDU handed over from the NI transport rx thread to the simulator thread
+  struct NiRxPduQueueEntry {
+    uint32_t size;
+    uint8_t  data[MAX_MAC_PDU_SIZE];
+  };
 
-  struct NiApiPacketHeader {
-    uint8_t  niApiPacketType;
-    uint32_t nrFrames;
-    uint8_t  nrSubFrames;
-    uint32_t cellId;
+  // SINR report or CRC result handed over from the NI transport rx thread to the
+  // simulator thread, which owns the channel SINR and the link adaptation state
+  struct NiLinkAdaptationQueueEntry {
+    bool     isCrc;
     uint16_t rnti;
-    uint8_t  numCtrlMsg;
-    uint8_t  numPaylMsg;
+    bool     crcOk;
+    double   widebandSinrDb;
+    uint32_t numSubbands;
+    double   subbandSinrDb[NI_LINK_ADAPTATION__MAX_SUBBANDS];
   };
 
-  struct NiDlDciListElement_s
-  {
-    uint16_t  m_rnti;
-    uint32_t  m_rbBitmap;
-    uint8_t   m_rbShift;
-    uint8_t   m_resAlloc;
-    // NOTE: restriction to one transport block
-    uint16_t  m_tbsSize;
-    uint8_t   m_mcs;
-    uint8_t   m_ndi;
-    uint8_t   m_rv;
-    uint8_t   m_cceIndex;
-    uint8_t   m_aggrLevel;
-    uint8_t   m_precodingInfo;
-    enum Format_e
-    {
-      ONE, ONE_A, ONE_B, ONE_C, ONE_D, TWO, TWO_A, TWO_B
-    } m_format;
-    uint8_t   m_tpc;
-    uint8_t   m_harqProcess;
-    uint8_t   m_dai;
-    enum VrbFormat_e
-    {
-      VRB_DISTRIBUTED,
-      VRB_LOCALIZED
-    } m_vrbFormat;
-    bool      m_tbSwap;
-    bool      m_spsRelease;
-    bool      m_pdcchOrder;
-    uint8_t   m_preambleIndex;
-    uint8_t   m_prachMaskIndex;
-    enum Ngap_e
-    {
-      GAP1, GAP2
-    } m_nGap;
-    uint8_t   m_tbsIdx;
-    uint8_t   m_dlPowerOffset;
-    uint8_t   m_pdcchPowerOffset;
-  };
+  // preallocated entries of the rx / tx packet and control message pools,
+  // larger subframes fall back to heap allocations
+#define NI_LTE_PHY_POOL_SIZE 64
 
-  struct NiMacCeListElement_s
-  {
-    uint16_t  m_rnti;
-    enum MacCeType_e
-    {
-      BSR, PHR, CRNTI
-    } m_macCeType;
-    uint8_t   m_phr;
-    uint8_t   m_crnti;
-    // NOTE: always four - see LteUeMac::SendReportBufferStatus
-    uint8_t   m_bufferStatus_0;
-    uint8_t   m_bufferStatus_1;
-    uint8_t   m_bufferStatus_2;
-    uint8_t   m_bufferStatus_3;
-  };
+  typedef Callback< void, Ptr<Packet> > NiPhyRxDataEndOkCallback;
+  typedef Callback< void, std::list<Ptr<LteControlMessage> > > NiPhyRxCtrlEndOkCallback;
+  typedef Callback< void, const SpectrumValue& > NiPhyRxCqiReportCallback;
+  typedef Callback< Ptr<LteSpectrumPhy> > NiPhySpectrumModelCallback;
 
   class NiLtePhyInterface : public Object
   {
+    // measures the private control and data frame codecs, see ni-micro-bench
+    friend class NiLtePhyInterfaceBench;
 
   public:
 
@@ -158,10 +110,13 @@ namespace ns3
     double GetNiChannelSinrValue () const;
     void SetNiChannelSinrValue (double chSinrDb);
     void UpdateNiChannelSinrValueFromRemoteControl(void);
+    // maximum number of UEs scheduled per TTI while the real-time loop is degraded, 0 if not limited
+    uint32_t GetNiMaxUesPerTti () const;
+    void NiNotifySkippedUes (uint32_t numUes);
 
     uint64_t NiSfnTtiCounterSync(uint32_t* m_nrFrames, uint32_t* m_nrSubFrames);
 
-    bool NiStartTxCtrlDataFrame (Ptr<PacketBurst> packetBurst, std::list<Ptr<LteControlMessage> > ctrlMsgList, uint32_t m_nrFrames, uint32_t m_nrSubFrames);
+    bool NiStartTxCtrlDataFrame (Ptr<PacketBurst> packetBurst, const std::list<Ptr<LteControlMessage> > &ctrlMsgList, uint32_t m_nrFrames, uint32_t m_nrSubFrames);
 
     void NiStartSubframe (uint32_t nrFrames, uint32_t nrSubFrames, int64_t ns3TtiTimingUs, uint64_t ueToEnbSfoffset);
 
@@ -171,6 +126,8 @@ namespace ns3
     void SetNiApiDevType (std::string type);
     void SetNiApiEnable (bool enable);
     void SetNiApiLoopbackEnable (bool enable);
+    void SetNiApiPipeRxMode (std::string mode);
+    void SetNiApiTransportType (std::string type);
 
     void InitializeNiUdpTransport();
     void DeInitializeNiUdpTransport();
@@ -181,28 +138,33 @@ namespace ns3
 
     void NiGenerateCqiReport ();
 
-    bool NiStartTxDlCtrlFrameBc (Ptr<PacketBurst> packetBurst, std::list<Ptr<LteControlMessage> > ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t &controlMessageCnt, std::map <uint16_t, uint16_t> &rntiMap);
-    bool NiStartTxDlCtrlFrameUc (Ptr<PacketBurst> packetBurst, std::list<Ptr<LteControlMessage> > ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t &controlMessageCnt, uint16_t curRnti);
-    bool NiStartTxUlCtrlFrame (Ptr<PacketBurst> packetBurst, std::list<Ptr<LteControlMessage> > ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t &controlMessageCnt);
+    bool NiStartTxDlCtrlFrameBc (Ptr<PacketBurst> packetBurst, const std::list<Ptr<LteControlMessage> > &ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t &controlMessageCnt, std::map <uint16_t, uint16_t> &rntiMap);
+    bool NiStartTxDlCtrlFrameUc (Ptr<PacketBurst> packetBurst, const std::list<Ptr<LteControlMessage> > &ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t &controlMessageCnt, uint16_t curRnti);
+    bool NiStartTxUlCtrlFrame (Ptr<PacketBurst> packetBurst, const std::list<Ptr<LteControlMessage> > &ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t &controlMessageCnt);
     bool NiStartTxDataFrame (Ptr<PacketBurst> packetBurst, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t curRnti);
     bool NiStartTxApiSend (uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset);
+    void NiFlushTxApiPdus (void);
 
-    bool NiStartRxCtrlDataFrame (uint8_t* payloadDataBuffer);
+    bool NiStartRxUdpCtrlDataFrame (uint8_t* payloadDataBuffer);
+    bool NiStartRxCtrlDataFrame (uint8_t* payloadDataBuffer, uint32_t payloadDataBufSize);
+    bool NiEnqueueRxCtrlDataFrame (uint8_t* payloadDataBuffer, uint32_t payloadSize);
+    void NiProcessRxPduQueue (void);
     bool NiStartRxCellMeasurementIndHandler (PhyCellMeasInd phyCellMeasInd);
-    bool NiStartRxDlCtrlFrame (Ptr<PacketBurst> packetBurst, std::list<Ptr<LteControlMessage> > &ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset);
-    bool NiStartRxUlCtrlFrame (Ptr<PacketBurst> packetBurst, std::list<Ptr<LteControlMessage> > &ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset);
-    bool NiStartRxDataFrame (Ptr<PacketBurst> packetBurst, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset);
-
-    void ConvertToNiDlDciListElement (DlDciListElement_s dlDciElem, NiDlDciListElement_s* dlDciElemNi);
-    void ConvertFromNiDlDciListElement (NiDlDciListElement_s dlDciElemNi, DlDciListElement_s* dlDciElem);
-    void ConvertToNiMacCeListElement (MacCeListElement_s BsrElem, NiMacCeListElement_s* BsrElemNi);
-    void ConvertFromNiMacCeListElement (NiMacCeListElement_s BsrElemNi, MacCeListElement_s* BsrElem);
-    void SerializeRarMessage (Ptr<RarLteControlMessage> rar , uint8_t* buffer, uint32_t* bufferOffset);
-    uint16_t DeserializeRarMessage (Ptr<RarLteControlMessage> rar , uint8_t* buffer, uint32_t* bufferOffset);
-    void SerializeDlCqiMessage (Ptr<DlCqiLteControlMessage> dlCqiMsg , uint8_t* buffer, uint32_t* bufferOffset);
-    void DeserializeDlCqiMessage (Ptr<DlCqiLteControlMessage> dlCqiMsg , uint8_t* buffer, uint32_t* bufferOffset);
-
-    uint64_t WaitForPhyTimingInd (void);
+    bool NiStartRxCrcResultHandler (uint16_t rnti, bool crcOk);
+    // decode one message bounded by payloadDataBufSize, false if the MAC PDU is truncated or malformed
+    bool NiStartRxDlCtrlFrame (std::vector<Ptr<Packet> > &rxPackets, std::list<Ptr<LteControlMessage> > &ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t payloadDataBufSize);
+    bool NiStartRxUlCtrlFrame (std::vector<Ptr<Packet> > &rxPackets, std::list<Ptr<LteControlMessage> > &ctrlMsgList, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t payloadDataBufSize);
+    bool NiStartRxDataFrame (std::vector<Ptr<Packet> > &rxPackets, uint8_t* payloadDataBuffer, uint32_t* payloadDataBufOffset, uint32_t payloadDataBufSize);
+    void NiRxCtrlMsgListAppend (std::list<Ptr<LteControlMessage> > &ctrlMsgList, Ptr<LteControlMessage> msg);
+
+    // serialize the message including its type, return the number of bytes written
+    uint32_t SerializeRarMessage (Ptr<RarLteControlMessage> rar , uint8_t* buffer, uint32_t* bufferOffset);
+    uint16_t DeserializeRarMessage (Ptr<RarLteControlMessage> rar , NiLteBitReader& reader);
+    uint32_t SerializeDlCqiMessage (Ptr<DlCqiLteControlMessage> dlCqiMsg , uint8_t* buffer, uint32_t* bufferOffset);
+    void DeserializeDlCqiMessage (Ptr<DlCqiLteControlMessage> dlCqiMsg , NiLteBitReader& reader);
+
+    uint64_t WaitForPhyTimingInd (NiPhyTimingSnapshot* pSnapshot);
+    void NiUpdateDeadlineMonitor (void);
     void NiSetTti (uint64_t tti_us);
 
     NiPhyRxDataEndOkCallback m_niPhyRxDataEndOkCallback;
@@ -251,6 +213,60 @@ namespace ns3
 
     int64_t m_sfnSfOffset;
     uint64_t m_lastTimingIndTimeUs;
+    uint64_t m_lastTimingIndSeqNum;  // timing indication the last subframe was aligned to
+    uint32_t m_niTimingIndSpinUs;
+
+    // subframes exceeding the PHY timing diff limits of NiStartSubframe
+    uint64_t m_numTimingDiffWarning;
+    uint64_t m_numTimingDiffError;
+    uint64_t m_numTimingDiffFatal;
+
+    NiPipeRxMode_t m_niApiPipeRxMode;
+    bool m_niApiShmTransport; // shared memory rings instead of named pipes
+    // AFW instance of the first pipe transport of the process, further PHYs use the next free ones
+    uint32_t m_niApiInstanceId = 0;
+
+    // rx hand-off from pipe transport thread (producer) to simulator thread (consumer)
+    NiSpscRing<NiRxPduQueueEntry>* m_niRxPduQueue;
+    uint32_t m_niRxPduQueueSize;
+    uint64_t m_niRxPduQueueNumBatches;
+    // received MAC PDUs dropped as truncated, malformed or of another wire format version
+    uint64_t m_niRxNumDecodeErrors;
+    // remote control data base version of the last SINR parameter read
+    uint64_t m_rcParameterVersion;
+
+    // slack of each subframe and degradation of the real-time loop when falling behind
+    NiLteDeadlineMonitor m_deadlineMonitor;
+    uint32_t m_niDeadlineBudgetUs = 1000;
+    uint32_t m_niDeadlineMarginUs = 200;
+    uint32_t m_niDeadlineMaxLevel = NI_DEADLINE_LEVEL_CAP_PDUS;
+    double   m_niDeadlineDegradeRate = 0.1;
+    double   m_niDeadlineRecoverRate = 0.02;
+    uint32_t m_niDeadlinePduCap = 1;
+    uint64_t m_numDeadlineSkippedUes = 0;
+
+    // outer loop link adaptation of the CQI reports from the PHY subband SINR and the CRC results
+    NiLteLinkAdaptation m_linkAdaptation;
+    NiSpscRing<NiLinkAdaptationQueueEntry>* m_niLinkAdaptationQueue = NULL;
+    bool     m_niLinkAdaptationEnable = false;
+    double   m_niLinkAdaptationBlerTarget = 0.1;
+    double   m_niLinkAdaptationStepDb = 0.5;
+
+    // downlink MAC PDUs of all UEs of a TTI, built in place and sent together by NiFlushTxApiPdus
+    // as one multi PDU config / payload request pair instead of one pair per UE
+    bool m_niApiDlMultiPdu = false;
+    std::vector<uint8_t> m_dlTxPduBuffer;
+    uint32_t m_dlTxPduBufferOffset = 0;
+    NiDlschTxPdu m_dlTxPdus[MAX_NUM_DLSCH_PDUS];
+    uint32_t m_numDlTxPdus = 0;
+    uint32_t m_dlTxPduBytes = 0;  // payload request parameter sets of the pending PDUs
+
+    // containers reused for every MAC PDU, emptied but not deallocated after use
+    std::vector<Ptr<Packet> > m_rxPackets;
+    std::vector<Ptr<Packet> > m_txPackets;
+    std::list<Ptr<LteControlMessage> > m_rxCtrlMsgList;
+    // spare list nodes spliced into m_rxCtrlMsgList instead of allocating new ones
+    std::list<Ptr<LteControlMessage> > m_rxCtrlMsgListPool;
   };
 
 } /* namespace ns3 */
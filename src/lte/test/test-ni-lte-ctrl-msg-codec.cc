@@ -0,0 +1,351 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#include "ns3/test.h"
+
+#include "ns3/ni-lte-ctrl-msg-codec.h"
+
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * Round trip of the packet header and of each control message through the packed
+ * wire format, the written size has to match the precomputed size of the message
+ */
+class NiLteCtrlMsgCodecRoundTripTestCase : public TestCase
+{
+public:
+  NiLteCtrlMsgCodecRoundTripTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiLteCtrlMsgCodecRoundTripTestCase::NiLteCtrlMsgCodecRoundTripTestCase ()
+  : TestCase ("Round trip of the NI LTE control messages")
+{
+}
+
+void
+NiLteCtrlMsgCodecRoundTripTestCase::DoRun (void)
+{
+  std::vector<uint8_t> buffer (256, 0xff);
+
+  // packet header, SFN is carried modulo 1024
+  NiApiPacketHeader hdr;
+  hdr.niApiPacketType = NIAPI_UL_PACKET;
+  hdr.nrFrames = 1024 + 513;
+  hdr.nrSubFrames = 9;
+  hdr.cellId = 1;
+  hdr.rnti = 61;
+  hdr.numCtrlMsg = 3;
+  hdr.numPaylMsg = 1;
+  NS_TEST_ASSERT_MSG_EQ (NiLtePacketHeaderCodec::Write (buffer.data (), hdr), NiLtePacketHeaderCodec::size, "header size");
+  {
+    NiLteBitReader r (buffer.data (), NiLtePacketHeaderCodec::size);
+    NiApiPacketHeader rxHdr;
+    NiLtePacketHeaderCodec::Decode (r, &rxHdr);
+    NS_TEST_ASSERT_MSG_EQ (r.IsOverrun (), false, "header overrun");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxHdr.version, NI_LTE_CTRL_MSG__VERSION, "version");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxHdr.niApiPacketType, (uint32_t) NIAPI_UL_PACKET, "packet type");
+    NS_TEST_ASSERT_MSG_EQ (rxHdr.nrFrames, 513, "SFN");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxHdr.nrSubFrames, 9, "subframe");
+    NS_TEST_ASSERT_MSG_EQ (rxHdr.cellId, 1, "cell id");
+    NS_TEST_ASSERT_MSG_EQ (rxHdr.rnti, 61, "rnti");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxHdr.numCtrlMsg, 3, "control messages");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxHdr.numPaylMsg, 1, "payload messages");
+  }
+
+  // DL DCI
+  DlDciListElement_s dlDci;
+  dlDci.m_rnti = 0xabcd;
+  dlDci.m_rbBitmap = 0x1ffffff;
+  dlDci.m_rbShift = 0;
+  dlDci.m_resAlloc = 0;
+  dlDci.m_tbsSize.push_back (9422);
+  dlDci.m_mcs.push_back (28);
+  dlDci.m_ndi.push_back (1);
+  dlDci.m_rv.push_back (3);
+  dlDci.m_cceIndex = 0;
+  dlDci.m_aggrLevel = 8;
+  dlDci.m_precodingInfo = 0;
+  dlDci.m_format = DlDciListElement_s::TWO_A;
+  dlDci.m_tpc = 1;
+  dlDci.m_harqProcess = 7;
+  dlDci.m_dai = 0;
+  dlDci.m_vrbFormat = DlDciListElement_s::VRB_LOCALIZED;
+  dlDci.m_tbSwap = false;
+  dlDci.m_spsRelease = false;
+  dlDci.m_pdcchOrder = true;
+  dlDci.m_preambleIndex = 63;
+  dlDci.m_prachMaskIndex = 0;
+  dlDci.m_nGap = DlDciListElement_s::GAP2;
+  dlDci.m_tbsIdx = 0;
+  dlDci.m_dlPowerOffset = 0;
+  dlDci.m_pdcchPowerOffset = 0;
+  {
+    NiLteBitWriter w (buffer.data ());
+    w.Put (LteControlMessage::DL_DCI, NI_LTE_CTRL_MSG__TYPE_BITS);
+    NiLteDlDciCodec::Encode (w, dlDci);
+    NS_TEST_ASSERT_MSG_EQ (w.Finish (), NiLteDlDciCodec::size, "DL DCI size");
+
+    NiLteBitReader r (buffer.data (), NiLteDlDciCodec::size);
+    NS_TEST_ASSERT_MSG_EQ (r.Get (NI_LTE_CTRL_MSG__TYPE_BITS), (uint32_t) LteControlMessage::DL_DCI, "DL DCI type");
+    DlDciListElement_s rxDci;
+    NiLteDlDciCodec::Decode (r, &rxDci);
+    NS_TEST_ASSERT_MSG_EQ (r.Finish (), NiLteDlDciCodec::size, "DL DCI bytes read");
+    NS_TEST_ASSERT_MSG_EQ (r.IsOverrun (), false, "DL DCI overrun");
+    NS_TEST_ASSERT_MSG_EQ (rxDci.m_rnti, dlDci.m_rnti, "DL DCI rnti");
+    NS_TEST_ASSERT_MSG_EQ (rxDci.m_rbBitmap, dlDci.m_rbBitmap, "DL DCI rbBitmap");
+    NS_TEST_ASSERT_MSG_EQ (rxDci.m_tbsSize.at (0), 9422, "DL DCI tbsSize");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxDci.m_mcs.at (0), 28, "DL DCI mcs");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxDci.m_rv.at (0), 3, "DL DCI rv");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxDci.m_aggrLevel, 8, "DL DCI aggregation level");
+    NS_TEST_ASSERT_MSG_EQ (rxDci.m_format, DlDciListElement_s::TWO_A, "DL DCI format");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxDci.m_harqProcess, 7, "DL DCI harq process");
+    NS_TEST_ASSERT_MSG_EQ (rxDci.m_vrbFormat, DlDciListElement_s::VRB_LOCALIZED, "DL DCI vrb format");
+    NS_TEST_ASSERT_MSG_EQ (rxDci.m_pdcchOrder, true, "DL DCI pdcch order");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxDci.m_preambleIndex, 63, "DL DCI preamble index");
+    NS_TEST_ASSERT_MSG_EQ (rxDci.m_nGap, DlDciListElement_s::GAP2, "DL DCI ngap");
+  }
+
+  // UL DCI with negative TPC and PDCCH power offset
+  UlDciListElement_s ulDci;
+  ulDci.m_rnti = 3;
+  ulDci.m_rbStart = 99;
+  ulDci.m_rbLen = 100;
+  ulDci.m_tbSize = 7480;
+  ulDci.m_mcs = 20;
+  ulDci.m_ndi = 1;
+  ulDci.m_cceIndex = 0;
+  ulDci.m_aggrLevel = 1;
+  ulDci.m_ueTxAntennaSelection = 3;
+  ulDci.m_hopping = false;
+  ulDci.m_n2Dmrs = 0;
+  ulDci.m_tpc = -1;
+  ulDci.m_cqiRequest = true;
+  ulDci.m_ulIndex = 0;
+  ulDci.m_dai = 0;
+  ulDci.m_freqHopping = 0;
+  ulDci.m_pdcchPowerOffset = -8;
+  {
+    NiLteBitWriter w (buffer.data ());
+    w.Put (LteControlMessage::UL_DCI, NI_LTE_CTRL_MSG__TYPE_BITS);
+    NiLteUlDciCodec::Encode (w, ulDci);
+    NS_TEST_ASSERT_MSG_EQ (w.Finish (), NiLteUlDciCodec::size, "UL DCI size");
+
+    NiLteBitReader r (buffer.data (), NiLteUlDciCodec::size);
+    NS_TEST_ASSERT_MSG_EQ (r.Get (NI_LTE_CTRL_MSG__TYPE_BITS), (uint32_t) LteControlMessage::UL_DCI, "UL DCI type");
+    UlDciListElement_s rxDci;
+    NiLteUlDciCodec::Decode (r, &rxDci);
+    NS_TEST_ASSERT_MSG_EQ (r.IsOverrun (), false, "UL DCI overrun");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxDci.m_rbStart, 99, "UL DCI rbStart");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxDci.m_rbLen, 100, "UL DCI rbLen");
+    NS_TEST_ASSERT_MSG_EQ (rxDci.m_tbSize, 7480, "UL DCI tbSize");
+    NS_TEST_ASSERT_MSG_EQ ((int32_t) rxDci.m_tpc, -1, "UL DCI tpc");
+    NS_TEST_ASSERT_MSG_EQ ((int32_t) rxDci.m_pdcchPowerOffset, -8, "UL DCI pdcch power offset");
+    NS_TEST_ASSERT_MSG_EQ (rxDci.m_cqiRequest, true, "UL DCI cqi request");
+  }
+
+  // DL CQI with one wideband and 25 subband CQIs
+  CqiListElement_s cqi;
+  cqi.m_rnti = 2;
+  cqi.m_ri = 1;
+  cqi.m_cqiType = CqiListElement_s::A30;
+  cqi.m_wbCqi.push_back (15);
+  for (uint32_t i = 0; i < 25; i++)
+    {
+      HigherLayerSelected_s hl;
+      hl.m_sbCqi.push_back (i % 16);
+      cqi.m_sbMeasResult.m_higherLayerSelected.push_back (hl);
+    }
+  {
+    NiLteBitWriter w (buffer.data ());
+    w.Put (LteControlMessage::DL_CQI, NI_LTE_CTRL_MSG__TYPE_BITS);
+    NiLteDlCqiCodec::Encode (w, cqi);
+    NS_TEST_ASSERT_MSG_EQ (w.Finish (), NiLteDlCqiCodec::Size (1, 25), "DL CQI size");
+
+    NiLteBitReader r (buffer.data (), NiLteDlCqiCodec::Size (1, 25));
+    NS_TEST_ASSERT_MSG_EQ (r.Get (NI_LTE_CTRL_MSG__TYPE_BITS), (uint32_t) LteControlMessage::DL_CQI, "DL CQI type");
+    CqiListElement_s rxCqi;
+    NiLteDlCqiCodec::Decode (r, &rxCqi);
+    NS_TEST_ASSERT_MSG_EQ (r.IsOverrun (), false, "DL CQI overrun");
+    NS_TEST_ASSERT_MSG_EQ (rxCqi.m_cqiType, CqiListElement_s::A30, "DL CQI type");
+    NS_TEST_ASSERT_MSG_EQ (rxCqi.m_wbCqi.size (), 1, "DL CQI wideband count");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxCqi.m_wbCqi.at (0), 15, "DL CQI wideband");
+    NS_TEST_ASSERT_MSG_EQ (rxCqi.m_sbMeasResult.m_higherLayerSelected.size (), 25, "DL CQI subband count");
+    for (uint32_t i = 0; i < 25; i++)
+      {
+        NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxCqi.m_sbMeasResult.m_higherLayerSelected[i].m_sbCqi.at (0), i % 16, "DL CQI subband");
+      }
+  }
+
+  // BSR
+  MacCeListElement_s bsr;
+  bsr.m_rnti = 5;
+  bsr.m_macCeType = MacCeListElement_s::BSR;
+  bsr.m_macCeValue.m_phr = 0;
+  bsr.m_macCeValue.m_crnti = 0;
+  bsr.m_macCeValue.m_bufferStatus.push_back (63);
+  bsr.m_macCeValue.m_bufferStatus.push_back (0);
+  bsr.m_macCeValue.m_bufferStatus.push_back (17);
+  bsr.m_macCeValue.m_bufferStatus.push_back (1);
+  {
+    NiLteBitWriter w (buffer.data ());
+    w.Put (LteControlMessage::BSR, NI_LTE_CTRL_MSG__TYPE_BITS);
+    NiLteBsrCodec::Encode (w, bsr);
+    NS_TEST_ASSERT_MSG_EQ (w.Finish (), NiLteBsrCodec::size, "BSR size");
+
+    NiLteBitReader r (buffer.data (), NiLteBsrCodec::size);
+    NS_TEST_ASSERT_MSG_EQ (r.Get (NI_LTE_CTRL_MSG__TYPE_BITS), (uint32_t) LteControlMessage::BSR, "BSR type");
+    MacCeListElement_s rxBsr;
+    NiLteBsrCodec::Decode (r, &rxBsr);
+    NS_TEST_ASSERT_MSG_EQ (r.IsOverrun (), false, "BSR overrun");
+    NS_TEST_ASSERT_MSG_EQ (rxBsr.m_rnti, 5, "BSR rnti");
+    NS_TEST_ASSERT_MSG_EQ (rxBsr.m_macCeValue.m_bufferStatus.size (), 4, "BSR buffer status count");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxBsr.m_macCeValue.m_bufferStatus.at (0), 63, "BSR buffer status 0");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxBsr.m_macCeValue.m_bufferStatus.at (2), 17, "BSR buffer status 2");
+  }
+
+  // RAR with two responses
+  RarLteControlMessage::Rar rar;
+  rar.rapId = 42;
+  rar.rarPayload.m_rnti = 7;
+  rar.rarPayload.m_grant.m_rnti = 7;
+  rar.rarPayload.m_grant.m_rbStart = 0;
+  rar.rarPayload.m_grant.m_rbLen = 6;
+  rar.rarPayload.m_grant.m_tbSize = 56;
+  rar.rarPayload.m_grant.m_mcs = 0;
+  rar.rarPayload.m_grant.m_hopping = false;
+  rar.rarPayload.m_grant.m_tpc = -2;
+  rar.rarPayload.m_grant.m_cqiRequest = false;
+  rar.rarPayload.m_grant.m_ulDelay = true;
+  {
+    NiLteBitWriter w (buffer.data ());
+    w.Put (LteControlMessage::RAR, NI_LTE_CTRL_MSG__TYPE_BITS);
+    NiLteRarCodec::Encode (w, 3, 2);
+    NiLteRarCodec::EncodeRar (w, rar);
+    NiLteRarCodec::EncodeRar (w, rar);
+    NS_TEST_ASSERT_MSG_EQ (w.Finish (), NiLteRarCodec::Size (2), "RAR size");
+
+    NiLteBitReader r (buffer.data (), NiLteRarCodec::Size (2));
+    NS_TEST_ASSERT_MSG_EQ (r.Get (NI_LTE_CTRL_MSG__TYPE_BITS), (uint32_t) LteControlMessage::RAR, "RAR type");
+    uint16_t raRnti;
+    uint32_t numRar;
+    NiLteRarCodec::Decode (r, &raRnti, &numRar);
+    NS_TEST_ASSERT_MSG_EQ (raRnti, 3, "RAR ra-rnti");
+    NS_TEST_ASSERT_MSG_EQ (numRar, 2, "RAR count");
+    for (uint32_t i = 0; i < numRar; i++)
+      {
+        RarLteControlMessage::Rar rxRar;
+        NiLteRarCodec::DecodeRar (r, &rxRar);
+        NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxRar.rapId, 42, "RAR rapId");
+        NS_TEST_ASSERT_MSG_EQ (rxRar.rarPayload.m_rnti, 7, "RAR rnti");
+        NS_TEST_ASSERT_MSG_EQ (rxRar.rarPayload.m_grant.m_tbSize, 56, "RAR grant tbSize");
+        NS_TEST_ASSERT_MSG_EQ ((int32_t) rxRar.rarPayload.m_grant.m_tpc, -2, "RAR grant tpc");
+        NS_TEST_ASSERT_MSG_EQ (rxRar.rarPayload.m_grant.m_ulDelay, true, "RAR grant ul delay");
+      }
+    NS_TEST_ASSERT_MSG_EQ (r.IsOverrun (), false, "RAR overrun");
+  }
+
+  // packet size and tag sidecar, PDCP tag not present
+  NiLtePacketTags tags;
+  tags.rnti = 0xfffe;
+  tags.lcid = 10;
+  tags.layer = 1;
+  tags.hasRlcTag = true;
+  tags.hasPdcpTag = false;
+  tags.rlcTimestamp = 12345678901234LL;
+  tags.pdcpTimestamp = 0;
+  {
+    NiLteBitWriter w (buffer.data ());
+    NiLteDataFrameCodec::EncodePacket (w, 1500, tags);
+    NS_TEST_ASSERT_MSG_EQ (w.Finish (), NiLteDataFrameCodec::sizePerPacket, "tag sidecar size");
+
+    NiLteBitReader r (buffer.data (), NiLteDataFrameCodec::sizePerPacket);
+    NiLtePacketTags rxTags;
+    NS_TEST_ASSERT_MSG_EQ (NiLteDataFrameCodec::DecodePacket (r, &rxTags), 1500, "packet size");
+    NS_TEST_ASSERT_MSG_EQ (r.IsOverrun (), false, "tag sidecar overrun");
+    NS_TEST_ASSERT_MSG_EQ (rxTags.rnti, 0xfffe, "tag sidecar rnti");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxTags.lcid, 10, "tag sidecar lcid");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) rxTags.layer, 1, "tag sidecar layer");
+    NS_TEST_ASSERT_MSG_EQ (rxTags.hasRlcTag, true, "tag sidecar rlc tag");
+    NS_TEST_ASSERT_MSG_EQ (rxTags.hasPdcpTag, false, "tag sidecar pdcp tag");
+    NS_TEST_ASSERT_MSG_EQ (rxTags.rlcTimestamp, 12345678901234LL, "tag sidecar rlc timestamp");
+  }
+}
+
+/**
+ * A message cut short by the received MAC PDU size marks the reader as overrun
+ * instead of reading beyond the buffer
+ */
+class NiLteCtrlMsgCodecTruncationTestCase : public TestCase
+{
+public:
+  NiLteCtrlMsgCodecTruncationTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiLteCtrlMsgCodecTruncationTestCase::NiLteCtrlMsgCodecTruncationTestCase ()
+  : TestCase ("Truncated NI LTE control messages")
+{
+}
+
+void
+NiLteCtrlMsgCodecTruncationTestCase::DoRun (void)
+{
+  std::vector<uint8_t> buffer (NiLteUlDciCodec::size, 0);
+  UlDciListElement_s ulDci = UlDciListElement_s ();
+  NiLteBitWriter w (buffer.data ());
+  w.Put (LteControlMessage::UL_DCI, NI_LTE_CTRL_MSG__TYPE_BITS);
+  NiLteUlDciCodec::Encode (w, ulDci);
+  w.Finish ();
+
+  for (uint32_t numBytes = 0; numBytes <= NiLteUlDciCodec::size; numBytes++)
+    {
+      NiLteBitReader r (buffer.data (), numBytes);
+      r.Get (NI_LTE_CTRL_MSG__TYPE_BITS);
+      UlDciListElement_s rxDci;
+      NiLteUlDciCodec::Decode (r, &rxDci);
+      NS_TEST_ASSERT_MSG_EQ (r.IsOverrun (), (numBytes < NiLteUlDciCodec::size), "overrun for " << numBytes << " bytes");
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (r.Finish (), numBytes, "bytes read for " << numBytes << " bytes");
+    }
+}
+
+class NiLteCtrlMsgCodecTestSuite : public TestSuite
+{
+public:
+  NiLteCtrlMsgCodecTestSuite ();
+};
+
+NiLteCtrlMsgCodecTestSuite::NiLteCtrlMsgCodecTestSuite ()
+  : TestSuite ("ni-lte-ctrl-msg-codec", UNIT)
+{
+  AddTestCase (new NiLteCtrlMsgCodecRoundTripTestCase, TestCase::QUICK);
+  AddTestCase (new NiLteCtrlMsgCodecTruncationTestCase, TestCase::QUICK);
+}
+
+static NiLteCtrlMsgCodecTestSuite g_niLteCtrlMsgCodecTestSuite;
+
+} // namespace ns3
@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+// Replays a recording of the L1-L2 API messages, written e.g. with
+// "ni-lte-simple --niApiCaptureFile=/tmp/Capture_Lte.pcap", in place of the
+// AFW or the UDP peer. The received messages are fed back to ns-3 with the
+// original pacing or accelerated, so that the handler CPU time and deadline
+// misses of NiLtePhyInterface / NiWifiMacInterface can be measured
+// deterministically without radios. Start the replay before ns-3 for pipes
+// and shared memory, after ns-3 for UDP. The simulation time of ns-3 has to
+// be shorter than the recording, since no timing indications follow its end.
+//
+// ./waf --run "ni-capture-replay --input=/tmp/Capture_Lte.pcap --target=pipe --speed=1"
+// ./waf --run "ni-lte-simple --niApiLteEnabled=true --niApiDevMode=NIAPI_BS --simTime=2.5"
+//
+// ./waf --run "ni-capture-replay --input=/tmp/Capture_Lte.pcap --print=true"
+
+#include "ns3/core-module.h"
+
+#include <string>
+#include <cstring>
+#include <vector>
+#include <iostream>
+#include <signal.h>
+#include <unistd.h>
+
+// NI includes
+#include "ns3/ni-capture.h"
+
+using namespace ns3;
+
+static NiCaptureReplay* g_pReplay = NULL;
+static volatile sig_atomic_t g_running = 0;
+
+static void
+SignalHandler (int signal)
+{
+  if (!g_running)
+    {
+      // still waiting for ns-3 to connect
+      _exit (1);
+    }
+  g_pReplay->Stop ();
+}
+
+static void
+PrintRecords (const std::vector<NiCaptureRecord>& records)
+{
+  const uint64_t startNs = records.empty () ? 0 : records[0].timeNs;
+  for (uint64_t i = 0; i < records.size (); i++)
+    {
+      const NiCaptureRecord& record = records[i];
+      const std::string context (record.hdr.context, strnlen (record.hdr.context, sizeof (record.hdr.context)));
+      std::cout << i << " " << (record.timeNs - startNs) / 1000.0 << " us "
+                << NiCapture::GetDirectionName (record.hdr.direction) << " "
+                << NiCapture::GetChannelName (record.hdr.channel) << " "
+                << "instance " << record.hdr.instance << " "
+                << context << " "
+                << record.data.size () << " bytes" << std::endl;
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string input = "/tmp/Capture_Lte.pcap";
+  std::string target = "pipe";
+  uint32_t instance = 0;
+  std::string context = "LTE";
+  std::string udpAddr = "127.0.0.1";
+  uint32_t udpPort = 0;
+  double speed = 1.0;
+  bool print = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("input", "Capture file", input);
+  cmd.AddValue ("target", "Replay target (pipe, shm or udp)", target);
+  cmd.AddValue ("instance", "AFW instance of the replayed pipe / shm messages", instance);
+  cmd.AddValue ("context", "Transport context of the replayed UDP messages", context);
+  cmd.AddValue ("udpAddr", "IP address of ns-3 for UDP replays", udpAddr);
+  cmd.AddValue ("udpPort", "Rx port of ns-3 for UDP replays", udpPort);
+  cmd.AddValue ("speed", "Pacing relative to the recording (1 = original, 0 = as fast as possible)", speed);
+  cmd.AddValue ("print", "List the records instead of replaying them", print);
+  cmd.Parse (argc, argv);
+
+  std::vector<NiCaptureRecord> records;
+  if (NiCapture::ReadFile (input, &records) < 0)
+    {
+      return 1;
+    }
+  if (print)
+    {
+      PrintRecords (records);
+      return 0;
+    }
+
+  NiCaptureReplay replay;
+  if (target == "pipe")
+    {
+      replay.SetTarget (NI_CAPTURE_REPLAY_PIPE);
+    }
+  else if (target == "shm")
+    {
+      replay.SetTarget (NI_CAPTURE_REPLAY_SHM);
+    }
+  else if (target == "udp")
+    {
+      replay.SetTarget (NI_CAPTURE_REPLAY_UDP);
+      replay.SetUdpDestination (context, udpAddr, udpPort);
+    }
+  else
+    {
+      std::cout << "Unknown target " << target << std::endl;
+      return 1;
+    }
+  replay.SetInstanceId (instance);
+  replay.SetSpeed (speed);
+
+  g_pReplay = &replay;
+  signal (SIGINT, SignalHandler);
+  signal (SIGTERM, SignalHandler);
+  // a disconnecting ns-3 is detected by the write error instead
+  signal (SIGPIPE, SIG_IGN);
+
+  if (replay.Open () < 0)
+    {
+      replay.Close ();
+      return 1;
+    }
+  g_running = 1;
+  replay.Run (records);
+  replay.PrintStats ();
+  replay.Close ();
+
+  return 0;
+}
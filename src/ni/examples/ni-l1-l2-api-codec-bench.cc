@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+// Micro benchmark of the compile time specialized NIAPI codecs against the
+// generic SerializeStruct / DeserializeStruct byte width loop. Meaningful
+// numbers require an optimized build (./waf configure -d optimized).
+//
+// ./waf --run "ni-l1-l2-api-codec-bench --numIter=1000000 --tbsSize=100"
+
+#include "ns3/core-module.h"
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <iostream>
+
+// NI includes
+#include "ns3/ni-common-constants.h"
+#include "ns3/ni-utils.h"
+#include "ns3/ni-l1-l2-api-common-handler.h"
+#include "ns3/ni-l1-l2-api-lte-handler.h"
+#include "ns3/ni-l1-l2-api-lte-message.h"
+
+using namespace ns3;
+
+typedef std::vector<const LteElementsSpec*> SpecList;
+
+// generic path - fixed part element by element, followed by the uint8_t array
+static void
+GenericSerialize (uint32_t* p_struct, const SpecList& specs, uint32_t arrayLen, uint8_t* p_buffer, uint32_t* p_bufferOffset)
+{
+  for (uint32_t i = 0; i < specs.size (); i++)
+    {
+      SerializeStruct (p_struct, specs[i]->numEl, (uint8_t*) specs[i]->byteWidth, p_buffer, p_bufferOffset);
+      p_struct += specs[i]->numEl;
+    }
+  for (uint32_t i = 0; i < arrayLen; i++)
+    {
+      p_buffer[(*p_bufferOffset)++] = ((uint8_t*) p_struct)[i];
+    }
+}
+
+static void
+GenericDeserialize (uint32_t* p_struct, const SpecList& specs, uint32_t arrayLen, uint8_t* p_buffer, uint32_t* p_bufferOffset)
+{
+  for (uint32_t i = 0; i < specs.size (); i++)
+    {
+      DeserializeStruct (p_struct, specs[i]->numEl, (uint8_t*) specs[i]->byteWidth, p_buffer, p_bufferOffset);
+      p_struct += specs[i]->numEl;
+    }
+  for (uint32_t i = 0; i < arrayLen; i++)
+    {
+      ((uint8_t*) p_struct)[i] = p_buffer[(*p_bufferOffset)++];
+    }
+}
+
+template <typename T>
+static void
+BenchMsg (std::string name, T* p_msg, const SpecList& specs, uint32_t arrayLen,
+          int32_t (*serialize)(T*, uint8_t*, uint32_t*),
+          int32_t (*deserialize)(T*, uint8_t*, uint32_t*),
+          uint32_t numIter)
+{
+  std::vector<uint8_t> buf (NI_COMMON_CONST_MAX_PAYLOAD_SIZE);
+  T* p_out = new T;
+  uint32_t checksum = 0;
+
+  uint64_t startNs = NiUtils::GetSysTimeNs ();
+  for (uint32_t i = 0; i < numIter; i++)
+    {
+      uint32_t offset = 0;
+      GenericSerialize ((uint32_t*) p_msg, specs, arrayLen, buf.data (), &offset);
+      checksum += buf[offset - 1];
+    }
+  const double genericSerNs = (double) (NiUtils::GetSysTimeNs () - startNs) / numIter;
+
+  startNs = NiUtils::GetSysTimeNs ();
+  for (uint32_t i = 0; i < numIter; i++)
+    {
+      uint32_t offset = 0;
+      serialize (p_msg, buf.data (), &offset);
+      checksum += buf[offset - 1];
+    }
+  const double codecSerNs = (double) (NiUtils::GetSysTimeNs () - startNs) / numIter;
+
+  std::cout << name << " (" << specs.size () << " parts, " << arrayLen << " array bytes)" << std::endl;
+  std::cout << "  serialize     generic " << genericSerNs << " ns, codec " << codecSerNs << " ns"
+            << " (x" << genericSerNs / codecSerNs << ")" << std::endl;
+
+  if (deserialize != NULL)
+    {
+      startNs = NiUtils::GetSysTimeNs ();
+      for (uint32_t i = 0; i < numIter; i++)
+        {
+          uint32_t offset = 0;
+          GenericDeserialize ((uint32_t*) p_out, specs, arrayLen, buf.data (), &offset);
+          checksum += ((uint32_t*) p_out)[1];
+        }
+      const double genericDeserNs = (double) (NiUtils::GetSysTimeNs () - startNs) / numIter;
+
+      startNs = NiUtils::GetSysTimeNs ();
+      for (uint32_t i = 0; i < numIter; i++)
+        {
+          uint32_t offset = 0;
+          deserialize (p_out, buf.data (), &offset);
+          checksum += ((uint32_t*) p_out)[1];
+        }
+      const double codecDeserNs = (double) (NiUtils::GetSysTimeNs () - startNs) / numIter;
+
+      std::cout << "  deserialize   generic " << genericDeserNs << " ns, codec " << codecDeserNs << " ns"
+                << " (x" << genericDeserNs / codecDeserNs << ")" << std::endl;
+    }
+
+  // keep the loops from being optimized away
+  if (checksum == 0x12345678)
+    {
+      std::cout << std::endl;
+    }
+  delete p_out;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t numIter = 1000000;
+  uint32_t tbsSize = 100;
+
+  CommandLine cmd;
+  cmd.AddValue ("numIter", "Number of encode / decode operations per message and path", numIter);
+  cmd.AddValue ("tbsSize", "MAC PDU size in bytes of PHY_DLSCH_RX_IND", tbsSize);
+  cmd.Parse (argc, argv);
+
+  if (tbsSize > MAX_MAC_PDU_SIZE)
+    {
+      std::cout << "tbsSize exceeds MAX_MAC_PDU_SIZE" << std::endl;
+      return 1;
+    }
+
+  SpecList msgHdr;
+  msgHdr.push_back (&ns3::genMsgHdrSpec);
+  msgHdr.push_back (&ns3::subMsgHdrSpec);
+
+  PhyTimingInd phyTimingInd;
+  InitializePhyTimingInd (&phyTimingInd);
+  BenchMsg ("PhyTimingInd", &phyTimingInd, msgHdr, 0, SerializePhyTimingInd, DeserializePhyTimingInd, numIter);
+
+  SpecList dlTxConfigReq (msgHdr);
+  dlTxConfigReq.push_back (&parSetHdrSpec);
+  dlTxConfigReq.push_back (&dlschTxConfigBodySpec);
+  dlTxConfigReq.push_back (&parSetHdrSpec);
+  dlTxConfigReq.push_back (&dciTxConfigDlGrantBodySpec);
+  PhyDlTxConfigReq phyDlTxConfigReq;
+  InitializePhyDlTxConfigReq (&phyDlTxConfigReq);
+  BenchMsg ("PhyDlTxConfigReq", &phyDlTxConfigReq, dlTxConfigReq, 0, SerializePhyDlTxConfigReq, DeserializePhyDlTxConfigReq, numIter);
+
+  SpecList txPayloadReqHdr (msgHdr);
+  txPayloadReqHdr.push_back (&parSetHdrSpec);
+  txPayloadReqHdr.push_back (&macPduTxBodyHdrSpec);
+  PhyTxPayloadReqHdr phyTxPayloadReqHdr;
+  InitializePhyTxPayloadReqHdr (&phyTxPayloadReqHdr, PHY_DL_TX_PAYLOAD_REQ);
+  BenchMsg ("PhyTxPayloadReqHdr", &phyTxPayloadReqHdr, txPayloadReqHdr, 0, SerializePhyTxPayloadReqHdr, DeserializePhyTxPayloadReqHdr, numIter);
+
+  SpecList dlschRxInd (msgHdr);
+  dlschRxInd.push_back (&parSetHdrSpec);
+  dlschRxInd.push_back (&dlschMacPduRxBodySpec);
+  PhyDlschRxInd* pPhyDlschRxInd = new PhyDlschRxInd;
+  InitializePhyDlschRxInd (pPhyDlschRxInd);
+  pPhyDlschRxInd->dlschMacPduRxBody.macPduSize = tbsSize;
+  BenchMsg ("PhyDlschRxInd", pPhyDlschRxInd, dlschRxInd, tbsSize, SerializePhyDlschRxInd, DeserializePhyDlschRxInd, numIter);
+  delete pPhyDlschRxInd;
+
+  SpecList cnf (msgHdr);
+  cnf.push_back (&parSetHdrSpec);
+  cnf.push_back (&cnfBodySpec);
+  PhyCnf phyCnf;
+  InitializePhyCnf (&phyCnf);
+  BenchMsg ("PhyCnf", &phyCnf, cnf, 0, SerializePhyCnf, DeserializePhyCnf, numIter);
+
+  return 0;
+}
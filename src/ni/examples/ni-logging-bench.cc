@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+// Micro benchmark of the NiLogging call sites: cost of a call which is
+// filtered by the level mask, of an emitted call which only copies its
+// arguments into the per-thread record ring and, for reference, of
+// formatting the same message into a stringstream as the old backend did.
+// The rendered log line is checked against the stringstream formatting.
+//
+// ./waf --run "ni-logging-bench --numIter=100000 --logFile=/tmp/Log_Bench.txt"
+
+#include "ns3/core-module.h"
+
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <unistd.h>
+
+// NI includes
+#include "ns3/ni-utils.h"
+#include "ns3/ni-logging.h"
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t numIter = 100000;
+  std::string logFile = "/tmp/Log_Bench.txt";
+
+  CommandLine cmd;
+  cmd.AddValue ("numIter", "Number of log calls per measurement", numIter);
+  cmd.AddValue ("logFile", "Log file written by the logging thread", logFile);
+  cmd.Parse (argc, argv);
+
+  NiLoggingInit (LOG__LEVEL_DEBUG, logFile, NI_LOG__INSTANT_WRITE_ENABLE, NiUtils::GetThreadPrioriy ());
+
+  const std::string rnti = "rnti";
+  const uint32_t sfn = 1023;
+  const double sinr = 17.25;
+
+  // reference rendering of the messages logged below
+  std::stringstream expected;
+  expected << "check " << rnti << "=" << 61 << " sfn=" << sfn << " sinr=" << sinr << " ok=" << true;
+
+  NI_LOG_DEBUG ("check " << rnti << "=" << 61 << " sfn=" << sfn << " sinr=" << sinr << " ok=" << true);
+
+  uint64_t startNs = NiUtils::GetSysTimeNs ();
+  for (uint32_t i = 0; i < numIter; i++)
+    {
+      NI_LOG_TRACE ("suppressed " << rnti << "=" << i << " sfn=" << sfn << " sinr=" << sinr);
+    }
+  const double suppressedNs = (double) (NiUtils::GetSysTimeNs () - startNs) / numIter;
+
+  // short bursts with a pause in between, so that the logging thread drains the
+  // ring outside of the measurement also on machines with a single cpu core
+  const uint32_t burstSize = 64;
+  uint64_t emittedTotalNs = 0;
+  uint64_t emittedMinBurstNs = UINT64_MAX;
+  for (uint32_t i = 0; i < numIter; )
+    {
+      uint32_t j = 0;
+      startNs = NiUtils::GetSysTimeNs ();
+      for (; (j < burstSize) && (i < numIter); j++, i++)
+        {
+          NI_LOG_DEBUG ("emitted " << rnti << "=" << i << " sfn=" << sfn << " sinr=" << sinr);
+        }
+      const uint64_t burstNs = NiUtils::GetSysTimeNs () - startNs;
+      emittedTotalNs += burstNs;
+      if (j == burstSize)
+        {
+          emittedMinBurstNs = std::min (emittedMinBurstNs, burstNs);
+        }
+      usleep (2000);
+    }
+  const double emittedNs = (double) emittedTotalNs / numIter;
+  const double emittedBestNs = (double) emittedMinBurstNs / burstSize;
+
+  uint64_t checksum = 0;
+  startNs = NiUtils::GetSysTimeNs ();
+  for (uint32_t i = 0; i < numIter; i++)
+    {
+      std::stringstream ss;
+      ss << "emitted " << rnti << "=" << i << " sfn=" << sfn << " sinr=" << sinr;
+      checksum += ss.str ().size ();
+    }
+  const double formattedNs = (double) (NiUtils::GetSysTimeNs () - startNs) / numIter;
+
+  NiLoggingDeInit ();
+
+  std::cout << "suppressed call " << suppressedNs << " ns" << std::endl;
+  std::cout << "emitted call    " << emittedNs << " ns (best burst " << emittedBestNs << " ns)" << std::endl;
+  std::cout << "stringstream    " << formattedNs << " ns (checksum " << checksum << ")" << std::endl;
+
+  // the first record of the log file has to match the stringstream rendering
+  std::ifstream log (logFile.c_str ());
+  std::string line;
+  bool match = false;
+  while (std::getline (log, line))
+    {
+      if (line.find ("check ") != std::string::npos)
+        {
+          match = (line.size () >= expected.str ().size ())
+            && (line.compare (line.size () - expected.str ().size (), std::string::npos, expected.str ()) == 0);
+          break;
+        }
+    }
+  std::cout << "rendering " << (match ? "matches" : "DIFFERS from") << " stringstream" << std::endl;
+
+  return match ? 0 : 1;
+}
@@ -0,0 +1,257 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+
+// Multi UE downlink throughput benchmark of the L1-L2 API without PHY hardware.
+// A forked NiLtePhyEmulator takes the role of the LTE Application Framework and
+// loops each DLSCH MAC PDU back as PHY_DLSCH_RX_IND. Every TTI the benchmark
+// sends one MAC PDU per UE, either as one multi PDU config / payload request
+// pair written at once (multiPdu=true) or as one request pair per UE.
+// With numCells > 1 one emulator per AFW instance is forked and all cells are
+// driven from this process; in epoll rx mode one reactor thread serves the
+// pipes of all cells.
+//
+// ./waf --run "ni-lte-multi-ue-bench --numUes=4 --tbsSize=1000 --numTtis=5000 --multiPdu=true"
+// ./waf --run "ni-lte-multi-ue-bench --numCells=4 --rxMode=epoll"
+
+#include "ns3/core-module.h"
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <iostream>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// NI includes
+#include "ns3/ni.h"
+#include "ns3/ni-lte-phy-emulator.h"
+
+using namespace ns3;
+
+static NiLtePhyEmulator* g_pPhyEmulator = NULL;
+static std::atomic<uint64_t> g_numRxPdus[NI_PIPE_MAX_INSTANCES];
+static std::atomic<uint64_t> g_numRxBytes[NI_PIPE_MAX_INSTANCES];
+
+static void
+PeerSignalHandler (int signal)
+{
+  g_pPhyEmulator->Stop ();
+}
+
+static bool
+RxCallback (uint32_t cell, uint8_t* macPdu, uint32_t macPduSize)
+{
+  g_numRxPdus[cell].fetch_add (1, std::memory_order_relaxed);
+  g_numRxBytes[cell].fetch_add (macPduSize, std::memory_order_relaxed);
+  return true;
+}
+
+//======================================================================================
+// benchmark
+//======================================================================================
+
+int
+main (int argc, char *argv[])
+{
+  std::string transport = "pipe";
+  uint32_t numUes = 4;
+  uint32_t tbsSize = 1000;
+  uint32_t numTtis = 5000;
+  uint32_t ttiUs = 1000;
+  bool multiPdu = true;
+  uint32_t numCells = 1;
+  std::string rxMode = "polling";
+
+  CommandLine cmd;
+  cmd.AddValue ("transport", "L1-L2 API transport to benchmark (shm or pipe)", transport);
+  cmd.AddValue ("numUes", "Number of UEs served in every TTI", numUes);
+  cmd.AddValue ("tbsSize", "MAC PDU size per UE in bytes", tbsSize);
+  cmd.AddValue ("numTtis", "Number of TTIs to send", numTtis);
+  cmd.AddValue ("ttiUs", "Period of PHY timing indications in microseconds", ttiUs);
+  cmd.AddValue ("multiPdu", "Send the PDUs of a TTI as one multi PDU request pair", multiPdu);
+  cmd.AddValue ("numCells", "Number of AFW instances (cells) driven from this process", numCells);
+  cmd.AddValue ("rxMode", "Receive mode of the pipe transports (epoll or polling)", rxMode);
+  cmd.Parse (argc, argv);
+
+  const bool useShm = (transport == "shm");
+  if (!useShm && (transport != "pipe"))
+    {
+      std::cout << "Unknown transport " << transport << std::endl;
+      return 1;
+    }
+  if ((numUes == 0) || (numUes > MAX_NUM_DLSCH_PDUS))
+    {
+      std::cout << "numUes has to be within 1.." << MAX_NUM_DLSCH_PDUS << std::endl;
+      return 1;
+    }
+  if ((numCells == 0) || (numCells > NI_PIPE_MAX_INSTANCES))
+    {
+      std::cout << "numCells has to be within 1.." << NI_PIPE_MAX_INSTANCES << std::endl;
+      return 1;
+    }
+  if (16 + numUes * (PHY_TX_PAYLOAD_PAR_SET_HDR_SIZE + tbsSize) > NI_COMMON_CONST_MAX_PAYLOAD_SIZE)
+    {
+      std::cout << "numUes * tbsSize exceeds the maximum payload request size" << std::endl;
+      return 1;
+    }
+
+  // one emulator process per cell
+  std::vector<pid_t> peerPids (numCells);
+  for (uint32_t c = 0; c < numCells; c++)
+    {
+      peerPids[c] = fork ();
+      if (peerPids[c] < 0)
+        {
+          std::cout << "fork failed" << std::endl;
+          return 1;
+        }
+      if (peerPids[c] == 0)
+        {
+          NiLtePhyEmulator phyEmulator;
+          phyEmulator.SetUseShm (useShm);
+          phyEmulator.SetInstanceId (c);
+          phyEmulator.SetTtiUs (ttiUs);
+          phyEmulator.SetCellMeasPeriodTti (0);
+          g_pPhyEmulator = &phyEmulator;
+          signal (SIGTERM, PeerSignalHandler);
+          if (phyEmulator.Open () == 0)
+            {
+              phyEmulator.Run (0);
+            }
+          phyEmulator.PrintStats ();
+          phyEmulator.Close ();
+          _exit (0);
+        }
+    }
+
+  // transports in UE role, so looped back DLSCH RX indications reach the rx callback
+  std::vector<Ptr<NiPipeTransport> > niTransports (numCells);
+  const int priority = NiUtils::GetThreadPrioriy ();
+  for (uint32_t c = 0; c < numCells; c++)
+    {
+      if (useShm)
+        {
+          niTransports[c] = CreateObject<NiShmTransport> ("BENCH");
+        }
+      else
+        {
+          niTransports[c] = CreateObject<NiPipeTransport> ("BENCH");
+        }
+      niTransports[c]->SetInstanceId (c);
+      niTransports[c]->SetRxMode ((rxMode == "epoll") ? NI_PIPE_RX_MODE_EPOLL : NI_PIPE_RX_MODE_POLLING);
+      niTransports[c]->SetNiApiDevType (1);
+      niTransports[c]->SetNiApiDataEndOkCallback (MakeBoundCallback (&RxCallback, c));
+      niTransports[c]->Init (priority, priority);
+    }
+
+  // one MAC PDU and two RBGs per UE
+  std::vector<std::vector<uint8_t> > macPdus (numUes);
+  std::vector<NiDlschTxPdu> pdus (numUes);
+  for (uint32_t u = 0; u < numUes; u++)
+    {
+      macPdus[u].assign (tbsSize, (uint8_t)u);
+      pdus[u].prbAlloc = 0x3 << (2 * u);
+      pdus[u].rnti     = 1 + u;
+      pdus[u].mcs      = 10;
+      pdus[u].macPdu   = macPdus[u].data ();
+      pdus[u].tbsSize  = tbsSize;
+    }
+
+  NiPhyTimingSnapshot snapshot;
+  uint64_t lastSeqNum = 0;
+  uint32_t numTimeouts = 0;
+  uint32_t numSent = 0;
+  uint64_t sumSendNs = 0;
+  uint64_t maxSendNs = 0;
+  const uint64_t spinNs = 50000;
+  const uint64_t timeoutNs = 100000000; // 100 ms
+
+  // cell 0 paces the loop, the other cells are served with their own timing
+  for (uint32_t i = 0; i < numTtis; i++)
+    {
+      if (!niTransports[0]->WaitForTimingInd (lastSeqNum, &snapshot, spinNs, timeoutNs))
+        {
+          numTimeouts++;
+          continue;
+        }
+      lastSeqNum = snapshot.seqNum;
+
+      const uint64_t startNs = NiUtils::GetSysTimeNs ();
+      for (uint32_t c = 0; c < numCells; c++)
+        {
+          Ptr<NiPipeTransport> niTransport = niTransports[c];
+          NiPhyTimingSnapshot cellSnapshot = snapshot;
+          if (c > 0)
+            {
+              niTransport->GetTimingSnapshot (&cellSnapshot);
+            }
+          if (multiPdu)
+            {
+              niTransport->CreateAndSendDlTxReqMsgs (cellSnapshot.sfn, cellSnapshot.tti, pdus.data (), numUes);
+            }
+          else
+            {
+              for (uint32_t u = 0; u < numUes; u++)
+                {
+                  niTransport->CreateAndSendDlTxConfigReqMsg (cellSnapshot.sfn, cellSnapshot.tti, pdus[u].prbAlloc, pdus[u].rnti, pdus[u].mcs, tbsSize);
+                  niTransport->CreateAndSendDlTxPayloadReqMsg (cellSnapshot.sfn, cellSnapshot.tti, pdus[u].macPdu, tbsSize);
+                }
+            }
+        }
+      const uint64_t sendNs = NiUtils::GetSysTimeNs () - startNs;
+      sumSendNs += sendNs;
+      if (sendNs > maxSendNs) maxSendNs = sendNs;
+      numSent++;
+    }
+
+  // let the last loopback indications arrive
+  usleep (10 * ttiUs);
+  for (uint32_t c = 0; c < numCells; c++)
+    {
+      niTransports[c]->DeInit ();
+      kill (peerPids[c], SIGTERM);
+      waitpid (peerPids[c], NULL, 0);
+    }
+
+  const double durationS = numSent * (ttiUs / 1e6);
+  std::cout << "-------- L1-L2 API multi UE downlink (" << transport << ", " << (multiPdu ? "multi PDU" : "per UE") << " requests) --------" << std::endl;
+  std::cout << "TTIs         = " << numSent << " (timeouts " << numTimeouts << ")" << std::endl;
+  std::cout << "Cells        = " << numCells << " (" << rxMode << " rx)" << std::endl;
+  std::cout << "UEs          = " << numUes << " per cell (tbsSize " << tbsSize << " bytes)" << std::endl;
+  std::cout << "writes/TTI   = " << numCells * (multiPdu ? 1 : 2 * numUes) << std::endl;
+  if (numSent > 0)
+    {
+      std::cout << "send/TTI     = avg " << (sumSendNs / numSent) / 1000.0 << " us, max " << maxSendNs / 1000.0 << " us" << std::endl;
+    }
+  for (uint32_t c = 0; c < numCells; c++)
+    {
+      std::cout << "Cell " << c << "       = PDUs " << numSent * numUes << " sent, " << g_numRxPdus[c].load () << " received";
+      if (numSent > 0)
+        {
+          std::cout << ", DL throughput " << (g_numRxBytes[c].load () * 8 / durationS / 1e6) << " Mbit/s";
+        }
+      std::cout << std::endl;
+    }
+
+  return 0;
+}
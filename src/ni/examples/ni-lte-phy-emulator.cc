@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+// Software PHY emulator standing in for the LTE Application Framework.
+// Start it before ni-lte-simple with the L1-L2 API enabled, e.g.
+//
+// ./waf --run "ni-lte-phy-emulator --transport=pipe --jitterUs=50 --sinrDb=20"
+// ./waf --run "ni-lte-simple --niApiLteEnabled=true --niApiDevMode=NIAPI_BS --niApiLteDlMultiPdu=true"
+//
+// The emulator prints throughput and TTI deadline misses periodically and
+// a summary when it is stopped with Ctrl-C or the duration expired.
+
+#include "ns3/core-module.h"
+
+#include <string>
+#include <iostream>
+#include <signal.h>
+#include <unistd.h>
+
+// NI includes
+#include "ns3/ni-lte-phy-emulator.h"
+
+using namespace ns3;
+
+static NiLtePhyEmulator* g_pPhyEmulator = NULL;
+static volatile sig_atomic_t g_running = 0;
+
+static void
+SignalHandler (int signal)
+{
+  if (!g_running)
+    {
+      // still waiting for the L2 to connect
+      _exit (1);
+    }
+  g_pPhyEmulator->Stop ();
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string transport = "pipe";
+  uint32_t instance = 0;
+  uint32_t ttiUs = 1000;
+  uint32_t jitterUs = 0;
+  bool loopback = true;
+  uint32_t cellId = 0;
+  double sinrDb = 30.0;
+  uint32_t numSubbandSinr = 13;
+  uint32_t cellMeasPeriodTti = 5;
+  double durationS = 0;
+  uint32_t reportIntervalS = 1;
+  uint32_t seed = 1;
+
+  CommandLine cmd;
+  cmd.AddValue ("transport", "L1-L2 API transport (pipe or shm)", transport);
+  cmd.AddValue ("instance", "Index of the emulated AFW instance, selects the pipe / ring names", instance);
+  cmd.AddValue ("ttiUs", "Period of PHY timing indications in microseconds", ttiUs);
+  cmd.AddValue ("jitterUs", "Maximum jitter of PHY timing indications in microseconds", jitterUs);
+  cmd.AddValue ("loopback", "Loop TX payloads back as DLSCH / ULSCH RX indications", loopback);
+  cmd.AddValue ("cellId", "Cell ID reported in cell measurement indications", cellId);
+  cmd.AddValue ("sinrDb", "Wideband and subband SINR of cell measurement indications in dB", sinrDb);
+  cmd.AddValue ("numSubbandSinr", "Number of subband SINR values of cell measurement indications", numSubbandSinr);
+  cmd.AddValue ("cellMeasPeriodTti", "Period of cell measurement indications in TTIs (0 = off)", cellMeasPeriodTti);
+  cmd.AddValue ("durationS", "Run time in seconds (0 = until Ctrl-C)", durationS);
+  cmd.AddValue ("reportIntervalS", "Interval of throughput reports in seconds (0 = off)", reportIntervalS);
+  cmd.AddValue ("seed", "Seed of the TTI jitter", seed);
+  cmd.Parse (argc, argv);
+
+  if ((transport != "pipe") && (transport != "shm"))
+    {
+      std::cout << "Unknown transport " << transport << std::endl;
+      return 1;
+    }
+
+  NiLtePhyEmulator phyEmulator;
+  phyEmulator.SetUseShm (transport == "shm");
+  phyEmulator.SetInstanceId (instance);
+  phyEmulator.SetTtiUs (ttiUs);
+  phyEmulator.SetTtiJitterUs (jitterUs);
+  phyEmulator.SetLoopback (loopback);
+  phyEmulator.SetCellId (cellId);
+  phyEmulator.SetSinrDb (sinrDb, numSubbandSinr);
+  phyEmulator.SetCellMeasPeriodTti (cellMeasPeriodTti);
+  phyEmulator.SetReportIntervalS (reportIntervalS);
+  phyEmulator.SetSeed (seed);
+
+  g_pPhyEmulator = &phyEmulator;
+  signal (SIGINT, SignalHandler);
+  signal (SIGTERM, SignalHandler);
+  // a disconnecting L2 is detected by the write error instead
+  signal (SIGPIPE, SIG_IGN);
+
+  if (phyEmulator.Open () < 0)
+    {
+      phyEmulator.Close ();
+      return 1;
+    }
+  g_running = 1;
+  phyEmulator.Run (durationS);
+  phyEmulator.PrintStats ();
+  phyEmulator.Close ();
+
+  return 0;
+}
@@ -88,8 +88,22 @@ main (int argc, char *argv[])
 
    // Activate logging using NI API log files
    bool niApiEnableLogging = true;
+   // placement of the NI threads, see NiUtils::SetThreadTopology
+   std::string niThreadTopology = "";
+   // lock and prefault memory for the real-time loop, see NiRtMemoryInit
+   bool niApiRtMemory = false;
    // Set log file names
    std::string LogFileName;
+   // Write binary timing traces of the real-time loop, decoded with ni-trace-decode
+   bool niApiEnableTrace = false;
+   // Size of the preallocated trace file in records (64 bytes each)
+   uint32_t niApiTraceMaxRecords = NI_TRACE__DEFAULT_MAX_RECORDS;
+   // Keep the latest niApiTraceMaxRecords records instead of the first ones
+   bool niApiTraceWrap = false;
+   // Record all L1-L2 API messages to this file, replayed with ni-capture-replay (empty = disabled)
+   std::string niApiCaptureFile = "";
+   // Maximum size of the capture file in MB
+   uint32_t niApiCaptureMaxMB = 256;
    // Enable remote control engine
    bool niRemoteControlEnable = false;
    // Enable TapBridge as data source and data sink
@@ -106,6 +120,13 @@ main (int argc, char *argv[])
   bool niApiLteEnabled = false;
   // Activate NIAPI loopback mode for LTE
   bool niApiLteLoopbackEnabled = false; // true UDP, false Pipes
+  // Receive mode of the pipe transport: NIAPI_PIPE_RX_POLLING or NIAPI_PIPE_RX_EPOLL
+  std::string niApiLtePipeRxMode = "NIAPI_PIPE_RX_POLLING";
+  std::string niApiLteTransportType = "NIAPI_TRANSPORT_PIPE";
+  // Send the DL MAC PDUs of all UEs of a TTI as one config / payload request pair
+  bool niApiLteDlMultiPdu = false;
+  // AFW instance (api_transport_<instance>-*) driven by this process
+  uint32_t niApiLteInstanceId = 0;
   // sinr value in db used for cqi calculation for the ni phy
   double niChSinrValueDb = 10;
 
@@ -118,9 +139,21 @@ main (int argc, char *argv[])
   cmd.AddValue("transmTime", "Time in seconds when the packet transmission should be scheduled", transmTime);
   cmd.AddValue("niApiEnableTapBridge", "Enable/disable TapBridge as external data source/sink", niApiEnableTapBridge);
   cmd.AddValue("niApiEnableLogging", "Set whether to enable NIAPI_DebugLogs", niApiEnableLogging);
+  cmd.AddValue("niThreadTopology", "CPU set, policy and priority of NI threads, e.g. \"PhyTimingInd=2:fifo:90;NS3=1\"", niThreadTopology);
+  cmd.AddValue("niApiRtMemory", "Lock and prefault the process memory for the real-time loop", niApiRtMemory);
+  cmd.AddValue("niApiEnableTrace", "Set whether to write binary timing traces", niApiEnableTrace);
+  cmd.AddValue("niApiTraceMaxRecords", "Number of records preallocated in the trace file", niApiTraceMaxRecords);
+  cmd.AddValue("niApiTraceWrap", "Keep the latest records once the trace file is full", niApiTraceWrap);
+  cmd.AddValue("niApiCaptureFile", "Record all L1-L2 API messages to this file (empty = disabled)", niApiCaptureFile);
+  cmd.AddValue("niApiCaptureMaxMB", "Maximum size of the capture file in MB", niApiCaptureMaxMB);
   cmd.AddValue("niApiDevMode", "Set whether the simulation should run as BS or Terminal", niApiDevMode);
   cmd.AddValue("niApiLteEnabled", "Enable NI API for LTE", niApiLteEnabled);
   cmd.AddValue("niApiLteLoopbackEnabled", "Enable/disable UDP loopback mode for LTE NI API", niApiLteLoopbackEnabled);
+  cmd.AddValue("niApiLtePipeRxMode", "Receive mode of the LTE NI API pipe transport (NIAPI_PIPE_RX_POLLING or NIAPI_PIPE_RX_EPOLL)", niApiLtePipeRxMode);
+  cmd.AddValue("niApiLteTransportType", "Transport of the LTE NI API (NIAPI_TRANSPORT_PIPE or NIAPI_TRANSPORT_SHM)", niApiLteTransportType);
+  cmd.AddValue("niApiLteDlMultiPdu", "Send the DL MAC PDUs of all UEs of a TTI as one config / payload request pair", niApiLteDlMultiPdu);
+  cmd.AddValue("niApiLteInstanceId", "AFW instance of the LTE NI API pipes / rings", niApiLteInstanceId);
+  cmd.AddValue("niRemoteControlEnable", "Enable/disable Remote Control engine", niRemoteControlEnable);
   cmd.Parse(argc, argv);
 
   // Activate the ns-3 real time simulator
@@ -190,6 +223,14 @@ main (int argc, char *argv[])
 
   // adding thread ID of main NS3 thread for possible troubleshooting
   NiUtils::AddThreadInfo(pthread_self(), "NS3 main thread");
+  if (!niThreadTopology.empty())
+    {
+      NiUtils::SetThreadTopology(niThreadTopology);
+    }
+  if (niApiRtMemory)
+    {
+      NiRtMemoryInit(NI_RT_MEMORY__DEFAULT_HEAP_PREFAULT_BYTES, NI_RT_MEMORY__DEFAULT_STACK_PREFAULT_BYTES);
+    }
 
   // install signal handlers in order to print debug information to std::out in case of an error
   NiUtils::InstallSignalHandler();
@@ -199,6 +240,14 @@ main (int argc, char *argv[])
       LogFileName = "/tmp/Log_Lte_" + simStationType + ".txt";
       NiLoggingInit(LOG__LEVEL_WARN | LOG__CONSOLE_DEBUG, LogFileName, NI_LOG__INSTANT_WRITE_DISABLE, niLoggingPriority);
   }
+  if (niApiEnableTrace)
+    {
+      NiTraceInit("/tmp/Trace_Lte_" + simStationType + ".bin", niApiTraceMaxRecords, niApiTraceWrap);
+    }
+  if (!niApiCaptureFile.empty ())
+    {
+      NiCaptureInit(niApiCaptureFile, (uint64_t) niApiCaptureMaxMB << 20);
+    }
 
   // Start RemoteControlEngine
   // use globally defined instance in RemoteControlÈngine class
@@ -268,6 +317,11 @@ main (int argc, char *argv[])
 
    // Set the device type mode for the ni phy applied for this ns-3 instance
    Config::SetDefault ("ns3::NiLtePhyInterface::niApiDevType", StringValue (niApiLteDevMode));
+   // Set the receive mode of the pipe transport - polling or epoll based
+   Config::SetDefault ("ns3::NiLtePhyInterface::niApiPipeRxMode", StringValue (niApiLtePipeRxMode));
+   Config::SetDefault ("ns3::NiLtePhyInterface::niApiTransportType", StringValue (niApiLteTransportType));
+   Config::SetDefault ("ns3::NiLtePhyInterface::niApiInstanceId", UintegerValue (niApiLteInstanceId));
+   Config::SetDefault ("ns3::NiLtePhyInterface::niApiDlMultiPdu", BooleanValue (niApiLteDlMultiPdu));
    // Enable / disable the use of ni api for the ni phy
    Config::SetDefault ("ns3::NiLtePhyInterface::enableNiApi", BooleanValue (niApiLteEnabled));
    // Enable / disable the use of ni api udp loopback mode for the ni phy
@@ -475,6 +529,14 @@ main (int argc, char *argv[])
      {
        NiLoggingDeInit();
      }
+   if (niApiEnableTrace)
+     {
+       NiTraceDeInit();
+     }
+   if (!niApiCaptureFile.empty ())
+     {
+       NiCaptureDeInit();
+     }
    // Close RemoteControlEngine
    if (niRemoteControlEnable)
      {
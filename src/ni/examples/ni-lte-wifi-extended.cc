@@ -280,8 +280,18 @@ int main (int argc, char *argv[]){
 
   // Activate logging using NI API log files
   bool niApiEnableLogging = true;
+  // placement of the NI threads, see NiUtils::SetThreadTopology
+  std::string niThreadTopology = "";
+  // lock and prefault memory for the real-time loop, see NiRtMemoryInit
+  bool niApiRtMemory = false;
   // Set log file names
   std::string LogFileName;
+  // Write binary timing traces of the real-time loop, decoded with ni-trace-decode
+  bool niApiEnableTrace = false;
+  // Size of the preallocated trace file in records (64 bytes each)
+  uint32_t niApiTraceMaxRecords = NI_TRACE__DEFAULT_MAX_RECORDS;
+  // Keep the latest niApiTraceMaxRecords records instead of the first ones
+  bool niApiTraceWrap = false;
   // Enable remote control engine
   bool niRemoteControlEnable = false;
   // Enable TapBridge as data source and data sink
@@ -362,6 +372,11 @@ int main (int argc, char *argv[]){
   cmd.AddValue("niApiEnableTapBridge", "Enable/disable TapBridge as external data source/sink", niApiEnableTapBridge);
   cmd.AddValue("niRemoteControlEnable", "Enable/disable Remote Control engine", niRemoteControlEnable);
   cmd.AddValue("niApiEnableLogging", "Set whether to enable NIAPI_DebugLogs", niApiEnableLogging);
+  cmd.AddValue("niThreadTopology", "CPU set, policy and priority of NI threads, e.g. \"PhyTimingInd=2:fifo:90;NS3=1\"", niThreadTopology);
+  cmd.AddValue("niApiRtMemory", "Lock and prefault the process memory for the real-time loop", niApiRtMemory);
+  cmd.AddValue("niApiEnableTrace", "Set whether to write binary timing traces", niApiEnableTrace);
+  cmd.AddValue("niApiTraceMaxRecords", "Number of records preallocated in the trace file", niApiTraceMaxRecords);
+  cmd.AddValue("niApiTraceWrap", "Keep the latest records once the trace file is full", niApiTraceWrap);
   cmd.AddValue("niApiDevMode", "Set whether the simulation should run as BS or Terminal", niApiDevMode);
   cmd.AddValue("niApiWifiEnabled", "Enable NI API for WiFi", niApiWifiEnabled);
   cmd.AddValue("niApiWifiLoopbackEnabled", "Enable/disable UDP loopback mode for WiFi NI API", niApiWifiLoopbackEnabled);
@@ -483,6 +498,14 @@ int main (int argc, char *argv[]){
 
   // adding thread ID of main NS3 thread for possible troubleshooting
   NiUtils::AddThreadInfo(pthread_self(), "NS3 main thread");
+  if (!niThreadTopology.empty())
+    {
+      NiUtils::SetThreadTopology(niThreadTopology);
+    }
+  if (niApiRtMemory)
+    {
+      NiRtMemoryInit(NI_RT_MEMORY__DEFAULT_HEAP_PREFAULT_BYTES, NI_RT_MEMORY__DEFAULT_STACK_PREFAULT_BYTES);
+    }
 
   // install signal handlers in order to print debug information to std::out in case of an error
   NiUtils::InstallSignalHandler();
@@ -492,6 +515,10 @@ int main (int argc, char *argv[]){
       LogFileName = "/tmp/Log_LteWifi_" + simStationType + ".txt";
       NiLoggingInit(LOG__LEVEL_WARN | LOG__CONSOLE_DEBUG, LogFileName, NI_LOG__INSTANT_WRITE_DISABLE, niLoggingPriority);
   }
+  if (niApiEnableTrace)
+    {
+      NiTraceInit("/tmp/Trace_LteWifi_" + simStationType + ".bin", niApiTraceMaxRecords, niApiTraceWrap);
+    }
   // Start RemoteControlEngine
   // use globally defined instance in RemoteControlÈngine class
   if (niRemoteControlEnable)
@@ -966,6 +993,10 @@ int main (int argc, char *argv[]){
     {
       NiLoggingDeInit();
     }
+  if (niApiEnableTrace)
+    {
+      NiTraceDeInit();
+    }
   // Close RemoteControlEngine
   if (niRemoteControlEnable)
     {
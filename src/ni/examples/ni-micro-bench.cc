@@ -0,0 +1,655 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+// Micro benchmark suite of the hot paths of the NI module: NIAPI message
+// codecs, TBS lookup, control and data frame codecs of NiLtePhyInterface,
+// NiLogging call sites and a NiUdpTransport loopback round trip. Each
+// benchmark runs numRep repetitions of numIter operations after a warm up;
+// the time per operation of all repetitions is written as JSON, so that
+// results of different releases can be compared. Meaningful numbers require
+// an optimized build (./waf configure -d optimized).
+//
+// ./waf --run "ni-micro-bench --output=/tmp/ni-micro-bench.json"
+// ./waf --run "ni-micro-bench --filter=phy/ --numIter=10000"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/lte-module.h"
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <ctime>
+#include <unistd.h>
+#include <sched.h>
+
+// NI includes
+#include "ns3/ni-common-constants.h"
+#include "ns3/ni-utils.h"
+#include "ns3/ni-logging.h"
+#include "ns3/ni-udp-transport.h"
+#include "ns3/ni-l1-l2-api-lte-handler.h"
+#include "ns3/ni-l1-l2-api-lte-message.h"
+#include "ns3/ni-l1-l2-api-lte-tables.h"
+#include "ns3/ni-lte-phy-interface.h"
+
+using namespace ns3;
+
+// time per operation of all repetitions of one benchmark
+struct BenchResult
+{
+  std::string group;
+  std::string name;
+  uint64_t numIter;
+  uint64_t bytesPerOp;
+  std::vector<double> repNs;
+};
+
+static std::vector<BenchResult> g_results;
+static std::string g_filter = "";
+static uint32_t g_numRep = 5;
+// results of the operations, keeps the loops from being optimized away
+static volatile uint64_t g_sink = 0;
+
+static bool
+IsSelected (const std::string& group, const std::string& name)
+{
+  return g_filter.empty () || ((group + "/" + name).find (g_filter) != std::string::npos);
+}
+
+static void
+AddResult (const std::string& group, const std::string& name, uint64_t numIter, uint64_t bytesPerOp, const std::vector<double>& repNs)
+{
+  BenchResult result;
+  result.group = group;
+  result.name = name;
+  result.numIter = numIter;
+  result.bytesPerOp = bytesPerOp;
+  result.repNs = repNs;
+  g_results.push_back (result);
+
+  double sumNs = 0;
+  for (uint32_t i = 0; i < repNs.size (); i++)
+    {
+      sumNs += repNs[i];
+    }
+  std::cout << std::left << std::setw (48) << (group + "/" + name) << std::right << std::fixed << std::setprecision (1)
+            << " mean " << std::setw (10) << sumNs / repNs.size () << " ns"
+            << "  min " << std::setw (10) << *std::min_element (repNs.begin (), repNs.end ()) << " ns" << std::endl;
+}
+
+// op (i) performs operation i and returns a value depending on its result
+template <typename F>
+static void
+Bench (const std::string& group, const std::string& name, uint64_t numIter, uint64_t bytesPerOp, F op)
+{
+  if (!IsSelected (group, name) || (numIter == 0))
+    {
+      return;
+    }
+  uint64_t checksum = 0;
+  for (uint64_t i = 0; i < numIter / 10 + 1; i++)
+    {
+      checksum += op (i);
+    }
+  std::vector<double> repNs;
+  for (uint32_t rep = 0; rep < g_numRep; rep++)
+    {
+      const uint64_t startNs = NiUtils::GetSysTimeNs ();
+      for (uint64_t i = 0; i < numIter; i++)
+        {
+          checksum += op (i);
+        }
+      repNs.push_back ((double) (NiUtils::GetSysTimeNs () - startNs) / numIter);
+    }
+  g_sink += checksum;
+  AddResult (group, name, numIter, bytesPerOp, repNs);
+}
+
+//=============================================================================
+// NIAPI message codecs and TBS table
+
+template <typename T>
+static void
+BenchMsgCodec (const std::string& name, T* p_msg,
+               int32_t (*serialize)(T*, uint8_t*, uint32_t*),
+               int32_t (*deserialize)(T*, uint8_t*, uint32_t*),
+               uint64_t numIter)
+{
+  std::vector<uint8_t> buf (NI_COMMON_CONST_MAX_PAYLOAD_SIZE);
+  uint32_t msgSize = 0;
+  serialize (p_msg, buf.data (), &msgSize);
+
+  Bench ("codec", "Serialize" + name, numIter, msgSize, [&] (uint64_t i) -> uint64_t
+    {
+      uint32_t offset = 0;
+      serialize (p_msg, buf.data (), &offset);
+      return buf[offset - 1];
+    });
+
+  if (deserialize != NULL)
+    {
+      T* p_out = new T;
+      Bench ("codec", "Deserialize" + name, numIter, msgSize, [&] (uint64_t i) -> uint64_t
+        {
+          uint32_t offset = 0;
+          deserialize (p_out, buf.data (), &offset);
+          return offset;
+        });
+      delete p_out;
+    }
+}
+
+static void
+BenchCodecs (uint64_t numIter, uint32_t tbsSize)
+{
+  PhyTimingInd phyTimingInd;
+  InitializePhyTimingInd (&phyTimingInd);
+  BenchMsgCodec ("PhyTimingInd", &phyTimingInd, SerializePhyTimingInd, DeserializePhyTimingInd, numIter);
+
+  PhyDlTxConfigReq phyDlTxConfigReq;
+  InitializePhyDlTxConfigReq (&phyDlTxConfigReq);
+  BenchMsgCodec ("PhyDlTxConfigReq", &phyDlTxConfigReq, SerializePhyDlTxConfigReq, DeserializePhyDlTxConfigReq, numIter);
+  BenchMsgCodec ("PhyDlTxConfigReqParSets", &phyDlTxConfigReq, SerializePhyDlTxConfigReqParSets, DeserializePhyDlTxConfigReqParSets, numIter);
+
+  PhyTxPayloadReqHdr phyTxPayloadReqHdr;
+  InitializePhyTxPayloadReqHdr (&phyTxPayloadReqHdr, PHY_DL_TX_PAYLOAD_REQ);
+  phyTxPayloadReqHdr.macPduTxBodyHdr.macPduSize = tbsSize;
+  BenchMsgCodec ("PhyTxPayloadReqHdr", &phyTxPayloadReqHdr, SerializePhyTxPayloadReqHdr, DeserializePhyTxPayloadReqHdr, numIter);
+  BenchMsgCodec ("PhyTxPayloadReqParSetHdr", &phyTxPayloadReqHdr, SerializePhyTxPayloadReqParSetHdr, DeserializePhyTxPayloadReqParSetHdr, numIter);
+
+  // the payload requests are only sent by ns-3
+  PhyDlTxPayloadReq* pPhyDlTxPayloadReq = new PhyDlTxPayloadReq;
+  InitializePhyDlTxPayloadReq (pPhyDlTxPayloadReq);
+  pPhyDlTxPayloadReq->dlschMacPduTxBody.macPduSize = tbsSize;
+  BenchMsgCodec<PhyDlTxPayloadReq> ("PhyDlTxPayloadReq", pPhyDlTxPayloadReq, SerializePhyDlTxPayloadReq, NULL, numIter);
+  delete pPhyDlTxPayloadReq;
+
+  PhyUlTxPayloadReq* pPhyUlTxPayloadReq = new PhyUlTxPayloadReq;
+  InitializePhyUlTxPayloadReq (pPhyUlTxPayloadReq);
+  pPhyUlTxPayloadReq->ulschMacPduTxBody.macPduSize = tbsSize;
+  BenchMsgCodec<PhyUlTxPayloadReq> ("PhyUlTxPayloadReq", pPhyUlTxPayloadReq, SerializePhyUlTxPayloadReq, NULL, numIter);
+  delete pPhyUlTxPayloadReq;
+
+  PhyDlschRxInd* pPhyDlschRxInd = new PhyDlschRxInd;
+  InitializePhyDlschRxInd (pPhyDlschRxInd);
+  pPhyDlschRxInd->dlschMacPduRxBody.macPduSize = tbsSize;
+  BenchMsgCodec ("PhyDlschRxInd", pPhyDlschRxInd, SerializePhyDlschRxInd, DeserializePhyDlschRxInd, numIter);
+  delete pPhyDlschRxInd;
+
+  PhyUlschRxInd* pPhyUlschRxInd = new PhyUlschRxInd;
+  InitializePhyUlschRxInd (pPhyUlschRxInd);
+  pPhyUlschRxInd->ulschMacPduRxBody.macPduSize = tbsSize;
+  BenchMsgCodec ("PhyUlschRxInd", pPhyUlschRxInd, SerializePhyUlschRxInd, DeserializePhyUlschRxInd, numIter);
+  delete pPhyUlschRxInd;
+
+  PhyCellMeasInd phyCellMeasInd;
+  InitializePhyCellMeasInd (&phyCellMeasInd);
+  phyCellMeasInd.cellMeasReportBody.numSubbandSinr = MAX_NUM_SUBBAND_SINR;
+  BenchMsgCodec ("PhyCellMeasInd", &phyCellMeasInd, SerializePhyCellMeasurementInd, DeserializePhyCellMeasurementInd, numIter);
+
+  PhyCnf phyCnf;
+  InitializePhyCnf (&phyCnf);
+  BenchMsgCodec ("PhyCnf", &phyCnf, SerializePhyCnf, DeserializePhyCnf, numIter);
+
+  // allocations of 1 .. 25 resource block groups
+  const uint32_t prbAllocations[8] = {0x1, 0x3, 0xF, 0xFF, 0x1FFF, 0xFFFFF, 0x1FFFFFF, 0x1555555};
+  Bench ("tables", "GetTbs", numIter, 0, [&] (uint64_t i) -> uint64_t
+    {
+      uint32_t tbs = 0;
+      GetTbs (i % 29, prbAllocations[i & 7], &tbs);
+      return tbs;
+    });
+}
+
+//=============================================================================
+// control and data frame codecs of NiLtePhyInterface
+
+namespace ns3 {
+
+class NiLtePhyInterfaceBench
+{
+public:
+  NiLtePhyInterfaceBench (uint32_t numPackets, uint32_t packetSize);
+
+  void Run (uint64_t numIter);
+
+private:
+  void BenchCtrlFrame (const std::string& name, Ptr<LteControlMessage> msg, bool downlink, uint64_t numIter);
+  void ReleaseRxFrame (void);
+
+  Ptr<NiLtePhyInterface> m_phy;
+  Ptr<PacketBurst> m_emptyBurst;
+  Ptr<PacketBurst> m_dataBurst;
+  std::vector<uint8_t> m_buf;
+};
+
+NiLtePhyInterfaceBench::NiLtePhyInterfaceBench (uint32_t numPackets, uint32_t packetSize)
+  : m_phy (CreateObject<NiLtePhyInterface> (NS3_ENB)),
+    m_emptyBurst (Create<PacketBurst> ()),
+    m_dataBurst (Create<PacketBurst> ()),
+    m_buf (NI_COMMON_CONST_MAX_PAYLOAD_SIZE)
+{
+  // packets of one bearer with the tags of the RLC and PDCP layers
+  for (uint32_t i = 0; i < numPackets; i++)
+    {
+      Ptr<Packet> packet = Create<Packet> (packetSize);
+      packet->AddPacketTag (LteRadioBearerTag (1, 3, 0));
+      packet->AddPacketTag (RlcTag (MilliSeconds (i)));
+      packet->AddPacketTag (PdcpTag (MilliSeconds (i)));
+      m_dataBurst->AddPacket (packet);
+    }
+}
+
+// releases the decoded packets and messages the same way as NiStartRxCtrlDataFrame
+void
+NiLtePhyInterfaceBench::ReleaseRxFrame (void)
+{
+  m_phy->m_rxPackets.clear ();
+  for (std::list<Ptr<LteControlMessage> >::iterator it = m_phy->m_rxCtrlMsgList.begin (); it != m_phy->m_rxCtrlMsgList.end (); ++it)
+    {
+      *it = 0;
+    }
+  m_phy->m_rxCtrlMsgListPool.splice (m_phy->m_rxCtrlMsgListPool.end (), m_phy->m_rxCtrlMsgList);
+}
+
+void
+NiLtePhyInterfaceBench::BenchCtrlFrame (const std::string& name, Ptr<LteControlMessage> msg, bool downlink, uint64_t numIter)
+{
+  std::list<Ptr<LteControlMessage> > ctrlMsgList;
+  ctrlMsgList.push_back (msg);
+  std::map<uint16_t, uint16_t> rntiMap;
+
+  // DL control messages are sent either to all UEs (broadcast) or to the RNTI of a DCI
+  const bool broadcast = (msg->GetMessageType () == LteControlMessage::RAR);
+  auto encode = [&] (uint64_t i) -> uint64_t
+    {
+      uint32_t offset = 0;
+      uint32_t controlMessageCnt = 0;
+      if (!downlink)
+        {
+          m_phy->NiStartTxUlCtrlFrame (m_emptyBurst, ctrlMsgList, m_buf.data (), &offset, controlMessageCnt);
+        }
+      else if (broadcast)
+        {
+          m_phy->NiStartTxDlCtrlFrameBc (m_emptyBurst, ctrlMsgList, m_buf.data (), &offset, controlMessageCnt, rntiMap);
+        }
+      else
+        {
+          m_phy->NiStartTxDlCtrlFrameUc (m_emptyBurst, ctrlMsgList, m_buf.data (), &offset, controlMessageCnt, 1);
+        }
+      return offset;
+    };
+  const uint32_t frameSize = encode (0);
+  Bench ("phy", "Encode" + name, numIter, frameSize, encode);
+
+  encode (0);
+  Bench ("phy", "Decode" + name, numIter, frameSize, [&] (uint64_t i) -> uint64_t
+    {
+      uint32_t offset = 0;
+      if (downlink)
+        {
+          m_phy->NiStartRxDlCtrlFrame (m_phy->m_rxPackets, m_phy->m_rxCtrlMsgList, m_buf.data (), &offset, frameSize);
+        }
+      else
+        {
+          m_phy->NiStartRxUlCtrlFrame (m_phy->m_rxPackets, m_phy->m_rxCtrlMsgList, m_buf.data (), &offset, frameSize);
+        }
+      ReleaseRxFrame ();
+      return offset;
+    });
+}
+
+void
+NiLtePhyInterfaceBench::Run (uint64_t numIter)
+{
+  // value initialized, all fields not set below are zero
+  DlDciListElement_s dci = DlDciListElement_s ();
+  dci.m_rnti = 1;
+  dci.m_rbBitmap = 0x1FFF;
+  dci.m_tbsSize.push_back (100);
+  dci.m_mcs.push_back (20);
+  dci.m_ndi.push_back (1);
+  dci.m_rv.push_back (0);
+  dci.m_format = DlDciListElement_s::ONE;
+  dci.m_vrbFormat = DlDciListElement_s::VRB_LOCALIZED;
+  Ptr<DlDciLteControlMessage> dlDci = Create<DlDciLteControlMessage> ();
+  dlDci->SetDci (dci);
+  BenchCtrlFrame ("DlDci", dlDci, true, numIter);
+
+  UlDciListElement_s ulDciElem = UlDciListElement_s ();
+  ulDciElem.m_rnti = 1;
+  ulDciElem.m_rbLen = 6;
+  ulDciElem.m_tbSize = 56;
+  ulDciElem.m_mcs = 5;
+  ulDciElem.m_tpc = 1;
+  Ptr<UlDciLteControlMessage> ulDci = Create<UlDciLteControlMessage> ();
+  ulDci->SetDci (ulDciElem);
+  BenchCtrlFrame ("UlDci", ulDci, true, numIter);
+
+  Ptr<RarLteControlMessage> rar = Create<RarLteControlMessage> ();
+  rar->SetRaRnti (2);
+  RarLteControlMessage::Rar rarElem = RarLteControlMessage::Rar ();
+  rarElem.rapId = 5;
+  rarElem.rarPayload.m_rnti = 1;
+  rarElem.rarPayload.m_grant.m_rnti = 1;
+  rarElem.rarPayload.m_grant.m_rbLen = 6;
+  rarElem.rarPayload.m_grant.m_tbSize = 56;
+  rar->AddRar (rarElem);
+  BenchCtrlFrame ("Rar", rar, true, numIter);
+
+  CqiListElement_s cqi = CqiListElement_s ();
+  cqi.m_rnti = 1;
+  cqi.m_ri = 1;
+  cqi.m_cqiType = CqiListElement_s::A30;
+  cqi.m_wbCqi.push_back (15);
+  for (uint32_t i = 0; i < MAX_NUM_SUBBAND_SINR; i++)
+    {
+      HigherLayerSelected_s subband;
+      subband.m_sbCqi.push_back (15);
+      cqi.m_sbMeasResult.m_higherLayerSelected.push_back (subband);
+    }
+  Ptr<DlCqiLteControlMessage> dlCqi = Create<DlCqiLteControlMessage> ();
+  dlCqi->SetDlCqi (cqi);
+  BenchCtrlFrame ("DlCqi", dlCqi, false, numIter);
+
+  MacCeListElement_s bsrElem = MacCeListElement_s ();
+  bsrElem.m_rnti = 1;
+  bsrElem.m_macCeType = MacCeListElement_s::BSR;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      bsrElem.m_macCeValue.m_bufferStatus.push_back (10 + i);
+    }
+  Ptr<BsrLteControlMessage> bsr = Create<BsrLteControlMessage> ();
+  bsr->SetBsr (bsrElem);
+  BenchCtrlFrame ("Bsr", bsr, false, numIter);
+
+  // packets of the burst to MAC PDU and back, including the tag sidecar
+  uint32_t pduSize = 0;
+  m_phy->NiStartTxDataFrame (m_dataBurst, m_buf.data (), &pduSize, 1);
+  Bench ("phy", "NiStartTxDataFrame", numIter, pduSize, [&] (uint64_t i) -> uint64_t
+    {
+      uint32_t offset = 0;
+      m_phy->NiStartTxDataFrame (m_dataBurst, m_buf.data (), &offset, 1);
+      return offset;
+    });
+  Bench ("phy", "NiStartRxDataFrame", numIter, pduSize, [&] (uint64_t i) -> uint64_t
+    {
+      uint32_t offset = 0;
+      m_phy->NiStartRxDataFrame (m_phy->m_rxPackets, m_buf.data (), &offset, pduSize);
+      const uint64_t numPackets = m_phy->m_rxPackets.size ();
+      ReleaseRxFrame ();
+      return offset + numPackets;
+    });
+}
+
+} // namespace ns3
+
+//=============================================================================
+// NiLogging
+
+static void
+BenchLogging (uint64_t numIter, std::string logFile)
+{
+  if (!IsSelected ("logging", "NiLogSuppressed") && !IsSelected ("logging", "NiLogEmitted"))
+    {
+      return;
+    }
+  NiLoggingInit (LOG__LEVEL_DEBUG, logFile, NI_LOG__INSTANT_WRITE_DISABLE, NiUtils::GetThreadPrioriy ());
+
+  const uint32_t sfn = 1023;
+  const double sinr = 17.25;
+  Bench ("logging", "NiLogSuppressed", numIter, 0, [&] (uint64_t i) -> uint64_t
+    {
+      NI_LOG_TRACE ("suppressed rnti=" << i << " sfn=" << sfn << " sinr=" << sinr);
+      return i;
+    });
+
+  // short bursts with a pause in between, so that the logging thread drains the
+  // ring outside of the measurement also on machines with a single cpu core
+  if (IsSelected ("logging", "NiLogEmitted"))
+    {
+      const uint32_t burstSize = 64;
+      std::vector<double> repNs;
+      for (uint32_t rep = 0; rep < g_numRep; rep++)
+        {
+          uint64_t totalNs = 0;
+          for (uint64_t i = 0; i < numIter; )
+            {
+              const uint64_t startNs = NiUtils::GetSysTimeNs ();
+              for (uint32_t j = 0; (j < burstSize) && (i < numIter); j++, i++)
+                {
+                  NI_LOG_DEBUG ("emitted rnti=" << i << " sfn=" << sfn << " sinr=" << sinr);
+                }
+              totalNs += NiUtils::GetSysTimeNs () - startNs;
+              usleep (2000);
+            }
+          repNs.push_back ((double) totalNs / numIter);
+        }
+      AddResult ("logging", "NiLogEmitted", numIter, 0, repNs);
+    }
+
+  NiLoggingDeInit ();
+}
+
+//=============================================================================
+// NiUdpTransport round trip over the loopback interface
+
+static std::atomic<uint64_t> g_numEchoRx (0);
+static Ptr<NiUdpTransport> g_echoTransport;
+static uint32_t g_echoMsgSize = 0;
+
+// rx thread of the echo side - sends each datagram back
+static bool
+EchoCallback (uint8_t* rxBuffer)
+{
+  g_echoTransport->SendToUdpSocketTx (rxBuffer, g_echoMsgSize);
+  g_echoTransport->FlushUdpSocketTx ();
+  return true;
+}
+
+static bool
+EchoRxCallback (uint8_t* rxBuffer)
+{
+  g_numEchoRx.fetch_add (1, std::memory_order_release);
+  return true;
+}
+
+static void
+BenchUdpRoundTrip (uint64_t numIter, uint32_t msgSize, uint32_t port)
+{
+  if (!IsSelected ("udp", "NiUdpTransportRoundTrip"))
+    {
+      return;
+    }
+  const std::string portStr = std::to_string (port);
+  const std::string echoPortStr = std::to_string (port + 1);
+  g_echoMsgSize = msgSize;
+  g_numEchoRx.store (0);
+
+  g_echoTransport = CreateObject<NiUdpTransport> ("BENCH_ECHO");
+  g_echoTransport->SetNiApiDataEndOkCallback (MakeCallback (&EchoCallback));
+  g_echoTransport->OpenUdpSocketTx ("127.0.0.1", portStr);
+  g_echoTransport->OpenUdpSocketRx (echoPortStr, NiUtils::GetThreadPrioriy ());
+
+  Ptr<NiUdpTransport> transport = CreateObject<NiUdpTransport> ("BENCH");
+  transport->SetNiApiDataEndOkCallback (MakeCallback (&EchoRxCallback));
+  transport->OpenUdpSocketRx (portStr, NiUtils::GetThreadPrioriy ());
+  transport->OpenUdpSocketTx ("127.0.0.1", echoPortStr);
+
+  std::vector<uint8_t> msg (msgSize);
+  uint64_t numSent = 0;
+  uint64_t numLost = 0;
+  Bench ("udp", "NiUdpTransportRoundTrip", numIter, msgSize, [&] (uint64_t i) -> uint64_t
+    {
+      transport->SendToUdpSocketTx (msg.data (), msgSize);
+      transport->FlushUdpSocketTx ();
+      numSent++;
+      // datagrams lost on the loopback interface would block forever, give up after 100 ms
+      const uint64_t sentNs = NiUtils::GetSysTimeNs ();
+      while (g_numEchoRx.load (std::memory_order_acquire) + numLost < numSent)
+        {
+          if (NiUtils::GetSysTimeNs () - sentNs > 100000000ULL)
+            {
+              numLost++;
+              break;
+            }
+          // leave the cpu to the rx threads on machines with few cores
+          sched_yield ();
+        }
+      return numSent;
+    });
+  if (numLost > 0)
+    {
+      std::cout << "NiUdpTransportRoundTrip: " << numLost << " of " << numSent << " round trips lost" << std::endl;
+    }
+
+  transport->CloseUdpSocketTx ();
+  transport->CloseUdpSocketRx ();
+  g_echoTransport->CloseUdpSocketRx ();
+  g_echoTransport->CloseUdpSocketTx ();
+  g_echoTransport = 0;
+}
+
+//=============================================================================
+
+static std::string
+GetBuildProfile (void)
+{
+#if defined (NS3_BUILD_PROFILE_DEBUG)
+  return "debug";
+#elif defined (NS3_BUILD_PROFILE_RELEASE)
+  return "release";
+#elif defined (NS3_BUILD_PROFILE_OPTIMIZED)
+  return "optimized";
+#else
+  return "unknown";
+#endif
+}
+
+static int32_t
+WriteJson (std::string fileName, uint64_t numIter)
+{
+  std::ofstream out (fileName.c_str ());
+  if (!out)
+    {
+      std::cout << "could not open " << fileName << std::endl;
+      return -1;
+    }
+
+  char hostName[256] = "";
+  gethostname (hostName, sizeof (hostName) - 1);
+  char timeStamp[32] = "";
+  const time_t now = time (NULL);
+  struct tm utc;
+  gmtime_r (&now, &utc);
+  strftime (timeStamp, sizeof (timeStamp), "%Y-%m-%dT%H:%M:%SZ", &utc);
+
+  out << std::fixed << std::setprecision (3);
+  out << "{" << std::endl;
+  out << "  \"benchmark\": \"ni-micro-bench\"," << std::endl;
+  out << "  \"niModuleVersion\": \"" << NI_MODULE_VERSION << "\"," << std::endl;
+  out << "  \"buildProfile\": \"" << GetBuildProfile () << "\"," << std::endl;
+  out << "  \"timestamp\": \"" << timeStamp << "\"," << std::endl;
+  out << "  \"host\": \"" << hostName << "\"," << std::endl;
+  out << "  \"numIter\": " << numIter << "," << std::endl;
+  out << "  \"numRep\": " << g_numRep << "," << std::endl;
+  out << "  \"results\": [" << std::endl;
+  for (uint32_t i = 0; i < g_results.size (); i++)
+    {
+      const BenchResult& result = g_results[i];
+      double sumNs = 0;
+      for (uint32_t rep = 0; rep < result.repNs.size (); rep++)
+        {
+          sumNs += result.repNs[rep];
+        }
+      out << "    {\"group\": \"" << result.group << "\", \"name\": \"" << result.name << "\""
+          << ", \"iterations\": " << result.numIter
+          << ", \"bytesPerOp\": " << result.bytesPerOp
+          << ", \"meanNs\": " << sumNs / result.repNs.size ()
+          << ", \"minNs\": " << *std::min_element (result.repNs.begin (), result.repNs.end ())
+          << ", \"maxNs\": " << *std::max_element (result.repNs.begin (), result.repNs.end ())
+          << ", \"repNs\": [";
+      for (uint32_t rep = 0; rep < result.repNs.size (); rep++)
+        {
+          out << (rep ? ", " : "") << result.repNs[rep];
+        }
+      out << "]}" << ((i + 1 < g_results.size ()) ? "," : "") << std::endl;
+    }
+  out << "  ]" << std::endl;
+  out << "}" << std::endl;
+  return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint64_t numIter = 100000;
+  uint64_t numLogIter = 10000;
+  uint64_t numRoundTrips = 2000;
+  uint32_t tbsSize = 100;
+  uint32_t numPackets = 4;
+  uint32_t packetSize = 100;
+  uint32_t udpMsgSize = 200;
+  uint32_t udpPort = 12795;
+  std::string logFile = "/tmp/Log_MicroBench.txt";
+  std::string output = "/tmp/ni-micro-bench.json";
+
+  CommandLine cmd;
+  cmd.AddValue ("numIter", "Number of operations per repetition of the codec and phy benchmarks", numIter);
+  cmd.AddValue ("numRep", "Number of repetitions of each benchmark", g_numRep);
+  cmd.AddValue ("numLogIter", "Number of log calls per repetition", numLogIter);
+  cmd.AddValue ("numRoundTrips", "Number of UDP round trips per repetition", numRoundTrips);
+  cmd.AddValue ("filter", "Run only benchmarks whose group/name contains this string", g_filter);
+  cmd.AddValue ("tbsSize", "MAC PDU size in bytes of the payload messages", tbsSize);
+  cmd.AddValue ("numPackets", "Number of packets per MAC PDU of the data frame benchmarks", numPackets);
+  cmd.AddValue ("packetSize", "Size of these packets in bytes", packetSize);
+  cmd.AddValue ("udpMsgSize", "Datagram size in bytes of the UDP round trip", udpMsgSize);
+  cmd.AddValue ("udpPort", "Local UDP ports udpPort and udpPort + 1 of the round trip", udpPort);
+  cmd.AddValue ("logFile", "Log file written by the logging thread", logFile);
+  cmd.AddValue ("output", "JSON result file (empty = none)", output);
+  cmd.Parse (argc, argv);
+
+  if ((tbsSize > MAX_MAC_PDU_SIZE) || (udpMsgSize == 0) || (udpMsgSize > NI_COMMON_CONST_MAX_PAYLOAD_SIZE) ||
+      (numPackets * (packetSize + 64) > NI_COMMON_CONST_MAX_PAYLOAD_SIZE) || (g_numRep == 0))
+    {
+      std::cout << "invalid message sizes or number of repetitions" << std::endl;
+      return 1;
+    }
+
+  BenchCodecs (numIter, tbsSize);
+  {
+    NiLtePhyInterfaceBench phyBench (numPackets, packetSize);
+    phyBench.Run (numIter);
+  }
+  BenchLogging (numLogIter, logFile);
+  BenchUdpRoundTrip (numRoundTrips, udpMsgSize, udpPort);
+
+  if (!output.empty () && (WriteJson (output, numIter) < 0))
+    {
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+// Round trip benchmark of the L1-L2 API transports without PHY hardware.
+// A forked NiLtePhyEmulator takes the role of the LTE Application Framework:
+// it creates the named pipes or shared memory rings, sends PHY_TIMING_IND every
+// TTI and loops each PHY_DL_TX_PAYLOAD_REQ back as PHY_DLSCH_RX_IND. The
+// benchmark measures the time from CreateAndSendDlTxPayloadReqMsg until the
+// rx callback of the transport has been called.
+//
+// ./waf --run "ni-shm-transport-bench --transport=shm --numMsgs=10000 --tbsSize=1000"
+
+#include "ns3/core-module.h"
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <iostream>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// NI includes
+#include "ns3/ni.h"
+#include "ns3/ni-lte-phy-emulator.h"
+
+using namespace ns3;
+
+static NiLtePhyEmulator* g_pPhyEmulator = NULL;
+static std::atomic<uint64_t> g_numRx (0);
+
+static void
+PeerSignalHandler (int signal)
+{
+  g_pPhyEmulator->Stop ();
+}
+
+static bool
+RxCallback (uint8_t* macPdu, uint32_t macPduSize)
+{
+  g_numRx.fetch_add (1, std::memory_order_release);
+  return true;
+}
+
+//======================================================================================
+// benchmark
+//======================================================================================
+
+int
+main (int argc, char *argv[])
+{
+  std::string transport = "shm";
+  uint32_t numMsgs = 10000;
+  uint32_t tbsSize = 1000;
+  uint32_t ttiUs = 1000;
+
+  CommandLine cmd;
+  cmd.AddValue ("transport", "L1-L2 API transport to benchmark (shm or pipe)", transport);
+  cmd.AddValue ("numMsgs", "Number of DL TX payload requests to send", numMsgs);
+  cmd.AddValue ("tbsSize", "MAC PDU size in bytes", tbsSize);
+  cmd.AddValue ("ttiUs", "Period of PHY timing indications in microseconds", ttiUs);
+  cmd.Parse (argc, argv);
+
+  const bool useShm = (transport == "shm");
+  if (!useShm && (transport != "pipe"))
+    {
+      std::cout << "Unknown transport " << transport << std::endl;
+      return 1;
+    }
+  if (tbsSize > MAX_MAC_PDU_SIZE)
+    {
+      std::cout << "tbsSize exceeds MAX_MAC_PDU_SIZE" << std::endl;
+      return 1;
+    }
+
+  const pid_t peerPid = fork ();
+  if (peerPid < 0)
+    {
+      std::cout << "fork failed" << std::endl;
+      return 1;
+    }
+  if (peerPid == 0)
+    {
+      NiLtePhyEmulator phyEmulator;
+      phyEmulator.SetUseShm (useShm);
+      phyEmulator.SetTtiUs (ttiUs);
+      phyEmulator.SetCellMeasPeriodTti (0);
+      g_pPhyEmulator = &phyEmulator;
+      signal (SIGTERM, PeerSignalHandler);
+      if (phyEmulator.Open () == 0)
+        {
+          phyEmulator.Run (0);
+        }
+      phyEmulator.Close ();
+      _exit (0);
+    }
+
+  // transport in UE role, so looped back DLSCH RX indications reach the rx callback
+  Ptr<NiPipeTransport> niTransport;
+  if (useShm)
+    {
+      niTransport = CreateObject<NiShmTransport> ("BENCH");
+    }
+  else
+    {
+      niTransport = CreateObject<NiPipeTransport> ("BENCH");
+    }
+  niTransport->SetNiApiDevType (1);
+  niTransport->SetNiApiDataEndOkCallback (MakeCallback (&RxCallback));
+  const int priority = NiUtils::GetThreadPrioriy ();
+  niTransport->Init (priority, priority);
+
+  while (!niTransport->GetTimingIndReceived ())
+    {
+      usleep (100);
+    }
+
+  std::vector<uint8_t> macPdu (tbsSize);
+  for (uint32_t i = 0; i < tbsSize; i++)
+    {
+      macPdu[i] = (uint8_t)i;
+    }
+
+  std::vector<uint64_t> latencyNs;
+  latencyNs.reserve (numMsgs);
+  uint32_t numLost = 0;
+  const uint64_t timeoutNs = 100000000; // 100 ms
+
+  for (uint32_t i = 0; i < numMsgs; i++)
+    {
+      const uint64_t numRx = g_numRx.load (std::memory_order_acquire);
+      const uint64_t startNs = NiUtils::GetSysTimeNs ();
+      niTransport->CreateAndSendDlTxPayloadReqMsg (0, 0, macPdu.data (), tbsSize);
+      uint64_t nowNs = startNs;
+      while ((g_numRx.load (std::memory_order_acquire) == numRx) && (nowNs - startNs < timeoutNs))
+        {
+          nowNs = NiUtils::GetSysTimeNs ();
+        }
+      if (g_numRx.load (std::memory_order_acquire) == numRx)
+        {
+          numLost++;
+          continue;
+        }
+      latencyNs.push_back (nowNs - startNs);
+    }
+
+  niTransport->DeInit ();
+  kill (peerPid, SIGTERM);
+  waitpid (peerPid, NULL, 0);
+
+  std::cout << "-------- L1-L2 API transport round trip (" << transport << ") --------" << std::endl;
+  std::cout << "messages     = " << numMsgs << " (tbsSize " << tbsSize << " bytes, lost " << numLost << ")" << std::endl;
+  if (!latencyNs.empty ())
+    {
+      std::sort (latencyNs.begin (), latencyNs.end ());
+      uint64_t sumNs = 0;
+      for (uint32_t i = 0; i < latencyNs.size (); i++)
+        {
+          sumNs += latencyNs[i];
+        }
+      std::cout << "avg          = " << (sumNs / latencyNs.size ()) / 1000.0 << " us" << std::endl;
+      std::cout << "min          = " << latencyNs.front () / 1000.0 << " us" << std::endl;
+      std::cout << "p50          = " << latencyNs[latencyNs.size () / 2] / 1000.0 << " us" << std::endl;
+      std::cout << "p99          = " << latencyNs[(latencyNs.size () * 99) / 100] / 1000.0 << " us" << std::endl;
+      std::cout << "max          = " << latencyNs.back () / 1000.0 << " us" << std::endl;
+    }
+
+  return 0;
+}
@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+// TTI jitter of a PHY timing thread for a list of thread placements. The
+// timing thread wakes up every TTI on an absolute deadline and records how
+// late it runs, while load threads named like the ns-3 main thread and the
+// logging thread keep the cpus busy for loadUs of every TTI. Placements are
+// separated by '|', "none" leaves all threads floating with the priority of
+// the benchmark, see NiUtils::SetThreadTopology for the rule syntax. Name
+// patterns can not contain spaces on the command line.
+//
+// ./waf --run "ni-thread-topology-bench --numTtis=5000 --placements='none|PhyTimingInd=0:fifo:90'"
+// ./waf --run "ni-thread-topology-bench --placements='none|PhyTimingInd=1:fifo:90;NS3=2-3;Nilogging=2-3'"
+
+#include "ns3/core-module.h"
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <iostream>
+#include <time.h>
+
+// NI includes
+#include "ns3/ni-utils.h"
+#include "ns3/ni-latency-histogram.h"
+
+using namespace ns3;
+
+static const uint64_t g_ttiNs = 1000000;
+
+static void
+TimingThread (NiLatencyHistograms* pHistograms, uint32_t numTtis)
+{
+  NiUtils::AddThreadInfo (pthread_self (), "BENCH NiPipeTransport PhyTimingInd thread");
+  struct timespec deadline;
+  clock_gettime (CLOCK_MONOTONIC, &deadline);
+  for (uint32_t tti = 0; tti < numTtis; tti++)
+    {
+      deadline.tv_nsec += g_ttiNs;
+      if (deadline.tv_nsec >= 1000000000L)
+        {
+          deadline.tv_nsec -= 1000000000L;
+          deadline.tv_sec++;
+        }
+      clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+      const uint64_t deadlineNs = (uint64_t) deadline.tv_sec * 1000000000ULL + deadline.tv_nsec;
+      const uint64_t nowNs = NiUtils::GetSysTimeNs ();
+      pHistograms->Record (NI_LATENCY_SUBFRAME_TIMING_WAIT, (nowNs > deadlineNs) ? nowNs - deadlineNs : 0);
+    }
+  NiUtils::RemoveThreadInfo (pthread_self ());
+}
+
+// busy for loadUs of every TTI, sleeps for the rest
+static void
+LoadThread (std::string name, uint64_t loadUs, std::atomic<bool>* pStop)
+{
+  NiUtils::AddThreadInfo (pthread_self (), name);
+  const struct timespec idle = {0, (long) ((g_ttiNs > loadUs * 1000) ? g_ttiNs - loadUs * 1000 : 0)};
+  while (!pStop->load (std::memory_order_relaxed))
+    {
+      const uint64_t startNs = NiUtils::GetSysTimeNs ();
+      while (NiUtils::GetSysTimeNs () - startNs < loadUs * 1000)
+        {
+        }
+      nanosleep (&idle, NULL);
+    }
+  NiUtils::RemoveThreadInfo (pthread_self ());
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t numTtis = 2000;
+  uint32_t loadUs = 400;
+  uint32_t numLoadThreads = 2;
+  std::string placements = "none|PhyTimingInd=:fifo:90";
+
+  CommandLine cmd;
+  cmd.AddValue ("numTtis", "Number of TTIs per placement", numTtis);
+  cmd.AddValue ("loadUs", "Busy time of each load thread per TTI in us", loadUs);
+  cmd.AddValue ("numLoadThreads", "Number of load threads per name (NS3 main, Nilogging)", numLoadThreads);
+  cmd.AddValue ("placements", "Thread topologies separated by '|', none = no placement", placements);
+  cmd.Parse (argc, argv);
+
+  std::cout << "placement, mean us, p50 us, p99 us, p99.9 us, max us" << std::endl;
+
+  std::stringstream placementList (placements);
+  std::string placement;
+  while (std::getline (placementList, placement, '|'))
+    {
+      NiUtils::SetThreadTopology ((placement == "none") ? "" : placement);
+
+      std::atomic<bool> stop (false);
+      std::vector<std::thread> loadThreads;
+      for (uint32_t i = 0; i < numLoadThreads; i++)
+        {
+          loadThreads.push_back (std::thread (LoadThread, "NS3 main thread", loadUs, &stop));
+          loadThreads.push_back (std::thread (LoadThread, "Nilogging thread", loadUs, &stop));
+        }
+
+      NiLatencyHistograms histograms;
+      std::thread timingThread (TimingThread, &histograms, numTtis);
+      timingThread.join ();
+      stop.store (true);
+      for (uint32_t i = 0; i < loadThreads.size (); i++)
+        {
+          loadThreads[i].join ();
+        }
+
+      const NiLatencySnapshot snapshot = histograms.GetSnapshot (NI_LATENCY_SUBFRAME_TIMING_WAIT);
+      std::cout << placement << ", " << snapshot.GetMeanNs () / 1000.0
+                << ", " << snapshot.GetPercentileNs (50.0) / 1000.0
+                << ", " << snapshot.GetPercentileNs (99.0) / 1000.0
+                << ", " << snapshot.GetPercentileNs (99.9) / 1000.0
+                << ", " << snapshot.GetMaxNs () / 1000.0 << std::endl;
+    }
+
+  return 0;
+}
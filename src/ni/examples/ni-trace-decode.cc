@@ -0,0 +1,205 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+// Offline decoder of the binary trace files written by NiTrace, e.g. with
+// "ni-lte-simple --niApiEnableTrace=1". The records are converted either to
+// a CSV file or to a directory with one little endian int64 file per column
+// (column store, e.g. for numpy.fromfile or a conversion to Parquet) plus a
+// schema.txt. With traceId the payload columns get the names of that trace.
+//
+// ./waf --run "ni-trace-decode --input=/tmp/Trace_Lte_BSTS.bin --output=/tmp/Trace_Lte_BSTS.csv"
+// ./waf --run "ni-trace-decode --input=/tmp/Trace_Lte_BSTS.bin --output=/tmp/trace --format=columns --traceId=1"
+
+#include "ns3/core-module.h"
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+
+// NI includes
+#include "ns3/ni-trace.h"
+
+using namespace ns3;
+
+static std::vector<std::string>
+GetColumnNames (int32_t traceId)
+{
+  std::vector<std::string> names;
+  names.push_back ("traceId");
+  names.push_back ("sfn");
+  names.push_back ("tti");
+  names.push_back ("simTimeUs");
+  names.push_back ("sysTimeNs");
+
+  std::vector<std::string> payloadNames;
+  if (traceId >= 0)
+    {
+      std::stringstream list (NiTrace::GetPayloadNames (traceId));
+      std::string item;
+      while (std::getline (list, item, ','))
+        {
+          payloadNames.push_back (item);
+        }
+    }
+  for (uint32_t i = 0; i < NI_TRACE__NUM_PAYLOAD; i++)
+    {
+      names.push_back ((i < payloadNames.size ()) ? payloadNames[i] : ("p" + std::to_string (i)));
+    }
+  return names;
+}
+
+static void
+GetColumnValues (const NiTraceRecord& record, const NiTraceFileHeader& hdr, int64_t* values)
+{
+  values[0] = record.traceId;
+  values[1] = record.sfn;
+  values[2] = record.tti;
+  values[3] = (int64_t)((double) record.simTimeStep * 1e6 / hdr.simTimeStepsPerSecond);
+  // relative to the opening of the trace file
+  values[4] = (int64_t)(record.sysTimeNs - hdr.startSysTimeNs);
+  for (uint32_t i = 0; i < NI_TRACE__NUM_PAYLOAD; i++)
+    {
+      values[5 + i] = record.payload[i];
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string input = "/tmp/Trace_Lte_BSTS.bin";
+  std::string output = "/tmp/Trace_Lte_BSTS.csv";
+  std::string format = "csv";
+  int32_t traceId = -1;
+
+  CommandLine cmd;
+  cmd.AddValue ("input", "Binary trace file", input);
+  cmd.AddValue ("output", "CSV file or column directory", output);
+  cmd.AddValue ("format", "csv or columns", format);
+  cmd.AddValue ("traceId", "Decode only records of this trace id (-1 = all)", traceId);
+  cmd.Parse (argc, argv);
+
+  if ((format != "csv") && (format != "columns"))
+    {
+      std::cout << "unknown format " << format << std::endl;
+      return 1;
+    }
+
+  NiTraceFileHeader hdr;
+  std::vector<NiTraceRecord> records;
+  if (NiTrace::ReadFile (input, &hdr, &records) < 0)
+    {
+      return 1;
+    }
+
+  const std::vector<std::string> names = GetColumnNames (traceId);
+  const uint32_t numColumns = names.size ();
+  std::vector<int64_t> values (numColumns);
+  uint64_t numDecoded = 0;
+
+  if (format == "csv")
+    {
+      std::ofstream csv (output.c_str ());
+      if (!csv)
+        {
+          std::cout << "cannot open " << output << std::endl;
+          return 1;
+        }
+      csv << "traceName";
+      for (uint32_t c = 0; c < numColumns; c++)
+        {
+          csv << "," << names[c];
+        }
+      csv << "\n";
+      for (uint64_t i = 0; i < records.size (); i++)
+        {
+          if ((traceId >= 0) && (records[i].traceId != traceId))
+            {
+              continue;
+            }
+          GetColumnValues (records[i], hdr, values.data ());
+          csv << NiTrace::GetTraceName (records[i].traceId);
+          for (uint32_t c = 0; c < numColumns; c++)
+            {
+              csv << "," << values[c];
+            }
+          csv << "\n";
+          numDecoded++;
+        }
+    }
+  else
+    {
+      mkdir (output.c_str (), 0775);
+      std::vector<std::ofstream*> columns;
+      for (uint32_t c = 0; c < numColumns; c++)
+        {
+          columns.push_back (new std::ofstream ((output + "/" + names[c] + ".i64").c_str (), std::ios::binary));
+          if (!*columns[c])
+            {
+              std::cout << "cannot open " << output << "/" << names[c] << ".i64" << std::endl;
+              return 1;
+            }
+        }
+      for (uint64_t i = 0; i < records.size (); i++)
+        {
+          if ((traceId >= 0) && (records[i].traceId != traceId))
+            {
+              continue;
+            }
+          GetColumnValues (records[i], hdr, values.data ());
+          for (uint32_t c = 0; c < numColumns; c++)
+            {
+              columns[c]->write ((const char*) &values[c], sizeof (int64_t));
+            }
+          numDecoded++;
+        }
+      for (uint32_t c = 0; c < numColumns; c++)
+        {
+          delete columns[c];
+        }
+
+      std::ofstream schema ((output + "/schema.txt").c_str ());
+      schema << "rows " << numDecoded << "\n";
+      for (uint32_t c = 0; c < numColumns; c++)
+        {
+          schema << names[c] << ".i64 int64 little-endian\n";
+        }
+      schema << "trace ids\n";
+      const int32_t ids[] = {NI_TRACE_START_SUBFRAME_START, NI_TRACE_PHY_TIMING_IND, NI_TRACE_WALL_CLOCK_ALIGNMENT,
+                             NI_TRACE_START_SUBFRAME_END, NI_TRACE_SEND_CONTROL_CHANNELS, NI_TRACE_SEND_DATA_CHANNELS,
+                             NI_TRACE_TX_CTRL_DATA_FRAME_START, NI_TRACE_TX_CTRL_DATA_FRAME_END};
+      for (uint32_t i = 0; i < sizeof (ids) / sizeof (ids[0]); i++)
+        {
+          schema << ids[i] << " " << NiTrace::GetTraceName (ids[i]) << ": " << NiTrace::GetPayloadNames (ids[i]) << "\n";
+        }
+    }
+
+  const uint64_t numRecords = hdr.numRecords.load ();
+  std::cout << input << ": " << records.size () << " records";
+  if (numRecords > records.size ())
+    {
+      std::cout << " (" << numRecords - records.size () << (hdr.wrap ? " overwritten" : " dropped or incomplete") << ")";
+    }
+  std::cout << ", " << numDecoded << " decoded to " << output << std::endl;
+  return 0;
+}
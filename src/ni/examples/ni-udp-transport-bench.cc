@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+// Throughput benchmark of NiUdpTransport over the loopback interface for a
+// list of batch sizes (1 = recvfrom / sendto, otherwise recvmmsg / sendmmsg).
+// The sender keeps at most `window` datagrams in flight so that the socket
+// receive buffer does not overflow and the rx thread is the bottleneck.
+// With numStations > 1 the fan out of each message to all stations with one
+// sendmmsg is compared against one sendto per station.
+//
+// ./waf --run "ni-udp-transport-bench --numMsgs=200000 --msgSize=200 --batchSizes=1,4,16,64"
+// ./waf --run "ni-udp-transport-bench --numMsgs=20000 --numStations=32 --batchSizes=0"
+
+#include "ns3/core-module.h"
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <atomic>
+#include <iostream>
+#include <unistd.h>
+#include <sched.h>
+
+// NI includes
+#include "ns3/ni-utils.h"
+#include "ns3/ni-udp-transport.h"
+
+using namespace ns3;
+
+static std::atomic<uint64_t> g_numRx (0);
+
+static bool
+RxCallback (uint8_t* rxBuffer)
+{
+  g_numRx.fetch_add (1, std::memory_order_release);
+  return true;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t numMsgs = 200000;
+  uint32_t msgSize = 200;
+  uint32_t window = 64;
+  std::string batchSizes = "1,4,16,64";
+  uint32_t port = 12790;
+  uint32_t numStations = 1;
+
+  CommandLine cmd;
+  cmd.AddValue ("numMsgs", "Number of datagrams per batch size", numMsgs);
+  cmd.AddValue ("msgSize", "Datagram size in bytes", msgSize);
+  cmd.AddValue ("window", "Maximum number of datagrams in flight", window);
+  cmd.AddValue ("batchSizes", "Comma separated list of batch sizes (0 = skip the throughput test)", batchSizes);
+  cmd.AddValue ("port", "Local UDP port", port);
+  cmd.AddValue ("numStations", "Number of receivers of the fan out test (1 = off)", numStations);
+  cmd.Parse (argc, argv);
+
+  if ((msgSize == 0) || (msgSize > NI_COMMON_CONST_MAX_PAYLOAD_SIZE))
+    {
+      std::cout << "msgSize exceeds NI_COMMON_CONST_MAX_PAYLOAD_SIZE" << std::endl;
+      return 1;
+    }
+
+  std::vector<uint8_t> msg (msgSize);
+  for (uint32_t i = 0; i < msgSize; i++)
+    {
+      msg[i] = (uint8_t)i;
+    }
+
+  std::cout << "batch size, packets/s, rx calls, avg rx batch, tx calls" << std::endl;
+
+  std::stringstream batchSizeList (batchSizes);
+  std::string item;
+  while (std::getline (batchSizeList, item, ','))
+    {
+      const uint32_t batchSize = std::stoul (item);
+      if (batchSize == 0)
+        {
+          continue;
+        }
+      const std::string portStr = std::to_string (port++);
+      g_numRx.store (0);
+
+      Ptr<NiUdpTransport> rxTransport = CreateObject<NiUdpTransport> ("BENCH_RX");
+      rxTransport->SetBatchSize (batchSize);
+      rxTransport->SetNiApiDataEndOkCallback (MakeCallback (&RxCallback));
+      rxTransport->OpenUdpSocketRx (portStr, NiUtils::GetThreadPrioriy ());
+
+      Ptr<NiUdpTransport> txTransport = CreateObject<NiUdpTransport> ("BENCH_TX");
+      txTransport->SetBatchSize (batchSize);
+      txTransport->OpenUdpSocketTx ("127.0.0.1", portStr);
+
+      const uint64_t startNs = NiUtils::GetSysTimeNs ();
+      uint32_t numSent = 0;
+      while (numSent < numMsgs)
+        {
+          if (numSent - g_numRx.load (std::memory_order_acquire) + batchSize > window)
+            {
+              // leave the cpu to the rx thread on machines with few cores
+              sched_yield ();
+              continue;
+            }
+          for (uint32_t i = 0; (i < batchSize) && (numSent < numMsgs); i++, numSent++)
+            {
+              txTransport->SendToUdpSocketTx (msg.data (), msgSize);
+            }
+          txTransport->FlushUdpSocketTx ();
+        }
+      // datagrams lost on the loopback interface would block forever, give up after 1 s
+      const uint64_t sentNs = NiUtils::GetSysTimeNs ();
+      while ((g_numRx.load (std::memory_order_acquire) < numMsgs) && (NiUtils::GetSysTimeNs () - sentNs < 1000000000ULL))
+        {
+          sched_yield ();
+        }
+      const uint64_t durationNs = NiUtils::GetSysTimeNs () - startNs;
+      const uint64_t numRx = g_numRx.load ();
+
+      const NiUdpTransportStats rxStats = rxTransport->GetStats ();
+      const NiUdpTransportStats txStats = txTransport->GetStats ();
+      std::cout << batchSize << ", " << (uint64_t)(numRx * 1e9 / durationNs) << ", "
+                << rxStats.numRxCalls << ", " << (double)rxStats.numRxPackets / rxStats.numRxCalls << ", "
+                << txStats.numTxCalls;
+      if (numRx < numMsgs)
+        {
+          std::cout << " (lost " << numMsgs - numRx << ")";
+        }
+      std::cout << std::endl;
+
+      txTransport->CloseUdpSocketTx ();
+      rxTransport->CloseUdpSocketRx ();
+    }
+
+  if (numStations > 1)
+    {
+      std::cout << "fan out to " << numStations << " stations, messages/s, tx calls" << std::endl;
+
+      std::vector<Ptr<NiUdpTransport> > stations;
+      Ptr<NiUdpTransport> txTransport = CreateObject<NiUdpTransport> ("BENCH_TX");
+      for (uint32_t i = 0; i < numStations; i++)
+        {
+          Ptr<NiUdpTransport> rxTransport = CreateObject<NiUdpTransport> ("BENCH_STA");
+          rxTransport->SetBatchSize (NI_UDP_MAX_BATCH_SIZE);
+          rxTransport->SetNiApiDataEndOkCallback (MakeCallback (&RxCallback));
+          rxTransport->OpenUdpSocketRx (std::to_string (port + i), NiUtils::GetThreadPrioriy ());
+          stations.push_back (rxTransport);
+          if (i == 0)
+            {
+              txTransport->OpenUdpSocketTx ("127.0.0.1", std::to_string (port));
+            }
+          else
+            {
+              txTransport->AddTxDestination ("127.0.0.1", std::to_string (port + i));
+            }
+        }
+
+      for (uint32_t fanOut = 0; fanOut < 2; fanOut++)
+        {
+          g_numRx.store (0);
+          const uint64_t numTxCallsBefore = txTransport->GetStats ().numTxCalls;
+          const uint64_t startNs = NiUtils::GetSysTimeNs ();
+          uint32_t numSent = 0;
+          while (numSent < numMsgs)
+            {
+              if ((uint64_t)(numSent + 1) * numStations - g_numRx.load (std::memory_order_acquire) > window * numStations)
+                {
+                  sched_yield ();
+                  continue;
+                }
+              if (fanOut)
+                {
+                  txTransport->SendToUdpSocketTxAll (msg.data (), msgSize);
+                }
+              else
+                {
+                  for (uint32_t i = 0; i < numStations; i++)
+                    {
+                      txTransport->SendToUdpSocketTxDest (i, msg.data (), msgSize);
+                    }
+                }
+              numSent++;
+            }
+          const uint64_t sentNs = NiUtils::GetSysTimeNs ();
+          while ((g_numRx.load (std::memory_order_acquire) < (uint64_t)numMsgs * numStations) && (NiUtils::GetSysTimeNs () - sentNs < 1000000000ULL))
+            {
+              sched_yield ();
+            }
+          const uint64_t durationNs = NiUtils::GetSysTimeNs () - startNs;
+          const uint64_t numRx = g_numRx.load ();
+          std::cout << (fanOut ? "sendmmsg" : "sendto  ") << ", " << (uint64_t)(numMsgs * 1e9 / durationNs) << ", "
+                    << txTransport->GetStats ().numTxCalls - numTxCallsBefore;
+          if (numRx < (uint64_t)numMsgs * numStations)
+            {
+              std::cout << " (lost " << (uint64_t)numMsgs * numStations - numRx << ")";
+            }
+          std::cout << std::endl;
+        }
+
+      txTransport->CloseUdpSocketTx ();
+      for (uint32_t i = 0; i < numStations; i++)
+        {
+          stations[i]->CloseUdpSocketRx ();
+        }
+    }
+
+  return 0;
+}
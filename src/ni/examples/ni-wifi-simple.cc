@@ -74,6 +74,14 @@ int main (int argc, char *argv[])
 
   // Activate logging using NI API log files
   bool niApiEnableLogging = true;
+  // placement of the NI threads, see NiUtils::SetThreadTopology
+  std::string niThreadTopology = "";
+  // lock and prefault memory for the real-time loop, see NiRtMemoryInit
+  bool niApiRtMemory = false;
+  // Record all L1-L2 API messages to this file, replayed with ni-capture-replay (empty = disabled)
+  std::string niApiCaptureFile = "";
+  // Maximum size of the capture file in MB
+  uint32_t niApiCaptureMaxMB = 256;
   // Set log file names
   std::string LogFileName;
   // Enable TapBridge as data source and data sink
@@ -110,6 +118,8 @@ int main (int argc, char *argv[])
   std::string niApiWifiBssidMacAddr("46:6F:4B:75:6D:61");
   // MCS used by 802.11 AFW
   uint32_t niApiWifiMcs(5);
+  // MAC addresses of the stations in UDP loopback mode, unknown addresses are sent to all stations
+  std::string niApiWifiStaMacAddrList("");
   //
   std::string phyMode ("DsssRate1Mbps");
   //
@@ -129,6 +139,10 @@ int main (int argc, char *argv[])
                "as AP and STA (for Infrastructure mode) or none of them", niApiWifiDevMode);
   cmd.AddValue("niApiWifiEnabled", "Enable NI API", niApiWifiEnabled);
   cmd.AddValue("niApiEnableLogging", "Set whether to enable NI_LOG_DEBUGs", niApiEnableLogging);
+  cmd.AddValue("niThreadTopology", "CPU set, policy and priority of NI threads, e.g. \"PhyTimingInd=2:fifo:90;NS3=1\"", niThreadTopology);
+  cmd.AddValue("niApiRtMemory", "Lock and prefault the process memory for the real-time loop", niApiRtMemory);
+  cmd.AddValue("niApiCaptureFile", "Record all L1-L2 API messages to this file (empty = disabled)", niApiCaptureFile);
+  cmd.AddValue("niApiCaptureMaxMB", "Maximum size of the capture file in MB", niApiCaptureMaxMB);
   cmd.AddValue("niApiWifiLoopbackEnabled", "Enable/disable UDP Loopback on MAC High", niApiWifiLoopbackEnabled);
   cmd.AddValue("niApiEnableTapBridge", "Enable/disable TapBridge as external data source/sink", niApiEnableTapBridge);
   cmd.AddValue("niApiWifiEnablePrintMsgContent", "Set whether the simulation should print out the contents of sent/received packets", niApiWifiEnablePrintMsgContent);
@@ -142,6 +156,7 @@ int main (int argc, char *argv[])
   cmd.AddValue("niApiWifiSta2MacAddr", "MAC address of STA2 in format ff:ff:ff:ff:ff:ff", niApiWifiSta2MacAddr);
   cmd.AddValue("niApiWifiBssidMacAddr", "MAC address of BSSID in format ff:ff:ff:ff:ff:ff", niApiWifiBssidMacAddr);
   cmd.AddValue("niApiWifiMcs", "MCS to be used by the 802.11 AFW", niApiWifiMcs);
+  cmd.AddValue("niApiWifiStaMacAddrList", "Comma separated MAC addresses of the stations in the order of their UDP ports (AP in UDP loopback mode)", niApiWifiStaMacAddrList);
   cmd.AddValue("niApiWifiStationNum", "Set whether the device should run as STA1 or STA2 in Infrastructure mode", nWifiStaNodes);
   cmd.AddValue("niApiWifiDeviceSelect", "Set whether the device should run as STA1 or STA2 in Infrastructure mode", niApiWifiDeviceSelect);
 
@@ -216,6 +231,14 @@ int main (int argc, char *argv[])
   int niLoggingPriority = ns3priority - 10;
   // adding thread ID of main NS3 thread for possible troubleshooting
   NiUtils::AddThreadInfo(pthread_self(), "NS3 main thread");
+  if (!niThreadTopology.empty())
+    {
+      NiUtils::SetThreadTopology(niThreadTopology);
+    }
+  if (niApiRtMemory)
+    {
+      NiRtMemoryInit(NI_RT_MEMORY__DEFAULT_HEAP_PREFAULT_BYTES, NI_RT_MEMORY__DEFAULT_STACK_PREFAULT_BYTES);
+    }
 
   // install signal handlers in order to print debug information to std::out in case of an error
   NiUtils::InstallSignalHandler();
@@ -224,6 +247,10 @@ int main (int argc, char *argv[])
       std::string LogFileName = "/tmp/Log_Wifi_" + stationType + ".txt";
       NiLoggingInit(LOG__LEVEL_ALL | LOG__CONSOLE_DEBUG, LogFileName, NI_LOG__INSTANT_WRITE_DISABLE, niLoggingPriority);
   }
+  if (!niApiCaptureFile.empty ())
+    {
+      NiCaptureInit(niApiCaptureFile, (uint64_t) niApiCaptureMaxMB << 20);
+    }
 
   // =========================
   // NI Wifi API Configuration
@@ -265,6 +292,7 @@ int main (int argc, char *argv[])
       Config::SetDefault ("ns3::NiWifiMacInterface::niApiConfirmationMessage", BooleanValue (niApiConfirmationMessage));
       Config::SetDefault ("ns3::NiWifiMacInterface::niApiWifiMcs", IntegerValue(niApiWifiMcs));
       Config::SetDefault ("ns3::NiWifiMacInterface::NumOfStations", IntegerValue (nWifiStaNodes));
+      Config::SetDefault ("ns3::NiWifiMacInterface::niApiWifiStaMacAddrList", StringValue (niApiWifiStaMacAddrList));
     }
 
   // wifi helper
@@ -492,6 +520,10 @@ int main (int argc, char *argv[])
     {
       NiLoggingDeInit();
     }
+  if (!niApiCaptureFile.empty ())
+    {
+      NiCaptureDeInit();
+    }
 
   NI_LOG_CONSOLE_INFO ("---- Program end! ---- ");
   return 0;
@@ -0,0 +1,602 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#include <stdio.h>      // printf, fopen
+#include <stdint.h>     // integer types
+
+#include <fcntl.h>      // open
+#include <sys/mman.h>   // mmap
+#include <unistd.h>
+#include <errno.h>      // errno
+#include <string.h>     // strerror, memcpy
+#include <time.h>       // nanosleep
+#include <cstddef>      // offsetof
+#include <algorithm>
+#include <arpa/inet.h>  // inet_pton
+#include <sys/socket.h>
+
+#include "ni-utils.h"
+#include "ni-logging.h"
+#include "ni-pipe.h"
+#include "ni-pipe-transport.h"
+#include "ni-shm-transport.h"
+#include "ni-capture.h"
+
+namespace ns3
+{
+
+  static_assert (sizeof (NiCaptureFileHeader) == 24, "NiCaptureFileHeader has to match the pcap file header");
+  static_assert (sizeof (NiCaptureRecordHeader) == 16, "NiCaptureRecordHeader has to match the pcap record header");
+  static_assert (sizeof (NiCapturePseudoHeader) == 8, "NiCapturePseudoHeader size changed");
+
+  // global capture file, opened by NiCaptureInit
+  NiCapture g_NiCapture;
+
+  NiCapture::NiCapture ()
+  : m_enabled (false),
+    m_pMem (NULL),
+    m_mapSize (0),
+    m_fd (-1),
+    m_numBytes (0),
+    m_numRecords (0),
+    m_numDropped (0)
+  {
+  }
+
+  NiCapture::~NiCapture ()
+  {
+    Close ();
+  }
+
+  int32_t NiCapture::Open (std::string fileName, uint64_t maxBytes)
+  {
+    if (m_pMem != NULL)
+      {
+        return -1;
+      }
+    if (maxBytes == 0)
+      {
+        maxBytes = NI_CAPTURE__DEFAULT_MAX_BYTES;
+      }
+    if (maxBytes < sizeof (NiCaptureFileHeader))
+      {
+        return -1;
+      }
+
+    unlink (fileName.c_str ());
+    errno = 0;
+    m_fd = open (fileName.c_str (), O_RDWR | O_CREAT | O_EXCL, 0664);
+    if (m_fd < 0)
+      {
+        printf ("ERROR: NiCapture::Open() -> open() for %s errno=%i: %s\n", fileName.c_str (), errno, strerror (errno));
+        return -1;
+      }
+
+    // allocate the blocks up front, so that capturing a message never waits for the file system
+    const size_t mapSize = maxBytes;
+    int32_t ret = posix_fallocate (m_fd, 0, mapSize);
+    if (ret != 0)
+      {
+        // e.g. not supported by the file system, fall back to a sparse file
+        if (ftruncate (m_fd, mapSize) < 0)
+          {
+            printf ("ERROR: NiCapture::Open() -> ftruncate() for %s errno=%i: %s\n", fileName.c_str (), errno, strerror (errno));
+            close (m_fd);
+            m_fd = -1;
+            return -1;
+          }
+      }
+
+    errno = 0;
+    void* pMem = mmap (NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (pMem == MAP_FAILED)
+      {
+        printf ("ERROR: NiCapture::Open() -> mmap() for %s errno=%i: %s\n", fileName.c_str (), errno, strerror (errno));
+        close (m_fd);
+        m_fd = -1;
+        return -1;
+      }
+    madvise (pMem, mapSize, MADV_SEQUENTIAL);
+
+    NiCaptureFileHeader hdr;
+    hdr.magic = NI_CAPTURE__PCAP_MAGIC_NS;
+    hdr.versionMajor = 2;
+    hdr.versionMinor = 4;
+    hdr.thisZone = 0;
+    hdr.sigFigs = 0;
+    hdr.snapLen = NI_CAPTURE__MAX_MSG_SIZE + sizeof (NiCapturePseudoHeader);
+    hdr.linkType = NI_CAPTURE__PCAP_LINKTYPE;
+    memcpy (pMem, &hdr, sizeof (hdr));
+
+    m_pMem = (uint8_t*) pMem;
+    m_mapSize = mapSize;
+    m_numBytes.store (sizeof (hdr), std::memory_order_relaxed);
+    m_numRecords.store (0, std::memory_order_relaxed);
+    m_numDropped.store (0, std::memory_order_relaxed);
+    m_fileName = fileName;
+    m_enabled.store (true, std::memory_order_release);
+    return 0;
+  }
+
+  int32_t NiCapture::Close (void)
+  {
+    if (m_pMem == NULL)
+      {
+        return 0;
+      }
+    m_enabled.store (false, std::memory_order_release);
+
+    const uint64_t numBytes = m_numBytes.load (std::memory_order_acquire);
+    munmap (m_pMem, m_mapSize);
+    // drop the unused preallocated space
+    if ((numBytes < m_mapSize) && (ftruncate (m_fd, numBytes) < 0))
+      {
+        printf ("ERROR: NiCapture::Close() -> ftruncate() for %s errno=%i: %s\n", m_fileName.c_str (), errno, strerror (errno));
+      }
+    close (m_fd);
+    m_pMem = NULL;
+    m_fd = -1;
+    printf ("NiCapture: %lu records (%lu bytes) written to %s, %lu dropped\n",
+            (unsigned long) GetNumRecords (), (unsigned long) numBytes, m_fileName.c_str (), (unsigned long) GetNumDropped ());
+    return 0;
+  }
+
+  void NiCapture::Write (enum NiCaptureDirection direction, enum NiCaptureChannel channel, uint32_t instance,
+                         const std::string& context, const struct iovec* pIov, int32_t iovCnt)
+  {
+    const uint64_t timeNs = NiUtils::GetSysTimeNs ();
+
+    uint32_t len = 0;
+    for (int32_t i = 0; i < iovCnt; i++)
+      {
+        len += pIov[i].iov_len;
+      }
+    const uint64_t recordSize = sizeof (NiCaptureRecordHeader) + sizeof (NiCapturePseudoHeader) + len;
+
+    // reserve the space of the record, records which do not fit anymore are dropped
+    uint64_t offset = m_numBytes.load (std::memory_order_relaxed);
+    do
+      {
+        if ((m_pMem == NULL) || (len > NI_CAPTURE__MAX_MSG_SIZE) || (offset + recordSize > m_mapSize))
+          {
+            m_numDropped.fetch_add (1, std::memory_order_relaxed);
+            return;
+          }
+      }
+    while (!m_numBytes.compare_exchange_weak (offset, offset + recordSize, std::memory_order_relaxed));
+
+    // records are not aligned in the file, the headers are copied
+    NiCapturePseudoHeader pseudoHdr;
+    memset (&pseudoHdr, 0, sizeof (pseudoHdr));
+    pseudoHdr.direction = direction;
+    pseudoHdr.channel = channel;
+    pseudoHdr.instance = instance;
+    strncpy (pseudoHdr.context, context.c_str (), sizeof (pseudoHdr.context));
+
+    NiCaptureRecordHeader recordHdr;
+    recordHdr.timeSec = timeNs / 1000000000ULL;
+    recordHdr.timeNsec = timeNs % 1000000000ULL;
+    recordHdr.inclLen = 0;
+    recordHdr.origLen = sizeof (pseudoHdr) + len;
+
+    uint8_t* pRecord = m_pMem + offset;
+    memcpy (pRecord, &recordHdr, sizeof (recordHdr));
+    memcpy (pRecord + sizeof (recordHdr), &pseudoHdr, sizeof (pseudoHdr));
+    uint8_t* pData = pRecord + sizeof (recordHdr) + sizeof (pseudoHdr);
+    for (int32_t i = 0; i < iovCnt; i++)
+      {
+        memcpy (pData, pIov[i].iov_base, pIov[i].iov_len);
+        pData += pIov[i].iov_len;
+      }
+    // the record is complete in the file as soon as its length is set, even if the process is killed
+    std::atomic_signal_fence (std::memory_order_release);
+    recordHdr.inclLen = recordHdr.origLen;
+    memcpy (pRecord + offsetof (NiCaptureRecordHeader, inclLen), &recordHdr.inclLen, sizeof (recordHdr.inclLen));
+    m_numRecords.fetch_add (1, std::memory_order_relaxed);
+  }
+
+  void NiCapture::Write (enum NiCaptureDirection direction, enum NiCaptureChannel channel, uint32_t instance,
+                         const std::string& context, const uint8_t* pBufU8, uint32_t len)
+  {
+    struct iovec iov;
+    iov.iov_base = (void*) pBufU8;
+    iov.iov_len = len;
+    Write (direction, channel, instance, context, &iov, 1);
+  }
+
+  uint64_t NiCapture::GetNumRecords (void) const
+  {
+    return m_numRecords.load (std::memory_order_relaxed);
+  }
+
+  uint64_t NiCapture::GetNumDropped (void) const
+  {
+    return m_numDropped.load (std::memory_order_relaxed);
+  }
+
+  int32_t NiCapture::ReadFile (std::string fileName, std::vector<NiCaptureRecord>* pRecords)
+  {
+    errno = 0;
+    FILE* pFile = fopen (fileName.c_str (), "rb");
+    if (pFile == NULL)
+      {
+        printf ("ERROR: NiCapture::ReadFile() -> fopen() for %s errno=%i: %s\n", fileName.c_str (), errno, strerror (errno));
+        return -1;
+      }
+
+    NiCaptureFileHeader hdr;
+    if ((fread (&hdr, sizeof (hdr), 1, pFile) != 1) ||
+        (hdr.magic != NI_CAPTURE__PCAP_MAGIC_NS) || (hdr.linkType != NI_CAPTURE__PCAP_LINKTYPE))
+      {
+        printf ("ERROR: NiCapture::ReadFile() -> %s is no NI capture file\n", fileName.c_str ());
+        fclose (pFile);
+        return -1;
+      }
+
+    pRecords->clear ();
+    NiCaptureRecordHeader recordHdr;
+    while (fread (&recordHdr, sizeof (recordHdr), 1, pFile) == 1)
+      {
+        NiCaptureRecord record;
+        if ((recordHdr.inclLen < sizeof (record.hdr)) ||
+            (fread (&record.hdr, sizeof (record.hdr), 1, pFile) != 1))
+          {
+            break;
+          }
+        record.timeNs = (uint64_t) recordHdr.timeSec * 1000000000ULL + recordHdr.timeNsec;
+        record.data.resize (recordHdr.inclLen - sizeof (record.hdr));
+        if (!record.data.empty () && (fread (record.data.data (), record.data.size (), 1, pFile) != 1))
+          {
+            // record of an aborted capture
+            break;
+          }
+        pRecords->push_back (record);
+      }
+    fclose (pFile);
+    return 0;
+  }
+
+  const char* NiCapture::GetDirectionName (uint8_t direction)
+  {
+    return (direction == NI_CAPTURE_DIR_TX) ? "TX" : "RX";
+  }
+
+  const char* NiCapture::GetChannelName (uint8_t channel)
+  {
+    switch (channel)
+      {
+        case NI_CAPTURE_CHANNEL_PIPE_TIMING_IND: return "PipeTimingInd";
+        case NI_CAPTURE_CHANNEL_PIPE_TX:         return "PipeTx";
+        case NI_CAPTURE_CHANNEL_PIPE_RX:         return "PipeRx";
+        case NI_CAPTURE_CHANNEL_UDP:             return "Udp";
+        default:                                 return "Unknown";
+      }
+  }
+
+  //======================================================================================
+  // replay
+  //======================================================================================
+
+  NiCaptureReplay::NiCaptureReplay ()
+  : m_target (NI_CAPTURE_REPLAY_PIPE),
+    m_instanceId (0),
+    m_udpPort (0),
+    m_speed (1.0),
+    m_fdTimingInd (-1),
+    m_fdTx (-1),
+    m_fdMaxTx (0),
+    m_fdRx (-1),
+    m_sockFd (-1),
+    m_pDrainBufU8 (NULL),
+    m_open (false),
+    m_stop (false)
+  {
+    memset (&m_udpAddr, 0, sizeof (m_udpAddr));
+  }
+
+  NiCaptureReplay::~NiCaptureReplay ()
+  {
+    Close ();
+  }
+
+void
+NiCaptureReplay::SetTarget (enum NiCaptureReplayTarget target)
+{
+  m_target = target;
+}
+
+void
+NiCaptureReplay::SetInstanceId (uint32_t instanceId)
+{
+  m_instanceId = instanceId;
+}
+
+void
+NiCaptureReplay::SetUdpDestination (std::string context, std::string ipAddr, uint32_t port)
+{
+  m_udpContext = context;
+  m_udpIpAddr = ipAddr;
+  m_udpPort = port;
+}
+
+void
+NiCaptureReplay::SetSpeed (double speed)
+{
+  m_speed = speed;
+}
+
+int32_t
+NiCaptureReplay::Open (void)
+{
+  m_pDrainBufU8 = new uint8_t[NI_COMMON_CONST_MAX_PAYLOAD_SIZE];
+  m_open = true;
+
+  if (m_target == NI_CAPTURE_REPLAY_UDP)
+    {
+      m_sockFd = socket (AF_INET, SOCK_DGRAM, 0);
+      m_udpAddr.sin_family = AF_INET;
+      m_udpAddr.sin_port = htons (m_udpPort);
+      if ((m_sockFd < 0) || (inet_pton (AF_INET, m_udpIpAddr.c_str (), &m_udpAddr.sin_addr) != 1))
+        {
+          NI_LOG_CONSOLE_INFO ("NiCaptureReplay: could not open UDP socket to " << m_udpIpAddr << ":" << m_udpPort);
+          return -1;
+        }
+      return 0;
+    }
+
+  if (m_target == NI_CAPTURE_REPLAY_SHM)
+    {
+      NI_LOG_CONSOLE_INFO ("NiCaptureReplay: creating shared memory rings of instance " << m_instanceId);
+      if ((m_timingIndRing.Create (NiShmTransport::GetShmRingName (m_instanceId, NI_PIPE_IDX_TIMING_IND), NI_SHM_RING_DATA_SIZE) < 0) ||
+          (m_txRing.Create (NiShmTransport::GetShmRingName (m_instanceId, NI_PIPE_IDX_TX), NI_SHM_RING_DATA_SIZE) < 0) ||
+          (m_rxRing.Create (NiShmTransport::GetShmRingName (m_instanceId, NI_PIPE_IDX_RX), NI_SHM_RING_DATA_SIZE) < 0))
+        {
+          return -1;
+        }
+      return 0;
+    }
+
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      m_pipeNames[i] = NiPipeTransport::GetPipeName (m_instanceId, i);
+      NiPipe::OpenFifo ((char*)m_pipeNames[i].c_str ());
+    }
+  NI_LOG_CONSOLE_INFO ("NiCaptureReplay: creating named pipes of instance " << m_instanceId << ", waiting for L2 to connect");
+  // the transport opens the tx pipe first, the open of the other pipes blocks until it is connected
+  if ((NiPipe::OpenPipeForRx ((char*)m_pipeNames[NI_PIPE_IDX_TX].c_str (), &m_fdTx, &m_readFdsTx, &m_fdMaxTx) < 0) ||
+      (NiPipe::OpenPipeForTx ((char*)m_pipeNames[NI_PIPE_IDX_TIMING_IND].c_str (), &m_fdTimingInd) < 0) ||
+      (NiPipe::OpenPipeForTx ((char*)m_pipeNames[NI_PIPE_IDX_RX].c_str (), &m_fdRx) < 0))
+    {
+      return -1;
+    }
+  NI_LOG_CONSOLE_INFO ("NiCaptureReplay: L2 connected");
+  return 0;
+}
+
+void
+NiCaptureReplay::Close (void)
+{
+  if (!m_open)
+    {
+      return;
+    }
+  if (m_target == NI_CAPTURE_REPLAY_UDP)
+    {
+      if (m_sockFd >= 0)
+        {
+          close (m_sockFd);
+          m_sockFd = -1;
+        }
+    }
+  else if (m_target == NI_CAPTURE_REPLAY_SHM)
+    {
+      m_timingIndRing.Close ();
+      m_txRing.Close ();
+      m_rxRing.Close ();
+    }
+  else
+    {
+      NiPipe::ClosePipe (&m_fdTimingInd);
+      NiPipe::ClosePipe (&m_fdTx);
+      NiPipe::ClosePipe (&m_fdRx);
+      for (uint32_t i = 0; i < 3; i++)
+        {
+          NiPipe::CloseFifo ((char*)m_pipeNames[i].c_str ());
+        }
+    }
+  delete [] m_pDrainBufU8;
+  m_pDrainBufU8 = NULL;
+  m_open = false;
+}
+
+// messages ns-3 received from the replaced PHY / peer
+bool
+NiCaptureReplay::IsReplayed (const NiCaptureRecord& record) const
+{
+  if (record.hdr.direction != NI_CAPTURE_DIR_RX)
+    {
+      return false;
+    }
+  if (m_target == NI_CAPTURE_REPLAY_UDP)
+    {
+      return (record.hdr.channel == NI_CAPTURE_CHANNEL_UDP) &&
+             (strncmp (record.hdr.context, m_udpContext.c_str (), sizeof (record.hdr.context)) == 0);
+    }
+  return (record.hdr.channel != NI_CAPTURE_CHANNEL_UDP) && (record.hdr.instance == m_instanceId);
+}
+
+// messages ns-3 sent to the replaced PHY, drained and compared during the replay
+bool
+NiCaptureReplay::IsRecordedTx (const NiCaptureRecord& record) const
+{
+  return (m_target != NI_CAPTURE_REPLAY_UDP) && (record.hdr.direction == NI_CAPTURE_DIR_TX) &&
+         (record.hdr.channel == NI_CAPTURE_CHANNEL_PIPE_TX) && (record.hdr.instance == m_instanceId);
+}
+
+void
+NiCaptureReplay::Send (const NiCaptureRecord& record)
+{
+  uint8_t* pBufU8 = (uint8_t*) record.data.data ();
+  const uint32_t len = record.data.size ();
+  if (m_target == NI_CAPTURE_REPLAY_UDP)
+    {
+      sendto (m_sockFd, pBufU8, len, 0, (struct sockaddr *)&m_udpAddr, sizeof (m_udpAddr));
+    }
+  else if (m_target == NI_CAPTURE_REPLAY_SHM)
+    {
+      struct iovec iov;
+      iov.iov_base = pBufU8;
+      iov.iov_len = len;
+      NiShmRing* pRing = (record.hdr.channel == NI_CAPTURE_CHANNEL_PIPE_TIMING_IND) ? &m_timingIndRing : &m_rxRing;
+      pRing->Write (&iov, 1);
+    }
+  else
+    {
+      int32_t* pFd = (record.hdr.channel == NI_CAPTURE_CHANNEL_PIPE_TIMING_IND) ? &m_fdTimingInd : &m_fdRx;
+      NiPipe::PipeWrite (pFd, pBufU8, len);
+    }
+  m_stats.numReplayed++;
+  m_stats.numReplayedBytes += len;
+}
+
+// reads the requests ns-3 sends, so that the transport never blocks on a full pipe / ring
+void
+NiCaptureReplay::DrainTx (void)
+{
+  if (m_target == NI_CAPTURE_REPLAY_UDP)
+    {
+      return;
+    }
+  int32_t nread;
+  do
+    {
+      if (m_target == NI_CAPTURE_REPLAY_SHM)
+        {
+          nread = m_txRing.Read (m_pDrainBufU8, NI_COMMON_CONST_MAX_PAYLOAD_SIZE);
+        }
+      else
+        {
+          nread = NiPipe::PipeReadOnce (&m_fdTx, m_pDrainBufU8, NI_COMMON_CONST_MAX_PAYLOAD_SIZE);
+        }
+      if (nread > 0)
+        {
+          m_stats.numDrainedTx++;
+          m_stats.numDrainedTxBytes += nread;
+        }
+    }
+  while (nread > 0);
+}
+
+// sleeps until shortly before the replay time, drains meanwhile and spins the rest
+void
+NiCaptureReplay::WaitUntil (uint64_t timeNs)
+{
+  const uint64_t spinNs = 50000;
+  const uint64_t drainPeriodNs = 100000;
+  uint64_t nowNs = NiUtils::GetSysTimeNs ();
+  while ((nowNs + spinNs < timeNs) && !m_stop)
+    {
+      DrainTx ();
+      const uint64_t sleepNs = std::min (timeNs - spinNs - nowNs, drainPeriodNs);
+      const struct timespec ts = {0, (long) sleepNs};
+      nanosleep (&ts, NULL);
+      nowNs = NiUtils::GetSysTimeNs ();
+    }
+  while ((nowNs < timeNs) && !m_stop)
+    {
+      nowNs = NiUtils::GetSysTimeNs ();
+    }
+}
+
+uint64_t
+NiCaptureReplay::Run (const std::vector<NiCaptureRecord>& records)
+{
+  const uint64_t lateThresholdNs = 100000;
+  uint64_t firstRecordNs = 0;
+  bool first = true;
+  const uint64_t startNs = NiUtils::GetSysTimeNs ();
+
+  for (std::vector<NiCaptureRecord>::const_iterator it = records.begin (); (it != records.end ()) && !m_stop; ++it)
+    {
+      if (IsRecordedTx (*it))
+        {
+          m_stats.numRecordedTx++;
+          m_stats.numRecordedTxBytes += it->data.size ();
+          continue;
+        }
+      if (!IsReplayed (*it))
+        {
+          continue;
+        }
+      if (first)
+        {
+          firstRecordNs = it->timeNs;
+          first = false;
+        }
+
+      // replay time relative to the first replayed record, scaled by the speed factor
+      if (m_speed > 0)
+        {
+          const uint64_t replayNs = startNs + (uint64_t)((it->timeNs - firstRecordNs) / m_speed);
+          WaitUntil (replayNs);
+          const uint64_t nowNs = NiUtils::GetSysTimeNs ();
+          const uint64_t lateNs = (nowNs > replayNs) ? (nowNs - replayNs) : 0;
+          if (lateNs > lateThresholdNs) m_stats.numLate++;
+          m_stats.sumLateNs += lateNs;
+          if (lateNs > m_stats.maxLateNs) m_stats.maxLateNs = lateNs;
+        }
+      Send (*it);
+      DrainTx ();
+    }
+
+  // let ns-3 answer the last indications
+  WaitUntil (NiUtils::GetSysTimeNs () + 10000000);
+  DrainTx ();
+  m_stats.durationNs = NiUtils::GetSysTimeNs () - startNs;
+  return m_stats.numReplayed;
+}
+
+void
+NiCaptureReplay::Stop (void)
+{
+  m_stop = true;
+}
+
+void
+NiCaptureReplay::PrintStats (void)
+{
+  NI_LOG_CONSOLE_INFO ("\n-------- NI Capture Replay Statistics --------");
+  NI_LOG_CONSOLE_INFO ("Replayed           = " << m_stats.numReplayed << " messages (" << m_stats.numReplayedBytes << " bytes, speed " << m_speed << ")");
+  NI_LOG_CONSOLE_INFO ("Duration           = " << m_stats.durationNs / 1e6 << " ms");
+  if (m_stats.numReplayed > 0)
+    {
+      NI_LOG_CONSOLE_INFO ("Pacing late        = avg " << (m_stats.sumLateNs / m_stats.numReplayed) / 1000.0 <<
+                           " us, max " << m_stats.maxLateNs / 1000.0 << " us, > 100 us: " << m_stats.numLate);
+    }
+  if (m_target != NI_CAPTURE_REPLAY_UDP)
+    {
+      NI_LOG_CONSOLE_INFO ("TX recorded        = " << m_stats.numRecordedTx << " writes (" << m_stats.numRecordedTxBytes << " bytes)");
+      NI_LOG_CONSOLE_INFO ("TX drained         = " << m_stats.numDrainedTx << " reads (" << m_stats.numDrainedTxBytes << " bytes)");
+    }
+  NI_LOG_CONSOLE_INFO ("----------------------------------------------\n");
+}
+
+} // namespace ns3
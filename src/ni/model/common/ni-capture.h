@@ -0,0 +1,262 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#ifndef SRC_NI_MODEL_COMMON_NI_CAPTURE_H_
+#define SRC_NI_MODEL_COMMON_NI_CAPTURE_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <sys/select.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+
+#include "ni-shm-ring.h"
+
+namespace ns3 {
+
+  // direction seen from ns-3
+  enum NiCaptureDirection
+  {
+    NI_CAPTURE_DIR_TX = 0,               // sent by ns-3 to the PHY / peer
+    NI_CAPTURE_DIR_RX = 1                // received by ns-3
+  };
+
+  // transport channel of a captured message, the pipe channels equal NI_PIPE_IDX_*
+  enum NiCaptureChannel
+  {
+    NI_CAPTURE_CHANNEL_PIPE_TIMING_IND = 0,
+    NI_CAPTURE_CHANNEL_PIPE_TX         = 1,
+    NI_CAPTURE_CHANNEL_PIPE_RX         = 2,
+    NI_CAPTURE_CHANNEL_UDP             = 3
+  };
+
+  // nanosecond resolution pcap file with a user link type, so that the
+  // files can also be opened by pcap tools
+#define NI_CAPTURE__PCAP_MAGIC_NS     0xA1B23C4D
+#define NI_CAPTURE__PCAP_LINKTYPE     147           // LINKTYPE_USER0
+#define NI_CAPTURE__MAX_MSG_SIZE      (1 << 16)
+#define NI_CAPTURE__DEFAULT_MAX_BYTES (256ULL << 20) // preallocated file size if no maximum is given
+
+  // pcap file header
+  typedef struct sNiCaptureFileHeader {
+    uint32_t magic;
+    uint16_t versionMajor;
+    uint16_t versionMinor;
+    int32_t thisZone;
+    uint32_t sigFigs;
+    uint32_t snapLen;
+    uint32_t linkType;
+  } NiCaptureFileHeader;
+
+  // pcap record header, the time is the monotonic system time (NiUtils::GetSysTimeNs),
+  // inclLen is written last - it stays 0 for an incomplete record of an aborted run
+  typedef struct sNiCaptureRecordHeader {
+    uint32_t timeSec;
+    uint32_t timeNsec;
+    uint32_t inclLen;
+    uint32_t origLen;
+  } NiCaptureRecordHeader;
+
+  // pseudo header in front of the raw message bytes of every record
+  typedef struct sNiCapturePseudoHeader {
+    uint8_t direction;                   // NiCaptureDirection
+    uint8_t channel;                     // NiCaptureChannel
+    uint16_t instance;                   // AFW instance of pipe channels
+    char context[4];                     // transport context, e.g. "LTE" or "WIFI"
+  } NiCapturePseudoHeader;
+
+  // one captured message as read back from a capture file
+  typedef struct sNiCaptureRecord {
+    uint64_t timeNs;
+    NiCapturePseudoHeader hdr;
+    std::vector<uint8_t> data;
+  } NiCaptureRecord;
+
+  // Capture of the L1-L2 API messages crossing the pipe / shared memory and UDP
+  // transports. Every read and every write of a transport becomes one record
+  // with direction, channel, timestamp and the raw bytes - a write may hold
+  // several messages, e.g. a config and a payload request. Records are copied
+  // into a preallocated, memory mapped file like the records of NiTrace, so
+  // capturing neither allocates nor blocks in a file write. Multiple threads
+  // may write concurrently, each reserves the space of its record atomically.
+  // Recordings are fed back by NiCaptureReplay, e.g. via the ni-capture-replay example.
+  class NiCapture
+  {
+  public:
+    NiCapture ();
+    virtual
+    ~NiCapture ();
+
+    // an existing file is replaced and maxBytes are preallocated (0 = NI_CAPTURE__DEFAULT_MAX_BYTES),
+    // records beyond are dropped and the file is truncated to the written records on Close()
+    int32_t Open (std::string fileName, uint64_t maxBytes);
+    int32_t Close (void);
+
+    bool IsEnabled (void) const
+    {
+      return m_enabled.load (std::memory_order_relaxed);
+    }
+
+    void Write (enum NiCaptureDirection direction, enum NiCaptureChannel channel, uint32_t instance,
+                const std::string& context, const struct iovec* pIov, int32_t iovCnt);
+    void Write (enum NiCaptureDirection direction, enum NiCaptureChannel channel, uint32_t instance,
+                const std::string& context, const uint8_t* pBufU8, uint32_t len);
+
+    uint64_t GetNumRecords (void) const;
+    uint64_t GetNumDropped (void) const;
+
+    // reads all records of a capture file in the order they were written
+    static int32_t ReadFile (std::string fileName, std::vector<NiCaptureRecord>* pRecords);
+    static const char* GetDirectionName (uint8_t direction);
+    static const char* GetChannelName (uint8_t channel);
+
+  private:
+    std::atomic<bool> m_enabled;
+    uint8_t* m_pMem;
+    size_t m_mapSize;
+    int32_t m_fd;
+    std::atomic<uint64_t> m_numBytes;    // end of the reserved records in the file
+    std::atomic<uint64_t> m_numRecords;
+    std::atomic<uint64_t> m_numDropped;
+    std::string m_fileName;
+  };
+
+  extern NiCapture g_NiCapture;
+
+  // replay targets - the role of the PHY (pipes / shared memory rings) or of the UDP peer
+  enum NiCaptureReplayTarget
+  {
+    NI_CAPTURE_REPLAY_PIPE = 0,
+    NI_CAPTURE_REPLAY_SHM  = 1,
+    NI_CAPTURE_REPLAY_UDP  = 2
+  };
+
+  typedef struct sNiCaptureReplayStats {
+    uint64_t numReplayed      = 0;       // messages sent to ns-3
+    uint64_t numReplayedBytes = 0;
+    uint64_t numRecordedTx    = 0;       // writes of ns-3 recorded on the tx channel of the instance
+    uint64_t numRecordedTxBytes = 0;
+    uint64_t numDrainedTx     = 0;       // reads of ns-3 requests during the replay (pipe / shm)
+    uint64_t numDrainedTxBytes = 0;
+    uint64_t numLate          = 0;       // messages sent more than 100 us after their replay time
+    uint64_t sumLateNs        = 0;
+    uint64_t maxLateNs        = 0;
+    uint64_t durationNs       = 0;
+  } NiCaptureReplayStats;
+
+  // Feeds the received messages of a recording back to ns-3 with the original
+  // pacing or accelerated by a speed factor, so that a recorded run can be
+  // repeated deterministically without radios. For pipes and shared memory
+  // rings the replay takes the role of the PHY of one AFW instance and drains
+  // the requests ns-3 sends; for UDP it takes the role of the peer and sends
+  // the recorded datagrams of one context to the ns-3 rx port.
+  class NiCaptureReplay
+  {
+  public:
+    NiCaptureReplay ();
+    virtual
+    ~NiCaptureReplay ();
+
+    // configuration - has to be done before Open
+    void SetTarget (enum NiCaptureReplayTarget target);
+    void SetInstanceId (uint32_t instanceId);
+    // recorded UDP messages of this context are sent to the address
+    void SetUdpDestination (std::string context, std::string ipAddr, uint32_t port);
+    // 1 = original pacing, 2 = twice as fast, 0 = as fast as possible
+    void SetSpeed (double speed);
+
+    // creates the pipes / rings and waits for ns-3 to connect, or opens the UDP socket
+    int32_t Open (void);
+    void Close (void);
+    // replays the records matching the target, returns the number of replayed messages
+    uint64_t Run (const std::vector<NiCaptureRecord>& records);
+    // async signal safe
+    void Stop (void);
+
+    const NiCaptureReplayStats& GetStats (void) const { return m_stats; }
+    void PrintStats (void);
+
+  private:
+    bool IsReplayed (const NiCaptureRecord& record) const;
+    bool IsRecordedTx (const NiCaptureRecord& record) const;
+    void Send (const NiCaptureRecord& record);
+    void DrainTx (void);
+    void WaitUntil (uint64_t timeNs);
+
+    // configuration
+    enum NiCaptureReplayTarget m_target;
+    uint32_t m_instanceId;
+    std::string m_udpContext;
+    std::string m_udpIpAddr;
+    uint32_t m_udpPort;
+    double m_speed;
+
+    // transport
+    std::string m_pipeNames[3];
+    int32_t m_fdTimingInd;
+    int32_t m_fdTx;
+    fd_set m_readFdsTx;
+    int32_t m_fdMaxTx;
+    int32_t m_fdRx;
+    NiShmRing m_timingIndRing;
+    NiShmRing m_txRing;
+    NiShmRing m_rxRing;
+    int32_t m_sockFd;
+    struct sockaddr_in m_udpAddr;
+    uint8_t* m_pDrainBufU8;
+    bool m_open;
+
+    std::atomic<bool> m_stop;
+    NiCaptureReplayStats m_stats;
+  };
+
+/**
+ * Use \ref to capture a message if capturing is enabled
+ *
+ * \param [in] direction NiCaptureDirection of the message.
+ * \param [in] channel NiCaptureChannel of the message.
+ * \param [in] instance AFW instance.
+ * \param [in] context Transport context.
+ * \param [in] ... Either iovec array and count or buffer and length.
+ */
+#define NI_CAPTURE(direction, channel, instance, context, ...) \
+{\
+  if (g_NiCapture.IsEnabled ()) \
+    {\
+      g_NiCapture.Write (direction, channel, instance, context, __VA_ARGS__);\
+    }\
+}\
+
+#define NiCaptureInit(CaptureFileName, MaxBytes) \
+{\
+  g_NiCapture.Open (CaptureFileName, MaxBytes);\
+}\
+
+#define NiCaptureDeInit() \
+{\
+  g_NiCapture.Close ();\
+}\
+
+} // namespace ns3
+
+#endif /* SRC_NI_MODEL_COMMON_NI_CAPTURE_H_ */
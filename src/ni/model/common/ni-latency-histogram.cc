@@ -0,0 +1,253 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#include <sstream>
+#include <iomanip>
+
+#include "ni-logging.h"
+#include "ni-latency-histogram.h"
+
+namespace ns3
+{
+
+  // global histograms, written by the simulator and the transport threads
+  NiLatencyHistograms g_NiLatency;
+
+  NiLatencySnapshot::NiLatencySnapshot ()
+  : m_counts (NI_LATENCY__NUM_BUCKETS, 0),
+    m_count (0),
+    m_sumNs (0),
+    m_maxNs (0)
+  {
+  }
+
+  double
+  NiLatencySnapshot::GetMeanNs (void) const
+  {
+    return (m_count > 0) ? (double) m_sumNs / m_count : 0.0;
+  }
+
+  uint64_t
+  NiLatencySnapshot::GetPercentileNs (double percentile) const
+  {
+    if (m_count == 0)
+      {
+        return 0;
+      }
+    uint64_t rank = (uint64_t) (percentile / 100.0 * m_count + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > m_count) rank = m_count;
+
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < NI_LATENCY__NUM_BUCKETS; i++)
+      {
+        sum += m_counts[i];
+        if (sum >= rank)
+          {
+            // the bucket bound can exceed the largest recorded value
+            const uint64_t upperBound = NiLatencyHistograms::GetBucketUpperBound (i);
+            return (upperBound < m_maxNs) ? upperBound : m_maxNs;
+          }
+      }
+    return m_maxNs;
+  }
+
+  std::string
+  NiLatencySnapshot::ToString (void) const
+  {
+    std::stringstream str;
+    str << std::fixed << std::setprecision (1)
+        << "count " << m_count
+        << ", mean " << GetMeanNs () / 1000.0
+        << ", p50 " << GetPercentileNs (50.0) / 1000.0
+        << ", p90 " << GetPercentileNs (90.0) / 1000.0
+        << ", p99 " << GetPercentileNs (99.0) / 1000.0
+        << ", p99.9 " << GetPercentileNs (99.9) / 1000.0
+        << ", p99.99 " << GetPercentileNs (99.99) / 1000.0
+        << ", max " << m_maxNs / 1000.0 << " us";
+    return str.str ();
+  }
+
+  std::atomic<uint64_t> NiLatencyHistograms::m_nextInstanceId (1);
+
+  NiLatencyHistograms::NiLatencyHistograms ()
+  : m_instanceId (m_nextInstanceId.fetch_add (1))
+  {
+    pthread_mutex_init (&m_mutex, NULL);
+  }
+
+  NiLatencyHistograms::~NiLatencyHistograms ()
+  {
+    for (uint32_t i = 0; i < m_threadBuckets.size (); i++)
+      {
+        delete m_threadBuckets[i];
+      }
+    pthread_mutex_destroy (&m_mutex);
+  }
+
+  uint32_t
+  NiLatencyHistograms::GetBucketIndex (uint64_t valueNs)
+  {
+    const uint32_t subBuckets = 1 << NI_LATENCY__SUB_BUCKET_BITS;
+    if (valueNs < subBuckets)
+      {
+        return valueNs;
+      }
+    const uint32_t magnitude = 63 - __builtin_clzll (valueNs);
+    if (magnitude >= NI_LATENCY__MAX_MAGNITUDE)
+      {
+        return NI_LATENCY__NUM_BUCKETS - 1;
+      }
+    const uint32_t shift = magnitude - NI_LATENCY__SUB_BUCKET_BITS;
+    return ((shift + 1) << NI_LATENCY__SUB_BUCKET_BITS) + (uint32_t) (valueNs >> shift) - subBuckets;
+  }
+
+  uint64_t
+  NiLatencyHistograms::GetBucketUpperBound (uint32_t index)
+  {
+    const uint32_t subBuckets = 1 << NI_LATENCY__SUB_BUCKET_BITS;
+    if (index < subBuckets)
+      {
+        return index;
+      }
+    const uint32_t shift = (index >> NI_LATENCY__SUB_BUCKET_BITS) - 1;
+    const uint64_t subBucket = (index & (subBuckets - 1)) + subBuckets;
+    return ((subBucket + 1) << shift) - 1;
+  }
+
+  NiLatencyThreadBuckets*
+  NiLatencyHistograms::GetThreadBuckets (void)
+  {
+    // buckets are kept until destruction, so the counts of terminated threads stay in the histograms
+    static __thread uint64_t threadOwner = 0;
+    static __thread NiLatencyThreadBuckets* threadBuckets = NULL;
+    if (threadOwner == m_instanceId)
+      {
+        return threadBuckets;
+      }
+
+    // first use by this thread or the thread switched between instances
+    const pthread_t threadId = pthread_self ();
+    pthread_mutex_lock (&m_mutex);
+    for (uint32_t t = 0; t < m_threadBuckets.size (); t++)
+      {
+        if (pthread_equal (m_threadBuckets[t]->threadId, threadId))
+          {
+            threadOwner = m_instanceId;
+            threadBuckets = m_threadBuckets[t];
+            pthread_mutex_unlock (&m_mutex);
+            return threadBuckets;
+          }
+      }
+    pthread_mutex_unlock (&m_mutex);
+
+    NiLatencyThreadBuckets* pBuckets = new NiLatencyThreadBuckets;
+    pBuckets->threadId = threadId;
+    for (uint32_t s = 0; s < NI_LATENCY_NUM_STAGES; s++)
+      {
+        for (uint32_t i = 0; i < NI_LATENCY__NUM_BUCKETS; i++)
+          {
+            pBuckets->counts[s][i].store (0, std::memory_order_relaxed);
+          }
+        pBuckets->sumNs[s].store (0, std::memory_order_relaxed);
+        pBuckets->maxNs[s].store (0, std::memory_order_relaxed);
+      }
+    pthread_mutex_lock (&m_mutex);
+    m_threadBuckets.push_back (pBuckets);
+    pthread_mutex_unlock (&m_mutex);
+    threadOwner = m_instanceId;
+    threadBuckets = pBuckets;
+    return threadBuckets;
+  }
+
+  void
+  NiLatencyHistograms::RegisterThread (void)
+  {
+    GetThreadBuckets ();
+  }
+
+  void
+  NiLatencyHistograms::Record (enum NiLatencyStage stage, uint64_t valueNs)
+  {
+    NiLatencyThreadBuckets* pBuckets = GetThreadBuckets ();
+    // single writer - plain load and store instead of an atomic increment
+    std::atomic<uint64_t>* pCount = &pBuckets->counts[stage][GetBucketIndex (valueNs)];
+    pCount->store (pCount->load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    pBuckets->sumNs[stage].store (pBuckets->sumNs[stage].load (std::memory_order_relaxed) + valueNs, std::memory_order_relaxed);
+    if (valueNs > pBuckets->maxNs[stage].load (std::memory_order_relaxed))
+      {
+        pBuckets->maxNs[stage].store (valueNs, std::memory_order_relaxed);
+      }
+  }
+
+  NiLatencySnapshot
+  NiLatencyHistograms::GetSnapshot (enum NiLatencyStage stage)
+  {
+    NiLatencySnapshot snapshot;
+    pthread_mutex_lock (&m_mutex);
+    for (uint32_t t = 0; t < m_threadBuckets.size (); t++)
+      {
+        const NiLatencyThreadBuckets* pBuckets = m_threadBuckets[t];
+        for (uint32_t i = 0; i < NI_LATENCY__NUM_BUCKETS; i++)
+          {
+            const uint64_t count = pBuckets->counts[stage][i].load (std::memory_order_relaxed);
+            snapshot.m_counts[i] += count;
+            snapshot.m_count += count;
+          }
+        snapshot.m_sumNs += pBuckets->sumNs[stage].load (std::memory_order_relaxed);
+        const uint64_t maxNs = pBuckets->maxNs[stage].load (std::memory_order_relaxed);
+        if (maxNs > snapshot.m_maxNs)
+          {
+            snapshot.m_maxNs = maxNs;
+          }
+      }
+    pthread_mutex_unlock (&m_mutex);
+    return snapshot;
+  }
+
+  void
+  NiLatencyHistograms::Print (void)
+  {
+    for (uint32_t s = 0; s < NI_LATENCY_NUM_STAGES; s++)
+      {
+        const NiLatencySnapshot snapshot = GetSnapshot ((enum NiLatencyStage) s);
+        if (snapshot.GetCount () > 0)
+          {
+            NI_LOG_CONSOLE_INFO(GetStageName ((enum NiLatencyStage) s) << ": " << snapshot.ToString ());
+          }
+      }
+  }
+
+  const char*
+  NiLatencyHistograms::GetStageName (enum NiLatencyStage stage)
+  {
+    switch (stage)
+      {
+      case NI_LATENCY_SUBFRAME_TIMING_WAIT: return "SubframeTimingWait";
+      case NI_LATENCY_TX_CTRL_DATA_FRAME:   return "TxCtrlDataFrame";
+      case NI_LATENCY_PIPE_WRITE:           return "PipeWrite";
+      case NI_LATENCY_RX_HANDLER:           return "RxHandler";
+      case NI_LATENCY_PHY_TIME_DIFF:        return "PhyTimeDiff";
+      default:                              return "Unknown";
+      }
+  }
+
+} // namespace ns3
@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#ifndef SRC_NI_MODEL_COMMON_NI_LATENCY_HISTOGRAM_H_
+#define SRC_NI_MODEL_COMMON_NI_LATENCY_HISTOGRAM_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <pthread.h>
+
+namespace ns3 {
+
+  // measured stages of the LTE real-time loop
+  enum NiLatencyStage
+  {
+    NI_LATENCY_SUBFRAME_TIMING_WAIT = 0, // NiStartSubframe entry until the PHY timing indication was received
+    NI_LATENCY_TX_CTRL_DATA_FRAME,       // NiStartTxCtrlDataFrame, encoding and sending of the tx requests
+    NI_LATENCY_PIPE_WRITE,               // NiPipe::PipeWrite / PipeWriteV system call
+    NI_LATENCY_RX_HANDLER,               // rx thread, message read until the rx callback returned
+    NI_LATENCY_PHY_TIME_DIFF,            // absolute CalcPhyTimeDiff offset between simulator and PHY timing
+    NI_LATENCY_NUM_STAGES
+  };
+
+  // values below 2^NI_LATENCY__SUB_BUCKET_BITS ns are counted exactly, above each power
+  // of two range is split into 2^NI_LATENCY__SUB_BUCKET_BITS buckets (max. error 3 %)
+#define NI_LATENCY__SUB_BUCKET_BITS 5
+  // values of 2^NI_LATENCY__MAX_MAGNITUDE ns (18 min) and above go to the last bucket
+#define NI_LATENCY__MAX_MAGNITUDE 40
+#define NI_LATENCY__NUM_BUCKETS ((NI_LATENCY__MAX_MAGNITUDE - NI_LATENCY__SUB_BUCKET_BITS + 1) << NI_LATENCY__SUB_BUCKET_BITS)
+
+  // buckets of all stages recorded by one thread, only written by that thread
+  typedef struct sNiLatencyThreadBuckets {
+    pthread_t threadId;
+    std::atomic<uint64_t> counts[NI_LATENCY_NUM_STAGES][NI_LATENCY__NUM_BUCKETS];
+    std::atomic<uint64_t> sumNs[NI_LATENCY_NUM_STAGES];
+    std::atomic<uint64_t> maxNs[NI_LATENCY_NUM_STAGES];
+  } NiLatencyThreadBuckets;
+
+  // merged buckets of one stage
+  class NiLatencySnapshot
+  {
+  public:
+    NiLatencySnapshot ();
+
+    uint64_t GetCount (void) const { return m_count; }
+    uint64_t GetMaxNs (void) const { return m_maxNs; }
+    double GetMeanNs (void) const;
+    // smallest value which is larger or equal than percentile % of the values
+    uint64_t GetPercentileNs (double percentile) const;
+    // count, mean, p50, p90, p99, p99.9, p99.99 and max in us
+    std::string ToString (void) const;
+
+  private:
+    friend class NiLatencyHistograms;
+    std::vector<uint64_t> m_counts;
+    uint64_t m_count;
+    uint64_t m_sumNs;
+    uint64_t m_maxNs;
+  };
+
+  // Always-on, HDR-style log bucketed latency histograms. Each thread records
+  // into its own buckets without locks or read-modify-write instructions, the
+  // buckets of all threads are merged when a histogram is read.
+  class NiLatencyHistograms
+  {
+  public:
+    NiLatencyHistograms ();
+    ~NiLatencyHistograms ();
+
+    // allocates the buckets of the calling thread, so that its first Record does not allocate
+    void RegisterThread (void);
+    void Record (enum NiLatencyStage stage, uint64_t valueNs);
+    NiLatencySnapshot GetSnapshot (enum NiLatencyStage stage);
+    // prints the percentiles of all stages with recorded values
+    void Print (void);
+
+    static const char* GetStageName (enum NiLatencyStage stage);
+    static uint32_t GetBucketIndex (uint64_t valueNs);
+    // largest value counted in a bucket
+    static uint64_t GetBucketUpperBound (uint32_t index);
+
+  private:
+    NiLatencyThreadBuckets* GetThreadBuckets (void);
+
+    static std::atomic<uint64_t> m_nextInstanceId;
+    const uint64_t m_instanceId; // identifies the instance in the thread local cache
+    pthread_mutex_t m_mutex;     // guards m_threadBuckets
+    std::vector<NiLatencyThreadBuckets*> m_threadBuckets;
+  };
+
+  extern NiLatencyHistograms g_NiLatency;
+
+} // namespace ns3
+
+#endif /* SRC_NI_MODEL_COMMON_NI_LATENCY_HISTOGRAM_H_ */
@@ -47,30 +47,30 @@ namespace ns3 {
   {
     m_logIsEnable=false;
     m_fileOut="";
-    m_isFirstCall = true;
     m_syncToFileInstant = false;
     m_loglevelMask = LOG__NONE;
+    m_activeLevelMask = LOG__NONE;
+    m_suppressedLevelMask = LOG__NONE;
     m_curLogBufferEntry = 0;
     m_logThreadPriority = 0;
+    m_firstCallSysTimeNs = 0;
+    m_numRings = 0;
+    m_flagStopWriteThread = false;
+    m_countMsgCnsl = 0;
+    pthread_mutex_init (&m_logMutex, NULL);
   }
 
   NiLogging::~NiLogging(void)
   {
-
+    for (uint32_t i = 0; i < m_rings.size (); i++)
+      {
+        delete m_rings[i];
+      }
   }
 
   void
   NiLogging::Initialize (uint32_t loglevelMask, std::string fileName, int NiLoggingPriority)
   {
-    if(pthread_mutex_init (&m_logMutex, NULL) != 0)
-      {
-        std::cout <<"\nNiLogging::Initialize: Error calling pthread_mutex_init for log stream " << std::endl;
-      }
-    if(sem_init (&m_semMsgCount, 0, 0) != 0)
-      {
-        NS_FATAL_ERROR("\nNiLogging::Initialize: Error calling sem_init!");
-      }
-
     if (loglevelMask == LOG__NONE)
       {
         m_logIsEnable = false;
@@ -83,10 +83,9 @@ namespace ns3 {
     m_loglevelMask = loglevelMask;
 
     m_fileOut = fileName;
-    m_isFirstCall = true;
     m_filePtr.open(m_fileOut.c_str(), std::ios::out);
     m_filePtr << this->PrintHeader();
-    gettimeofday(&m_firstCallSysTime, NULL);
+    m_firstCallSysTimeNs = NiUtils::GetSysTimeNs ();
 
     m_flagStopWriteThread = false;
 
@@ -94,22 +93,174 @@ namespace ns3 {
     m_logThreadPriority = NiLoggingPriority;
     m_logThread = Create<SystemThread> (MakeCallback (&NiLogging::writeThread, this));
     m_logThread->Start ();
+
+    UpdateActiveLevelMask ();
+  }
+
+  void
+  NiLogging::SetSuppressedLevels (uint32_t levelMask)
+  {
+    m_suppressedLevelMask = levelMask;
+    // logging stays off before Initialize and after DeInitialize
+    if (m_activeLevelMask.load (std::memory_order_relaxed) != LOG__NONE)
+      {
+        UpdateActiveLevelMask ();
+      }
+  }
+
+  void
+  NiLogging::UpdateActiveLevelMask (void)
+  {
+    // fatal messages stop the system whenever logging is enabled and can not be suppressed
+    const uint32_t levelMask = (m_loglevelMask & ~m_suppressedLevelMask) | LOG__FATAL;
+    m_activeLevelMask.store (m_logIsEnable ? levelMask : LOG__NONE, std::memory_order_release);
   }
 
   void
   NiLogging::DeInitialize (void)
   {
+    m_activeLevelMask.store (LOG__NONE, std::memory_order_release);
     terminateWriteThread();
     WriteToFile();
-    pthread_mutex_destroy(&m_logMutex);
-    sem_destroy(&m_semMsgCount);
+
+    uint64_t numDropped = 0;
+    pthread_mutex_lock (&m_logMutex);
+    for (uint32_t i = 0; i < m_rings.size (); i++)
+      {
+        numDropped += m_rings[i]->GetNumDropped ();
+      }
+    pthread_mutex_unlock (&m_logMutex);
+    if (numDropped > 0)
+      {
+        std::cout << "NI.LOGGING: " << numDropped << " log records dropped due to full rings" << std::endl;
+      }
+  }
+
+  NiLogRecord*
+  NiLogging::GetWriteSlot (NiLogRing** pRing)
+  {
+    // rings are kept until destruction, so the pointer stays valid across re-initialization
+    static __thread NiLogRing* threadRing = NULL;
+    if (threadRing == NULL)
+      {
+        threadRing = new NiLogRing (NI_LOG__RING_SIZE);
+        pthread_mutex_lock (&m_logMutex);
+        m_rings.push_back (threadRing);
+        m_numRings.store (m_rings.size (), std::memory_order_release);
+        pthread_mutex_unlock (&m_logMutex);
+      }
+    *pRing = threadRing;
+
+    NiLogRecord* record = threadRing->GetWriteSlot ();
+    if (record != NULL)
+      {
+        InitRecord (record);
+      }
+    return record;
+  }
+
+  void
+  NiLogging::InitRecord (NiLogRecord* record)
+  {
+    record->simTimeStep = Simulator::Now().GetTimeStep();
+    record->sysTimeNs = NiUtils::GetSysTimeNs ();
+    record->argsLength = 0;
+    record->truncated = false;
   }
 
-  //Disable first call in write() function!!
   void
-  NiLogging::DisableFirstCall(void)
+  NiLogging::CommitWrite (NiLogRing* ring, NiLogRecord* record)
+  {
+    if (ring != NULL)
+      {
+        ring->CommitWrite ();
+      }
+
+    // stop system on FATAL ERROR and print out debugging info
+    if (record->site->logLevel == LOG__FATAL)
+      {
+        Fatal (record);
+      }
+  }
+
+  std::string
+  NiLogging::RenderMessage (const NiLogRecord* record)
   {
-    m_isFirstCall = false;
+    std::stringstream strStream;
+    const uint8_t* p = record->args;
+    const uint8_t* end = record->args + record->argsLength;
+
+    while (p < end)
+      {
+        const uint8_t type = *p++;
+        switch (type)
+          {
+          case NI_LOG_ARG_INT:
+            {
+              int64_t v;
+              memcpy (&v, p, sizeof (v));
+              p += sizeof (v);
+              strStream << v;
+              break;
+            }
+          case NI_LOG_ARG_UINT:
+            {
+              uint64_t v;
+              memcpy (&v, p, sizeof (v));
+              p += sizeof (v);
+              strStream << v;
+              break;
+            }
+          case NI_LOG_ARG_DOUBLE:
+            {
+              double v;
+              memcpy (&v, p, sizeof (v));
+              p += sizeof (v);
+              strStream << v;
+              break;
+            }
+          case NI_LOG_ARG_BOOL:
+            strStream << (bool) *p++;
+            break;
+          case NI_LOG_ARG_CHAR:
+            strStream << (char) *p++;
+            break;
+          case NI_LOG_ARG_PTR:
+            {
+              const void* v;
+              memcpy (&v, p, sizeof (v));
+              p += sizeof (v);
+              strStream << v;
+              break;
+            }
+          case NI_LOG_ARG_STRING:
+            {
+              uint16_t len;
+              memcpy (&len, p, sizeof (len));
+              p += sizeof (len);
+              strStream.write ((const char*) p, len);
+              p += len;
+              break;
+            }
+          case NI_LOG_ARG_MANIP:
+            {
+              std::ostream& (*manip)(std::ostream&);
+              memcpy (&manip, p, sizeof (manip));
+              p += sizeof (manip);
+              strStream << manip;
+              break;
+            }
+          default:
+            // corrupt record
+            p = end;
+            break;
+          }
+      }
+    if (record->truncated)
+      {
+        strStream << " [...]";
+      }
+    return strStream.str ();
   }
 
   //Thread which writes the log strings to file or buffer
@@ -117,185 +268,157 @@ namespace ns3 {
   NiLogging::writeThread()
   {
     NI_LOG_DEBUG("NI.LOGGING: logging thread with id:" << pthread_self() << " started");
-    NiUtils::AddThreadInfo (pthread_self(), "Nilogging thread");
-
     // Main thread that writes the buffers into the log file
-    // Now we reduce the priority of this thread
+    // Now we reduce the priority of this thread, the thread topology may override it
     NiUtils::SetThreadPrioriy(m_logThreadPriority);
+    NiUtils::AddThreadInfo (pthread_self(), "Nilogging thread");
 
-    const uint32_t numMsgflushCnsl = 4; // after this number of log messages the console will be flushed
-    uint32_t countMsgCnsl = 0;
+    std::vector<NiLogRing*> rings;
     while(true)
       {
-        niLogInfo logInfo;
-        std::stringstream msgBufferStream;
-        std::string timingInfo, sourceInfo, funcInfo;
-
-        if (sem_wait (&m_semMsgCount) < 0)
-          {
-            NS_FATAL_ERROR("\nNiLogging:writeThread::Error calling sem_wait!");
-          }
-        if(m_flagStopWriteThread)
-          {
-            //std::cout << "Terminating logging thread...\n" <<std::endl;
-            return;
-          }
-        if (pthread_mutex_lock (&m_logMutex) != 0)
-          {
-            NS_FATAL_ERROR("\nNiLogging::writeThread::Error calling pthread_mutex_lock!");
-          }
-        // get logging element from the queue
-        if(m_msgQueue.size() == 0)
+        // take over rings of threads which logged for the first time
+        if (rings.size () != m_numRings.load (std::memory_order_acquire))
           {
-            NS_FATAL_ERROR("\nNiLogging::writeThread::msgQueue length is zero!");
-          }
-        else
-          {
-            logInfo = m_msgQueue.front();
-            m_msgQueue.pop_front();
-          }
-        if (pthread_mutex_unlock (&m_logMutex) != 0)
-          {
-            NS_FATAL_ERROR("\nNiLogging::writeThread::Error calling pthread_mutex_lock!");
+            pthread_mutex_lock (&m_logMutex);
+            rings = m_rings;
+            pthread_mutex_unlock (&m_logMutex);
           }
 
-        funcInfo = ", " + logInfo.func + "(), ";
-        timingInfo = ", Sim(us)=" + std::to_string(logInfo.simTimeUs)  +  ", Sys(us)=" + std::to_string(logInfo.sysTimeUs);
-
-        if (logInfo.logLevel & m_loglevelMask)
+        // merge the records of all rings in system time order
+        uint32_t numWritten = 0;
+        while (true)
           {
-            switch (logInfo.logLevel) {
-              case LOG__NONE:
-                break;
-              case LOG__FATAL:
-                msgBufferStream << "[FATAL]" << timingInfo << sourceInfo << ", " << logInfo.buffer;
-                break;
-              case LOG__ERROR:
-                msgBufferStream << "[ERROR]" << timingInfo << funcInfo << logInfo.buffer;
-                break;
-              case LOG__WARN:
-                msgBufferStream << "[WARN ]" << timingInfo << funcInfo << logInfo.buffer;
-                break;
-              case LOG__INFO:
-                msgBufferStream << "[INFO ]" << timingInfo << funcInfo << logInfo.buffer;
-                break;
-              case LOG__DEBUG:
-                msgBufferStream << "[DEBUG]" << timingInfo << funcInfo << logInfo.buffer;
-                break;
-              case LOG__TRACE:
-                msgBufferStream << "[TRACE]" << ", " << logInfo.simTimeUs << "," << logInfo.sysTimeUs << ", " << logInfo.buffer;
-                break;
-              case LOG__CONSOLE_DEBUG:
-                msgBufferStream << "[CNSL ]" << timingInfo << funcInfo << logInfo.buffer;
-                std::cout << logInfo.buffer << std::endl;
-                if (countMsgCnsl % numMsgflushCnsl) fflush( stdout );
-                countMsgCnsl++;
-                break;
-              default:
-                NS_FATAL_ERROR("\nNiLogging::writeThread:: Error undefined loglevel:" << logInfo.logLevel);
-                break;
-            }
-
-            // Now we write to file pointer
-            if (m_syncToFileInstant)
+            NiLogRing* nextRing = NULL;
+            NiLogRecord* nextRecord = NULL;
+            for (uint32_t i = 0; i < rings.size (); i++)
               {
-                // write to file
-                m_filePtr << msgBufferStream.str() << std::endl;
+                NiLogRecord* record = rings[i]->GetReadSlot ();
+                if ((record != NULL) && ((nextRecord == NULL) || (record->sysTimeNs < nextRecord->sysTimeNs)))
+                  {
+                    nextRing = rings[i];
+                    nextRecord = record;
+                  }
               }
-            else
+            if (nextRecord == NULL)
+              {
+                break;
+              }
+            WriteRecord (nextRecord);
+            nextRing->CommitRead ();
+            numWritten++;
+          }
+
+        if (numWritten == 0)
+          {
+            // all rings drained - producers never wait for this thread
+            if (m_flagStopWriteThread.load (std::memory_order_acquire))
               {
-                // write into circular buffer
-                m_logStringBuffer[m_curLogBufferEntry].str(std::string()); // clear the stringstream
-                m_logStringBuffer[m_curLogBufferEntry] << msgBufferStream.str() << std::endl;
-                m_curLogBufferEntry =  (m_curLogBufferEntry+1) % NI_LOG__BUFFER_SIZE;
+                NiUtils::RemoveThreadInfo (pthread_self());
+                return;
               }
+            struct timespec ts = {0, 1000000};
+            nanosleep (&ts, NULL);
           }
       }
   }
 
   void
-  NiLogging::Write (const enum NiLogLevel logLevel, const std::string file, const int line, const std::string func, const std::string &buffer)
+  NiLogging::WriteRecord (const NiLogRecord* record)
   {
+    const std::string buffer = RenderMessage (record);
     if(buffer.length() <= 0)
       {
         return; //No need to log anything if the message field is zero
       }
 
-    struct timeval systime, timeDiff;
-    uint64_t simTimeUs, sysTimeUs;
-    niLogInfo logInfo;
-
-    // get system time
-    gettimeofday(&systime, NULL);
-    // get simulator time
-    simTimeUs = Simulator::Now().GetMicroSeconds();
-
-    //First call to write function
-    if(m_isFirstCall)
-      {
-        m_isFirstCall = false;
-        m_firstCallSysTime = systime;
-      }
-
-    // calc normalized system timing in us
-    timersub(&systime, &m_firstCallSysTime, &timeDiff);
-    sysTimeUs = timeDiff.tv_sec * 1000000 + timeDiff.tv_usec;
-
-    logInfo.simTimeUs = simTimeUs;
-    logInfo.sysTimeUs = sysTimeUs;
-    logInfo.logLevel = logLevel;
-    logInfo.file = file;
-    logInfo.line = line;
-    logInfo.func = func;
-    logInfo.buffer = buffer;
-
-    // put messages to logfile
-    if (pthread_mutex_lock (&m_logMutex) != 0)
-      {
-        NS_FATAL_ERROR("\nNiLogging::Write::Error calling pthread_mutex_lock!");
-      }
-
-    m_msgQueue.push_back(logInfo);
+    const NiLogSite* site = record->site;
+    const uint64_t sysTimeUs = (record->sysTimeNs > m_firstCallSysTimeNs) ? (record->sysTimeNs - m_firstCallSysTimeNs) / 1000 : 0;
+    const int64_t simTimeUs = Time (record->simTimeStep).GetMicroSeconds();
+    std::stringstream msgBufferStream;
+    const std::string funcInfo = std::string (", ") + site->func + "(), ";
+    const std::string timingInfo = ", Sim(us)=" + std::to_string(simTimeUs)  +  ", Sys(us)=" + std::to_string(sysTimeUs);
+    const uint32_t numMsgflushCnsl = 4; // after this number of log messages the console will be flushed
 
-    if (pthread_mutex_unlock (&m_logMutex) != 0)
+    switch (site->logLevel) {
+      case LOG__NONE:
+        break;
+      case LOG__FATAL:
+        msgBufferStream << "[FATAL]" << timingInfo << ", " << buffer;
+        break;
+      case LOG__ERROR:
+        msgBufferStream << "[ERROR]" << timingInfo << funcInfo << buffer;
+        break;
+      case LOG__WARN:
+        msgBufferStream << "[WARN ]" << timingInfo << funcInfo << buffer;
+        break;
+      case LOG__INFO:
+        msgBufferStream << "[INFO ]" << timingInfo << funcInfo << buffer;
+        break;
+      case LOG__DEBUG:
+        msgBufferStream << "[DEBUG]" << timingInfo << funcInfo << buffer;
+        break;
+      case LOG__TRACE:
+        msgBufferStream << "[TRACE]" << ", " << simTimeUs << "," << sysTimeUs << ", " << buffer;
+        break;
+      case LOG__CONSOLE_DEBUG:
+        msgBufferStream << "[CNSL ]" << timingInfo << funcInfo << buffer;
+        std::cout << buffer << std::endl;
+        if (m_countMsgCnsl % numMsgflushCnsl) fflush( stdout );
+        m_countMsgCnsl++;
+        break;
+      default:
+        NS_FATAL_ERROR("\nNiLogging::writeThread:: Error undefined loglevel:" << site->logLevel);
+        break;
+    }
+
+    // Now we write to file pointer
+    if (m_syncToFileInstant)
       {
-        NS_FATAL_ERROR("\nNiLogging::Write::Error calling pthread_mutex_lock!");
+        // write to file
+        m_filePtr << msgBufferStream.str() << std::endl;
       }
-    if (sem_post (&m_semMsgCount) < 0)
+    else
       {
-        NS_FATAL_ERROR("\nNiLogging::Write::Error calling sem_post!");
+        // write into circular buffer
+        m_logStringBuffer[m_curLogBufferEntry].str(std::string()); // clear the stringstream
+        m_logStringBuffer[m_curLogBufferEntry] << msgBufferStream.str() << std::endl;
+        m_curLogBufferEntry =  (m_curLogBufferEntry+1) % NI_LOG__BUFFER_SIZE;
       }
+  }
 
-    // stop system on FATAL ERROR and print out debugging info
-    if (logInfo.logLevel == LOG__FATAL)
-      {
-        std::string funcInfo = ", " + logInfo.func + "(), ";
-        std::string timingInfo = ", Sim(us)=" + std::to_string(logInfo.simTimeUs)  +  ", Sys(us)=" + std::to_string(logInfo.sysTimeUs);
-        std::string sourceInfo = ", " + logInfo.file + ", line " + std::to_string(logInfo.line) + funcInfo;
-        // print out to stdout
-        std::cout << std::endl << "[FATAL]" << timingInfo << sourceInfo << ", " << logInfo.buffer << std::endl << std::endl;
-        fflush( stdout );
-        // stop logging
-        NiLoggingDeInit();
-        struct timespec ts = {1,0};
-        nanosleep( &ts, NULL );
-        // print call stack
-        NiUtils::Backtrace();
-        // stop NS-3
-        NS_FATAL_ERROR ("NI_LOG_FATAL"); // this also stops the whole application
-      }
+  void
+  NiLogging::Fatal (const NiLogRecord* record)
+  {
+    const NiLogSite* site = record->site;
+    const uint64_t sysTimeUs = (record->sysTimeNs > m_firstCallSysTimeNs) ? (record->sysTimeNs - m_firstCallSysTimeNs) / 1000 : 0;
+    const int64_t simTimeUs = Time (record->simTimeStep).GetMicroSeconds();
+    std::string funcInfo = std::string (", ") + site->func + "(), ";
+    std::string timingInfo = ", Sim(us)=" + std::to_string(simTimeUs)  +  ", Sys(us)=" + std::to_string(sysTimeUs);
+    std::string sourceInfo = std::string (", ") + site->file + ", line " + std::to_string(site->line) + funcInfo;
+    // print out to stdout
+    std::cout << std::endl << "[FATAL]" << timingInfo << sourceInfo << ", " << RenderMessage (record) << std::endl << std::endl;
+    fflush( stdout );
+    // stop logging
+    NiLoggingDeInit();
+    struct timespec ts = {1,0};
+    nanosleep( &ts, NULL );
+    // print call stack
+    NiUtils::Backtrace();
+    // stop NS-3
+    NS_FATAL_ERROR ("NI_LOG_FATAL"); // this also stops the whole application
   }
 
   void
   NiLogging::terminateWriteThread()
   {
-    m_flagStopWriteThread = true;
-
-    if(sem_post (&m_semMsgCount) < 0)
+    // the thread drains all rings before it terminates
+    if (m_logThread == 0)
       {
-        NS_FATAL_ERROR("\nLteSpectrumPhy::terminateWriteThread::Error calling sem_post!");
+        return;
       }
+    m_flagStopWriteThread.store (true, std::memory_order_release);
     m_logThread->Join();
+    m_logThread = 0;
   }
 
   void
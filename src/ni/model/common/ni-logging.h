@@ -27,11 +27,16 @@
 #include <deque>
 #include <sys/time.h>              // for CPU time measurement
 #include <bitset>                  // for binary printouts
+#include <atomic>
+#include <vector>
+#include <cstring>
+#include <type_traits>
 
 #include "ns3/system-thread.h"
 #include "ns3/simulator.h"
 #include "ns3/fatal-error.h"
 #include "ns3/nstime.h"
+#include "ns3/ni-spsc-ring.h"
 
 #ifndef NI_LOGGIN_H
 #define NI_LOGGIN_H
@@ -79,22 +84,46 @@ enum NiLogLevel {
   LOG__PREFIX_ALL     = 0xf0000000  //!< All prefixes.
 };
 
-typedef struct sNiLogInfo {
-  uint64_t simTimeUs;
-  uint64_t sysTimeUs;
-  NiLogLevel logLevel;
-  std::string file;
-  int line;
-  std::string func;
-  std::string buffer;
-} niLogInfo;
-
 // Logging Mode
 #define NI_LOG__INSTANT_WRITE_ENABLE true    // write on the fly to the file
 #define NI_LOG__INSTANT_WRITE_DISABLE false  // write to a circular buffer
 
 #define NI_LOG__BUFFER_SIZE (1 << 17)
 
+// binary log records - each logging thread owns a ring of NI_LOG__RING_SIZE records
+#define NI_LOG__RING_SIZE (1 << 11)
+#define NI_LOG__RECORD_SIZE 512
+
+// static description of a logging call site, the record refers to it instead of copying file and function
+typedef struct sNiLogSite {
+  NiLogLevel logLevel;
+  const char* file;
+  int line;
+  const char* func;
+} NiLogSite;
+
+// type tags of the raw message arguments of a record
+enum NiLogArgType {
+  NI_LOG_ARG_INT = 0,   // int64_t
+  NI_LOG_ARG_UINT,      // uint64_t
+  NI_LOG_ARG_DOUBLE,    // double
+  NI_LOG_ARG_BOOL,      // uint8_t
+  NI_LOG_ARG_CHAR,      // char
+  NI_LOG_ARG_PTR,       // const void*
+  NI_LOG_ARG_STRING,    // uint16_t length followed by the characters
+  NI_LOG_ARG_MANIP      // std::ostream& (*)(std::ostream&), e.g. std::endl
+};
+
+// fixed size binary log record, the message is rendered by the logging thread
+typedef struct sNiLogRecord {
+  const NiLogSite* site;
+  int64_t simTimeStep;   // Simulator::Now time step, converted to us by the logging thread
+  uint64_t sysTimeNs;
+  uint16_t argsLength;   // used bytes of args
+  bool truncated;        // arguments did not fit into the record
+  uint8_t args[NI_LOG__RECORD_SIZE - 2*sizeof (uint64_t) - sizeof (void*) - 4];
+} NiLogRecord;
+
 /**
  * Use \ref to output a message of level LOG__NONE.
  *
@@ -190,16 +219,20 @@ typedef struct sNiLogInfo {
 /**
  * Use \ref to output a message according to LogLevel
  *
+ * The level is filtered before the message is touched. Enabled messages are
+ * stored as a binary record (call site plus raw arguments) in the ring of the
+ * calling thread and rendered later by the logging thread.
+ *
  * \param [in] LogLevel The log level.
  * \param [in] msg The message to log.
  */
 #define NiLoggingLog(LogLevel, msg) \
 {\
-  if(g_NiLogging.IsEnable() ) \
+  if (g_NiLogging.IsLevelEnabled (LogLevel)) \
     {\
-      std::stringstream strStream;\
-      strStream << msg;\
-      g_NiLogging.Write (LogLevel, __FILE__, __LINE__, __func__, strStream.str());\
+      static const NiLogSite niLogSite = {LogLevel, __FILE__, __LINE__, __func__};\
+      NiLogRecordWriter niLogRecordWriter (&niLogSite);\
+      niLogRecordWriter << msg;\
     }\
 }\
 
@@ -209,6 +242,8 @@ typedef struct sNiLogInfo {
 }\
 
 
+typedef NiSpscRing<NiLogRecord> NiLogRing;
+
 //This class is explicitly used to enable logging for multi-threading use case.
 //We can't use std::cout, cerr as they introduce too much latency in the system!
 class NiLogging
@@ -218,36 +253,259 @@ public:
   ~NiLogging(void);
   void Initialize (uint32_t logLevel, std::string fileName, int NiLoggingPriority);
   void DeInitialize (void);
-  void Write (const enum NiLogLevel logLevel, const std::string file, const int line, const std::string func, const std::string &buffer);
   bool IsEnable(void);
+  // true if messages of logLevel are written - fatal messages always are while logging is enabled
+  bool IsLevelEnabled (const enum NiLogLevel logLevel) const
+  {
+    return (m_activeLevelMask.load (std::memory_order_relaxed) & logLevel) != 0;
+  }
   void EnableSyncToFileInstant (void);
+  // levels not written although enabled by Initialize, e.g. while the real-time loop is degraded
+  void SetSuppressedLevels (uint32_t levelMask);
+
+  // producer side of the calling thread's ring, used by NiLogRecordWriter
+  NiLogRecord* GetWriteSlot (NiLogRing** pRing);
+  // ring is NULL for a record outside of the rings, e.g. a fatal message while the ring is full
+  void CommitWrite (NiLogRing* ring, NiLogRecord* record);
+  void InitRecord (NiLogRecord* record);
+
+  // renders the message of a record as the former stringstream of NiLoggingLog did
+  static std::string RenderMessage (const NiLogRecord* record);
 private:
   void WriteToFile();
   void terminateWriteThread();
   void writeThread();
-  void DisableFirstCall(void);
+  void WriteRecord (const NiLogRecord* record);
+  void Fatal (const NiLogRecord* record);
   const std::string PrintHeader(void);
+  void UpdateActiveLevelMask (void);
 
   uint64_t m_curLogBufferEntry;
   std::stringstream m_logStringBuffer[NI_LOG__BUFFER_SIZE];
   std::string m_fileOut;
-  pthread_mutex_t m_logMutex;
+  pthread_mutex_t m_logMutex;     // protects m_rings
   bool m_logIsEnable;
-  bool m_isFirstCall;
-  struct timeval m_firstCallSysTime;; //Wall Clock time when this function is called for the first time
+  uint64_t m_firstCallSysTimeNs;  // system time of Initialize
   bool m_syncToFileInstant ; //Boolean variable that tells the simulator to instantaneously synch contents of m_NIAPIStringStream to file
   std::ofstream m_filePtr;
-  sem_t m_semMsgCount; //Counts how many messages are in queue
-  std::deque<niLogInfo> m_msgQueue;
-  bool m_flagStopWriteThread;
+  std::vector<NiLogRing*> m_rings;  // one per logging thread, kept until destruction
+  std::atomic<uint32_t> m_numRings;
+  std::atomic<bool> m_flagStopWriteThread;
   Ptr<SystemThread> m_logThread;
   int m_logThreadPriority;
   uint32_t m_loglevelMask;
+  std::atomic<uint32_t> m_activeLevelMask; // m_loglevelMask without suppressed levels | LOG__FATAL while enabled, otherwise 0
+  uint32_t m_suppressedLevelMask;
+  uint32_t m_countMsgCnsl;
 };
 
 //global variable for class NiLogging
 extern NiLogging g_NiLogging;
 
+// Collects the arguments of one NiLoggingLog call into a record of the calling
+// thread's ring and commits it on destruction. Arithmetic values, pointers and
+// manipulators are stored raw, strings and character arrays are copied, as a const
+// char array can not be told apart from a string literal and may be gone when the
+// logging thread renders the record. Other types, e.g. enums, are formatted with
+// their operator<< at the call site.
+class NiLogRecordWriter
+{
+public:
+  explicit NiLogRecordWriter (const NiLogSite* site)
+  {
+    m_record = g_NiLogging.GetWriteSlot (&m_ring);
+    if ((m_record == NULL) && (site->logLevel == LOG__FATAL))
+      {
+        // a fatal message must not be dropped with a full ring, it is built
+        // on the stack and stops the system synchronously in CommitWrite
+        m_ring = NULL;
+        m_record = &m_fatalRecord;
+        g_NiLogging.InitRecord (m_record);
+      }
+    if (m_record != NULL)
+      {
+        m_record->site = site;
+      }
+  }
+
+  ~NiLogRecordWriter ()
+  {
+    if (m_record != NULL)
+      {
+        g_NiLogging.CommitWrite (m_ring, m_record);
+      }
+  }
+
+  // one entry point for all values, forwarding references keep character arrays
+  // apart from pointers to characters
+  template <typename T>
+  NiLogRecordWriter& operator<< (T&& value)
+  {
+    typedef typename std::remove_reference<T>::type U;
+    typedef typename std::remove_cv<typename std::remove_pointer<typename std::decay<T>::type>::type>::type Pointee;
+    typedef typename std::decay<T>::type D;
+    const int kind =
+        std::is_array<U>::value ? KIND_BUFFER :
+        (std::is_pointer<D>::value && IsChar<Pointee>::value) ? KIND_CSTRING :
+        std::is_pointer<D>::value ? KIND_POINTER :
+        std::is_same<D, bool>::value ? KIND_BOOL :
+        IsChar<D>::value ? KIND_CHAR :
+        std::is_integral<D>::value ? (std::is_signed<D>::value ? KIND_INT : KIND_UINT) :
+        (std::is_floating_point<D>::value && !std::is_same<D, long double>::value) ? KIND_DOUBLE :
+        std::is_same<D, std::string>::value ? KIND_STRING : KIND_OTHER;
+    PutValue (value, std::integral_constant<int, kind> ());
+    return *this;
+  }
+
+  // character buffers, including variable length arrays
+  NiLogRecordWriter& operator<< (char* value)
+  {
+    PutString (value, (value != NULL) ? strlen (value) : 0);
+    return *this;
+  }
+
+  NiLogRecordWriter& operator<< (std::ostream& (*manip)(std::ostream&))
+  {
+    PutArg (NI_LOG_ARG_MANIP, &manip, sizeof (manip));
+    return *this;
+  }
+
+private:
+  enum {
+    KIND_BUFFER, KIND_CSTRING, KIND_POINTER, KIND_BOOL, KIND_CHAR,
+    KIND_INT, KIND_UINT, KIND_DOUBLE, KIND_STRING, KIND_OTHER
+  };
+
+  // ostream prints all character types as characters and pointers to them as C strings
+  template <typename T>
+  struct IsChar
+  {
+    static const bool value = std::is_same<T, char>::value || std::is_same<T, signed char>::value ||
+                              std::is_same<T, unsigned char>::value;
+  };
+
+  template <typename V>
+  void PutValue (const V& value, std::integral_constant<int, KIND_BUFFER>)
+  {
+    const char* v = (const char*) value;
+    PutString (v, strnlen (v, sizeof (V)));
+  }
+
+  template <typename V>
+  void PutValue (const V& value, std::integral_constant<int, KIND_CSTRING>)
+  {
+    const char* v = (const char*) value;
+    PutString (v, (v != NULL) ? strlen (v) : 0);
+  }
+
+  template <typename V>
+  void PutValue (const V& value, std::integral_constant<int, KIND_POINTER>)
+  {
+    const void* v = (const void*) value;
+    PutArg (NI_LOG_ARG_PTR, &v, sizeof (v));
+  }
+
+  template <typename V>
+  void PutValue (const V& value, std::integral_constant<int, KIND_BOOL>)
+  {
+    const uint8_t v = value ? 1 : 0;
+    PutArg (NI_LOG_ARG_BOOL, &v, sizeof (v));
+  }
+
+  template <typename V>
+  void PutValue (const V& value, std::integral_constant<int, KIND_CHAR>)
+  {
+    const char v = (char) value;
+    PutArg (NI_LOG_ARG_CHAR, &v, sizeof (v));
+  }
+
+  template <typename V>
+  void PutValue (const V& value, std::integral_constant<int, KIND_INT>)
+  {
+    const int64_t v = value;
+    PutArg (NI_LOG_ARG_INT, &v, sizeof (v));
+  }
+
+  template <typename V>
+  void PutValue (const V& value, std::integral_constant<int, KIND_UINT>)
+  {
+    const uint64_t v = value;
+    PutArg (NI_LOG_ARG_UINT, &v, sizeof (v));
+  }
+
+  template <typename V>
+  void PutValue (const V& value, std::integral_constant<int, KIND_DOUBLE>)
+  {
+    const double v = value;
+    PutArg (NI_LOG_ARG_DOUBLE, &v, sizeof (v));
+  }
+
+  void PutValue (const std::string& value, std::integral_constant<int, KIND_STRING>)
+  {
+    PutString (value.data (), value.size ());
+  }
+
+  // all other types are formatted here with their operator<<
+  template <typename V>
+  void PutValue (const V& value, std::integral_constant<int, KIND_OTHER>)
+  {
+    if ((m_record != NULL) && !m_record->truncated)
+      {
+        std::ostringstream os;
+        os << value;
+        const std::string str = os.str ();
+        PutString (str.data (), str.size ());
+      }
+  }
+
+  void PutArg (uint8_t type, const void* value, uint32_t size)
+  {
+    if ((m_record == NULL) || m_record->truncated)
+      {
+        return;
+      }
+    if (m_record->argsLength + 1 + size > sizeof (m_record->args))
+      {
+        m_record->truncated = true;
+        return;
+      }
+    uint8_t* p = m_record->args + m_record->argsLength;
+    *p = type;
+    memcpy (p + 1, value, size);
+    m_record->argsLength += 1 + size;
+  }
+
+  void PutString (const char* str, size_t length)
+  {
+    if ((m_record == NULL) || m_record->truncated)
+      {
+        return;
+      }
+    const uint32_t space = sizeof (m_record->args) - m_record->argsLength;
+    if (space < 1 + sizeof (uint16_t) + 1)
+      {
+        m_record->truncated = true;
+        return;
+      }
+    // keep as much of a long string as fits
+    uint16_t len = length;
+    if (length > space - 1 - sizeof (uint16_t))
+      {
+        len = space - 1 - sizeof (uint16_t);
+        m_record->truncated = true;
+      }
+    uint8_t* p = m_record->args + m_record->argsLength;
+    *p = NI_LOG_ARG_STRING;
+    memcpy (p + 1, &len, sizeof (len));
+    memcpy (p + 1 + sizeof (len), str, len);
+    m_record->argsLength += 1 + sizeof (len) + len;
+  }
+
+  NiLogRing* m_ring;
+  NiLogRecord* m_record;
+  NiLogRecord m_fatalRecord;
+};
+
 // global variables for tracing
 extern uint64_t g_logTraceStartSubframeTime;
 
@@ -0,0 +1,244 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#include <pthread.h>
+
+#include "ni-logging.h"
+#include "ni-utils.h"
+#include "ni-pipe.h"
+#include "ni-pipe-reactor.h"
+#include "ni-latency-histogram.h"
+
+namespace ns3
+{
+
+  // process wide reactor, shared by all pipe transports in epoll rx mode
+  NiPipeReactor g_NiPipeReactor;
+
+  NiPipeReactor::NiPipeReactor ()
+  : m_stop (false)
+  {
+  }
+
+  NiPipeReactor::~NiPipeReactor ()
+  {
+  }
+
+int32_t
+NiPipeReactor::Register (NiPipeTransport* pTransport, int32_t timingIndFd, int32_t rxFd,
+                         int threadPriority, bool useEventFd)
+{
+  std::lock_guard<std::mutex> startStopLock (m_startStopMutex);
+  std::lock_guard<std::mutex> lock (m_mutex);
+
+  // without entries the thread may still run, an Unregister waiting for m_startStopMutex then keeps it
+  if (m_thread == 0)
+    {
+      // first transport - create epoll instance and start the reactor thread
+      m_useEventFd = useEventFd;
+      m_threadPriority = threadPriority;
+      if (NiPipe::EpollOpen (&m_epollFd, m_useEventFd ? &m_eventFd : NULL) < 0)
+        {
+          NI_LOG_FATAL ("NiPipeReactor::Register: could not create epoll instance");
+          return -1;
+        }
+      m_threadStats = NiPipeRxThreadStats ();
+      m_maxNumTransports = 0;
+      m_stop = false;
+      m_thread = Create<SystemThread> (MakeCallback (&NiPipeReactor::Run, this));
+      m_thread->Start ();
+    }
+
+  if ((NiPipe::EpollAddFd (&m_epollFd, &timingIndFd) < 0) ||
+      (NiPipe::EpollAddFd (&m_epollFd, &rxFd) < 0))
+    {
+      NI_LOG_FATAL ("NiPipeReactor::Register: could not add pipes of instance " << pTransport->GetInstanceId ());
+      return -1;
+    }
+  NiPipeReactorEntry timingIndEntry = {timingIndFd, pTransport, true};
+  NiPipeReactorEntry rxEntry = {rxFd, pTransport, false};
+  m_entries.push_back (timingIndEntry);
+  m_entries.push_back (rxEntry);
+
+  const uint32_t numTransports = CountTransports ();
+  if (numTransports > m_maxNumTransports)
+    {
+      m_maxNumTransports = numTransports;
+    }
+  NI_LOG_DEBUG ("NiPipeReactor: registered instance " << pTransport->GetInstanceId () <<
+                ", serving " << numTransports << " transport(s)");
+  return 0;
+}
+
+bool
+NiPipeReactor::Unregister (NiPipeTransport* pTransport)
+{
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    for (std::vector<NiPipeReactorEntry>::iterator it = m_entries.begin (); it != m_entries.end (); )
+      {
+        if (it->pTransport == pTransport)
+          {
+            NiPipe::EpollDelFd (&m_epollFd, &it->fd);
+            it = m_entries.erase (it);
+          }
+        else
+          {
+            ++it;
+          }
+      }
+    // wait for a running handler of the transport, unless it is the caller
+    if (!SystemThread::Equals (m_threadId))
+      {
+        while (m_pDispatchTransport == pTransport)
+          {
+            m_dispatchDone.wait (lock);
+          }
+      }
+  }
+
+  // a concurrent Register must not start a new reactor thread before this one is joined
+  std::lock_guard<std::mutex> startStopLock (m_startStopMutex);
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    if (!m_entries.empty () || m_thread == 0)
+      {
+        return false;
+      }
+    m_stop = true;
+  }
+
+  // last transport - stop the reactor thread outside of the lock
+  if (m_useEventFd)
+    {
+      NiPipe::EpollWakeup (&m_eventFd);
+    }
+  NI_LOG_DEBUG ("wait for reactor thread");
+  m_thread->Join ();
+  NI_LOG_DEBUG ("reactor thread finished");
+  m_thread = 0;
+  NiPipe::EpollClose (&m_epollFd, &m_eventFd);
+  return true;
+}
+
+uint32_t
+NiPipeReactor::GetNumTransports (void)
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  return CountTransports ();
+}
+
+const NiPipeRxThreadStats&
+NiPipeReactor::GetThreadStats (void) const
+{
+  return m_threadStats;
+}
+
+uint32_t
+NiPipeReactor::GetMaxNumTransports (void) const
+{
+  return m_maxNumTransports;
+}
+
+// every transport registers two pipes
+uint32_t
+NiPipeReactor::CountTransports (void) const
+{
+  return m_entries.size () / 2;
+}
+
+void
+NiPipeReactor::Run (void)
+{
+  // set thread priority - timing ind is the most time critical message
+  NiUtils::SetThreadPrioriy (m_threadPriority);
+  NiUtils::AddThreadInfo (pthread_self (), "NiPipeReactor Epoll thread");
+  // histogram buckets of this thread are allocated here instead of in the first handler
+  g_NiLatency.RegisterThread ();
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_threadId = SystemThread::Self ();
+  }
+  NI_LOG_DEBUG ("NI.PIPE.REACTOR: Epoll thread with id:" << pthread_self () << " started");
+
+  const uint64_t startCpuTimeUs = NiUtils::GetThreadCpuTimeUs ();
+  const uint64_t startSysTimeUs = NiUtils::GetSysTime ();
+
+  // without eventfd the wait has to time out to be able to check the stop flag
+  const int32_t timeoutMs = m_useEventFd ? -1 : m_epollTimeoutMs;
+  int32_t readyFds[m_maxReadyFds];
+
+  while (!m_stop)
+    {
+      const int32_t numReady = NiPipe::EpollWait (&m_epollFd, readyFds, m_maxReadyFds, timeoutMs);
+      const uint64_t wakeupTimeNs = NiUtils::GetSysTimeNs ();
+      if (numReady < 0)
+        {
+          NI_LOG_FATAL ("NiPipeReactor::Run: epoll wait failed");
+          break;
+        }
+
+      bool handled = false;
+      for (int32_t i = 0; i < numReady; i++)
+        {
+          // look up the entry under the lock and dispatch without it, so that handlers
+          // may use the reactor and do not block Register / Unregister of other transports
+          NiPipeReactorEntry entry = {-1, NULL, false};
+          {
+            std::lock_guard<std::mutex> lock (m_mutex);
+            // descriptors of a transport unregistered meanwhile are not found anymore,
+            // eventfd wakeup is only used for shutdown, stop flag is checked in loop condition
+            for (std::vector<NiPipeReactorEntry>::iterator it = m_entries.begin (); it != m_entries.end (); ++it)
+              {
+                if (it->fd == readyFds[i])
+                  {
+                    entry = *it;
+                    break;
+                  }
+              }
+            m_pDispatchTransport = entry.pTransport;
+          }
+          if (entry.pTransport == NULL)
+            {
+              continue;
+            }
+          const bool handledFd = entry.isTimingInd ? entry.pTransport->HandleTimingInd () : entry.pTransport->HandleCnfAndRxInd ();
+          entry.pTransport->UpdateRxThreadStats (&entry.pTransport->m_epollThreadStats, wakeupTimeNs, handledFd);
+          handled |= handledFd;
+          {
+            std::lock_guard<std::mutex> lock (m_mutex);
+            m_pDispatchTransport = NULL;
+          }
+          m_dispatchDone.notify_all ();
+        }
+      m_threadStats.numWakeups++;
+      if (!handled)
+        {
+          m_threadStats.numIdleWakeups++;
+        }
+    }
+
+  m_threadStats.cpuTimeUs  = NiUtils::GetThreadCpuTimeUs () - startCpuTimeUs;
+  m_threadStats.wallTimeUs = NiUtils::GetSysTime () - startSysTimeUs;
+  NiUtils::RemoveThreadInfo (pthread_self ());
+}
+
+} //namespace ns3
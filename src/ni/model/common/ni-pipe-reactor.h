@@ -0,0 +1,101 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#ifndef NI_PIPE_REACTOR_H_
+#define NI_PIPE_REACTOR_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "ns3/system-thread.h"
+#include "ni-pipe-transport.h"
+
+namespace ns3 {
+
+  // One epoll thread serving the timing ind and the rx ind / cnf pipes of all pipe
+  // transports of the process, so that one ns-3 process can drive several AFW
+  // instances (e.g. multi-cell or carrier aggregation) without a thread pair per
+  // instance. The thread is started with the first and stopped with the last
+  // registered transport; ready pipes are dispatched to the message handlers of
+  // the transport they belong to.
+  class NiPipeReactor
+  {
+  public:
+    NiPipeReactor ();
+    ~NiPipeReactor ();
+
+    // adds the rx pipes of the transport - thread priority and eventfd usage
+    // are taken from the transport that starts the reactor thread
+    int32_t Register (NiPipeTransport* pTransport, int32_t timingIndFd, int32_t rxFd,
+                      int threadPriority, bool useEventFd);
+    // removes the rx pipes of the transport, its handlers are not called anymore
+    // after return unless called from one of them - returns true if this stopped
+    // the reactor thread
+    bool Unregister (NiPipeTransport* pTransport);
+
+    uint32_t GetNumTransports (void);
+    // measurements of the last reactor thread run, complete once it was stopped
+    const NiPipeRxThreadStats& GetThreadStats (void) const;
+    uint32_t GetMaxNumTransports (void) const;
+
+  private:
+    // one registered pipe
+    typedef struct sNiPipeReactorEntry {
+      int32_t fd;
+      NiPipeTransport* pTransport;
+      bool isTimingInd;
+    } NiPipeReactorEntry;
+
+    void Run (void);
+    uint32_t CountTransports (void) const;
+
+    static const int32_t m_epollTimeoutMs = 10;
+    static const int32_t m_maxReadyFds = 2 * NI_PIPE_MAX_INSTANCES;
+
+    // serializes start and stop of the reactor thread by Register / Unregister
+    std::mutex m_startStopMutex;
+    // protects m_entries and m_pDispatchTransport, not held while dispatching
+    std::mutex m_mutex;
+    std::vector<NiPipeReactorEntry> m_entries;
+    // transport whose handler is running in the reactor thread, Unregister waits for it
+    NiPipeTransport* m_pDispatchTransport = NULL;
+    std::condition_variable m_dispatchDone;
+    SystemThread::ThreadId m_threadId = 0;
+
+    int32_t m_epollFd = -1;
+    int32_t m_eventFd = -1;
+    bool m_useEventFd = true;
+    int m_threadPriority = 0;
+    std::atomic<bool> m_stop;
+    Ptr<SystemThread> m_thread;
+
+    NiPipeRxThreadStats m_threadStats;
+    uint32_t m_maxNumTransports = 0;
+  };
+
+  extern NiPipeReactor g_NiPipeReactor;
+
+} //namespace ns3
+
+#endif /* NI_PIPE_REACTOR_H_ */
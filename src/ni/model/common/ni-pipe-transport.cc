@@ -21,19 +21,26 @@
  
 #include <cstdio>
 #include <cstdlib>
+#include <cerrno>
+#include <algorithm>
 #include <iostream>
 #include <bitset>
 #include <thread>
 #include <string>
+#include <sstream>
 #include <ns3/simulator.h>
 #include "ns3/ni-l1-l2-api-lte-message.h"
 #include "ns3/ni-l1-l2-api-lte-handler.h"
 #include "ns3/ni-lte-sdr-timing-sync.h"
 #include "ns3/ni-utils.h"
 #include "ns3/ni-logging.h"
+#include "ns3/ni-latency-histogram.h"
+#include "ns3/ni-rt-memory.h"
 #include "ni-pipe.h"
 #include "ns3/ni-remote-control-engine.h"
 #include "ni-pipe-transport.h"
+#include "ni-pipe-reactor.h"
+#include "ni-capture.h"
 
 
 namespace ns3 {
@@ -58,15 +65,14 @@ int32_t
 NiPipeTransport::Init(int timingIndThreadPriority, int rxThreadpriority)
 {
   //---------------------------------------------------------
-  // initialize named pipes
+  // initialize transport (named pipes by default)
   //---------------------------------------------------------
 
-  NI_LOG_CONSOLE_DEBUG( "NI.TRANSPORT: Preparing named pipes" );
-
-  // Assumption: The LV counterpart has created the FIFOs and will also clean them up at the end
-  NiPipe::OpenPipeForTx(m_pipe_name_2, &m_fd2);
-  NiPipe::OpenPipeForRx(m_pipe_name_1, &m_fd1, &m_readFds1, &m_fdMax1);
-  NiPipe::OpenPipeForRx(m_pipe_name_3, &m_fd3, &m_readFds3, &m_fdMax3);
+  if (OpenTransport() < 0)
+    {
+      NI_LOG_FATAL("NiPipeTransport::Init: could not open transport");
+      return -1;
+    }
 
   //---------------------------------------------------------
   // prepare variables
@@ -96,64 +102,143 @@ NiPipeTransport::Init(int timingIndThreadPriority, int rxThreadpriority)
     }
   memset(m_pBufU8Pipe3, 0, m_maxPacketSize);
 
-  m_sysTimeUs = 1000; // 1 TTI = 1 ms
-  m_lastSysTimeUs = 0;
+  m_lastTimingSnapshot = NiPhyTimingSnapshot();
+  m_timingSnapshot.Write(m_lastTimingSnapshot);
+  m_timingIndWaitStats = NiTimingIndWaitStats();
 
-  // spawn thread for PHY timint indication
-  m_timingIndReceived = false;
   m_timingIndThreadStop = false;
   m_timingIndThreadPriority = timingIndThreadPriority;
-  m_timingIndThread = Create<SystemThread> (MakeCallback (&NiPipeTransport::ReceiveTimingInd, this));
-  m_timingIndThread->Start();
-
-  // spawn thread for Rx reception (RX indication, TX confirmation)
   m_rxThreadStop = false;
   m_rxThreadpriority = rxThreadpriority;
-  m_rxThread = Create<SystemThread> (MakeCallback (&NiPipeTransport::ReceiveCnfAndRxInd, this));
-  m_rxThread->Start();
+
+  if (m_rxMode == NI_PIPE_RX_MODE_EPOLL)
+    {
+      // timing ind and rx ind / cnf pipe are served by the reactor thread shared with the
+      // other instances - timing ind is the most time critical message so use its priority
+      if (g_NiPipeReactor.Register(this, m_fd1, m_fd3, m_timingIndThreadPriority, m_useEventFd) < 0)
+        {
+          NI_LOG_FATAL("NiPipeTransport::Init: could not register pipes at reactor");
+        }
+    }
+  else
+    {
+      // spawn thread for PHY timint indication
+      m_timingIndThread = Create<SystemThread> (MakeCallback (&NiPipeTransport::ReceiveTimingInd, this));
+      m_timingIndThread->Start();
+
+      // spawn thread for Rx reception (RX indication, TX confirmation)
+      m_rxThread = Create<SystemThread> (MakeCallback (&NiPipeTransport::ReceiveCnfAndRxInd, this));
+      m_rxThread->Start();
+    }
 
   return 0;
 }
 
 uint64_t NiPipeTransport::GetTimingIndTime(void)
 {
-  return m_sysTimeUs;
+  NiPhyTimingSnapshot snapshot;
+  m_timingSnapshot.Read(&snapshot);
+  return snapshot.sysTimeUs;
 }
 
 bool NiPipeTransport::GetTimingIndReceived(void)
 {
-  return m_timingIndReceived;
+  NiPhyTimingSnapshot snapshot;
+  m_timingSnapshot.Read(&snapshot);
+  return snapshot.seqNum > 0;
 }
 
 uint8_t NiPipeTransport::GetTimingIndTti(void)
 {
-  return m_tti;
+  NiPhyTimingSnapshot snapshot;
+  m_timingSnapshot.Read(&snapshot);
+  return (uint8_t) snapshot.tti;
 }
 
 uint16_t NiPipeTransport::GetTimingIndSfn(void)
 {
-  return m_sfn;
+  NiPhyTimingSnapshot snapshot;
+  m_timingSnapshot.Read(&snapshot);
+  return (uint16_t) snapshot.sfn;
+}
+
+void NiPipeTransport::GetTimingSnapshot(NiPhyTimingSnapshot* pSnapshot)
+{
+  m_timingSnapshot.Read(pSnapshot);
+}
+
+// not thread safe, to be called from one (the simulator) thread only
+bool NiPipeTransport::WaitForTimingInd(uint64_t lastSeqNum, NiPhyTimingSnapshot* pSnapshot, uint64_t spinNs, uint64_t timeoutNs)
+{
+  NiTimingIndWaitStats* pStats = &m_timingIndWaitStats;
+  pStats->numWaits++;
+
+  uint32_t seq = m_timingSnapshot.Read(pSnapshot);
+  if (pSnapshot->seqNum > lastSeqNum)
+    {
+      pStats->numImmediate++;
+      return true;
+    }
+
+  bool blocked = false;
+  do
+    {
+      bool blockedOnce = false;
+      if (!m_timingSnapshot.WaitForUpdate(&seq, pSnapshot, spinNs, timeoutNs, &blockedOnce))
+        {
+          pStats->numTimeouts++;
+          return false;
+        }
+      blocked |= blockedOnce;
+    }
+  while (pSnapshot->seqNum <= lastSeqNum);
+
+  const uint64_t latencyNs = NiUtils::GetSysTimeNs() - pSnapshot->sysTimeNs;
+  if (blocked) pStats->numBlocked++; else pStats->numSpin++;
+  pStats->numWakeLatency++;
+  pStats->sumWakeLatencyNs += latencyNs;
+  pStats->lastWakeLatencyNs = latencyNs;
+  if (latencyNs > pStats->maxWakeLatencyNs) pStats->maxWakeLatencyNs = latencyNs;
+  return true;
+}
+
+const NiTimingIndWaitStats& NiPipeTransport::GetTimingIndWaitStats(void) const
+{
+  return m_timingIndWaitStats;
 }
 
 int32_t
 NiPipeTransport::DeInit(void)
 {
-  m_timingIndThreadStop = true;
-  NI_LOG_DEBUG( "wait for timingIndThread");
-  m_timingIndThread->Join();
-  NI_LOG_DEBUG( "timingIndThread finished");
-
-  m_rxThreadStop = true;
-  NI_LOG_DEBUG( "wait for rxThread");
-  m_rxThread->Join();
-  NI_LOG_DEBUG( "rxThread finished");
+  bool reactorStopped = false;
+  if (m_rxMode == NI_PIPE_RX_MODE_EPOLL)
+    {
+      m_timingIndThreadStop = true;
+      m_rxThreadStop = true;
+      // handlers of this instance are not called anymore after return
+      reactorStopped = g_NiPipeReactor.Unregister(this);
+    }
+  else
+    {
+      m_timingIndThreadStop = true;
+      NI_LOG_DEBUG( "wait for timingIndThread");
+      m_timingIndThread->Join();
+      NI_LOG_DEBUG( "timingIndThread finished");
+
+      m_rxThreadStop = true;
+      NI_LOG_DEBUG( "wait for rxThread");
+      m_rxThread->Join();
+      NI_LOG_DEBUG( "rxThread finished");
+    }
 
   NI_LOG_CONSOLE_INFO("\n-------- NI L1-L2 API Statistics --------");
+  NI_LOG_CONSOLE_INFO("Instance           = " << m_instanceId << " (" << m_pipe_name_1 << ")");
   NI_LOG_CONSOLE_INFO("PhyTimingInd       = " << m_numPhyTimingInd);
   NI_LOG_CONSOLE_INFO("PhyDlTxConfigReq   = " << m_numPhyDlTxConfigReq);
   NI_LOG_CONSOLE_INFO("PhyDlTxPayloadReq  = " << m_numPhyDlTxPayloadReq);
+  NI_LOG_CONSOLE_INFO("  DLSCH PDUs       = " << m_numDlschTxPdus << " (max " << m_maxDlschTxPdusPerTti << " per TTI)");
   NI_LOG_CONSOLE_INFO("PhyUlTxPayloadReq  = " << m_numPhyUlTxPayloadReq);
-  for (uint32_t i; i < CNF_NUM_STATUS_CODES; i++)
+  for (uint32_t i = 0; i < CNF_NUM_STATUS_CODES; i++)
     {
       if (m_numPhyCnf[i] > 0)
         {
@@ -163,8 +248,41 @@ NiPipeTransport::DeInit(void)
   NI_LOG_CONSOLE_INFO("PhyDlschRxInd      = " << m_numPhyDlschRxInd);
   NI_LOG_CONSOLE_INFO("PhyCellMeasInd     = " << m_numPhyCellMeasInd);
   NI_LOG_CONSOLE_INFO("PhyUlschRxInd      = " << m_numPhyUlschRxInd);
+  if (m_rxMode == NI_PIPE_RX_MODE_EPOLL)
+    {
+      PrintRxThreadStats("Epoll rx (reactor)", &m_epollThreadStats);
+      if (reactorStopped)
+        {
+          // the last instance reports the shared reactor thread
+          NiPipeRxThreadStats reactorStats = g_NiPipeReactor.GetThreadStats();
+          std::stringstream name;
+          name << "Reactor thread (" << g_NiPipeReactor.GetMaxNumTransports() << " instances)";
+          PrintRxThreadStats(name.str(), &reactorStats);
+        }
+    }
+  else
+    {
+      PrintRxThreadStats("TimingInd thread", &m_timingIndThreadStats);
+      PrintRxThreadStats("RxIndCnf thread", &m_rxThreadStats);
+    }
+  if (m_timingIndWaitStats.numWaits > 0)
+    {
+      const NiTimingIndWaitStats* pWait = &m_timingIndWaitStats;
+      NI_LOG_CONSOLE_INFO("TimingInd waits    = " << pWait->numWaits << " (immediate " << pWait->numImmediate <<
+                          ", spin " << pWait->numSpin << ", blocked " << pWait->numBlocked <<
+                          ", timeout " << pWait->numTimeouts << ")");
+      if (pWait->numWakeLatency > 0)
+        {
+          NI_LOG_CONSOLE_INFO("  wake latency     = avg " << (pWait->sumWakeLatencyNs / pWait->numWakeLatency) / 1000.0 <<
+                              " us, max " << pWait->maxWakeLatencyNs / 1000.0 << " us");
+        }
+    }
+  g_NiLatency.Print();
+  NiAllocScope::Print();
   NI_LOG_CONSOLE_INFO("-----------------------------------------\n");
 
+  CloseTransport();
+
   free( m_pBufU8Pipe1 );
   free( m_pBufU8Pipe2 );
   free( m_pBufU8Pipe3 );
@@ -180,86 +298,39 @@ NiPipeTransport::ReceiveTimingInd(void)
   // set thread priority
   NiUtils::SetThreadPrioriy(m_timingIndThreadPriority);
   NiUtils::AddThreadInfo (pthread_self(), (m_context + " NiPipeTransport PhyTimingInd thread"));
+  g_NiLatency.RegisterThread();
   NI_LOG_DEBUG("NI.PIPE.TRANSPORT: Pipe PhyTimingInd thread with id:" <<  pthread_self() << " started");
 
-  // thread loop
+  const uint64_t startCpuTimeUs = NiUtils::GetThreadCpuTimeUs();
+  const uint64_t startSysTimeUs = NiUtils::GetSysTime();
+
+  uint32_t iteration = 0;
+  // poll pipe for timing indication
   while(!m_timingIndThreadStop)
     {
-      NI_LOG_NONE ("timingIndThread Start");
-    int32_t  nread  = 0;
-
-    // NIAPI related parameters
-    uint32_t msgType    = 0;
-    uint32_t bodyLength = 0;
-
-    // NIAPI messages
-    PhyTimingInd phyTimingInd;
-
-    uint32_t iteration = 0;
-    // poll pipe for timing indication
-    while ( true )
-      {
-        bool done = false;
-        //----------------------------------------------------------------
-        // read timing indication (polling mode)
-        //----------------------------------------------------------------
-
-        nread = NiPipe::PipeRead(&m_fd1, &m_readFds1, &m_fdMax1, m_pBufU8Pipe1, 16); // TTI indication = 16 bytes
-
-        if (nread > 0)
-          {
-            NI_LOG_NONE ("received " << nread << "bytes");
-            m_bufOffsetU8Pipe1 = 0;
-            GetMsgType( &msgType, m_pBufU8Pipe1, &m_bufOffsetU8Pipe1 );
-
-            switch (msgType)
-            {
-              // Where timing trigger is received from L1, send config and payload.
-              case (PHY_TIMING_IND):
-                  bool firstRun;
-                  firstRun = false;
-                  if (!m_timingIndReceived)
-                    {
-                      m_timingIndReceived = true;
-                      firstRun = true;
-                    }
-                  m_numPhyTimingInd++;
-                  m_lastSysTimeUs = m_sysTimeUs;
-                  m_sysTimeUs = NiUtils::GetSysTime();
-                  DeserializePhyTimingInd( &phyTimingInd, m_pBufU8Pipe1, &m_bufOffsetU8Pipe1 );
-                  m_tti = (uint8_t) phyTimingInd.subMsgHdr.tti;
-                  m_sfn = (uint16_t) phyTimingInd.subMsgHdr.sfn;
-                  NI_LOG_DEBUG ("TimingInd received after: " + std::to_string(m_sysTimeUs-m_lastSysTimeUs) +
-                                " with SFN: " + std::to_string(m_sfn) + " TTI: " +
-                                std::to_string(m_tti));
-                  done = true;
-                  break;
-              default:
-                  NI_LOG_FATAL("Received UNKNOWN message. pipe=" << m_pipe_name_1 << " msgType=" << msgType);
-                  done = true;
-                break;
-            }
-          }
-        else
-          {
-            iteration++;
-            if (iteration > 1000) {
-                NI_LOG_NONE ("1000 x nothing received");
-                iteration = 0;
-            }
+      // PipeRead returns after select timeout or when data is available
+      const bool handled = HandleTimingInd();
+      UpdateRxThreadStats(&m_timingIndThreadStats, NiUtils::GetSysTimeNs(), handled);
+      if (!handled)
+        {
+          iteration++;
+          if (iteration > 1000) {
+              NI_LOG_NONE ("1000 x nothing received");
+              iteration = 0;
           }
-        if (done || m_timingIndThreadStop) break;
-        nanosleep( &m_ts, NULL );   // wait a little bit and then start over again
-      }
+          IdleWait();   // wait a little bit and then start over again
+        }
 //    // remote control implementation example
-//    g_RemoteControlEngine.GetPdb()->setParameterNumPhyTimingInd(m_numPhyTimingInd); // Makes PhyTimingInd read accesible thorgh Remote Control
 //    if (m_numPhyTimingInd % 1000 == 0
 //      && g_RemoteControlEngine.GetPdb()->getParameterLogPhyTimingInd() ) //Remote Controlled logging enable through second boolean statement
 //      {
 //        NI_LOG_CONSOLE_INFO(std::to_string(m_numPhyTimingInd) + " PhyTimingInd Received");
 //      }
-
     }
+
+  m_timingIndThreadStats.cpuTimeUs  = NiUtils::GetThreadCpuTimeUs() - startCpuTimeUs;
+  m_timingIndThreadStats.wallTimeUs = NiUtils::GetSysTime() - startSysTimeUs;
+  NiUtils::RemoveThreadInfo (pthread_self());
 }
 
 void
@@ -268,141 +339,395 @@ NiPipeTransport::ReceiveCnfAndRxInd(void)
   // set thread priority
   NiUtils::SetThreadPrioriy(m_rxThreadpriority);
   NiUtils::AddThreadInfo (pthread_self(), (m_context + " NiPipeTransport RxIndCnf thread"));
+  g_NiLatency.RegisterThread();
   NI_LOG_DEBUG("NI.PIPE.TRANSPORT: Pipe RxIndCnf thread with id:" <<  pthread_self() << " started");
 
-  // thread loop
+  const uint64_t startCpuTimeUs = NiUtils::GetThreadCpuTimeUs();
+  const uint64_t startSysTimeUs = NiUtils::GetSysTime();
+
+  uint64_t iteration = 0;
+  // poll pipe for rx indication or tx confirmation
   while(!m_rxThreadStop)
     {
-    NI_LOG_NONE ("rxThread Start");
-    int32_t  nread  = 0;
+      const bool handled = HandleCnfAndRxInd();
+      UpdateRxThreadStats(&m_rxThreadStats, NiUtils::GetSysTimeNs(), handled);
+      if (!handled)
+        {
+          iteration++;
+          if (iteration > 1000) {
+              NI_LOG_NONE ("1000 x nothing received");
+              iteration = 0;
+          }
+          IdleWait();   // wait a little bit and then start over again
+        }
+    }
+
+  m_rxThreadStats.cpuTimeUs  = NiUtils::GetThreadCpuTimeUs() - startCpuTimeUs;
+  m_rxThreadStats.wallTimeUs = NiUtils::GetSysTime() - startSysTimeUs;
+  NiUtils::RemoveThreadInfo (pthread_self());
+}
+
+//======================================================================================
+// named pipe i/o
+//======================================================================================
+
+int32_t
+NiPipeTransport::OpenTransport(void)
+{
+  NI_LOG_CONSOLE_DEBUG( "NI.TRANSPORT: Preparing named pipes" );
+
+  // Assumption: The LV counterpart has created the FIFOs and will also clean them up at the end
+  if ((NiPipe::OpenPipeForTx((char*)m_pipe_name_2.c_str(), &m_fd2) < 0) ||
+      (NiPipe::OpenPipeForRx((char*)m_pipe_name_1.c_str(), &m_fd1, &m_readFds1, &m_fdMax1) < 0) ||
+      (NiPipe::OpenPipeForRx((char*)m_pipe_name_3.c_str(), &m_fd3, &m_readFds3, &m_fdMax3) < 0))
+    {
+      return -1;
+    }
+  return 0;
+}
+
+void
+NiPipeTransport::CloseTransport(void)
+{
+  NiPipe::ClosePipe(&m_fd1);
+  NiPipe::ClosePipe(&m_fd2);
+  NiPipe::ClosePipe(&m_fd3);
+  m_fd1 = -1;
+  m_fd2 = -1;
+  m_fd3 = -1;
+}
+
+int32_t
+NiPipeTransport::ReadTimingIndMsg(uint8_t* pBufU8, uint32_t maxLen)
+{
+  if (m_rxMode == NI_PIPE_RX_MODE_EPOLL)
+    {
+      const int32_t nread = ReadPipeNonBlocking(&m_fd1, pBufU8, 16, &m_numReadPipe1); // TTI indication = 16 bytes
+      if (nread != 0)
+        {
+          m_numReadPipe1 = 0;
+        }
+      return nread;
+    }
+  return NiPipe::PipeRead(&m_fd1, &m_readFds1, &m_fdMax1, pBufU8, 16);
+}
+
+int32_t
+NiPipeTransport::ReadRxMsg(uint8_t* pBufU8, uint32_t maxLen)
+{
+  uint32_t bufOffset  = 0;
+  uint32_t bodyLength = 0;
+
+  if (m_rxMode == NI_PIPE_RX_MODE_EPOLL)
+    {
+      return ReadRxMsgNonBlocking(pBufU8, maxLen);
+    }
+
+  int32_t nread = NiPipe::PipeRead(&m_fd3, &m_readFds3, &m_fdMax3, pBufU8, 8); // genMsgHdr = 8 bytes
+  if (nread <= 0)
+    {
+      return nread;
+    }
+
+  GetBodyLength( &bodyLength, pBufU8, &bufOffset );
+  if (8 + bodyLength > maxLen)
+    {
+      NI_LOG_FATAL( "ERROR: Message exceeds rx buffer. pipe=" << m_pipe_name_3 << ", bodyLength=" << bodyLength );
+      return -1;
+    }
+
+  // Read rest of the message - body might not be completely written yet, so wait for it
+  if ( (int32_t)bodyLength > NiPipe::PipeRead(&m_fd3, &m_readFds3, &m_fdMax3, pBufU8+8, bodyLength ) )
+    {
+      NI_LOG_FATAL( "ERROR: Could not read requested amount of bytes. "
+                    "pipe=" << m_pipe_name_3 << ", num_requested=" << bodyLength << ", num_received=" << nread );
+    }
+
+  return 8 + bodyLength;
+}
+
+int32_t
+NiPipeTransport::WriteTxMsg(const struct iovec* pIov, int32_t iovCnt)
+{
+  return NiPipe::PipeWriteV(&m_fd2, pIov, iovCnt);
+}
+
+// all tx messages pass here, so that they are captured independent of the transport
+int32_t
+NiPipeTransport::SendTxMsg(const struct iovec* pIov, int32_t iovCnt)
+{
+  NI_CAPTURE(NI_CAPTURE_DIR_TX, NI_CAPTURE_CHANNEL_PIPE_TX, m_instanceId, m_context, pIov, iovCnt);
+  return WriteTxMsg(pIov, iovCnt);
+}
+
+void
+NiPipeTransport::IdleWait(void)
+{
+  nanosleep( &m_ts, NULL );
+}
+
+// in epoll mode the non-blocking descriptor is known to be readable - no need for select,
+// but a message may arrive in parts: the bytes read so far stay in pBufU8 and are counted
+// in *pNumRead, 0 is returned until len bytes are complete and the next readiness event
+// continues the message - the caller resets *pNumRead once the message is complete
+int32_t
+NiPipeTransport::ReadPipeNonBlocking(int32_t* pFd, uint8_t* pBufU8, uint32_t len, uint32_t* pNumRead)
+{
+  while (*pNumRead < len)
+    {
+      const uint32_t numToRead = std::min<uint32_t>(len - *pNumRead, UINT16_MAX);
+      const int32_t nread = NiPipe::PipeReadOnce(pFd, pBufU8 + *pNumRead, numToRead);
+      if (nread > 0)
+        {
+          *pNumRead += nread;
+        }
+      else if ((nread < 0) && (errno == EINTR))
+        {
+          continue;
+        }
+      else if ((nread < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK))
+        {
+          NI_LOG_ERROR("NiPipeTransport::ReadPipeNonBlocking: read failed, errno=" << errno);
+          *pNumRead = 0;
+          return -1;
+        }
+      else
+        {
+          // no more data (EAGAIN) or no writer (0), continue with the next readiness event
+          return 0;
+        }
+    }
+  return len;
+}
 
-    // NIAPI related parameters
-    uint32_t msgType    = 0;
-    uint32_t bodyLength = 0;
+// general message header and body of an rx message, both possibly in parts
+int32_t
+NiPipeTransport::ReadRxMsgNonBlocking(uint8_t* pBufU8, uint32_t maxLen)
+{
+  uint32_t bufOffset  = 0;
+  uint32_t bodyLength = 0;
 
-    // NIAPI messages
-    PhyCnf phyCnf;
-    PhyDlschRxInd phyDlschRxInd;
-    PhyCellMeasInd phyCellMeasInd;
-    PhyUlschRxInd phyUlschRxInd;
+  if (m_numReadPipe3 < 8)
+    {
+      const int32_t nread = ReadPipeNonBlocking(&m_fd3, pBufU8, 8, &m_numReadPipe3); // genMsgHdr = 8 bytes
+      if (nread <= 0)
+        {
+          return nread;
+        }
+    }
 
-    std::string str;
+  GetBodyLength( &bodyLength, pBufU8, &bufOffset );
+  if (8 + bodyLength > maxLen)
+    {
+      NI_LOG_FATAL( "ERROR: Message exceeds rx buffer. pipe=" << m_pipe_name_3 << ", bodyLength=" << bodyLength );
+      m_numReadPipe3 = 0;
+      return -1;
+    }
 
-    uint64_t iteration = 0;
-    // poll pipe for rx indication or tx confirmation
-    while ( true )
+  // read rest of the message - the body might not be completely written yet
+  const int32_t nread = ReadPipeNonBlocking(&m_fd3, pBufU8, 8 + bodyLength, &m_numReadPipe3);
+  if (nread != 0)
+    {
+      m_numReadPipe3 = 0;
+    }
+  return nread;
+}
+
+// reads and processes one PHY timing indication, returns true if a message was handled
+bool
+NiPipeTransport::HandleTimingInd(void)
+{
+  NI_LOG_NONE ("timingIndThread Start");
+  int32_t  nread  = 0;
+
+  // NIAPI related parameters
+  uint32_t msgType    = 0;
+
+  // NIAPI messages
+  PhyTimingInd phyTimingInd;
+
+  //----------------------------------------------------------------
+  // read timing indication
+  //----------------------------------------------------------------
+
+  nread = ReadTimingIndMsg(m_pBufU8Pipe1, m_maxPacketSize);
+
+  if (nread <= 0)
+    {
+      return false;
+    }
+  NI_CAPTURE(NI_CAPTURE_DIR_RX, NI_CAPTURE_CHANNEL_PIPE_TIMING_IND, m_instanceId, m_context, m_pBufU8Pipe1, nread);
+  NiAllocScope allocScope (NI_ALLOC_SCOPE_TRANSPORT_RX);
+
+  NI_LOG_NONE ("received " << nread << "bytes");
+  m_bufOffsetU8Pipe1 = 0;
+  GetMsgType( &msgType, m_pBufU8Pipe1, &m_bufOffsetU8Pipe1 );
+
+  switch (msgType)
+  {
+    // Where timing trigger is received from L1, send config and payload.
+    case (PHY_TIMING_IND):
       {
-        bool done = false;
-        //----------------------------------------------------------------
-        // read DL RX payload and DL TX confirmation
-        //----------------------------------------------------------------
-
-        nread = NiPipe::PipeRead( &m_fd3, &m_readFds3, &m_fdMax3, m_pBufU8Pipe3, 8 ); // genMsgHdr = 8 bytes
-
-        if (nread > 0)
-          {
-            NI_LOG_NONE ("received " << nread << "bytes");
-            // Extract message type and body length (variable)
-            m_bufOffsetU8Pipe3 = 0;
-            GetMsgType( &msgType, m_pBufU8Pipe3, &m_bufOffsetU8Pipe3 );
-            GetBodyLength( &bodyLength, m_pBufU8Pipe3, &m_bufOffsetU8Pipe3 );
-
-            // Read rest of the message
-            if ( bodyLength > NiPipe::PipeRead(&m_fd3, &m_readFds3, &m_fdMax3, m_pBufU8Pipe3+8, bodyLength ) )
-              {
-                NI_LOG_FATAL( "ERROR: Could not read requested amount of bytes. "
-                              "pipe=" << m_pipe_name_3 << ", num_requested=" << bodyLength << ", num_received=" << nread );
-              }
+        m_numPhyTimingInd++;
+        // makes PhyTimingInd readable and subscribable through remote control
+        g_RemoteControlEngine.GetPdb()->parameterNum_PhyTimingInd.Set(m_numPhyTimingInd);
+        const uint64_t lastSysTimeUs = m_lastTimingSnapshot.sysTimeUs;
+        m_lastTimingSnapshot.sysTimeUs = NiUtils::GetSysTime();
+        m_lastTimingSnapshot.sysTimeNs = NiUtils::GetSysTimeNs();
+        DeserializePhyTimingInd( &phyTimingInd, m_pBufU8Pipe1, &m_bufOffsetU8Pipe1 );
+        m_lastTimingSnapshot.tti = phyTimingInd.subMsgHdr.tti;
+        m_lastTimingSnapshot.sfn = phyTimingInd.subMsgHdr.sfn;
+        m_lastTimingSnapshot.seqNum = m_numPhyTimingInd;
+        // publish time, SFN and TTI together and wake up a waiting simulator thread
+        m_timingSnapshot.Write(m_lastTimingSnapshot);
+        NI_LOG_DEBUG ("TimingInd received after: " + std::to_string(m_lastTimingSnapshot.sysTimeUs-lastSysTimeUs) +
+                      " with SFN: " + std::to_string(m_lastTimingSnapshot.sfn) + " TTI: " +
+                      std::to_string(m_lastTimingSnapshot.tti));
+        break;
+      }
+    default:
+        NI_LOG_FATAL("Received UNKNOWN message. pipe=" << m_pipe_name_1 << " msgType=" << msgType);
+      break;
+  }
 
-            const int numBytes = 32;
-            char buffer [numBytes*2+1];
+  return true;
+}
 
-            switch (msgType)
-            {
-              case (PHY_ULSCH_RX_IND):
-                m_numPhyUlschRxInd++;
-                DeserializePhyUlschRxInd( &phyUlschRxInd, m_pBufU8Pipe3, &m_bufOffsetU8Pipe3 );
+// reads and processes one rx indication or tx confirmation, returns true if a message was handled
+bool
+NiPipeTransport::HandleCnfAndRxInd(void)
+{
+  NI_LOG_NONE ("rxThread Start");
+  int32_t  nread  = 0;
 
-                for(int j = 0; j < numBytes; j++)
-                  {
-                    sprintf(&buffer[2*j], "%02X", phyUlschRxInd.ulschMacPduRxBody.macPdu[j]);
-                  }
+  // NIAPI related parameters
+  uint32_t msgType    = 0;
+  uint32_t bodyLength = 0;
+
+  // NIAPI messages
+  PhyCnf phyCnf;
+  PhyDlschRxInd phyDlschRxInd;
+  PhyCellMeasInd phyCellMeasInd;
+  PhyUlschRxInd phyUlschRxInd;
+
+  std::string str;
+
+  //----------------------------------------------------------------
+  // read DL RX payload and DL TX confirmation
+  //----------------------------------------------------------------
+
+  nread = ReadRxMsg( m_pBufU8Pipe3, m_maxPacketSize );
+
+  if (nread <= 0)
+    {
+      return false;
+    }
+  NI_CAPTURE(NI_CAPTURE_DIR_RX, NI_CAPTURE_CHANNEL_PIPE_RX, m_instanceId, m_context, m_pBufU8Pipe3, nread);
+  const uint64_t readTimeNs = NiUtils::GetSysTimeNs();
+  NiAllocScope allocScope (NI_ALLOC_SCOPE_TRANSPORT_RX);
+
+  NI_LOG_NONE ("received " << nread << "bytes");
+  // Extract message type and body length (variable)
+  m_bufOffsetU8Pipe3 = 0;
+  GetMsgType( &msgType, m_pBufU8Pipe3, &m_bufOffsetU8Pipe3 );
+  GetBodyLength( &bodyLength, m_pBufU8Pipe3, &m_bufOffsetU8Pipe3 );
+
+        switch (msgType)
+        {
+          case (PHY_ULSCH_RX_IND):
+            m_numPhyUlschRxInd++;
+            DeserializePhyUlschRxInd( &phyUlschRxInd, m_pBufU8Pipe3, &m_bufOffsetU8Pipe3 );
+
+            // the debug output is formatted only if it is written
+            if (g_NiLogging.IsLevelEnabled (LOG__DEBUG))
+              {
                 NI_LOG_DEBUG ("UlschRxInd received with" <<
                               " SFN: " << phyUlschRxInd.subMsgHdr.sfn <<
                               " TTI: " << phyUlschRxInd.subMsgHdr.tti <<
                               " CRC: " << phyUlschRxInd.ulschMacPduRxBody.crcResult <<
                               " RNTI: " << phyUlschRxInd.ulschMacPduRxBody.rnti <<
                               " PDU Size: " << phyUlschRxInd.ulschMacPduRxBody.macPduSize <<
-                              " PDU[]: " << buffer);
+                              " PDU[]: " << PrintMacPdu(phyUlschRxInd.ulschMacPduRxBody.macPdu, phyUlschRxInd.ulschMacPduRxBody.macPduSize));
+              }
 
-                if (m_niApiDevType == 0) // eNB
+            if (m_niApiDevType == 0) // eNB
+              {
+                if (!m_niApiCrcResultCallback.IsNull ())
                   {
-                    if (phyUlschRxInd.ulschMacPduRxBody.crcResult == 1)
-                      {
-                        // call function for rx packet processing
-                        const uint32_t fpgaPayloadLengthHeaderSize = 4; // added by FPGA
-                        if (phyUlschRxInd.ulschMacPduRxBody.macPduSize >= fpgaPayloadLengthHeaderSize)
-                          {
-                            uint32_t fpgaPayloadLength = 0;
-                            for (int i = 0; i < fpgaPayloadLengthHeaderSize; ++i) {
-                                fpgaPayloadLength |= (phyUlschRxInd.ulschMacPduRxBody.macPdu[i] << i*8);
-                            }
-                            NI_LOG_DEBUG("fpgaPayloadLength: " << fpgaPayloadLength);
-                            // TODO-NI: handover payload length to upper layers?
-                            m_niApiDataEndOkCallback((uint8_t*)&phyUlschRxInd.ulschMacPduRxBody.macPdu[fpgaPayloadLengthHeaderSize]);
-                          }
-                        else
-                          {
-                            NI_LOG_FATAL("PHY_ULSCH_RX_IND corrupt");
-                          }
-                      }
+                    m_niApiCrcResultCallback(phyUlschRxInd.ulschMacPduRxBody.rnti, phyUlschRxInd.ulschMacPduRxBody.crcResult == 1);
                   }
-                else
+                if (phyUlschRxInd.ulschMacPduRxBody.crcResult == 1)
                   {
-                    NI_LOG_FATAL("PHY_ULSCH_RX_IND received and device type is not eNB");
+                    // call function for rx packet processing
+                    const uint32_t fpgaPayloadLengthHeaderSize = 4; // added by FPGA
+                    if (phyUlschRxInd.ulschMacPduRxBody.macPduSize >= fpgaPayloadLengthHeaderSize)
+                      {
+                        uint32_t fpgaPayloadLength = 0;
+                        for (int i = 0; i < fpgaPayloadLengthHeaderSize; ++i) {
+                            fpgaPayloadLength |= (phyUlschRxInd.ulschMacPduRxBody.macPdu[i] << i*8);
+                        }
+                        NI_LOG_DEBUG("fpgaPayloadLength: " << fpgaPayloadLength);
+                        // TODO-NI: handover payload length to upper layers?
+                        m_niApiDataEndOkCallback((uint8_t*)&phyUlschRxInd.ulschMacPduRxBody.macPdu[fpgaPayloadLengthHeaderSize],
+                                                 phyUlschRxInd.ulschMacPduRxBody.macPduSize - fpgaPayloadLengthHeaderSize);
+                      }
+                    else
+                      {
+                        NI_LOG_FATAL("PHY_ULSCH_RX_IND corrupt");
+                      }
                   }
-                done = true;
-                break;
-              case (PHY_DLSCH_RX_IND):
-                m_numPhyDlschRxInd++;
-                DeserializePhyDlschRxInd( &phyDlschRxInd, m_pBufU8Pipe3, &m_bufOffsetU8Pipe3 );
+              }
+            else
+              {
+                NI_LOG_FATAL("PHY_ULSCH_RX_IND received and device type is not eNB");
+              }
+            break;
+          case (PHY_DLSCH_RX_IND):
+            m_numPhyDlschRxInd++;
+            DeserializePhyDlschRxInd( &phyDlschRxInd, m_pBufU8Pipe3, &m_bufOffsetU8Pipe3 );
 
-                for(int j = 0; j < numBytes; j++)
-                  {
-                    sprintf(&buffer[2*j], "%02X", phyDlschRxInd.dlschMacPduRxBody.macPdu[j]);
-                  }
+            // the debug output is formatted only if it is written
+            if (g_NiLogging.IsLevelEnabled (LOG__DEBUG))
+              {
                 NI_LOG_DEBUG ("DlschRxInd received with" <<
                               " SFN: " << phyDlschRxInd.subMsgHdr.sfn <<
                               " TTI: " << phyDlschRxInd.subMsgHdr.tti <<
                               " CRC: " << phyDlschRxInd.dlschMacPduRxBody.crcResult <<
                               " RNTI: " << phyDlschRxInd.dlschMacPduRxBody.rnti <<
                               " PDU Size: " << phyDlschRxInd.dlschMacPduRxBody.macPduSize <<
-                              " PDU[]: " << buffer);
+                              " PDU[]: " << PrintMacPdu(phyDlschRxInd.dlschMacPduRxBody.macPdu, phyDlschRxInd.dlschMacPduRxBody.macPduSize));
+              }
 
-                if (m_niApiDevType == 1) // UE
+            if (m_niApiDevType == 1) // UE
+              {
+                if (!m_niApiCrcResultCallback.IsNull ())
                   {
-                    if (phyDlschRxInd.dlschMacPduRxBody.crcResult == 1)
-                      {
-                        NI_LOG_NONE("Start NS3 Rx processing");
-                        // call function for rx packet processing
-                        m_niApiDataEndOkCallback((uint8_t*)&phyDlschRxInd.dlschMacPduRxBody.macPdu);
-                        NI_LOG_NONE("Finished NS3 Rx processing");
-                      }
+                    m_niApiCrcResultCallback(phyDlschRxInd.dlschMacPduRxBody.rnti, phyDlschRxInd.dlschMacPduRxBody.crcResult == 1);
                   }
-                else
+                if (phyDlschRxInd.dlschMacPduRxBody.crcResult == 1)
                   {
-                    NI_LOG_FATAL("PHY_DLSCH_RX_IND received and device type is not UE");
+                    NI_LOG_NONE("Start NS3 Rx processing");
+                    // call function for rx packet processing
+                    m_niApiDataEndOkCallback((uint8_t*)&phyDlschRxInd.dlschMacPduRxBody.macPdu,
+                                             phyDlschRxInd.dlschMacPduRxBody.macPduSize);
+                    NI_LOG_NONE("Finished NS3 Rx processing");
                   }
-                done = true;
-                break;
-              case (PHY_CELL_MEASUREMENT_IND):
+              }
+            else
+              {
+                NI_LOG_FATAL("PHY_DLSCH_RX_IND received and device type is not UE");
+              }
+            break;
+          case (PHY_CELL_MEASUREMENT_IND):
+            {
+              m_numPhyCellMeasInd++;
+              DeserializePhyCellMeasurementInd( &phyCellMeasInd, m_pBufU8Pipe3, &m_bufOffsetU8Pipe3 );
+              if (phyCellMeasInd.cellMeasReportBody.numSubbandSinr > MAX_NUM_SUBBAND_SINR)
+                {
+                  NI_LOG_FATAL("PHY_CELL_MEASUREMENT_IND numSubbandSinr > MAX_NUM_SUBBAND_SINR (" << phyCellMeasInd.cellMeasReportBody.numSubbandSinr << ")");
+                }
+              if (g_NiLogging.IsLevelEnabled (LOG__DEBUG))
                 {
-                  m_numPhyCellMeasInd++;
-                  DeserializePhyCellMeasurementInd( &phyCellMeasInd, m_pBufU8Pipe3, &m_bufOffsetU8Pipe3 );
-                  if (phyCellMeasInd.cellMeasReportBody.numSubbandSinr > MAX_NUM_SUBBAND_SINR)
-                    {
-                      NI_LOG_FATAL("PHY_CELL_MEASUREMENT_IND numSubbandSinr > MAX_NUM_SUBBAND_SINR (" << phyCellMeasInd.cellMeasReportBody.numSubbandSinr << ")");
-                    }
                   std::stringstream strSbSinr;
                   for(int j = 0; j < phyCellMeasInd.cellMeasReportBody.numSubbandSinr; j++)
                     {
@@ -415,98 +740,135 @@ NiPipeTransport::ReceiveCnfAndRxInd(void)
                                 " WBSINR: " << NiUtils::ConvertFxpI8_6_2ToDouble(phyCellMeasInd.cellMeasReportBody.widebandSinr) <<
                                 " Num SBSINR: " << phyCellMeasInd.cellMeasReportBody.numSubbandSinr <<
                                 " SBSINR[]: " << strSbSinr.str());
-                  if (m_niApiDevType == 1) // UE
-                    {
-                      m_niApiCellMeasurementEndOkCallback(phyCellMeasInd);
-                    }
-                  break;
                 }
-              case (PHY_CNF):
-                DeserializePhyCnf( &phyCnf, m_pBufU8Pipe3, &m_bufOffsetU8Pipe3 );
-                str = " for srcMsgType:" + std::to_string((uint16_t)phyCnf.cnfBody.srcMsgType) +
-                      " received in SFN: " +
-                       std::to_string((uint16_t) phyCnf.subMsgHdr.sfn) + " TTI: " +
-                       std::to_string((uint8_t) phyCnf.subMsgHdr.tti);
-                m_numPhyCnf[phyCnf.cnfBody.cnfStatus]++;
-                switch (phyCnf.cnfBody.cnfStatus)
+              if (m_niApiDevType == 1) // UE
                 {
-                  case CNF_SUCCESS:
-                    NI_LOG_DEBUG("CNF_SUCCESS" << str);
-                    break;
-                  case CNF_UNKNOWN_MESSAGE:
-                    NI_LOG_WARN("CNF_UNKNOWN_MESSAGE" << str);
-                    NI_LOG_CONSOLE_DEBUG("CNF_UNKNOWN_MESSAGE" << str);
-                    break;
-                  case CNF_MESSAGE_NOT_SUPPORTED:
-                    NI_LOG_WARN("CNF_MESSAGE_NOT_SUPPORTED" << str);
-                    NI_LOG_CONSOLE_DEBUG("CNF_MESSAGE_NOT_SUPPORTED" << str);
-                    break;
-                  case CNF_UNKNOWN_PARAMETER_SET:
-                    NI_LOG_WARN("CNF_UNKNOWN_PARAMETER_SET" << str);
-                    NI_LOG_CONSOLE_DEBUG("CNF_UNKNOWN_PARAMETER_SET" << str);
-                    break;
-                  case CNF_MISSING_PARAMETER_SET:
-                    NI_LOG_WARN("CNF_MISSING_PARAMETER_SET" << str);
-                    NI_LOG_CONSOLE_DEBUG("CNF_MISSING_PARAMETER_SET" << str);
-                    break;
-                  case CNF_PARAMETER_SET_REPETITION:
-                    NI_LOG_WARN("CNF_PARAMETER_SET_REPETITION" << str);
-                    NI_LOG_CONSOLE_DEBUG("CNF_PARAMETER_SET_REPETITION" << str);
-                    break;
-                  case CNF_RANGE_VIOLATION:
-                    NI_LOG_WARN("CNF_RANGE_VIOLATION" << str);
-                    NI_LOG_CONSOLE_DEBUG("CNF_RANGE_VIOLATION" << str);
-                    break;
-                  case CNF_STATE_VIOLATION:
-                    NI_LOG_WARN("CNF_STATE_VIOLATION" << str);
-                    NI_LOG_CONSOLE_DEBUG("CNF_STATE_VIOLATION" << str);
-                    break;
-                  case CNF_TIMEOUT:
-                    NI_LOG_WARN("CNF_TIMEOUT" << str);
-                    NI_LOG_CONSOLE_DEBUG("CNF_TIMEOUT" << str);
-                    break;
-                  case CNF_CONFIG_PAYLOAD_MISMATCH:
-                    NI_LOG_WARN("CNF_CONFIG_PAYLOAD_MISMATCH" << str);
-                    NI_LOG_CONSOLE_DEBUG("CNF_CONFIG_PAYLOAD_MISMATCH" << str);
-                    break;
-                  case CNF_LENGTH_MISMATCH:
-                    NI_LOG_WARN("CNF_LENGTH_MISMATCH" << str);
-                    NI_LOG_CONSOLE_DEBUG("CNF_LENGTH_MISMATCH" << str);
-                    break;
-                  case CNF_INPUT_BUFFER_FULL:
-                    NI_LOG_WARN("CNF_INPUT_BUFFER_FULL" << str);
-                    NI_LOG_CONSOLE_DEBUG("CNF_INPUT_BUFFER_FULL" << str);
-                    break;
-                  case CNF_INTERNAL_ERROR:
-                    NI_LOG_WARN("CNF_INTERNAL_ERROR" << str);
-                    NI_LOG_CONSOLE_DEBUG("CNF_INTERNAL_ERROR" << str);
-                    break;
-                  case CNF_INSTANCE_ID_MISMATCH:
-                    NI_LOG_WARN("CNF_INSTANCE_ID_MISMATCH" << str);
-                    NI_LOG_CONSOLE_DEBUG("CNF_INSTANCE_ID_MISMATCH" << str);
-                    break;
-                  default:
-                    NI_LOG_FATAL("Received UNKNOWN confirm. pipe=" << m_pipe_name_3 << " cnfStatus=" << phyCnf.cnfBody.cnfStatus);
-                    break;
+                  m_niApiCellMeasurementEndOkCallback(phyCellMeasInd);
                 }
-                done = true;
+              break;
+            }
+          case (PHY_CNF):
+            DeserializePhyCnf( &phyCnf, m_pBufU8Pipe3, &m_bufOffsetU8Pipe3 );
+            // the message suffix is only needed for debug output and failed requests
+            if ((phyCnf.cnfBody.cnfStatus != CNF_SUCCESS) || g_NiLogging.IsLevelEnabled (LOG__DEBUG))
+              {
+                str = " for srcMsgType:" + std::to_string((uint16_t)phyCnf.cnfBody.srcMsgType) +
+                      " received in SFN: " +
+                      std::to_string((uint16_t) phyCnf.subMsgHdr.sfn) + " TTI: " +
+                      std::to_string((uint8_t) phyCnf.subMsgHdr.tti);
+              }
+            m_numPhyCnf[phyCnf.cnfBody.cnfStatus]++;
+            if (phyCnf.cnfBody.cnfStatus == CNF_SUCCESS)
+              {
+                g_RemoteControlEngine.GetPdb()->numPhyCnfSuccess.Increment(1);
+              }
+            else
+              {
+                g_RemoteControlEngine.GetPdb()->numPhyCnfError.Increment(1);
+              }
+            switch (phyCnf.cnfBody.cnfStatus)
+            {
+              case CNF_SUCCESS:
+                NI_LOG_DEBUG("CNF_SUCCESS" << str);
+                break;
+              case CNF_UNKNOWN_MESSAGE:
+                NI_LOG_WARN("CNF_UNKNOWN_MESSAGE" << str);
+                NI_LOG_CONSOLE_DEBUG("CNF_UNKNOWN_MESSAGE" << str);
+                break;
+              case CNF_MESSAGE_NOT_SUPPORTED:
+                NI_LOG_WARN("CNF_MESSAGE_NOT_SUPPORTED" << str);
+                NI_LOG_CONSOLE_DEBUG("CNF_MESSAGE_NOT_SUPPORTED" << str);
+                break;
+              case CNF_UNKNOWN_PARAMETER_SET:
+                NI_LOG_WARN("CNF_UNKNOWN_PARAMETER_SET" << str);
+                NI_LOG_CONSOLE_DEBUG("CNF_UNKNOWN_PARAMETER_SET" << str);
+                break;
+              case CNF_MISSING_PARAMETER_SET:
+                NI_LOG_WARN("CNF_MISSING_PARAMETER_SET" << str);
+                NI_LOG_CONSOLE_DEBUG("CNF_MISSING_PARAMETER_SET" << str);
+                break;
+              case CNF_PARAMETER_SET_REPETITION:
+                NI_LOG_WARN("CNF_PARAMETER_SET_REPETITION" << str);
+                NI_LOG_CONSOLE_DEBUG("CNF_PARAMETER_SET_REPETITION" << str);
+                break;
+              case CNF_RANGE_VIOLATION:
+                NI_LOG_WARN("CNF_RANGE_VIOLATION" << str);
+                NI_LOG_CONSOLE_DEBUG("CNF_RANGE_VIOLATION" << str);
+                break;
+              case CNF_STATE_VIOLATION:
+                NI_LOG_WARN("CNF_STATE_VIOLATION" << str);
+                NI_LOG_CONSOLE_DEBUG("CNF_STATE_VIOLATION" << str);
+                break;
+              case CNF_TIMEOUT:
+                NI_LOG_WARN("CNF_TIMEOUT" << str);
+                NI_LOG_CONSOLE_DEBUG("CNF_TIMEOUT" << str);
+                break;
+              case CNF_CONFIG_PAYLOAD_MISMATCH:
+                NI_LOG_WARN("CNF_CONFIG_PAYLOAD_MISMATCH" << str);
+                NI_LOG_CONSOLE_DEBUG("CNF_CONFIG_PAYLOAD_MISMATCH" << str);
+                break;
+              case CNF_LENGTH_MISMATCH:
+                NI_LOG_WARN("CNF_LENGTH_MISMATCH" << str);
+                NI_LOG_CONSOLE_DEBUG("CNF_LENGTH_MISMATCH" << str);
+                break;
+              case CNF_INPUT_BUFFER_FULL:
+                NI_LOG_WARN("CNF_INPUT_BUFFER_FULL" << str);
+                NI_LOG_CONSOLE_DEBUG("CNF_INPUT_BUFFER_FULL" << str);
+                break;
+              case CNF_INTERNAL_ERROR:
+                NI_LOG_WARN("CNF_INTERNAL_ERROR" << str);
+                NI_LOG_CONSOLE_DEBUG("CNF_INTERNAL_ERROR" << str);
+                break;
+              case CNF_INSTANCE_ID_MISMATCH:
+                NI_LOG_WARN("CNF_INSTANCE_ID_MISMATCH" << str);
+                NI_LOG_CONSOLE_DEBUG("CNF_INSTANCE_ID_MISMATCH" << str);
                 break;
               default:
-                NI_LOG_FATAL("Received UNKNOWN message. pipe=" << m_pipe_name_3 << " msgType=" << msgType);
-                done = true;
+                NI_LOG_FATAL("Received UNKNOWN confirm. pipe=" << m_pipe_name_3 << " cnfStatus=" << phyCnf.cnfBody.cnfStatus);
                 break;
             }
-          }
-        else {
-            iteration++;
-            if (iteration > 1000) {
-                NI_LOG_NONE ("1000 x nothing received");
-                iteration = 0;
-            }
+            break;
+          default:
+            NI_LOG_FATAL("Received UNKNOWN message. pipe=" << m_pipe_name_3 << " msgType=" << msgType);
+            break;
         }
-        if (done || m_rxThreadStop) break;
-        nanosleep( &m_ts, NULL );   // wait a little bit and then start over again
-      }
+
+  g_NiLatency.Record(NI_LATENCY_RX_HANDLER, NiUtils::GetSysTimeNs() - readTimeNs);
+  return true;
+}
+
+void
+NiPipeTransport::UpdateRxThreadStats(NiPipeRxThreadStats* pStats, uint64_t wakeupTimeNs, bool handled)
+{
+  pStats->numWakeups++;
+  if (!handled)
+    {
+      pStats->numIdleWakeups++;
+      return;
+    }
+  const uint64_t latencyNs = NiUtils::GetSysTimeNs() - wakeupTimeNs;
+  pStats->numLatency++;
+  pStats->sumLatencyNs += latencyNs;
+  if (latencyNs < pStats->minLatencyNs) pStats->minLatencyNs = latencyNs;
+  if (latencyNs > pStats->maxLatencyNs) pStats->maxLatencyNs = latencyNs;
+}
+
+void
+NiPipeTransport::PrintRxThreadStats(std::string name, NiPipeRxThreadStats* pStats)
+{
+  const double cpuLoad = (pStats->wallTimeUs > 0) ? (100.0 * pStats->cpuTimeUs / pStats->wallTimeUs) : 0.0;
+  NI_LOG_CONSOLE_INFO(name << " (" << ((m_rxMode == NI_PIPE_RX_MODE_EPOLL) ? "epoll" : "polling") << " mode):");
+  // per instance reactor stats have no thread of their own
+  if (pStats->wallTimeUs > 0)
+    {
+      NI_LOG_CONSOLE_INFO("  cpu usage        = " << cpuLoad << " % (" << pStats->cpuTimeUs << " us / " << pStats->wallTimeUs << " us)");
+    }
+  NI_LOG_CONSOLE_INFO("  wakeups          = " << pStats->numWakeups << " (idle: " << pStats->numIdleWakeups << ")");
+  if (pStats->numLatency > 0)
+    {
+      NI_LOG_CONSOLE_INFO("  wakeup->handler  = avg " << (pStats->sumLatencyNs / pStats->numLatency) / 1000.0 <<
+                          " us, min " << pStats->minLatencyNs / 1000.0 <<
+                          " us, max " << pStats->maxLatencyNs / 1000.0 << " us");
     }
 }
 
@@ -558,8 +920,13 @@ int32_t NiPipeTransport::CreateAndSendDlTxConfigReqMsg(
   SerializePhyDlTxConfigReq( &phyDlTxConfigReq, m_pBufU8Pipe2, &m_bufOffsetU8Pipe2 );
 
   // send tx config request message to lte application framework l1-l2 api
-  nwrite = NiPipe::PipeWrite( &m_fd2, m_pBufU8Pipe2, (uint16_t)m_bufOffsetU8Pipe2 );
+  struct iovec iov;
+  iov.iov_base = m_pBufU8Pipe2;
+  iov.iov_len  = m_bufOffsetU8Pipe2;
+  nwrite = SendTxMsg( &iov, 1 );
   m_numPhyDlTxConfigReq++;
+  m_numDlschTxPdus++;
+  if (m_maxDlschTxPdusPerTti < 1) m_maxDlschTxPdusPerTti = 1;
 
   return nwrite;
 }
@@ -571,50 +938,150 @@ int32_t NiPipeTransport::CreateAndSendDlTxPayloadReqMsg(
     uint32_t tbsSize
 )
 {
-  int32_t  nwrite     = 0;
-
-  const int numBytes = 32;
-  char buffer [numBytes*2+1];
-  for(int j = 0; j < numBytes; j++)
-    {
-      sprintf(&buffer[2*j], "%02X", macPduPacket[j]);
-    }
-
   NI_LOG_DEBUG ("Create DL Payload REQ Message with"
                 " sfn: " << sfn <<
                 ", tti: " << tti <<
-                ", macPduPacket[]: " << buffer <<
+                ", macPduPacket[]: " << PrintMacPdu(macPduPacket, tbsSize) <<
                 ", tbsSize: " << tbsSize);
 
-  // create dl payload request data structure and initialize
-  PhyDlTxPayloadReq phyDlTxPayloadReq;
-  InitializePhyDlTxPayloadReq( &phyDlTxPayloadReq );
-  // update general and sub message headers
-  phyDlTxPayloadReq.genMsgHdr.refId                   = m_msgRefId++;
-  phyDlTxPayloadReq.genMsgHdr.bodyLength              = 17+tbsSize;
-  phyDlTxPayloadReq.subMsgHdr.cnfMode                 = 1;    // request confirmations from PHY
-  phyDlTxPayloadReq.subMsgHdr.sfn                     = GetTimingIndSfn(); //TODO-NI: replace by caller Sfn
-  phyDlTxPayloadReq.subMsgHdr.tti                     = GetTimingIndTti(); //TODO-NI: replace by caller Tti
-  // update dlsch mac pdu fields
-  phyDlTxPayloadReq.dlschMacPduTxHdr.parSetBodyLength = 4+tbsSize;
-  phyDlTxPayloadReq.dlschMacPduTxBody.macPduIndex     = m_macPduIndex;
-  phyDlTxPayloadReq.dlschMacPduTxBody.macPduSize      = tbsSize;
-
-  // store mac pdu into buffer
-  // TODO-NI: remove this memcpy by handing over the mempointer to the upper layer
-  memcpy(phyDlTxPayloadReq.dlschMacPduTxBody.macPdu, macPduPacket, tbsSize);
   m_numPhyDlTxPayloadReq++;
 
-  // serialize dl payload request message
+  return CreateAndSendTxPayloadReqMsg(PHY_DL_TX_PAYLOAD_REQ, macPduPacket, tbsSize);
+}
+
+// Serializes the config request with one DLSCH config and DCI DL grant parameter set
+// pair per PDU followed by the headers of the payload request into the tx buffer. The
+// MAC PDUs are taken directly from the caller buffers, so both messages are sent with
+// one gather write of 2*numPdus iovecs. Each PDU gets its own MAC PDU index which links
+// its config parameter sets to its payload parameter set, and its DCI its own CCEs.
+int32_t NiPipeTransport::CreateAndSendDlTxReqMsgs(
+    uint32_t sfn,
+    uint32_t tti,
+    const NiDlschTxPdu* pdus,
+    uint32_t numPdus
+)
+{
+  if ((numPdus == 0) || (numPdus > MAX_NUM_DLSCH_PDUS))
+    {
+      NI_LOG_FATAL("NiPipeTransport::CreateAndSendDlTxReqMsgs: numPdus " << numPdus << " not within 1.." << MAX_NUM_DLSCH_PDUS);
+      return -1;
+    }
+
+  // payload request body = sub message header + one parameter set per PDU
+  uint32_t payloadBodyLength = 8;
+  for (uint32_t i = 0; i < numPdus; i++)
+    {
+      if (pdus[i].tbsSize > MAX_MAC_PDU_SIZE)
+        {
+          NI_LOG_FATAL("NiPipeTransport::CreateAndSendDlTxReqMsgs: tbsSize " << pdus[i].tbsSize << " exceeds MAX_MAC_PDU_SIZE");
+          return -1;
+        }
+      payloadBodyLength += PHY_TX_PAYLOAD_PAR_SET_HDR_SIZE + pdus[i].tbsSize;
+    }
+  if (8 + payloadBodyLength > m_maxPacketSize)
+    {
+      NI_LOG_FATAL("NiPipeTransport::CreateAndSendDlTxReqMsgs: payload request of " << 8 + payloadBodyLength << " bytes exceeds max payload size");
+      return -1;
+    }
+
+  // both requests have to refer to the same TTI
+  // TODO-NI: re-calculate NS-3 timing to PHY timing
+  const uint32_t phySfn = GetTimingIndSfn(); //TODO-NI: replace by caller Sfn
+  const uint32_t phyTti = GetTimingIndTti(); //TODO-NI: replace by caller Tti
+
+  // create dl config request data structure and initialize
+  PhyDlTxConfigReq phyDlTxConfigReq;
+  InitializePhyDlTxConfigReq( &phyDlTxConfigReq );
+  phyDlTxConfigReq.genMsgHdr.refId                      = m_msgRefId++;
+  phyDlTxConfigReq.genMsgHdr.bodyLength                 = 8 + numPdus*PHY_DL_TX_CONFIG_PAR_SETS_SIZE;
+  phyDlTxConfigReq.subMsgHdr.numSubMsg                  = 2*numPdus;
+  phyDlTxConfigReq.subMsgHdr.cnfMode                    = 1;    // request confirmations from PHY
+  phyDlTxConfigReq.subMsgHdr.sfn                        = phySfn;
+  phyDlTxConfigReq.subMsgHdr.tti                        = phyTti;
+
+  // create tx payload request header and initialize
+  PhyTxPayloadReqHdr phyTxPayloadReqHdr;
+  InitializePhyTxPayloadReqHdr( &phyTxPayloadReqHdr, PHY_DL_TX_PAYLOAD_REQ );
+  phyTxPayloadReqHdr.genMsgHdr.refId                  = m_msgRefId++;
+  phyTxPayloadReqHdr.genMsgHdr.bodyLength             = payloadBodyLength;
+  phyTxPayloadReqHdr.subMsgHdr.numSubMsg              = numPdus;
+  phyTxPayloadReqHdr.subMsgHdr.cnfMode                = 1;    // request confirmations from PHY
+  phyTxPayloadReqHdr.subMsgHdr.sfn                    = phySfn;
+  phyTxPayloadReqHdr.subMsgHdr.tti                    = phyTti;
+
+  // config request - the first parameter set pair is part of the complete message
   m_bufOffsetU8Pipe2 = 0;
+  const uint64_t firstMacPduIndex = m_macPduIndex + 1;
+  for (uint32_t i = 0; i < numPdus; i++)
+    {
+      NI_LOG_DEBUG ("Create DL Config REQ parameter sets with" <<
+                    " sfn: " << sfn <<
+                    ", tti: " << tti <<
+                    ", pdu: " << i <<
+                    ", prbAlloc: " << (std::bitset<32>) pdus[i].prbAlloc <<
+                    ", rnti: " << pdus[i].rnti <<
+                    ", mcs: " << pdus[i].mcs <<
+                    ", tbsSize: " << pdus[i].tbsSize);
+
+      // update dlsch config
+      phyDlTxConfigReq.dlschTxConfigHdr.parSetId            = i;
+      phyDlTxConfigReq.dlschTxConfigBody.macPduIndex        = ++m_macPduIndex;
+      phyDlTxConfigReq.dlschTxConfigBody.rnti               = pdus[i].rnti;
+      phyDlTxConfigReq.dlschTxConfigBody.prbAllocation      = pdus[i].prbAlloc;
+      phyDlTxConfigReq.dlschTxConfigBody.mcs                = pdus[i].mcs;
+      // update dci config
+      phyDlTxConfigReq.dciTxConfigDlGrantHdr.parSetId       = i;
+      phyDlTxConfigReq.dciTxConfigDlGrantBody.rnti          = pdus[i].rnti;
+      phyDlTxConfigReq.dciTxConfigDlGrantBody.cceOffset     = i * NI_PIPE_DL_DCI_NUM_CCE;
+      phyDlTxConfigReq.dciTxConfigDlGrantBody.prbAllocation = pdus[i].prbAlloc;
+      phyDlTxConfigReq.dciTxConfigDlGrantBody.mcs           = pdus[i].mcs;
+      phyDlTxConfigReq.dciTxConfigDlGrantBody.tpc           = 0;
+
+      if (i == 0)
+        {
+          SerializePhyDlTxConfigReq( &phyDlTxConfigReq, m_pBufU8Pipe2, &m_bufOffsetU8Pipe2 );
+        }
+      else
+        {
+          SerializePhyDlTxConfigReqParSets( &phyDlTxConfigReq, m_pBufU8Pipe2, &m_bufOffsetU8Pipe2 );
+        }
+    }
 
+  // payload request - headers in the tx buffer, mac pdus referenced from the caller buffers
+  struct iovec iov[2*MAX_NUM_DLSCH_PDUS];
+  uint32_t iovCnt = 0;
+  uint32_t hdrStart = 0;
+  for (uint32_t i = 0; i < numPdus; i++)
+    {
+      phyTxPayloadReqHdr.macPduTxHdr.parSetId             = i;
+      phyTxPayloadReqHdr.macPduTxHdr.parSetBodyLength     = 4+pdus[i].tbsSize;
+      phyTxPayloadReqHdr.macPduTxBodyHdr.macPduIndex      = firstMacPduIndex + i;
+      phyTxPayloadReqHdr.macPduTxBodyHdr.macPduSize       = pdus[i].tbsSize;
 
-  SerializePhyDlTxPayloadReq( &phyDlTxPayloadReq, m_pBufU8Pipe2, &m_bufOffsetU8Pipe2 );
+      if (i == 0)
+        {
+          // config request and first payload header are contiguous
+          SerializePhyTxPayloadReqHdr( &phyTxPayloadReqHdr, m_pBufU8Pipe2, &m_bufOffsetU8Pipe2 );
+        }
+      else
+        {
+          SerializePhyTxPayloadReqParSetHdr( &phyTxPayloadReqHdr, m_pBufU8Pipe2, &m_bufOffsetU8Pipe2 );
+        }
+      iov[iovCnt].iov_base = m_pBufU8Pipe2 + hdrStart;
+      iov[iovCnt].iov_len  = m_bufOffsetU8Pipe2 - hdrStart;
+      iovCnt++;
+      iov[iovCnt].iov_base = pdus[i].macPdu;
+      iov[iovCnt].iov_len  = pdus[i].tbsSize;
+      iovCnt++;
+      hdrStart = m_bufOffsetU8Pipe2;
+    }
 
-  // send tx payload request message to lte application framework l1-l2 api
-  nwrite = NiPipe::PipeWrite(&m_fd2, m_pBufU8Pipe2, (uint16_t)m_bufOffsetU8Pipe2);
+  m_numPhyDlTxConfigReq++;
+  m_numPhyDlTxPayloadReq++;
+  m_numDlschTxPdus += numPdus;
+  if (numPdus > m_maxDlschTxPdusPerTti) m_maxDlschTxPdusPerTti = numPdus;
 
-  return nwrite;
+  return SendTxMsg(iov, iovCnt);
 }
 
 int32_t NiPipeTransport::CreateAndSendUlTxPayloadReqMsg(
@@ -624,50 +1091,70 @@ int32_t NiPipeTransport::CreateAndSendUlTxPayloadReqMsg(
     uint32_t tbsSize
 )
 {
-  int32_t  nwrite     = 0;
-
-  const int numBytes = 32;
-  char buffer [numBytes*2+1];
-  for(int j = 0; j < numBytes; j++)
-    {
-      sprintf(&buffer[2*j], "%02X", macPduPacket[j]);
-    }
-
   NI_LOG_DEBUG ("Create UL Payload REQ Message with"
                 " sfn: " << sfn <<
                 ", tti: " << tti <<
-                ", macPduPacket[]: " << buffer <<
+                ", macPduPacket[]: " << PrintMacPdu(macPduPacket, tbsSize) <<
                 ", tbsSize: " << tbsSize);
 
-  // create ul payload request data structure and initialize
-  PhyUlTxPayloadReq phyUlTxPayloadReq;
-  InitializePhyUlTxPayloadReq( &phyUlTxPayloadReq );
-  // update general and sub message headers
-  phyUlTxPayloadReq.genMsgHdr.refId                   = m_msgRefId++;
-  phyUlTxPayloadReq.genMsgHdr.bodyLength              = 17+tbsSize;
-  phyUlTxPayloadReq.subMsgHdr.cnfMode                 = 1;    // request confirmations from PHY
-  phyUlTxPayloadReq.subMsgHdr.sfn                     = GetTimingIndSfn(); //TODO-NI: replace by caller Sfn
-  phyUlTxPayloadReq.subMsgHdr.tti                     = GetTimingIndTti(); //TODO-NI: replace by caller Tti
-  // update dlsch mac pdu fields
-  phyUlTxPayloadReq.ulschMacPduTxHdr.parSetBodyLength = 4+tbsSize;
-  phyUlTxPayloadReq.ulschMacPduTxBody.macPduIndex     = m_macPduIndex;
-  phyUlTxPayloadReq.ulschMacPduTxBody.macPduSize      = tbsSize;
-
-  // store mac pdu into buffer
-  // TODO-NI: remove this memcpy by handing over the mempointer to the upper layer
-  memcpy(phyUlTxPayloadReq.ulschMacPduTxBody.macPdu, macPduPacket, tbsSize);
   m_numPhyUlTxPayloadReq++;
 
-  // serialize dl payload request message
-  m_bufOffsetU8Pipe2 = 0;
+  return CreateAndSendTxPayloadReqMsg(PHY_UL_TX_PAYLOAD_REQ, macPduPacket, tbsSize);
+}
 
+// Serializes only the message headers and sends them together with the MAC PDU
+// taken directly from the caller buffer using one gather write, i.e. without
+// copying the MAC PDU into an intermediate message structure or buffer.
+int32_t NiPipeTransport::CreateAndSendTxPayloadReqMsg(
+    uint32_t msgType,
+    uint8_t* macPduPacket,
+    uint32_t tbsSize
+)
+{
+  if (tbsSize > MAX_MAC_PDU_SIZE)
+    {
+      NI_LOG_FATAL("NiPipeTransport::CreateAndSendTxPayloadReqMsg: tbsSize " << tbsSize << " exceeds MAX_MAC_PDU_SIZE");
+      return -1;
+    }
 
-  SerializePhyUlTxPayloadReq( &phyUlTxPayloadReq, m_pBufU8Pipe2, &m_bufOffsetU8Pipe2 );
+  // create tx payload request header and initialize
+  PhyTxPayloadReqHdr phyTxPayloadReqHdr;
+  InitializePhyTxPayloadReqHdr( &phyTxPayloadReqHdr, msgType );
+  // update general and sub message headers
+  phyTxPayloadReqHdr.genMsgHdr.refId                  = m_msgRefId++;
+  phyTxPayloadReqHdr.genMsgHdr.bodyLength             = 17+tbsSize;
+  phyTxPayloadReqHdr.subMsgHdr.cnfMode                = 1;    // request confirmations from PHY
+  phyTxPayloadReqHdr.subMsgHdr.sfn                    = GetTimingIndSfn(); //TODO-NI: replace by caller Sfn
+  phyTxPayloadReqHdr.subMsgHdr.tti                    = GetTimingIndTti(); //TODO-NI: replace by caller Tti
+  // update mac pdu fields
+  phyTxPayloadReqHdr.macPduTxHdr.parSetBodyLength     = 4+tbsSize;
+  phyTxPayloadReqHdr.macPduTxBodyHdr.macPduIndex      = m_macPduIndex;
+  phyTxPayloadReqHdr.macPduTxBodyHdr.macPduSize       = tbsSize;
+
+  // serialize headers only
+  m_bufOffsetU8Pipe2 = 0;
+  SerializePhyTxPayloadReqHdr( &phyTxPayloadReqHdr, m_pBufU8Pipe2, &m_bufOffsetU8Pipe2 );
 
-  // send tx payload request message to lte application framework l1-l2 api
-  nwrite = NiPipe::PipeWrite(&m_fd2, m_pBufU8Pipe2, (uint16_t)m_bufOffsetU8Pipe2);
+  // send headers and mac pdu to lte application framework l1-l2 api
+  struct iovec iov[2];
+  iov[0].iov_base = m_pBufU8Pipe2;
+  iov[0].iov_len  = m_bufOffsetU8Pipe2;
+  iov[1].iov_base = macPduPacket;
+  iov[1].iov_len  = tbsSize;
 
-  return nwrite;
+  return SendTxMsg(iov, 2);
+}
+
+// hex dump of the first bytes of a mac pdu for debug output
+std::string NiPipeTransport::PrintMacPdu(uint8_t* macPduPacket, uint32_t tbsSize)
+{
+  const uint32_t numBytes = 32;
+  char buffer [numBytes*2+1] = {0};
+  for(uint32_t j = 0; (j < numBytes) && (j < tbsSize); j++)
+    {
+      sprintf(&buffer[2*j], "%02X", macPduPacket[j]);
+    }
+  return std::string(buffer);
 }
 
 
@@ -681,9 +1168,49 @@ void NiPipeTransport::SetNiApiCellMeasurementEndOkCallback (NiPipeTransportCellM
     m_niApiCellMeasurementEndOkCallback = c;
   }
 
+void NiPipeTransport::SetNiApiCrcResultCallback (NiPipeTransportCrcResultCallback c)
+  {
+    m_niApiCrcResultCallback = c;
+  }
+
 void NiPipeTransport::SetNiApiDevType(uint8_t niApiDevType)
   {
     m_niApiDevType = niApiDevType;
   }
 
+void NiPipeTransport::SetRxMode(NiPipeRxMode_t rxMode, bool useEventFd)
+  {
+    m_rxMode = rxMode;
+    m_useEventFd = useEventFd;
+  }
+
+void NiPipeTransport::SetInstanceId(uint32_t instanceId)
+  {
+    if (instanceId >= NI_PIPE_MAX_INSTANCES)
+      {
+        NI_LOG_FATAL("NiPipeTransport::SetInstanceId: instance " << instanceId << " exceeds maximum of " << NI_PIPE_MAX_INSTANCES);
+      }
+    m_instanceId = instanceId;
+    m_pipe_name_1 = GetPipeName(instanceId, NI_PIPE_IDX_TIMING_IND);
+    m_pipe_name_2 = GetPipeName(instanceId, NI_PIPE_IDX_TX);
+    m_pipe_name_3 = GetPipeName(instanceId, NI_PIPE_IDX_RX);
+  }
+
+uint32_t NiPipeTransport::GetInstanceId(void) const
+  {
+    return m_instanceId;
+  }
+
+// AFW 2.2 provides a single instance with pipes numbered 0..2, later versions
+// and further instances use api_transport_<instance>-<pipe>
+std::string NiPipeTransport::GetPipeName(uint32_t instanceId, uint32_t pipeIdx)
+  {
+    if (instanceId == 0)
+      {
+        const char* names[] = {NI_PIPE_NAME_TIMING_IND, NI_PIPE_NAME_TX, NI_PIPE_NAME_RX};
+        return names[pipeIdx];
+      }
+    return "/tmp/api_transport_" + std::to_string(instanceId) + "-" + std::to_string(pipeIdx) + "_pipe";
+  }
+
 } //namespace ns3
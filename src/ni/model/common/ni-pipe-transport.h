@@ -23,21 +23,96 @@
 #define NI_PIPE_TRANSPORT_H_
 
 #include <cstdio>
+#include <cstdint>
+#include <string>
+#include <sys/uio.h>
 
 #include "ns3/object.h"
 #include "ns3/system-thread.h"
 //#include "ns3/ni.h"
 #include "ni-common-constants.h"
+#include "ni-seqlock.h"
 #include "ns3/ni-l1-l2-api-lte.h"
 
 namespace ns3 {
-  typedef Callback< bool, uint8_t* > NiPipeTransportDataEndOkCallback;
+  // pipe names are defined by the LTE Application Framework
+#if (NI_AFW_VERSION_MAJOR == 2 && NI_AFW_VERSION_MINOR == 2)
+#define NI_PIPE_NAME_TIMING_IND "/tmp/api_transport_0_pipe"    // phy timing ind
+#define NI_PIPE_NAME_TX         "/tmp/api_transport_1_pipe"    // phy tx cfg/payl
+#define NI_PIPE_NAME_RX         "/tmp/api_transport_2_pipe"    // phy rx ind / cnf
+#else
+#define NI_PIPE_NAME_TIMING_IND "/tmp/api_transport_0-0_pipe"  // phy timing ind
+#define NI_PIPE_NAME_TX         "/tmp/api_transport_0-1_pipe"  // phy tx cfg/payl
+#define NI_PIPE_NAME_RX         "/tmp/api_transport_0-2_pipe"  // phy rx ind / cnf
+#endif
+  // one AFW instance (eNB / carrier) provides three pipes, api_transport_<instance>-<pipe>
+#define NI_PIPE_IDX_TIMING_IND  0
+#define NI_PIPE_IDX_TX          1
+#define NI_PIPE_IDX_RX          2
+#define NI_PIPE_MAX_INSTANCES   16
+  // PDCCH CCEs of each DL grant DCI, the DCIs of the PDUs of one TTI get consecutive,
+  // non-overlapping CCE offsets (16 PDUs need 64 CCEs, available from 10 MHz on)
+#define NI_PIPE_DL_DCI_NUM_CCE  4
+
+  typedef Callback< bool, uint8_t*, uint32_t > NiPipeTransportDataEndOkCallback;
   typedef Callback< bool, PhyCellMeasInd > NiPipeTransportCellMeasurementEndOkCallback;
+  // rnti and crc result of each received DLSCH/ULSCH transport block, also called for failed ones
+  typedef Callback< bool, uint16_t, bool > NiPipeTransportCrcResultCallback;
+
+  // receive mode of the pipe transport
+  typedef enum {
+    NI_PIPE_RX_MODE_POLLING = 0, // one thread per rx pipe polling with select timeout and nanosleep
+    NI_PIPE_RX_MODE_EPOLL   = 1, // one reactor thread blocking on epoll for the rx pipes of all instances
+  } NiPipeRxMode_t;
+
+  // PHY timing state published by the timing ind thread - read as one consistent snapshot
+  typedef struct sNiPhyTimingSnapshot {
+    uint64_t seqNum            = 0;    // number of timing indications received, 0 = none yet
+    uint64_t sysTimeUs         = 1000; // reception time, 1 TTI = 1 ms before the first indication
+    uint64_t sysTimeNs         = 0;
+    uint32_t sfn               = 0;
+    uint32_t tti               = 0;
+  } NiPhyTimingSnapshot;
+
+  // measurements of WaitForTimingInd - wake latency is the time from publishing
+  // the timing indication until the waiting thread has the snapshot
+  typedef struct sNiTimingIndWaitStats {
+    uint64_t numWaits          = 0;
+    uint64_t numImmediate      = 0; // indication was already available
+    uint64_t numSpin           = 0; // received within the spin phase
+    uint64_t numBlocked        = 0; // futex wait needed
+    uint64_t numTimeouts       = 0;
+    uint64_t numWakeLatency    = 0;
+    uint64_t sumWakeLatencyNs  = 0;
+    uint64_t maxWakeLatencyNs  = 0;
+    uint64_t lastWakeLatencyNs = 0;
+  } NiTimingIndWaitStats;
 
+  // DLSCH MAC PDU of one UE together with its DL grant
+  typedef struct sNiDlschTxPdu {
+    uint32_t prbAlloc;
+    uint32_t rnti;
+    uint32_t mcs;
+    uint8_t* macPdu;
+    uint32_t tbsSize;
+  } NiDlschTxPdu;
+
+  // receive thread measurements - cpu usage and wakeup-to-handler latency
+  typedef struct sNiPipeRxThreadStats {
+    uint64_t numWakeups        = 0; // returns of select / epoll_wait
+    uint64_t numIdleWakeups    = 0; // wakeups where no message was handled
+    uint64_t cpuTimeUs         = 0; // consumed thread cpu time
+    uint64_t wallTimeUs        = 0; // thread life time
+    uint64_t numLatency        = 0; // number of handled messages
+    uint64_t sumLatencyNs      = 0; // wakeup until message handler finished
+    uint64_t minLatencyNs      = UINT64_MAX;
+    uint64_t maxLatencyNs      = 0;
+  } NiPipeRxThreadStats;
 
   // note - used as member of ns-3 object class - mainly used for callback functionality
   class NiPipeTransport : public Object
   {
+    friend class NiPipeReactor;
   public:
     NiPipeTransport ();
     NiPipeTransport (std::string context);
@@ -50,6 +125,12 @@ namespace ns3 {
     bool GetTimingIndReceived(void);
     uint8_t GetTimingIndTti(void);
     uint16_t GetTimingIndSfn(void);
+    // consistent copy of time, SFN and TTI of the last timing indication
+    void GetTimingSnapshot(NiPhyTimingSnapshot* pSnapshot);
+    // waits until a timing indication newer than lastSeqNum was received, spinning for
+    // up to spinNs before blocking, returns false on timeout (timeoutNs 0 = none)
+    bool WaitForTimingInd(uint64_t lastSeqNum, NiPhyTimingSnapshot* pSnapshot, uint64_t spinNs, uint64_t timeoutNs);
+    const NiTimingIndWaitStats& GetTimingIndWaitStats(void) const;
     int32_t DeInit(void);
 
     int32_t CreateAndSendDlTxConfigReqMsg(
@@ -68,6 +149,15 @@ namespace ns3 {
         uint32_t tbsSize
     );
 
+    // sends the DLSCH PDUs of up to MAX_NUM_DLSCH_PDUS UEs of one TTI as one PHY_DL_TX_CONFIG_REQ
+    // and one PHY_DL_TX_PAYLOAD_REQ with one parameter set pair per PDU, both with a single write
+    int32_t CreateAndSendDlTxReqMsgs(
+        uint32_t sfn,
+        uint32_t tti,
+        const NiDlschTxPdu* pdus,
+        uint32_t numPdus
+    );
+
     int32_t CreateAndSendUlTxPayloadReqMsg(
         uint32_t sfn,
         uint32_t tti,
@@ -78,67 +168,101 @@ namespace ns3 {
 
     void SetNiApiDataEndOkCallback (NiPipeTransportDataEndOkCallback c);
     void SetNiApiCellMeasurementEndOkCallback (NiPipeTransportCellMeasurementEndOkCallback c);
+    void SetNiApiCrcResultCallback (NiPipeTransportCrcResultCallback c);
     void SetNiApiDevType(uint8_t niApiDevType);
+    // has to be called before Init
+    void SetRxMode(NiPipeRxMode_t rxMode, bool useEventFd = true);
+    // index of the AFW instance the pipes belong to, has to be called before Init
+    void SetInstanceId(uint32_t instanceId);
+    uint32_t GetInstanceId(void) const;
+
+    // name of pipe NI_PIPE_IDX_* of an AFW instance - instance 0 uses the NI_PIPE_NAME_* names
+    static std::string GetPipeName(uint32_t instanceId, uint32_t pipeIdx);
+
+  protected:
+    // transport specific i/o - the named pipe implementation is the default,
+    // derived transports (e.g. shared memory) override these functions
+    virtual int32_t OpenTransport(void);
+    virtual void CloseTransport(void);
+    // read one complete message (general message header + body), returns 0 if none is available
+    virtual int32_t ReadTimingIndMsg(uint8_t* pBufU8, uint32_t maxLen);
+    virtual int32_t ReadRxMsg(uint8_t* pBufU8, uint32_t maxLen);
+    // write one complete message given as gather list
+    virtual int32_t WriteTxMsg(const struct iovec* pIov, int32_t iovCnt);
+    // called by the rx threads if nothing was received
+    virtual void IdleWait(void);
+
+    NiPipeRxMode_t m_rxMode = NI_PIPE_RX_MODE_POLLING;
 
   private:
     // private function prototypes
     void ReceiveTimingInd(void);
     void ReceiveCnfAndRxInd(void);
+    int32_t CreateAndSendTxPayloadReqMsg(uint32_t msgType, uint8_t* macPduPacket, uint32_t tbsSize);
+    int32_t SendTxMsg(const struct iovec* pIov, int32_t iovCnt);
+    std::string PrintMacPdu(uint8_t* macPduPacket, uint32_t tbsSize);
+    bool HandleTimingInd(void);
+    bool HandleCnfAndRxInd(void);
+    int32_t ReadPipeNonBlocking(int32_t* pFd, uint8_t* pBufU8, uint32_t len, uint32_t* pNumRead);
+    int32_t ReadRxMsgNonBlocking(uint8_t* pBufU8, uint32_t maxLen);
+    void UpdateRxThreadStats(NiPipeRxThreadStats* pStats, uint64_t wakeupTimeNs, bool handled);
+    void PrintRxThreadStats(std::string name, NiPipeRxThreadStats* pStats);
 
 
     static const size_t m_maxPacketSize = NI_COMMON_CONST_MAX_PAYLOAD_SIZE; // bytes
 
     const struct timespec m_ts = {0, 10000L};  // 10us wait time within threads to CPU consumption
 
-    // pipe names are defined by the LTE Application Framework
+    // pipe names are defined by the LTE Application Framework and the instance index
+    uint32_t m_instanceId = 0;
     // phy timing ind
-#if (NI_AFW_VERSION_MAJOR == 2 && NI_AFW_VERSION_MINOR == 2)
-    char* m_pipe_name_1 = (char*)"/tmp/api_transport_0_pipe";
-#else
-    char* m_pipe_name_1 = (char*)"/tmp/api_transport_0-0_pipe";
-#endif
+    std::string m_pipe_name_1 = NI_PIPE_NAME_TIMING_IND;
     int32_t m_fd1 = -1;
     fd_set m_readFds1;
     int32_t m_fdMax1 = 0;
     uint8_t*  m_pBufU8Pipe1;
     uint32_t m_bufOffsetU8Pipe1 = 0;
+    // bytes of a partially received message in epoll mode
+    uint32_t m_numReadPipe1 = 0;
     // phy tx cfg/payl
-#if (NI_AFW_VERSION_MAJOR == 2 && NI_AFW_VERSION_MINOR == 2)
-    char* m_pipe_name_2 = (char*)"/tmp/api_transport_1_pipe";
-#else
-    char* m_pipe_name_2 = (char*)"/tmp/api_transport_0-1_pipe";
-#endif
+    std::string m_pipe_name_2 = NI_PIPE_NAME_TX;
     int32_t m_fd2 = -1;
     uint8_t*  m_pBufU8Pipe2;
     uint32_t m_bufOffsetU8Pipe2 = 0;
     // phy rx ind
-#if (NI_AFW_VERSION_MAJOR == 2 && NI_AFW_VERSION_MINOR == 2)
-    char* m_pipe_name_3 = (char*)"/tmp/api_transport_2_pipe";
-#else
-    char* m_pipe_name_3 = (char*)"/tmp/api_transport_0-2_pipe";
-#endif
+    std::string m_pipe_name_3 = NI_PIPE_NAME_RX;
     int32_t m_fd3 = -1;
     fd_set m_readFds3;
     int32_t m_fdMax3 = 0;
     uint8_t*  m_pBufU8Pipe3;
     uint32_t m_bufOffsetU8Pipe3 = 0;
+    uint32_t m_numReadPipe3 = 0;
 
-    uint64_t m_sysTimeUs = 1000; // 1 TTI = 1 ms
-    uint64_t m_lastSysTimeUs = 0;
-    uint8_t m_tti = 0;
-    uint16_t m_sfn = 0;
+    // written by the timing ind thread only, published via m_timingSnapshot
+    NiPhyTimingSnapshot m_lastTimingSnapshot;
+    NiSeqlock<NiPhyTimingSnapshot> m_timingSnapshot;
+    NiTimingIndWaitStats m_timingIndWaitStats;
 
     Ptr<SystemThread> m_timingIndThread;
     int m_timingIndThreadPriority = 0;
     bool m_timingIndThreadStop = false;
-    bool m_timingIndReceived = false;
 
     Ptr<SystemThread> m_rxThread;
     NiPipeTransportDataEndOkCallback m_niApiDataEndOkCallback;
     NiPipeTransportCellMeasurementEndOkCallback m_niApiCellMeasurementEndOkCallback;
+    NiPipeTransportCrcResultCallback m_niApiCrcResultCallback;
     int m_rxThreadpriority = 0;
     bool m_rxThreadStop = false;
 
+    // epoll mode registers the rx pipes with the process wide reactor (g_NiPipeReactor),
+    // shutdown of the reactor thread is signaled by eventfd or detected by a bounded epoll wait
+    bool m_useEventFd = true;
+
+    NiPipeRxThreadStats m_timingIndThreadStats;
+    NiPipeRxThreadStats m_rxThreadStats;
+    // wakeups of the reactor thread for the pipes of this instance
+    NiPipeRxThreadStats m_epollThreadStats;
+
     //TODO-NI: use typedef
     uint8_t m_niApiDevType = 0; // NIAPI_ENB  = 0, NIAPI_UE = 1, NIAPI_ALL = 2, NIAPI_NONE = 3,
 
@@ -151,6 +275,8 @@ namespace ns3 {
     uint64_t m_numPhyDlTxConfigReq             = 0;
     uint64_t m_numPhyDlTxPayloadReq            = 0;
     uint64_t m_numPhyUlTxPayloadReq            = 0;
+    uint64_t m_numDlschTxPdus                  = 0;
+    uint64_t m_maxDlschTxPdusPerTti            = 0;
     uint64_t m_numPhyCnf[CNF_NUM_STATUS_CODES] = {0};
     uint64_t m_numPhyDlschRxInd                = 0;
     uint64_t m_numPhyCellMeasInd               = 0;
@@ -25,11 +25,15 @@
 #include <fcntl.h>      // for named pipe
 #include <sys/stat.h>   // for named pipe
 #include <sys/select.h> // for reading pipe with select
+#include <sys/epoll.h>  // for event driven reading of pipes
+#include <sys/eventfd.h> // for waking up epoll waiters
 #include <unistd.h>
 #include <errno.h>      // errno
 #include <string.h>     // strerror
 #include <time.h>
 
+#include "ni-utils.h"
+#include "ni-latency-histogram.h"
 #include "ni-pipe.h"
 
 namespace ns3
@@ -147,8 +151,21 @@ namespace ns3
 
   int32_t NiPipe::PipeWrite(int32_t* pFd, uint8_t* pBufU8, uint16_t len)
   {
+    const uint64_t startNs = NiUtils::GetSysTimeNs();
     errno = 0;
-    return write((*pFd), pBufU8, len);
+    const int32_t ret = write((*pFd), pBufU8, len);
+    g_NiLatency.Record(NI_LATENCY_PIPE_WRITE, NiUtils::GetSysTimeNs() - startNs);
+    return ret;
+  }
+
+  // Gather write of several buffers with one system call, e.g. message header and caller owned payload
+  int32_t NiPipe::PipeWriteV(int32_t* pFd, const struct iovec* pIov, int32_t iovCnt)
+  {
+    const uint64_t startNs = NiUtils::GetSysTimeNs();
+    errno = 0;
+    const int32_t ret = writev((*pFd), pIov, iovCnt);
+    g_NiLatency.Record(NI_LATENCY_PIPE_WRITE, NiUtils::GetSysTimeNs() - startNs);
+    return ret;
   }
 
   // Poll named pipe for data
@@ -210,4 +227,115 @@ namespace ns3
     return read((*pFd), pBufU8, max_len);
   }
 
+  // Create epoll instance, if pEventFd is not NULL an eventfd is created and registered as well
+  int32_t NiPipe::EpollOpen(int32_t* pEpollFd, int32_t* pEventFd)
+  {
+    errno = 0;
+    (*pEpollFd) = epoll_create1(EPOLL_CLOEXEC);
+    if ( (*pEpollFd) < 0 )
+      {
+        printf( "ERROR: NiPipe::EpollOpen() -> epoll_create1() errno=%i: %s\n", errno, strerror(errno) );
+        return -1;
+      }
+
+    if (pEventFd != NULL)
+      {
+        (*pEventFd) = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if ( (*pEventFd) < 0 )
+          {
+            printf( "ERROR: NiPipe::EpollOpen() -> eventfd() errno=%i: %s\n", errno, strerror(errno) );
+            close((*pEpollFd));
+            (*pEpollFd) = -1;
+            return -2;
+          }
+        if (EpollAddFd(pEpollFd, pEventFd) < 0)
+          {
+            return -3;
+          }
+      }
+
+    return 0;
+  }
+
+  // Register file descriptor for read events (level triggered)
+  int32_t NiPipe::EpollAddFd(int32_t* pEpollFd, int32_t* pFd)
+  {
+    errno = 0;
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = (*pFd);
+    if (epoll_ctl((*pEpollFd), EPOLL_CTL_ADD, (*pFd), &ev) < 0)
+      {
+        printf( "ERROR: NiPipe::EpollAddFd() -> epoll_ctl() errno=%i: %s\n", errno, strerror(errno) );
+        return -1;
+      }
+    return 0;
+  }
+
+  // Remove file descriptor from the interest list
+  int32_t NiPipe::EpollDelFd(int32_t* pEpollFd, int32_t* pFd)
+  {
+    errno = 0;
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    if (epoll_ctl((*pEpollFd), EPOLL_CTL_DEL, (*pFd), &ev) < 0)
+      {
+        printf( "ERROR: NiPipe::EpollDelFd() -> epoll_ctl() errno=%i: %s\n", errno, strerror(errno) );
+        return -1;
+      }
+    return 0;
+  }
+
+  // Block until at least one registered descriptor is readable or timeout (-1 = infinite) expired.
+  // Returns number of ready descriptors written to pReadyFds, 0 on timeout and <0 on error.
+  int32_t NiPipe::EpollWait(int32_t* pEpollFd, int32_t* pReadyFds, int32_t maxFds, int32_t timeoutMs)
+  {
+    const int32_t maxEvents = 8;
+    struct epoll_event events[maxEvents];
+    if (maxFds > maxEvents) maxFds = maxEvents;
+
+    int32_t numEvents;
+    do
+      {
+        errno = 0;
+        numEvents = epoll_wait((*pEpollFd), events, maxFds, timeoutMs);
+      }
+    while (numEvents < 0 && errno == EINTR);
+
+    if (numEvents < 0)
+      {
+        printf( "ERROR: NiPipe::EpollWait() -> epoll_wait() errno=%i: %s\n", errno, strerror(errno) );
+        return -1;
+      }
+    for (int32_t i = 0; i < numEvents; i++)
+      {
+        pReadyFds[i] = events[i].data.fd;
+      }
+    return numEvents;
+  }
+
+  // Signal eventfd to wake up thread blocked in EpollWait
+  int32_t NiPipe::EpollWakeup(int32_t* pEventFd)
+  {
+    errno = 0;
+    uint64_t value = 1;
+    return write((*pEventFd), &value, sizeof(value));
+  }
+
+  int32_t NiPipe::EpollClose(int32_t* pEpollFd, int32_t* pEventFd)
+  {
+    if ((pEventFd != NULL) && ((*pEventFd) >= 0))
+      {
+        close((*pEventFd));
+        (*pEventFd) = -1;
+      }
+    if ((*pEpollFd) >= 0)
+      {
+        close((*pEpollFd));
+        (*pEpollFd) = -1;
+      }
+    return 0;
+  }
+
 } /* namespace ns3 */
@@ -21,6 +21,7 @@
 
 #include <stdint.h>
 #include <sys/select.h>
+#include <sys/uio.h>
 
 #ifndef NI_PIPE_H_
 #define NI_PIPE_H_
@@ -42,8 +43,18 @@ namespace ns3
      static int32_t ClosePipe(int32_t* pFd);
 
      static int32_t PipeWrite(int32_t* pFd, uint8_t* pBufU8, uint16_t len);
+     static int32_t PipeWriteV(int32_t* pFd, const struct iovec* pIov, int32_t iovCnt);
      static int32_t PipeRead(int32_t* pFd, fd_set* pReadFds, int32_t* pFdMax, uint8_t* pBufU8, uint16_t max_len);
      static int32_t PipeReadOnce(int32_t* pFd, uint8_t* pBufU8, uint16_t max_len);
+
+     // event driven reception - one epoll instance can serve several pipes,
+     // an optional eventfd is used to wake up a blocked waiter (e.g. for shutdown)
+     static int32_t EpollOpen(int32_t* pEpollFd, int32_t* pEventFd);
+     static int32_t EpollAddFd(int32_t* pEpollFd, int32_t* pFd);
+     static int32_t EpollDelFd(int32_t* pEpollFd, int32_t* pFd);
+     static int32_t EpollWait(int32_t* pEpollFd, int32_t* pReadyFds, int32_t maxFds, int32_t timeoutMs);
+     static int32_t EpollWakeup(int32_t* pEventFd);
+     static int32_t EpollClose(int32_t* pEpollFd, int32_t* pEventFd);
   private:
 
   };
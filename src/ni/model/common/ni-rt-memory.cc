@@ -0,0 +1,274 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#include <sys/mman.h>
+#include <malloc.h>
+#include <alloca.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <new>
+
+#include "ni-logging.h"
+#include "ni-rt-memory.h"
+
+namespace
+{
+  // innermost alloc scope and allocation counter of the calling thread
+  thread_local ns3::NiAllocScope* t_niAllocScope = NULL;
+  thread_local bool t_niAllocCounting = false;
+  thread_local uint64_t t_niAllocCount = 0;
+
+  struct NiAllocStageCounters
+  {
+    std::atomic<uint64_t> numScopes;
+    std::atomic<uint64_t> numScopesWithAllocs;
+    std::atomic<uint64_t> numAllocs;
+    std::atomic<uint64_t> maxAllocsPerScope;
+  };
+  // zero initialized as static storage, updated by the simulator and the transport threads
+  NiAllocStageCounters s_niAllocCounters[ns3::NI_ALLOC_SCOPE_NUM_STAGES];
+
+  std::atomic<bool> s_niRtMemoryLocked (false);
+
+  // touches the stack below the caller, the pages stay mapped after the return
+  void __attribute__ ((noinline))
+  NiPrefaultStack (size_t bytes, size_t pageSize)
+  {
+    volatile uint8_t* stack = (volatile uint8_t*) alloca (bytes);
+    for (size_t i = 0; i < bytes; i += pageSize)
+      {
+        stack[i] = 0;
+      }
+  }
+}
+
+#ifdef NI_ALLOC_COUNT_ENABLED
+// Replacements of the global allocation functions which count the allocations of
+// threads inside a NiAllocScope. The NI library is linked before the C++ library,
+// so these replace the default ones for the whole process.
+void*
+operator new (std::size_t size)
+{
+  if (t_niAllocCounting) t_niAllocCount++;
+  void* p = malloc (size > 0 ? size : 1);
+  if (p == NULL) throw std::bad_alloc ();
+  return p;
+}
+
+void*
+operator new[] (std::size_t size)
+{
+  return operator new (size);
+}
+
+void*
+operator new (std::size_t size, const std::nothrow_t&) noexcept
+{
+  if (t_niAllocCounting) t_niAllocCount++;
+  return malloc (size > 0 ? size : 1);
+}
+
+void*
+operator new[] (std::size_t size, const std::nothrow_t& tag) noexcept
+{
+  return operator new (size, tag);
+}
+
+void
+operator delete (void* p) noexcept
+{
+  free (p);
+}
+
+void
+operator delete[] (void* p) noexcept
+{
+  free (p);
+}
+
+void
+operator delete (void* p, const std::nothrow_t&) noexcept
+{
+  free (p);
+}
+
+void
+operator delete[] (void* p, const std::nothrow_t&) noexcept
+{
+  free (p);
+}
+#endif
+
+namespace ns3
+{
+
+  bool
+  NiRtMemoryInit (size_t heapPrefaultBytes, size_t stackPrefaultBytes)
+  {
+    const size_t pageSize = sysconf (_SC_PAGESIZE);
+
+    // keep freed memory in the heap instead of returning it to the system,
+    // and serve large allocations from the heap instead of fresh mappings
+    mallopt (M_TRIM_THRESHOLD, -1);
+    mallopt (M_MMAP_MAX, 0);
+
+    bool locked = true;
+    if (mlockall (MCL_CURRENT | MCL_FUTURE) != 0)
+      {
+        NI_LOG_CONSOLE_INFO("NI.RT_MEMORY: mlockall failed (" << strerror (errno) << "), memory is not locked");
+        locked = false;
+      }
+    s_niRtMemoryLocked = locked;
+
+    // grow the heap once, the pages are kept since the trim threshold is disabled
+    if (heapPrefaultBytes > 0)
+      {
+        volatile uint8_t* heap = (volatile uint8_t*) malloc (heapPrefaultBytes);
+        if (heap != NULL)
+          {
+            for (size_t i = 0; i < heapPrefaultBytes; i += pageSize)
+              {
+                heap[i] = 0;
+              }
+            free ((void*) heap);
+          }
+      }
+    if (stackPrefaultBytes > 0)
+      {
+        NiPrefaultStack (stackPrefaultBytes, pageSize);
+      }
+
+    NI_LOG_CONSOLE_INFO("NI.RT_MEMORY: " << (locked ? "locked" : "not locked") << ", prefaulted " <<
+                        heapPrefaultBytes / 1024 << " KiB heap, " << stackPrefaultBytes / 1024 << " KiB stack");
+    return locked;
+  }
+
+  bool
+  NiRtMemoryIsLocked (void)
+  {
+    return s_niRtMemoryLocked;
+  }
+
+  NiAllocScope::NiAllocScope (enum NiAllocScopeStage stage)
+  : m_stage (stage),
+    m_parent (t_niAllocScope),
+    m_parentCounting (t_niAllocCounting),
+    m_startCount (t_niAllocCount),
+    m_nestedAllocs (0)
+  {
+    t_niAllocScope = this;
+    t_niAllocCounting = (stage != NI_ALLOC_SCOPE_PAUSE);
+  }
+
+  NiAllocScope::~NiAllocScope ()
+  {
+    const uint64_t totalAllocs = t_niAllocCount - m_startCount;
+    t_niAllocScope = m_parent;
+    t_niAllocCounting = m_parentCounting;
+    if (m_parent != NULL)
+      {
+        m_parent->m_nestedAllocs += totalAllocs;
+      }
+    if (m_stage >= NI_ALLOC_SCOPE_NUM_STAGES)
+      {
+        return;
+      }
+
+    const uint64_t numAllocs = totalAllocs - m_nestedAllocs;
+    NiAllocStageCounters* pCounters = &s_niAllocCounters[m_stage];
+    pCounters->numScopes.fetch_add (1, std::memory_order_relaxed);
+    if (numAllocs > 0)
+      {
+        pCounters->numScopesWithAllocs.fetch_add (1, std::memory_order_relaxed);
+        pCounters->numAllocs.fetch_add (numAllocs, std::memory_order_relaxed);
+        uint64_t maxAllocs = pCounters->maxAllocsPerScope.load (std::memory_order_relaxed);
+        while ((numAllocs > maxAllocs) &&
+               !pCounters->maxAllocsPerScope.compare_exchange_weak (maxAllocs, numAllocs, std::memory_order_relaxed))
+          {
+          }
+      }
+  }
+
+  uint64_t
+  NiAllocScope::GetNumAllocs (void) const
+  {
+    return t_niAllocCount - m_startCount - m_nestedAllocs;
+  }
+
+  NiAllocScopeStats
+  NiAllocScope::GetStats (enum NiAllocScopeStage stage)
+  {
+    NiAllocScopeStats stats = {0, 0, 0, 0};
+    if (stage < NI_ALLOC_SCOPE_NUM_STAGES)
+      {
+        const NiAllocStageCounters* pCounters = &s_niAllocCounters[stage];
+        stats.numScopes = pCounters->numScopes.load (std::memory_order_relaxed);
+        stats.numScopesWithAllocs = pCounters->numScopesWithAllocs.load (std::memory_order_relaxed);
+        stats.numAllocs = pCounters->numAllocs.load (std::memory_order_relaxed);
+        stats.maxAllocsPerScope = pCounters->maxAllocsPerScope.load (std::memory_order_relaxed);
+      }
+    return stats;
+  }
+
+  void
+  NiAllocScope::ResetStats (void)
+  {
+    for (uint32_t s = 0; s < NI_ALLOC_SCOPE_NUM_STAGES; s++)
+      {
+        s_niAllocCounters[s].numScopes = 0;
+        s_niAllocCounters[s].numScopesWithAllocs = 0;
+        s_niAllocCounters[s].numAllocs = 0;
+        s_niAllocCounters[s].maxAllocsPerScope = 0;
+      }
+  }
+
+  void
+  NiAllocScope::Print (void)
+  {
+#ifdef NI_ALLOC_COUNT_ENABLED
+    for (uint32_t s = 0; s < NI_ALLOC_SCOPE_NUM_STAGES; s++)
+      {
+        const NiAllocScopeStats stats = GetStats ((enum NiAllocScopeStage) s);
+        if (stats.numScopes > 0)
+          {
+            NI_LOG_CONSOLE_INFO("HeapAllocs " << GetStageName ((enum NiAllocScopeStage) s) << ": scopes " << stats.numScopes <<
+                                ", with allocs " << stats.numScopesWithAllocs << ", allocs " << stats.numAllocs <<
+                                ", max " << stats.maxAllocsPerScope << " per scope");
+          }
+      }
+#endif
+  }
+
+  const char*
+  NiAllocScope::GetStageName (enum NiAllocScopeStage stage)
+  {
+    switch (stage)
+      {
+      case NI_ALLOC_SCOPE_SUBFRAME:     return "Subframe";
+      case NI_ALLOC_SCOPE_PHY_RX:       return "PhyRx";
+      case NI_ALLOC_SCOPE_TRANSPORT_RX: return "TransportRx";
+      default:                          return "Unknown";
+      }
+  }
+
+} // namespace ns3
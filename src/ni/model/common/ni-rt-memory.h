@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#ifndef SRC_NI_MODEL_COMMON_NI_RT_MEMORY_H_
+#define SRC_NI_MODEL_COMMON_NI_RT_MEMORY_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ns3 {
+
+  // heap allocations are only counted in debug builds, optimized builds keep the
+  // global operator new of the C++ library
+#ifdef NS3_BUILD_PROFILE_DEBUG
+#define NI_ALLOC_COUNT_ENABLED
+#endif
+
+  // default amount of heap and stack memory touched by NiRtMemoryInit
+#define NI_RT_MEMORY__DEFAULT_HEAP_PREFAULT_BYTES  (64 * 1024 * 1024)
+#define NI_RT_MEMORY__DEFAULT_STACK_PREFAULT_BYTES (512 * 1024)
+
+  // Real-time memory mode: locks all current and future pages of the process, keeps
+  // freed heap memory in the process and touches heapPrefaultBytes of heap and
+  // stackPrefaultBytes of stack of the calling thread, so that the TTI path neither
+  // page faults nor calls into the kernel for memory. Stacks of threads started
+  // afterwards are locked completely and count against RLIMIT_MEMLOCK.
+  // Returns false if the pages could not be locked (CAP_IPC_LOCK or RLIMIT_MEMLOCK).
+  bool NiRtMemoryInit (size_t heapPrefaultBytes, size_t stackPrefaultBytes);
+  bool NiRtMemoryIsLocked (void);
+
+  // sections of the LTE real-time loop which should be free of heap allocations
+  enum NiAllocScopeStage
+  {
+    NI_ALLOC_SCOPE_SUBFRAME = 0,   // NiStartSubframe, without the processing of received MAC PDUs
+    NI_ALLOC_SCOPE_PHY_RX,         // NiStartRxCtrlDataFrame, without the upcalls into the LTE PHY
+    NI_ALLOC_SCOPE_TRANSPORT_RX,   // pipe transport handlers of timing ind, rx ind and cnf messages
+    NI_ALLOC_SCOPE_NUM_STAGES,
+    NI_ALLOC_SCOPE_PAUSE = NI_ALLOC_SCOPE_NUM_STAGES // no counting, e.g. during upcalls into ns-3
+  };
+
+  typedef struct sNiAllocScopeStats {
+    uint64_t numScopes;
+    uint64_t numScopesWithAllocs;
+    uint64_t numAllocs;
+    uint64_t maxAllocsPerScope;
+  } NiAllocScopeStats;
+
+  // Counts the heap allocations of the calling thread during its lifetime. Scopes
+  // can be nested, the allocations are accounted to the innermost scope only.
+  class NiAllocScope
+  {
+  public:
+    NiAllocScope (enum NiAllocScopeStage stage);
+    ~NiAllocScope ();
+
+    // allocations of this scope so far, without the ones of nested scopes
+    uint64_t GetNumAllocs (void) const;
+
+    static NiAllocScopeStats GetStats (enum NiAllocScopeStage stage);
+    static void ResetStats (void);
+    // prints the statistics of all stages with recorded scopes (debug builds only)
+    static void Print (void);
+    static const char* GetStageName (enum NiAllocScopeStage stage);
+
+  private:
+    NiAllocScope (const NiAllocScope&);
+    NiAllocScope& operator= (const NiAllocScope&);
+
+    const enum NiAllocScopeStage m_stage;
+    NiAllocScope* const m_parent;
+    const bool m_parentCounting;
+    const uint64_t m_startCount;  // thread allocation counter at construction
+    uint64_t m_nestedAllocs;      // allocations accounted to nested scopes
+  };
+
+} // namespace ns3
+
+#endif /* SRC_NI_MODEL_COMMON_NI_RT_MEMORY_H_ */
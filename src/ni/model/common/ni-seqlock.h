@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#ifndef SRC_NI_MODEL_COMMON_NI_SEQLOCK_H_
+#define SRC_NI_MODEL_COMMON_NI_SEQLOCK_H_
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+namespace ns3 {
+
+  // Single-writer sequence lock publishing a small trivially copyable value.
+  // Readers never block the writer and retry if they raced with an update,
+  // so they always get a consistent copy. Readers can additionally wait for
+  // the next update: first by spinning for a bounded time, then blocking on a
+  // futex on the sequence counter which the writer wakes after publishing.
+  template <typename T>
+  class NiSeqlock
+  {
+  public:
+    NiSeqlock ()
+    : m_seq (0),
+      m_numWaiters (0)
+    {
+      const T init = T ();
+      StoreWords (&init);
+    }
+
+    // writer side
+    void Write (const T& value)
+    {
+      const uint32_t seq = m_seq.load (std::memory_order_relaxed);
+      m_seq.store (seq + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence (std::memory_order_release);
+      StoreWords (&value);
+      // seq_cst store and load pair with the waiter registration in WaitForUpdate
+      m_seq.store (seq + 2, std::memory_order_seq_cst);
+      if (m_numWaiters.load (std::memory_order_seq_cst) > 0)
+        {
+          syscall (SYS_futex, &m_seq, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+        }
+    }
+
+    // reader side - returns the sequence number of the copy
+    uint32_t Read (T* pValue) const
+    {
+      while (1)
+        {
+          const uint32_t seq = m_seq.load (std::memory_order_acquire);
+          if (seq & 1)
+            {
+              continue;
+            }
+          LoadWords (pValue);
+          std::atomic_thread_fence (std::memory_order_acquire);
+          if (m_seq.load (std::memory_order_relaxed) == seq)
+            {
+              return seq;
+            }
+        }
+    }
+
+    uint32_t GetSeq (void) const
+    {
+      return m_seq.load (std::memory_order_acquire);
+    }
+
+    // Waits until a value newer than the one read with sequence number *pSeq is
+    // published: spins for up to spinNs, then blocks until timeoutNs expired
+    // (0 = no timeout). Returns true if a newer value was read into pValue and
+    // its sequence number into *pSeq, pBlocked tells whether the futex wait was needed.
+    bool WaitForUpdate (uint32_t* pSeq, T* pValue, uint64_t spinNs, uint64_t timeoutNs, bool* pBlocked)
+    {
+      const uint32_t lastSeq = *pSeq;
+      *pBlocked = false;
+      const uint64_t startNs = GetTimeNs ();
+
+      while (!IsNewer (m_seq.load (std::memory_order_acquire), lastSeq))
+        {
+          const uint64_t waitedNs = GetTimeNs () - startNs;
+          if ((timeoutNs > 0) && (waitedNs >= timeoutNs))
+            {
+              return false;
+            }
+          if (waitedNs < spinNs)
+            {
+#if defined (__x86_64__) || defined (__i386__)
+              __builtin_ia32_pause ();
+#endif
+              continue;
+            }
+
+          // announce waiter before re-checking the sequence, the writer checks
+          // the waiter count after publishing, so no wakeup can be lost
+          *pBlocked = true;
+          m_numWaiters.fetch_add (1, std::memory_order_seq_cst);
+          const uint32_t seq = m_seq.load (std::memory_order_seq_cst);
+          if (!IsNewer (seq, lastSeq))
+            {
+              // without timeout block at most 100 ms at a time
+              const uint64_t remainingNs = (timeoutNs > 0) ? (timeoutNs - waitedNs) : 100000000ULL;
+              struct timespec ts;
+              ts.tv_sec  = remainingNs / 1000000000ULL;
+              ts.tv_nsec = remainingNs % 1000000000ULL;
+              syscall (SYS_futex, &m_seq, FUTEX_WAIT_PRIVATE, seq, &ts, NULL, 0);
+            }
+          m_numWaiters.fetch_sub (1, std::memory_order_relaxed);
+        }
+
+      *pSeq = Read (pValue);
+      return true;
+    }
+
+  private:
+    static const uint32_t m_numWords = (sizeof (T) + sizeof (uint64_t) - 1) / sizeof (uint64_t);
+
+    // even sequence numbers are stable values, an odd number means a write is in progress
+    static bool IsNewer (uint32_t seq, uint32_t lastSeq)
+    {
+      return (seq != lastSeq) && !(seq & 1);
+    }
+
+    static uint64_t GetTimeNs (void)
+    {
+      struct timespec ts;
+      clock_gettime (CLOCK_MONOTONIC, &ts);
+      return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    }
+
+    // the value is copied word by word with relaxed atomics to avoid a data race
+    void StoreWords (const T* pValue)
+    {
+      uint64_t words[m_numWords] = {0};
+      memcpy (words, pValue, sizeof (T));
+      for (uint32_t i = 0; i < m_numWords; i++)
+        {
+          m_words[i].store (words[i], std::memory_order_relaxed);
+        }
+    }
+
+    void LoadWords (T* pValue) const
+    {
+      uint64_t words[m_numWords];
+      for (uint32_t i = 0; i < m_numWords; i++)
+        {
+          words[i] = m_words[i].load (std::memory_order_relaxed);
+        }
+      memcpy (pValue, words, sizeof (T));
+    }
+
+    std::atomic<uint32_t> m_seq;
+    std::atomic<uint32_t> m_numWaiters;
+    std::atomic<uint64_t> m_words[m_numWords];
+  };
+
+} // namespace ns3
+
+#endif /* SRC_NI_MODEL_COMMON_NI_SEQLOCK_H_ */
@@ -0,0 +1,304 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#include <stdio.h>      // printf
+#include <stdint.h>     // integer types
+
+#include <fcntl.h>      // open
+#include <sys/mman.h>   // mmap
+#include <sys/stat.h>   // fstat
+#include <unistd.h>
+#include <errno.h>      // errno
+#include <string.h>     // strerror, memcpy
+#include <time.h>
+#include <signal.h>     // kill
+#include <new>
+
+#include "ni-shm-ring.h"
+
+namespace ns3
+{
+
+  NiShmRing::NiShmRing ()
+  : m_pCtrl (NULL),
+    m_pData (NULL),
+    m_mask (0),
+    m_mapSize (0),
+    m_owner (false),
+    m_numFull (0)
+  {
+  }
+
+  NiShmRing::~NiShmRing ()
+  {
+    Close ();
+  }
+
+  // Create shared memory file and initialize control block - an existing ring of the same name is replaced
+  int32_t NiShmRing::Create (std::string name, uint32_t dataSize)
+  {
+    uint32_t size = 1;
+    while (size < dataSize) size <<= 1;
+
+    m_path = "/dev/shm/" + name;
+    unlink (m_path.c_str ());
+
+    errno = 0;
+    int32_t fd = open (m_path.c_str (), O_RDWR | O_CREAT | O_EXCL, 0664);
+    if (fd < 0)
+      {
+        printf ("ERROR: NiShmRing::Create() -> open() for %s errno=%i: %s\n", m_path.c_str (), errno, strerror (errno));
+        return -1;
+      }
+    const size_t mapSize = sizeof (NiShmRingCtrl) + size;
+    if (ftruncate (fd, mapSize) < 0)
+      {
+        printf ("ERROR: NiShmRing::Create() -> ftruncate() for %s errno=%i: %s\n", m_path.c_str (), errno, strerror (errno));
+        close (fd);
+        return -1;
+      }
+    if (Map (fd, mapSize) < 0)
+      {
+        return -1;
+      }
+
+    new (m_pCtrl) NiShmRingCtrl;
+    m_pCtrl->dataSize = size;
+    m_pCtrl->ownerPid = getpid ();
+    m_pCtrl->head.store (0, std::memory_order_relaxed);
+    m_pCtrl->tail.store (0, std::memory_order_relaxed);
+    // publish ring - the peer only uses it after the magic is visible
+    m_pCtrl->magic.store (m_magic, std::memory_order_release);
+
+    m_mask = size - 1;
+    m_owner = true;
+    return 0;
+  }
+
+  // Attach to a ring created by the peer, waits until it is available or timeoutMs has passed
+  int32_t NiShmRing::Attach (std::string name, uint32_t timeoutMs)
+  {
+    struct timespec ts;
+    ts.tv_sec = 0;
+    ts.tv_nsec = 250000L;  // loop wait time
+
+    struct timespec start, now;
+    clock_gettime (CLOCK_MONOTONIC, &start);
+
+    m_path = "/dev/shm/" + name;
+
+    while (1)
+      {
+        errno = 0;
+        int32_t fd = open (m_path.c_str (), O_RDWR);
+        if (fd < 0)
+          {
+            if (errno != ENOENT)
+              {
+                // unexpected errno, abort
+                printf ("ERROR: NiShmRing::Attach() -> open() for %s errno=%i: %s\n", m_path.c_str (), errno, strerror (errno));
+                return -1;
+              }
+          }
+        else
+          {
+            struct stat st;
+            if ((fstat (fd, &st) == 0) && ((size_t)st.st_size > sizeof (NiShmRingCtrl)))
+              {
+                if (Map (fd, st.st_size) < 0)
+                  {
+                    return -1;
+                  }
+                // rings left behind by a terminated peer are ignored until re-created
+                if ((m_pCtrl->magic.load (std::memory_order_acquire) == m_magic) &&
+                    ((kill (m_pCtrl->ownerPid, 0) == 0) || (errno == EPERM)))
+                  {
+                    // the data size is published with the magic, the ring has to fit into the file
+                    const uint32_t dataSize = m_pCtrl->dataSize;
+                    if ((dataSize == 0) || ((dataSize & (dataSize - 1)) != 0) ||
+                        (sizeof (NiShmRingCtrl) + (uint64_t) dataSize > (uint64_t) st.st_size))
+                      {
+                        printf ("ERROR: NiShmRing::Attach() -> %s has an invalid data size %u for a file size of %lu\n",
+                                m_path.c_str (), dataSize, (unsigned long) st.st_size);
+                        munmap (m_pCtrl, m_mapSize);
+                        m_pCtrl = NULL;
+                        m_pData = NULL;
+                        return -1;
+                      }
+                    // all done
+                    break;
+                  }
+                munmap (m_pCtrl, m_mapSize);
+                m_pCtrl = NULL;
+                m_pData = NULL;
+              }
+            else
+              {
+                close (fd);
+              }
+          }
+        clock_gettime (CLOCK_MONOTONIC, &now);
+        const uint64_t waitMs = (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
+        if (waitMs >= timeoutMs)
+          {
+            printf ("ERROR: NiShmRing::Attach() -> %s not created by a running peer within %u ms\n", m_path.c_str (), timeoutMs);
+            return -1;
+          }
+        nanosleep (&ts, NULL);
+      }
+
+    m_mask = m_pCtrl->dataSize - 1;
+    m_owner = false;
+    return 0;
+  }
+
+  int32_t NiShmRing::Close (void)
+  {
+    if (m_pCtrl == NULL)
+      {
+        return 0;
+      }
+    if (m_owner)
+      {
+        // invalidate ring for peers attaching later
+        m_pCtrl->magic.store (0, std::memory_order_release);
+      }
+    munmap (m_pCtrl, m_mapSize);
+    m_pCtrl = NULL;
+    m_pData = NULL;
+    if (m_owner)
+      {
+        unlink (m_path.c_str ());
+        m_owner = false;
+      }
+    return 0;
+  }
+
+  // Map shared memory file, the descriptor is not needed anymore afterwards
+  int32_t NiShmRing::Map (int32_t fd, size_t mapSize)
+  {
+    errno = 0;
+    void* pMem = mmap (NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close (fd);
+    if (pMem == MAP_FAILED)
+      {
+        printf ("ERROR: NiShmRing::Map() -> mmap() for %s errno=%i: %s\n", m_path.c_str (), errno, strerror (errno));
+        return -1;
+      }
+    m_pCtrl = (NiShmRingCtrl*)pMem;
+    m_pData = (uint8_t*)pMem + sizeof (NiShmRingCtrl);
+    m_mapSize = mapSize;
+    return 0;
+  }
+
+  int32_t NiShmRing::Write (const struct iovec* pIov, int32_t iovCnt)
+  {
+    if (m_pCtrl == NULL)
+      {
+        return -1;
+      }
+
+    uint32_t len = 0;
+    for (int32_t i = 0; i < iovCnt; i++)
+      {
+        len += pIov[i].iov_len;
+      }
+    if ((len < m_genMsgHdrSize) || (len > m_mask + 1))
+      {
+        return -1;
+      }
+
+    const uint64_t head = m_pCtrl->head.load (std::memory_order_relaxed);
+    const uint64_t tail = m_pCtrl->tail.load (std::memory_order_acquire);
+    if ((m_mask + 1) - (head - tail) < len)
+      {
+        m_numFull++;
+        return 0;
+      }
+
+    uint64_t pos = head;
+    for (int32_t i = 0; i < iovCnt; i++)
+      {
+        CopyIn (pos, (const uint8_t*)pIov[i].iov_base, pIov[i].iov_len);
+        pos += pIov[i].iov_len;
+      }
+    // make complete message visible to the consumer
+    m_pCtrl->head.store (pos, std::memory_order_release);
+
+    return len;
+  }
+
+  int32_t NiShmRing::Read (uint8_t* pBufU8, uint32_t maxLen)
+  {
+    if (m_pCtrl == NULL)
+      {
+        return -1;
+      }
+
+    const uint64_t tail = m_pCtrl->tail.load (std::memory_order_relaxed);
+    const uint64_t head = m_pCtrl->head.load (std::memory_order_acquire);
+    if (head == tail)
+      {
+        return 0;
+      }
+
+    // general message header - body length in bytes 5-7
+    uint8_t genMsgHdr[m_genMsgHdrSize];
+    CopyOut (tail, genMsgHdr, m_genMsgHdrSize);
+    const uint32_t bodyLength = (genMsgHdr[5] << 16) | (genMsgHdr[6] << 8) | genMsgHdr[7];
+    const uint32_t len = m_genMsgHdrSize + bodyLength;
+    if (len > head - tail)
+      {
+        printf ("ERROR: NiShmRing::Read() -> corrupt message in %s, bodyLength=%u\n", m_path.c_str (), bodyLength);
+        return -1;
+      }
+    if (len > maxLen)
+      {
+        // drop message, otherwise the ring would be blocked
+        printf ("ERROR: NiShmRing::Read() -> message in %s exceeds buffer, bodyLength=%u\n", m_path.c_str (), bodyLength);
+        m_pCtrl->tail.store (tail + len, std::memory_order_release);
+        return -1;
+      }
+
+    CopyOut (tail, pBufU8, len);
+    m_pCtrl->tail.store (tail + len, std::memory_order_release);
+
+    return len;
+  }
+
+  // copy into / out of the data area, splitting at the wrap around
+  void NiShmRing::CopyIn (uint64_t pos, const uint8_t* pSrc, uint32_t len)
+  {
+    const uint32_t offset = pos & m_mask;
+    const uint32_t first = ((m_mask + 1) - offset < len) ? (m_mask + 1) - offset : len;
+    memcpy (m_pData + offset, pSrc, first);
+    memcpy (m_pData, pSrc + first, len - first);
+  }
+
+  void NiShmRing::CopyOut (uint64_t pos, uint8_t* pDst, uint32_t len)
+  {
+    const uint32_t offset = pos & m_mask;
+    const uint32_t first = ((m_mask + 1) - offset < len) ? (m_mask + 1) - offset : len;
+    memcpy (pDst, m_pData + offset, first);
+    memcpy (pDst + first, m_pData, len - first);
+  }
+
+} /* namespace ns3 */
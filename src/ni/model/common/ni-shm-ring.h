@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#ifndef SRC_NI_MODEL_COMMON_NI_SHM_RING_H_
+#define SRC_NI_MODEL_COMMON_NI_SHM_RING_H_
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <sys/uio.h>
+
+namespace ns3 {
+
+  // Lock-free single-producer/single-consumer byte ring located in a memory
+  // mapped file below /dev/shm, shared between two processes.
+  // Messages are framed by the NI API general message header (8 bytes, body
+  // length in bytes 5-7), so the reader always gets complete messages.
+  // One side calls Create(), the other side calls Attach(). Neither Write()
+  // nor Read() enters the kernel.
+  class NiShmRing
+  {
+  public:
+    NiShmRing ();
+    virtual
+    ~NiShmRing ();
+
+    // data size is rounded up to the next power of two
+    int32_t Create (std::string name, uint32_t dataSize);
+    // waits until the ring has been created by a running peer, -1 if this
+    // takes longer than timeoutMs
+    int32_t Attach (std::string name, uint32_t timeoutMs = m_defaultAttachTimeoutMs);
+    int32_t Close (void);
+
+    // producer side - returns number of bytes written, 0 if the ring is full, -1 on error
+    int32_t Write (const struct iovec* pIov, int32_t iovCnt);
+    // consumer side - returns size of the message read, 0 if the ring is empty, -1 on error
+    int32_t Read (uint8_t* pBufU8, uint32_t maxLen);
+
+    bool IsOpen (void) const { return m_pCtrl != NULL; }
+    uint64_t GetNumFull (void) const { return m_numFull; }
+
+  private:
+    // control block at the beginning of the shared memory, head and tail are
+    // kept on separate cache lines
+    typedef struct sNiShmRingCtrl {
+      std::atomic<uint32_t> magic;
+      uint32_t dataSize;
+      int32_t ownerPid;  // creating process, used to detect stale rings
+      uint8_t padHdr[64 - sizeof (std::atomic<uint32_t>) - sizeof (uint32_t) - sizeof (int32_t)];
+      std::atomic<uint64_t> head;  // written by producer
+      uint8_t padHead[64 - sizeof (std::atomic<uint64_t>)];
+      std::atomic<uint64_t> tail;  // written by consumer
+      uint8_t padTail[64 - sizeof (std::atomic<uint64_t>)];
+    } NiShmRingCtrl;
+
+    int32_t Map (int32_t fd, size_t mapSize);
+    void CopyIn (uint64_t pos, const uint8_t* pSrc, uint32_t len);
+    void CopyOut (uint64_t pos, uint8_t* pDst, uint32_t len);
+
+    static const uint32_t m_magic = 0x4E495348; // "NISH"
+    static const uint32_t m_defaultAttachTimeoutMs = 30000;
+    static const uint32_t m_genMsgHdrSize = 8;
+
+    NiShmRingCtrl* m_pCtrl;
+    uint8_t* m_pData;
+    uint32_t m_mask;
+    size_t m_mapSize;
+    bool m_owner;
+    std::string m_path;
+    uint64_t m_numFull;
+  };
+
+} // namespace ns3
+
+#endif /* SRC_NI_MODEL_COMMON_NI_SHM_RING_H_ */
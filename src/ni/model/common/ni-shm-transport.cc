@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#include <time.h>
+#include "ns3/ni-utils.h"
+#include "ns3/ni-logging.h"
+#include "ni-shm-transport.h"
+
+
+namespace ns3 {
+  NiShmTransport::NiShmTransport ()
+  : NiPipeTransport (),
+    m_lastRxTimeNs (0)
+  {
+  }
+
+  NiShmTransport::NiShmTransport (std::string context)
+  : NiPipeTransport (context),
+    m_lastRxTimeNs (0)
+  {
+  }
+
+  NiShmTransport::~NiShmTransport ()
+  {
+  }
+
+void
+NiShmTransport::SetBusyPollWindowUs(uint64_t busyPollWindowUs)
+{
+  m_busyPollWindowNs = busyPollWindowUs * 1000;
+}
+
+std::string
+NiShmTransport::GetShmRingName(uint32_t instanceId, uint32_t pipeIdx)
+{
+  return std::string(NI_SHM_RING_NAME_PREFIX) + std::to_string(instanceId) + "-" + std::to_string(pipeIdx) + "_shm";
+}
+
+int32_t
+NiShmTransport::OpenTransport(void)
+{
+  NI_LOG_CONSOLE_DEBUG( "NI.TRANSPORT: Attaching to shared memory rings" );
+
+  // there are no descriptors to wait on
+  if (m_rxMode == NI_PIPE_RX_MODE_EPOLL)
+    {
+      NI_LOG_WARN("NiShmTransport::OpenTransport: epoll rx mode not supported, using polling");
+      m_rxMode = NI_PIPE_RX_MODE_POLLING;
+    }
+
+  // Assumption: The PHY side has created the rings and will also clean them up at the end
+  if ((m_txRing.Attach(GetShmRingName(GetInstanceId(), NI_PIPE_IDX_TX)) < 0) ||
+      (m_timingIndRing.Attach(GetShmRingName(GetInstanceId(), NI_PIPE_IDX_TIMING_IND)) < 0) ||
+      (m_rxRing.Attach(GetShmRingName(GetInstanceId(), NI_PIPE_IDX_RX)) < 0))
+    {
+      return -1;
+    }
+  m_lastRxTimeNs.store(NiUtils::GetSysTimeNs(), std::memory_order_relaxed);
+  return 0;
+}
+
+void
+NiShmTransport::CloseTransport(void)
+{
+  if (m_txRing.GetNumFull() > 0)
+    {
+      NI_LOG_CONSOLE_INFO("Tx shared memory ring full = " << m_txRing.GetNumFull());
+    }
+  m_timingIndRing.Close();
+  m_txRing.Close();
+  m_rxRing.Close();
+}
+
+int32_t
+NiShmTransport::ReadTimingIndMsg(uint8_t* pBufU8, uint32_t maxLen)
+{
+  const int32_t nread = m_timingIndRing.Read(pBufU8, maxLen);
+  if (nread > 0)
+    {
+      m_lastRxTimeNs.store(NiUtils::GetSysTimeNs(), std::memory_order_relaxed);
+    }
+  return nread;
+}
+
+int32_t
+NiShmTransport::ReadRxMsg(uint8_t* pBufU8, uint32_t maxLen)
+{
+  const int32_t nread = m_rxRing.Read(pBufU8, maxLen);
+  if (nread > 0)
+    {
+      m_lastRxTimeNs.store(NiUtils::GetSysTimeNs(), std::memory_order_relaxed);
+    }
+  return nread;
+}
+
+int32_t
+NiShmTransport::WriteTxMsg(const struct iovec* pIov, int32_t iovCnt)
+{
+  const int32_t nwrite = m_txRing.Write(pIov, iovCnt);
+  if (nwrite == 0)
+    {
+      NI_LOG_WARN("NiShmTransport::WriteTxMsg: tx ring full, message dropped");
+      return -1;
+    }
+  return nwrite;
+}
+
+// busy poll while the PHY is active, sleep otherwise
+void
+NiShmTransport::IdleWait(void)
+{
+  const uint64_t idleTimeNs = NiUtils::GetSysTimeNs() - m_lastRxTimeNs.load(std::memory_order_relaxed);
+  if (idleTimeNs < m_busyPollWindowNs)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+      __builtin_ia32_pause();
+#endif
+      return;
+    }
+  nanosleep( &m_ts, NULL );
+}
+
+} //namespace ns3
@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#ifndef NI_SHM_TRANSPORT_H_
+#define NI_SHM_TRANSPORT_H_
+
+#include <atomic>
+
+#include "ni-pipe-transport.h"
+#include "ni-shm-ring.h"
+
+namespace ns3 {
+
+  // shared memory rings, one ring per pipe of the named pipe transport, see GetShmRingName
+#define NI_SHM_RING_DATA_SIZE       (1 << 20)                   // bytes per ring
+#define NI_SHM_RING_NAME_PREFIX     "ni_api_transport_"         // ni_api_transport_<instance>-<pipe>_shm
+
+  // L1-L2 API transport over shared memory rings instead of named pipes.
+  // Message handling, statistics and callbacks are inherited from the pipe
+  // transport, only the i/o functions are replaced. The rings are created by
+  // the PHY side, the transport attaches to them in Init.
+  // Reception is always done by polling: rx threads busy poll while messages
+  // are flowing and only sleep after the busy poll window expired without any
+  // message, so no system call is made on the TTI hot path.
+  class NiShmTransport : public NiPipeTransport
+  {
+  public:
+    NiShmTransport ();
+    NiShmTransport (std::string context);
+    virtual
+    ~NiShmTransport ();
+
+    // has to be called before Init, 0 disables busy polling
+    void SetBusyPollWindowUs(uint64_t busyPollWindowUs);
+
+    // name of the ring replacing pipe NI_PIPE_IDX_* of an AFW instance
+    static std::string GetShmRingName(uint32_t instanceId, uint32_t pipeIdx);
+
+  protected:
+    virtual int32_t OpenTransport(void);
+    virtual void CloseTransport(void);
+    virtual int32_t ReadTimingIndMsg(uint8_t* pBufU8, uint32_t maxLen);
+    virtual int32_t ReadRxMsg(uint8_t* pBufU8, uint32_t maxLen);
+    virtual int32_t WriteTxMsg(const struct iovec* pIov, int32_t iovCnt);
+    virtual void IdleWait(void);
+
+  private:
+    NiShmRing m_timingIndRing;
+    NiShmRing m_txRing;
+    NiShmRing m_rxRing;
+
+    const struct timespec m_ts = {0, 10000L};  // 10us wait time if idle
+    uint64_t m_busyPollWindowNs = 2000000;     // 2 TTIs
+    std::atomic<uint64_t> m_lastRxTimeNs;
+  };
+
+} //namespace ns3
+
+#endif /* NI_SHM_TRANSPORT_H_ */
@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#ifndef SRC_NI_MODEL_COMMON_NI_SPSC_RING_H_
+#define SRC_NI_MODEL_COMMON_NI_SPSC_RING_H_
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
+namespace ns3 {
+
+  // Bounded lock-free single-producer/single-consumer ring.
+  // Slots are preallocated and written / read in place, so an element is
+  // copied only once by the producer. The producer calls GetWriteSlot() and
+  // CommitWrite(), the consumer calls GetReadSlot() and CommitRead().
+  template <typename T>
+  class NiSpscRing
+  {
+  public:
+    // capacity is rounded up to the next power of two
+    explicit NiSpscRing (uint32_t capacity)
+    : m_head (0),
+      m_tail (0),
+      m_numPushed (0),
+      m_numDropped (0),
+      m_maxDepth (0),
+      m_numPopped (0)
+    {
+      uint32_t size = 1;
+      while (size < capacity) size <<= 1;
+      m_mask = size - 1;
+      m_slots.resize (size);
+    }
+
+    // producer side - returns NULL and counts a drop if the ring is full
+    T* GetWriteSlot (void)
+    {
+      const uint32_t head = m_head.load (std::memory_order_relaxed);
+      const uint32_t tail = m_tail.load (std::memory_order_acquire);
+      if ((head - tail) > m_mask)
+        {
+          m_numDropped++;
+          return NULL;
+        }
+      return &m_slots[head & m_mask];
+    }
+
+    void CommitWrite (void)
+    {
+      const uint32_t head = m_head.load (std::memory_order_relaxed) + 1;
+      m_head.store (head, std::memory_order_release);
+      m_numPushed++;
+      const uint32_t depth = head - m_tail.load (std::memory_order_relaxed);
+      if (depth > m_maxDepth) m_maxDepth = depth;
+    }
+
+    // consumer side - returns NULL if the ring is empty
+    T* GetReadSlot (void)
+    {
+      const uint32_t tail = m_tail.load (std::memory_order_relaxed);
+      const uint32_t head = m_head.load (std::memory_order_acquire);
+      if (head == tail)
+        {
+          return NULL;
+        }
+      return &m_slots[tail & m_mask];
+    }
+
+    void CommitRead (void)
+    {
+      m_tail.store (m_tail.load (std::memory_order_relaxed) + 1, std::memory_order_release);
+      m_numPopped++;
+    }
+
+    // number of elements currently queued (snapshot)
+    uint32_t GetDepth (void) const
+    {
+      return m_head.load (std::memory_order_acquire) - m_tail.load (std::memory_order_acquire);
+    }
+
+    uint32_t GetCapacity (void) const { return m_mask + 1; }
+    uint64_t GetNumPushed (void) const { return m_numPushed; }
+    uint64_t GetNumDropped (void) const { return m_numDropped; }
+    uint32_t GetMaxDepth (void) const { return m_maxDepth; }
+    uint64_t GetNumPopped (void) const { return m_numPopped; }
+
+  private:
+    // keep producer and consumer indices on separate cache lines
+    std::atomic<uint32_t> m_head;
+    uint8_t m_padHead[64 - sizeof (std::atomic<uint32_t>)];
+    std::atomic<uint32_t> m_tail;
+    uint8_t m_padTail[64 - sizeof (std::atomic<uint32_t>)];
+    uint32_t m_mask;
+    std::vector<T> m_slots;
+
+    // statistics - written by producer only
+    uint64_t m_numPushed;
+    uint64_t m_numDropped;
+    uint32_t m_maxDepth;
+    // statistics - written by consumer only
+    uint64_t m_numPopped;
+  };
+
+} // namespace ns3
+
+#endif /* SRC_NI_MODEL_COMMON_NI_SPSC_RING_H_ */
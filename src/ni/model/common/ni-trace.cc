@@ -0,0 +1,298 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#include <stdio.h>      // printf
+#include <stdint.h>     // integer types
+
+#include <fcntl.h>      // open
+#include <sys/mman.h>   // mmap
+#include <sys/stat.h>   // fstat
+#include <unistd.h>
+#include <errno.h>      // errno
+#include <string.h>     // strerror, memcpy
+#include <new>
+#include <algorithm>
+
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+
+#include "ni-utils.h"
+#include "ni-trace.h"
+
+namespace ns3
+{
+
+  static_assert (sizeof (NiTraceRecord) == 64, "NiTraceRecord has to be one cache line");
+  static_assert (sizeof (NiTraceFileHeader) == 64, "NiTraceFileHeader size changed");
+
+  static const char g_niTraceMagic[8] = "NITRACE";
+
+  // global trace file, opened by NiTraceInit
+  NiTrace g_NiTrace;
+
+  NiTrace::NiTrace ()
+  : m_enabled (false),
+    m_pHdr (NULL),
+    m_pRecords (NULL),
+    m_maxRecords (0),
+    m_wrap (false),
+    m_mapSize (0),
+    m_fd (-1)
+  {
+  }
+
+  NiTrace::~NiTrace ()
+  {
+    Close ();
+  }
+
+  // Create trace file and preallocate the space for maxRecords records - an existing file is replaced
+  int32_t NiTrace::Open (std::string fileName, uint64_t maxRecords, bool wrap)
+  {
+    if ((m_pHdr != NULL) || (maxRecords == 0))
+      {
+        return -1;
+      }
+
+    unlink (fileName.c_str ());
+    errno = 0;
+    m_fd = open (fileName.c_str (), O_RDWR | O_CREAT | O_EXCL, 0664);
+    if (m_fd < 0)
+      {
+        printf ("ERROR: NiTrace::Open() -> open() for %s errno=%i: %s\n", fileName.c_str (), errno, strerror (errno));
+        return -1;
+      }
+
+    // allocate the blocks up front, so that writing a record never waits for the file system
+    const size_t mapSize = sizeof (NiTraceFileHeader) + maxRecords * sizeof (NiTraceRecord);
+    int32_t ret = posix_fallocate (m_fd, 0, mapSize);
+    if (ret != 0)
+      {
+        // e.g. not supported by the file system, fall back to a sparse file
+        if (ftruncate (m_fd, mapSize) < 0)
+          {
+            printf ("ERROR: NiTrace::Open() -> ftruncate() for %s errno=%i: %s\n", fileName.c_str (), errno, strerror (errno));
+            close (m_fd);
+            m_fd = -1;
+            return -1;
+          }
+      }
+
+    errno = 0;
+    void* pMem = mmap (NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (pMem == MAP_FAILED)
+      {
+        printf ("ERROR: NiTrace::Open() -> mmap() for %s errno=%i: %s\n", fileName.c_str (), errno, strerror (errno));
+        close (m_fd);
+        m_fd = -1;
+        return -1;
+      }
+    madvise (pMem, mapSize, MADV_SEQUENTIAL);
+
+    m_pHdr = new (pMem) NiTraceFileHeader;
+    memcpy (m_pHdr->magic, g_niTraceMagic, sizeof (m_pHdr->magic));
+    m_pHdr->version = NI_TRACE__FILE_VERSION;
+    m_pHdr->recordSize = sizeof (NiTraceRecord);
+    m_pHdr->maxRecords = maxRecords;
+    m_pHdr->startSysTimeNs = NiUtils::GetSysTimeNs ();
+    m_pHdr->simTimeStepsPerSecond = Seconds (1).GetTimeStep ();
+    m_pHdr->numRecords.store (0, std::memory_order_relaxed);
+    m_pHdr->wrap = wrap ? 1 : 0;
+
+    m_pRecords = (NiTraceRecord*)((uint8_t*)pMem + sizeof (NiTraceFileHeader));
+    m_maxRecords = maxRecords;
+    m_wrap = wrap;
+    m_mapSize = mapSize;
+    m_fileName = fileName;
+    m_enabled.store (true, std::memory_order_release);
+    return 0;
+  }
+
+  int32_t NiTrace::Close (void)
+  {
+    if (m_pHdr == NULL)
+      {
+        return 0;
+      }
+    m_enabled.store (false, std::memory_order_release);
+
+    const uint64_t numRecords = m_pHdr->numRecords.load (std::memory_order_acquire);
+    const uint64_t numDropped = GetNumDropped ();
+    munmap (m_pHdr, m_mapSize);
+    if (!m_wrap && (numRecords < m_maxRecords))
+      {
+        // drop the unused preallocated space
+        if (ftruncate (m_fd, sizeof (NiTraceFileHeader) + numRecords * sizeof (NiTraceRecord)) < 0)
+          {
+            printf ("ERROR: NiTrace::Close() -> ftruncate() for %s errno=%i: %s\n", m_fileName.c_str (), errno, strerror (errno));
+          }
+      }
+    close (m_fd);
+
+    printf ("NI.TRACE: %lu records written to %s", (unsigned long) (numRecords - numDropped), m_fileName.c_str ());
+    if (numDropped > 0)
+      {
+        printf (", %lu dropped since the file was full", (unsigned long) numDropped);
+      }
+    printf ("\n");
+
+    m_pHdr = NULL;
+    m_pRecords = NULL;
+    m_fd = -1;
+    return 0;
+  }
+
+  void NiTrace::Write (enum NiTraceId traceId, uint16_t sfn, uint8_t tti,
+                       int64_t p0, int64_t p1, int64_t p2, int64_t p3, int64_t p4)
+  {
+    const uint64_t index = m_pHdr->numRecords.fetch_add (1, std::memory_order_relaxed);
+    if ((index >= m_maxRecords) && !m_wrap)
+      {
+        return;
+      }
+    NiTraceRecord* pRecord = &m_pRecords[m_wrap ? (index % m_maxRecords) : index];
+
+    pRecord->committed = 0;
+    std::atomic_signal_fence (std::memory_order_release);
+    pRecord->traceId = traceId;
+    pRecord->sfn = sfn;
+    pRecord->tti = tti;
+    pRecord->reserved = 0;
+    pRecord->simTimeStep = Simulator::Now ().GetTimeStep ();
+    pRecord->sysTimeNs = NiUtils::GetSysTimeNs ();
+    pRecord->payload[0] = p0;
+    pRecord->payload[1] = p1;
+    pRecord->payload[2] = p2;
+    pRecord->payload[3] = p3;
+    pRecord->payload[4] = p4;
+    // the record is complete in the file as soon as the flag is set, even if the process is killed
+    std::atomic_signal_fence (std::memory_order_release);
+    pRecord->committed = 1;
+  }
+
+  uint64_t NiTrace::GetNumRecords (void) const
+  {
+    return (m_pHdr != NULL) ? m_pHdr->numRecords.load (std::memory_order_relaxed) : 0;
+  }
+
+  uint64_t NiTrace::GetNumDropped (void) const
+  {
+    const uint64_t numRecords = GetNumRecords ();
+    return (!m_wrap && (numRecords > m_maxRecords)) ? (numRecords - m_maxRecords) : 0;
+  }
+
+  int32_t NiTrace::ReadFile (std::string fileName, NiTraceFileHeader* pHdr, std::vector<NiTraceRecord>* pRecords)
+  {
+    errno = 0;
+    int32_t fd = open (fileName.c_str (), O_RDONLY);
+    if (fd < 0)
+      {
+        printf ("ERROR: NiTrace::ReadFile() -> open() for %s errno=%i: %s\n", fileName.c_str (), errno, strerror (errno));
+        return -1;
+      }
+    struct stat st;
+    if ((fstat (fd, &st) < 0) || ((size_t)st.st_size < sizeof (NiTraceFileHeader)))
+      {
+        printf ("ERROR: NiTrace::ReadFile() -> %s is no trace file\n", fileName.c_str ());
+        close (fd);
+        return -1;
+      }
+    void* pMem = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close (fd);
+    if (pMem == MAP_FAILED)
+      {
+        printf ("ERROR: NiTrace::ReadFile() -> mmap() for %s errno=%i: %s\n", fileName.c_str (), errno, strerror (errno));
+        return -1;
+      }
+
+    const NiTraceFileHeader* pFileHdr = (const NiTraceFileHeader*)pMem;
+    if ((memcmp (pFileHdr->magic, g_niTraceMagic, sizeof (g_niTraceMagic)) != 0) ||
+        (pFileHdr->version != NI_TRACE__FILE_VERSION) || (pFileHdr->recordSize != sizeof (NiTraceRecord)))
+      {
+        printf ("ERROR: NiTrace::ReadFile() -> %s has an unsupported format\n", fileName.c_str ());
+        munmap (pMem, st.st_size);
+        return -1;
+      }
+
+    memcpy (pHdr->magic, pFileHdr->magic, sizeof (pHdr->magic));
+    pHdr->version = pFileHdr->version;
+    pHdr->recordSize = pFileHdr->recordSize;
+    pHdr->maxRecords = pFileHdr->maxRecords;
+    pHdr->startSysTimeNs = pFileHdr->startSysTimeNs;
+    pHdr->simTimeStepsPerSecond = pFileHdr->simTimeStepsPerSecond;
+    pHdr->numRecords.store (pFileHdr->numRecords.load (std::memory_order_relaxed), std::memory_order_relaxed);
+    pHdr->wrap = pFileHdr->wrap;
+
+    // a run which was not closed left the preallocated size, a closed run without wrap was truncated
+    const uint64_t numInFile = (st.st_size - sizeof (NiTraceFileHeader)) / sizeof (NiTraceRecord);
+    const uint64_t numRecords = pHdr->numRecords.load (std::memory_order_relaxed);
+    const uint64_t numValid = std::min (std::min (numRecords, pHdr->maxRecords), numInFile);
+    // the oldest record of a wrapped ring is the one following the latest
+    const uint64_t first = (pHdr->wrap && (numRecords > pHdr->maxRecords)) ? (numRecords % pHdr->maxRecords) : 0;
+
+    const NiTraceRecord* pFileRecords = (const NiTraceRecord*)((const uint8_t*)pMem + sizeof (NiTraceFileHeader));
+    pRecords->clear ();
+    pRecords->reserve (numValid);
+    for (uint64_t i = 0; i < numValid; i++)
+      {
+        const NiTraceRecord* pRecord = &pFileRecords[(first + i) % numValid];
+        if (pRecord->committed)
+          {
+            pRecords->push_back (*pRecord);
+          }
+      }
+    munmap (pMem, st.st_size);
+    return 0;
+  }
+
+  const char*
+  NiTrace::GetTraceName (uint16_t traceId)
+  {
+    switch (traceId)
+      {
+      case NI_TRACE_START_SUBFRAME_START:     return "StartSubFrameStart";
+      case NI_TRACE_PHY_TIMING_IND:           return "PhyTimingInd";
+      case NI_TRACE_WALL_CLOCK_ALIGNMENT:     return "WallClockAlignment";
+      case NI_TRACE_START_SUBFRAME_END:       return "StartSubFrameEnd";
+      case NI_TRACE_SEND_CONTROL_CHANNELS:    return "SendControlChannels";
+      case NI_TRACE_SEND_DATA_CHANNELS:       return "SendDataChannels";
+      case NI_TRACE_TX_CTRL_DATA_FRAME_START: return "NiStartTxCtrlDataFrameStart";
+      case NI_TRACE_TX_CTRL_DATA_FRAME_END:   return "NiStartTxCtrlDataFrameEnd";
+      default:                                return "Unknown";
+      }
+  }
+
+  const char*
+  NiTrace::GetPayloadNames (uint16_t traceId)
+  {
+    switch (traceId)
+      {
+      case NI_TRACE_PHY_TIMING_IND:
+        return "diffNs3ToPhyTimingInd,timingIndTimeUs,g_alignmentOffset,g_globalTimingdiffNano,wakeLatencyNs";
+      case NI_TRACE_WALL_CLOCK_ALIGNMENT:
+        return "wallClockDelta,currentAlignment,normalizedRealtime";
+      default:
+        // time since the start of the subframe
+        return "subframeTimeUs";
+      }
+  }
+
+} // namespace ns3
@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#ifndef SRC_NI_MODEL_COMMON_NI_TRACE_H_
+#define SRC_NI_MODEL_COMMON_NI_TRACE_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace ns3 {
+
+  // trace ids - the numbers are the ones of the former "[Trace#n]" log lines
+  enum NiTraceId
+  {
+    NI_TRACE_START_SUBFRAME_START     = 0,
+    NI_TRACE_PHY_TIMING_IND           = 1,
+    NI_TRACE_WALL_CLOCK_ALIGNMENT     = 2,
+    NI_TRACE_START_SUBFRAME_END       = 10,
+    NI_TRACE_SEND_CONTROL_CHANNELS    = 11,
+    NI_TRACE_SEND_DATA_CHANNELS       = 12,
+    NI_TRACE_TX_CTRL_DATA_FRAME_START = 20,
+    NI_TRACE_TX_CTRL_DATA_FRAME_END   = 21
+  };
+
+#define NI_TRACE__NUM_PAYLOAD 5
+#define NI_TRACE__DEFAULT_MAX_RECORDS (1 << 20)
+#define NI_TRACE__FILE_VERSION 1
+
+  // fixed size trace record, one cache line
+  typedef struct sNiTraceRecord {
+    uint16_t traceId;
+    uint16_t sfn;
+    uint8_t tti;
+    uint8_t committed;     // written last, incomplete records of an aborted run stay 0
+    uint16_t reserved;
+    int64_t simTimeStep;   // Simulator::Now time step, see simTimeStepsPerSecond
+    uint64_t sysTimeNs;    // monotonic system time
+    int64_t payload[NI_TRACE__NUM_PAYLOAD];
+  } NiTraceRecord;
+
+  // file header, followed by maxRecords records
+  typedef struct sNiTraceFileHeader {
+    char magic[8];                       // "NITRACE"
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t maxRecords;
+    uint64_t startSysTimeNs;
+    int64_t simTimeStepsPerSecond;
+    std::atomic<uint64_t> numRecords;    // written records, keeps counting when the file is full
+    uint8_t wrap;                        // 1 - the records are a ring holding the latest maxRecords
+    uint8_t pad[64 - 8 - 2*sizeof (uint32_t) - 4*sizeof (uint64_t) - 1];
+  } NiTraceFileHeader;
+
+  // Binary append-only trace file. Records are written into a preallocated,
+  // memory mapped file, so tracing neither allocates nor formats text nor
+  // enters the kernel. Multiple threads may write concurrently.
+  // Without wrap, records beyond maxRecords are dropped and the file is
+  // truncated to the written records on Close().
+  // The file is decoded offline, e.g. by the ni-trace-decode example.
+  class NiTrace
+  {
+  public:
+    NiTrace ();
+    virtual
+    ~NiTrace ();
+
+    int32_t Open (std::string fileName, uint64_t maxRecords, bool wrap);
+    int32_t Close (void);
+
+    bool IsEnabled (void) const
+    {
+      return m_enabled.load (std::memory_order_relaxed);
+    }
+
+    void Write (enum NiTraceId traceId, uint16_t sfn, uint8_t tti,
+                int64_t p0 = 0, int64_t p1 = 0, int64_t p2 = 0, int64_t p3 = 0, int64_t p4 = 0);
+
+    uint64_t GetNumRecords (void) const;
+    uint64_t GetNumDropped (void) const;
+
+    // reads the committed records of a trace file in the order they were written
+    static int32_t ReadFile (std::string fileName, NiTraceFileHeader* pHdr, std::vector<NiTraceRecord>* pRecords);
+    static const char* GetTraceName (uint16_t traceId);
+    // comma separated names of the used payload fields
+    static const char* GetPayloadNames (uint16_t traceId);
+
+  private:
+    std::atomic<bool> m_enabled;
+    NiTraceFileHeader* m_pHdr;
+    NiTraceRecord* m_pRecords;
+    uint64_t m_maxRecords;
+    bool m_wrap;
+    size_t m_mapSize;
+    int32_t m_fd;
+    std::string m_fileName;
+  };
+
+  extern NiTrace g_NiTrace;
+
+/**
+ * Use \ref to write a record to the trace file if tracing is enabled
+ *
+ * \param [in] traceId NiTraceId of the record.
+ * \param [in] sfn System frame number.
+ * \param [in] tti Subframe number.
+ * \param [in] ... Up to NI_TRACE__NUM_PAYLOAD integer payload fields.
+ */
+#define NI_TRACE(traceId, sfn, tti, ...) \
+{\
+  if (g_NiTrace.IsEnabled ()) \
+    {\
+      g_NiTrace.Write (traceId, sfn, tti, ##__VA_ARGS__);\
+    }\
+}\
+
+#define NiTraceInit(TraceFileName, MaxRecords, Wrap) \
+{\
+  g_NiTrace.Open (TraceFileName, MaxRecords, Wrap);\
+}\
+
+#define NiTraceDeInit() \
+{\
+  g_NiTrace.Close ();\
+}\
+
+} // namespace ns3
+
+#endif /* SRC_NI_MODEL_COMMON_NI_TRACE_H_ */
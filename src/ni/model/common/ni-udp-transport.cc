@@ -22,10 +22,15 @@
 #include <sstream>
 #include <iomanip>
 #include <stdio.h>
+#include <errno.h>
+#include <time.h>
+#include <algorithm>
+#include <sys/uio.h>
 
 #include "ns3/ni-logging.h"
 #include "ns3/ni-utils.h"
 
+#include "ni-capture.h"
 #include "ni-udp-transport.h"
 
 namespace ns3
@@ -34,13 +39,35 @@ namespace ns3
   NiUdpTransport::NiUdpTransport ()
   {
     m_context = "none";
-    m_rxApiThreadStop = true;
+    Init ();
   }
 
   NiUdpTransport::NiUdpTransport (std::string context)
   {
     m_context = context;
+    Init ();
+  }
+
+  void
+  NiUdpTransport::Init (void)
+  {
     m_rxApiThreadStop = true;
+    m_niApiTxEndPointOpen = false;
+    m_niApiRxEndPointOpen = false;
+    m_sockFdTx = -1;
+    m_sockFdRx = -1;
+    m_batchSize = 1;
+    m_stats = {};
+    m_pBufU8Rx = NULL;
+    m_rxSlotState = NULL;
+    m_nextRxSlot = 0;
+    m_rxMsgs = NULL;
+    m_rxIovecs = NULL;
+    m_rxMsgSlots = NULL;
+    m_pBufU8Tx = NULL;
+    m_numTxQueued = 0;
+    m_txMsgs = NULL;
+    m_txIovecs = NULL;
   }
 
   NiUdpTransport::~NiUdpTransport ()
@@ -66,6 +93,32 @@ namespace ns3
     return m_niApiRxEndPointOpen;
   }
 
+  void
+  NiUdpTransport::SetBatchSize (uint32_t batchSize)
+  {
+    if (m_niApiTxEndPointOpen || m_niApiRxEndPointOpen)
+      {
+        NI_LOG_FATAL (m_context << " - UDP batch size has to be set before the sockets are opened");
+      }
+    if ((batchSize < 1) || (batchSize > NI_UDP_MAX_BATCH_SIZE))
+      {
+        NI_LOG_FATAL (m_context << " - UDP batch size " << batchSize << " out of range [1.." << NI_UDP_MAX_BATCH_SIZE << "]");
+      }
+    m_batchSize = batchSize;
+  }
+
+  uint32_t
+  NiUdpTransport::GetBatchSize () const
+  {
+    return m_batchSize;
+  }
+
+  const NiUdpTransportStats&
+  NiUdpTransport::GetStats () const
+  {
+    return m_stats;
+  }
+
   void
   NiUdpTransport::OpenUdpSocketTx(std::string remoteTxIpAddr, std::string remoteTxPort)
   {
@@ -103,41 +156,223 @@ namespace ns3
       {
         NI_LOG_FATAL (m_context << " - Error Tx UDP Socket inet_aton() failed!");
       }
+    m_txDestinations.clear();
+    m_txDestinations.push_back(m_remoteAddr);
 
     NI_LOG_DEBUG(m_context << " - UDP TX socket created and opened with"
         << " local socket = "<< m_sockFdTx
         << " address = " << inet_ntoa(localAddr.sin_addr)
         << " port = "<< ntohs(localAddr.sin_port));
 
+    if (m_batchSize > 1)
+      {
+        // one slot per message of a batch, the destination is set per message
+        m_pBufU8Tx = (uint8_t*)malloc(m_maxUdpRxPacketSize*m_batchSize);
+        m_txMsgs   = (struct mmsghdr*)calloc(m_batchSize, sizeof(struct mmsghdr));
+        m_txIovecs = (struct iovec*)calloc(m_batchSize, sizeof(struct iovec));
+        if ((m_pBufU8Tx == NULL) || (m_txMsgs == NULL) || (m_txIovecs == NULL))
+          {
+            NI_LOG_FATAL("NiUdpTransport::OpenUdpSocketTx: malloc for tx batch failed")
+          }
+        for (uint32_t i = 0; i < m_batchSize; i++)
+          {
+            m_txIovecs[i].iov_base = m_pBufU8Tx + i*m_maxUdpRxPacketSize;
+            m_txMsgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+            m_txMsgs[i].msg_hdr.msg_iov     = &m_txIovecs[i];
+            m_txMsgs[i].msg_hdr.msg_iovlen  = 1;
+          }
+        m_numTxQueued = 0;
+      }
+
     m_niApiTxEndPointOpen = true;
   }
 
+  uint32_t
+  NiUdpTransport::AddTxDestination(std::string remoteTxIpAddr, std::string remoteTxPort)
+  {
+    if(!m_niApiTxEndPointOpen)
+      {
+        NI_LOG_FATAL (m_context << "- Error Tx UDP Socket not open");
+      }
+
+    struct sockaddr_in remoteAddr;
+    memset ((char *)&remoteAddr, 0, sizeof (remoteAddr));
+    remoteAddr.sin_family = AF_INET;
+    remoteAddr.sin_port   = htons (atoi (remoteTxPort.c_str ()));
+    if (inet_aton (remoteTxIpAddr.c_str (), &remoteAddr.sin_addr)==0)
+      {
+        NI_LOG_FATAL (m_context << " - Error Tx UDP destination inet_aton() failed!");
+      }
+    // entries of a pending batch point into the vector, so it must not be reallocated under them
+    FlushUdpSocketTx();
+    m_txDestinations.push_back(remoteAddr);
+
+    NI_LOG_DEBUG(m_context << " - UDP Tx destination " << m_txDestinations.size() - 1 << " = " << remoteTxIpAddr << ":" << remoteTxPort);
+
+    return m_txDestinations.size() - 1;
+  }
+
+  uint32_t
+  NiUdpTransport::GetNumTxDestinations() const
+  {
+    return m_txDestinations.size();
+  }
+
   void
   NiUdpTransport::SendToUdpSocketTx(uint8_t *txBuffer, uint32_t txBufferSize)
+  {
+    SendToUdpSocketTxDest(0, txBuffer, txBufferSize);
+  }
+
+  void
+  NiUdpTransport::SendToUdpSocketTxDest(uint32_t destination, uint8_t *txBuffer, uint32_t txBufferSize)
   {
     if(!m_niApiTxEndPointOpen)
       {
         NI_LOG_FATAL (m_context << "- Error Tx UDP Socket not open");
       }
+    if (destination >= m_txDestinations.size())
+      {
+        NI_LOG_FATAL (m_context << "- Tx UDP destination " << destination << " unknown");
+      }
+    struct sockaddr_in* pRemoteAddr = &m_txDestinations[destination];
 
-    NI_LOG_DEBUG(m_context << " - Data of size " << txBufferSize << " sent to ip addr=" << inet_ntoa(m_remoteAddr.sin_addr) << " / port=" << ntohs(m_remoteAddr.sin_port));
-    //PrintBufferU8(txBuffer, 16);
+    if (m_batchSize == 1)
+      {
+        // send tx buffer content to the destination
+        NI_CAPTURE(NI_CAPTURE_DIR_TX, NI_CAPTURE_CHANNEL_UDP, destination, m_context, txBuffer, txBufferSize);
+        if (sendto(m_sockFdTx, txBuffer, txBufferSize, 0, (struct sockaddr *)pRemoteAddr, sizeof(*pRemoteAddr))==-1)
+          {
+            NI_LOG_FATAL (m_context << "- Tx UDP Socket send failed");
+          }
+        m_stats.numTxPackets++;
+        m_stats.numTxCalls++;
+        return;
+      }
 
-    // send tx buffer content to m_remoteAddr
-    if (sendto(m_sockFdTx, txBuffer, txBufferSize, 0, (struct sockaddr *)&m_remoteAddr, sizeof(m_remoteAddr))==-1)
+    if (txBufferSize > m_maxUdpRxPacketSize)
       {
-        NI_LOG_FATAL (m_context << "- Tx UDP Socket send failed");
+        NI_LOG_FATAL (m_context << "- Tx UDP message of size " << txBufferSize << " exceeds batch slot size");
+      }
+
+    // queue a copy, the caller reuses its buffer for the next message
+    memcpy(m_txIovecs[m_numTxQueued].iov_base, txBuffer, txBufferSize);
+    m_txIovecs[m_numTxQueued].iov_len = txBufferSize;
+    m_txMsgs[m_numTxQueued].msg_hdr.msg_name = pRemoteAddr;
+    m_numTxQueued++;
+
+    if (m_numTxQueued == m_batchSize)
+      {
+        FlushUdpSocketTx();
       }
   }
 
+  void
+  NiUdpTransport::SendToUdpSocketTxAll(uint8_t *txBuffer, uint32_t txBufferSize)
+  {
+    SendToUdpSocketTxMsgs(NI_UDP_TX_ALL_DESTINATIONS, &txBuffer, &txBufferSize, 1);
+  }
+
+  void
+  NiUdpTransport::SendToUdpSocketTxMsgs(uint32_t destination, uint8_t* const* txBuffers, const uint32_t* txBufferSizes, uint32_t numMsgs)
+  {
+    if(!m_niApiTxEndPointOpen)
+      {
+        NI_LOG_FATAL (m_context << "- Error Tx UDP Socket not open");
+      }
+    if ((destination != NI_UDP_TX_ALL_DESTINATIONS) && (destination >= m_txDestinations.size()))
+      {
+        NI_LOG_FATAL (m_context << "- Tx UDP destination " << destination << " unknown");
+        return;
+      }
+
+    // keep the order of messages queued before
+    FlushUdpSocketTx();
+
+    // all headers reference the caller's buffers, they are sent before returning
+    m_txFanOutIovecs.resize(numMsgs);
+    for (uint32_t i = 0; i < numMsgs; i++)
+      {
+        m_txFanOutIovecs[i].iov_base = txBuffers[i];
+        m_txFanOutIovecs[i].iov_len  = txBufferSizes[i];
+      }
+    const uint32_t firstDestination = (destination == NI_UDP_TX_ALL_DESTINATIONS) ? 0 : destination;
+    const uint32_t numDestinations  = (destination == NI_UDP_TX_ALL_DESTINATIONS) ? m_txDestinations.size() : 1;
+    m_txFanOutMsgs.resize(numDestinations*numMsgs);
+    for (uint32_t d = 0; d < numDestinations; d++)
+      {
+        for (uint32_t i = 0; i < numMsgs; i++)
+          {
+            struct mmsghdr* pMsg = &m_txFanOutMsgs[d*numMsgs + i];
+            memset(pMsg, 0, sizeof(struct mmsghdr));
+            pMsg->msg_hdr.msg_name    = &m_txDestinations[firstDestination + d];
+            pMsg->msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+            pMsg->msg_hdr.msg_iov     = &m_txFanOutIovecs[i];
+            pMsg->msg_hdr.msg_iovlen  = 1;
+          }
+      }
+    SendMmsg(m_txFanOutMsgs.data(), numDestinations*numMsgs);
+  }
+
+  void
+  NiUdpTransport::FlushUdpSocketTx(void)
+  {
+    SendMmsg(m_txMsgs, m_numTxQueued);
+    m_numTxQueued = 0;
+  }
+
+  void
+  NiUdpTransport::SendMmsg(struct mmsghdr* msgs, uint32_t numMsgs)
+  {
+    uint32_t numSent = 0;
+
+    if (g_NiCapture.IsEnabled())
+      {
+        for (uint32_t i = 0; i < numMsgs; i++)
+          {
+            // the message addresses point into m_txDestinations, record the destination index
+            const uint32_t destination = (struct sockaddr_in*)msgs[i].msg_hdr.msg_name - m_txDestinations.data();
+            g_NiCapture.Write(NI_CAPTURE_DIR_TX, NI_CAPTURE_CHANNEL_UDP, destination, m_context, msgs[i].msg_hdr.msg_iov, msgs[i].msg_hdr.msg_iovlen);
+          }
+      }
+
+    // sendmmsg may return after a part of the messages and takes at most UIO_MAXIOV
+    while (numSent < numMsgs)
+      {
+        const uint32_t numReq = std::min<uint32_t>(numMsgs - numSent, UIO_MAXIOV);
+        const int retVal = sendmmsg(m_sockFdTx, &msgs[numSent], numReq, 0);
+        if (retVal < 0)
+          {
+            if (errno == EINTR) continue;
+            NI_LOG_FATAL (m_context << "- Tx UDP Socket send failed");
+            break;
+          }
+        numSent += retVal;
+        m_stats.numTxCalls++;
+      }
+    m_stats.numTxPackets += numSent;
+  }
+
   void
   NiUdpTransport::CloseUdpSocketTx(void)
   {
-    if (m_sockFdTx >= 0);
-    {
+    if (m_sockFdTx >= 0)
+      {
+        if (m_niApiTxEndPointOpen)
+          {
+            FlushUdpSocketTx();
+          }
         close(m_sockFdTx);
+        m_sockFdTx = -1;
         NI_LOG_DEBUG(m_context << " - UDP Tx socket closed");
-    }
+      }
+    m_niApiTxEndPointOpen = false;
+    free (m_pBufU8Tx);
+    free (m_txMsgs);
+    free (m_txIovecs);
+    m_pBufU8Tx = NULL;
+    m_txMsgs = NULL;
+    m_txIovecs = NULL;
   }
 
   void
@@ -155,9 +390,6 @@ namespace ns3
     localAddrInfoHints.ai_socktype = SOCK_DGRAM;
     localAddrInfoHints.ai_flags    = AI_PASSIVE; // use my IP
 
-    // clear the set
-    FD_ZERO(&m_readFds);
-
     // translation of name of service location (UDP port) to set of socket addresses
     int rxRetVal;
     if ((rxRetVal = getaddrinfo (NULL, localRxPort.c_str(), &localAddrInfoHints, &serverInfo)) != 0)
@@ -217,9 +449,6 @@ namespace ns3
 
     freeaddrinfo (serverInfo);
 
-    // Add the sockfd to the m_readFds set
-    FD_SET (m_sockFdRx, &m_readFds);
-
     // buffer for NIAPI messages
     m_pBufU8Rx = (uint8_t*)malloc(sizeof(uint8_t)*m_maxUdpRxPacketSize*m_numBufU8RxEntries);
     if (m_pBufU8Rx == NULL)
@@ -227,6 +456,21 @@ namespace ns3
         NI_LOG_FATAL("NiUdpTransport::OpenUdpSocketRx: malloc for rxPayload failed")
       }
     memset(m_pBufU8Rx, 0, m_maxUdpRxPacketSize*m_numBufU8RxEntries);
+    m_rxSlotState = new std::atomic<uint8_t>[m_numBufU8RxEntries];
+    for (uint32_t i = 0; i < m_numBufU8RxEntries; i++)
+      {
+        m_rxSlotState[i].store(NI_UDP_RX_SLOT_FREE, std::memory_order_relaxed);
+      }
+    m_nextRxSlot = 0;
+
+    // message headers of one recvmmsg batch, the iovecs point to the slots picked per call
+    m_rxMsgs     = (struct mmsghdr*)calloc(m_batchSize, sizeof(struct mmsghdr));
+    m_rxIovecs   = (struct iovec*)calloc(m_batchSize, sizeof(struct iovec));
+    m_rxMsgSlots = (uint32_t*)calloc(m_batchSize, sizeof(uint32_t));
+    if ((m_rxMsgs == NULL) || (m_rxIovecs == NULL) || (m_rxMsgSlots == NULL))
+      {
+        NI_LOG_FATAL("NiUdpTransport::OpenUdpSocketRx: malloc for rx batch failed")
+      }
 
     // create system thread for listening to local rx port
     m_rxApiThreadStop = false;
@@ -248,11 +492,9 @@ namespace ns3
     // TODO-NI set thread priority!
     //NiUtils::SetThreadPrioriy(...);
 
-    int32_t numBytesRx = 0;
-    uint32_t bufU8RxEntry = 0;
-
     struct sockaddr_storage rxAddr;
     socklen_t rxAddrLen = sizeof (rxAddr);
+    const struct timespec slotStallSleep = {0, 10000L}; // 10us
 
     if(!m_niApiRxEndPointOpen)
       {
@@ -262,29 +504,74 @@ namespace ns3
 
     while(!m_rxApiThreadStop)
       {
-        // the descriptor has data
-        if (FD_ISSET (m_sockFdRx, &m_readFds))
+        // pick the next free buffer slots for this receive call, slots retained by
+        // the consumer are skipped until they were released
+        uint32_t numSlots = 0;
+        for (uint32_t i = 0; (i < m_numBufU8RxEntries) && (numSlots < m_batchSize); i++)
+          {
+            const uint32_t slot = (m_nextRxSlot + i) % m_numBufU8RxEntries;
+            if (m_rxSlotState[slot].load(std::memory_order_acquire) == NI_UDP_RX_SLOT_FREE)
+              {
+                m_rxMsgSlots[numSlots++] = slot;
+              }
+          }
+        if (numSlots == 0)
           {
-            // calculate offset to current buffer entry
-            uint32_t bufU8RxOffset = bufU8RxEntry * m_maxUdpRxPacketSize;
-            //read m_maxUdpRxPacketSize bytes from m_rxBuf into m_sockFdRx, their_addr to identify the sender
-            numBytesRx = recvfrom (m_sockFdRx, m_pBufU8Rx + bufU8RxOffset,\
-                                   m_maxUdpRxPacketSize, 0, \
-                                   (struct sockaddr *)&rxAddr, \
-                                   &rxAddrLen);
-            if (numBytesRx > 0 && !m_rxApiThreadStop)
+            m_stats.numRxSlotStalls++;
+            nanosleep(&slotStallSleep, NULL);
+            continue;
+          }
+
+        // blocks for the first datagram until the socket receive timeout expired,
+        // recvmmsg additionally drains what is queued up to the batch size
+        int32_t numMsgsRx;
+        int32_t numBytesRx = 0;
+        if (m_batchSize == 1)
+          {
+            numBytesRx = recvfrom (m_sockFdRx, m_pBufU8Rx + m_rxMsgSlots[0]*m_maxUdpRxPacketSize,
+                                   m_maxUdpRxPacketSize, 0,
+                                   (struct sockaddr *)&rxAddr, &rxAddrLen);
+            numMsgsRx = (numBytesRx > 0) ? 1 : 0;
+          }
+        else
+          {
+            for (uint32_t i = 0; i < numSlots; i++)
               {
-                NI_LOG_DEBUG(m_context << " - Udp packet of size " << numBytesRx << " from ip addr=" << inet_ntoa(((struct sockaddr_in *)&rxAddr)->sin_addr) << " received.");
-                //PrintBufferU8(rxBuffer, 16);
-
-                // call function for rx packet processing
-                m_niApiDataEndOkCallback(m_pBufU8Rx + bufU8RxOffset);
-                // switch to the next buffer entry
-                bufU8RxEntry = (bufU8RxEntry + 1) % m_numBufU8RxEntries;
-                //printf("%d, %d, %p\n", bufU8RxEntry, bufU8RxOffset, (m_pBufU8Rx + bufU8RxOffset));
+                m_rxIovecs[i].iov_base = m_pBufU8Rx + m_rxMsgSlots[i]*m_maxUdpRxPacketSize;
+                m_rxIovecs[i].iov_len  = m_maxUdpRxPacketSize;
+                m_rxMsgs[i].msg_hdr.msg_iov    = &m_rxIovecs[i];
+                m_rxMsgs[i].msg_hdr.msg_iovlen = 1;
               }
+            numMsgsRx = recvmmsg (m_sockFdRx, m_rxMsgs, numSlots, MSG_WAITFORONE, NULL);
+          }
+        if ((numMsgsRx <= 0) || m_rxApiThreadStop)
+          {
+            continue;
           }
+
+        m_stats.numRxPackets += numMsgsRx;
+        m_stats.numRxCalls++;
+        if ((uint64_t)numMsgsRx > m_stats.maxRxBatch) m_stats.maxRxBatch = numMsgsRx;
+
+        for (int32_t i = 0; i < numMsgsRx; i++)
+          {
+            const uint32_t slot = m_rxMsgSlots[i];
+            m_rxSlotState[slot].store(NI_UDP_RX_SLOT_RX_THREAD, std::memory_order_relaxed);
+            NI_CAPTURE(NI_CAPTURE_DIR_RX, NI_CAPTURE_CHANNEL_UDP, 0, m_context, m_pBufU8Rx + slot*m_maxUdpRxPacketSize,
+                       (m_batchSize == 1) ? (uint32_t) numBytesRx : m_rxMsgs[i].msg_len);
+
+            // call function for rx packet processing
+            m_niApiDataEndOkCallback(m_pBufU8Rx + slot*m_maxUdpRxPacketSize);
+
+            // hand the slot back unless the consumer retained it
+            if (m_rxSlotState[slot].load(std::memory_order_relaxed) == NI_UDP_RX_SLOT_RX_THREAD)
+              {
+                m_rxSlotState[slot].store(NI_UDP_RX_SLOT_FREE, std::memory_order_relaxed);
+              }
+          }
+        m_nextRxSlot = (m_rxMsgSlots[numMsgsRx - 1] + 1) % m_numBufU8RxEntries;
       } // end while loop
+    NiUtils::RemoveThreadInfo (pthread_self());
     NI_LOG_DEBUG(m_context << " - NiUdpTransport::ReceiveFromUdpSocketRx: stopped");
   }
 
@@ -296,11 +583,62 @@ namespace ns3
     if (m_sockFdRx >= 0)
       {
         close(m_sockFdRx);
+        m_sockFdRx = -1;
       }
+    m_niApiRxEndPointOpen = false;
+    PrintStats();
     free (m_pBufU8Rx);
+    delete[] m_rxSlotState;
+    free (m_rxMsgs);
+    free (m_rxIovecs);
+    free (m_rxMsgSlots);
+    m_pBufU8Rx = NULL;
+    m_rxSlotState = NULL;
+    m_rxMsgs = NULL;
+    m_rxIovecs = NULL;
+    m_rxMsgSlots = NULL;
     NI_LOG_DEBUG(m_context << " - NiUdpTransport::CloseUdpSocketRx: socket and thread closed");
   }
 
+  uint32_t
+  NiUdpTransport::GetRxSlot (uint8_t* rxBuffer) const
+  {
+    if ((rxBuffer < m_pBufU8Rx) || (rxBuffer >= m_pBufU8Rx + m_maxUdpRxPacketSize*m_numBufU8RxEntries))
+      {
+        NI_LOG_FATAL (m_context << " - buffer is no UDP Rx buffer of this transport");
+      }
+    // any pointer into the slot identifies it
+    return (rxBuffer - m_pBufU8Rx) / m_maxUdpRxPacketSize;
+  }
+
+  void
+  NiUdpTransport::RetainRxBuffer (uint8_t* rxBuffer)
+  {
+    m_rxSlotState[GetRxSlot(rxBuffer)].store(NI_UDP_RX_SLOT_CONSUMER, std::memory_order_relaxed);
+  }
+
+  void
+  NiUdpTransport::ReleaseRxBuffer (uint8_t* rxBuffer)
+  {
+    // publishes the consumer's accesses before the Rx thread refills the slot
+    m_rxSlotState[GetRxSlot(rxBuffer)].store(NI_UDP_RX_SLOT_FREE, std::memory_order_release);
+  }
+
+  void
+  NiUdpTransport::PrintStats (void) const
+  {
+    if (m_stats.numRxPackets == 0)
+      {
+        return;
+      }
+    NI_LOG_CONSOLE_INFO("-------- NiUdpTransport " << m_context << " Rx (batch size " << m_batchSize << ") --------");
+    NI_LOG_CONSOLE_INFO("Packets            = " << m_stats.numRxPackets);
+    NI_LOG_CONSOLE_INFO("Receive calls      = " << m_stats.numRxCalls << " (avg batch " <<
+                        (double)m_stats.numRxPackets / m_stats.numRxCalls << ", max " << m_stats.maxRxBatch << ")");
+    NI_LOG_CONSOLE_INFO("Slot stalls        = " << m_stats.numRxSlotStalls);
+    NI_LOG_CONSOLE_INFO("-----------------------------------------\n");
+  }
+
   void
   NiUdpTransport::PrintBufferU8(uint8_t* p_buffer, uint32_t p_bufferOffset)
   {
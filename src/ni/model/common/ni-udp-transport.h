@@ -29,6 +29,9 @@
 #include <inttypes.h>
 #include <string.h>
 #include <unistd.h>
+#include <atomic>
+#include <vector>
+#include <sys/socket.h>
 
 #include <ns3/object.h>
 #include <ns3/system-thread.h>
@@ -39,6 +42,29 @@ namespace ns3
 
   typedef Callback< bool, uint8_t* > NiUdpTransportDataEndOkCallback;
 
+  // maximum number of datagrams handled by one recvmmsg / sendmmsg call
+#define NI_UDP_MAX_BATCH_SIZE 64
+  // destination of SendToUdpSocketTxMsgs addressing all tx destinations
+#define NI_UDP_TX_ALL_DESTINATIONS 0xFFFFFFFF
+
+  // owner of an Rx buffer slot
+  enum NiUdpRxSlotState_t
+  {
+    NI_UDP_RX_SLOT_FREE = 0,   // can be filled by the next receive call
+    NI_UDP_RX_SLOT_RX_THREAD,  // filled, data end ok callback running
+    NI_UDP_RX_SLOT_CONSUMER    // retained by the consumer until ReleaseRxBuffer
+  };
+
+  struct NiUdpTransportStats
+  {
+    uint64_t numRxPackets;
+    uint64_t numRxCalls;      // recvfrom / recvmmsg calls which returned data
+    uint64_t maxRxBatch;
+    uint64_t numRxSlotStalls; // no free Rx slot since all were retained by the consumer
+    uint64_t numTxPackets;
+    uint64_t numTxCalls;      // sendto / sendmmsg calls
+  };
+
   // note - used as member of ns-3 object class - mainly used for callback functionality
   class NiUdpTransport : public Object
   {
@@ -52,18 +78,46 @@ namespace ns3
     bool GetTxEndPointOpen () const;
     bool GetRxEndPointOpen () const;
 
+    // number of datagrams per recvmmsg / sendmmsg call, 1 selects recvfrom / sendto
+    // note: has to be set before the sockets are opened
+    void SetBatchSize (uint32_t batchSize);
+    uint32_t GetBatchSize () const;
+    const NiUdpTransportStats& GetStats () const;
+
+    // the remote address becomes tx destination 0, further destinations share the tx socket
     void OpenUdpSocketTx(std::string remoteTxIpAddr, std::string remoteTxPort);
+    uint32_t AddTxDestination(std::string remoteTxIpAddr, std::string remoteTxPort);
+    uint32_t GetNumTxDestinations() const;
+    // in batch mode the message is copied and queued until the batch is full or flushed
     void SendToUdpSocketTx(uint8_t* txBuffer, uint32_t txBufferSize);
+    void SendToUdpSocketTxDest(uint32_t destination, uint8_t* txBuffer, uint32_t txBufferSize);
+    // sends the message to all tx destinations with one sendmmsg per up to UIO_MAXIOV destinations
+    void SendToUdpSocketTxAll(uint8_t* txBuffer, uint32_t txBufferSize);
+    // sends numMsgs messages in order to one or all (NI_UDP_TX_ALL_DESTINATIONS) destinations
+    // with one sendmmsg without copying them, the buffers can be reused after return
+    void SendToUdpSocketTxMsgs(uint32_t destination, uint8_t* const* txBuffers, const uint32_t* txBufferSizes, uint32_t numMsgs);
+    void FlushUdpSocketTx(void);
     void CloseUdpSocketTx(void);
 
     void OpenUdpSocketRx(std::string locaRxPort, int rxThreadPriority);
     void ReceiveFromUdpSocketRx();
     void CloseUdpSocketRx(void);
 
+    // Rx buffers are owned by the transport and reused once the data end ok callback
+    // returned. A consumer keeping a buffer beyond the callback has to retain it within
+    // the callback and release it afterwards from any thread.
+    void RetainRxBuffer(uint8_t* rxBuffer);
+    void ReleaseRxBuffer(uint8_t* rxBuffer);
+
     void PrintBufferU8(uint8_t* p_buffer, uint32_t p_bufferOffset);
 
   private:
 
+    void Init (void);
+    void SendMmsg (struct mmsghdr* msgs, uint32_t numMsgs);
+    uint32_t GetRxSlot (uint8_t* rxBuffer) const;
+    void PrintStats (void) const;
+
     NiUdpTransportDataEndOkCallback m_niApiDataEndOkCallback;
 
     std::string m_niUdpRemoteIpAddrTx;
@@ -73,13 +127,29 @@ namespace ns3
     std::string m_context; // "LTE" or "WIFI"
 
     struct sockaddr_in m_remoteAddr;
+    std::vector<struct sockaddr_in> m_txDestinations;
+    std::vector<struct mmsghdr> m_txFanOutMsgs;
+    std::vector<struct iovec> m_txFanOutIovecs;
 
     int32_t m_sockFdTx, m_sockFdRx;
-    fd_set m_readFds;
+
+    uint32_t m_batchSize;
+    NiUdpTransportStats m_stats;
 
     uint8_t*  m_pBufU8Rx;
     const uint32_t m_numBufU8RxEntries = 128; // number of buffer entries for UDP Rx Thread
     const size_t m_maxUdpRxPacketSize = NI_COMMON_CONST_MAX_PAYLOAD_SIZE; // bytes
+    std::atomic<uint8_t>* m_rxSlotState;      // NiUdpRxSlotState_t per buffer entry
+    uint32_t m_nextRxSlot;
+    struct mmsghdr* m_rxMsgs;
+    struct iovec* m_rxIovecs;
+    uint32_t* m_rxMsgSlots;
+
+    // queued messages of the current Tx batch
+    uint8_t*  m_pBufU8Tx;
+    uint32_t m_numTxQueued;
+    struct mmsghdr* m_txMsgs;
+    struct iovec* m_txIovecs;
 
     bool m_niApiTxEndPointOpen;
     bool m_niApiRxEndPointOpen;
@@ -26,6 +26,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/time.h>
+#include <time.h>
+#include <mutex>
+#include <sstream>
 #include "ns3/fatal-error.h"
 #include "ni-utils.h"
 
@@ -33,8 +36,12 @@ namespace ns3 {
 
 // local variables
 static std::vector<ThreadInfo> m_threadInfo;
+static std::vector<ThreadPlacement> m_threadTopology;
+// threads register themselves concurrently
+static std::mutex m_threadInfoLock;
 // local function prototypes
 void NiUtilsHandleSignals (int sig);
+static void NiUtilsApplyThreadTopology (const ThreadInfo& threadInfo);
 
 
 
@@ -81,19 +88,213 @@ void NiUtils::AddThreadInfo (pthread_t threadId, std::string threadName)
   ThreadInfo threadInfo;
   threadInfo.id = threadId;
   threadInfo.name = threadName;
+  std::lock_guard<std::mutex> lock(m_threadInfoLock);
   m_threadInfo.push_back(threadInfo);
-  pthread_setname_np(threadId, threadName.c_str());
+  // kernel thread names are limited to 15 characters
+  pthread_setname_np(threadId, threadName.substr(0, 15).c_str());
+  NiUtilsApplyThreadTopology(threadInfo);
+}
+
+void NiUtils::RemoveThreadInfo (pthread_t threadId)
+{
+  std::lock_guard<std::mutex> lock(m_threadInfoLock);
+  for(std::vector<ThreadInfo>::iterator it = m_threadInfo.begin(); it != m_threadInfo.end(); ++it) {
+      if (pthread_equal(it->id, threadId))
+        {
+          m_threadInfo.erase(it);
+          break;
+        }
+  }
 }
 
 void NiUtils::PrintThreadInfo(void)
 {
+  std::lock_guard<std::mutex> lock(m_threadInfoLock);
   for(std::vector<ThreadInfo>::iterator it = m_threadInfo.begin(); it != m_threadInfo.end(); ++it) {
-      std::cout << "threadName:" << it->name << ", threadId:" << it->id << std::endl;
+      std::cout << "threadName:" << it->name << ", threadId:" << it->id << ", " << GetThreadPlacement(it->id) << std::endl;
   }
 }
 
+// parses "0,2-3" into a cpu set
+static bool NiUtilsParseCpuList (const std::string& cpuList, cpu_set_t* pCpus)
+{
+  CPU_ZERO(pCpus);
+  std::stringstream ss(cpuList);
+  std::string range;
+  while (std::getline(ss, range, ','))
+    {
+      unsigned first, last;
+      char dash;
+      std::stringstream rs(range);
+      if (!(rs >> first))
+        {
+          return false;
+        }
+      last = first;
+      if ((rs >> dash) && ((dash != '-') || !(rs >> last)))
+        {
+          return false;
+        }
+      if ((last < first) || (last >= CPU_SETSIZE))
+        {
+          return false;
+        }
+      for (unsigned cpu = first; cpu <= last; cpu++)
+        {
+          CPU_SET(cpu, pCpus);
+        }
+    }
+  return CPU_COUNT(pCpus) > 0;
+}
+
+void NiUtils::SetThreadTopology(std::string topology)
+{
+  std::vector<ThreadPlacement> threadTopology;
+  std::stringstream ss(topology);
+  std::string rule;
+  while (std::getline(ss, rule, ';'))
+    {
+      if (rule.empty())
+        {
+          continue;
+        }
+      const size_t eq = rule.find('=');
+      if ((eq == std::string::npos) || (eq == 0))
+        {
+          NS_FATAL_ERROR("Thread topology rule without name pattern: " << rule);
+        }
+      ThreadPlacement placement;
+      placement.pattern = rule.substr(0, eq);
+      std::stringstream fields(rule.substr(eq + 1));
+      std::string cpuList, policy, priority;
+      std::getline(fields, cpuList, ':');
+      std::getline(fields, policy, ':');
+      std::getline(fields, priority, ':');
+
+      placement.setCpus = !cpuList.empty();
+      if (placement.setCpus && !NiUtilsParseCpuList(cpuList, &placement.cpus))
+        {
+          NS_FATAL_ERROR("Invalid cpu list in thread topology rule: " << rule);
+        }
+      if (policy.empty())
+        {
+          placement.policy = -1;
+        }
+      else if (policy == "fifo")
+        {
+          placement.policy = SCHED_FIFO;
+        }
+      else if (policy == "rr")
+        {
+          placement.policy = SCHED_RR;
+        }
+      else if (policy == "other")
+        {
+          placement.policy = SCHED_OTHER;
+        }
+      else
+        {
+          NS_FATAL_ERROR("Invalid scheduling policy in thread topology rule: " << rule);
+        }
+      placement.setPriority = !priority.empty();
+      placement.priority = placement.setPriority ? atoi(priority.c_str()) : 0;
+      threadTopology.push_back(placement);
+    }
+
+  std::lock_guard<std::mutex> lock(m_threadInfoLock);
+  m_threadTopology = threadTopology;
+  for(std::vector<ThreadInfo>::iterator it = m_threadInfo.begin(); it != m_threadInfo.end(); ++it) {
+      NiUtilsApplyThreadTopology(*it);
+  }
+}
+
+// called with m_threadInfoLock held
+static void NiUtilsApplyThreadTopology (const ThreadInfo& threadInfo)
+{
+  if (m_threadTopology.empty())
+    {
+      return;
+    }
+  for (std::vector<ThreadPlacement>::const_iterator it = m_threadTopology.begin(); it != m_threadTopology.end(); ++it)
+    {
+      if (threadInfo.name.find(it->pattern) == std::string::npos)
+        {
+          continue;
+        }
+      if (it->setCpus && (pthread_setaffinity_np(threadInfo.id, sizeof(cpu_set_t), &it->cpus) != 0))
+        {
+          NS_FATAL_ERROR("Error setting cpu affinity of " << threadInfo.name);
+        }
+      if ((it->policy >= 0) || it->setPriority)
+        {
+          int policy;
+          struct sched_param param;
+          if (pthread_getschedparam(threadInfo.id, &policy, &param) != 0)
+            {
+              NS_FATAL_ERROR("Error getting thread priority of " << threadInfo.name);
+            }
+          if (it->policy >= 0)
+            {
+              policy = it->policy;
+              // the priority of real-time policies has to be set, SCHED_OTHER requires 0
+              param.sched_priority = (policy == SCHED_OTHER) ? 0 : sched_get_priority_min(policy);
+            }
+          if (it->setPriority)
+            {
+              param.sched_priority = it->priority;
+            }
+          if (pthread_setschedparam(threadInfo.id, policy, &param) != 0)
+            {
+              NS_FATAL_ERROR("Error setting scheduling policy and priority of " << threadInfo.name);
+            }
+        }
+      break;
+    }
+  std::cout << "NI.THREAD: " << threadInfo.name << ": " << NiUtils::GetThreadPlacement(threadInfo.id) << std::endl;
+}
+
+std::string NiUtils::GetThreadPlacement(pthread_t threadId)
+{
+  std::stringstream ss;
+  cpu_set_t cpus;
+  if (pthread_getaffinity_np(threadId, sizeof(cpu_set_t), &cpus) == 0)
+    {
+      // print the cpu set as list of ranges
+      ss << "cpus ";
+      int first = -1;
+      bool separator = false;
+      for (int cpu = 0; cpu <= CPU_SETSIZE; cpu++)
+        {
+          const bool set = (cpu < CPU_SETSIZE) && CPU_ISSET(cpu, &cpus);
+          if (set && (first < 0))
+            {
+              first = cpu;
+            }
+          else if (!set && (first >= 0))
+            {
+              ss << (separator ? "," : "") << first;
+              if (cpu - 1 > first)
+                {
+                  ss << "-" << cpu - 1;
+                }
+              separator = true;
+              first = -1;
+            }
+        }
+    }
+  int policy;
+  struct sched_param param;
+  if (pthread_getschedparam(threadId, &policy, &param) == 0)
+    {
+      ss << ", " << ((policy == SCHED_FIFO) ? "SCHED_FIFO" : ((policy == SCHED_RR) ? "SCHED_RR" : "SCHED_OTHER"))
+         << " " << param.sched_priority;
+    }
+  return ss.str();
+}
+
 std::string NiUtils::GetThreadName (pthread_t threadId)
 {
+  std::lock_guard<std::mutex> lock(m_threadInfoLock);
   std::string threadName = "unknown";
   for(std::vector<ThreadInfo>::iterator it = m_threadInfo.begin(); it != m_threadInfo.end(); ++it) {
       if (it->id == threadId)
@@ -149,6 +350,22 @@ uint64_t NiUtils::GetSysTime(void)
   return (systime.tv_sec * 1000000 + systime.tv_usec);
 }
 
+// monotonic time stamp in nanoseconds, used for latency measurements
+uint64_t NiUtils::GetSysTimeNs(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+// cpu time consumed by the calling thread in microseconds
+uint64_t NiUtils::GetThreadCpuTimeUs(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+
 
 // converts FXP I8<6.2> to double value
 double NiUtils::ConvertFxpI8_6_2ToDouble(uint8_t fxp)
@@ -174,6 +391,14 @@ double NiUtils::ConvertFxpI8_6_2ToDouble(uint8_t fxp)
   return (integerPartDbl + decimalPartDbl);
 }
 
+// converts double value to FXP I8<6.2>, rounded to 0.25 and saturated to [-32, 31.75]
+uint8_t NiUtils::ConvertDoubleToFxpI8_6_2(double value)
+{
+  double scaled = value * 4.0;
+  scaled = (scaled < -128.0) ? -128.0 : ((scaled > 127.0) ? 127.0 : scaled);
+  return (uint8_t) ((int8_t) ((scaled < 0) ? (scaled - 0.5) : (scaled + 0.5)));
+}
+
 
 
 // local C functions
@@ -26,6 +26,7 @@
 #include <thread>
 #include <vector>
 #include <cstdint>
+#include <sched.h>
 
 namespace ns3 {
 
@@ -35,19 +36,43 @@ typedef struct sThreadInfo {
   std::string name;
 } ThreadInfo;
 
+// CPU placement of the NI threads whose name contains the pattern
+typedef struct sThreadPlacement {
+  std::string pattern;
+  bool setCpus;
+  cpu_set_t cpus;
+  int policy;           // SCHED_FIFO, SCHED_RR, SCHED_OTHER or -1 to keep the policy
+  bool setPriority;
+  int priority;
+} ThreadPlacement;
+
 class NiUtils
 {
 public:
   NiUtils ();
   static int GetThreadPrioriy(void);
   static void SetThreadPrioriy(int priority);
+  // registers a thread by name and applies the thread topology to it
   static void AddThreadInfo (pthread_t threadId, std::string threadName);
+  // has to be called before a registered thread exits
+  static void RemoveThreadInfo (pthread_t threadId);
   static void PrintThreadInfo(void);
+  // Sets the placement of named threads, applied to registered threads and to threads
+  // registered later. Rules are separated by ';', the first matching rule is applied:
+  //   <name pattern>=<cpu list>[:<fifo|rr|other>[:<priority>]]
+  // e.g. "PhyTimingInd=2:fifo:90;RxIndCnf=3:fifo:89;Nilogging=0-1:other:0"
+  // An empty cpu list, policy or priority keeps the current value.
+  static void SetThreadTopology(std::string topology);
+  // effective cpu set, scheduling policy and priority, e.g. "cpus 2, SCHED_FIFO 90"
+  static std::string GetThreadPlacement(pthread_t threadId);
   static std::string GetThreadName (pthread_t threadId);
   static void InstallSignalHandler(void);
   static void Backtrace(void);
   static uint64_t GetSysTime(void);
+  static uint64_t GetSysTimeNs(void);
+  static uint64_t GetThreadCpuTimeUs(void);
   static double ConvertFxpI8_6_2ToDouble(uint8_t fxp);
+  static uint8_t ConvertDoubleToFxpI8_6_2(double value);
 private:
 
   virtual
@@ -0,0 +1,220 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#pragma once
+
+#include <cstddef>       // offsetof
+#include <cstdint>       // integer types
+#include <cstring>       // memcpy
+#include "ni-l1-l2-api-lte.h"
+
+namespace ns3 {
+
+//======================================================================================
+// Compile time specialized NIAPI encoders / decoders
+//
+// The byte widths of the LteElementsSpec tables in ni-l1-l2-api-lte.h are repeated
+// here as template parameters. All NIAPI structures consist of uint32_t elements
+// only, so the fixed part of a message (headers and parameter set bodies without
+// the uint8_t arrays) is one contiguous uint32_t array. The codec of a message is
+// the concatenation of the field specs of its parts; field offsets and the wire
+// size are constants and each field becomes a single big-endian store / load.
+// The result is byte-identical to SerializeStruct / DeserializeStruct.
+//======================================================================================
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "NiApiField assumes a little endian host"
+#endif
+
+// big-endian store / load of the lower W bytes of an element
+template <uint8_t W> struct NiApiField;
+
+template <> struct NiApiField<1>
+{
+  static inline void Store (uint8_t* p_buffer, uint32_t value)
+  {
+    p_buffer[0] = (uint8_t) value;
+  }
+  static inline uint32_t Load (const uint8_t* p_buffer)
+  {
+    return p_buffer[0];
+  }
+};
+
+template <> struct NiApiField<2>
+{
+  static inline void Store (uint8_t* p_buffer, uint32_t value)
+  {
+    const uint16_t be = __builtin_bswap16 ((uint16_t) value);
+    memcpy (p_buffer, &be, 2);
+  }
+  static inline uint32_t Load (const uint8_t* p_buffer)
+  {
+    uint16_t be;
+    memcpy (&be, p_buffer, 2);
+    return __builtin_bswap16 (be);
+  }
+};
+
+template <> struct NiApiField<3>
+{
+  static inline void Store (uint8_t* p_buffer, uint32_t value)
+  {
+    p_buffer[0] = (uint8_t) (value >> 16);
+    p_buffer[1] = (uint8_t) (value >> 8);
+    p_buffer[2] = (uint8_t) value;
+  }
+  static inline uint32_t Load (const uint8_t* p_buffer)
+  {
+    return (p_buffer[0] << 16) | (p_buffer[1] << 8) | p_buffer[2];
+  }
+};
+
+template <> struct NiApiField<4>
+{
+  static inline void Store (uint8_t* p_buffer, uint32_t value)
+  {
+    const uint32_t be = __builtin_bswap32 (value);
+    memcpy (p_buffer, &be, 4);
+  }
+  static inline uint32_t Load (const uint8_t* p_buffer)
+  {
+    uint32_t be;
+    memcpy (&be, p_buffer, 4);
+    return __builtin_bswap32 (be);
+  }
+};
+
+// field spec -- one byte width per uint32_t element, unrolled at compile time
+template <uint8_t... W> struct NiApiFieldSpec;
+
+template <> struct NiApiFieldSpec<>
+{
+  static const uint32_t numEl = 0;
+  static const uint32_t size  = 0;
+  static inline void Serialize (const uint32_t* p_struct, uint8_t* p_buffer) {}
+  static inline void Deserialize (uint32_t* p_struct, const uint8_t* p_buffer) {}
+};
+
+template <uint8_t W0, uint8_t... W> struct NiApiFieldSpec<W0, W...>
+{
+  typedef NiApiFieldSpec<W...> Tail;
+  static const uint32_t numEl = 1 + Tail::numEl;
+  static const uint32_t size  = W0 + Tail::size;   // bytes on the wire
+
+  static inline void Serialize (const uint32_t* p_struct, uint8_t* p_buffer)
+  {
+    NiApiField<W0>::Store (p_buffer, p_struct[0]);
+    Tail::Serialize (p_struct + 1, p_buffer + W0);
+  }
+  static inline void Deserialize (uint32_t* p_struct, const uint8_t* p_buffer)
+  {
+    p_struct[0] = NiApiField<W0>::Load (p_buffer);
+    Tail::Deserialize (p_struct + 1, p_buffer + W0);
+  }
+};
+
+// concatenation of field specs
+template <typename... S> struct NiApiFieldSpecCat;
+
+template <typename S> struct NiApiFieldSpecCat<S>
+{
+  typedef S Type;
+};
+
+template <uint8_t... A, uint8_t... B, typename... S>
+struct NiApiFieldSpecCat<NiApiFieldSpec<A...>, NiApiFieldSpec<B...>, S...>
+{
+  typedef typename NiApiFieldSpecCat<NiApiFieldSpec<A..., B...>, S...>::Type Type;
+};
+
+//--------------------------------------------------------------------------------------
+// field specs of headers and parameter set bodies (see ni-l1-l2-api-lte.h)
+//--------------------------------------------------------------------------------------
+
+typedef NiApiFieldSpec<2, 2, 1, 3>    GenMsgHdrCodec;
+typedef NiApiFieldSpec<2, 1, 1, 1, 3> LteSubMsgHdrCodec;
+typedef NiApiFieldSpec<1, 1, 3>       ParSetHdrCodec;
+
+typedef NiApiFieldSpec<1, 2>          CnfBodyCodec;
+typedef NiApiFieldSpec<1, 2, 4, 1>    DlschTxConfigBodyCodec;
+typedef NiApiFieldSpec<2, 1, 4, 1, 1> DciTxConfigDlGrantBodyCodec;
+typedef NiApiFieldSpec<1, 3>          MacPduTxBodyHdrCodec;       // DLSCH / ULSCH MAC PDU TX without PDU
+typedef NiApiFieldSpec<2, 1, 3>       MacPduRxBodyHdrCodec;       // DLSCH / ULSCH MAC PDU RX without PDU
+typedef NiApiFieldSpec<2, 1, 1>       CellMeasReportBodyHdrCodec; // without subband SINR array
+
+//--------------------------------------------------------------------------------------
+// fixed part of complete NIAPI messages
+//--------------------------------------------------------------------------------------
+
+typedef NiApiFieldSpecCat<GenMsgHdrCodec, LteSubMsgHdrCodec>::Type MsgHdrCodec;
+
+typedef MsgHdrCodec PhyTimingIndCodec;
+
+typedef NiApiFieldSpecCat<MsgHdrCodec, ParSetHdrCodec, CnfBodyCodec>::Type PhyCnfCodec;
+
+typedef NiApiFieldSpecCat<MsgHdrCodec,
+                          ParSetHdrCodec, DlschTxConfigBodyCodec,
+                          ParSetHdrCodec, DciTxConfigDlGrantBodyCodec>::Type PhyDlTxConfigReqCodec;
+
+typedef NiApiFieldSpecCat<MsgHdrCodec, ParSetHdrCodec, MacPduTxBodyHdrCodec>::Type PhyTxPayloadReqHdrCodec;
+
+typedef NiApiFieldSpecCat<MsgHdrCodec, ParSetHdrCodec, MacPduRxBodyHdrCodec>::Type PhyMacPduRxIndHdrCodec;
+
+// parameter sets of each further PDU of a multi PDU DL config / payload request
+typedef NiApiFieldSpecCat<ParSetHdrCodec, DlschTxConfigBodyCodec,
+                          ParSetHdrCodec, DciTxConfigDlGrantBodyCodec>::Type DlTxConfigParSetsCodec;
+
+typedef NiApiFieldSpecCat<ParSetHdrCodec, MacPduTxBodyHdrCodec>::Type MacPduTxParSetHdrCodec;
+
+typedef NiApiFieldSpecCat<MsgHdrCodec, ParSetHdrCodec, CellMeasReportBodyHdrCodec>::Type PhyCellMeasIndHdrCodec;
+
+// the codecs rely on the fixed part being a gap-less uint32_t array
+static_assert (PhyTimingIndCodec::numEl * sizeof (uint32_t) == sizeof (PhyTimingInd),
+               "PhyTimingInd layout does not match its codec");
+static_assert (PhyCnfCodec::numEl * sizeof (uint32_t) == sizeof (PhyCnf),
+               "PhyCnf layout does not match its codec");
+static_assert (PhyDlTxConfigReqCodec::numEl * sizeof (uint32_t) == sizeof (PhyDlTxConfigReq),
+               "PhyDlTxConfigReq layout does not match its codec");
+static_assert (PhyTxPayloadReqHdrCodec::numEl * sizeof (uint32_t) == sizeof (PhyTxPayloadReqHdr),
+               "PhyTxPayloadReqHdr layout does not match its codec");
+static_assert (PhyTxPayloadReqHdrCodec::numEl * sizeof (uint32_t) == offsetof (PhyDlTxPayloadReq, dlschMacPduTxBody.macPdu),
+               "PhyDlTxPayloadReq layout does not match its codec");
+static_assert (PhyTxPayloadReqHdrCodec::numEl * sizeof (uint32_t) == offsetof (PhyUlTxPayloadReq, ulschMacPduTxBody.macPdu),
+               "PhyUlTxPayloadReq layout does not match its codec");
+static_assert (PhyMacPduRxIndHdrCodec::numEl * sizeof (uint32_t) == offsetof (PhyDlschRxInd, dlschMacPduRxBody.macPdu),
+               "PhyDlschRxInd layout does not match its codec");
+static_assert (PhyMacPduRxIndHdrCodec::numEl * sizeof (uint32_t) == offsetof (PhyUlschRxInd, ulschMacPduRxBody.macPdu),
+               "PhyUlschRxInd layout does not match its codec");
+static_assert (PhyCellMeasIndHdrCodec::numEl * sizeof (uint32_t) == offsetof (PhyCellMeasInd, cellMeasReportBody.subbandSinr),
+               "PhyCellMeasInd layout does not match its codec");
+static_assert (PhyTxPayloadReqHdrCodec::size == PHY_TX_PAYLOAD_REQ_HDR_SIZE,
+               "PHY_TX_PAYLOAD_REQ_HDR_SIZE does not match its codec");
+static_assert (DlTxConfigParSetsCodec::numEl * sizeof (uint32_t) == sizeof (PhyDlTxConfigReq) - offsetof (PhyDlTxConfigReq, dlschTxConfigHdr),
+               "PhyDlTxConfigReq parameter sets do not match their codec");
+static_assert (MacPduTxParSetHdrCodec::numEl * sizeof (uint32_t) == sizeof (PhyTxPayloadReqHdr) - offsetof (PhyTxPayloadReqHdr, macPduTxHdr),
+               "PhyTxPayloadReqHdr parameter set does not match its codec");
+static_assert (DlTxConfigParSetsCodec::size == PHY_DL_TX_CONFIG_PAR_SETS_SIZE,
+               "PHY_DL_TX_CONFIG_PAR_SETS_SIZE does not match its codec");
+static_assert (MacPduTxParSetHdrCodec::size == PHY_TX_PAYLOAD_PAR_SET_HDR_SIZE,
+               "PHY_TX_PAYLOAD_PAR_SET_HDR_SIZE does not match its codec");
+
+} //namespace ns3
@@ -20,38 +20,27 @@
  */
 
 #include <cstdint>       // integer types
-#include "../common/ni-l1-l2-api-common-handler.h"
+#include <cstring>       // memcpy
+#include "ni-l1-l2-api-lte-codec.h"
 #include "ni-l1-l2-api-lte-handler.h"
 
 namespace ns3 {
 
+// All messages are encoded by the compile time specialized codecs of
+// ni-l1-l2-api-lte-codec.h, uint8_t arrays (MAC PDU, subband SINR) are copied
+// separately after the fixed part.
+
 //======================================================================================
-static int32_t SerializeMessageHeader(
-  GenMsgHdr* p_genMsgHdr,
-  LteSubMsgHdr* p_subMsgHdr,
-  uint8_t*   p_buffer,
-  uint32_t*  p_bufferOffset
+int32_t SerializePhyDlTxConfigReq(
+  PhyDlTxConfigReq* p_phyDlTxConfigReq,
+  uint8_t*          p_buffer,
+  uint32_t*         p_bufferOffset
 )
 //======================================================================================
 {
 
-  // Serialize general message header.
-  SerializeStruct(
-    (uint32_t*) p_genMsgHdr,
-    genMsgHdrSpec.numEl,
-    (uint8_t*) &(genMsgHdrSpec.byteWidth),
-    p_buffer,
-    p_bufferOffset
-  );
-
-  // Serialize sub message header.
-  SerializeStruct(
-    (uint32_t*) p_subMsgHdr,
-    subMsgHdrSpec.numEl,
-    (uint8_t*) &(subMsgHdrSpec.byteWidth),
-    p_buffer,
-    p_bufferOffset
-  );
+  PhyDlTxConfigReqCodec::Serialize ((uint32_t*) p_phyDlTxConfigReq, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += PhyDlTxConfigReqCodec::size;
 
   return 0;
 }
@@ -61,32 +50,18 @@ static int32_t SerializeMessageHeader(
 
 
 //======================================================================================
-static int32_t DeserializeMessageHeader(
-  GenMsgHdr* p_genMsgHdr,
-  LteSubMsgHdr* p_subMsgHdr,
-  uint8_t*   p_buffer,
-  uint32_t*  p_bufferOffset
+int32_t SerializePhyDlTxPayloadReq(
+  PhyDlTxPayloadReq* p_phyDlTxPayloadReq,
+  uint8_t*           p_buffer,
+  uint32_t*          p_bufferOffset
 )
 //======================================================================================
 {
 
-  // Deserialize general message header.
-  DeserializeStruct(
-    (uint32_t*) p_genMsgHdr,
-    genMsgHdrSpec.numEl,
-    (uint8_t*) &(genMsgHdrSpec.byteWidth),
-    p_buffer,
-    p_bufferOffset
-  );
-
-  // Deserialize sub message header.
-  DeserializeStruct(
-    (uint32_t*) p_subMsgHdr,
-    subMsgHdrSpec.numEl,
-    (uint8_t*) &(subMsgHdrSpec.byteWidth),
-    p_buffer,
-    p_bufferOffset
-  );
+  PhyTxPayloadReqHdrCodec::Serialize ((uint32_t*) p_phyDlTxPayloadReq, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += PhyTxPayloadReqHdrCodec::size;
+  memcpy (p_buffer + (*p_bufferOffset), p_phyDlTxPayloadReq->dlschMacPduTxBody.macPdu, p_phyDlTxPayloadReq->dlschMacPduTxBody.macPduSize);
+  (*p_bufferOffset) += p_phyDlTxPayloadReq->dlschMacPduTxBody.macPduSize;
 
   return 0;
 }
@@ -96,135 +71,18 @@ static int32_t DeserializeMessageHeader(
 
 
 //======================================================================================
-static int32_t SerializeParameterSet(
-  uint32_t   msgType,
-  uint32_t   subMsgType,
-  ParSetHdr* p_parSetHdr,
-  uint32_t*  p_msgBody,      // Note: Type is uint32_t* in order to support generic parameter sets
-  uint8_t*   p_buffer,
-  uint32_t*  p_bufferOffset
+int32_t SerializePhyUlTxPayloadReq(
+  PhyUlTxPayloadReq* p_phyUlTxPayloadReq,
+  uint8_t*           p_buffer,
+  uint32_t*          p_bufferOffset
 )
 //======================================================================================
 {
 
-  // Depending on the message body, select the right specification of its elements.
-  uint8_t  num_el;
-  uint8_t* p_byte_width;
-
-  switch ( msgType )
-  {
-
-    case (PHY_DL_TX_CONFIG_REQ):
-    {
-
-      switch ( subMsgType )
-      {
-        case (DLSCH_TX_CONFIG):
-        {
-          num_el       = dlschTxConfigBodySpec.numEl;
-          p_byte_width = (uint8_t*) &(dlschTxConfigBodySpec.byteWidth);
-          break;
-        }
-        case (DCI_TX_CONFIG_DL_GRANT):
-        {
-          num_el       = dciTxConfigDlGrantBodySpec.numEl;
-          p_byte_width = (uint8_t*) &(dciTxConfigDlGrantBodySpec.byteWidth);
-          break;
-        }
-        default:
-        {
-          break;
-        }
-      }
-      break;
-
-    }
-
-    case (PHY_DL_TX_PAYLOAD_REQ):
-    {
-
-      switch ( subMsgType )
-      {
-        case (DLSCH_MAC_PDU):
-        {
-          num_el       = dlschMacPduTxBodySpec.numEl;
-          p_byte_width = (uint8_t*) &(dlschMacPduTxBodySpec.byteWidth);
-          break;
-        }
-        default:
-        {
-          break;
-        }
-      }
-      break;
-
-    }
-
-    case (PHY_UL_TX_PAYLOAD_REQ):
-    {
-
-      switch ( subMsgType )
-      {
-        case (ULSCH_MAC_PDU):
-        {
-          num_el       = ulschMacPduTxBodySpec.numEl;
-          p_byte_width = (uint8_t*) &(ulschMacPduTxBodySpec.byteWidth);
-          break;
-        }
-        default:
-        {
-          break;
-        }
-      }
-      break;
-
-    }
-
-    default:
-    {
-      break;
-    }
-
-  }
-
-  // Serialize parameter set header
-  SerializeStruct(
-    (uint32_t*) p_parSetHdr,
-    parSetHdrSpec.numEl,
-    (uint8_t*) &(parSetHdrSpec.byteWidth),
-    p_buffer,
-    p_bufferOffset
-  );
-
-  // Serialize parameter set body
-  SerializeStruct(
-    (uint32_t*) p_msgBody,
-    num_el,
-    p_byte_width,
-    p_buffer,
-    p_bufferOffset
-  );
-
-  // Serialize payload separately
-  if ( ( msgType == PHY_DL_TX_PAYLOAD_REQ ) and ( subMsgType == DLSCH_MAC_PDU ) )
-  {
-    SerializePayload(
-      (*(DlschMacPduTxBody*)p_msgBody).macPdu,
-      (*(DlschMacPduTxBody*)p_msgBody).macPduSize,
-      p_buffer,
-      p_bufferOffset
-    );
-  }
-
-  if ( ( msgType == PHY_UL_TX_PAYLOAD_REQ ) and ( subMsgType == ULSCH_MAC_PDU ) )
-  {
-    SerializePayload(
-      (*(UlschMacPduTxBody*)p_msgBody).macPdu,
-      (*(UlschMacPduTxBody*)p_msgBody).macPduSize,
-      p_buffer,
-      p_bufferOffset
-    );
-  }
+  PhyTxPayloadReqHdrCodec::Serialize ((uint32_t*) p_phyUlTxPayloadReq, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += PhyTxPayloadReqHdrCodec::size;
+  memcpy (p_buffer + (*p_bufferOffset), p_phyUlTxPayloadReq->ulschMacPduTxBody.macPdu, p_phyUlTxPayloadReq->ulschMacPduTxBody.macPduSize);
+  (*p_bufferOffset) += p_phyUlTxPayloadReq->ulschMacPduTxBody.macPduSize;
 
   return 0;
 }
@@ -233,158 +91,40 @@ static int32_t SerializeParameterSet(
 
 
 
+//======================================================================================
+// Serialize only the headers of a DL/UL TX payload request, the MAC PDU itself is
+// transmitted directly from the caller buffer (see NiPipeTransport)
+int32_t SerializePhyTxPayloadReqHdr(
+  PhyTxPayloadReqHdr* p_phyTxPayloadReqHdr,
+  uint8_t*            p_buffer,
+  uint32_t*           p_bufferOffset
+)
+//======================================================================================
+{
+
+  PhyTxPayloadReqHdrCodec::Serialize ((uint32_t*) p_phyTxPayloadReqHdr, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += PhyTxPayloadReqHdrCodec::size;
+
+  return 0;
+}
+//======================================================================================
+//======================================================================================
+
+
 
 //======================================================================================
-static int32_t DeserializeParameterSet(
-  uint32_t   msgType,
-  uint32_t   subMsgType,
-  ParSetHdr* p_parSetHdr,
-  uint32_t*  p_msgBody,      // Note: Type is uint32_t* in order to support generic parameter sets
-  uint8_t*   p_buffer,
-  uint32_t*  p_bufferOffset
+// Serializes only the DLSCH config and DCI DL grant parameter sets, i.e. the part
+// appended for each further PDU of a multi PDU PHY_DL_TX_CONFIG_REQ
+int32_t SerializePhyDlTxConfigReqParSets(
+  PhyDlTxConfigReq* p_phyDlTxConfigReq,
+  uint8_t*          p_buffer,
+  uint32_t*         p_bufferOffset
 )
 //======================================================================================
 {
 
-  // Depending on the message body, select the right specification of its elements.
-  uint8_t  num_el;
-  uint8_t* p_byte_width;
-
-  switch ( msgType )
-  {
-
-    case (PHY_DLSCH_RX_IND):
-    {
-
-      switch ( subMsgType )
-      {
-        case (DLSCH_MAC_PDU):
-        {
-          num_el       = dlschMacPduRxBodySpec.numEl;
-          p_byte_width = (uint8_t*) &(dlschMacPduRxBodySpec.byteWidth);
-          break;
-        }
-        default:
-        {
-          break;
-        }
-      }
-      break;
-    }
-
-    case (PHY_ULSCH_RX_IND):
-    {
-
-      switch ( subMsgType )
-      {
-        case (ULSCH_MAC_PDU):
-        {
-          num_el       = ulschMacPduRxBodySpec.numEl;
-          p_byte_width = (uint8_t*) &(ulschMacPduRxBodySpec.byteWidth);
-          break;
-        }
-        default:
-        {
-          break;
-        }
-      }
-      break;
-    }
-
-    case (PHY_CELL_MEASUREMENT_IND):
-    {
-      switch ( subMsgType )
-      {
-        case (CELL_MEASUREMENT_REPORT):
-        {
-          num_el       = cellMeasReportBodySpec.numEl;
-          p_byte_width = (uint8_t*) &(cellMeasReportBodySpec.byteWidth);
-          break;
-        }
-        default:
-        {
-          break;
-        }
-      }
-      break;
-    }
-
-    case (PHY_CNF):
-    {
-
-      switch ( subMsgType )
-      {
-        case (0):
-        {
-          num_el       = cnfBodySpec.numEl;
-          p_byte_width = (uint8_t*) &(cnfBodySpec.byteWidth);
-          break;
-        }
-        default:
-        {
-          break;
-        }
-      }
-      break;
-
-    }
-
-    default:
-    {
-      break;
-    }
-
-  }
-
-  // Serialize parameter set header
-  DeserializeStruct(
-    (uint32_t*) p_parSetHdr,
-    parSetHdrSpec.numEl,
-    (uint8_t*) &(parSetHdrSpec.byteWidth),
-    p_buffer,
-    p_bufferOffset
-  );
-
-  // Serialize parameter set body
-  DeserializeStruct(
-    (uint32_t*) p_msgBody,
-    num_el,
-    p_byte_width,
-    p_buffer,
-    p_bufferOffset
-  );
-
-  // Serialize payload separately
-  if ( ( msgType == PHY_DLSCH_RX_IND ) and ( subMsgType == DLSCH_MAC_PDU ) )
-  {
-    DeserializePayload(
-      ((DlschMacPduRxBody*)p_msgBody)->macPdu,
-      ((DlschMacPduRxBody*)p_msgBody)->macPduSize,
-      p_buffer,
-      p_bufferOffset
-    );
-  }
-
-  if ( ( msgType == PHY_ULSCH_RX_IND ) and ( subMsgType == ULSCH_MAC_PDU ) )
-  {
-    DeserializePayload(
-      ((UlschMacPduRxBody*)p_msgBody)->macPdu,
-      ((UlschMacPduRxBody*)p_msgBody)->macPduSize,
-      p_buffer,
-      p_bufferOffset
-    );
-  }
-
-  if ( ( msgType == PHY_CELL_MEASUREMENT_IND ) and ( subMsgType == CELL_MEASUREMENT_REPORT ) )
-  {
-      // SINR array is of type uint8 -> here we can re-use the de-serialize function for payload
-      DeserializePayload(
-        ((CellMeasReportBody*)p_msgBody)->subbandSinr,
-        ((CellMeasReportBody*)p_msgBody)->numSubbandSinr,
-        p_buffer,
-        p_bufferOffset
-      );
-  }
+  DlTxConfigParSetsCodec::Serialize ((uint32_t*) &p_phyDlTxConfigReq->dlschTxConfigHdr, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += DlTxConfigParSetsCodec::size;
 
   return 0;
 }
@@ -394,21 +134,18 @@ static int32_t DeserializeParameterSet(
 
 
 //======================================================================================
-// Serialize the MAC PDU, i.e., copy it from the payload buffer to the NIAPI message buffer
-static int32_t SerializePayload(
-  uint8_t*  p_payloadBuffer,
-  uint32_t  num_el,
-  uint8_t*  p_buffer,
-  uint32_t* p_bufferOffset
+// Serializes only the MAC PDU parameter set header, i.e. the part preceding each
+// further MAC PDU of a multi PDU PHY_DL_TX_PAYLOAD_REQ
+int32_t SerializePhyTxPayloadReqParSetHdr(
+  PhyTxPayloadReqHdr* p_phyTxPayloadReqHdr,
+  uint8_t*            p_buffer,
+  uint32_t*           p_bufferOffset
 )
 //======================================================================================
 {
 
-  for (uint32_t i = 0; i < num_el; i++ )
-  {
-    p_buffer[(*p_bufferOffset)] = p_payloadBuffer[i];
-    (*p_bufferOffset)++;
-  }
+  MacPduTxParSetHdrCodec::Serialize ((uint32_t*) &p_phyTxPayloadReqHdr->macPduTxHdr, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += MacPduTxParSetHdrCodec::size;
 
   return 0;
 }
@@ -418,21 +155,17 @@ static int32_t SerializePayload(
 
 
 //======================================================================================
-// Deserialize the MAC PDU, i.e., copy it from the NIAPI message buffer to the payload buffer
-static int32_t DeserializePayload(
-  uint8_t*  p_payloadBuffer,
-  uint32_t  num_el,
-  uint8_t*  p_buffer,
-  uint32_t* p_bufferOffset
+// PHY side messages - used by stand-in peers of the L1-L2 API transport
+int32_t SerializePhyTimingInd(
+  PhyTimingInd* p_phyTimingInd,
+  uint8_t*      p_buffer,
+  uint32_t*     p_bufferOffset
 )
 //======================================================================================
 {
 
-  for (uint32_t i = 0; i < num_el; i++ )
-  {
-    p_payloadBuffer[i] = p_buffer[(*p_bufferOffset)];
-    (*p_bufferOffset)++;
-  }
+  PhyTimingIndCodec::Serialize ((uint32_t*) p_phyTimingInd, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += PhyTimingIndCodec::size;
 
   return 0;
 }
@@ -442,38 +175,98 @@ static int32_t DeserializePayload(
 
 
 //======================================================================================
-int32_t SerializePhyDlTxConfigReq(
+int32_t SerializePhyDlschRxInd(
+  PhyDlschRxInd* p_phyDlschRxInd,
+  uint8_t*       p_buffer,
+  uint32_t*      p_bufferOffset
+)
+//======================================================================================
+{
+
+  PhyMacPduRxIndHdrCodec::Serialize ((uint32_t*) p_phyDlschRxInd, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += PhyMacPduRxIndHdrCodec::size;
+  memcpy (p_buffer + (*p_bufferOffset), p_phyDlschRxInd->dlschMacPduRxBody.macPdu, p_phyDlschRxInd->dlschMacPduRxBody.macPduSize);
+  (*p_bufferOffset) += p_phyDlschRxInd->dlschMacPduRxBody.macPduSize;
+
+  return 0;
+}
+//======================================================================================
+//======================================================================================
+
+
+
+//======================================================================================
+int32_t SerializePhyUlschRxInd(
+  PhyUlschRxInd* p_phyUlschRxInd,
+  uint8_t*       p_buffer,
+  uint32_t*      p_bufferOffset
+)
+//======================================================================================
+{
+
+  PhyMacPduRxIndHdrCodec::Serialize ((uint32_t*) p_phyUlschRxInd, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += PhyMacPduRxIndHdrCodec::size;
+  memcpy (p_buffer + (*p_bufferOffset), p_phyUlschRxInd->ulschMacPduRxBody.macPdu, p_phyUlschRxInd->ulschMacPduRxBody.macPduSize);
+  (*p_bufferOffset) += p_phyUlschRxInd->ulschMacPduRxBody.macPduSize;
+
+  return 0;
+}
+//======================================================================================
+//======================================================================================
+
+
+
+//======================================================================================
+int32_t SerializePhyCellMeasurementInd(
+  PhyCellMeasInd* p_phyCellMeasInd,
+  uint8_t*        p_buffer,
+  uint32_t*       p_bufferOffset
+)
+//======================================================================================
+{
+
+  PhyCellMeasIndHdrCodec::Serialize ((uint32_t*) p_phyCellMeasInd, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += PhyCellMeasIndHdrCodec::size;
+  memcpy (p_buffer + (*p_bufferOffset), p_phyCellMeasInd->cellMeasReportBody.subbandSinr, p_phyCellMeasInd->cellMeasReportBody.numSubbandSinr);
+  (*p_bufferOffset) += p_phyCellMeasInd->cellMeasReportBody.numSubbandSinr;
+
+  return 0;
+}
+//======================================================================================
+//======================================================================================
+
+
+
+//======================================================================================
+int32_t SerializePhyCnf(
+  PhyCnf*    p_phyCnf,
+  uint8_t*   p_buffer,
+  uint32_t*  p_bufferOffset
+)
+//======================================================================================
+{
+
+  PhyCnfCodec::Serialize ((uint32_t*) p_phyCnf, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += PhyCnfCodec::size;
+
+  return 0;
+}
+//======================================================================================
+//======================================================================================
+
+
+
+//======================================================================================
+int32_t DeserializePhyDlTxConfigReq(
   PhyDlTxConfigReq* p_phyDlTxConfigReq,
-  uint8_t*  p_buffer,
-  uint32_t* p_bufferOffset
+  uint8_t*          p_buffer,
+  uint32_t*         p_bufferOffset
 )
 //======================================================================================
 {
 
-  SerializeMessageHeader(
-    &(p_phyDlTxConfigReq->genMsgHdr),
-    &(p_phyDlTxConfigReq->subMsgHdr),
-    p_buffer,
-    p_bufferOffset
-  );
-
-  SerializeParameterSet(
-    PHY_DL_TX_CONFIG_REQ,
-    DLSCH_TX_CONFIG,
-    &(p_phyDlTxConfigReq->dlschTxConfigHdr),
-    (uint32_t*) &(p_phyDlTxConfigReq->dlschTxConfigBody),
-    p_buffer,
-    p_bufferOffset
-  );
-
-  SerializeParameterSet(
-    PHY_DL_TX_CONFIG_REQ,
-    DCI_TX_CONFIG_DL_GRANT,
-    &(p_phyDlTxConfigReq->dciTxConfigDlGrantHdr),
-    (uint32_t*) &(p_phyDlTxConfigReq->dciTxConfigDlGrantBody),
-    p_buffer,
-    p_bufferOffset
-  );
+  PhyDlTxConfigReqCodec::Deserialize ((uint32_t*) p_phyDlTxConfigReq, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += PhyDlTxConfigReqCodec::size;
 
   return 0;
 }
@@ -483,29 +276,17 @@ int32_t SerializePhyDlTxConfigReq(
 
 
 //======================================================================================
-int32_t SerializePhyDlTxPayloadReq(
-  PhyDlTxPayloadReq* p_phyDlTxPayloadReq,
-  uint8_t*  p_buffer,
-  uint32_t* p_bufferOffset
+// The MAC PDU is not copied, it starts at p_buffer[*p_bufferOffset] afterwards
+int32_t DeserializePhyTxPayloadReqHdr(
+  PhyTxPayloadReqHdr* p_phyTxPayloadReqHdr,
+  uint8_t*            p_buffer,
+  uint32_t*           p_bufferOffset
 )
 //======================================================================================
 {
 
-    SerializeMessageHeader(
-      &(p_phyDlTxPayloadReq->genMsgHdr),
-      &(p_phyDlTxPayloadReq->subMsgHdr),
-      p_buffer,
-      p_bufferOffset
-    );
-
-    SerializeParameterSet(
-      PHY_DL_TX_PAYLOAD_REQ,
-      DLSCH_MAC_PDU,
-      &(p_phyDlTxPayloadReq->dlschMacPduTxHdr),
-      (uint32_t*) &(p_phyDlTxPayloadReq->dlschMacPduTxBody),
-      p_buffer,
-      p_bufferOffset
-    );
+  PhyTxPayloadReqHdrCodec::Deserialize ((uint32_t*) p_phyTxPayloadReqHdr, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += PhyTxPayloadReqHdrCodec::size;
 
   return 0;
 }
@@ -515,29 +296,36 @@ int32_t SerializePhyDlTxPayloadReq(
 
 
 //======================================================================================
-int32_t SerializePhyUlTxPayloadReq(
-  PhyUlTxPayloadReq* p_phyUlTxPayloadReq,
-  uint8_t*  p_buffer,
-  uint32_t* p_bufferOffset
+int32_t DeserializePhyDlTxConfigReqParSets(
+  PhyDlTxConfigReq* p_phyDlTxConfigReq,
+  uint8_t*          p_buffer,
+  uint32_t*         p_bufferOffset
 )
 //======================================================================================
 {
 
-    SerializeMessageHeader(
-      &(p_phyUlTxPayloadReq->genMsgHdr),
-      &(p_phyUlTxPayloadReq->subMsgHdr),
-      p_buffer,
-      p_bufferOffset
-    );
-
-    SerializeParameterSet(
-      PHY_UL_TX_PAYLOAD_REQ,
-      ULSCH_MAC_PDU,
-      &(p_phyUlTxPayloadReq->ulschMacPduTxHdr),
-      (uint32_t*) &(p_phyUlTxPayloadReq->ulschMacPduTxBody),
-      p_buffer,
-      p_bufferOffset
-    );
+  DlTxConfigParSetsCodec::Deserialize ((uint32_t*) &p_phyDlTxConfigReq->dlschTxConfigHdr, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += DlTxConfigParSetsCodec::size;
+
+  return 0;
+}
+//======================================================================================
+//======================================================================================
+
+
+
+//======================================================================================
+// The MAC PDU is not copied, it starts at p_buffer[*p_bufferOffset] afterwards
+int32_t DeserializePhyTxPayloadReqParSetHdr(
+  PhyTxPayloadReqHdr* p_phyTxPayloadReqHdr,
+  uint8_t*            p_buffer,
+  uint32_t*           p_bufferOffset
+)
+//======================================================================================
+{
+
+  MacPduTxParSetHdrCodec::Deserialize ((uint32_t*) &p_phyTxPayloadReqHdr->macPduTxHdr, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += MacPduTxParSetHdrCodec::size;
 
   return 0;
 }
@@ -555,12 +343,8 @@ int32_t DeserializePhyTimingInd(
 //======================================================================================
 {
 
-  DeserializeMessageHeader(
-    &(p_phyTimingInd->genMsgHdr),
-    &(p_phyTimingInd->subMsgHdr),
-    p_buffer,
-    p_bufferOffset
-  );
+  PhyTimingIndCodec::Deserialize ((uint32_t*) p_phyTimingInd, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += PhyTimingIndCodec::size;
 
   return 0;
 }
@@ -569,7 +353,6 @@ int32_t DeserializePhyTimingInd(
 
 
 
-
 //======================================================================================
 int32_t DeserializePhyDlschRxInd(
   PhyDlschRxInd* p_phyDlschRxInd,
@@ -579,21 +362,10 @@ int32_t DeserializePhyDlschRxInd(
 //======================================================================================
 {
 
-  DeserializeMessageHeader(
-    &(p_phyDlschRxInd->genMsgHdr),
-    &(p_phyDlschRxInd->subMsgHdr),
-    p_buffer,
-    p_bufferOffset
-  );
-
-  DeserializeParameterSet(
-    PHY_DLSCH_RX_IND,
-    DLSCH_MAC_PDU,
-    &(p_phyDlschRxInd->dlschMacPduRxHdr),
-    (uint32_t*) &(p_phyDlschRxInd->dlschMacPduRxBody),
-    p_buffer,
-    p_bufferOffset
-  );
+  PhyMacPduRxIndHdrCodec::Deserialize ((uint32_t*) p_phyDlschRxInd, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += PhyMacPduRxIndHdrCodec::size;
+  memcpy (p_phyDlschRxInd->dlschMacPduRxBody.macPdu, p_buffer + (*p_bufferOffset), p_phyDlschRxInd->dlschMacPduRxBody.macPduSize);
+  (*p_bufferOffset) += p_phyDlschRxInd->dlschMacPduRxBody.macPduSize;
 
   return 0;
 }
@@ -601,30 +373,20 @@ int32_t DeserializePhyDlschRxInd(
 //======================================================================================
 
 
+
 //======================================================================================
 int32_t DeserializePhyCellMeasurementInd(
   PhyCellMeasInd* p_phyCellMeasInd,
-  uint8_t*       p_buffer,
-  uint32_t*      p_bufferOffset
+  uint8_t*        p_buffer,
+  uint32_t*       p_bufferOffset
 )
 //======================================================================================
 {
 
-  DeserializeMessageHeader(
-    &(p_phyCellMeasInd->genMsgHdr),
-    &(p_phyCellMeasInd->subMsgHdr),
-    p_buffer,
-    p_bufferOffset
-  );
-
-  DeserializeParameterSet(
-    PHY_CELL_MEASUREMENT_IND,
-    CELL_MEASUREMENT_REPORT,
-    &(p_phyCellMeasInd->cellMeasReportHdr),
-    (uint32_t*) &(p_phyCellMeasInd->cellMeasReportBody),
-    p_buffer,
-    p_bufferOffset
-  );
+  PhyCellMeasIndHdrCodec::Deserialize ((uint32_t*) p_phyCellMeasInd, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += PhyCellMeasIndHdrCodec::size;
+  memcpy (p_phyCellMeasInd->cellMeasReportBody.subbandSinr, p_buffer + (*p_bufferOffset), p_phyCellMeasInd->cellMeasReportBody.numSubbandSinr);
+  (*p_bufferOffset) += p_phyCellMeasInd->cellMeasReportBody.numSubbandSinr;
 
   return 0;
 }
@@ -632,6 +394,7 @@ int32_t DeserializePhyCellMeasurementInd(
 //======================================================================================
 
 
+
 //======================================================================================
 int32_t DeserializePhyUlschRxInd(
   PhyUlschRxInd* p_phyUlschRxInd,
@@ -641,21 +404,10 @@ int32_t DeserializePhyUlschRxInd(
 //======================================================================================
 {
 
-  DeserializeMessageHeader(
-    &(p_phyUlschRxInd->genMsgHdr),
-    &(p_phyUlschRxInd->subMsgHdr),
-    p_buffer,
-    p_bufferOffset
-  );
-
-  DeserializeParameterSet(
-    PHY_ULSCH_RX_IND,
-    ULSCH_MAC_PDU,
-    &(p_phyUlschRxInd->ulschMacPduRxHdr),
-    (uint32_t*) &(p_phyUlschRxInd->ulschMacPduRxBody),
-    p_buffer,
-    p_bufferOffset
-  );
+  PhyMacPduRxIndHdrCodec::Deserialize ((uint32_t*) p_phyUlschRxInd, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += PhyMacPduRxIndHdrCodec::size;
+  memcpy (p_phyUlschRxInd->ulschMacPduRxBody.macPdu, p_buffer + (*p_bufferOffset), p_phyUlschRxInd->ulschMacPduRxBody.macPduSize);
+  (*p_bufferOffset) += p_phyUlschRxInd->ulschMacPduRxBody.macPduSize;
 
   return 0;
 }
@@ -666,28 +418,15 @@ int32_t DeserializePhyUlschRxInd(
 
 //======================================================================================
 int32_t DeserializePhyCnf(
-  PhyCnf*   p_phyCnf,
-  uint8_t*  p_buffer,
-  uint32_t* p_bufferOffset
+  PhyCnf*    p_phyCnf,
+  uint8_t*   p_buffer,
+  uint32_t*  p_bufferOffset
 )
 //======================================================================================
 {
 
-  DeserializeMessageHeader(
-    &(p_phyCnf->genMsgHdr),
-    &(p_phyCnf->subMsgHdr),
-    p_buffer,
-    p_bufferOffset
-  );
-
-  DeserializeParameterSet(
-    PHY_CNF,
-    0,
-    &(p_phyCnf->cnfHdr),
-    (uint32_t*) &(p_phyCnf->cnfBody),
-    p_buffer,
-    p_bufferOffset
-  );
+  PhyCnfCodec::Deserialize ((uint32_t*) p_phyCnf, p_buffer + (*p_bufferOffset));
+  (*p_bufferOffset) += PhyCnfCodec::size;
 
   return 0;
 }
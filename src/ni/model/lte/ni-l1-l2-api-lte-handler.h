@@ -27,68 +27,91 @@
 namespace ns3 {
 //--------------------------------------------------------------------------------------
 
-// these low-level functions are not available outside of this module, hence static
+// Add serialization/deserialization fucntions for each NIAPI message as needed
 
-static int32_t SerializeMessageHeader(
-  GenMsgHdr* p_genMsgHdr,
-  LteSubMsgHdr* p_subMsgHdr,
-  uint8_t*   p_buffer,
-  uint32_t*  p_bufferOffset
+int32_t SerializePhyDlTxConfigReq(
+  PhyDlTxConfigReq* p_phyDlTxConfigReq,
+  uint8_t*          p_buffer,
+  uint32_t*         p_bufferOffset
 );
 
-static int32_t DeserializeMessageHeader(
-  GenMsgHdr* p_genMsgHdr,
-  LteSubMsgHdr* p_subMsgHdr,
-  uint8_t*   p_buffer,
-  uint32_t*  p_bufferOffset
+int32_t SerializePhyDlTxPayloadReq(
+  PhyDlTxPayloadReq* p_phyDlTxPayloadReq,
+  uint8_t*           p_buffer,
+  uint32_t*          p_bufferOffset
 );
 
-static int32_t SerializeParameterSet(
-  uint32_t  msgType,
-  uint32_t  subMsgType,
-  ParSetHdr* p_parSetHdr,
-  uint32_t* p_msgBody,      // Note: Type is uint32_t* in order to support generic parameter sets
-  uint8_t*  p_buffer,
-  uint32_t* p_bufferOffset
+int32_t SerializePhyTxPayloadReqHdr(
+  PhyTxPayloadReqHdr* p_phyTxPayloadReqHdr,
+  uint8_t*            p_buffer,
+  uint32_t*           p_bufferOffset
 );
 
-static int32_t DeserializeParameterSet(
-  uint32_t  msgType,
-  uint32_t  subMsgType,
-  ParSetHdr* p_parSetHdr,
-  uint32_t* p_msgBody,      // Note: Type is uint32_t* in order to support generic parameter sets
-  uint8_t*  p_buffer,
-  uint32_t* p_bufferOffset
+// parameter sets of further PDUs appended to a multi PDU request
+int32_t SerializePhyDlTxConfigReqParSets(
+  PhyDlTxConfigReq* p_phyDlTxConfigReq,
+  uint8_t*          p_buffer,
+  uint32_t*         p_bufferOffset
 );
 
-static int32_t SerializePayload(
-  uint8_t*  p_payloadBuffer,
-  uint32_t  num_el,
-  uint8_t*  p_buffer,
-  uint32_t* p_bufferOffset
+int32_t SerializePhyTxPayloadReqParSetHdr(
+  PhyTxPayloadReqHdr* p_phyTxPayloadReqHdr,
+  uint8_t*            p_buffer,
+  uint32_t*           p_bufferOffset
 );
 
-static int32_t DeserializePayload(
-  uint8_t*  p_payloadBuffer,
-  uint32_t  num_el,
+int32_t SerializePhyTimingInd(
+  PhyTimingInd* p_phyTimingInd,
+  uint8_t*      p_buffer,
+  uint32_t*     p_bufferOffset
+);
+
+int32_t SerializePhyDlschRxInd(
+  PhyDlschRxInd* p_phyDlschRxInd,
+  uint8_t*       p_buffer,
+  uint32_t*      p_bufferOffset
+);
+
+int32_t SerializePhyUlschRxInd(
+  PhyUlschRxInd* p_phyUlschRxInd,
+  uint8_t*       p_buffer,
+  uint32_t*      p_bufferOffset
+);
+
+int32_t SerializePhyCellMeasurementInd(
+  PhyCellMeasInd* p_phyCellMeasInd,
+  uint8_t*        p_buffer,
+  uint32_t*       p_bufferOffset
+);
+
+int32_t SerializePhyCnf(
+  PhyCnf*   p_phyCnf,
   uint8_t*  p_buffer,
   uint32_t* p_bufferOffset
 );
 
-//--------------------------------------------------------------------------------------
+int32_t DeserializePhyDlTxConfigReq(
+  PhyDlTxConfigReq* p_phyDlTxConfigReq,
+  uint8_t*          p_buffer,
+  uint32_t*         p_bufferOffset
+);
 
-// Add serialization/deserialization fucntions for each NIAPI message as needed
+int32_t DeserializePhyTxPayloadReqHdr(
+  PhyTxPayloadReqHdr* p_phyTxPayloadReqHdr,
+  uint8_t*            p_buffer,
+  uint32_t*           p_bufferOffset
+);
 
-int32_t SerializePhyDlTxConfigReq(
+int32_t DeserializePhyDlTxConfigReqParSets(
   PhyDlTxConfigReq* p_phyDlTxConfigReq,
   uint8_t*          p_buffer,
   uint32_t*         p_bufferOffset
 );
 
-int32_t SerializePhyDlTxPayloadReq(
-  PhyDlTxPayloadReq* p_phyDlTxPayloadReq,
-  uint8_t*           p_buffer,
-  uint32_t*          p_bufferOffset
+int32_t DeserializePhyTxPayloadReqParSetHdr(
+  PhyTxPayloadReqHdr* p_phyTxPayloadReqHdr,
+  uint8_t*            p_buffer,
+  uint32_t*           p_bufferOffset
 );
 
 int32_t DeserializePhyTimingInd(
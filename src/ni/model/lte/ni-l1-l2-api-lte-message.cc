@@ -684,6 +684,170 @@ int32_t InitializePhyUlTxPayloadReq( PhyUlTxPayloadReq* p_phyUlTxPayloadReq )
 
   return 0;
 }
+
+//=============================================================================================================================
+// Initialize header of PHY_DL_TX_PAYLOAD_REQ or PHY_UL_TX_PAYLOAD_REQ with default values.
+int32_t InitializePhyTxPayloadReqHdr( PhyTxPayloadReqHdr* p_phyTxPayloadReqHdr, uint32_t msgType )
+//=============================================================================================================================
+{
+
+  (*p_phyTxPayloadReqHdr).genMsgHdr.msgType    = msgType; // PHY_DL_TX_PAYLOAD_REQ or PHY_UL_TX_PAYLOAD_REQ
+  (*p_phyTxPayloadReqHdr).genMsgHdr.refId      = 0;  // update in loop
+  (*p_phyTxPayloadReqHdr).genMsgHdr.instId     = 0;  // unused
+  (*p_phyTxPayloadReqHdr).genMsgHdr.bodyLength = 17; // =17+tbs, update in loop, value in bytes, excl. genMsgHdr
+
+  (*p_phyTxPayloadReqHdr).subMsgHdr.sfn        = 0;  // update in loop
+  (*p_phyTxPayloadReqHdr).subMsgHdr.tti        = 0;  // update in loop
+  (*p_phyTxPayloadReqHdr).subMsgHdr.numSubMsg  = 1;
+  (*p_phyTxPayloadReqHdr).subMsgHdr.cnfMode    = 0;  // 0 = no confirmation
+  (*p_phyTxPayloadReqHdr).subMsgHdr.resField   = 0;
+
+  (*p_phyTxPayloadReqHdr).macPduTxHdr.subMsgType       = DLSCH_MAC_PDU; // same value as ULSCH_MAC_PDU
+  (*p_phyTxPayloadReqHdr).macPduTxHdr.parSetId         = 0;
+  (*p_phyTxPayloadReqHdr).macPduTxHdr.parSetBodyLength = 4;  // =4+tbs, update in loop
+
+  (*p_phyTxPayloadReqHdr).macPduTxBodyHdr.macPduIndex  = 0;  // currently sending only one PDU per TTI
+  (*p_phyTxPayloadReqHdr).macPduTxBodyHdr.macPduSize   = 0;  // =tbs, update in loop
+
+  return 0;
+}
+
+//=============================================================================================================================
+// Initialize PHY_TIMING_IND with default values.
+int32_t InitializePhyTimingInd( PhyTimingInd* p_phyTimingInd )
+//=============================================================================================================================
+{
+
+  (*p_phyTimingInd).genMsgHdr.msgType    = PHY_TIMING_IND;
+  (*p_phyTimingInd).genMsgHdr.refId      = 0;  // update in loop
+  (*p_phyTimingInd).genMsgHdr.instId     = 0;  // unused
+  (*p_phyTimingInd).genMsgHdr.bodyLength = 8;  // value in bytes, excl. genMsgHdr
+
+  (*p_phyTimingInd).subMsgHdr.sfn        = 0;  // update in loop
+  (*p_phyTimingInd).subMsgHdr.tti        = 0;  // update in loop
+  (*p_phyTimingInd).subMsgHdr.numSubMsg  = 0;
+  (*p_phyTimingInd).subMsgHdr.cnfMode    = 0;
+  (*p_phyTimingInd).subMsgHdr.resField   = 0;
+
+  return 0;
+}
+
+//=============================================================================================================================
+// Initialize PHY_DLSCH_RX_IND with default values.
+int32_t InitializePhyDlschRxInd( PhyDlschRxInd* p_phyDlschRxInd )
+//=============================================================================================================================
+{
+
+  (*p_phyDlschRxInd).genMsgHdr.msgType    = PHY_DLSCH_RX_IND;
+  (*p_phyDlschRxInd).genMsgHdr.refId      = 0;  // update in loop
+  (*p_phyDlschRxInd).genMsgHdr.instId     = 0;  // unused
+  (*p_phyDlschRxInd).genMsgHdr.bodyLength = 19; // =19+tbs, update in loop, value in bytes, excl. genMsgHdr
+
+  (*p_phyDlschRxInd).subMsgHdr.sfn        = 0;  // update in loop
+  (*p_phyDlschRxInd).subMsgHdr.tti        = 0;  // update in loop
+  (*p_phyDlschRxInd).subMsgHdr.numSubMsg  = 1;
+  (*p_phyDlschRxInd).subMsgHdr.cnfMode    = 0;
+  (*p_phyDlschRxInd).subMsgHdr.resField   = 0;
+
+  (*p_phyDlschRxInd).dlschMacPduRxHdr.subMsgType       = DLSCH_MAC_PDU;
+  (*p_phyDlschRxInd).dlschMacPduRxHdr.parSetId         = 0;
+  (*p_phyDlschRxInd).dlschMacPduRxHdr.parSetBodyLength = 6;  // =6+tbs, update in loop
+
+  (*p_phyDlschRxInd).dlschMacPduRxBody.rnti       = 0;
+  (*p_phyDlschRxInd).dlschMacPduRxBody.crcResult  = 1;  // 1 = CRC ok
+  (*p_phyDlschRxInd).dlschMacPduRxBody.macPduSize = 0;  // =tbs, update in loop
+
+  memset((*p_phyDlschRxInd).dlschMacPduRxBody.macPdu, 0, MAX_MAC_PDU_SIZE);
+
+  return 0;
+}
+
+//=============================================================================================================================
+// Initialize PHY_ULSCH_RX_IND with default values.
+int32_t InitializePhyUlschRxInd( PhyUlschRxInd* p_phyUlschRxInd )
+//=============================================================================================================================
+{
+
+  (*p_phyUlschRxInd).genMsgHdr.msgType    = PHY_ULSCH_RX_IND;
+  (*p_phyUlschRxInd).genMsgHdr.refId      = 0;  // update in loop
+  (*p_phyUlschRxInd).genMsgHdr.instId     = 0;  // unused
+  (*p_phyUlschRxInd).genMsgHdr.bodyLength = 19; // =19+tbs, update in loop, value in bytes, excl. genMsgHdr
+
+  (*p_phyUlschRxInd).subMsgHdr.sfn        = 0;  // update in loop
+  (*p_phyUlschRxInd).subMsgHdr.tti        = 0;  // update in loop
+  (*p_phyUlschRxInd).subMsgHdr.numSubMsg  = 1;
+  (*p_phyUlschRxInd).subMsgHdr.cnfMode    = 0;
+  (*p_phyUlschRxInd).subMsgHdr.resField   = 0;
+
+  (*p_phyUlschRxInd).ulschMacPduRxHdr.subMsgType       = ULSCH_MAC_PDU;
+  (*p_phyUlschRxInd).ulschMacPduRxHdr.parSetId         = 0;
+  (*p_phyUlschRxInd).ulschMacPduRxHdr.parSetBodyLength = 6;  // =6+tbs, update in loop
+
+  (*p_phyUlschRxInd).ulschMacPduRxBody.rnti       = 0;
+  (*p_phyUlschRxInd).ulschMacPduRxBody.crcResult  = 1;  // 1 = CRC ok
+  (*p_phyUlschRxInd).ulschMacPduRxBody.macPduSize = 0;  // =tbs, update in loop
+
+  memset((*p_phyUlschRxInd).ulschMacPduRxBody.macPdu, 0, MAX_MAC_PDU_SIZE);
+
+  return 0;
+}
+
+//=============================================================================================================================
+// Initialize PHY_CELL_MEASUREMENT_IND with default values.
+int32_t InitializePhyCellMeasInd( PhyCellMeasInd* p_phyCellMeasInd )
+//=============================================================================================================================
+{
+
+  (*p_phyCellMeasInd).genMsgHdr.msgType    = PHY_CELL_MEASUREMENT_IND;
+  (*p_phyCellMeasInd).genMsgHdr.refId      = 0;  // update in loop
+  (*p_phyCellMeasInd).genMsgHdr.instId     = 0;  // unused
+  (*p_phyCellMeasInd).genMsgHdr.bodyLength = 17; // =17+numSubbandSinr, update in loop, value in bytes, excl. genMsgHdr
+
+  (*p_phyCellMeasInd).subMsgHdr.sfn        = 0;  // update in loop
+  (*p_phyCellMeasInd).subMsgHdr.tti        = 0;  // update in loop
+  (*p_phyCellMeasInd).subMsgHdr.numSubMsg  = 1;
+  (*p_phyCellMeasInd).subMsgHdr.cnfMode    = 0;
+  (*p_phyCellMeasInd).subMsgHdr.resField   = 0;
+
+  (*p_phyCellMeasInd).cellMeasReportHdr.subMsgType       = CELL_MEASUREMENT_REPORT;
+  (*p_phyCellMeasInd).cellMeasReportHdr.parSetId         = 0;
+  (*p_phyCellMeasInd).cellMeasReportHdr.parSetBodyLength = 4;  // =4+numSubbandSinr, update in loop
+
+  (*p_phyCellMeasInd).cellMeasReportBody.cellId         = 0;
+  (*p_phyCellMeasInd).cellMeasReportBody.widebandSinr   = 0;  // fixed point I8.6.2 in dB
+  (*p_phyCellMeasInd).cellMeasReportBody.numSubbandSinr = 0;
+
+  memset((*p_phyCellMeasInd).cellMeasReportBody.subbandSinr, 0, MAX_NUM_SUBBAND_SINR);
+
+  return 0;
+}
+
+//=============================================================================================================================
+// Initialize PHY_CNF with default values.
+int32_t InitializePhyCnf( PhyCnf* p_phyCnf )
+//=============================================================================================================================
+{
+
+  (*p_phyCnf).genMsgHdr.msgType    = PHY_CNF;
+  (*p_phyCnf).genMsgHdr.refId      = 0;  // update in loop
+  (*p_phyCnf).genMsgHdr.instId     = 0;  // unused
+  (*p_phyCnf).genMsgHdr.bodyLength = 16; // value in bytes, excl. genMsgHdr
+
+  (*p_phyCnf).subMsgHdr.sfn        = 0;  // update in loop
+  (*p_phyCnf).subMsgHdr.tti        = 0;  // update in loop
+  (*p_phyCnf).subMsgHdr.numSubMsg  = 1;
+  (*p_phyCnf).subMsgHdr.cnfMode    = 0;
+  (*p_phyCnf).subMsgHdr.resField   = 0;
+
+  (*p_phyCnf).cnfHdr.subMsgType       = 0;
+  (*p_phyCnf).cnfHdr.parSetId         = 0;
+  (*p_phyCnf).cnfHdr.parSetBodyLength = 3;
+
+  (*p_phyCnf).cnfBody.cnfStatus  = CNF_SUCCESS;
+  (*p_phyCnf).cnfBody.srcMsgType = 0;  // update in loop
+
+  return 0;
+}
 //=============================================================================================================================
 //=============================================================================================================================
 } //namespace ns3
@@ -54,6 +54,12 @@ namespace ns3 {
   int32_t InitializePhyDlTxConfigReq( PhyDlTxConfigReq* p_phyDlTxConfigReq );
   int32_t InitializePhyDlTxPayloadReq( PhyDlTxPayloadReq* p_phyDlTxPayloadReq );
   int32_t InitializePhyUlTxPayloadReq( PhyUlTxPayloadReq* p_phyUlTxPayloadReq );
+  int32_t InitializePhyTxPayloadReqHdr( PhyTxPayloadReqHdr* p_phyTxPayloadReqHdr, uint32_t msgType );
+  int32_t InitializePhyTimingInd( PhyTimingInd* p_phyTimingInd );
+  int32_t InitializePhyDlschRxInd( PhyDlschRxInd* p_phyDlschRxInd );
+  int32_t InitializePhyUlschRxInd( PhyUlschRxInd* p_phyUlschRxInd );
+  int32_t InitializePhyCellMeasInd( PhyCellMeasInd* p_phyCellMeasInd );
+  int32_t InitializePhyCnf( PhyCnf* p_phyCnf );
 
 //=============================================================================================================================
 //=============================================================================================================================
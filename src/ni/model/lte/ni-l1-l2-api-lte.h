@@ -83,6 +83,7 @@ namespace ns3 {
 // magic numbers
 #define MAX_MAC_PDU_SIZE              9422    // tbs=9422 for prb=110 and mcs=28
 #define MAX_NUM_SUBBAND_SINR          13
+#define MAX_NUM_DLSCH_PDUS            16      // DLSCH config/payload parameter set pairs per TTI
 
 //======================================================================================
 // NIAPI message headers
@@ -232,6 +233,23 @@ static const LteElementsSpec ulschMacPduTxBodySpec = {
 
 
 
+//--------------------------------------------------------------------------------------
+// PHY_DL_TX_PAYLOAD_REQ / PHY_UL_TX_PAYLOAD_REQ --> MAC_PDU_TX without MAC PDU -- 4 bytes
+//--------------------------------------------------------------------------------------
+
+// used for scatter-gather transmission where the MAC PDU is not copied into the message
+typedef struct sMacPduTxBodyHdr {
+  uint32_t macPduIndex;
+  uint32_t macPduSize;
+} MacPduTxBodyHdr;
+
+static const LteElementsSpec macPduTxBodyHdrSpec = {
+  .numEl    = 2,
+  .byteWidth = {1, 3},
+};
+
+
+
 //--------------------------------------------------------------------------------------
 // PHY_DLSCH_RX_IND --> DLSCH_MAC_PDU_RX -- (6+tbs) bytes
 //--------------------------------------------------------------------------------------
@@ -322,6 +340,20 @@ typedef struct sPhyUlTxPayloadReq {
   UlschMacPduTxBody ulschMacPduTxBody;
 } PhyUlTxPayloadReq;
 
+// header part of PHY_DL_TX_PAYLOAD_REQ / PHY_UL_TX_PAYLOAD_REQ -- 25 bytes, MAC PDU follows
+typedef struct sPhyTxPayloadReqHdr {
+  GenMsgHdr         genMsgHdr;
+  LteSubMsgHdr      subMsgHdr;
+  ParSetHdr         macPduTxHdr;
+  MacPduTxBodyHdr   macPduTxBodyHdr;
+} PhyTxPayloadReqHdr;
+
+#define PHY_TX_PAYLOAD_REQ_HDR_SIZE   25      // genMsgHdr (8) + subMsgHdr (8) + parSetHdr (5) + body (4)
+
+// parameter sets of each further PDU of a multi PDU PHY_DL_TX_CONFIG_REQ / PHY_DL_TX_PAYLOAD_REQ
+#define PHY_DL_TX_CONFIG_PAR_SETS_SIZE  27    // DLSCH config (5+8) + DCI DL grant (5+9)
+#define PHY_TX_PAYLOAD_PAR_SET_HDR_SIZE 9     // parSetHdr (5) + body (4) without MAC PDU
+
 typedef struct sPhyDlschRxInd {
   GenMsgHdr         genMsgHdr;
   LteSubMsgHdr      subMsgHdr;
@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#include <iomanip>
+
+#include "ni-lte-deadline-monitor.h"
+#include "../common/ni-logging.h"
+
+namespace ns3 {
+
+  NiLteDeadlineMonitor::NiLteDeadlineMonitor ()
+  : m_level (NI_DEADLINE_LEVEL_NORMAL),
+    m_lastSlackUs (0),
+    m_missRate (0.0),
+    m_tightRate (0.0),
+    m_numSubframes (0),
+    m_numMisses (0),
+    m_numLevelChanges (0),
+    m_subframesSinceChange (0)
+  {
+    for (uint32_t l = 0; l < NI_DEADLINE_NUM_LEVELS; l++)
+      {
+        m_numSubframesAtLevel[l] = 0;
+      }
+  }
+
+  void
+  NiLteDeadlineMonitor::Configure (const NiDeadlineMonitorConfig& config)
+  {
+    m_config = config;
+    if (m_config.maxLevel >= NI_DEADLINE_NUM_LEVELS)
+      {
+        m_config.maxLevel = NI_DEADLINE_NUM_LEVELS - 1;
+      }
+    if (m_level > (enum NiDeadlineLevel) m_config.maxLevel)
+      {
+        m_level = (enum NiDeadlineLevel) m_config.maxLevel;
+      }
+  }
+
+  const NiDeadlineMonitorConfig&
+  NiLteDeadlineMonitor::GetConfig (void) const
+  {
+    return m_config;
+  }
+
+  bool
+  NiLteDeadlineMonitor::RecordSubframe (uint64_t usedUs)
+  {
+    const double alpha = 1.0 / NI_DEADLINE__RATE_WINDOW;
+    m_lastSlackUs = (int64_t) m_config.budgetUs - (int64_t) usedUs;
+    const bool miss = (m_lastSlackUs < 0);
+    const bool tight = (m_lastSlackUs < (int64_t) m_config.marginUs);
+
+    m_missRate += alpha * ((miss ? 1.0 : 0.0) - m_missRate);
+    m_tightRate += alpha * ((tight ? 1.0 : 0.0) - m_tightRate);
+    if (miss) m_numMisses++;
+    m_numSubframes++;
+    m_numSubframesAtLevel[m_level]++;
+    m_subframesSinceChange++;
+
+    if (m_subframesSinceChange < m_config.holdSubframes)
+      {
+        return false;
+      }
+    if ((m_tightRate >= m_config.degradeRate) && (m_level < (enum NiDeadlineLevel) m_config.maxLevel))
+      {
+        m_level = (enum NiDeadlineLevel) (m_level + 1);
+      }
+    else if ((m_tightRate <= m_config.recoverRate) && (m_level > NI_DEADLINE_LEVEL_NORMAL))
+      {
+        m_level = (enum NiDeadlineLevel) (m_level - 1);
+      }
+    else
+      {
+        return false;
+      }
+    m_subframesSinceChange = 0;
+    m_numLevelChanges++;
+    return true;
+  }
+
+  uint64_t
+  NiLteDeadlineMonitor::GetNumSubframesAtLevel (enum NiDeadlineLevel level) const
+  {
+    return (level < NI_DEADLINE_NUM_LEVELS) ? m_numSubframesAtLevel[level] : 0;
+  }
+
+  void
+  NiLteDeadlineMonitor::Print (void) const
+  {
+    NI_LOG_CONSOLE_INFO("Deadline misses    = " << m_numMisses << " of " << m_numSubframes << " subframes (budget " <<
+                        m_config.budgetUs << " us, margin " << m_config.marginUs << " us)");
+    NI_LOG_CONSOLE_INFO("Deadline level     = " << GetLevelName (m_level) << ", " << m_numLevelChanges << " changes, rates: miss " <<
+                        std::fixed << std::setprecision (3) << m_missRate << ", tight " << m_tightRate << std::defaultfloat);
+    for (uint32_t l = 0; l < NI_DEADLINE_NUM_LEVELS; l++)
+      {
+        if (m_numSubframesAtLevel[l] > 0)
+          {
+            NI_LOG_CONSOLE_INFO("  " << std::left << std::setw (17) << GetLevelName ((enum NiDeadlineLevel) l) << std::right <<
+                                "= " << m_numSubframesAtLevel[l] << " subframes");
+          }
+      }
+  }
+
+  const char*
+  NiLteDeadlineMonitor::GetLevelName (enum NiDeadlineLevel level)
+  {
+    switch (level)
+      {
+      case NI_DEADLINE_LEVEL_NORMAL:       return "Normal";
+      case NI_DEADLINE_LEVEL_NO_DEBUG_LOG: return "NoDebugLog";
+      case NI_DEADLINE_LEVEL_NO_CQI:       return "NoCqi";
+      case NI_DEADLINE_LEVEL_DEFER_RC:     return "DeferRc";
+      case NI_DEADLINE_LEVEL_CAP_PDUS:     return "CapPdus";
+      default:                             return "Unknown";
+      }
+  }
+
+} // namespace ns3
@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#ifndef NI_LTE_DEADLINE_MONITOR_H_
+#define NI_LTE_DEADLINE_MONITOR_H_
+
+#include <cstdint>
+
+namespace ns3 {
+
+  // degradation levels, each level includes the measures of the levels below
+  enum NiDeadlineLevel
+  {
+    NI_DEADLINE_LEVEL_NORMAL = 0,   // no degradation
+    NI_DEADLINE_LEVEL_NO_DEBUG_LOG, // debug, trace and console debug logging suppressed
+    NI_DEADLINE_LEVEL_NO_CQI,       // generation of CQI reports from the PHY SINR skipped
+    NI_DEADLINE_LEVEL_DEFER_RC,     // remote control parameters only applied every NI_DEADLINE__RC_DEFER_PERIOD subframes
+    NI_DEADLINE_LEVEL_CAP_PDUS,     // number of MAC PDUs serialized per TTI capped
+    NI_DEADLINE_NUM_LEVELS
+  };
+
+  // number of subframes the running rates are averaged over (exponential moving average)
+#define NI_DEADLINE__RATE_WINDOW 64
+  // subframes between remote control updates at NI_DEADLINE_LEVEL_DEFER_RC
+#define NI_DEADLINE__RC_DEFER_PERIOD 100
+
+  struct NiDeadlineMonitorConfig
+  {
+    uint32_t budgetUs = 1000;   // time from the PHY timing indication until the tx requests have to be sent
+    uint32_t marginUs = 200;    // subframes with less slack count as tight
+    uint32_t maxLevel = NI_DEADLINE_LEVEL_CAP_PDUS; // NI_DEADLINE_LEVEL_NORMAL disables the degradation
+    double degradeRate = 0.1;   // rate of tight subframes stepping one level down
+    double recoverRate = 0.02;  // rate of tight subframes stepping one level up again
+    uint32_t holdSubframes = 100; // minimum number of subframes between two level changes
+  };
+
+  // Tracks the slack of each subframe against the deadline budget and steps the
+  // degradation level down while the running rate of tight subframes exceeds
+  // degradeRate, and up again once it fell below recoverRate.
+  class NiLteDeadlineMonitor
+  {
+  public:
+    NiLteDeadlineMonitor ();
+
+    void Configure (const NiDeadlineMonitorConfig& config);
+    const NiDeadlineMonitorConfig& GetConfig (void) const;
+
+    // records the time used by one subframe, returns true if the level changed
+    bool RecordSubframe (uint64_t usedUs);
+
+    enum NiDeadlineLevel GetLevel (void) const { return m_level; }
+    // true if the measures of level are active
+    bool IsActive (enum NiDeadlineLevel level) const { return m_level >= level; }
+
+    int64_t GetLastSlackUs (void) const { return m_lastSlackUs; }
+    double GetMissRate (void) const { return m_missRate; }
+    double GetTightRate (void) const { return m_tightRate; }
+    uint64_t GetNumSubframes (void) const { return m_numSubframes; }
+    uint64_t GetNumMisses (void) const { return m_numMisses; }
+    uint64_t GetNumLevelChanges (void) const { return m_numLevelChanges; }
+    uint64_t GetNumSubframesAtLevel (enum NiDeadlineLevel level) const;
+
+    // prints misses, rates and the subframes spent at each level
+    void Print (void) const;
+    static const char* GetLevelName (enum NiDeadlineLevel level);
+
+  private:
+    NiDeadlineMonitorConfig m_config;
+    enum NiDeadlineLevel m_level;
+    int64_t m_lastSlackUs;
+    double m_missRate;   // running rate of subframes exceeding the budget
+    double m_tightRate;  // running rate of subframes with less than marginUs slack, including misses
+    uint64_t m_numSubframes;
+    uint64_t m_numMisses;
+    uint64_t m_numLevelChanges;
+    uint64_t m_subframesSinceChange;
+    uint64_t m_numSubframesAtLevel[NI_DEADLINE_NUM_LEVELS];
+  };
+
+} // namespace ns3
+
+#endif /* NI_LTE_DEADLINE_MONITOR_H_ */
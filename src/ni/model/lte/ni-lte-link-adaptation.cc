@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#include <algorithm>
+#include <iomanip>
+
+#include "ni-lte-link-adaptation.h"
+#include "../common/ni-logging.h"
+
+namespace ns3 {
+
+  NiLteLinkAdaptation::NiLteLinkAdaptation ()
+  {
+  }
+
+  void
+  NiLteLinkAdaptation::Configure (const NiLinkAdaptationConfig& config)
+  {
+    m_config = config;
+    if ((m_config.sinrAlpha <= 0.0) || (m_config.sinrAlpha > 1.0))
+      {
+        m_config.sinrAlpha = 1.0;
+      }
+    if (m_config.minOffsetDb > m_config.maxOffsetDb)
+      {
+        m_config.minOffsetDb = m_config.maxOffsetDb;
+      }
+  }
+
+  const NiLinkAdaptationConfig&
+  NiLteLinkAdaptation::GetConfig (void) const
+  {
+    return m_config;
+  }
+
+  void
+  NiLteLinkAdaptation::ReportSinr (uint16_t rnti, double widebandSinrDb, const double* subbandSinrDb, uint32_t numSubbands)
+  {
+    if (numSubbands > NI_LINK_ADAPTATION__MAX_SUBBANDS)
+      {
+        numSubbands = NI_LINK_ADAPTATION__MAX_SUBBANDS;
+      }
+    UeState& ue = m_ueStates[rnti];
+    // the first report and a changed subband layout restart the filter
+    const double alpha = (ue.sinrValid && (ue.numSubbands == numSubbands)) ? m_config.sinrAlpha : 1.0;
+
+    ue.widebandSinrDb += alpha * (widebandSinrDb - ue.widebandSinrDb);
+    for (uint32_t i = 0; i < numSubbands; i++)
+      {
+        ue.subbandSinrDb[i] += alpha * (subbandSinrDb[i] - ue.subbandSinrDb[i]);
+      }
+    ue.numSubbands = numSubbands;
+    ue.sinrValid = true;
+    ue.numSinrReports++;
+  }
+
+  void
+  NiLteLinkAdaptation::ReportCrc (uint16_t rnti, bool crcOk)
+  {
+    const double alpha = 1.0 / NI_LINK_ADAPTATION__BLER_WINDOW;
+    UeState& ue = m_ueStates[rnti];
+
+    if (crcOk)
+      {
+        ue.offsetDb += m_config.stepDownDb * m_config.blerTarget / (1.0 - m_config.blerTarget);
+      }
+    else
+      {
+        ue.offsetDb -= m_config.stepDownDb;
+        ue.numCrcErrors++;
+      }
+    ue.offsetDb = std::min (std::max (ue.offsetDb, m_config.minOffsetDb), m_config.maxOffsetDb);
+    ue.bler += alpha * ((crcOk ? 0.0 : 1.0) - ue.bler);
+    ue.numCrc++;
+  }
+
+  bool
+  NiLteLinkAdaptation::GetSinrPerRb (uint16_t rnti, uint32_t numRb, std::vector<double>* sinrDb) const
+  {
+    std::map<uint16_t, UeState>::const_iterator it = m_ueStates.find (rnti);
+    if ((it == m_ueStates.end ()) || !it->second.sinrValid)
+      {
+        return false;
+      }
+    const UeState& ue = it->second;
+
+    sinrDb->resize (numRb);
+    for (uint32_t rb = 0; rb < numRb; rb++)
+      {
+        const double sinr = (ue.numSubbands > 0) ? ue.subbandSinrDb[rb * ue.numSubbands / numRb] : ue.widebandSinrDb;
+        (*sinrDb)[rb] = sinr + ue.offsetDb;
+      }
+    return true;
+  }
+
+  double
+  NiLteLinkAdaptation::GetOffsetDb (uint16_t rnti) const
+  {
+    std::map<uint16_t, UeState>::const_iterator it = m_ueStates.find (rnti);
+    return (it != m_ueStates.end ()) ? it->second.offsetDb : 0.0;
+  }
+
+  double
+  NiLteLinkAdaptation::GetBler (uint16_t rnti) const
+  {
+    std::map<uint16_t, UeState>::const_iterator it = m_ueStates.find (rnti);
+    return (it != m_ueStates.end ()) ? it->second.bler : 0.0;
+  }
+
+  uint64_t
+  NiLteLinkAdaptation::GetNumCrc (uint16_t rnti) const
+  {
+    std::map<uint16_t, UeState>::const_iterator it = m_ueStates.find (rnti);
+    return (it != m_ueStates.end ()) ? it->second.numCrc : 0;
+  }
+
+  uint64_t
+  NiLteLinkAdaptation::GetNumCrcErrors (uint16_t rnti) const
+  {
+    std::map<uint16_t, UeState>::const_iterator it = m_ueStates.find (rnti);
+    return (it != m_ueStates.end ()) ? it->second.numCrcErrors : 0;
+  }
+
+  void
+  NiLteLinkAdaptation::Print (void) const
+  {
+    NI_LOG_CONSOLE_INFO("BLER target        = " << m_config.blerTarget << " (step " << m_config.stepDownDb <<
+                        " dB, offset " << m_config.minOffsetDb << " .. " << m_config.maxOffsetDb << " dB)");
+    for (std::map<uint16_t, UeState>::const_iterator it = m_ueStates.begin (); it != m_ueStates.end (); ++it)
+      {
+        const UeState& ue = it->second;
+        NI_LOG_CONSOLE_INFO("RNTI " << std::left << std::setw (13) << it->first << std::right << "= " <<
+                            std::fixed << std::setprecision (2) <<
+                            "SINR " << ue.widebandSinrDb << " dB (" << ue.numSubbands << " subbands, " << ue.numSinrReports << " reports), " <<
+                            "offset " << ue.offsetDb << " dB, BLER " << std::setprecision (3) << ue.bler <<
+                            " (" << ue.numCrcErrors << " of " << ue.numCrc << " CRC failed)" << std::defaultfloat);
+      }
+  }
+
+} // namespace ns3
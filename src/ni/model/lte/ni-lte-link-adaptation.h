@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#ifndef NI_LTE_LINK_ADAPTATION_H_
+#define NI_LTE_LINK_ADAPTATION_H_
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+  // maximum number of subband SINR values kept per UE, same as MAX_NUM_SUBBAND_SINR of PHY_CELL_MEASUREMENT_IND
+#define NI_LINK_ADAPTATION__MAX_SUBBANDS 13
+  // number of CRC results the running BLER is averaged over (exponential moving average)
+#define NI_LINK_ADAPTATION__BLER_WINDOW 100
+  // key of the link measured by the device itself, i.e. the downlink of a UE
+#define NI_LINK_ADAPTATION__OWN_LINK 0
+
+  struct NiLinkAdaptationConfig
+  {
+    double blerTarget = 0.1;    // block error rate the outer loop converges to
+    double stepDownDb = 0.5;    // offset decrease on a CRC error, the increase on success is stepDownDb * blerTarget / (1 - blerTarget)
+    double minOffsetDb = -10.0; // lower limit of the outer loop offset
+    double maxOffsetDb = 3.0;   // upper limit of the outer loop offset
+    double sinrAlpha = 0.25;    // weight of a new SINR report in the filtered SINR, 1.0 disables the filter
+  };
+
+  // Outer loop link adaptation per RNTI. The PHY SINR reports (wideband and
+  // subband) are filtered and corrected by an offset which is stepped down on
+  // each CRC error and up on each CRC success, so that the block error rate of
+  // the link converges to blerTarget. The corrected SINR per resource block is
+  // used for the CQI reports towards the ns-3 schedulers.
+  // Not thread safe, all methods are called from the simulator thread. The
+  // transport rx thread hands the reports and CRC results over via a queue.
+  class NiLteLinkAdaptation
+  {
+  public:
+    NiLteLinkAdaptation ();
+
+    void Configure (const NiLinkAdaptationConfig& config);
+    const NiLinkAdaptationConfig& GetConfig (void) const;
+
+    // updates the filtered SINR of rnti, numSubbands may be 0 for wideband only reports
+    void ReportSinr (uint16_t rnti, double widebandSinrDb, const double* subbandSinrDb, uint32_t numSubbands);
+    // updates the outer loop offset and BLER of rnti with the CRC result of one transport block
+    void ReportCrc (uint16_t rnti, bool crcOk);
+
+    // fills sinrDb with the corrected SINR of each of numRb resource blocks, the
+    // subbands are mapped evenly onto the resource blocks, returns false if no
+    // SINR was reported for rnti yet
+    bool GetSinrPerRb (uint16_t rnti, uint32_t numRb, std::vector<double>* sinrDb) const;
+    double GetOffsetDb (uint16_t rnti) const;
+    double GetBler (uint16_t rnti) const;
+    uint64_t GetNumCrc (uint16_t rnti) const;
+    uint64_t GetNumCrcErrors (uint16_t rnti) const;
+
+    // prints the SINR, offset and BLER of each RNTI
+    void Print (void) const;
+
+  private:
+    struct UeState
+    {
+      bool sinrValid = false;
+      double widebandSinrDb = 0.0;
+      uint32_t numSubbands = 0;
+      double subbandSinrDb[NI_LINK_ADAPTATION__MAX_SUBBANDS] = {};
+      double offsetDb = 0.0;
+      double bler = 0.0;
+      uint64_t numSinrReports = 0;
+      uint64_t numCrc = 0;
+      uint64_t numCrcErrors = 0;
+    };
+
+    NiLinkAdaptationConfig m_config;
+    std::map<uint16_t, UeState> m_ueStates;
+  };
+
+} // namespace ns3
+
+#endif /* NI_LTE_LINK_ADAPTATION_H_ */
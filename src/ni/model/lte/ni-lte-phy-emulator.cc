@@ -0,0 +1,700 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <iostream>
+
+#include "ns3/ni-common-constants.h"
+#include "ns3/ni-l1-l2-api-lte-handler.h"
+#include "ns3/ni-l1-l2-api-lte-message.h"
+#include "ns3/ni-pipe.h"
+#include "ns3/ni-pipe-transport.h"
+#include "ns3/ni-shm-transport.h"
+#include "ns3/ni-utils.h"
+#include "ns3/ni-logging.h"
+#include "ni-lte-phy-emulator.h"
+
+namespace ns3 {
+
+  NiLtePhyEmulator::NiLtePhyEmulator ()
+  : m_useShm (false),
+    m_instanceId (0),
+    m_ttiUs (1000),
+    m_ttiJitterUs (0),
+    m_loopback (true),
+    m_cellId (0),
+    m_cellMeasPeriodTti (5),
+    m_widebandSinrDb (30.0),
+    m_numSubbandSinr (MAX_NUM_SUBBAND_SINR),
+    m_idleWaitNs (10000),
+    m_reportIntervalS (0),
+    m_rng (0),
+    m_fdTimingInd (-1),
+    m_fdTx (-1),
+    m_fdMaxTx (0),
+    m_fdRx (-1),
+    m_pRxBufU8 (NULL),
+    m_rxBufLen (0),
+    m_pTxBufU8 (NULL),
+    m_stop (false),
+    m_sfn (0),
+    m_tti (0),
+    m_refId (0),
+    m_timingIndTimeNs (0),
+    m_lastTimingIndTimeNs (0),
+    m_numDlConfigPending (0),
+    m_pPhyDlschRxInd (NULL),
+    m_pPhyUlschRxInd (NULL)
+  {
+  }
+
+  NiLtePhyEmulator::~NiLtePhyEmulator ()
+  {
+    Close ();
+  }
+
+void
+NiLtePhyEmulator::SetUseShm (bool useShm)
+{
+  m_useShm = useShm;
+}
+
+void
+NiLtePhyEmulator::SetInstanceId (uint32_t instanceId)
+{
+  m_instanceId = instanceId;
+}
+
+void
+NiLtePhyEmulator::SetTtiUs (uint32_t ttiUs)
+{
+  m_ttiUs = ttiUs;
+}
+
+void
+NiLtePhyEmulator::SetTtiJitterUs (uint32_t ttiJitterUs)
+{
+  m_ttiJitterUs = ttiJitterUs;
+}
+
+void
+NiLtePhyEmulator::SetLoopback (bool loopback)
+{
+  m_loopback = loopback;
+}
+
+void
+NiLtePhyEmulator::SetCellId (uint32_t cellId)
+{
+  m_cellId = cellId;
+}
+
+void
+NiLtePhyEmulator::SetCellMeasPeriodTti (uint32_t cellMeasPeriodTti)
+{
+  m_cellMeasPeriodTti = cellMeasPeriodTti;
+}
+
+void
+NiLtePhyEmulator::SetSinrDb (double widebandSinrDb, uint32_t numSubbandSinr)
+{
+  m_widebandSinrDb = widebandSinrDb;
+  m_numSubbandSinr = (numSubbandSinr > MAX_NUM_SUBBAND_SINR) ? MAX_NUM_SUBBAND_SINR : numSubbandSinr;
+}
+
+void
+NiLtePhyEmulator::SetIdleWaitNs (uint32_t idleWaitNs)
+{
+  m_idleWaitNs = idleWaitNs;
+}
+
+void
+NiLtePhyEmulator::SetSeed (uint32_t seed)
+{
+  m_rng.seed (seed);
+}
+
+void
+NiLtePhyEmulator::SetReportIntervalS (uint32_t reportIntervalS)
+{
+  m_reportIntervalS = reportIntervalS;
+}
+
+int32_t
+NiLtePhyEmulator::Open (void)
+{
+  m_pRxBufU8 = new uint8_t[2 * NI_COMMON_CONST_MAX_PAYLOAD_SIZE];
+  m_rxBufLen = 0;
+  m_pTxBufU8 = new uint8_t[NI_COMMON_CONST_MAX_PAYLOAD_SIZE];
+  m_pPhyDlschRxInd = new PhyDlschRxInd;
+  InitializePhyDlschRxInd (m_pPhyDlschRxInd);
+  m_pPhyUlschRxInd = new PhyUlschRxInd;
+  InitializePhyUlschRxInd (m_pPhyUlschRxInd);
+
+  if (m_useShm)
+    {
+      NI_LOG_CONSOLE_INFO ("NiLtePhyEmulator: creating shared memory rings of instance " << m_instanceId);
+      if ((m_timingIndRing.Create (NiShmTransport::GetShmRingName (m_instanceId, NI_PIPE_IDX_TIMING_IND), NI_SHM_RING_DATA_SIZE) < 0) ||
+          (m_txRing.Create (NiShmTransport::GetShmRingName (m_instanceId, NI_PIPE_IDX_TX), NI_SHM_RING_DATA_SIZE) < 0) ||
+          (m_rxRing.Create (NiShmTransport::GetShmRingName (m_instanceId, NI_PIPE_IDX_RX), NI_SHM_RING_DATA_SIZE) < 0))
+        {
+          return -1;
+        }
+      return 0;
+    }
+
+  m_pipeNameTimingInd = NiPipeTransport::GetPipeName (m_instanceId, NI_PIPE_IDX_TIMING_IND);
+  m_pipeNameTx = NiPipeTransport::GetPipeName (m_instanceId, NI_PIPE_IDX_TX);
+  m_pipeNameRx = NiPipeTransport::GetPipeName (m_instanceId, NI_PIPE_IDX_RX);
+  NI_LOG_CONSOLE_INFO ("NiLtePhyEmulator: creating named pipes of instance " << m_instanceId << ", waiting for L2 to connect");
+  NiPipe::OpenFifo ((char*)m_pipeNameTimingInd.c_str ());
+  NiPipe::OpenFifo ((char*)m_pipeNameTx.c_str ());
+  NiPipe::OpenFifo ((char*)m_pipeNameRx.c_str ());
+  // the transport opens the tx pipe first, the open of the other pipes blocks until it is connected
+  if ((NiPipe::OpenPipeForRx ((char*)m_pipeNameTx.c_str (), &m_fdTx, &m_readFdsTx, &m_fdMaxTx) < 0) ||
+      (NiPipe::OpenPipeForTx ((char*)m_pipeNameTimingInd.c_str (), &m_fdTimingInd) < 0) ||
+      (NiPipe::OpenPipeForTx ((char*)m_pipeNameRx.c_str (), &m_fdRx) < 0))
+    {
+      return -1;
+    }
+  NI_LOG_CONSOLE_INFO ("NiLtePhyEmulator: L2 connected");
+  return 0;
+}
+
+void
+NiLtePhyEmulator::Close (void)
+{
+  if (m_pTxBufU8 == NULL)
+    {
+      return;
+    }
+  if (m_useShm)
+    {
+      m_timingIndRing.Close ();
+      m_txRing.Close ();
+      m_rxRing.Close ();
+    }
+  else
+    {
+      NiPipe::ClosePipe (&m_fdTimingInd);
+      NiPipe::ClosePipe (&m_fdTx);
+      NiPipe::ClosePipe (&m_fdRx);
+      NiPipe::CloseFifo ((char*)m_pipeNameTimingInd.c_str ());
+      NiPipe::CloseFifo ((char*)m_pipeNameTx.c_str ());
+      NiPipe::CloseFifo ((char*)m_pipeNameRx.c_str ());
+    }
+  delete [] m_pRxBufU8;
+  delete [] m_pTxBufU8;
+  delete m_pPhyDlschRxInd;
+  delete m_pPhyUlschRxInd;
+  m_pRxBufU8 = NULL;
+  m_pTxBufU8 = NULL;
+  m_pPhyDlschRxInd = NULL;
+  m_pPhyUlschRxInd = NULL;
+}
+
+void
+NiLtePhyEmulator::Stop (void)
+{
+  m_stop.store (true, std::memory_order_relaxed);
+}
+
+void
+NiLtePhyEmulator::Run (double durationS)
+{
+  std::uniform_int_distribution<int32_t> jitterDist (-(int32_t)m_ttiJitterUs, (int32_t)m_ttiJitterUs);
+  const uint64_t ttiNs = (uint64_t)m_ttiUs * 1000;
+  const uint64_t startNs = NiUtils::GetSysTimeNs ();
+  const uint64_t durationNs = (uint64_t)(durationS * 1e9);
+  const uint64_t reportIntervalNs = (uint64_t)m_reportIntervalS * 1000000000ULL;
+  uint64_t nominalTimingIndNs = startNs;
+  uint64_t nextTimingIndNs = startNs;
+  uint64_t nextReportNs = startNs + reportIntervalNs;
+  m_lastReportStats = m_stats;
+
+  while (!m_stop.load (std::memory_order_relaxed))
+    {
+      const uint64_t nowNs = NiUtils::GetSysTimeNs ();
+      if ((durationNs > 0) && (nowNs - startNs >= durationNs))
+        {
+          break;
+        }
+
+      bool busy = false;
+      if (nowNs >= nextTimingIndNs)
+        {
+          SendTimingInd ();
+          if ((m_cellMeasPeriodTti > 0) && (m_stats.numPhyTimingInd % m_cellMeasPeriodTti == 0))
+            {
+              SendCellMeasInd ();
+            }
+          // jitter is applied around the nominal TTI grid, i.e. it does not accumulate
+          nominalTimingIndNs += ttiNs;
+          const int64_t jitterNs = (m_ttiJitterUs > 0) ? (int64_t)jitterDist (m_rng) * 1000 : 0;
+          nextTimingIndNs = nominalTimingIndNs + jitterNs;
+          busy = true;
+        }
+
+      busy |= ReceiveMsgs ();
+
+      if ((reportIntervalNs > 0) && (nowNs >= nextReportNs))
+        {
+          PrintReport (nowNs - (nextReportNs - reportIntervalNs));
+          nextReportNs += reportIntervalNs;
+        }
+
+      if (!busy && (m_idleWaitNs > 0))
+        {
+          // do not oversleep the next timing indication
+          const uint64_t untilTimingIndNs = (nextTimingIndNs > nowNs) ? (nextTimingIndNs - nowNs) : 0;
+          struct timespec ts = {0, (long)((untilTimingIndNs < m_idleWaitNs) ? untilTimingIndNs : m_idleWaitNs)};
+          nanosleep (&ts, NULL);
+        }
+    }
+}
+
+void
+NiLtePhyEmulator::SendTimingInd (void)
+{
+  const uint64_t nowNs = NiUtils::GetSysTimeNs ();
+  if (m_stats.numPhyTimingInd > 0)
+    {
+      if (++m_tti == 10)
+        {
+          m_tti = 0;
+          m_sfn = (m_sfn + 1) % 1024;
+        }
+      const uint64_t intervalUs = (nowNs - m_timingIndTimeNs) / 1000;
+      if (intervalUs < m_stats.minTtiIntervalUs) m_stats.minTtiIntervalUs = intervalUs;
+      if (intervalUs > m_stats.maxTtiIntervalUs) m_stats.maxTtiIntervalUs = intervalUs;
+    }
+  m_lastTimingIndTimeNs = m_timingIndTimeNs;
+  m_timingIndTimeNs = nowNs;
+  m_numDlConfigPending = 0;
+
+  PhyTimingInd phyTimingInd;
+  InitializePhyTimingInd (&phyTimingInd);
+  phyTimingInd.genMsgHdr.refId = m_refId++;
+  phyTimingInd.subMsgHdr.sfn   = m_sfn;
+  phyTimingInd.subMsgHdr.tti   = m_tti;
+
+  uint32_t bufOffset = 0;
+  SerializePhyTimingInd (&phyTimingInd, m_pTxBufU8, &bufOffset);
+  if (m_useShm)
+    {
+      struct iovec iov;
+      iov.iov_base = m_pTxBufU8;
+      iov.iov_len  = bufOffset;
+      m_timingIndRing.Write (&iov, 1);
+    }
+  else
+    {
+      if (NiPipe::PipeWrite (&m_fdTimingInd, m_pTxBufU8, bufOffset) < 0)
+        {
+          NI_LOG_CONSOLE_INFO ("NiLtePhyEmulator: L2 disconnected");
+          Stop ();
+        }
+    }
+  m_stats.numPhyTimingInd++;
+}
+
+void
+NiLtePhyEmulator::SendCellMeasInd (void)
+{
+  PhyCellMeasInd phyCellMeasInd;
+  InitializePhyCellMeasInd (&phyCellMeasInd);
+  phyCellMeasInd.genMsgHdr.refId                       = m_refId++;
+  phyCellMeasInd.genMsgHdr.bodyLength                  = 17 + m_numSubbandSinr;
+  phyCellMeasInd.subMsgHdr.sfn                         = m_sfn;
+  phyCellMeasInd.subMsgHdr.tti                         = m_tti;
+  phyCellMeasInd.cellMeasReportHdr.parSetBodyLength    = 4 + m_numSubbandSinr;
+  phyCellMeasInd.cellMeasReportBody.cellId             = m_cellId;
+  phyCellMeasInd.cellMeasReportBody.widebandSinr       = NiUtils::ConvertDoubleToFxpI8_6_2 (m_widebandSinrDb);
+  phyCellMeasInd.cellMeasReportBody.numSubbandSinr     = m_numSubbandSinr;
+  memset (phyCellMeasInd.cellMeasReportBody.subbandSinr, NiUtils::ConvertDoubleToFxpI8_6_2 (m_widebandSinrDb), m_numSubbandSinr);
+
+  uint32_t bufOffset = 0;
+  SerializePhyCellMeasurementInd (&phyCellMeasInd, m_pTxBufU8, &bufOffset);
+  SendMsg (m_pTxBufU8, bufOffset);
+  m_stats.numPhyCellMeasInd++;
+}
+
+void
+NiLtePhyEmulator::SendCnf (uint32_t srcMsgType, uint32_t cnfStatus, uint32_t sfn, uint32_t tti)
+{
+  PhyCnf phyCnf;
+  InitializePhyCnf (&phyCnf);
+  phyCnf.genMsgHdr.refId       = m_refId++;
+  phyCnf.subMsgHdr.sfn         = sfn;
+  phyCnf.subMsgHdr.tti         = tti;
+  phyCnf.cnfBody.cnfStatus     = cnfStatus;
+  phyCnf.cnfBody.srcMsgType    = srcMsgType;
+
+  uint8_t buf[32];
+  uint32_t bufOffset = 0;
+  SerializePhyCnf (&phyCnf, buf, &bufOffset);
+  SendMsg (buf, bufOffset);
+  m_stats.numPhyCnf++;
+}
+
+// sends a message on the rx ind / cnf pipe
+void
+NiLtePhyEmulator::SendMsg (uint8_t* pBufU8, uint32_t len)
+{
+  struct iovec iov;
+  iov.iov_base = pBufU8;
+  iov.iov_len  = len;
+  if (m_useShm)
+    {
+      m_rxRing.Write (&iov, 1);
+    }
+  else if (NiPipe::PipeWriteV (&m_fdRx, &iov, 1) < 0)
+    {
+      NI_LOG_CONSOLE_INFO ("NiLtePhyEmulator: L2 disconnected");
+      Stop ();
+    }
+}
+
+// reads and handles all complete messages available, returns true if any was handled
+bool
+NiLtePhyEmulator::ReceiveMsgs (void)
+{
+  bool handled = false;
+
+  if (m_useShm)
+    {
+      int32_t nread;
+      while ((nread = m_txRing.Read (m_pRxBufU8, NI_COMMON_CONST_MAX_PAYLOAD_SIZE)) > 0)
+        {
+          HandleMsg (m_pRxBufU8, nread);
+          handled = true;
+        }
+      return handled;
+    }
+
+  // a read may return partial or several messages - reassemble them in the rx buffer
+  const int32_t nread = NiPipe::PipeReadOnce (&m_fdTx, m_pRxBufU8 + m_rxBufLen,
+                                              NI_COMMON_CONST_MAX_PAYLOAD_SIZE);
+  if (nread == 0)
+    {
+      NI_LOG_CONSOLE_INFO ("NiLtePhyEmulator: L2 disconnected");
+      Stop ();
+      return false;
+    }
+  if (nread < 0)
+    {
+      return false;
+    }
+  m_rxBufLen += nread;
+
+  uint32_t offset = 0;
+  while (m_rxBufLen - offset >= 8)
+    {
+      uint32_t bodyLength = 0;
+      uint32_t hdrOffset = offset;
+      GetBodyLength (&bodyLength, m_pRxBufU8, &hdrOffset);
+      if (8 + bodyLength > NI_COMMON_CONST_MAX_PAYLOAD_SIZE)
+        {
+          NI_LOG_CONSOLE_INFO ("NiLtePhyEmulator: invalid message, bodyLength=" << bodyLength);
+          offset = m_rxBufLen;
+          break;
+        }
+      if (m_rxBufLen - offset < 8 + bodyLength)
+        {
+          break;
+        }
+      HandleMsg (m_pRxBufU8 + offset, 8 + bodyLength);
+      offset += 8 + bodyLength;
+      handled = true;
+    }
+  m_rxBufLen -= offset;
+  memmove (m_pRxBufU8, m_pRxBufU8 + offset, m_rxBufLen);
+
+  return handled;
+}
+
+// requests have to refer to the TTI of the last timing indication
+uint32_t
+NiLtePhyEmulator::CheckDeadline (uint32_t sfn, uint32_t tti)
+{
+  if ((sfn != m_sfn) || (tti != m_tti))
+    {
+      m_stats.numDeadlineMisses++;
+      return CNF_TIMEOUT;
+    }
+  const uint64_t latencyUs = (NiUtils::GetSysTimeNs () - m_timingIndTimeNs) / 1000;
+  m_stats.numReqLatency++;
+  m_stats.sumReqLatencyUs += latencyUs;
+  if (latencyUs > m_stats.maxReqLatencyUs) m_stats.maxReqLatencyUs = latencyUs;
+  return CNF_SUCCESS;
+}
+
+void
+NiLtePhyEmulator::HandleMsg (uint8_t* pBufU8, uint32_t len)
+{
+  uint32_t msgType = 0;
+  uint32_t bufOffset = 0;
+  GetMsgType (&msgType, pBufU8, &bufOffset);
+
+  switch (msgType)
+  {
+    case (PHY_DL_TX_CONFIG_REQ):
+      {
+        PhyDlTxConfigReq phyDlTxConfigReq;
+        DeserializePhyDlTxConfigReq (&phyDlTxConfigReq, pBufU8, &bufOffset);
+        m_stats.numPhyDlTxConfigReq++;
+        uint32_t cnfStatus = CheckDeadline (phyDlTxConfigReq.subMsgHdr.sfn, phyDlTxConfigReq.subMsgHdr.tti);
+        // one DLSCH config and DCI DL grant parameter set pair per PDU
+        const uint32_t numPdus = phyDlTxConfigReq.subMsgHdr.numSubMsg / 2;
+        if ((numPdus == 0) || (numPdus > MAX_NUM_DLSCH_PDUS) ||
+            (16 + numPdus * PHY_DL_TX_CONFIG_PAR_SETS_SIZE > len))
+          {
+            cnfStatus = CNF_LENGTH_MISMATCH;
+            m_numDlConfigPending = 0;
+          }
+        else
+          {
+            for (uint32_t i = 0; i < numPdus; i++)
+              {
+                if (i > 0)
+                  {
+                    DeserializePhyDlTxConfigReqParSets (&phyDlTxConfigReq, pBufU8, &bufOffset);
+                  }
+                m_dlConfigMacPduIndex[i] = phyDlTxConfigReq.dlschTxConfigBody.macPduIndex;
+                m_dlConfigRnti[i] = phyDlTxConfigReq.dlschTxConfigBody.rnti;
+              }
+            m_numDlConfigPending = numPdus;
+          }
+        if (phyDlTxConfigReq.subMsgHdr.cnfMode == 1)
+          {
+            SendCnf (msgType, cnfStatus, phyDlTxConfigReq.subMsgHdr.sfn, phyDlTxConfigReq.subMsgHdr.tti);
+          }
+        break;
+      }
+    case (PHY_DL_TX_PAYLOAD_REQ):
+      {
+        PhyTxPayloadReqHdr phyTxPayloadReqHdr;
+        DeserializePhyTxPayloadReqHdr (&phyTxPayloadReqHdr, pBufU8, &bufOffset);
+        const uint32_t sfn = phyTxPayloadReqHdr.subMsgHdr.sfn;
+        const uint32_t tti = phyTxPayloadReqHdr.subMsgHdr.tti;
+        const uint32_t numPdus = phyTxPayloadReqHdr.subMsgHdr.numSubMsg;
+        uint32_t cnfStatus = CheckDeadline (sfn, tti);
+        m_stats.numPhyDlTxPayloadReq++;
+
+        // each MAC PDU parameter set has to match a DLSCH config of the same TTI by its index
+        uint8_t* pMacPdus[MAX_NUM_DLSCH_PDUS];
+        uint32_t macPduSizes[MAX_NUM_DLSCH_PDUS];
+        uint32_t rntis[MAX_NUM_DLSCH_PDUS];
+        uint32_t numValidPdus = 0;
+        bool mismatch = (numPdus != m_numDlConfigPending);
+        for (uint32_t i = 0; (i < numPdus) && (i < MAX_NUM_DLSCH_PDUS); i++)
+          {
+            if (i > 0)
+              {
+                if (bufOffset + PHY_TX_PAYLOAD_PAR_SET_HDR_SIZE > len)
+                  {
+                    cnfStatus = CNF_LENGTH_MISMATCH;
+                    break;
+                  }
+                DeserializePhyTxPayloadReqParSetHdr (&phyTxPayloadReqHdr, pBufU8, &bufOffset);
+              }
+            const uint32_t macPduSize = phyTxPayloadReqHdr.macPduTxBodyHdr.macPduSize;
+            if ((macPduSize > MAX_MAC_PDU_SIZE) || (bufOffset + macPduSize > len))
+              {
+                cnfStatus = CNF_LENGTH_MISMATCH;
+                break;
+              }
+            uint32_t idxConfig = 0;
+            while ((idxConfig < m_numDlConfigPending) &&
+                   (m_dlConfigMacPduIndex[idxConfig] != phyTxPayloadReqHdr.macPduTxBodyHdr.macPduIndex))
+              {
+                idxConfig++;
+              }
+            const bool matched = (idxConfig < m_numDlConfigPending);
+            mismatch |= !matched;
+            pMacPdus[numValidPdus] = pBufU8 + bufOffset;
+            macPduSizes[numValidPdus] = macPduSize;
+            rntis[numValidPdus] = matched ? m_dlConfigRnti[idxConfig] : 0;
+            numValidPdus++;
+            bufOffset += macPduSize;
+          }
+        if (numPdus > MAX_NUM_DLSCH_PDUS)
+          {
+            cnfStatus = CNF_LENGTH_MISMATCH;
+          }
+        if (cnfStatus == CNF_LENGTH_MISMATCH)
+          {
+            numValidPdus = 0;
+          }
+        else if ((cnfStatus == CNF_SUCCESS) && mismatch)
+          {
+            m_stats.numConfigPayloadMismatch++;
+            cnfStatus = CNF_CONFIG_PAYLOAD_MISMATCH;
+          }
+        m_numDlConfigPending = 0;
+
+        for (uint32_t i = 0; i < numValidPdus; i++)
+          {
+            m_stats.numDlBytes += macPduSizes[i];
+          }
+        m_stats.numDlschPdus += numValidPdus;
+        if (numValidPdus > m_stats.maxDlschPdusPerReq) m_stats.maxDlschPdusPerReq = numValidPdus;
+        if (phyTxPayloadReqHdr.subMsgHdr.cnfMode == 1)
+          {
+            SendCnf (msgType, cnfStatus, sfn, tti);
+          }
+        if (!m_loopback)
+          {
+            break;
+          }
+        for (uint32_t i = 0; i < numValidPdus; i++)
+          {
+            if (macPduSizes[i] > 0)
+              {
+                SendDlschRxInd (sfn, tti, rntis[i], pMacPdus[i], macPduSizes[i]);
+              }
+          }
+        break;
+      }
+    case (PHY_UL_TX_PAYLOAD_REQ):
+      {
+        PhyTxPayloadReqHdr phyTxPayloadReqHdr;
+        DeserializePhyTxPayloadReqHdr (&phyTxPayloadReqHdr, pBufU8, &bufOffset);
+        const uint32_t sfn = phyTxPayloadReqHdr.subMsgHdr.sfn;
+        const uint32_t tti = phyTxPayloadReqHdr.subMsgHdr.tti;
+        uint32_t macPduSize = phyTxPayloadReqHdr.macPduTxBodyHdr.macPduSize;
+        uint32_t cnfStatus = CheckDeadline (sfn, tti);
+        if ((macPduSize > MAX_MAC_PDU_SIZE) || (bufOffset + macPduSize > len))
+          {
+            cnfStatus = CNF_LENGTH_MISMATCH;
+            macPduSize = 0;
+          }
+        uint8_t* pMacPdu = pBufU8 + bufOffset;
+
+        m_stats.numPhyUlTxPayloadReq++;
+        m_stats.numUlBytes += macPduSize;
+        if (phyTxPayloadReqHdr.subMsgHdr.cnfMode == 1)
+          {
+            SendCnf (msgType, cnfStatus, sfn, tti);
+          }
+        if (!m_loopback || (macPduSize == 0))
+          {
+            break;
+          }
+
+        // the FPGA prepends the payload length (4 bytes, little endian) to the ULSCH MAC PDU
+        const uint32_t fpgaPayloadLengthHeaderSize = 4;
+        if (macPduSize + fpgaPayloadLengthHeaderSize > MAX_MAC_PDU_SIZE)
+          {
+            macPduSize = MAX_MAC_PDU_SIZE - fpgaPayloadLengthHeaderSize;
+          }
+        const uint32_t rxPduSize = macPduSize + fpgaPayloadLengthHeaderSize;
+        uint32_t txOffset = 0;
+        m_pPhyUlschRxInd->genMsgHdr.refId                     = m_refId++;
+        m_pPhyUlschRxInd->genMsgHdr.bodyLength                = 19 + rxPduSize;
+        m_pPhyUlschRxInd->subMsgHdr.sfn                       = sfn;
+        m_pPhyUlschRxInd->subMsgHdr.tti                       = tti;
+        m_pPhyUlschRxInd->ulschMacPduRxHdr.parSetBodyLength   = 6 + rxPduSize;
+        m_pPhyUlschRxInd->ulschMacPduRxBody.macPduSize        = rxPduSize;
+        for (uint32_t i = 0; i < fpgaPayloadLengthHeaderSize; i++)
+          {
+            m_pPhyUlschRxInd->ulschMacPduRxBody.macPdu[i] = (macPduSize >> (i * 8)) & 0xFF;
+          }
+        memcpy (m_pPhyUlschRxInd->ulschMacPduRxBody.macPdu + fpgaPayloadLengthHeaderSize, pMacPdu, macPduSize);
+        SerializePhyUlschRxInd (m_pPhyUlschRxInd, m_pTxBufU8, &txOffset);
+        m_stats.numPhyUlschRxInd++;
+        SendMsg (m_pTxBufU8, txOffset);
+        break;
+      }
+    default:
+      m_stats.numUnknownMsg++;
+      SendCnf (msgType, CNF_UNKNOWN_MESSAGE, m_sfn, m_tti);
+      break;
+  }
+}
+
+void
+NiLtePhyEmulator::SendDlschRxInd (uint32_t sfn, uint32_t tti, uint32_t rnti, uint8_t* pMacPdu, uint32_t macPduSize)
+{
+  uint32_t txOffset = 0;
+  m_pPhyDlschRxInd->genMsgHdr.refId                     = m_refId++;
+  m_pPhyDlschRxInd->genMsgHdr.bodyLength                = 19 + macPduSize;
+  m_pPhyDlschRxInd->subMsgHdr.sfn                       = sfn;
+  m_pPhyDlschRxInd->subMsgHdr.tti                       = tti;
+  m_pPhyDlschRxInd->dlschMacPduRxHdr.parSetBodyLength   = 6 + macPduSize;
+  m_pPhyDlschRxInd->dlschMacPduRxBody.rnti              = rnti;
+  m_pPhyDlschRxInd->dlschMacPduRxBody.macPduSize        = macPduSize;
+  memcpy (m_pPhyDlschRxInd->dlschMacPduRxBody.macPdu, pMacPdu, macPduSize);
+  SerializePhyDlschRxInd (m_pPhyDlschRxInd, m_pTxBufU8, &txOffset);
+  m_stats.numPhyDlschRxInd++;
+  SendMsg (m_pTxBufU8, txOffset);
+}
+
+void
+NiLtePhyEmulator::PrintReport (uint64_t intervalNs)
+{
+  const double intervalS = intervalNs / 1e9;
+  const NiLtePhyEmulatorStats& last = m_lastReportStats;
+  NI_LOG_CONSOLE_INFO ("NiLtePhyEmulator: SFN " << m_sfn <<
+                       " DL " << ((m_stats.numDlBytes - last.numDlBytes) * 8 / intervalS / 1e6) << " Mbit/s" <<
+                       " UL " << ((m_stats.numUlBytes - last.numUlBytes) * 8 / intervalS / 1e6) << " Mbit/s" <<
+                       " deadline misses " << (m_stats.numDeadlineMisses - last.numDeadlineMisses));
+  m_lastReportStats = m_stats;
+}
+
+void
+NiLtePhyEmulator::PrintStats (void)
+{
+  const double durationS = m_stats.numPhyTimingInd * (m_ttiUs / 1e6);
+  NI_LOG_CONSOLE_INFO ("\n-------- NI LTE PHY Emulator Statistics --------");
+  NI_LOG_CONSOLE_INFO ("Transport          = " << (m_useShm ? "shared memory" : "named pipes") << " (instance " << m_instanceId << ")");
+  NI_LOG_CONSOLE_INFO ("PhyTimingInd       = " << m_stats.numPhyTimingInd << " (TTI " << m_ttiUs << " us, jitter +/-" << m_ttiJitterUs << " us)");
+  if (m_stats.numPhyTimingInd > 1)
+    {
+      NI_LOG_CONSOLE_INFO ("  interval         = min " << m_stats.minTtiIntervalUs << " us, max " << m_stats.maxTtiIntervalUs << " us");
+    }
+  NI_LOG_CONSOLE_INFO ("PhyDlTxConfigReq   = " << m_stats.numPhyDlTxConfigReq);
+  NI_LOG_CONSOLE_INFO ("PhyDlTxPayloadReq  = " << m_stats.numPhyDlTxPayloadReq << " (" << m_stats.numDlBytes << " bytes)");
+  NI_LOG_CONSOLE_INFO ("  DLSCH PDUs       = " << m_stats.numDlschPdus << " (max " << m_stats.maxDlschPdusPerReq << " per request)");
+  NI_LOG_CONSOLE_INFO ("PhyUlTxPayloadReq  = " << m_stats.numPhyUlTxPayloadReq << " (" << m_stats.numUlBytes << " bytes)");
+  NI_LOG_CONSOLE_INFO ("Unknown messages   = " << m_stats.numUnknownMsg);
+  NI_LOG_CONSOLE_INFO ("PhyCnf             = " << m_stats.numPhyCnf);
+  NI_LOG_CONSOLE_INFO ("PhyDlschRxInd      = " << m_stats.numPhyDlschRxInd);
+  NI_LOG_CONSOLE_INFO ("PhyUlschRxInd      = " << m_stats.numPhyUlschRxInd);
+  NI_LOG_CONSOLE_INFO ("PhyCellMeasInd     = " << m_stats.numPhyCellMeasInd << " (SINR " << m_widebandSinrDb << " dB)");
+  if (durationS > 0)
+    {
+      NI_LOG_CONSOLE_INFO ("DL throughput      = " << (m_stats.numDlBytes * 8 / durationS / 1e6) << " Mbit/s");
+      NI_LOG_CONSOLE_INFO ("UL throughput      = " << (m_stats.numUlBytes * 8 / durationS / 1e6) << " Mbit/s");
+    }
+  NI_LOG_CONSOLE_INFO ("TTI deadline misses= " << m_stats.numDeadlineMisses);
+  NI_LOG_CONSOLE_INFO ("Config/payload mismatch = " << m_stats.numConfigPayloadMismatch);
+  if (m_stats.numReqLatency > 0)
+    {
+      NI_LOG_CONSOLE_INFO ("TimingInd->request = avg " << (m_stats.sumReqLatencyUs / m_stats.numReqLatency) <<
+                           " us, max " << m_stats.maxReqLatencyUs << " us");
+    }
+  NI_LOG_CONSOLE_INFO ("------------------------------------------------\n");
+}
+
+} // namespace ns3
@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2019 National Instruments
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Vincent Kotzsch <vincent.kotzsch@ni.com>
+ *         Clemens Felber <clemens.felber@ni.com>
+ */
+
+#ifndef SRC_NI_MODEL_LTE_NI_LTE_PHY_EMULATOR_H_
+#define SRC_NI_MODEL_LTE_NI_LTE_PHY_EMULATOR_H_
+
+#include <atomic>
+#include <random>
+#include <string>
+#include <cstdint>
+#include <sys/select.h>
+#include <sys/uio.h>
+
+#include "ns3/ni-l1-l2-api-lte.h"
+#include "ns3/ni-shm-ring.h"
+
+namespace ns3 {
+
+  // emulator statistics
+  typedef struct sNiLtePhyEmulatorStats {
+    uint64_t numPhyTimingInd        = 0;
+    uint64_t numPhyDlTxConfigReq    = 0;
+    uint64_t numPhyDlTxPayloadReq   = 0;
+    uint64_t numPhyUlTxPayloadReq   = 0;
+    uint64_t numUnknownMsg          = 0;
+    uint64_t numPhyCnf              = 0;
+    uint64_t numPhyDlschRxInd       = 0;
+    uint64_t numPhyUlschRxInd       = 0;
+    uint64_t numPhyCellMeasInd      = 0;
+    uint64_t numDlschPdus           = 0; // MAC PDUs of DL TX payload requests
+    uint64_t maxDlschPdusPerReq     = 0;
+    uint64_t numDlBytes             = 0; // MAC PDU bytes of DL TX payload requests
+    uint64_t numUlBytes             = 0; // MAC PDU bytes of UL TX payload requests
+    uint64_t numDeadlineMisses      = 0; // requests received for an already elapsed TTI
+    uint64_t numConfigPayloadMismatch = 0;
+    uint64_t numReqLatency          = 0; // requests received within their TTI
+    uint64_t sumReqLatencyUs        = 0; // timing ind until request reception
+    uint64_t maxReqLatencyUs        = 0;
+    uint64_t minTtiIntervalUs       = UINT64_MAX; // achieved timing ind intervals
+    uint64_t maxTtiIntervalUs       = 0;
+  } NiLtePhyEmulatorStats;
+
+  // Software stand-in for the PHY of the LTE Application Framework.
+  // Creates the named pipes (or shared memory rings) of the L1-L2 API, sends
+  // PHY_TIMING_IND every TTI with optional jitter, confirms TX requests with
+  // PHY_CNF, loops TX payloads back as PHY_DLSCH_RX_IND / PHY_ULSCH_RX_IND (one
+  // per MAC PDU of a multi PDU DL request, paired by MAC PDU index) and
+  // sends periodic PHY_CELL_MEASUREMENT_IND with a configurable SINR.
+  // Requests that refer to an already elapsed TTI are counted as deadline
+  // misses and confirmed with CNF_TIMEOUT.
+  class NiLtePhyEmulator
+  {
+  public:
+    NiLtePhyEmulator ();
+    virtual
+    ~NiLtePhyEmulator ();
+
+    // configuration - has to be done before Open
+    void SetUseShm (bool useShm);
+    // AFW instance whose pipes / rings are created
+    void SetInstanceId (uint32_t instanceId);
+    void SetTtiUs (uint32_t ttiUs);
+    void SetTtiJitterUs (uint32_t ttiJitterUs);
+    void SetLoopback (bool loopback);
+    void SetCellId (uint32_t cellId);
+    void SetCellMeasPeriodTti (uint32_t cellMeasPeriodTti);
+    void SetSinrDb (double widebandSinrDb, uint32_t numSubbandSinr);
+    void SetIdleWaitNs (uint32_t idleWaitNs);
+    void SetSeed (uint32_t seed);
+    void SetReportIntervalS (uint32_t reportIntervalS);
+
+    int32_t Open (void);
+    void Close (void);
+    // runs the PHY loop until Stop is called or the duration expired (0 = infinite)
+    void Run (double durationS);
+    // async signal safe
+    void Stop (void);
+
+    void PrintStats (void);
+    const NiLtePhyEmulatorStats& GetStats (void) const { return m_stats; }
+
+  private:
+    void SendTimingInd (void);
+    void SendCellMeasInd (void);
+    void SendCnf (uint32_t srcMsgType, uint32_t cnfStatus, uint32_t sfn, uint32_t tti);
+    void SendMsg (uint8_t* pBufU8, uint32_t len);
+    bool ReceiveMsgs (void);
+    void HandleMsg (uint8_t* pBufU8, uint32_t len);
+    uint32_t CheckDeadline (uint32_t sfn, uint32_t tti);
+    void SendDlschRxInd (uint32_t sfn, uint32_t tti, uint32_t rnti, uint8_t* pMacPdu, uint32_t macPduSize);
+    void PrintReport (uint64_t intervalNs);
+
+    // configuration
+    bool m_useShm;
+    uint32_t m_instanceId;
+    uint32_t m_ttiUs;
+    uint32_t m_ttiJitterUs;
+    bool m_loopback;
+    uint32_t m_cellId;
+    uint32_t m_cellMeasPeriodTti;
+    double m_widebandSinrDb;
+    uint32_t m_numSubbandSinr;
+    uint32_t m_idleWaitNs;
+    uint32_t m_reportIntervalS;
+    std::mt19937 m_rng;
+
+    // transport
+    std::string m_pipeNameTimingInd;
+    std::string m_pipeNameTx;
+    std::string m_pipeNameRx;
+    int32_t m_fdTimingInd;
+    int32_t m_fdTx;
+    fd_set m_readFdsTx;
+    int32_t m_fdMaxTx;
+    int32_t m_fdRx;
+    NiShmRing m_timingIndRing;
+    NiShmRing m_txRing;
+    NiShmRing m_rxRing;
+    uint8_t* m_pRxBufU8;       // reassembly of messages read from the tx pipe
+    uint32_t m_rxBufLen;
+    uint8_t* m_pTxBufU8;
+
+    // PHY state
+    std::atomic<bool> m_stop;
+    uint32_t m_sfn;
+    uint32_t m_tti;
+    uint32_t m_refId;
+    uint64_t m_timingIndTimeNs;
+    uint64_t m_lastTimingIndTimeNs;
+    // DLSCH parameter sets of the last config request, consumed by the payload request
+    uint32_t m_dlConfigMacPduIndex[MAX_NUM_DLSCH_PDUS];
+    uint32_t m_dlConfigRnti[MAX_NUM_DLSCH_PDUS];
+    uint32_t m_numDlConfigPending;
+
+    // message buffers (large because of MAC PDU arrays)
+    PhyDlschRxInd* m_pPhyDlschRxInd;
+    PhyUlschRxInd* m_pPhyUlschRxInd;
+
+    NiLtePhyEmulatorStats m_stats;
+    NiLtePhyEmulatorStats m_lastReportStats;
+  };
+
+} // namespace ns3
+
+#endif /* SRC_NI_MODEL_LTE_NI_LTE_PHY_EMULATOR_H_ */
@@ -24,6 +24,8 @@
 #include "ni-lte-sdr-timing-sync.h"
 #include "../common/ni-utils.h"
 #include "../common/ni-logging.h"
+#include "../common/ni-trace.h"
+#include "../common/ni-latency-histogram.h"
 #include "../../model/common/ni-pipe-transport.h"
 
 
@@ -74,8 +76,7 @@ namespace ns3 {
             NI_LOG_NONE("wallClockDelta: " + std::to_string(wallClockDelta) +
                         ", currentAlignment: " + std::to_string(currentAlignment) +
                         ", normalizedRealtime: " + std::to_string(normalizedRealtime));
-            NI_LOG_NONE("[Trace#2],wallClockDelta,currentAlignment,normalizedRealtime," <<
-                        wallClockDelta << "," << currentAlignment << "," << normalizedRealtime);
+            NI_TRACE(NI_TRACE_WALL_CLOCK_ALIGNMENT, 0, 0, wallClockDelta, currentAlignment, normalizedRealtime);
           }
         if (normalizedRealtime < g_lastNormalizedRealtime) {
             NI_LOG_FATAL("ERROR: normalizedRealtime < g_lastNormalizedRealtime (" <<
@@ -145,6 +146,7 @@ namespace ns3 {
   NiLteSdrTimingSync::CalcPhyTimeDiff(int64_t currentDiff)
   {
     int64_t mean = 0;
+    g_NiLatency.Record(NI_LATENCY_PHY_TIME_DIFF, ((currentDiff < 0) ? -currentDiff : currentDiff) * 1000);
     g_phytimeUsAccu += currentDiff;
     NI_LOG_NONE ("g_phytimeUsAccu: " + std::to_string(g_phytimeUsAccu) +
                  ", currentDiff: " + std::to_string(currentDiff) +
@@ -26,14 +26,22 @@
 #include "ns3/ni-common-constants.h"
 #include "ns3/ni-l1-l2-api.h"
 #include "ns3/ni-logging.h"
+#include "ns3/ni-trace.h"
+#include "ns3/ni-capture.h"
+#include "ns3/ni-latency-histogram.h"
+#include "ns3/ni-rt-memory.h"
 #include "ns3/ni-utils.h"
+#include "ns3/ni-spsc-ring.h"
 #include "ns3/ni-remote-control-engine.h"
 #include "ns3/ni-udp-transport.h"
 #include "ns3/ni-pipe-transport.h"
+#include "ns3/ni-shm-transport.h"
 
 // LTE
 #include "ns3/ni-lte-constants.h"
 #include "ns3/ni-lte-sdr-timing-sync.h"
+#include "ns3/ni-lte-deadline-monitor.h"
+#include "ns3/ni-lte-link-adaptation.h"
 #include "ns3/ni-lte-phy-interface.h"
 
 // WIFI
@@ -27,6 +27,9 @@
 #include <unistd.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
 
 
 
@@ -56,13 +59,22 @@ void LocalCommsInterface::Initialize(std::string name){
     //printf("Socket has name %s\n", server.sun_path);
 
 
+    if (pipe2(wakeupPipe, O_NONBLOCK | O_CLOEXEC) < 0) {
+        perror("ERROR: LocalCommsInterface::Initialize, creating wakeup pipe");
+        exit(1);
+    }
+
     poll_list[0].fd = sock;
     poll_list[0].events = POLLIN|POLLPRI;
+    poll_list[1].fd = wakeupPipe[0];
+    poll_list[1].events = POLLIN;
 
 }
 
 void LocalCommsInterface::Close(){
     close(sock);
+    close(wakeupPipe[0]);
+    close(wakeupPipe[1]);
     // todo deleting objects whatsoever?
     return;
 }
@@ -92,9 +104,10 @@ std::string LocalCommsInterface::GetMessage(int timeout){
     } else {
     //std::cout << "data available" << std::endl;
     len = sizeof(struct sockaddr_un);
-    numBytes = recvfrom(sock, buf, 1024, 0, (struct sockaddr *) &dstaddr, &len);
+    numBytes = recvfrom(sock, buf, sizeof(buf) - 1, 0, (struct sockaddr *) &dstaddr, &len);
     if (numBytes < 0) {
         perror("ERROR: LocalCommsInterface::GetMessage, recvfrom() failed");
+        numBytes = 0;
     }
     buf[numBytes] = '\0';
 
@@ -131,3 +144,67 @@ void LocalCommsInterface::SendMessage(std::string message, std::string destinati
 
     return;
 }
+
+bool LocalCommsInterface::Poll(int64_t timeoutNs){
+    struct timespec ts;
+    ts.tv_sec = timeoutNs / 1000000000LL;
+    ts.tv_nsec = timeoutNs % 1000000000LL;
+    if (ppoll(poll_list, 2, (timeoutNs < 0) ? NULL : &ts, NULL) <= 0) {
+        return false;
+    }
+    if (poll_list[1].revents & POLLIN) {
+        char drain[64];
+        while (read(wakeupPipe[0], drain, sizeof(drain)) > 0) {
+            ;
+        }
+    }
+    return (poll_list[0].revents & POLLIN) == POLLIN;
+}
+
+void LocalCommsInterface::Wakeup(){
+    const char wakeup = 1;
+    // a full pipe already wakes up the poll
+    if (write(wakeupPipe[1], &wakeup, 1) < 0 && errno != EAGAIN) {
+        perror("ERROR: LocalCommsInterface::Wakeup, write() failed");
+    }
+}
+
+bool LocalCommsInterface::ReceiveMessage(std::string* message, std::string* source){
+    struct sockaddr_un srcaddr;
+    socklen_t len = sizeof(struct sockaddr_un);
+    const ssize_t numBytes = recvfrom(sock, buf, sizeof(buf) - 1, MSG_DONTWAIT, (struct sockaddr *) &srcaddr, &len);
+    if (numBytes < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            perror("ERROR: LocalCommsInterface::ReceiveMessage, recvfrom() failed");
+        }
+        return false;
+    }
+    message->assign(buf, numBytes);
+    // unnamed sockets only carry the address family
+    if (len > sizeof(sa_family_t) && srcaddr.sun_path[0] != '\0') {
+        source->assign(srcaddr.sun_path);
+    } else {
+        source->clear();
+    }
+    return true;
+}
+
+bool LocalCommsInterface::SendData(const void* data, uint32_t size, const std::string& sourcePath){
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, sourcePath.c_str(), sizeof(addr.sun_path) - 1);
+    // non-blocking, a client not reading its socket must not stall the remote control thread
+    return sendto(sock, data, size, MSG_DONTWAIT, (struct sockaddr *) &addr, sizeof(struct sockaddr_un)) == (ssize_t) size;
+}
+
+uint32_t LocalCommsInterface::GetData(uint8_t* data, uint32_t size, int timeout){
+    struct pollfd pfd;
+    pfd.fd = sock;
+    pfd.events = POLLIN;
+    if (poll(&pfd, 1, timeout) <= 0) {
+        return 0;
+    }
+    const ssize_t numBytes = recv(sock, data, size, MSG_DONTWAIT);
+    return (numBytes > 0) ? (uint32_t) numBytes : 0;
+}
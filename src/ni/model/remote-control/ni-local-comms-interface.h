@@ -24,11 +24,15 @@
 #define LOCAL_COMMS_INTERFACE_H
 
 #include <string>
+#include <stdint.h>
 
 #include <poll.h>
 #include <sys/un.h>
 #include <sys/socket.h>
 
+// maximum size of a datagram, e.g. a batch of commands or their responses
+#define NI_RC_MAX_MESSAGE_SIZE 8192
+
 class LocalCommsInterface
 {
     //todo c++ify (use std::string consequently)
@@ -37,10 +41,12 @@ class LocalCommsInterface
 
 private:
     int sock, msgsock, rval;
+    // written by Wakeup to interrupt a blocking Poll from another thread
+    int wakeupPipe[2];
     struct sockaddr_un server;
     struct sockaddr_un dstaddr;
-    char buf[1024];
-    struct pollfd poll_list[1];
+    char buf[NI_RC_MAX_MESSAGE_SIZE];
+    struct pollfd poll_list[2];
 
 public:
 	void Initialize(std::string name);
@@ -48,6 +54,18 @@ public:
 	std::string GetMessage(int timeout);
 	void SendMessage(std::string message, std::string destination);
 
+	// waits until a message is available, the timeout expired or Wakeup was called,
+	// timeoutNs < 0 waits without timeout, returns true if a message is available
+	bool Poll(int64_t timeoutNs);
+	void Wakeup();
+	// non-blocking receive, returns false if no message is pending. The source is
+	// empty for clients without bound address which can not receive responses.
+	bool ReceiveMessage(std::string* message, std::string* source);
+	// sends to a socket path as returned by ReceiveMessage
+	bool SendData(const void* data, uint32_t size, const std::string& sourcePath);
+	// receives a binary message, returns its size or 0 if none arrived within the timeout
+	uint32_t GetData(uint8_t* data, uint32_t size, int timeout);
+
 };
 
 #endif
@@ -21,254 +21,318 @@
  */
 
 #include "ni-parameter-data-base.h"
+#include "ns3/ni-latency-histogram.h"
 #include "iostream"
 
+//
+// typed parameters
+//
+NiParameterBase::NiParameterBase(ParameterDataBase* pdb, std::string name, bool readOnly)
+  : m_pdb(pdb), m_name(name), m_readOnly(readOnly)
+{
+    pdb->Register(this);
+}
+
+template <typename T>
+bool NiParameter<T>::Set(T value){
+    // written this way to reject NaN as well
+    if (!((value >= m_min) && (value <= m_max))) {
+        return false;
+    }
+    m_value.store(value, std::memory_order_release);
+    // read-only parameters are statistics of the simulator itself, readers do not wait for them
+    if (!IsReadOnly()) {
+        m_pdb->IncrementVersion();
+    }
+    return true;
+}
+
+// string conversion of the supported parameter types, returns false for malformed values
+static bool ParseParameterValue(const std::string& str, int* value){
+    try {
+        size_t pos = 0;
+        *value = std::stoi(str, &pos);
+        return pos == str.size();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+static bool ParseParameterValue(const std::string& str, uint32_t* value){
+    try {
+        size_t pos = 0;
+        const unsigned long long v = std::stoull(str, &pos);
+        *value = (uint32_t) v;
+        return (pos == str.size()) && (str[0] != '-') && (v <= UINT32_MAX);
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+static bool ParseParameterValue(const std::string& str, uint64_t* value){
+    try {
+        size_t pos = 0;
+        *value = std::stoull(str, &pos);
+        return (pos == str.size()) && (str[0] != '-');
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+static bool ParseParameterValue(const std::string& str, bool* value){
+    if ((str == "true") || (str == "1")) {
+        *value = true;
+    } else if ((str == "false") || (str == "0")) {
+        *value = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+static bool ParseParameterValue(const std::string& str, double* value){
+    try {
+        size_t pos = 0;
+        *value = std::stod(str, &pos);
+        return pos == str.size();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+static std::string FormatParameterValue(int value){
+    return std::to_string(value);
+}
+static std::string FormatParameterValue(uint32_t value){
+    return std::to_string(value);
+}
+static std::string FormatParameterValue(uint64_t value){
+    return std::to_string(value);
+}
+static std::string FormatParameterValue(bool value){
+    return value ? "true" : "false";
+}
+static std::string FormatParameterValue(double value){
+    return std::to_string(value);
+}
+
+template <typename T>
+std::string NiParameter<T>::GetString() const{
+    return FormatParameterValue(Get());
+}
 
+template <typename T>
+std::string NiParameter<T>::SetString(std::string value){
+    T v;
+    if (!ParseParameterValue(value, &v)) {
+        return "ERR:INVALID_VALUE";
+    }
+    if (!Set(v)) {
+        std::cout << "ParameterDataBase: ERR:" << GetName() << " value not in range" << std::endl;
+        return "ERR:VALUE_NOT_IN_RANGE";
+    }
+    return value;
+}
+
+template class NiParameter<int>;
+template class NiParameter<uint32_t>;
+template class NiParameter<uint64_t>;
+template class NiParameter<bool>;
+template class NiParameter<double>;
+
+std::string NiStringParameter::Get() const{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_value;
+}
+
+void NiStringParameter::Set(std::string value){
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_value = value;
+    }
+    m_pdb->IncrementVersion();
+}
+
+//
+// parameter registry
+//
+ParameterDataBase::ParameterDataBase()
+  : version(0)
+{
+}
+
+void ParameterDataBase::Register(NiParameterBase* parameter){
+    parameters[parameter->GetName()] = parameter;
+}
+
+NiParameterBase* ParameterDataBase::FindParameter(const std::string& name) const{
+    std::map<std::string, NiParameterBase*>::const_iterator it = parameters.find(name);
+    return (it != parameters.end()) ? it->second : NULL;
+}
+
+void ParameterDataBase::IncrementVersion(){
+    version.fetch_add(1, std::memory_order_acq_rel);
+}
 
 //
 // 1st demo parameter access methods (2 xactual type (int), 2x string)
 //
 void ParameterDataBase::setParameterInt1(int p1){
-    parameterInt1 = p1;
-    return;
+    parameterInt1.Set(p1);
 }
 void ParameterDataBase::setParameterInt1(std::string p1str){
-    parameterInt1 = std::stoi(p1str);
-    return;
+    parameterInt1.SetString(p1str);
 }
 int ParameterDataBase::getParameterInt1(){
-    return parameterInt1;
+    return parameterInt1.Get();
 }
 std::string ParameterDataBase::getStringParamterInt1(){
-    return std::to_string(parameterInt1);
+    return parameterInt1.GetString();
 }
 
 //
 //2nd demo paramter methods (2x string)
 //
 void ParameterDataBase::setParameterString1(std::string str1){
-    parameterString1 = str1;
-    return;
+    parameterString1.Set(str1);
 }
 std::string ParameterDataBase::getParameterString1(){
-    //todo check returning string, what exactly happens, copy, ref type thing?;
-    return parameterString1;
+    return parameterString1.Get();
 }
 
 //
 //ns3 Example Parameter num_PhyTimingInd (transport.cc) (do not set from testman --> no set by string method needed)
 //
 void ParameterDataBase::setParameterNumPhyTimingInd(int pti){
-    parameterNum_PhyTimingInd = pti;
-    //std::cout << "TEST:SetParam: " << pti << "/" << parameterNum_PhyTimingInd << std::endl;
+    parameterNum_PhyTimingInd.Set((uint64_t) pti);
 }
 int ParameterDataBase::getParameterNumPhyTimingInd(){
-    //std::cout << "TEST:GetParam: " << parameterNum_PhyTimingInd << std::endl;
-    return parameterNum_PhyTimingInd;
+    return (int) parameterNum_PhyTimingInd.Get();
 }
 std::string ParameterDataBase::getStringParameterNumPhyTimingInd(){
-    //std::cout << "TEST:GetParam: " << parameterNum_PhyTimingInd << " / " << std::to_string(parameterNum_PhyTimingInd) << std::endl;
-    return std::to_string(parameterNum_PhyTimingInd);
+    return parameterNum_PhyTimingInd.GetString();
 }
 
 //
 //ns3 Example Parameter for activating Loggin of phy timing indication
 //
 void ParameterDataBase::setParameterLogPhyTimingInd(std::string lptiStr){
-    if (lptiStr == "true") {
-        parameterLog_PhyTimingInd = true;
-    } else {
-        parameterLog_PhyTimingInd = false;
-    }
+    parameterLog_PhyTimingInd.SetString(lptiStr);
 }
 bool ParameterDataBase::getParameterLogPhyTimingInd(){
-    //std::cout << "TEST:GetParam: " << parameterLog_PhyTimingInd << std::endl;
-    return parameterLog_PhyTimingInd;
+    return parameterLog_PhyTimingInd.Get();
 }
 std::string ParameterDataBase::getStringParameterLogPhyTimingInd(){
-    if (parameterLog_PhyTimingInd) {
-        return "true";
-    } else {
-        return "false";
-    }
+    return parameterLog_PhyTimingInd.GetString();
 }
 
 //ns3 example for implementing lwa/lwip decision varaibles --LWA
 void ParameterDataBase::setParameterLwaDecVariable(uint32_t p1) {
-  // 0, 1, 2
-  // otherwise throw error message
-  if (p1 <= 2)
-    {
-      lwaDecisionVariable = p1;
-    }
-  else
-    {
-      std::cout << "ParameterDataBase::setParameterLwaDecVariable: ERR:LWA value not in range" << std::endl;
-    }
+  lwaDecisionVariable.Set(p1);
 }
 
 std::string ParameterDataBase::setParameterLwaDecVariable(std::string p1str) {
-  // 0, 1, 2
-  // otherwise throw error message
-  std::string ret = p1str;
-  if (p1str == "1") {
-      lwaDecisionVariable = 1;
-  } else if (p1str == "2") {
-      lwaDecisionVariable = 2;
-  } else if (p1str == "0") {
-      lwaDecisionVariable = 0;
-  } else {
-      std::cout << "ParameterDataBase::setParameterLwaDecVariable: ERR:LWA value not in range" << std::endl;
-      ret = "ERR:LWA value not in range";
-  }
-  return ret;
+  return lwaDecisionVariable.SetString(p1str);
 }
 
 uint32_t ParameterDataBase::getParameterLwaDecVariable(){
- 	return lwaDecisionVariable;
+  return lwaDecisionVariable.Get();
 }
 
 std::string ParameterDataBase::getStringParameterLwaDecVariable(){
-  return std::to_string(lwaDecisionVariable);
+  return lwaDecisionVariable.GetString();
 }
 
 //ns3 example for implementing lwa/lwip decision varaibles --LWIP
 void ParameterDataBase::setParameterLwipDecVariable(uint32_t p2) {
-  // 0, 1
-  // otherwise throw error message
-  if (p2 <= 1)
-    {
-      lwipDecisionVariable = p2;
-    }
-  else
-    {
-      std::cout << "ParameterDataBase::setParameterLwipDecVariable: ERR:LWIP value not in range" << std::endl;
-    }
+  lwipDecisionVariable.Set(p2);
 }
 
 std::string ParameterDataBase::setParameterLwipDecVariable(std::string p2str) {
-  // 0, 1
-  // otherwise throw error message
-  std::string ret = p2str;
-  if (p2str == "1") {
-      lwipDecisionVariable = 1;
-  } else if (p2str == "0") {
-      lwipDecisionVariable = 0;
-  } else {
-      ret= "ERR:LWIP value not in range";
-  }
-  return ret;
+  return lwipDecisionVariable.SetString(p2str);
 }
 
 uint32_t ParameterDataBase::getParameterLwipDecVariable(){
-	return lwipDecisionVariable;
+  return lwipDecisionVariable.Get();
 }
 
 std::string ParameterDataBase::getStringParameterLwipDecVariable(){
-  return std::to_string(lwipDecisionVariable);
+  return lwipDecisionVariable.GetString();
 }
 
-
 //ns3 enable manual UE Channel Sinr
 void ParameterDataBase::setParameterManualLteUeChannelSinrEnable(bool enable) {
-  manualLteUeChannelSinrEnable = enable;
+  manualLteUeChannelSinrEnable.Set(enable);
 }
 
 std::string ParameterDataBase::setParameterManualLteUeChannelSinrEnable(std::string enableStr) {
-  if (enableStr == "true") {
-      manualLteUeChannelSinrEnable = true;
-  } else {
-      manualLteUeChannelSinrEnable = false;
-  }
-  return enableStr;
+  return manualLteUeChannelSinrEnable.SetString(enableStr);
 }
 
 bool ParameterDataBase::getParameterManualLteUeChannelSinrEnable(void){
-  return manualLteUeChannelSinrEnable;
+  return manualLteUeChannelSinrEnable.Get();
 }
 
 std::string ParameterDataBase::getStringParameterManualLteUeChannelSinrEnable(void){
-  if (manualLteUeChannelSinrEnable) {
-      return "true";
-  } else {
-      return "false";
-  }
+  return manualLteUeChannelSinrEnable.GetString();
 }
 
 //ns3 UE Channel Sinr
 void ParameterDataBase::setParameterLteUeChannelSinr(double sinr) {
-  // range check?
-  lteUeChannelSinr = sinr;
+  lteUeChannelSinr.Set(sinr);
 }
 
 std::string ParameterDataBase::setParameterLteUeChannelSinr(std::string sinrStr) {
-  // range check?
-  lteUeChannelSinr = std::stod(sinrStr);
-  return sinrStr;
+  return lteUeChannelSinr.SetString(sinrStr);
 }
 
 double ParameterDataBase::getParameterLteUeChannelSinr(){
-  return lteUeChannelSinr;
+  return lteUeChannelSinr.Get();
 }
 
 std::string ParameterDataBase::getStringParameterLteUeChannelSinr(){
-  return std::to_string(lteUeChannelSinr);
+  return lteUeChannelSinr.GetString();
 }
 
 std::string ParameterDataBase::getParameterByName(std::string pname){
 
   std::string response = "";
-  //std::cout << "TEMP CMD FEEDBACK: " << pname << std::endl;
 
   if (pname.empty()) {
       response = "ERR:EMPTY_VARIABLE_NAME";
-  } else if (pname == "ParameterInt1") {
-      response = getStringParamterInt1();
-  } else if (pname == "ParameterString1") {
-      response = getParameterString1();
-  } else if (pname == "num_PhyTimingInd") {
-      response = getStringParameterNumPhyTimingInd();
-  } else if (pname == "log_PhyTimingInd") {
-      response = getStringParameterLogPhyTimingInd();
-  } else if (pname == "ParameterLwaDecVariable") {
-      response = getStringParameterLwaDecVariable();
-  } else if (pname == "ParameterLwipDecVariable") {
-      response = getStringParameterLwipDecVariable();
-  } else if (pname == "ParameterManualLteUeChannelSinrEnable") {
-      response = getStringParameterManualLteUeChannelSinrEnable();
-  } else if (pname == "ParameterLteUeChannelSinr") {
-      response = getStringParameterLteUeChannelSinr();
+  } else if (pname.compare(0, 8, "latency_") == 0) {
+      response = getStringParameterLatency(pname.substr(8));
   } else {
-      response = "ERR:UNKOWN_PARAMETER";
+      NiParameterBase* parameter = FindParameter(pname);
+      if (parameter != NULL) {
+          response = parameter->GetString();
+      } else {
+          response = "ERR:UNKOWN_PARAMETER";
+      }
   }
   return response;
 }
 
+// percentiles of the latency histogram of a real-time loop stage, e.g. "latency_PipeWrite"
+std::string ParameterDataBase::getStringParameterLatency(std::string stageName){
+  for (uint32_t s = 0; s < ns3::NI_LATENCY_NUM_STAGES; s++) {
+      if (stageName == ns3::NiLatencyHistograms::GetStageName((ns3::NiLatencyStage) s)) {
+          return ns3::g_NiLatency.GetSnapshot((ns3::NiLatencyStage) s).ToString();
+      }
+  }
+  return "ERR:UNKOWN_PARAMETER";
+}
+
 std::string ParameterDataBase::setParameterByName(std::string pname, std::string pvalue) {
-  //todo consider merging abfarge which param to once only
-  //maybe: preprocessor makro: both makro definition lead to same function but with differen parameters (first compare param, then if read/write)
   std::string response = pvalue;
 
   if (pname.empty() || pvalue.empty() ) {
       response = "ERR:EMPTY_NAME_OR_VALUE";
-  } else if (pname == "ParameterInt1") {
-      setParameterInt1(pvalue); //todo for all setters need error checking!
-  } else if (pname == "ParameterString1") {
-      setParameterString1(pvalue);
-  } else if (pname == "num_PhyTimingInd") {
-      response = "ERR:ONLY_READ_ACCESIBLE";
-  } else if (pname == "log_PhyTimingInd") {
-      setParameterLogPhyTimingInd(pvalue);
-  } else if (pname == "ParameterLwaDecVariable") {
-      response = setParameterLwaDecVariable(pvalue);
-  } else if (pname == "ParameterLwipDecVariable") {
-      response = setParameterLwipDecVariable(pvalue);
-  } else if (pname == "ParameterManualLteUeChannelSinrEnable") {
-      response = setParameterManualLteUeChannelSinrEnable(pvalue);
-  } else if (pname == "ParameterLteUeChannelSinr") {
-      response = setParameterLteUeChannelSinr(pvalue);
   } else {
-      response = "ERR_UNKOWN_PARAMETER"; //TODO-NI: change to ERR:UNKOWN_PARAMETER
+      NiParameterBase* parameter = FindParameter(pname);
+      if (parameter == NULL) {
+          response = "ERR_UNKOWN_PARAMETER"; //TODO-NI: change to ERR:UNKOWN_PARAMETER
+      } else if (parameter->IsReadOnly()) {
+          response = "ERR:ONLY_READ_ACCESIBLE";
+      } else {
+          response = parameter->SetString(pvalue);
+      }
   }
 
   return response;
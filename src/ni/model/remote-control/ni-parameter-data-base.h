@@ -24,21 +24,138 @@
 #define PARAMETER_DATA_BASE_H
 
 #include <string>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <stdint.h>
+
+class ParameterDataBase;
+
+// Type independent part of a remote control parameter, used by the data base
+// to serve READ / WRITE requests by name.
+class NiParameterBase
+{
+public:
+    // registers the parameter in the data base under its name
+    NiParameterBase(ParameterDataBase* pdb, std::string name, bool readOnly);
+    virtual ~NiParameterBase() {}
+
+    const std::string& GetName() const { return m_name; }
+    bool IsReadOnly() const { return m_readOnly; }
+
+    virtual std::string GetString() const = 0;
+    // value streamed in telemetry frames, only valid for numeric parameters
+    virtual bool IsNumeric() const { return true; }
+    virtual double GetNumber() const = 0;
+    // returns the value on success, otherwise an "ERR:..." response
+    virtual std::string SetString(std::string value) = 0;
+
+protected:
+    ParameterDataBase* m_pdb;
+
+private:
+    NiParameterBase(const NiParameterBase&);
+    NiParameterBase& operator=(const NiParameterBase&);
+
+    std::string m_name;
+    bool m_readOnly;
+};
+
+// Parameter of scalar type T stored in an atomic, so that the simulator thread
+// can read it without a lock while the remote control thread writes it. Values
+// outside of [min, max] are rejected. Every write of a writable parameter
+// increments the version of the data base.
+template <typename T>
+class NiParameter : public NiParameterBase
+{
+public:
+    NiParameter(ParameterDataBase* pdb, std::string name, T defaultValue, T min, T max, bool readOnly = false)
+      : NiParameterBase(pdb, name, readOnly), m_value(defaultValue), m_min(min), m_max(max)
+    {
+    }
+
+    T Get() const { return m_value.load(std::memory_order_acquire); }
+    // returns false if the value is out of range
+    bool Set(T value);
+    // for statistics with a single writer thread, not an atomic read-modify-write
+    void Increment(T delta) { Set(Get() + delta); }
+
+    virtual std::string GetString() const;
+    virtual std::string SetString(std::string value);
+    virtual double GetNumber() const { return (double) Get(); }
+
+private:
+    std::atomic<T> m_value;
+    T m_min;
+    T m_max;
+};
+
+// String parameters are not used by real-time paths and are guarded by a lock.
+class NiStringParameter : public NiParameterBase
+{
+public:
+    NiStringParameter(ParameterDataBase* pdb, std::string name, std::string defaultValue)
+      : NiParameterBase(pdb, name, false), m_value(defaultValue)
+    {
+    }
+
+    std::string Get() const;
+    void Set(std::string value);
+
+    virtual std::string GetString() const { return Get(); }
+    virtual std::string SetString(std::string value) { Set(value); return value; }
+    virtual bool IsNumeric() const { return false; }
+    virtual double GetNumber() const { return 0.0; }
+
+private:
+    mutable std::mutex m_lock;
+    std::string m_value;
+};
 
 class ParameterDataBase
 {
 private:
-    int parameterInt1;
-    std::string parameterString1;
-    int parameterNum_PhyTimingInd;
-    bool parameterLog_PhyTimingInd;
-    uint32_t lwaDecisionVariable;
-    uint32_t lwipDecisionVariable;
-    bool manualLteUeChannelSinrEnable;
-    double lteUeChannelSinr;
+    friend class NiParameterBase;
+    template <typename T> friend class NiParameter;
+    friend class NiStringParameter;
 
+    ParameterDataBase(const ParameterDataBase&);
+    ParameterDataBase& operator=(const ParameterDataBase&);
+
+    void Register(NiParameterBase* parameter);
+    void IncrementVersion();
+
+    std::map<std::string, NiParameterBase*> parameters;
+    std::atomic<uint64_t> version;
 
 public:
+    ParameterDataBase();
+
+    // Incremented on every write of a writable parameter. Real-time paths keep
+    // the version of their last read and only re-read parameters after it changed.
+    uint64_t GetVersion() const { return version.load(std::memory_order_acquire); }
+    // returns NULL for unknown parameters
+    NiParameterBase* FindParameter(const std::string& name) const;
+
+    // Parameters register themselves in declaration order. Adding a parameter
+    // only requires a member here, READ / WRITE by name work without further code.
+    NiParameter<int> parameterInt1{this, "ParameterInt1", 0, INT32_MIN, INT32_MAX};
+    NiStringParameter parameterString1{this, "ParameterString1", ""};
+    // statistics published by the simulator, not writable via remote control
+    NiParameter<uint64_t> parameterNum_PhyTimingInd{this, "num_PhyTimingInd", 0, 0, UINT64_MAX, true};
+    NiParameter<uint64_t> numPhyCnfSuccess{this, "num_PhyCnfSuccess", 0, 0, UINT64_MAX, true};
+    NiParameter<uint64_t> numPhyCnfError{this, "num_PhyCnfError", 0, 0, UINT64_MAX, true};
+    NiParameter<double> lteChannelSinrStat{this, "stat_LteChannelSinr", 0.0, -1000.0, 1000.0, true};
+    NiParameter<uint64_t> numPdcpTxBytes{this, "num_PdcpTxBytes", 0, 0, UINT64_MAX, true};
+    NiParameter<uint32_t> lteDeadlineLevel{this, "stat_LteDeadlineLevel", 0, 0, UINT32_MAX, true};
+    NiParameter<uint64_t> numLteDeadlineMiss{this, "num_LteDeadlineMiss", 0, 0, UINT64_MAX, true};
+    NiParameter<bool> parameterLog_PhyTimingInd{this, "log_PhyTimingInd", false, false, true};
+    // 0: LTE only, 1: split between LTE and LWA, 2: LWA only
+    NiParameter<uint32_t> lwaDecisionVariable{this, "ParameterLwaDecVariable", 0, 0, 2};
+    // 0: LTE only, 1: LWIP only
+    NiParameter<uint32_t> lwipDecisionVariable{this, "ParameterLwipDecVariable", 0, 0, 1};
+    NiParameter<bool> manualLteUeChannelSinrEnable{this, "ParameterManualLteUeChannelSinrEnable", false, false, true};
+    NiParameter<double> lteUeChannelSinr{this, "ParameterLteUeChannelSinr", 0.0, -1000.0, 1000.0};
 
 	void setParameterInt1(int p1);
 	void setParameterInt1(std::string p1str);
@@ -79,6 +196,8 @@ public:
 	double getParameterLteUeChannelSinr();
 	std::string getStringParameterLteUeChannelSinr();
 
+	std::string getStringParameterLatency(std::string stageName);
+
 };
 
 #endif
@@ -23,6 +23,7 @@
 #include "ni-remote-control-engine.h"
 #include "ns3/ni-utils.h"
 #include <unistd.h>
+#include <string.h>
 
 //instatntiate global variable
 RemoteControlEngine g_RemoteControlEngine;
@@ -31,6 +32,10 @@ RemoteControlEngine::RemoteControlEngine() {
         instance_name = "";
         timeout = 1000;
         stop = false;
+        lastSubscriptionId = 0;
+        for (uint32_t i = 0; i < NI_RC_MAX_SUBSCRIPTIONS; i++) {
+            subscriptions[i].id = 0;
+        }
     }
 
 void RemoteControlEngine::Initialize(std::string name, int tmout, int remoteControlThreadPriority)
@@ -38,6 +43,9 @@ void RemoteControlEngine::Initialize(std::string name, int tmout, int remoteCont
     instance_name = name;
     timeout = tmout;
     remoteControlInterfaceThreadPriority = remoteControlThreadPriority;
+    // bound before the thread starts, so that commands can be sent right after Initialize
+    // and Deinitialize can always wake up the thread
+    lci.Initialize(instance_name);
     //Spawn Thread
     pthread_create(&t, NULL, &RemoteControlEngine::ThreadHelper, this);
     //int status = pthread_create(&t, NULL, &RemoteControlEngine::ThreadHelper, this);
@@ -58,6 +66,7 @@ ParameterDataBase *RemoteControlEngine::GetPdb(){
 
 void RemoteControlEngine::Deinitialize(){
     stop = true;
+    lci.Wakeup();
     pthread_join(t, NULL);
 }
 
@@ -68,68 +77,189 @@ void *RemoteControlEngine::RemoteControlInterfaceThread(void)
     ns3::NiUtils::AddThreadInfo (pthread_self(), "NiRemoteControlEngine thread");
     //std::cout << "NI.RC: remote-control thread with id:" <<  pthread_self() << " started" << std::endl;
 
-    //todo consider restructuring and cleanup
-    //LocalCommsInterface lci;
-    //ParameterDataBase pdb;
-    lci.Initialize(instance_name);
-    std::string temp_buf;
+    std::string message;
+    std::string client;
     //todo consider not hardcoding names and further review naming convention as such (could encounter this issue a couple more time)
-    std::string destination = "rc-srv-local";
+    const std::string destination = "rc-srv-local";
 
-    //todo eval if possibility needed to cancel thread?
+    int64_t nextFrameNs = -1;
     while (stop==false) {
-        //todo return value of get message must indicate if valid or not
-        //todo or need a "data_avail" method
-        temp_buf = lci.GetMessage(timeout);
-        
-        //here starts command handler!
-        if(temp_buf.empty())
-        {
-            ;  //No message received at all, do nothing
-        } else {
-            //todo: "handleStringCommand(temp_buf);""
-
-            //First Command Level (Tier 1)
-
-            // todo more hierarchical and structured command processing by tree/level based environment calls
-            std::stringstream ss(temp_buf);
-            std::string token;
-            std::getline(ss,token,':');
-            //std::cout << "command (tier 1) token: " << token << std::endl;
-            // // Tier 1 if-else ladder
-            std::string response = "";
-            if (token.empty()) {
-                response = "ERR:EMPTY_COMMAND";
-            } else if (token == "READ") {
-                std::string pname = "";
-                std::getline(ss, pname, ':');
-                response = pdb.getParameterByName(pname);
-            } else if (token == "WRITE") {
-                std::string pname = "";
-                std::string pvalue = "";
-                std::getline(ss, pname, ':');
-                std::getline(ss, pvalue, ':');
-                response = pdb.setParameterByName(pname, pvalue);
-            } else {
-                response = "ERR:UNKNOWN_COMMAND";
+        // blocks until a command arrives, the next telemetry frame is due or Deinitialize wakes it up
+        const int64_t timeoutNs = (nextFrameNs >= 0) ? nextFrameNs : (int64_t) timeout * 1000000LL;
+        if (lci.Poll(timeoutNs)) {
+            // handle all pending datagrams before the next poll
+            while (lci.ReceiveMessage(&message, &client)) {
+                std::stringstream commands(message);
+                std::string command;
+                std::string response = "";
+                bool first = true;
+                while (std::getline(commands, command, ';')) {
+                    if (!first) {
+                        response += ";";
+                    }
+                    response += HandleCommand(command, client);
+                    first = false;
+                }
+                if (first) {
+                    response = "ERR:EMPTY_COMMAND";
+                }
+                if (client.empty()) {
+                    lci.SendMessage(response, destination);
+                } else {
+                    lci.SendData(response.data(), response.size(), client);
+                }
             }
+        }
+        nextFrameNs = SendTelemetryFrames(ns3::NiUtils::GetSysTimeNs());
+    }
 
-            //std::cout << response << std::endl;
-            lci.SendMessage (response, destination);
+    lci.Close();
+    ns3::NiUtils::RemoveThreadInfo (pthread_self());
 
+    return 0;
+}
 
+std::string RemoteControlEngine::HandleCommand(const std::string& command, const std::string& client)
+{
+    //First Command Level (Tier 1)
+    std::stringstream ss(command);
+    std::string token;
+    std::getline(ss,token,':');
+    // Tier 1 if-else ladder
+    std::string response = "";
+    if (token.empty()) {
+        response = "ERR:EMPTY_COMMAND";
+    } else if (token == "READ") {
+        std::string pname = "";
+        std::getline(ss, pname, ':');
+        response = pdb.getParameterByName(pname);
+    } else if (token == "WRITE") {
+        std::string pname = "";
+        std::string pvalue = "";
+        std::getline(ss, pname, ':');
+        std::getline(ss, pvalue, ':');
+        response = pdb.setParameterByName(pname, pvalue);
+    } else if (token == "SUBSCRIBE") {
+        response = Subscribe(ss, client);
+    } else if (token == "UNSUBSCRIBE") {
+        response = Unsubscribe(ss);
+    } else {
+        response = "ERR:UNKNOWN_COMMAND";
+    }
+    return response;
+}
 
+std::string RemoteControlEngine::Subscribe(std::stringstream& ss, const std::string& client)
+{
+    if (client.empty()) {
+        // frames can only be sent to a bound socket
+        return "ERR:UNBOUND_CLIENT";
+    }
+    std::string periodStr = "";
+    std::string names = "";
+    std::getline(ss, periodStr, ':');
+    std::getline(ss, names, ':');
+    uint32_t periodMs = 0;
+    try {
+        periodMs = std::stoul(periodStr);
+    } catch (const std::exception&) {
+        periodMs = 0;
+    }
+    if (periodMs == 0) {
+        return "ERR:INVALID_PERIOD";
+    }
 
+    NiRcSubscription* pSubscription = NULL;
+    for (uint32_t i = 0; i < NI_RC_MAX_SUBSCRIPTIONS; i++) {
+        if (subscriptions[i].id == 0) {
+            pSubscription = &subscriptions[i];
+            break;
         }
+    }
+    if (pSubscription == NULL) {
+        return "ERR:TOO_MANY_SUBSCRIPTIONS";
+    }
 
-        //todo DELET THIS: use timeout in poll() instead or blocking poll() at all
-        usleep(1000000);
-
+    std::vector<NiParameterBase*> parameters;
+    std::stringstream nameList(names);
+    std::string name;
+    while (std::getline(nameList, name, ',')) {
+        NiParameterBase* parameter = pdb.FindParameter(name);
+        if (parameter == NULL) {
+            return "ERR:UNKOWN_PARAMETER";
+        }
+        if (!parameter->IsNumeric()) {
+            return "ERR:NOT_NUMERIC";
+        }
+        parameters.push_back(parameter);
+    }
+    if (parameters.empty() || parameters.size() > NI_RC_MAX_SUBSCRIBED_VALUES) {
+        return "ERR:INVALID_NUMBER_OF_PARAMETERS";
     }
 
+    // ids are never 0 and not reused until 255 further subscriptions were made
+    do {
+        lastSubscriptionId++;
+    } while (lastSubscriptionId == 0);
+    pSubscription->id = lastSubscriptionId;
+    pSubscription->client = client;
+    pSubscription->periodNs = (uint64_t) periodMs * 1000000ULL;
+    pSubscription->nextFrameNs = ns3::NiUtils::GetSysTimeNs();
+    pSubscription->seqNum = 0;
+    pSubscription->parameters = parameters;
+    return "OK:" + std::to_string(pSubscription->id);
+}
 
+std::string RemoteControlEngine::Unsubscribe(std::stringstream& ss)
+{
+    std::string idStr = "";
+    std::getline(ss, idStr, ':');
+    for (uint32_t i = 0; i < NI_RC_MAX_SUBSCRIPTIONS; i++) {
+        if ((subscriptions[i].id != 0) && (idStr == std::to_string(subscriptions[i].id))) {
+            subscriptions[i].id = 0;
+            subscriptions[i].parameters.clear();
+            return "OK";
+        }
+    }
+    return "ERR:UNKNOWN_SUBSCRIPTION";
+}
 
-    return 0;
+int64_t RemoteControlEngine::SendTelemetryFrames(uint64_t nowNs)
+{
+    uint8_t frame[sizeof(NiRcTelemetryFrameHeader) + NI_RC_MAX_SUBSCRIBED_VALUES * sizeof(double)];
+    int64_t nextFrameNs = -1;
+    for (uint32_t i = 0; i < NI_RC_MAX_SUBSCRIPTIONS; i++) {
+        NiRcSubscription& subscription = subscriptions[i];
+        if (subscription.id == 0) {
+            continue;
+        }
+        if (subscription.nextFrameNs <= nowNs) {
+            NiRcTelemetryFrameHeader header;
+            header.magic = NI_RC_TELEMETRY_MAGIC;
+            header.version = NI_RC_TELEMETRY_VERSION;
+            header.subscriptionId = subscription.id;
+            header.numValues = subscription.parameters.size();
+            header.seqNum = subscription.seqNum++;
+            header.sysTimeNs = nowNs;
+            memcpy(frame, &header, sizeof(header));
+            double* pValues = (double*) (frame + sizeof(header));
+            for (uint32_t v = 0; v < header.numValues; v++) {
+                pValues[v] = subscription.parameters[v]->GetNumber();
+            }
+            // a frame which can not be sent is dropped, the subscriber sees the gap in seqNum
+            lci.SendData(frame, sizeof(header) + header.numValues * sizeof(double), subscription.client);
+            subscription.nextFrameNs += subscription.periodNs;
+            // do not send bursts of frames to catch up after a stall
+            if (subscription.nextFrameNs <= nowNs) {
+                subscription.nextFrameNs = nowNs + subscription.periodNs;
+            }
+        }
+        const int64_t untilNextFrameNs = subscription.nextFrameNs - nowNs;
+        if ((nextFrameNs < 0) || (untilNextFrameNs < nextFrameNs)) {
+            nextFrameNs = untilNextFrameNs;
+        }
+    }
+    return nextFrameNs;
 }
 
 //CAREFUL: ThreadHelper is defined as static  member function in class definition (header), although "static" keyword is left out here
@@ -29,6 +29,44 @@
 #include <iostream>
 #include <vector>
 #include <sstream>
+#include <atomic>
+
+// Commands are text datagrams, several commands of one datagram are separated by ';'
+// and answered in order by one datagram with the responses separated by ';':
+//   READ:<parameter>
+//   WRITE:<parameter>:<value>
+//   SUBSCRIBE:<period ms>:<parameter>,<parameter>,...  -> OK:<subscription id>
+//   UNSUBSCRIBE:<subscription id>                      -> OK
+// A subscription streams the numerical values of the parameters to the bound socket
+// of the subscriber in binary telemetry frames, one per period.
+
+#define NI_RC_MAX_SUBSCRIPTIONS      8
+#define NI_RC_MAX_SUBSCRIBED_VALUES  32
+#define NI_RC_TELEMETRY_MAGIC        0x00  // text responses never start with a zero byte
+#define NI_RC_TELEMETRY_VERSION      1
+
+// header of a telemetry frame in host byte order, followed by numValues doubles
+// in the order of the parameters given with SUBSCRIBE
+struct NiRcTelemetryFrameHeader
+{
+    uint8_t  magic;
+    uint8_t  version;
+    uint8_t  subscriptionId;
+    uint8_t  numValues;
+    uint32_t seqNum;     // per subscription, gaps indicate dropped frames
+    uint64_t sysTimeNs;  // time the values were read
+};
+static_assert(sizeof(NiRcTelemetryFrameHeader) == 16, "telemetry frame header is part of the wire format");
+
+struct NiRcSubscription
+{
+    uint8_t id;           // 0 = unused
+    std::string client;   // socket path of the subscriber
+    uint64_t periodNs;
+    uint64_t nextFrameNs;
+    uint32_t seqNum;
+    std::vector<NiParameterBase*> parameters;
+};
 
 class RemoteControlEngine
 {
@@ -36,14 +74,22 @@ private:
     pthread_t t;
     std::string instance_name;
     int timeout;
-    bool stop;
+    std::atomic<bool> stop;
     LocalCommsInterface lci;
     ParameterDataBase pdb;
     int remoteControlInterfaceThreadPriority;
+    NiRcSubscription subscriptions[NI_RC_MAX_SUBSCRIPTIONS];
+    uint8_t lastSubscriptionId;
 
     void *RemoteControlInterfaceThread(void);
     static void *ThreadHelper(void *context);
 
+    std::string HandleCommand(const std::string& command, const std::string& client);
+    std::string Subscribe(std::stringstream& ss, const std::string& client);
+    std::string Unsubscribe(std::stringstream& ss);
+    // sends the frames which are due and returns the time until the next one in ns, -1 if none
+    int64_t SendTelemetryFrames(uint64_t nowNs);
+
 public:
     RemoteControlEngine();
     void Initialize(std::string name, int tmout, int remoteControlThreadPriority);
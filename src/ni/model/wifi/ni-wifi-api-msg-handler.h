@@ -26,6 +26,10 @@
 
 #include "ns3/ni-wifi-api-msg-types.h"   // NIAPI message definitions
 
+// encoded sizes of the TX requests of the MAC high
+#define TX_CONFIG_REQ_SIZE          69  // general + sub message header, MSDU TX params, PHY TX params
+#define TX_PAYLOAD_REQ_HDR_SIZE     24  // general + sub message header, MSDU TX payload without MSDU data
+
 #ifdef __cplusplus
 extern "C"{
 #endif
@@ -86,6 +90,30 @@ int32_t DeserializeMessage(
   uint32_t*           p_bufferOffset
 );
 
+// Single-pass encoders of the TX requests writing the same bytes as SerializeMessage
+// with the static parameters used by the MAC high, but without the U32 message structs.
+// MAC addresses are passed as U8[6]. Both return the number of bytes written.
+uint32_t EncodeTxConfigReq(
+  uint8_t*        p_buffer,
+  uint32_t        instId,
+  uint32_t        frameType,
+  uint32_t        subType,
+  uint32_t        toDs,
+  uint32_t        fromDs,
+  const uint8_t*  p_destAddr,
+  const uint8_t*  p_sourceAddr,
+  const uint8_t*  p_bssid,
+  uint32_t        msduLength,
+  uint32_t        mcs
+);
+
+// the MSDU data of msduLength bytes has to be written by the caller behind the returned offset
+uint32_t EncodeTxPayloadReqHdr(
+  uint8_t*  p_buffer,
+  uint32_t  instId,
+  uint32_t  msduLength
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,6 +6,21 @@
 // An essential include is test.h
 #include "ns3/test.h"
 
+#include <cstring>
+#include <random>
+#include <vector>
+#include <thread>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <signal.h>
+#include "ns3/ni-l1-l2-api-common-handler.h"
+#include "ns3/ni-l1-l2-api-lte-handler.h"
+#include "ns3/ni-l1-l2-api-lte-codec.h"
+#include "ns3/ni-pipe-reactor.h"
+#include "ns3/ni-lte-phy-emulator.h"
+
 // Do not put your test classes in namespace ns3.  You may find it useful
 // to use the using directive to access the ns3 namespace directly
 using namespace ns3;
@@ -46,6 +61,1463 @@ NiTestCase1::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+// The rx PDU ring has to drop on a full ring, keep the order across the wrap
+// around of its indices and hand over everything queued as one batch, also
+// with producer and consumer in different threads.
+class NiSpscRingTestCase : public TestCase
+{
+public:
+  NiSpscRingTestCase ();
+  virtual ~NiSpscRingTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiSpscRingTestCase::NiSpscRingTestCase ()
+  : TestCase ("SPSC ring drops when full, wraps around and drains in batches")
+{
+}
+
+NiSpscRingTestCase::~NiSpscRingTestCase ()
+{
+}
+
+static void
+NiSpscRingProduce (NiSpscRing<uint32_t>* pRing, uint32_t numValues)
+{
+  for (uint32_t i = 0; i < numValues; )
+    {
+      uint32_t* pSlot = pRing->GetWriteSlot ();
+      if (pSlot == NULL)
+        {
+          std::this_thread::yield ();
+          continue;
+        }
+      *pSlot = i++;
+      pRing->CommitWrite ();
+    }
+}
+
+void
+NiSpscRingTestCase::DoRun (void)
+{
+  // full ring - capacity is rounded up to a power of two
+  NiSpscRing<uint32_t> ring (5);
+  NS_TEST_ASSERT_MSG_EQ (ring.GetCapacity (), 8, "capacity not rounded up");
+  NS_TEST_ASSERT_MSG_EQ ((ring.GetReadSlot () == NULL), true, "empty ring returned a slot");
+  for (uint32_t i = 0; i < ring.GetCapacity (); i++)
+    {
+      uint32_t* pSlot = ring.GetWriteSlot ();
+      NS_TEST_ASSERT_MSG_NE ((pSlot == NULL), true, "ring full before its capacity");
+      *pSlot = i;
+      ring.CommitWrite ();
+    }
+  NS_TEST_ASSERT_MSG_EQ ((ring.GetWriteSlot () == NULL), true, "full ring returned a slot");
+  NS_TEST_ASSERT_MSG_EQ (ring.GetNumDropped (), 1, "drop on full ring not counted");
+  NS_TEST_ASSERT_MSG_EQ (ring.GetMaxDepth (), ring.GetCapacity (), "wrong max depth");
+
+  // batch drain of everything queued, as NiProcessRxPduQueue does
+  const uint32_t batchSize = ring.GetDepth ();
+  NS_TEST_ASSERT_MSG_EQ (batchSize, ring.GetCapacity (), "wrong depth of full ring");
+  for (uint32_t i = 0; i < batchSize; i++)
+    {
+      uint32_t* pSlot = ring.GetReadSlot ();
+      NS_TEST_ASSERT_MSG_NE ((pSlot == NULL), true, "queued element missing");
+      NS_TEST_ASSERT_MSG_EQ (*pSlot, i, "batch out of order");
+      ring.CommitRead ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (ring.GetDepth (), 0, "ring not empty after batch");
+
+  // wrap around - the slot index runs over the end of the ring many times
+  uint32_t next = 0;
+  for (uint32_t round = 0; round < 100; round++)
+    {
+      for (uint32_t i = 0; i < 3; i++)
+        {
+          *ring.GetWriteSlot () = 1000 + round * 3 + i;
+          ring.CommitWrite ();
+        }
+      while (ring.GetReadSlot () != NULL)
+        {
+          NS_TEST_ASSERT_MSG_EQ (*ring.GetReadSlot (), 1000 + next, "wrong element after wrap around");
+          ring.CommitRead ();
+          next++;
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (next, 300, "elements lost after wrap around");
+  NS_TEST_ASSERT_MSG_EQ (ring.GetNumPushed (), ring.GetNumPopped (), "pushed and popped differ");
+
+  // producer thread, batches drained by this thread
+  const uint32_t numValues = 100000;
+  NiSpscRing<uint32_t> threadRing (64);
+  std::thread producer (NiSpscRingProduce, &threadRing, numValues);
+  uint32_t expected = 0;
+  bool inOrder = true;
+  while (expected < numValues)
+    {
+      const uint32_t depth = threadRing.GetDepth ();
+      for (uint32_t i = 0; i < depth; i++)
+        {
+          uint32_t* pSlot = threadRing.GetReadSlot ();
+          inOrder &= (pSlot != NULL) && (*pSlot == expected);
+          threadRing.CommitRead ();
+          expected++;
+        }
+      if (depth == 0)
+        {
+          std::this_thread::yield ();
+        }
+    }
+  producer.join ();
+  NS_TEST_ASSERT_MSG_EQ (inOrder, true, "values lost or reordered between threads");
+  NS_TEST_ASSERT_MSG_EQ (threadRing.GetNumPopped (), numValues, "wrong number of values read");
+  NS_TEST_ASSERT_MSG_EQ (threadRing.GetDepth (), 0, "values left in the ring");
+}
+
+// Messages written to the shared memory ring have to be read back complete,
+// also when they span the end of the data area, and a full ring must not
+// accept a message. Attach must give up if the ring is never created or if
+// its data size does not fit into the file.
+class NiShmRingTestCase : public TestCase
+{
+public:
+  NiShmRingTestCase ();
+  virtual ~NiShmRingTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiShmRingTestCase::NiShmRingTestCase ()
+  : TestCase ("Shared memory ring wraps around and rejects messages when full")
+{
+}
+
+NiShmRingTestCase::~NiShmRingTestCase ()
+{
+}
+
+// message framed by the general message header, body length in bytes 5-7
+static std::vector<uint8_t>
+NiShmRingTestMsg (uint32_t len, uint8_t fill)
+{
+  std::vector<uint8_t> msg (len, fill);
+  const uint32_t bodyLength = len - 8;
+  msg[5] = (bodyLength >> 16) & 0xFF;
+  msg[6] = (bodyLength >> 8) & 0xFF;
+  msg[7] = bodyLength & 0xFF;
+  for (uint32_t i = 8; i < len; i++)
+    {
+      msg[i] = fill + i;
+    }
+  return msg;
+}
+
+void
+NiShmRingTestCase::DoRun (void)
+{
+  const std::string name = "ni-test-shm-ring";
+  NiShmRing noPeer;
+  NS_TEST_ASSERT_MSG_EQ (noPeer.Attach (name + "-missing", 10), -1, "attach without peer did not time out");
+
+  NiShmRing producer, consumer;
+  NS_TEST_ASSERT_MSG_EQ (producer.Create (name, 60), 0, "create failed");
+  NS_TEST_ASSERT_MSG_EQ (consumer.Attach (name, 1000), 0, "attach failed");
+
+  std::vector<uint8_t> buf (64);
+  struct iovec iov;
+
+  // full ring - data area of 64 bytes, the second message of 40 bytes does not fit
+  std::vector<uint8_t> msg = NiShmRingTestMsg (40, 0x10);
+  iov.iov_base = msg.data ();
+  iov.iov_len = msg.size ();
+  NS_TEST_ASSERT_MSG_EQ (producer.Write (&iov, 1), 40, "write failed");
+  NS_TEST_ASSERT_MSG_EQ (producer.Write (&iov, 1), 0, "full ring accepted a message");
+  NS_TEST_ASSERT_MSG_EQ (producer.GetNumFull (), 1, "full ring not counted");
+  NS_TEST_ASSERT_MSG_EQ (consumer.Read (buf.data (), buf.size ()), 40, "read failed");
+  NS_TEST_ASSERT_MSG_EQ (memcmp (buf.data (), msg.data (), msg.size ()), 0, "message corrupted");
+  NS_TEST_ASSERT_MSG_EQ (consumer.Read (buf.data (), buf.size ()), 0, "empty ring returned a message");
+
+  // wrap around - written from offset 40 on, 24 bytes before and 16 bytes after the end
+  msg = NiShmRingTestMsg (40, 0x20);
+  struct iovec iovParts[2];
+  iovParts[0].iov_base = msg.data ();
+  iovParts[0].iov_len = 8;
+  iovParts[1].iov_base = msg.data () + 8;
+  iovParts[1].iov_len = msg.size () - 8;
+  NS_TEST_ASSERT_MSG_EQ (producer.Write (iovParts, 2), 40, "write across the end failed");
+  NS_TEST_ASSERT_MSG_EQ (consumer.Read (buf.data (), buf.size ()), 40, "read across the end failed");
+  NS_TEST_ASSERT_MSG_EQ (memcmp (buf.data (), msg.data (), msg.size ()), 0, "message across the end corrupted");
+
+  // messages of all sizes, each header and body starting at a different offset
+  for (uint32_t n = 0; n < 200; n++)
+    {
+      msg = NiShmRingTestMsg (8 + (n * 7) % 57, (uint8_t) n);
+      iov.iov_base = msg.data ();
+      iov.iov_len = msg.size ();
+      NS_TEST_ASSERT_MSG_EQ (producer.Write (&iov, 1), (int32_t) msg.size (), "write of message " << n << " failed");
+      NS_TEST_ASSERT_MSG_EQ (consumer.Read (buf.data (), buf.size ()), (int32_t) msg.size (), "read of message " << n << " failed");
+      NS_TEST_ASSERT_MSG_EQ (memcmp (buf.data (), msg.data (), msg.size ()), 0, "message " << n << " corrupted");
+    }
+
+  consumer.Close ();
+  producer.Close ();
+
+  // ring file shorter than the published data size
+  NiShmRing truncated, attacher;
+  NS_TEST_ASSERT_MSG_EQ (truncated.Create (name, 64), 0, "create failed");
+  const std::string path = "/dev/shm/" + name;
+  struct stat st;
+  NS_TEST_ASSERT_MSG_EQ (stat (path.c_str (), &st), 0, "stat failed");
+  NS_TEST_ASSERT_MSG_EQ (truncate (path.c_str (), st.st_size - 32), 0, "truncate failed");
+  NS_TEST_ASSERT_MSG_EQ (attacher.Attach (name, 1000), -1, "attached a ring exceeding its file");
+  truncated.Close ();
+}
+
+// Fuzz test of the compile time specialized NIAPI codecs: random messages are
+// encoded / decoded by the codecs and by the generic SerializeStruct /
+// DeserializeStruct byte width loop, the wire format has to be identical.
+class NiApiCodecTestCase : public TestCase
+{
+public:
+  NiApiCodecTestCase ();
+  virtual ~NiApiCodecTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  template <typename T>
+  void CheckMsg (std::string name,
+                 int32_t (*serialize)(T*, uint8_t*, uint32_t*),
+                 int32_t (*deserialize)(T*, uint8_t*, uint32_t*),
+                 std::vector<const LteElementsSpec*> specs,
+                 uint32_t maxArrayLen);
+
+  std::mt19937 m_rng;
+};
+
+NiApiCodecTestCase::NiApiCodecTestCase ()
+  : TestCase ("NIAPI codecs match the generic serialization")
+{
+}
+
+NiApiCodecTestCase::~NiApiCodecTestCase ()
+{
+}
+
+// The fixed part of a message is the uint32_t array described by specs, an optional
+// uint8_t array follows whose length is the last element of the fixed part.
+template <typename T>
+void
+NiApiCodecTestCase::CheckMsg (std::string name,
+                              int32_t (*serialize)(T*, uint8_t*, uint32_t*),
+                              int32_t (*deserialize)(T*, uint8_t*, uint32_t*),
+                              std::vector<const LteElementsSpec*> specs,
+                              uint32_t maxArrayLen)
+{
+  const uint32_t numIter = 1000;
+  uint32_t numEl = 0;
+  for (uint32_t i = 0; i < specs.size (); i++)
+    {
+      numEl += specs[i]->numEl;
+    }
+
+  std::vector<uint8_t> msg (sizeof (T)), msgCodec (sizeof (T)), msgGeneric (sizeof (T));
+  std::vector<uint8_t> bufCodec (NI_COMMON_CONST_MAX_PAYLOAD_SIZE), bufGeneric (NI_COMMON_CONST_MAX_PAYLOAD_SIZE);
+  uint32_t* pWords = (uint32_t*) msg.data ();
+  uint8_t* pArray = (uint8_t*) (pWords + numEl);
+
+  for (uint32_t n = 0; n < numIter; n++)
+    {
+      for (uint32_t i = 0; i < numEl; i++)
+        {
+          pWords[i] = m_rng ();
+        }
+      uint32_t arrayLen = 0;
+      if (maxArrayLen > 0)
+        {
+          arrayLen = m_rng () % (maxArrayLen + 1);
+          pWords[numEl - 1] = arrayLen;
+          for (uint32_t i = 0; i < arrayLen; i++)
+            {
+              pArray[i] = m_rng ();
+            }
+        }
+      const uint32_t startOffset = m_rng () % 8;
+
+      // encode
+      memset (bufCodec.data (), 0xA5, bufCodec.size ());
+      memset (bufGeneric.data (), 0xA5, bufGeneric.size ());
+      uint32_t offsetCodec = startOffset;
+      serialize ((T*) msg.data (), bufCodec.data (), &offsetCodec);
+      uint32_t offsetGeneric = startOffset;
+      uint32_t* pStruct = pWords;
+      for (uint32_t i = 0; i < specs.size (); i++)
+        {
+          SerializeStruct (pStruct, specs[i]->numEl, (uint8_t*) specs[i]->byteWidth, bufGeneric.data (), &offsetGeneric);
+          pStruct += specs[i]->numEl;
+        }
+      for (uint32_t i = 0; i < arrayLen; i++)
+        {
+          bufGeneric[offsetGeneric++] = pArray[i];
+        }
+      NS_TEST_ASSERT_MSG_EQ (offsetCodec, offsetGeneric, name << ": serialized length differs");
+      NS_TEST_ASSERT_MSG_EQ (memcmp (bufCodec.data (), bufGeneric.data (), bufCodec.size ()), 0,
+                             name << ": serialized bytes differ");
+
+      if (deserialize == NULL)
+        {
+          continue;
+        }
+
+      // decode
+      memset (msgCodec.data (), 0, msgCodec.size ());
+      memset (msgGeneric.data (), 0, msgGeneric.size ());
+      offsetCodec = startOffset;
+      deserialize ((T*) msgCodec.data (), bufCodec.data (), &offsetCodec);
+      offsetGeneric = startOffset;
+      pStruct = (uint32_t*) msgGeneric.data ();
+      for (uint32_t i = 0; i < specs.size (); i++)
+        {
+          DeserializeStruct (pStruct, specs[i]->numEl, (uint8_t*) specs[i]->byteWidth, bufGeneric.data (), &offsetGeneric);
+          pStruct += specs[i]->numEl;
+        }
+      for (uint32_t i = 0; i < arrayLen; i++)
+        {
+          ((uint8_t*) pStruct)[i] = bufGeneric[offsetGeneric++];
+        }
+      NS_TEST_ASSERT_MSG_EQ (offsetCodec, offsetGeneric, name << ": deserialized length differs");
+      NS_TEST_ASSERT_MSG_EQ (memcmp (msgCodec.data (), msgGeneric.data (), msgCodec.size ()), 0,
+                             name << ": deserialized message differs");
+    }
+}
+
+void
+NiApiCodecTestCase::DoRun (void)
+{
+  m_rng.seed (1);
+
+  const LteElementsSpec* hdr[] = {&ns3::genMsgHdrSpec, &ns3::subMsgHdrSpec};
+  std::vector<const LteElementsSpec*> msgHdr (hdr, hdr + 2);
+
+  std::vector<const LteElementsSpec*> dlTxConfigReq (msgHdr);
+  dlTxConfigReq.push_back (&parSetHdrSpec);
+  dlTxConfigReq.push_back (&dlschTxConfigBodySpec);
+  dlTxConfigReq.push_back (&parSetHdrSpec);
+  dlTxConfigReq.push_back (&dciTxConfigDlGrantBodySpec);
+
+  std::vector<const LteElementsSpec*> dlTxPayloadReq (msgHdr);
+  dlTxPayloadReq.push_back (&parSetHdrSpec);
+  dlTxPayloadReq.push_back (&dlschMacPduTxBodySpec);
+
+  std::vector<const LteElementsSpec*> ulTxPayloadReq (msgHdr);
+  ulTxPayloadReq.push_back (&parSetHdrSpec);
+  ulTxPayloadReq.push_back (&ulschMacPduTxBodySpec);
+
+  std::vector<const LteElementsSpec*> txPayloadReqHdr (msgHdr);
+  txPayloadReqHdr.push_back (&parSetHdrSpec);
+  txPayloadReqHdr.push_back (&macPduTxBodyHdrSpec);
+
+  std::vector<const LteElementsSpec*> dlschRxInd (msgHdr);
+  dlschRxInd.push_back (&parSetHdrSpec);
+  dlschRxInd.push_back (&dlschMacPduRxBodySpec);
+
+  std::vector<const LteElementsSpec*> ulschRxInd (msgHdr);
+  ulschRxInd.push_back (&parSetHdrSpec);
+  ulschRxInd.push_back (&ulschMacPduRxBodySpec);
+
+  std::vector<const LteElementsSpec*> cellMeasInd (msgHdr);
+  cellMeasInd.push_back (&parSetHdrSpec);
+  cellMeasInd.push_back (&cellMeasReportBodySpec);
+
+  std::vector<const LteElementsSpec*> cnf (msgHdr);
+  cnf.push_back (&parSetHdrSpec);
+  cnf.push_back (&cnfBodySpec);
+
+  CheckMsg<PhyTimingInd> ("PhyTimingInd", SerializePhyTimingInd, DeserializePhyTimingInd, msgHdr, 0);
+  CheckMsg<PhyDlTxConfigReq> ("PhyDlTxConfigReq", SerializePhyDlTxConfigReq, DeserializePhyDlTxConfigReq, dlTxConfigReq, 0);
+  CheckMsg<PhyDlTxPayloadReq> ("PhyDlTxPayloadReq", SerializePhyDlTxPayloadReq, NULL, dlTxPayloadReq, MAX_MAC_PDU_SIZE);
+  CheckMsg<PhyUlTxPayloadReq> ("PhyUlTxPayloadReq", SerializePhyUlTxPayloadReq, NULL, ulTxPayloadReq, MAX_MAC_PDU_SIZE);
+  CheckMsg<PhyTxPayloadReqHdr> ("PhyTxPayloadReqHdr", SerializePhyTxPayloadReqHdr, DeserializePhyTxPayloadReqHdr, txPayloadReqHdr, 0);
+  CheckMsg<PhyDlschRxInd> ("PhyDlschRxInd", SerializePhyDlschRxInd, DeserializePhyDlschRxInd, dlschRxInd, MAX_MAC_PDU_SIZE);
+  CheckMsg<PhyUlschRxInd> ("PhyUlschRxInd", SerializePhyUlschRxInd, DeserializePhyUlschRxInd, ulschRxInd, MAX_MAC_PDU_SIZE);
+  CheckMsg<PhyCellMeasInd> ("PhyCellMeasInd", SerializePhyCellMeasurementInd, DeserializePhyCellMeasurementInd, cellMeasInd, MAX_NUM_SUBBAND_SINR);
+  CheckMsg<PhyCnf> ("PhyCnf", SerializePhyCnf, DeserializePhyCnf, cnf, 0);
+}
+
+// Readers of the seqlock racing with the writer must never see a value of
+// which only some words are updated, and a reader blocked in WaitForUpdate
+// has to be woken up by the next Write.
+class NiSeqlockTestCase : public TestCase
+{
+public:
+  NiSeqlockTestCase ();
+  virtual ~NiSeqlockTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiSeqlockTestCase::NiSeqlockTestCase ()
+  : TestCase ("Seqlock readers see no torn values and are woken up on publish")
+{
+}
+
+NiSeqlockTestCase::~NiSeqlockTestCase ()
+{
+}
+
+// several words, all set to the same counter by the writer
+struct NiSeqlockTestValue
+{
+  uint64_t words[4];
+};
+
+static void
+NiSeqlockWrite (NiSeqlock<NiSeqlockTestValue>* pSeqlock, uint64_t numWrites)
+{
+  NiSeqlockTestValue value;
+  for (uint64_t n = 1; n <= numWrites; n++)
+    {
+      for (uint32_t i = 0; i < 4; i++)
+        {
+          value.words[i] = n;
+        }
+      pSeqlock->Write (value);
+    }
+}
+
+static void
+NiSeqlockWaitForUpdate (NiSeqlock<NiSeqlockTestValue>* pSeqlock, uint32_t seq, bool* pUpdated, bool* pBlocked, uint64_t* pValue)
+{
+  NiSeqlockTestValue value;
+  *pUpdated = pSeqlock->WaitForUpdate (&seq, &value, 0, 2000000000ULL, pBlocked);
+  *pValue = value.words[0];
+}
+
+void
+NiSeqlockTestCase::DoRun (void)
+{
+  // torn reads - reader in this thread, writer in another one
+  const uint64_t numWrites = 200000;
+  NiSeqlock<NiSeqlockTestValue> seqlock;
+  std::thread writer (NiSeqlockWrite, &seqlock, numWrites);
+  uint64_t numTorn = 0, numBackwards = 0, last = 0;
+  NiSeqlockTestValue value;
+  do
+    {
+      seqlock.Read (&value);
+      for (uint32_t i = 1; i < 4; i++)
+        {
+          numTorn += (value.words[i] != value.words[0]);
+        }
+      numBackwards += (value.words[0] < last);
+      last = value.words[0];
+    }
+  while (last < numWrites);
+  writer.join ();
+  NS_TEST_ASSERT_MSG_EQ (numTorn, 0, "torn values read");
+  NS_TEST_ASSERT_MSG_EQ (numBackwards, 0, "values read out of order");
+  NS_TEST_ASSERT_MSG_EQ (seqlock.GetSeq (), 2 * numWrites, "wrong sequence number");
+
+  // no update - the wait times out
+  bool blocked = false;
+  uint32_t seq = seqlock.Read (&value);
+  NS_TEST_ASSERT_MSG_EQ (seqlock.WaitForUpdate (&seq, &value, 0, 1000000, &blocked), false, "wait without update did not time out");
+  NS_TEST_ASSERT_MSG_EQ (blocked, true, "wait without spin did not block");
+
+  // wake-up on publish - the reader blocks on the futex until the write
+  bool updated = false;
+  uint64_t readValue = 0;
+  blocked = false;
+  std::thread reader (NiSeqlockWaitForUpdate, &seqlock, seq, &updated, &blocked, &readValue);
+  // give the reader time to reach the futex wait
+  usleep (50000);
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      value.words[i] = numWrites + 1;
+    }
+  seqlock.Write (value);
+  reader.join ();
+  NS_TEST_ASSERT_MSG_EQ (updated, true, "blocked reader not woken up by the write");
+  NS_TEST_ASSERT_MSG_EQ (blocked, true, "reader did not block");
+  NS_TEST_ASSERT_MSG_EQ (readValue, numWrites + 1, "reader did not get the published value");
+}
+
+// The single-pass Wi-Fi TX request encoders have to write the same bytes as
+// SerializeMessage of the message structs filled like the MAC high does.
+class NiWifiTxEncoderTestCase : public TestCase
+{
+public:
+  NiWifiTxEncoderTestCase ();
+  virtual ~NiWifiTxEncoderTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiWifiTxEncoderTestCase::NiWifiTxEncoderTestCase ()
+  : TestCase ("Wi-Fi TX request encoders match SerializeMessage")
+{
+}
+
+NiWifiTxEncoderTestCase::~NiWifiTxEncoderTestCase ()
+{
+}
+
+void
+NiWifiTxEncoderTestCase::DoRun (void)
+{
+  std::mt19937 rng (1);
+  std::vector<uint8_t> bufEncoder (NI_COMMON_CONST_MAX_PAYLOAD_SIZE), bufGeneric (NI_COMMON_CONST_MAX_PAYLOAD_SIZE);
+  TxPayloadReqBody* pTxPayloadReqBody = new TxPayloadReqBody;
+
+  for (uint32_t n = 0; n < 1000; n++)
+    {
+      const uint32_t instId = rng () % 3;
+      const uint32_t msduLength = rng () % 4066;
+      uint8_t addr[3][6];
+      for (uint32_t i = 0; i < 18; i++)
+        {
+          addr[i / 6][i % 6] = rng ();
+        }
+
+      // TX Config Req
+      NiapiCommonHeader hdr;
+      TxConfigReqBody txConfigReqBody;
+      hdr.genMsgHdr.msgType    = TX_CONFIG_REQ;
+      hdr.genMsgHdr.refId      = 1;
+      hdr.genMsgHdr.instId     = instId;
+      hdr.genMsgHdr.bodyLength = (txConfigReqBody.msduTxParams.parSetLength + 4) + (txConfigReqBody.phyTxParams.parSetLength + 4) + 8 + 8;
+      hdr.subMsgHdr.resv       = 0;
+      hdr.subMsgHdr.timestmp   = 0x10;
+      hdr.subMsgHdr.numSubMsg  = 2;
+      hdr.subMsgHdr.cnfMode    = 1;
+      txConfigReqBody.msduTxParams.msduIndex  = 1;
+      txConfigReqBody.msduTxParams.frameType  = rng () % 3;
+      txConfigReqBody.msduTxParams.subType    = rng () % 64;
+      txConfigReqBody.msduTxParams.toDs       = rng () % 2;
+      txConfigReqBody.msduTxParams.fromDs     = rng () % 2;
+      for (uint32_t i = 0; i < 6; i++)
+        {
+          txConfigReqBody.msduTxParams.destAddr[i]   = addr[0][i];
+          txConfigReqBody.msduTxParams.sourceAddr[i] = addr[1][i];
+          txConfigReqBody.msduTxParams.bssid[i]      = addr[2][i];
+        }
+      txConfigReqBody.msduTxParams.msduLength = msduLength;
+      txConfigReqBody.phyTxParams.msduIndex   = 1;
+      txConfigReqBody.phyTxParams.format      = 2;
+      txConfigReqBody.phyTxParams.bandwidth   = 0;
+      txConfigReqBody.phyTxParams.mcs         = rng () % 10;
+
+      memset (bufEncoder.data (), 0xA5, bufEncoder.size ());
+      memset (bufGeneric.data (), 0xA5, bufGeneric.size ());
+      uint32_t offsetGeneric = 0;
+      SerializeMessage (&hdr, (uint32_t*) &txConfigReqBody, bufGeneric.data (), &offsetGeneric);
+      uint32_t offsetEncoder = EncodeTxConfigReq (bufEncoder.data (), instId,
+                                                  txConfigReqBody.msduTxParams.frameType, txConfigReqBody.msduTxParams.subType,
+                                                  txConfigReqBody.msduTxParams.toDs, txConfigReqBody.msduTxParams.fromDs,
+                                                  addr[0], addr[1], addr[2], msduLength, txConfigReqBody.phyTxParams.mcs);
+      NS_TEST_ASSERT_MSG_EQ (offsetEncoder, offsetGeneric, "TX Config Req: encoded length differs");
+      NS_TEST_ASSERT_MSG_EQ (offsetEncoder, TX_CONFIG_REQ_SIZE, "TX Config Req: unexpected length");
+      NS_TEST_ASSERT_MSG_EQ (memcmp (bufEncoder.data (), bufGeneric.data (), bufEncoder.size ()), 0,
+                             "TX Config Req: encoded bytes differ");
+
+      // TX Payload Req
+      hdr.genMsgHdr.msgType    = TX_PAYLOAD_REQ;
+      hdr.genMsgHdr.bodyLength = msduLength + 4 + 8 + 8;
+      hdr.subMsgHdr.timestmp   = 0x20;
+      hdr.subMsgHdr.numSubMsg  = 1;
+      *pTxPayloadReqBody = TxPayloadReqBody ();
+      pTxPayloadReqBody->msduTxPayload.msduIndex    = 1;
+      pTxPayloadReqBody->msduTxPayload.parSetLength = msduLength + 4;
+      pTxPayloadReqBody->msduTxPayload.msduLength   = msduLength;
+      for (uint32_t i = 0; i < msduLength; i++)
+        {
+          pTxPayloadReqBody->msduTxPayload.msduData[i] = (uint8_t) rng ();
+        }
+
+      memset (bufEncoder.data (), 0xA5, bufEncoder.size ());
+      memset (bufGeneric.data (), 0xA5, bufGeneric.size ());
+      offsetGeneric = 0;
+      SerializeMessage (&hdr, (uint32_t*) pTxPayloadReqBody, bufGeneric.data (), &offsetGeneric);
+      offsetEncoder = EncodeTxPayloadReqHdr (bufEncoder.data (), instId, msduLength);
+      NS_TEST_ASSERT_MSG_EQ (offsetEncoder, TX_PAYLOAD_REQ_HDR_SIZE, "TX Payload Req: unexpected header length");
+      for (uint32_t i = 0; i < msduLength; i++)
+        {
+          bufEncoder[offsetEncoder++] = pTxPayloadReqBody->msduTxPayload.msduData[i];
+        }
+      NS_TEST_ASSERT_MSG_EQ (offsetEncoder, offsetGeneric, "TX Payload Req: encoded length differs");
+      NS_TEST_ASSERT_MSG_EQ (memcmp (bufEncoder.data (), bufGeneric.data (), bufEncoder.size ()), 0,
+                             "TX Payload Req: encoded bytes differ");
+    }
+
+  delete pTxPayloadReqBody;
+}
+
+// A fatal message has to stop the process also when the log ring of the
+// calling thread is full. Checked in a child process, which aborts.
+class NiLoggingFatalTestCase : public TestCase
+{
+public:
+  NiLoggingFatalTestCase ();
+  virtual ~NiLoggingFatalTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiLoggingFatalTestCase::NiLoggingFatalTestCase ()
+  : TestCase ("Fatal log messages stop the process with a full log ring")
+{
+}
+
+NiLoggingFatalTestCase::~NiLoggingFatalTestCase ()
+{
+}
+
+void
+NiLoggingFatalTestCase::DoRun (void)
+{
+  const pid_t pid = fork ();
+  if (pid == 0)
+    {
+      // the fatal output is expected, keep it out of the test report
+      const int devNull = open ("/dev/null", O_WRONLY);
+      dup2 (devNull, STDOUT_FILENO);
+      dup2 (devNull, STDERR_FILENO);
+
+      // the child has no logging thread, nothing drains the ring
+      NiLogRing* pRing = NULL;
+      uint32_t numRecords = 0;
+      while (g_NiLogging.GetWriteSlot (&pRing) != NULL)
+        {
+          pRing->CommitWrite ();
+          numRecords++;
+        }
+      static const NiLogSite fatalSite = {LOG__FATAL, __FILE__, __LINE__, __func__};
+      {
+        NiLogRecordWriter writer (&fatalSite);
+        writer << "fatal with full ring after " << numRecords << " records";
+      }
+      _exit (0);
+    }
+  NS_TEST_ASSERT_MSG_GT (pid, 0, "fork failed");
+
+  int status = 0;
+  waitpid (pid, &status, 0);
+  NS_TEST_ASSERT_MSG_EQ (WIFSIGNALED (status), true, "fatal message with full ring did not stop the process");
+  NS_TEST_ASSERT_MSG_EQ (WTERMSIG (status), SIGABRT, "process not stopped by the fatal error");
+}
+
+// Trace records written through the memory mapped file have to be read back
+// in order, without and with wrap around of a full file.
+class NiTraceFileTestCase : public TestCase
+{
+public:
+  NiTraceFileTestCase ();
+  virtual ~NiTraceFileTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiTraceFileTestCase::NiTraceFileTestCase ()
+  : TestCase ("Trace file records are read back in order")
+{
+}
+
+NiTraceFileTestCase::~NiTraceFileTestCase ()
+{
+}
+
+void
+NiTraceFileTestCase::DoRun (void)
+{
+  const std::string fileName = CreateTempDirFilename ("ni-trace.bin");
+  const uint32_t maxRecords = 8;
+  const uint32_t numWritten = 13;
+
+  for (uint32_t wrap = 0; wrap < 2; wrap++)
+    {
+      NiTrace trace;
+      NS_TEST_ASSERT_MSG_EQ (trace.Open (fileName, maxRecords, wrap), 0, "Open failed");
+      for (uint32_t i = 0; i < numWritten; i++)
+        {
+          trace.Write (NI_TRACE_PHY_TIMING_IND, i, i % 10, -(int64_t)i, i, 2, 3, 4);
+        }
+      const uint64_t expectedDropped = wrap ? 0 : numWritten - maxRecords;
+      NS_TEST_ASSERT_MSG_EQ (trace.GetNumDropped (), expectedDropped, "wrong number of dropped records");
+      trace.Close ();
+
+      NiTraceFileHeader hdr;
+      std::vector<NiTraceRecord> records;
+      NS_TEST_ASSERT_MSG_EQ (NiTrace::ReadFile (fileName, &hdr, &records), 0, "ReadFile failed");
+      NS_TEST_ASSERT_MSG_EQ (hdr.numRecords.load (), numWritten, "wrong number of written records");
+      NS_TEST_ASSERT_MSG_EQ (records.size (), maxRecords, "wrong number of records read");
+      // without wrap the first records are kept, with wrap the latest ones
+      const uint32_t first = wrap ? numWritten - maxRecords : 0;
+      for (uint32_t i = 0; i < records.size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (records[i].traceId, NI_TRACE_PHY_TIMING_IND, "wrong trace id");
+          NS_TEST_ASSERT_MSG_EQ (records[i].sfn, first + i, "records out of order");
+          NS_TEST_ASSERT_MSG_EQ ((uint32_t) records[i].tti, (first + i) % 10, "wrong tti");
+          NS_TEST_ASSERT_MSG_EQ (records[i].payload[0], -(int64_t)(first + i), "wrong payload");
+          NS_TEST_ASSERT_MSG_EQ (records[i].payload[4], 4, "wrong payload");
+        }
+      if (!wrap)
+        {
+          // the unused preallocated space is released on close
+          struct stat st;
+          stat (fileName.c_str (), &st);
+          NS_TEST_ASSERT_MSG_EQ ((uint64_t) st.st_size, sizeof (NiTraceFileHeader) + maxRecords * sizeof (NiTraceRecord),
+                                 "file not truncated");
+        }
+    }
+}
+
+// Captured messages have to be read back with their pseudo header and bytes,
+// and records beyond the maximum file size have to be dropped.
+class NiCaptureFileTestCase : public TestCase
+{
+public:
+  NiCaptureFileTestCase ();
+  virtual ~NiCaptureFileTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiCaptureFileTestCase::NiCaptureFileTestCase ()
+  : TestCase ("Capture file records are read back with header and bytes")
+{
+}
+
+NiCaptureFileTestCase::~NiCaptureFileTestCase ()
+{
+}
+
+void
+NiCaptureFileTestCase::DoRun (void)
+{
+  const std::string fileName = CreateTempDirFilename ("ni-capture.pcap");
+  uint8_t hdrU8[4] = {1, 2, 3, 4};
+  uint8_t bodyU8[100];
+  for (uint32_t i = 0; i < sizeof (bodyU8); i++)
+    {
+      bodyU8[i] = i;
+    }
+  struct iovec iov[2];
+  iov[0].iov_base = hdrU8;
+  iov[0].iov_len = sizeof (hdrU8);
+  iov[1].iov_base = bodyU8;
+  iov[1].iov_len = sizeof (bodyU8);
+
+  // file header, two records and no room for the third one
+  const uint64_t maxBytes = sizeof (NiCaptureFileHeader) + 2 * (sizeof (NiCaptureRecordHeader) + sizeof (NiCapturePseudoHeader))
+                            + sizeof (hdrU8) + sizeof (bodyU8) + 10;
+  NiCapture capture;
+  NS_TEST_ASSERT_MSG_EQ (capture.Open (fileName, maxBytes), 0, "Open failed");
+  NS_TEST_ASSERT_MSG_EQ (capture.IsEnabled (), true, "capture not enabled");
+  capture.Write (NI_CAPTURE_DIR_TX, NI_CAPTURE_CHANNEL_PIPE_TX, 3, "LTE", iov, 2);
+  capture.Write (NI_CAPTURE_DIR_RX, NI_CAPTURE_CHANNEL_UDP, 12701, "WIFI", bodyU8, 10);
+  capture.Write (NI_CAPTURE_DIR_RX, NI_CAPTURE_CHANNEL_UDP, 12701, "WIFI", bodyU8, 10);
+  NS_TEST_ASSERT_MSG_EQ (capture.GetNumRecords (), 2, "wrong number of written records");
+  NS_TEST_ASSERT_MSG_EQ (capture.GetNumDropped (), 1, "wrong number of dropped records");
+  capture.Close ();
+  NS_TEST_ASSERT_MSG_EQ (capture.IsEnabled (), false, "capture still enabled");
+
+  std::vector<NiCaptureRecord> records;
+  NS_TEST_ASSERT_MSG_EQ (NiCapture::ReadFile (fileName, &records), 0, "ReadFile failed");
+  NS_TEST_ASSERT_MSG_EQ (records.size (), 2, "wrong number of records read");
+
+  NS_TEST_ASSERT_MSG_EQ ((uint32_t) records[0].hdr.direction, NI_CAPTURE_DIR_TX, "wrong direction");
+  NS_TEST_ASSERT_MSG_EQ ((uint32_t) records[0].hdr.channel, NI_CAPTURE_CHANNEL_PIPE_TX, "wrong channel");
+  NS_TEST_ASSERT_MSG_EQ (records[0].hdr.instance, 3, "wrong instance");
+  NS_TEST_ASSERT_MSG_EQ (std::string (records[0].hdr.context), "LTE", "wrong context");
+  NS_TEST_ASSERT_MSG_EQ (records[0].data.size (), sizeof (hdrU8) + sizeof (bodyU8), "wrong record length");
+  NS_TEST_ASSERT_MSG_EQ (memcmp (records[0].data.data (), hdrU8, sizeof (hdrU8)), 0, "wrong iovec bytes");
+  NS_TEST_ASSERT_MSG_EQ (memcmp (records[0].data.data () + sizeof (hdrU8), bodyU8, sizeof (bodyU8)), 0, "wrong iovec bytes");
+
+  NS_TEST_ASSERT_MSG_EQ ((uint32_t) records[1].hdr.direction, NI_CAPTURE_DIR_RX, "wrong direction");
+  NS_TEST_ASSERT_MSG_EQ ((uint32_t) records[1].hdr.channel, NI_CAPTURE_CHANNEL_UDP, "wrong channel");
+  // the context fills the field without termination
+  NS_TEST_ASSERT_MSG_EQ (std::string (records[1].hdr.context, sizeof (records[1].hdr.context)), "WIFI", "wrong context");
+  NS_TEST_ASSERT_MSG_EQ (records[1].data.size (), 10, "wrong record length");
+  NS_TEST_ASSERT_MSG_EQ (memcmp (records[1].data.data (), bodyU8, 10), 0, "wrong buffer bytes");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (records[1].timeNs, records[0].timeNs, "timestamps out of order");
+}
+
+// Latency values have to land in buckets whose bounds are within the
+// configured precision, and the buckets of all threads have to be merged.
+class NiLatencyHistogramTestCase : public TestCase
+{
+public:
+  NiLatencyHistogramTestCase ();
+  virtual ~NiLatencyHistogramTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiLatencyHistogramTestCase::NiLatencyHistogramTestCase ()
+  : TestCase ("Latency histograms bucket and merge values of several threads")
+{
+}
+
+NiLatencyHistogramTestCase::~NiLatencyHistogramTestCase ()
+{
+}
+
+static void
+NiLatencyRecordRange (NiLatencyHistograms* pHistograms, uint64_t first, uint64_t last)
+{
+  for (uint64_t v = first; v <= last; v++)
+    {
+      pHistograms->Record (NI_LATENCY_RX_HANDLER, v * 1000);
+    }
+}
+
+void
+NiLatencyHistogramTestCase::DoRun (void)
+{
+  const uint64_t maxRelError = 1 << NI_LATENCY__SUB_BUCKET_BITS;
+  uint32_t lastIndex = 0;
+  for (uint64_t v = 1; v < (1ULL << NI_LATENCY__MAX_MAGNITUDE); v += 1 + v / 7)
+    {
+      const uint32_t index = NiLatencyHistograms::GetBucketIndex (v);
+      const uint64_t upperBound = NiLatencyHistograms::GetBucketUpperBound (index);
+      NS_TEST_ASSERT_MSG_LT (index, NI_LATENCY__NUM_BUCKETS, "bucket index out of range");
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (index, lastIndex, "bucket index not monotonic");
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (upperBound, v, "value above the bucket bound");
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (upperBound - v, v / maxRelError, "bucket too wide");
+      lastIndex = index;
+    }
+  NS_TEST_ASSERT_MSG_EQ (NiLatencyHistograms::GetBucketIndex (UINT64_MAX), NI_LATENCY__NUM_BUCKETS - 1, "large values not clamped");
+
+  // 1..1000 us, recorded by the test thread and a second thread
+  NiLatencyHistograms histograms;
+  NiLatencyRecordRange (&histograms, 1, 500);
+  std::thread thread (NiLatencyRecordRange, &histograms, 501, 1000);
+  thread.join ();
+
+  const NiLatencySnapshot snapshot = histograms.GetSnapshot (NI_LATENCY_RX_HANDLER);
+  NS_TEST_ASSERT_MSG_EQ (snapshot.GetCount (), 1000, "values of a thread are missing");
+  NS_TEST_ASSERT_MSG_EQ (snapshot.GetMaxNs (), 1000000, "wrong maximum");
+  NS_TEST_ASSERT_MSG_EQ_TOL (snapshot.GetMeanNs (), 500500.0, 0.1, "wrong mean");
+  NS_TEST_ASSERT_MSG_EQ_TOL ((double) snapshot.GetPercentileNs (50.0), 500000.0, 500000.0 / maxRelError, "wrong median");
+  NS_TEST_ASSERT_MSG_EQ_TOL ((double) snapshot.GetPercentileNs (99.0), 990000.0, 990000.0 / maxRelError, "wrong p99");
+  NS_TEST_ASSERT_MSG_EQ (snapshot.GetPercentileNs (100.0), 1000000, "p100 is not the maximum");
+  NS_TEST_ASSERT_MSG_EQ (histograms.GetSnapshot (NI_LATENCY_PIPE_WRITE).GetCount (), 0, "stages not separated");
+}
+
+// Remote control parameters have to be accessible by name, reject malformed
+// and out of range values and increment the version on every accepted write.
+class NiParameterDataBaseTestCase : public TestCase
+{
+public:
+  NiParameterDataBaseTestCase ();
+  virtual ~NiParameterDataBaseTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiParameterDataBaseTestCase::NiParameterDataBaseTestCase ()
+  : TestCase ("Remote control parameter data base checks values and versions")
+{
+}
+
+NiParameterDataBaseTestCase::~NiParameterDataBaseTestCase ()
+{
+}
+
+void
+NiParameterDataBaseTestCase::DoRun (void)
+{
+  ParameterDataBase pdb;
+  uint64_t version = pdb.GetVersion ();
+
+  NS_TEST_ASSERT_MSG_EQ (pdb.setParameterByName ("ParameterLwaDecVariable", "2"), "2", "valid value rejected");
+  NS_TEST_ASSERT_MSG_EQ (pdb.getParameterLwaDecVariable (), 2, "typed value not written");
+  NS_TEST_ASSERT_MSG_EQ (pdb.getParameterByName ("ParameterLwaDecVariable"), "2", "value not readable by name");
+  NS_TEST_ASSERT_MSG_EQ (pdb.GetVersion (), version + 1, "version not incremented");
+  version = pdb.GetVersion ();
+
+  NS_TEST_ASSERT_MSG_EQ (pdb.setParameterByName ("ParameterLwaDecVariable", "3"), "ERR:VALUE_NOT_IN_RANGE", "range not checked");
+  NS_TEST_ASSERT_MSG_EQ (pdb.setParameterByName ("ParameterLwipDecVariable", "-1"), "ERR:INVALID_VALUE", "negative value accepted");
+  NS_TEST_ASSERT_MSG_EQ (pdb.setParameterByName ("ParameterLteUeChannelSinr", "12.5dB"), "ERR:INVALID_VALUE", "malformed value accepted");
+  NS_TEST_ASSERT_MSG_EQ (pdb.setParameterByName ("ParameterManualLteUeChannelSinrEnable", "yes"), "ERR:INVALID_VALUE", "malformed bool accepted");
+  NS_TEST_ASSERT_MSG_EQ (pdb.setParameterByName ("num_PhyTimingInd", "1"), "ERR:ONLY_READ_ACCESIBLE", "read-only parameter written");
+  NS_TEST_ASSERT_MSG_EQ (pdb.setParameterByName ("ParameterUnknown", "1"), "ERR_UNKOWN_PARAMETER", "unknown parameter written");
+  NS_TEST_ASSERT_MSG_EQ (pdb.getParameterByName ("ParameterUnknown"), "ERR:UNKOWN_PARAMETER", "unknown parameter read");
+  NS_TEST_ASSERT_MSG_EQ (pdb.getParameterLwaDecVariable (), 2, "rejected value written");
+  NS_TEST_ASSERT_MSG_EQ (pdb.GetVersion (), version, "version incremented by rejected writes");
+
+  // statistics of the simulator do not invalidate the cached parameters of real-time paths
+  pdb.setParameterNumPhyTimingInd (1000);
+  NS_TEST_ASSERT_MSG_EQ (pdb.getParameterByName ("num_PhyTimingInd"), "1000", "statistics not readable");
+  NS_TEST_ASSERT_MSG_EQ (pdb.GetVersion (), version, "version incremented by statistics");
+
+  NS_TEST_ASSERT_MSG_EQ (pdb.setParameterByName ("ParameterManualLteUeChannelSinrEnable", "true"), "true", "bool rejected");
+  NS_TEST_ASSERT_MSG_EQ (pdb.setParameterByName ("ParameterLteUeChannelSinr", "12.5"), "12.5", "double rejected");
+  NS_TEST_ASSERT_MSG_EQ (pdb.getParameterManualLteUeChannelSinrEnable (), true, "bool not written");
+  NS_TEST_ASSERT_MSG_EQ (pdb.getParameterLteUeChannelSinr (), 12.5, "double not written");
+  NS_TEST_ASSERT_MSG_EQ (pdb.setParameterByName ("ParameterString1", "abc"), "abc", "string rejected");
+  NS_TEST_ASSERT_MSG_EQ (pdb.getParameterByName ("ParameterString1"), "abc", "string not written");
+  NS_TEST_ASSERT_MSG_EQ (pdb.GetVersion (), version + 3, "version not incremented by each write");
+}
+
+// Batched commands have to be answered in order and a subscription has to
+// stream telemetry frames with the current parameter values.
+class NiRemoteControlEngineTestCase : public TestCase
+{
+public:
+  NiRemoteControlEngineTestCase ();
+  virtual ~NiRemoteControlEngineTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiRemoteControlEngineTestCase::NiRemoteControlEngineTestCase ()
+  : TestCase ("Remote control engine answers batches and streams telemetry")
+{
+}
+
+NiRemoteControlEngineTestCase::~NiRemoteControlEngineTestCase ()
+{
+}
+
+// returns the next text response, telemetry frames received in between are skipped
+static std::string
+NiRemoteControlGetResponse (LocalCommsInterface* pClient)
+{
+  uint8_t data[NI_RC_MAX_MESSAGE_SIZE];
+  uint32_t size;
+  while ((size = pClient->GetData (data, sizeof (data), 1000)) > 0)
+    {
+      if (data[0] != NI_RC_TELEMETRY_MAGIC)
+        {
+          return std::string ((char*) data, size);
+        }
+    }
+  return "";
+}
+
+void
+NiRemoteControlEngineTestCase::DoRun (void)
+{
+  RemoteControlEngine engine;
+  engine.Initialize ("ni-test-rc", 100, NiUtils::GetThreadPrioriy ());
+  LocalCommsInterface client;
+  client.Initialize ("ni-test-rc-client");
+
+  client.SendMessage ("WRITE:ParameterInt1:7;READ:ParameterInt1;READ:ParameterUnknown", "ni-test-rc");
+  NS_TEST_ASSERT_MSG_EQ (NiRemoteControlGetResponse (&client), "7;7;ERR:UNKOWN_PARAMETER", "batch not answered in order");
+  client.SendMessage ("SUBSCRIBE:1:ParameterString1", "ni-test-rc");
+  NS_TEST_ASSERT_MSG_EQ (NiRemoteControlGetResponse (&client), "ERR:NOT_NUMERIC", "string parameter subscribed");
+
+  engine.GetPdb ()->numPdcpTxBytes.Increment (1500);
+  client.SendMessage ("SUBSCRIBE:1:num_PdcpTxBytes,ParameterInt1", "ni-test-rc");
+  NS_TEST_ASSERT_MSG_EQ (NiRemoteControlGetResponse (&client), "OK:1", "subscription rejected");
+
+  // the first frame is sent right away, the second one a period later
+  for (uint32_t seqNum = 0; seqNum < 2; seqNum++)
+    {
+      uint8_t frame[NI_RC_MAX_MESSAGE_SIZE];
+      const uint32_t size = client.GetData (frame, sizeof (frame), 1000);
+      NS_TEST_ASSERT_MSG_EQ (size, sizeof (NiRcTelemetryFrameHeader) + 2 * sizeof (double), "wrong frame size");
+      if (size != sizeof (NiRcTelemetryFrameHeader) + 2 * sizeof (double))
+        {
+          break;
+        }
+      NiRcTelemetryFrameHeader header;
+      double values[2];
+      memcpy (&header, frame, sizeof (header));
+      memcpy (values, frame + sizeof (header), sizeof (values));
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t) header.magic, NI_RC_TELEMETRY_MAGIC, "wrong magic");
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t) header.subscriptionId, 1, "wrong subscription");
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t) header.numValues, 2, "wrong number of values");
+      NS_TEST_ASSERT_MSG_EQ (header.seqNum, seqNum, "frames missing");
+      NS_TEST_ASSERT_MSG_EQ (values[0], 1500.0, "wrong counter value");
+      NS_TEST_ASSERT_MSG_EQ (values[1], 7.0, "wrong parameter value");
+    }
+
+  client.SendMessage ("UNSUBSCRIBE:1", "ni-test-rc");
+  NS_TEST_ASSERT_MSG_EQ (NiRemoteControlGetResponse (&client), "OK", "subscription not removed");
+
+  // stops without waiting for the poll timeout
+  const uint64_t startNs = NiUtils::GetSysTimeNs ();
+  engine.Deinitialize ();
+  NS_TEST_ASSERT_MSG_LT (NiUtils::GetSysTimeNs () - startNs, 50000000ULL, "engine thread not woken up");
+  client.Close ();
+}
+
+// A thread registered by name has to get the cpu set and policy of the first
+// matching thread topology rule.
+class NiThreadTopologyTestCase : public TestCase
+{
+public:
+  NiThreadTopologyTestCase ();
+  virtual ~NiThreadTopologyTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiThreadTopologyTestCase::NiThreadTopologyTestCase ()
+  : TestCase ("Thread topology places registered threads")
+{
+}
+
+NiThreadTopologyTestCase::~NiThreadTopologyTestCase ()
+{
+}
+
+static void
+NiThreadTopologyRegister (std::string name, std::string* pPlacement)
+{
+  NiUtils::AddThreadInfo (pthread_self (), name);
+  *pPlacement = NiUtils::GetThreadPlacement (pthread_self ());
+  NiUtils::RemoveThreadInfo (pthread_self ());
+}
+
+void
+NiThreadTopologyTestCase::DoRun (void)
+{
+  NiUtils::SetThreadTopology ("TopologyTest A=0:other:0;TopologyTest=0:fifo:1");
+
+  std::string placement;
+  std::thread first (NiThreadTopologyRegister, "NiTest TopologyTest A thread", &placement);
+  first.join ();
+  NS_TEST_ASSERT_MSG_EQ (placement, "cpus 0, SCHED_OTHER 0", "first matching rule not applied");
+
+  std::thread other (NiThreadTopologyRegister, "NiTest unplaced thread", &placement);
+  other.join ();
+  NS_TEST_ASSERT_MSG_NE (placement.find ("SCHED_"), std::string::npos, "placement of a floating thread not reported");
+
+  NiUtils::SetThreadTopology ("");
+}
+
+class NiAllocScopeTestCase : public TestCase
+{
+public:
+  NiAllocScopeTestCase ();
+  virtual ~NiAllocScopeTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiAllocScopeTestCase::NiAllocScopeTestCase ()
+  : TestCase ("Alloc scopes count heap allocations of nested and paused sections")
+{
+}
+
+NiAllocScopeTestCase::~NiAllocScopeTestCase ()
+{
+}
+
+void
+NiAllocScopeTestCase::DoRun (void)
+{
+  NiAllocScope::ResetStats ();
+  std::vector<int> preallocated;
+  preallocated.reserve (16);
+  {
+    NiAllocScope scope (NI_ALLOC_SCOPE_SUBFRAME);
+    // reusing reserved storage must not allocate
+    preallocated.push_back (1);
+    preallocated.clear ();
+    NS_TEST_ASSERT_MSG_EQ (scope.GetNumAllocs (), 0, "allocation counted for reserved storage");
+  }
+  {
+    NiAllocScope scope (NI_ALLOC_SCOPE_SUBFRAME);
+    std::vector<int>* pVector = new std::vector<int> (8);
+    {
+      NiAllocScope nestedScope (NI_ALLOC_SCOPE_PHY_RX);
+      std::vector<int> nested (4);
+      {
+        NiAllocScope pauseScope (NI_ALLOC_SCOPE_PAUSE);
+        std::vector<int> paused (4);
+      }
+#ifdef NI_ALLOC_COUNT_ENABLED
+      NS_TEST_ASSERT_MSG_EQ (nestedScope.GetNumAllocs (), 1, "paused allocations counted");
+#endif
+    }
+    delete pVector;
+#ifdef NI_ALLOC_COUNT_ENABLED
+    NS_TEST_ASSERT_MSG_EQ (scope.GetNumAllocs (), 2, "nested allocations counted by the outer scope");
+#endif
+  }
+
+  const NiAllocScopeStats subframeStats = NiAllocScope::GetStats (NI_ALLOC_SCOPE_SUBFRAME);
+  const NiAllocScopeStats phyRxStats = NiAllocScope::GetStats (NI_ALLOC_SCOPE_PHY_RX);
+  NS_TEST_ASSERT_MSG_EQ (subframeStats.numScopes, 2, "wrong number of subframe scopes");
+  NS_TEST_ASSERT_MSG_EQ (phyRxStats.numScopes, 1, "wrong number of rx scopes");
+#ifdef NI_ALLOC_COUNT_ENABLED
+  NS_TEST_ASSERT_MSG_EQ (subframeStats.numScopesWithAllocs, 1, "wrong number of subframe scopes with allocations");
+  NS_TEST_ASSERT_MSG_EQ (subframeStats.maxAllocsPerScope, 2, "wrong maximum of allocations per scope");
+  NS_TEST_ASSERT_MSG_EQ (phyRxStats.numAllocs, 1, "wrong number of rx allocations");
+#endif
+  NiAllocScope::ResetStats ();
+}
+
+class NiLteDeadlineMonitorTestCase : public TestCase
+{
+public:
+  NiLteDeadlineMonitorTestCase ();
+  virtual ~NiLteDeadlineMonitorTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiLteDeadlineMonitorTestCase::NiLteDeadlineMonitorTestCase ()
+  : TestCase ("Deadline monitor steps through the degradation levels and recovers")
+{
+}
+
+NiLteDeadlineMonitorTestCase::~NiLteDeadlineMonitorTestCase ()
+{
+}
+
+void
+NiLteDeadlineMonitorTestCase::DoRun (void)
+{
+  NiLteDeadlineMonitor monitor;
+  NiDeadlineMonitorConfig config;
+  monitor.Configure (config);
+
+  // late subframes step one level down per hold time until the configured maximum
+  for (uint32_t i = 0; i < 10 * config.holdSubframes; i++)
+    {
+      monitor.RecordSubframe (config.budgetUs + 100);
+    }
+  NS_TEST_ASSERT_MSG_EQ (monitor.GetLevel (), NI_DEADLINE_LEVEL_CAP_PDUS, "maximum level not reached");
+  NS_TEST_ASSERT_MSG_EQ (monitor.GetNumSubframesAtLevel (NI_DEADLINE_LEVEL_NO_DEBUG_LOG), config.holdSubframes, "level changed before the hold time");
+  NS_TEST_ASSERT_MSG_EQ (monitor.GetNumMisses (), 10 * config.holdSubframes, "misses not counted");
+  NS_TEST_ASSERT_MSG_EQ (monitor.GetLastSlackUs (), -100, "wrong slack");
+
+  // subframes with enough slack restore all levels
+  for (uint32_t i = 0; i < 10 * config.holdSubframes; i++)
+    {
+      monitor.RecordSubframe (config.budgetUs - config.marginUs - 100);
+    }
+  NS_TEST_ASSERT_MSG_EQ (monitor.GetLevel (), NI_DEADLINE_LEVEL_NORMAL, "levels not restored");
+  NS_TEST_ASSERT_MSG_EQ (monitor.GetNumLevelChanges (), 2 * NI_DEADLINE_LEVEL_CAP_PDUS, "wrong number of level changes");
+  NS_TEST_ASSERT_MSG_LT (monitor.GetMissRate (), config.recoverRate, "miss rate not decayed");
+
+  // tight subframes within the budget degrade as well, but not beyond the maximum level
+  config.maxLevel = NI_DEADLINE_LEVEL_NO_DEBUG_LOG;
+  monitor.Configure (config);
+  for (uint32_t i = 0; i < 10 * config.holdSubframes; i++)
+    {
+      monitor.RecordSubframe (config.budgetUs - config.marginUs / 2);
+    }
+  NS_TEST_ASSERT_MSG_EQ (monitor.GetLevel (), NI_DEADLINE_LEVEL_NO_DEBUG_LOG, "maximum level exceeded");
+  NS_TEST_ASSERT_MSG_EQ (monitor.IsActive (NI_DEADLINE_LEVEL_NO_CQI), false, "level above the current one active");
+}
+
+class NiLteLinkAdaptationTestCase : public TestCase
+{
+public:
+  NiLteLinkAdaptationTestCase ();
+  virtual ~NiLteLinkAdaptationTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiLteLinkAdaptationTestCase::NiLteLinkAdaptationTestCase ()
+  : TestCase ("Link adaptation maps subband SINR onto resource blocks and converges to the BLER target")
+{
+}
+
+NiLteLinkAdaptationTestCase::~NiLteLinkAdaptationTestCase ()
+{
+}
+
+void
+NiLteLinkAdaptationTestCase::DoRun (void)
+{
+  NiLteLinkAdaptation linkAdaptation;
+  NiLinkAdaptationConfig config;
+  linkAdaptation.Configure (config);
+  const uint16_t rnti = 1;
+  std::vector<double> sinrPerRb;
+
+  NS_TEST_ASSERT_MSG_EQ (linkAdaptation.GetSinrPerRb (rnti, 25, &sinrPerRb), false, "SINR without report");
+
+  // the subbands are spread evenly over the resource blocks, the first report is taken unfiltered
+  const double subbandSinr[4] = {5.0, 10.0, 15.0, 20.0};
+  linkAdaptation.ReportSinr (rnti, 12.0, subbandSinr, 4);
+  NS_TEST_ASSERT_MSG_EQ (linkAdaptation.GetSinrPerRb (rnti, 25, &sinrPerRb), true, "SINR of reported RNTI missing");
+  NS_TEST_ASSERT_MSG_EQ (sinrPerRb.size (), 25, "wrong number of resource blocks");
+  NS_TEST_ASSERT_MSG_EQ_TOL (sinrPerRb[0], 5.0, 1e-9, "wrong SINR of first subband");
+  NS_TEST_ASSERT_MSG_EQ_TOL (sinrPerRb[6], 5.0, 1e-9, "wrong SINR at end of first subband");
+  NS_TEST_ASSERT_MSG_EQ_TOL (sinrPerRb[7], 10.0, 1e-9, "wrong SINR at start of second subband");
+  NS_TEST_ASSERT_MSG_EQ_TOL (sinrPerRb[24], 20.0, 1e-9, "wrong SINR of last subband");
+
+  // later reports are filtered
+  const double subbandSinr2[4] = {9.0, 10.0, 15.0, 20.0};
+  linkAdaptation.ReportSinr (rnti, 12.0, subbandSinr2, 4);
+  linkAdaptation.GetSinrPerRb (rnti, 25, &sinrPerRb);
+  NS_TEST_ASSERT_MSG_EQ_TOL (sinrPerRb[0], 5.0 + config.sinrAlpha * 4.0, 1e-9, "SINR not filtered");
+
+  // wideband only reports apply to all resource blocks
+  linkAdaptation.ReportSinr (rnti + 1, 7.0, NULL, 0);
+  linkAdaptation.GetSinrPerRb (rnti + 1, 6, &sinrPerRb);
+  NS_TEST_ASSERT_MSG_EQ_TOL (sinrPerRb[5], 7.0, 1e-9, "wrong wideband SINR");
+
+  // one error in 1 / blerTarget transport blocks keeps the offset where it is
+  linkAdaptation.ReportCrc (rnti + 1, false);
+  NS_TEST_ASSERT_MSG_EQ_TOL (linkAdaptation.GetOffsetDb (rnti + 1), -config.stepDownDb, 1e-9, "offset not stepped down");
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      linkAdaptation.ReportCrc (rnti + 1, (i % 10) != 9);
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (linkAdaptation.GetOffsetDb (rnti + 1), -config.stepDownDb, 1e-6, "offset drifts at the BLER target");
+  NS_TEST_ASSERT_MSG_EQ_TOL (linkAdaptation.GetBler (rnti + 1), config.blerTarget, 0.05, "wrong BLER");
+  NS_TEST_ASSERT_MSG_EQ (linkAdaptation.GetNumCrcErrors (rnti + 1), 101, "CRC errors not counted");
+  linkAdaptation.GetSinrPerRb (rnti + 1, 6, &sinrPerRb);
+  NS_TEST_ASSERT_MSG_EQ_TOL (sinrPerRb[0], 7.0 - config.stepDownDb, 1e-6, "offset not applied");
+
+  // errors only drive the offset to its lower limit, successes only to its upper one
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      linkAdaptation.ReportCrc (rnti, false);
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (linkAdaptation.GetOffsetDb (rnti), config.minOffsetDb, 1e-9, "lower offset limit exceeded");
+  for (uint32_t i = 0; i < 10000; i++)
+    {
+      linkAdaptation.ReportCrc (rnti, true);
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (linkAdaptation.GetOffsetDb (rnti), config.maxOffsetDb, 1e-9, "upper offset limit exceeded");
+  NS_TEST_ASSERT_MSG_LT (linkAdaptation.GetBler (rnti), 0.01, "BLER not decayed");
+}
+
+// Pipe transport without PHY side, tx messages are captured instead of written.
+class NiCaptureTransport : public NiPipeTransport
+{
+public:
+  NiCaptureTransport () : NiPipeTransport ("TEST"), m_numWrites (0) {}
+
+  std::vector<uint8_t> m_txBytes;
+  uint32_t m_numWrites;
+
+protected:
+  virtual int32_t OpenTransport (void) { return 0; }
+  virtual void CloseTransport (void) {}
+  virtual int32_t ReadTimingIndMsg (uint8_t* pBufU8, uint32_t maxLen) { return 0; }
+  virtual int32_t ReadRxMsg (uint8_t* pBufU8, uint32_t maxLen) { return 0; }
+  virtual int32_t WriteTxMsg (const struct iovec* pIov, int32_t iovCnt)
+  {
+    m_numWrites++;
+    for (int32_t i = 0; i < iovCnt; i++)
+      {
+        const uint8_t* pBase = (const uint8_t*) pIov[i].iov_base;
+        m_txBytes.insert (m_txBytes.end (), pBase, pBase + pIov[i].iov_len);
+      }
+    return m_txBytes.size ();
+  }
+};
+
+class NiDlTxMultiPduTestCase : public TestCase
+{
+public:
+  NiDlTxMultiPduTestCase ();
+  virtual ~NiDlTxMultiPduTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiDlTxMultiPduTestCase::NiDlTxMultiPduTestCase ()
+  : TestCase ("DLSCH PDUs of several UEs are sent as one config and payload request pair")
+{
+}
+
+NiDlTxMultiPduTestCase::~NiDlTxMultiPduTestCase ()
+{
+}
+
+void
+NiDlTxMultiPduTestCase::DoRun (void)
+{
+  const uint32_t numPdus = 3;
+  std::vector<uint8_t> macPdus[numPdus];
+  NiDlschTxPdu pdus[numPdus];
+  for (uint32_t i = 0; i < numPdus; i++)
+    {
+      macPdus[i].assign (100 + 50 * i, (uint8_t)(0xA0 + i));
+      pdus[i].prbAlloc = 0x7 << (3 * i);
+      pdus[i].rnti     = 10 + i;
+      pdus[i].mcs      = 5 + i;
+      pdus[i].macPdu   = macPdus[i].data ();
+      pdus[i].tbsSize  = macPdus[i].size ();
+    }
+
+  Ptr<NiCaptureTransport> transport = CreateObject<NiCaptureTransport> ();
+  transport->Init (0, 0);
+  transport->CreateAndSendDlTxReqMsgs (0, 0, pdus, numPdus);
+  transport->DeInit ();
+  NS_TEST_ASSERT_MSG_EQ (transport->m_numWrites, 1, "requests not sent with one write");
+
+  // config request with one DLSCH config / DCI DL grant parameter set pair per PDU
+  uint8_t* pBuf = transport->m_txBytes.data ();
+  uint32_t offset = 0;
+  uint32_t macPduIndex[numPdus];
+  uint32_t cceOffset[numPdus];
+  PhyDlTxConfigReq configReq;
+  DeserializePhyDlTxConfigReq (&configReq, pBuf, &offset);
+  NS_TEST_ASSERT_MSG_EQ (configReq.genMsgHdr.msgType, PHY_DL_TX_CONFIG_REQ, "wrong config message type");
+  NS_TEST_ASSERT_MSG_EQ (configReq.genMsgHdr.bodyLength, 8 + numPdus * PHY_DL_TX_CONFIG_PAR_SETS_SIZE, "wrong config body length");
+  NS_TEST_ASSERT_MSG_EQ (configReq.subMsgHdr.numSubMsg, 2 * numPdus, "wrong number of config parameter sets");
+  for (uint32_t i = 0; i < numPdus; i++)
+    {
+      if (i > 0)
+        {
+          DeserializePhyDlTxConfigReqParSets (&configReq, pBuf, &offset);
+        }
+      NS_TEST_ASSERT_MSG_EQ (configReq.dlschTxConfigBody.rnti, pdus[i].rnti, "wrong DLSCH rnti");
+      NS_TEST_ASSERT_MSG_EQ (configReq.dlschTxConfigBody.prbAllocation, pdus[i].prbAlloc, "wrong DLSCH PRB allocation");
+      NS_TEST_ASSERT_MSG_EQ (configReq.dciTxConfigDlGrantBody.mcs, pdus[i].mcs, "wrong DCI mcs");
+      macPduIndex[i] = configReq.dlschTxConfigBody.macPduIndex;
+      cceOffset[i] = configReq.dciTxConfigDlGrantBody.cceOffset;
+      if (i > 0)
+        {
+          NS_TEST_ASSERT_MSG_NE (macPduIndex[i], macPduIndex[i - 1], "PDUs share a MAC PDU index");
+          NS_TEST_ASSERT_MSG_NE (cceOffset[i], cceOffset[i - 1], "DCIs share a CCE offset");
+          NS_TEST_ASSERT_MSG_GT_OR_EQ (cceOffset[i], cceOffset[i - 1] + NI_PIPE_DL_DCI_NUM_CCE, "DCIs overlap on the PDCCH");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (offset, 8 + configReq.genMsgHdr.bodyLength, "config body length does not match its parameter sets");
+
+  // payload request with one MAC PDU parameter set per PDU, linked by the MAC PDU index
+  const uint32_t payloadStart = offset;
+  PhyTxPayloadReqHdr payloadReq;
+  DeserializePhyTxPayloadReqHdr (&payloadReq, pBuf, &offset);
+  NS_TEST_ASSERT_MSG_EQ (payloadReq.genMsgHdr.msgType, PHY_DL_TX_PAYLOAD_REQ, "wrong payload message type");
+  NS_TEST_ASSERT_MSG_EQ (payloadReq.subMsgHdr.numSubMsg, numPdus, "wrong number of payload parameter sets");
+  for (uint32_t i = 0; i < numPdus; i++)
+    {
+      if (i > 0)
+        {
+          DeserializePhyTxPayloadReqParSetHdr (&payloadReq, pBuf, &offset);
+        }
+      NS_TEST_ASSERT_MSG_EQ (payloadReq.macPduTxBodyHdr.macPduIndex, macPduIndex[i], "payload not linked to its config");
+      NS_TEST_ASSERT_MSG_EQ (payloadReq.macPduTxBodyHdr.macPduSize, pdus[i].tbsSize, "wrong MAC PDU size");
+      NS_TEST_ASSERT_MSG_EQ (memcmp (pBuf + offset, macPdus[i].data (), pdus[i].tbsSize), 0, "MAC PDU corrupted");
+      offset += pdus[i].tbsSize;
+    }
+  NS_TEST_ASSERT_MSG_EQ (offset - payloadStart, 8 + payloadReq.genMsgHdr.bodyLength, "payload body length does not match its parameter sets");
+  NS_TEST_ASSERT_MSG_EQ (offset, transport->m_txBytes.size (), "unexpected bytes after the payload request");
+}
+
+// Two AFW instances emulated in threads, their pipes are served by one reactor thread.
+static void
+NiPipeReactorRunEmulator (NiLtePhyEmulator* pEmulator)
+{
+  if (pEmulator->Open () == 0)
+    {
+      pEmulator->Run (0);
+    }
+}
+
+static bool
+NiPipeReactorRxCallback (uint32_t* pNumRx, uint8_t* macPdu, uint32_t macPduSize)
+{
+  (*pNumRx)++;
+  return true;
+}
+
+class NiPipeReactorTestCase : public TestCase
+{
+public:
+  NiPipeReactorTestCase ();
+  virtual ~NiPipeReactorTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NiPipeReactorTestCase::NiPipeReactorTestCase ()
+  : TestCase ("Pipes of several AFW instances are served by one reactor thread")
+{
+}
+
+NiPipeReactorTestCase::~NiPipeReactorTestCase ()
+{
+}
+
+void
+NiPipeReactorTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (NiPipeTransport::GetPipeName (0, NI_PIPE_IDX_RX), std::string (NI_PIPE_NAME_RX), "instance 0 does not use the AFW pipe names");
+  NS_TEST_ASSERT_MSG_EQ (NiPipeTransport::GetPipeName (3, NI_PIPE_IDX_TX), std::string ("/tmp/api_transport_3-1_pipe"), "wrong pipe name");
+
+  const uint32_t numInstances = 2;
+  const uint32_t firstInstance = NI_PIPE_MAX_INSTANCES - numInstances;
+  NiLtePhyEmulator emulators[numInstances];
+  std::thread emulatorThreads[numInstances];
+  Ptr<NiPipeTransport> transports[numInstances];
+  uint32_t numRx[numInstances] = {0};
+  for (uint32_t i = 0; i < numInstances; i++)
+    {
+      const uint32_t instance = firstInstance + i;
+      emulators[i].SetInstanceId (instance);
+      emulators[i].SetCellMeasPeriodTti (0);
+      emulatorThreads[i] = std::thread (NiPipeReactorRunEmulator, &emulators[i]);
+      // the transport can connect once the emulator created its pipes
+      struct stat pipeStat;
+      while (stat (NiPipeTransport::GetPipeName (instance, NI_PIPE_IDX_RX).c_str (), &pipeStat) != 0)
+        {
+          usleep (1000);
+        }
+      transports[i] = CreateObject<NiPipeTransport> ("TEST");
+      transports[i]->SetInstanceId (instance);
+      transports[i]->SetRxMode (NI_PIPE_RX_MODE_EPOLL);
+      // UE role, so looped back DLSCH RX indications reach the callback
+      transports[i]->SetNiApiDevType (1);
+      transports[i]->SetNiApiDataEndOkCallback (MakeBoundCallback (&NiPipeReactorRxCallback, &numRx[i]));
+      transports[i]->Init (0, 0);
+    }
+  NS_TEST_ASSERT_MSG_EQ (g_NiPipeReactor.GetNumTransports (), numInstances, "transports not registered at the reactor");
+
+  NiPhyTimingSnapshot snapshot;
+  for (uint32_t i = 0; i < numInstances; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (transports[i]->WaitForTimingInd (0, &snapshot, 0, 100000000), true, "no timing indication of instance " << i);
+    }
+
+  // a PDU sent to the second instance is only delivered to its callback
+  std::vector<uint8_t> macPdu (64, 0x5A);
+  NiDlschTxPdu pdu = {0x3, 1, 10, macPdu.data (), (uint32_t) macPdu.size ()};
+  transports[1]->GetTimingSnapshot (&snapshot);
+  transports[1]->CreateAndSendDlTxReqMsgs (snapshot.sfn, snapshot.tti, &pdu, 1);
+  for (uint32_t wait = 0; (wait < 100) && (numRx[1] == 0); wait++)
+    {
+      usleep (1000);
+    }
+
+  // stop the PHY side first, it must not write to pipes already closed by the transport
+  for (uint32_t i = 0; i < numInstances; i++)
+    {
+      emulators[i].Stop ();
+      emulatorThreads[i].join ();
+      transports[i]->DeInit ();
+      NS_TEST_ASSERT_MSG_EQ (g_NiPipeReactor.GetNumTransports (), numInstances - 1 - i, "transport not unregistered");
+      emulators[i].Close ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (numRx[0], 0, "PDU delivered to the wrong instance");
+  NS_TEST_ASSERT_MSG_EQ (numRx[1], 1, "PDU not delivered to its instance");
+  NS_TEST_ASSERT_MSG_EQ (g_NiPipeReactor.GetMaxNumTransports (), numInstances, "instances not served by one reactor");
+  NS_TEST_ASSERT_MSG_GT (g_NiPipeReactor.GetThreadStats ().numWakeups, 0, "reactor thread did not run");
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -61,6 +1533,23 @@ NiTestSuite::NiTestSuite ()
 {
   // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
   AddTestCase (new NiTestCase1, TestCase::QUICK);
+  AddTestCase (new NiSpscRingTestCase, TestCase::QUICK);
+  AddTestCase (new NiShmRingTestCase, TestCase::QUICK);
+  AddTestCase (new NiApiCodecTestCase, TestCase::QUICK);
+  AddTestCase (new NiSeqlockTestCase, TestCase::QUICK);
+  AddTestCase (new NiWifiTxEncoderTestCase, TestCase::QUICK);
+  AddTestCase (new NiLoggingFatalTestCase, TestCase::QUICK);
+  AddTestCase (new NiTraceFileTestCase, TestCase::QUICK);
+  AddTestCase (new NiCaptureFileTestCase, TestCase::QUICK);
+  AddTestCase (new NiLatencyHistogramTestCase, TestCase::QUICK);
+  AddTestCase (new NiParameterDataBaseTestCase, TestCase::QUICK);
+  AddTestCase (new NiRemoteControlEngineTestCase, TestCase::QUICK);
+  AddTestCase (new NiThreadTopologyTestCase, TestCase::QUICK);
+  AddTestCase (new NiAllocScopeTestCase, TestCase::QUICK);
+  AddTestCase (new NiLteDeadlineMonitorTestCase, TestCase::QUICK);
+  AddTestCase (new NiLteLinkAdaptationTestCase, TestCase::QUICK);
+  AddTestCase (new NiDlTxMultiPduTestCase, TestCase::QUICK);
+  AddTestCase (new NiPipeReactorTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
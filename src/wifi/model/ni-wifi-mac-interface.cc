@@ -165,6 +165,17 @@ namespace ns3
                          BooleanValue (false),
                          MakeBooleanAccessor (&NiWifiMacInterface::m_NiApiConfirmationMessage),
                          MakeBooleanChecker ())
+          .AddAttribute ("niApiWifiUdpBatchSize",
+                         "Number of datagrams per recvmmsg / sendmmsg call of the UDP transport (1 = recvfrom / sendto)",
+                         UintegerValue (16),
+                         MakeUintegerAccessor (&NiWifiMacInterface::m_niApiWifiUdpBatchSize),
+                         MakeUintegerChecker<uint32_t> (1, NI_UDP_MAX_BATCH_SIZE))
+          .AddAttribute ("niApiWifiStaMacAddrList",
+                         "Comma separated MAC addresses of the stations in the order of their UDP ports (AP in UDP Loopback mode), "
+                         "frames to other addresses are sent to all stations",
+                         StringValue (""),
+                         MakeStringAccessor (&NiWifiMacInterface::m_niApiWifiStaMacAddrList),
+                         MakeStringChecker ())
           .AddAttribute ("enableNiApi",
                          "Activate/Deactivate NI API Code.",
                          BooleanValue (false),
@@ -295,43 +306,45 @@ namespace ns3
     int ns3Priority = NiUtils::GetThreadPrioriy();
     const int rxThreadPriority = ns3Priority - 5;
 
+    // parse the configured MAC addresses once instead of per transmitted MSDU,
+    // addresses not needed by the configured mode are left empty
+    const std::string* macAddrStrings[5] = {&m_niApiWifiApMacAddress, &m_niApiWifiStaMacAddress,
+        &m_niApiWifiBssidMacAddress, &m_niApiWifiSta1MacAddr, &m_niApiWifiSta2MacAddr};
+    Mac48Address* macAddrs[5] = {&m_niApiWifiApMac48, &m_niApiWifiStaMac48,
+        &m_niApiWifiBssidMac48, &m_niApiWifiSta1Mac48, &m_niApiWifiSta2Mac48};
+    for (uint32_t i = 0; i < 5; i++)
+      {
+        if (!macAddrStrings[i]->empty())
+          {
+            *macAddrs[i] = Mac48Address(macAddrStrings[i]->c_str());
+          }
+      }
+
     if ((m_ns3WifiDevType == NS3_AP) && ((m_niApiWifiDevType == NIAPI_AP)||(m_niApiWifiDevType==NIAPI_WIFI_ALL)))
       {
         if(m_enableNiApiLoopback)
           {
-            uint32_t niApiWifiApRemotePortTx = std::stoi (m_niApiWifiApRemotePortTx.c_str());
+            // one tx socket for all stations, station i listens on the remote port + i
+            m_wifiNiUdpTransport = CreateObject <NiUdpTransport> ("WIFI");
+            m_wifiNiUdpTransport->SetBatchSize(m_niApiWifiUdpBatchSize);
+            m_wifiNiUdpTransport->SetNiApiDataEndOkCallback (MakeCallback (&NiWifiMacInterface::NiStartRxCtrlDataFrame, this));
 
-            for (uint32_t index = 0; index < m_NumOfStations; ++index)
+            NI_LOG_CONSOLE_DEBUG("Initialize AP UDP Tx Socket for " << m_NumOfStations << " stations");
+            m_wifiNiUdpTransport->OpenUdpSocketTx(m_niApiWifiApRemoteIpAddrTx, m_niApiWifiApRemotePortTx);
+            const uint32_t niApiWifiApRemotePortTx = std::stoi (m_niApiWifiApRemotePortTx);
+            for (uint32_t index = 1; index < m_NumOfStations; ++index)
               {
-                // FIXME-NI: Dangerous! Array has 10 elements but m_NumOfStations can be >10, wich leads to segmentation faults
-                m_wifiNiUdpTransportArray[index] = CreateObject <NiUdpTransport> ("WIFI_" + std::to_string(index));
-
-                // create udp transport object from AP to STA1 in Infrastructure mode
-                NI_LOG_CONSOLE_DEBUG("Initialize AP UDP Tx Socket" << index);
-                m_wifiNiUdpTransportArray[index]->OpenUdpSocketTx(m_niApiWifiApRemoteIpAddrTx, m_niApiWifiApRemotePortTx);
-
-                niApiWifiApRemotePortTx++;
-                std::stringstream temp;
-                temp << niApiWifiApRemotePortTx;
-                m_niApiWifiApRemotePortTx = temp.str();
-
-                //				// set callback function for rx packets
-                //				m_wifiNiUdpTransportArray[index]->SetNiApiDataEndOkCallback (MakeCallback (&NiWifiMacInterface::NiStartRxCtrlDataFrame, this));
-                //
-                //				NI_LOG_CONSOLE_DEBUG("Initialize AP UDP Rx Socket");
-                //				m_wifiNiUdpTransportArray[index]->OpenUdpSocketRx(m_niApiWifiApLocalPortRx);
+                m_wifiNiUdpTransport->AddTxDestination(m_niApiWifiApRemoteIpAddrTx, std::to_string(niApiWifiApRemotePortTx + index));
               }
-
-            // set callback function for rx packets
-            m_wifiNiUdpTransportArray[0]->SetNiApiDataEndOkCallback (MakeCallback (&NiWifiMacInterface::NiStartRxCtrlDataFrame, this));
+            InitializeNiWifiStaTable();
 
             NI_LOG_CONSOLE_DEBUG("Initialize AP UDP Rx Socket");
-            m_wifiNiUdpTransportArray[0]->OpenUdpSocketRx(m_niApiWifiApLocalPortRx, rxThreadPriority);
+            m_wifiNiUdpTransport->OpenUdpSocketRx(m_niApiWifiApLocalPortRx, rxThreadPriority);
           }
         else
           {
-            // TODO-NI: member m_wifiNiUdpTransport should be replaced by m_wifiNiUdpTransportArray[0]
             m_wifiNiUdpTransport = CreateObject <NiUdpTransport> ("WIFI");
+            m_wifiNiUdpTransport->SetBatchSize(m_niApiWifiUdpBatchSize);
             //    // set callback function for rx packets
             m_wifiNiUdpTransport->SetNiApiDataEndOkCallback (MakeCallback (&NiWifiMacInterface::NiStartRxCtrlDataFrame, this));
 
@@ -345,6 +358,7 @@ namespace ns3
             if (m_NiApiConfirmationMessage)
 				{
 					m_wifiNiUdpTxCNF = CreateObject <NiUdpTransport> ("WIFI_txCNF");
+					m_wifiNiUdpTxCNF->SetBatchSize(m_niApiWifiUdpBatchSize);
 
 					NI_LOG_CONSOLE_DEBUG("Initialize AP UDP TX confirmation receive Socket");
 					m_wifiNiUdpTxCNF->OpenUdpSocketRx("12501",rxThreadPriority);
@@ -360,6 +374,7 @@ namespace ns3
     else if ((m_ns3WifiDevType == NS3_STA)  && ((m_niApiWifiDevType == NIAPI_STA)||(m_niApiWifiDevType==NIAPI_WIFI_ALL)))
       {
         m_wifiNiUdpTransport = CreateObject <NiUdpTransport> ("WIFI");
+        m_wifiNiUdpTransport->SetBatchSize(m_niApiWifiUdpBatchSize);
         // set callback function for rx packets
         m_wifiNiUdpTransport->SetNiApiDataEndOkCallback (MakeCallback (&NiWifiMacInterface::NiStartRxCtrlDataFrame, this));
 
@@ -374,6 +389,7 @@ namespace ns3
         if ((m_NiApiConfirmationMessage)&&(!m_enableNiApiLoopback))
         {
         	m_wifiNiUdpTxCNF = CreateObject <NiUdpTransport> ("WIFI_txCNF");
+        	m_wifiNiUdpTxCNF->SetBatchSize(m_niApiWifiUdpBatchSize);
 
         	NI_LOG_CONSOLE_DEBUG("Initialize STA UDP TX confirmation receive Socket");
         	m_wifiNiUdpTxCNF->OpenUdpSocketRx("12502",rxThreadPriority);
@@ -385,6 +401,7 @@ namespace ns3
     else if ((m_ns3WifiDevType == NS3_ADHOC)  && (m_niApiWifiDevType == NIAPI_STA1))
       {
         m_wifiNiUdpTransport = CreateObject <NiUdpTransport> ("WIFI");
+        m_wifiNiUdpTransport->SetBatchSize(m_niApiWifiUdpBatchSize);
         // set callback function for rx packets
         m_wifiNiUdpTransport->SetNiApiDataEndOkCallback (MakeCallback (&NiWifiMacInterface::NiStartRxCtrlDataFrame, this));
 
@@ -398,6 +415,7 @@ namespace ns3
         if ((m_NiApiConfirmationMessage)&&(!m_enableNiApiLoopback))
 			{
 				m_wifiNiUdpTxCNF = CreateObject <NiUdpTransport> ("WIFI_txCNF");
+				m_wifiNiUdpTxCNF->SetBatchSize(m_niApiWifiUdpBatchSize);
 
 				NI_LOG_CONSOLE_DEBUG("Initialize STA1 UDP TX confirmation receive Socket");
 				m_wifiNiUdpTxCNF->OpenUdpSocketRx("12501",rxThreadPriority);
@@ -409,6 +427,7 @@ namespace ns3
     else if ((m_ns3WifiDevType == NS3_ADHOC)  && (m_niApiWifiDevType == NIAPI_STA2))
       {
         m_wifiNiUdpTransport = CreateObject <NiUdpTransport> ("WIFI");
+        m_wifiNiUdpTransport->SetBatchSize(m_niApiWifiUdpBatchSize);
         // set callback function for rx packets
         m_wifiNiUdpTransport->SetNiApiDataEndOkCallback (MakeCallback (&NiWifiMacInterface::NiStartRxCtrlDataFrame, this));
 
@@ -422,6 +441,7 @@ namespace ns3
         if ((m_NiApiConfirmationMessage)&&(!m_enableNiApiLoopback))
 			{
 				m_wifiNiUdpTxCNF = CreateObject <NiUdpTransport> ("WIFI_txCNF");
+				m_wifiNiUdpTxCNF->SetBatchSize(m_niApiWifiUdpBatchSize);
 
 				NI_LOG_CONSOLE_DEBUG("Initialize STA2 UDP TX confirmation receive Socket");
 				m_wifiNiUdpTxCNF->OpenUdpSocketRx("12502",rxThreadPriority);
@@ -434,6 +454,42 @@ namespace ns3
     return;
   }
 
+  void
+  NiWifiMacInterface::InitializeNiWifiStaTable()
+  {
+    // MAC addresses of the stations in the order of their UDP ports, stations
+    // without entry are only reached by the fan out to all stations
+    m_niApiWifiStaTable.clear();
+    std::stringstream macAddrList (m_niApiWifiStaMacAddrList);
+    std::string macAddr;
+    uint32_t index = 0;
+    while (std::getline (macAddrList, macAddr, ','))
+      {
+        if (index >= m_wifiNiUdpTransport->GetNumTxDestinations())
+          {
+            NI_LOG_FATAL("niApiWifiStaMacAddrList has more entries than NumOfStations");
+          }
+        m_niApiWifiStaTable[Mac48Address(macAddr.c_str())] = index++;
+      }
+    NI_LOG_DEBUG("Station table with " << m_niApiWifiStaTable.size() << " MAC addresses for " <<
+                 m_wifiNiUdpTransport->GetNumTxDestinations() << " stations");
+  }
+
+  void
+  NiWifiMacInterface::NiSendToStations(Mac48Address destination, uint8_t* const* p_buffers, const uint32_t* p_bufferSizes, uint32_t numBuffers)
+  {
+    std::map<Mac48Address, uint32_t>::const_iterator it = m_niApiWifiStaTable.find (destination);
+    if ((it != m_niApiWifiStaTable.end ()) && !destination.IsGroup ())
+      {
+        m_wifiNiUdpTransport->SendToUdpSocketTxMsgs(it->second, p_buffers, p_bufferSizes, numBuffers);
+      }
+    else
+      {
+        // group addressed or unknown station - one copy per station in one syscall batch
+        m_wifiNiUdpTransport->SendToUdpSocketTxMsgs(NI_UDP_TX_ALL_DESTINATIONS, p_buffers, p_bufferSizes, numBuffers);
+      }
+  }
+
   void
   NiWifiMacInterface::DeInitializeNiUdpTransport()
   {
@@ -616,9 +672,100 @@ namespace ns3
 
   }
 
+  // Encodes TX Config Req and TX Payload Req of one MSDU in a single pass.
+  void
+  NiWifiMacInterface::NiEncodeTxReqs(
+      Ptr<const Packet> packet,
+      const WifiMacHeader& hdr,
+      const Mac48Address txAddr[3],
+      uint8_t staType,
+      uint8_t* p_configReqBuffer,
+      uint32_t* p_configReqSize,
+      uint8_t* p_payloadReqBuffer,
+      uint32_t* p_payloadReqSize,
+      uint32_t payloadReqBufferSize
+  )
+  {
+    const uint32_t instId = (staType == 0) ? 1 : ((staType == 1) ? 2 : 0);
+
+    // The MSDU is the serialized combined packet. Its metadata and byte tag offsets depend on the
+    // WifiMacHeader, so the header still has to be added to a (copy on write) copy of the packet,
+    // which is then serialized directly behind the TX Payload Req header.
+    Ptr<Packet> combinedPacket = packet->Copy ();
+    combinedPacket->AddHeader (hdr);
+    const uint32_t msduLength = combinedPacket->GetSerializedSize ();
+    // MSDU length is limited by MsduTxPayload::msduData
+    if ((msduLength > 4065) || (TX_PAYLOAD_REQ_HDR_SIZE + msduLength > payloadReqBufferSize) ||
+        (combinedPacket->Serialize (p_payloadReqBuffer + TX_PAYLOAD_REQ_HDR_SIZE, msduLength) == 0))
+      {
+        NI_LOG_FATAL ("NiWifiMacInterface::NiEncodeTxReqs: MSDU of " << msduLength << " bytes exceeds TX Payload Req");
+        *p_configReqSize = *p_payloadReqSize = 0;
+        return;
+      }
+    *p_payloadReqSize = EncodeTxPayloadReqHdr (p_payloadReqBuffer, instId, msduLength) + msduLength;
+
+    uint32_t frameType = 0;
+    uint32_t subType = 0;
+    if (hdr.IsMgt ())
+      {
+        subType = hdr.GetType ();
+      }
+    else if (hdr.IsCtl ())
+      {
+        frameType = 1;
+      }
+    else if (hdr.IsData ())
+      {
+        frameType = 2;
+      }
+
+    uint8_t destAddr[6], sourceAddr[6], bssid[6];
+    txAddr[0].CopyTo (destAddr);
+    txAddr[1].CopyTo (sourceAddr);
+    txAddr[2].CopyTo (bssid);
+
+    *p_configReqSize = EncodeTxConfigReq (p_configReqBuffer, instId, frameType, subType,
+                                          hdr.IsToDs () ? 1 : 0, hdr.IsFromDs () ? 1 : 0,
+                                          destAddr, sourceAddr, bssid, msduLength, m_niApiWifiMcs);
+  }
+
+  void
+  NiWifiMacInterface::NiSendTxReqs (Mac48Address destination, bool printMsgContent)
+  {
+    if (m_bufferSizeTxConfigReq == 0)
+      {
+        return;
+      }
+    uint8_t* buffers[2] = {m_bufferTxConfigReq, m_bufferTx};
+    const uint32_t bufferSizes[2] = {m_bufferSizeTxConfigReq, m_bufferOffsetTx};
+
+    if (printMsgContent)
+      {
+        // print packet contents
+        PrintBufferU8(m_bufferTxConfigReq, &m_bufferSizeTxConfigReq, 36);
+        PrintBufferU8(m_bufferTx, &m_bufferOffsetTx, 34);
+      }
+
+    // hand the TX Config Req / TX Payload Req pair to the socket in one call
+    if ((m_ns3WifiDevType == NS3_AP) && m_enableNiApiLoopback)
+      {
+        NiSendToStations(destination, buffers, bufferSizes, 2);
+      }
+    else
+      {
+        m_wifiNiUdpTransport->SendToUdpSocketTxMsgs(0, buffers, bufferSizes, 2);
+      }
+
+    // reset buffer
+    m_bufferOffsetTx = 0;
+  }
+
   void
   NiWifiMacInterface::NiStartTxCtrlDataFrame(Ptr<const Packet> packet, WifiMacHeader hdr)
   {
+    // MAC addresses of the TX Config Req
+    Mac48Address txAddr[3] = {hdr.GetAddr1 (), hdr.GetAddr2 (), hdr.GetAddr3 ()};
+
     if ((m_ns3WifiDevType == NS3_AP) && ((m_niApiWifiDevType == NIAPI_AP)||(m_niApiWifiDevType==NIAPI_WIFI_ALL)))
       {
         NI_LOG_DEBUG ("AP Tx Start with packet of size = " << packet->GetSerializedSize() << " bytes");
@@ -634,119 +781,35 @@ namespace ns3
          *	the ns-3 packet.
          */
 
-        // create combined packet consisting of the ns-3 WifiMacHeader and the ns-3 packet
-        Ptr<const Packet> combinedPacket = NiCreateCombinedPacket(packet, hdr);
-
-        // modify the header's MAC addresses to make it work with 802.11 AFW
-        // Note that the original WifiMacHeader contents are still available in combinedPacket!
+        // modify the TX Config Req MAC addresses to make it work with 802.11 AFW
+        // Note that the original WifiMacHeader contents are still sent in the MSDU!
         if(!m_enableNiApiLoopback)
           {
-            hdr.SetAddr1 (Mac48Address(m_niApiWifiStaMacAddress.c_str()));	//assign destination address
-            hdr.SetAddr2 (Mac48Address(m_niApiWifiApMacAddress.c_str()));	//assign source address
-            hdr.SetAddr3 (Mac48Address(m_niApiWifiBssidMacAddress.c_str()));
+            txAddr[0] = m_niApiWifiStaMac48;	//assign destination address
+            txAddr[1] = m_niApiWifiApMac48;	//assign source address
+            txAddr[2] = m_niApiWifiBssidMac48;
           }
 
-        // create TX Configuration Request message
         // Note: Station type is hard-coded to zero.
-        NiCreateTxConfigReq(combinedPacket, hdr, m_niApiWifiMcs, m_bufferTx, &m_bufferOffsetTx, 0);
-
-        if (m_niApiWifiEnablePrintMsgContent && hdr.IsData())
-          {
-            // print packet contents
-            PrintBufferU8(m_bufferTx, &m_bufferOffsetTx, 36);
-          }
-
-        // send serialized TX Configuration Request message to the UDP socket
-        if(!m_enableNiApiLoopback)
-          {
-            m_wifiNiUdpTransport->SendToUdpSocketTx(m_bufferTx, m_bufferOffsetTx);
-          }
-        else
-          {
-            for (uint8_t index = 0; index < m_NumOfStations; ++index)
-              {
-                m_wifiNiUdpTransportArray[index]->SendToUdpSocketTx(m_bufferTx, m_bufferOffsetTx);
-              }
-          }
-
-        // reset buffer
-        m_bufferOffsetTx = 0;
-
-        // create TX Payload Request message
-        // Note: Station type is hard-coded to zero.
-        NiCreateTxPayloadReq(combinedPacket, m_bufferTx, &m_bufferOffsetTx, 0);
-
-        if (m_niApiWifiEnablePrintMsgContent && hdr.IsData())
-          {
-            // print packet contents
-            PrintBufferU8(m_bufferTx, &m_bufferOffsetTx, 34);
-          }
-
-        // send serialized TX Configuration Request message to the UDP socket
-        if(!m_enableNiApiLoopback)
-          {
-            m_wifiNiUdpTransport->SendToUdpSocketTx(m_bufferTx, m_bufferOffsetTx);
-          }
-        else
-          {
-            for (uint8_t index = 0; index < m_NumOfStations; ++index)
-              {
-                m_wifiNiUdpTransportArray[index]->SendToUdpSocketTx(m_bufferTx, m_bufferOffsetTx);
-              }
-          }
-
-        // reset buffer
-        m_bufferOffsetTx = 0;
+        NiEncodeTxReqs(packet, hdr, txAddr, 0, m_bufferTxConfigReq, &m_bufferSizeTxConfigReq,
+                       m_bufferTx, &m_bufferOffsetTx, sizeof(m_bufferTx));
+        NiSendTxReqs(txAddr[0], m_niApiWifiEnablePrintMsgContent && hdr.IsData());
       }
     else if ((m_ns3WifiDevType == NS3_STA)  && ((m_niApiWifiDevType == NIAPI_STA)||(m_niApiWifiDevType==NIAPI_WIFI_ALL)))
       {
         NI_LOG_DEBUG ("STA Tx Start with packet of size = " << packet->GetSerializedSize() << " bytes");
 
-        // create combined packet consisting of the ns-3 WifiMacHeader and the ns-3 packet
-        Ptr<const Packet> combinedPacket = NiCreateCombinedPacket(packet, hdr);
-
-        // modify the header's MAC addresses to make it work with 802.11 AFW
-        // Note that the original WifiMacHeader contents are still available in combinedPacket!
+        // modify the TX Config Req MAC addresses to make it work with 802.11 AFW
         if(!m_enableNiApiLoopback)
           {
-            hdr.SetAddr1 (Mac48Address(m_niApiWifiApMacAddress.c_str()));			//assign destination address
-            hdr.SetAddr2 (Mac48Address(m_niApiWifiStaMacAddress.c_str()));		//assign source address
-            hdr.SetAddr3 (Mac48Address(m_niApiWifiBssidMacAddress.c_str()));
+            txAddr[0] = m_niApiWifiApMac48;	//assign destination address
+            txAddr[1] = m_niApiWifiStaMac48;	//assign source address
+            txAddr[2] = m_niApiWifiBssidMac48;
           }
 
-        // create TX Configuration Request message
-        // Note: Station type is hard-coded to zero.
-        NiCreateTxConfigReq(combinedPacket, hdr, m_niApiWifiMcs, m_bufferTx, &m_bufferOffsetTx, 1);
-
-        if (m_niApiWifiEnablePrintMsgContent)
-          {
-            // print packet contents
-            PrintBufferU8(m_bufferTx, &m_bufferOffsetTx, 36);
-          }
-
-        // send serialized TX Configuration Request message to the UDP socket
-        //NIWifiApiSendToUdpSocketTx(m_bufferTx, m_bufferOffsetTx);
-        m_wifiNiUdpTransport->SendToUdpSocketTx(m_bufferTx, m_bufferOffsetTx);
-
-        // reset buffer
-        m_bufferOffsetTx = 0;
-
-        // create TX Payload Request message
-        // Note: Station type is hard-coded to zero.
-        NiCreateTxPayloadReq(combinedPacket, m_bufferTx, &m_bufferOffsetTx, 1);
-
-        if (m_niApiWifiEnablePrintMsgContent)
-          {
-            // print packet contents
-            PrintBufferU8(m_bufferTx, &m_bufferOffsetTx, 34);
-          }
-
-        // send serialized TX Configuration Request message to the UDP socket
-        //NIWifiApiSendToUdpSocketTx(m_bufferTx, m_bufferOffsetTx);
-        m_wifiNiUdpTransport->SendToUdpSocketTx(m_bufferTx, m_bufferOffsetTx);
-
-        // reset buffer
-        m_bufferOffsetTx = 0;
+        NiEncodeTxReqs(packet, hdr, txAddr, 1, m_bufferTxConfigReq, &m_bufferSizeTxConfigReq,
+                       m_bufferTx, &m_bufferOffsetTx, sizeof(m_bufferTx));
+        NiSendTxReqs(txAddr[0], m_niApiWifiEnablePrintMsgContent);
       }
     else if (m_ns3WifiDevType == NS3_ADHOC)
       {
@@ -755,58 +818,28 @@ namespace ns3
 
         uint8_t adhoc_staType = 0; //local variable for TX Configuration Request message. Initialized to 0.
 
-        // create combined packet consisting of the ns-3 WifiMacHeader and the ns-3 packet
-        Ptr<const Packet> combinedPacket = NiCreateCombinedPacket(packet, hdr);
-
-        // modify the header's MAC addresses to make it work with 802.11 AFW
-        // Note that the original WifiMacHeader contents are still available in combinedPacket!
+        // modify the TX Config Req MAC addresses to make it work with 802.11 AFW
         if(!m_enableNiApiLoopback)
           {
             if (m_niApiWifiDevType == NIAPI_STA1)
               {
-                hdr.SetAddr1 (Mac48Address(m_niApiWifiSta2MacAddr.c_str()));	//assign destination address
-                hdr.SetAddr2 (Mac48Address(m_niApiWifiSta1MacAddr.c_str()));	//assign source address
+                txAddr[0] = m_niApiWifiSta2Mac48;	//assign destination address
+                txAddr[1] = m_niApiWifiSta1Mac48;	//assign source address
                 adhoc_staType = 0; // Set to 0 for station 1
               }
             else if (m_niApiWifiDevType == NIAPI_STA2)
               {
-                hdr.SetAddr1 (Mac48Address(m_niApiWifiSta1MacAddr.c_str()));	//assign destination address
-                hdr.SetAddr2 (Mac48Address(m_niApiWifiSta2MacAddr.c_str()));	//assign source address
+                txAddr[0] = m_niApiWifiSta1Mac48;	//assign destination address
+                txAddr[1] = m_niApiWifiSta2Mac48;	//assign source address
                 adhoc_staType = 1; // Set to 1 for station 2
               }
 
-            hdr.SetAddr3 (Mac48Address(m_niApiWifiBssidMacAddress.c_str()));
-          }
-
-        // create TX Configuration Request message
-        NiCreateTxConfigReq(combinedPacket, hdr, m_niApiWifiMcs, m_bufferTx, &m_bufferOffsetTx, adhoc_staType);
-
-        if (m_niApiWifiEnablePrintMsgContent)
-          {
-            // print packet contents
-            PrintBufferU8 (m_bufferTx, &m_bufferOffsetTx, 36);
+            txAddr[2] = m_niApiWifiBssidMac48;
           }
 
-        // send serialized TX Configuration Request message to the UDP socket
-        m_wifiNiUdpTransport->SendToUdpSocketTx(m_bufferTx, m_bufferOffsetTx);
-
-        // reset buffer
-        m_bufferOffsetTx = 0;
-
-        // create TX Payload Request message
-        NiCreateTxPayloadReq(combinedPacket, m_bufferTx, &m_bufferOffsetTx, adhoc_staType);
-
-        // print packet contents
-        if (m_niApiWifiEnablePrintMsgContent)
-          {
-            PrintBufferU8 (m_bufferTx, &m_bufferOffsetTx, 34);
-          }
-
-        // send serialized TX Configuration Request message to the UDP socket
-        m_wifiNiUdpTransport->SendToUdpSocketTx(m_bufferTx, m_bufferOffsetTx);
-
-        // reset buffer
-        m_bufferOffsetTx = 0;
+        NiEncodeTxReqs(packet, hdr, txAddr, adhoc_staType, m_bufferTxConfigReq, &m_bufferSizeTxConfigReq,
+                       m_bufferTx, &m_bufferOffsetTx, sizeof(m_bufferTx));
+        NiSendTxReqs(txAddr[0], m_niApiWifiEnablePrintMsgContent);
 
       }else {
           // do nothing
@@ -111,6 +111,21 @@ namespace ns3{
         uint8_t staType
     );
 
+    // Encodes TX Config Req and TX Payload Req of one MSDU in a single pass, byte-identical to
+    // NiCreateTxConfigReq / NiCreateTxPayloadReq of the combined packet but without the intermediate
+    // message structs. The TX Config Req carries the MAC addresses txAddr instead of the ones of hdr.
+    void NiEncodeTxReqs(
+        Ptr<const Packet> packet,
+        const WifiMacHeader& hdr,
+        const Mac48Address txAddr[3],
+        uint8_t staType,
+        uint8_t* p_configReqBuffer,
+        uint32_t* p_configReqSize,
+        uint8_t* p_payloadReqBuffer,
+        uint32_t* p_payloadReqSize,
+        uint32_t payloadReqBufferSize
+    );
+
   private:
 
     void SetNiWifiDevType (std::string type);
@@ -121,6 +136,13 @@ namespace ns3{
     void InitializeNiUdpTransport();
     void DeInitializeNiUdpTransport();
 
+    // station table of the AP in UDP Loopback mode
+    void InitializeNiWifiStaTable();
+    void NiSendToStations(Mac48Address destination, uint8_t* const* p_buffers, const uint32_t* p_bufferSizes, uint32_t numBuffers);
+
+    // sends the encoded TX Config Req / TX Payload Req pair with one call to the UDP transport
+    void NiSendTxReqs (Mac48Address destination, bool printMsgContent);
+
     // Identifies the received messages type ID by extracting the first four bytes.
     uint16_t GetMsgTypeId (uint8_t* p_buffer);
 
@@ -162,9 +184,11 @@ namespace ns3{
 
     uint32_t m_NumOfStations;
 
-    Ptr<NiUdpTransport> m_wifiNiUdpTransport; // TODO-NI: remove
+    Ptr<NiUdpTransport> m_wifiNiUdpTransport;
 
-    Ptr<NiUdpTransport> m_wifiNiUdpTransportArray[10]; // TODO-NI: replace magic number by define / constant value which can be used for sanity checks
+    // MAC address of a station -> tx destination of m_wifiNiUdpTransport (AP in UDP Loopback mode)
+    std::map<Mac48Address, uint32_t> m_niApiWifiStaTable;
+    std::string m_niApiWifiStaMacAddrList;
 
     Ptr<NiUdpTransport> m_wifiNiUdpTxCNF;
 
@@ -192,9 +216,19 @@ namespace ns3{
     std::string m_niApiWifiSta1MacAddr;
     std::string m_niApiWifiSta2MacAddr;
 
+    // MAC addresses above, parsed once during initialization
+    Mac48Address m_niApiWifiApMac48;
+    Mac48Address m_niApiWifiStaMac48;
+    Mac48Address m_niApiWifiBssidMac48;
+    Mac48Address m_niApiWifiSta1Mac48;
+    Mac48Address m_niApiWifiSta2Mac48;
+
     uint32_t m_niApiWifiMcs;
+    uint32_t m_niApiWifiUdpBatchSize;
 
     uint8_t  m_bufferTx[9000];
+    uint8_t  m_bufferTxConfigReq[TX_CONFIG_REQ_SIZE];
+    uint32_t m_bufferSizeTxConfigReq = 0;
     //uint8_t  m_bufferRx[9500];
     uint32_t m_bufferOffsetTx = 0;
     uint32_t m_bufferOffsetRx = 0;